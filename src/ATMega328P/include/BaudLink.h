@@ -0,0 +1,53 @@
+/**
+ * @file BaudLink.h
+ * @brief the Arduino's side of the UART rate negotiation with the ESP32
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The ESP32 leads (see include/Link/BaudLink.h in the ESP32 project for the whole exchange). This side only answers:
+ *
+ *   "baud <rate>"   -> "baudOK <rate>" and switch, or "baudNO <rate>" for a rate we cannot do exactly
+ *   "test ..."      -> the same line back if its crc matches, "testBAD <n>" if not
+ *   "baudCommit"    -> keep the rate
+ *   "ping"          -> "pong <garbled lines received since the last pong>"
+ *   "baudDrop"      -> back to 115200
+ *
+ * and protects itself: a switched rate without "baudCommit" within BAUD_COMMIT_MS, or without a ping for
+ * BAUD_WATCHDOG_MS, goes back to 115200, so the two sides always meet again even if the messages in between were lost.
+ *
+ * No Arduino dependencies, the state machine can be run over a simulated link on a computer.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef BAUD_LINK_H
+#define BAUD_LINK_H
+
+#include <stdint.h>
+
+#define BAUD_DEFAULT 115200
+
+// have to match the ESP32's
+#define BAUD_COMMIT_MS 1500
+#define BAUD_WATCHDOG_MS 3500
+#define BAUD_TEST_PAYLOAD 32
+
+typedef void (*BaudSendCallback)(const char* line);        // send one line (newline added)
+typedef void (*BaudSetCallback)(uint32_t baud);            // switch the UART once everything sent has left
+
+struct BaudLink {
+  uint32_t baud;
+  bool committed;
+  uint32_t since;                       // when the rate was switched, or the last ping
+  uint16_t rxErrors;                    // garbled lines since the last pong
+};
+
+uint8_t baudCrc8(const char* data, int len);
+
+void baudLinkInit(BaudLink* link);
+bool baudLinkLine(BaudLink* link, const char* line, uint32_t now, BaudSendCallback send, BaudSetCallback setBaud);
+void baudLinkError(BaudLink* link);
+void baudLinkPoll(BaudLink* link, uint32_t now, BaudSetCallback setBaud);
+
+#endif
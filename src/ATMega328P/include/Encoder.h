@@ -0,0 +1,68 @@
+/**
+ * @file Encoder.h
+ * @brief quadrature decoding for the RPGs
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The pin change ISR reads the A and B pins of an RPG and hands them over as a 2 bit AB value. Together with the
+ * previous value that is one of 16 transitions: a step clockwise, a step counter clockwise, or nothing (no change, or
+ * a skipped state from a bounce). The answer for each transition is computed at compile time into a 16 byte table in
+ * flash, so decoding is one lookup (encoderStep() is inline, the ISR makes no call for it).
+ *
+ * No Arduino dependencies, the ISR's decoding can be fed recorded or generated waveforms on a computer.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef ENCODER_H
+#define ENCODER_H
+
+#include <stdint.h>
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#else
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#endif
+
+struct Encoder {
+  uint8_t prev;                         // last AB value
+};
+
+// position of an AB value in the clockwise cycle 00 -> 01 -> 11 -> 10 (2 bit gray code decoded)
+constexpr uint8_t encoderPosition(uint8_t ab) {
+  return (uint8_t)((ab ^ (ab >> 1)) & 3);
+}
+
+// positions moved forward (mod 4) by a transition (previous AB << 2 | current AB)
+constexpr uint8_t encoderDistance(uint8_t transition) {
+  return (uint8_t)((encoderPosition(transition & 3) - encoderPosition(transition >> 2)) & 3);
+}
+
+/**
+ * @brief step for a transition: one position forward is clockwise, one back counter clockwise. no change, or two
+ * positions (a state was missed, direction unknown) is no step
+ */
+constexpr int8_t encoderTransition(uint8_t transition) {
+  return encoderDistance(transition) == 1 ? 1 : encoderDistance(transition) == 3 ? -1 : 0;
+}
+
+extern const int8_t ENCODER_STEPS[16] PROGMEM;
+
+void encoderReset(volatile Encoder* e, uint8_t ab);
+
+/**
+ * @brief decode one pin change
+ *
+ * @param ab current A (bit 1) and B (bit 0)
+ * @return 1 clockwise, -1 counter clockwise, 0 no step
+ */
+inline int8_t encoderStep(volatile Encoder* e, uint8_t ab) {
+  uint8_t transition = (uint8_t)((e->prev << 2) | ab);
+  e->prev = ab;
+  return (int8_t)pgm_read_byte(&ENCODER_STEPS[transition]);
+}
+
+#endif
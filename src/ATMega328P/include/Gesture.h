@@ -0,0 +1,81 @@
+/**
+ * @file Gesture.h
+ * @brief non blocking click / hold / double click / auto repeat recognizer for the buttons
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The main loop samples every button once per pass and hands the pressed ones (one bit per button) to gestureUpdate()
+ * together with millis(). Debouncing is done with timestamps: a pin has to keep its new level for debounceMs before it
+ * counts, so nothing ever waits. Each button has its own GestureConfig saying which gestures it reports and their
+ * timing:
+ *
+ *   press    right after the (debounced) press
+ *   click    on release, if it was not held long enough for a hold. with a double click window the click is only
+ *            reported once the window has passed without a second press
+ *   double   second press within doubleMs of a click release
+ *   hold     once, when the button has been down for holdMs
+ *   repeat   while down: first after repeatDelayMs, then every repeatMs
+ *   release  after the (debounced) release
+ *
+ * No Arduino dependencies, the timing can be simulated on a computer.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef GESTURE_H
+#define GESTURE_H
+
+#include <stdint.h>
+
+#define GESTURE_MAX_BUTTONS 8
+
+enum GestureEvent : uint8_t {
+  GESTURE_PRESS,
+  GESTURE_CLICK,
+  GESTURE_DOUBLE,
+  GESTURE_HOLD,
+  GESTURE_REPEAT,
+  GESTURE_RELEASE
+};
+
+// GestureConfig::events bits
+#define GESTURE_ON_PRESS   (1 << GESTURE_PRESS)
+#define GESTURE_ON_CLICK   (1 << GESTURE_CLICK)
+#define GESTURE_ON_DOUBLE  (1 << GESTURE_DOUBLE)
+#define GESTURE_ON_HOLD    (1 << GESTURE_HOLD)
+#define GESTURE_ON_REPEAT  (1 << GESTURE_REPEAT)
+#define GESTURE_ON_RELEASE (1 << GESTURE_RELEASE)
+
+struct GestureConfig {
+  uint8_t events;                 // GESTURE_ON_* bits
+  uint8_t debounceMs;
+  uint16_t holdMs;
+  uint16_t doubleMs;              // double click window (only used with GESTURE_ON_DOUBLE)
+  uint16_t repeatDelayMs;
+  uint16_t repeatMs;
+};
+
+struct GestureButton {
+  uint8_t state;
+  bool raw;                       // last sampled level (true = pressed)
+  bool down;                      // debounced level
+  uint32_t rawAt;                 // when raw last changed
+  uint32_t since;                 // press time, or release time while waiting for a double click
+  uint32_t nextRepeat;
+};
+
+struct GestureSet {
+  const GestureConfig* config;
+  uint8_t count;
+  GestureButton buttons[GESTURE_MAX_BUTTONS];
+};
+
+typedef void (*GestureCallback)(uint8_t button, GestureEvent event);
+
+void gestureInit(GestureSet* set, const GestureConfig* config, uint8_t count);
+void gestureUpdate(GestureSet* set, uint8_t pressed, uint32_t now, GestureCallback callback);
+bool gestureDown(const GestureSet* set, uint8_t button);
+bool gestureIdle(const GestureSet* set);
+
+#endif
@@ -0,0 +1,54 @@
+/**
+ * @file InputContext.h
+ * @brief which inputs the screen on the ESP32 reads, so only those are scanned and reported
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The ESP32 sends "ctx <inputs hex> <rpg delta ms> <joystick ms>" when its screen changes and every couple of seconds
+ * (see include/Link/InputContext.h in the ESP32 project). Inputs outside the context have their pin change interrupts
+ * masked, the joysticks are only sampled (and the ADC only powered) while one is in it, and with an RPG delta interval
+ * the ticks are added up and sent as "rpg1Delta <ticks>" instead of one command each.
+ *
+ * Until the ESP32 says otherwise, everything the firmware always scanned is on (CTX_DEFAULT). The power button is not
+ * part of the context, it is always watched.
+ *
+ * No Arduino dependencies, the parser can be checked on a computer.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef INPUT_CONTEXT_H
+#define INPUT_CONTEXT_H
+
+#include <stdint.h>
+
+// input groups, same bits on the ESP32
+#define CTX_UP_ARROW   (1 << 0)
+#define CTX_DOWN_ARROW (1 << 1)
+#define CTX_HOME       (1 << 2)
+#define CTX_C1A        (1 << 3)
+#define CTX_C1B        (1 << 4)
+#define CTX_C2A        (1 << 5)
+#define CTX_C2B        (1 << 6)
+#define CTX_RPG1       (1 << 7)
+#define CTX_RPG2       (1 << 8)
+#define CTX_JOY1       (1 << 9)
+#define CTX_JOY2       (1 << 10)
+#define CTX_ALL        0x07FF
+
+#define CTX_JOYSTICKS  (CTX_JOY1 | CTX_JOY2)
+#define CTX_DEFAULT    (CTX_ALL & ~CTX_JOYSTICKS)    // joysticks wait for the ESP32 to ask for them
+#define CTX_JOYSTICK_MS 10
+
+struct InputContext {
+  uint16_t inputs;                      // CTX_* bits
+  uint16_t rpgDeltaMs;                  // 0 = one command per tick
+  uint16_t joystickMs;                  // 0 = every pass
+};
+
+void inputContextDefault(InputContext* ctx);
+bool inputContextParse(const char* line, InputContext* ctx);
+bool inputContextSame(const InputContext* a, const InputContext* b);
+
+#endif
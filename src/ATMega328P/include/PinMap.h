@@ -0,0 +1,47 @@
+/**
+ * @file PinMap.h
+ * @brief Arduino pin number -> ATmega328P port, bit and mask, at compile time
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The pins are only written down once, as Arduino pin numbers (the ones pinMode() takes). Which PINx register to read
+ * and which PCMSKx bit to set are derived from them here instead of being mirrored by hand, so moving a button to
+ * another pin is a one line change and anything that no longer fits (an RPG off port B) stops the build.
+ *
+ * Uno / Nano numbering: D0..D7 are PD0..PD7, D8..D13 are PB0..PB5, A0..A5 (14..19) are PC0..PC5. Everything is
+ * constexpr, so none of it exists at run time.
+ *
+ */
+
+#ifndef PIN_MAP_H
+#define PIN_MAP_H
+
+#include <stdint.h>
+
+enum PinPort : uint8_t { PORT_B, PORT_C, PORT_D };
+
+constexpr uint8_t pinPort(uint8_t pin) {
+  return (pin < 8) ? PORT_D : (pin < 14) ? PORT_B : PORT_C;
+}
+
+constexpr uint8_t pinBit(uint8_t pin) {
+  return (pin < 8) ? pin : (pin < 14) ? pin - 8 : pin - 14;
+}
+
+// bit in the PINx register, and in the PCMSKx register of the same port (PCMSK0 = port b, 1 = c, 2 = d)
+constexpr uint8_t pinMask(uint8_t pin) {
+  return (uint8_t)(1 << pinBit(pin));
+}
+
+// OR of the masks of the pins in a table that are on a port
+constexpr uint8_t portMask(const uint8_t* pins, uint8_t count, uint8_t port) {
+  return count == 0 ? 0
+                    : (uint8_t)(((pinPort(pins[0]) == port) ? pinMask(pins[0]) : 0) | portMask(pins + 1, count - 1, port));
+}
+
+static_assert(pinPort(2) == PORT_D && pinBit(7) == 7, "D0..D7 are port d");
+static_assert(pinPort(8) == PORT_B && pinBit(13) == 5, "D8..D13 are port b");
+static_assert(pinPort(14) == PORT_C && pinBit(19) == 5, "A0..A5 are port c");
+
+#endif
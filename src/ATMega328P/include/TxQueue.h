@@ -0,0 +1,58 @@
+/**
+ * @file TxQueue.h
+ * @brief prioritized queue of commands waiting to go out to the ESP32
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Inputs no longer write to the UART themselves: they push a command code here, and the loop moves commands into the
+ * serial buffer only while there is room for a whole line, so nothing ever waits on a full buffer.
+ *
+ * There is one FIFO per priority and the highest non-empty one is sent first (button presses never queue behind a
+ * stream of joystick repeats). Commands pushed with a coalesce key replace a queued command of the same priority and
+ * key instead of adding another one, and their values are added up: a joystick held to the right only ever has its
+ * latest command waiting, and RPG deltas keep a running total per RPG (a total past the int8_t range continues in a
+ * second command, so a fast spin loses nothing). If a FIFO is full the new command is dropped and counted, and the
+ * ESP32 is told how many were lost (see txTakeDropped()).
+ *
+ * No Arduino dependencies, coalescing can be checked on a computer.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef TX_QUEUE_H
+#define TX_QUEUE_H
+
+#include <stdint.h>
+
+#define TX_QUEUE_SIZE 16                // commands per priority, power of two
+#define TX_NO_COALESCE 0
+
+enum TxPriority : uint8_t {
+  TX_HIGH,                              // buttons and power
+  TX_NORMAL,                            // RPG ticks (every one counts, never coalesced) and RPG deltas
+  TX_LOW,                               // streamed joystick directions
+  TX_PRIORITIES
+};
+
+struct TxRing {
+  uint8_t code[TX_QUEUE_SIZE];
+  uint8_t key[TX_QUEUE_SIZE];
+  int8_t value[TX_QUEUE_SIZE];          // sent after the command for commands that carry one
+  uint8_t head;
+  uint8_t count;
+};
+
+struct TxQueue {
+  TxRing rings[TX_PRIORITIES];
+  uint16_t dropped;                     // lost since the last overflow notice
+  uint16_t coalesced;                   // total merged into a queued command (statistics)
+};
+
+void txQueueInit(TxQueue* q);
+bool txPush(TxQueue* q, uint8_t code, TxPriority priority, uint8_t coalesceKey, int8_t value = 0);
+bool txPeek(const TxQueue* q, uint8_t* code, int8_t* value = nullptr);
+void txPop(TxQueue* q);
+uint16_t txTakeDropped(TxQueue* q);
+
+#endif
@@ -0,0 +1,51 @@
+/**
+ * @file Arduino.h
+ * @brief the part of the Arduino AVR core the sketch uses, for the native test build
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Only built by [env:native] (the board env ignores this library). Pins, time and Serial are the simulated chip's,
+ * see HostAVR.h.
+ *
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "avr/io.h"
+#include "avr/interrupt.h"
+#include "HardwareSerial.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+// analog pins by their digital numbers, as on the Uno
+static const uint8_t A0 = 14;
+static const uint8_t A1 = 15;
+static const uint8_t A2 = 16;
+static const uint8_t A3 = 17;
+static const uint8_t A4 = 18;
+static const uint8_t A5 = 19;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file Esp32Peer.cpp
+ * @brief implementation of the ESP32 end of a co-simulation
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "Esp32Peer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+Esp32Peer::Esp32Peer(VirtualUart* uart) : uart(uart) {
+  memset(rpgTicks, 0, sizeof(rpgTicks));
+  dropped = garbled = contextsSent = 0;
+  nowUs = 0;
+  rxLen = 0;
+  rxGarbled = false;
+  hasScreen = contextSent = false;
+  contextSentAt = 0;
+  uart->rxBuffer[UART_ESP32] = ESP32_RX_BUFFER;
+}
+
+/**
+ * @brief setup(): start the rate negotiation
+ */
+void Esp32Peer::begin(uint64_t now) {
+  nowUs = now;
+  esp32::baudLinkBegin(&link, this, ms());
+}
+
+/**
+ * @brief one pass of the ESP32's loop as far as the UART goes
+ */
+void Esp32Peer::poll(uint64_t now) {
+  nowUs = now;
+
+  // readCommand()
+  int c;
+  while ((c = uart->read(UART_ESP32, nowUs)) >= 0) {
+    if (c == '\n') {
+      rx[rxLen] = '\0';
+      bool wasGarbled = rxGarbled;
+      rxLen = 0;
+      rxGarbled = false;
+      if (wasGarbled) {
+        garbled++;
+        esp32::baudLinkError(&link, ms());
+      } else if (!esp32::baudLinkLine(&link, rx, ms())) {
+        handle(rx);
+      }
+    }
+    else if (c == '\r') continue;
+    else if (c < 0x20 || c > 0x7E || rxLen == sizeof(rx) - 1) rxGarbled = true;
+    else rx[rxLen++] = c;
+  }
+
+  esp32::baudLinkPoll(&link, ms());
+
+  // updateInputContext()
+  if (hasScreen && (!contextSent || !esp32::inputContextSame(&screen, &sent) ||
+                    ms() - contextSentAt >= CONTEXT_REFRESH_MS)) {
+    char line[32];
+    esp32::inputContextFormat(&screen, line, sizeof(line));
+    sendLine(line);
+    sent = screen;
+    contextSentAt = ms();
+    contextSent = true;
+    contextsSent++;
+  }
+}
+
+/**
+ * @brief a screen change: this is what the Arduino should scan now
+ */
+void Esp32Peer::show(const esp32::InputContext& ctx) {
+  screen = ctx;
+  hasScreen = true;
+}
+
+/**
+ * @brief handleCommand() as far as counting goes
+ */
+void Esp32Peer::handle(const char* line) {
+  PeerCommand cmd;
+  cmd.atUs = nowUs;
+  snprintf(cmd.line, sizeof(cmd.line), "%s", line);
+  commands.push_back(cmd);
+
+  if (strncmp(line, "txOverflow ", 11) == 0) {
+    dropped += atoi(line + 11);
+    return;
+  }
+  uint8_t rpg;
+  int ticks;
+  if (esp32::rpgDeltaParse(line, &rpg, &ticks)) {
+    rpgTicks[rpg] += ticks;
+  }
+  else if (strcmp(line, "rpg1CW") == 0)  rpgTicks[1]++;
+  else if (strcmp(line, "rpg1CCW") == 0) rpgTicks[1]--;
+  else if (strcmp(line, "rpg2CW") == 0)  rpgTicks[2]++;
+  else if (strcmp(line, "rpg2CCW") == 0) rpgTicks[2]--;
+}
+
+int Esp32Peer::count(const char* command) const {
+  int n = 0;
+  for (size_t i = 0; i < commands.size(); i++) {
+    if (strcmp(commands[i].line, command) == 0) n++;
+  }
+  return n;
+}
+
+void Esp32Peer::sendLine(const char* line) {
+  for (const char* p = line; *p; p++) uart->write(UART_ESP32, *p, nowUs);
+  uart->write(UART_ESP32, '\r', nowUs);
+  uart->write(UART_ESP32, '\n', nowUs);
+}
+
+void Esp32Peer::setBaud(uint32_t baud) {
+  uart->setBaud(UART_ESP32, baud, nowUs);
+}
@@ -0,0 +1,66 @@
+/**
+ * @file Esp32Peer.h
+ * @brief the ESP32 end of a co-simulation: its loop's UART handling, built from the ESP32 project's link modules
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The ESP32's main.cpp needs the panel, Wi-Fi and file system, so it is not compiled here. What it does with the UART is
+ * (readCommand(), baudLinkPoll(), updateInputContext() in its loop), and poll() is that part of a pass, with the
+ * ESP32's own BaudLink and InputContext code (Esp32Side.h). Every command that comes through is logged with the time it
+ * was read, RPG ticks are added up (single ticks and deltas) and txOverflow counts are collected, like handleCommand().
+ *
+ * The screen is whatever context show() was last given; none until then, so nothing is sent.
+ *
+ */
+
+#ifndef ESP32_PEER_H
+#define ESP32_PEER_H
+
+#include <stdint.h>
+#include <vector>
+#include "Esp32Side.h"
+#include "VirtualUart.h"
+
+#define ESP32_RX_BUFFER 1024            // ARDUINO_RX_BUFFER in the ESP32's main.cpp
+
+struct PeerCommand {
+  uint64_t atUs;
+  char line[24];
+};
+
+class Esp32Peer : public esp32::LinkPort {
+public:
+  explicit Esp32Peer(VirtualUart* uart);
+
+  esp32::BaudLink link;
+  std::vector<PeerCommand> commands;    // everything but link lines, in arrival order
+  long rpgTicks[3];                     // by RPG (1, 2), clockwise positive
+  uint32_t dropped;                     // from txOverflow
+  uint32_t garbled;
+  uint32_t contextsSent;
+
+  void begin(uint64_t now);
+  void poll(uint64_t now);
+  void show(const esp32::InputContext& ctx);
+
+  int count(const char* command) const;
+  uint32_t ms() const { return (uint32_t)(nowUs / 1000); }
+
+  void sendLine(const char* line) override;
+  void setBaud(uint32_t baud) override;
+
+private:
+  VirtualUart* uart;
+  uint64_t nowUs;
+  char rx[64];
+  uint8_t rxLen;
+  bool rxGarbled;
+  esp32::InputContext screen, sent;
+  bool hasScreen, contextSent;
+  uint32_t contextSentAt;
+
+  void handle(const char* line);
+};
+
+#endif
@@ -0,0 +1,20 @@
+/**
+ * @file Esp32Side.cpp
+ * @brief the ESP32 project's link sources, compiled into namespace esp32
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The C headers they use are included first, out here, so their include guards keep them out of the namespace.
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace esp32 {
+#include "../../../../ESP32/src/Link/BaudLink.cpp"
+#include "../../../../ESP32/src/Link/InputContext.cpp"
+}
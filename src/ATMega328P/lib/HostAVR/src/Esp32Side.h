@@ -0,0 +1,33 @@
+/**
+ * @file Esp32Side.h
+ * @brief the ESP32's end of the link protocols, for the native test build
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The ESP32 project's link modules (src/Link in ../ESP32) are compiled into namespace esp32, so a test can run both
+ * ends of an exchange in one program even though the two projects use the same names (BaudLink, InputContext, ...).
+ * The include guards are set aside while the ESP32 headers are read, so the Arduino's headers of the same names can be
+ * included before or after this one. The CTX_* bits are macros and defined by both; a bit that differs between the
+ * projects is a redefinition warning.
+ *
+ */
+
+#ifndef ESP32_SIDE_H
+#define ESP32_SIDE_H
+
+#include <stdint.h>
+
+#pragma push_macro("BAUD_LINK_H")
+#pragma push_macro("INPUT_CONTEXT_H")
+#undef BAUD_LINK_H
+#undef INPUT_CONTEXT_H
+namespace esp32 {
+#include "Link/BaudLink.h"
+#include "Link/InputContext.h"
+#include "Input/InputMap.h"             // the InputCode bits inputContextFromCodes() takes
+}
+#pragma pop_macro("INPUT_CONTEXT_H")
+#pragma pop_macro("BAUD_LINK_H")
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file HardwareSerial.cpp
+ * @brief implementation of the simulated Serial
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "HardwareSerial.h"
+#include "HostAVR.h"
+#include <stdio.h>
+#include <string.h>
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long baud) {
+  if (uart) uart->setBaud(UART_ARDUINO, baud, hostNowUs);
+}
+
+void HardwareSerial::flush() {
+  if (!uart) return;
+  uint64_t start = hostNowUs;
+  while (uart->drainedAt(UART_ARDUINO) > hostNowUs) hostAdvanceTo(uart->drainedAt(UART_ARDUINO));
+  hostStats.flushWaitUs += hostNowUs - start;
+}
+
+int HardwareSerial::available() {
+  return uart ? uart->available(UART_ARDUINO, hostNowUs) : 0;
+}
+
+int HardwareSerial::read() {
+  return uart ? uart->read(UART_ARDUINO, hostNowUs) : -1;
+}
+
+int HardwareSerial::availableForWrite() {
+  return uart ? uart->availableForWrite(UART_ARDUINO, hostNowUs) : UART_BUFFER;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (!uart) return 1;
+  uint64_t start = hostNowUs;
+  while (uart->availableForWrite(UART_ARDUINO, hostNowUs) == 0) hostAdvanceUs(1);
+  hostStats.writeWaitUs += hostNowUs - start;
+  uart->write(UART_ARDUINO, c, hostNowUs);
+  return 1;
+}
+
+size_t HardwareSerial::write(const char* s) {
+  size_t n = 0;
+  while (*s) n += write((uint8_t)*s++);
+  return n;
+}
+
+size_t HardwareSerial::print(long v) {
+  char text[24];
+  snprintf(text, sizeof(text), "%ld", v);
+  return write(text);
+}
+
+size_t HardwareSerial::print(unsigned long v) {
+  char text[24];
+  snprintf(text, sizeof(text), "%lu", v);
+  return write(text);
+}
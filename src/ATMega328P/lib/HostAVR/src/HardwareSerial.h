@@ -0,0 +1,54 @@
+/**
+ * @file HardwareSerial.h
+ * @brief Serial on the Arduino end of a VirtualUart, for the native test build
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Behaves like the AVR core's: 64 byte buffers both ways, write() waits while the transmit buffer is full, flush()
+ * waits until the last byte is out. Waiting moves the simulated clock (pin changes and the peer keep running) and is
+ * added up in hostStats. Without a VirtualUart attached everything written is thrown away.
+ *
+ */
+
+#ifndef HOST_HARDWARE_SERIAL_H
+#define HOST_HARDWARE_SERIAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+class VirtualUart;
+
+class HardwareSerial {
+public:
+  void attach(VirtualUart* uart) { this->uart = uart; }
+
+  void begin(unsigned long baud);
+  void end() {}
+  void flush();
+  int available();
+  int read();
+  int availableForWrite();
+  size_t write(uint8_t c);
+  size_t write(const char* s);
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return print((long)v); }
+  size_t print(unsigned int v) { return print((unsigned long)v); }
+  size_t print(long v);
+  size_t print(unsigned long v);
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(T v) { return print(v) + println(); }
+
+  operator bool() const { return true; }
+
+private:
+  VirtualUart* uart = nullptr;
+};
+
+extern HardwareSerial Serial;
+
+#endif
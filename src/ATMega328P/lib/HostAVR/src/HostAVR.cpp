@@ -0,0 +1,276 @@
+/**
+ * @file HostAVR.cpp
+ * @brief implementation of the simulated ATmega328P (registers, pins, pin change interrupts, clock, Arduino calls)
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * hostAdvanceTo() walks from one thing that happens to the next: a scheduled pin change, the end of a running ISR with
+ * a flag waiting, or the peer's turn. Everything at the same microsecond happens in that order. The sketch itself only
+ * runs when the test calls setup() / loop(), so a loop pass takes no simulated time unless the test advances the
+ * clock after it (or the pass waits on Serial).
+ *
+ */
+
+#include "HostAVR.h"
+#include "Arduino.h"
+#include "util/atomic.h"
+#include <map>
+
+volatile uint8_t PINB, PINC, PIND;
+volatile uint8_t PORTB, PORTC, PORTD;
+volatile uint8_t DDRB, DDRC, DDRD;
+volatile uint8_t PCMSK0, PCMSK1, PCMSK2;
+volatile uint8_t PCICR, PCIFR;
+volatile uint8_t ADCSRA;
+volatile uint8_t SREG;
+
+uint64_t hostNowUs = 0;
+uint32_t hostIsrUs = 8;                 // ~130 cycles at 16 MHz, what the port b ISR takes with both RPGs
+HostStats hostStats;
+
+struct PinEvent {
+  uint8_t pin;
+  bool level;
+};
+
+static bool outside[HOST_PINS];         // level the test drives, inputs only
+static bool future[HOST_PINS];          // outside level once everything scheduled has happened
+static std::multimap<uint64_t, PinEvent> schedule;
+static uint16_t analog[6];
+static uint16_t lastConversion;
+static uint64_t isrBusyUntil;
+static HostTask peer;
+static uint32_t peerEveryUs;
+static uint64_t peerNext;
+
+static volatile uint8_t* const PIN_REG[3] = { &PINB, &PINC, &PIND };
+static volatile uint8_t* const PORT_REG[3] = { &PORTB, &PORTC, &PORTD };
+static volatile uint8_t* const DDR_REG[3] = { &DDRB, &DDRC, &DDRD };
+static volatile uint8_t* const PCMSK_REG[3] = { &PCMSK0, &PCMSK1, &PCMSK2 };
+static void (*const VECTOR[3])(void) = { PCINT0_vect, PCINT1_vect, PCINT2_vect };
+
+// same numbering as PinMap.h: port b = 0, c = 1, d = 2
+static uint8_t portOf(uint8_t pin) {
+  return (pin < 8) ? 2 : (pin < 14) ? 0 : 1;
+}
+
+static uint8_t bitOf(uint8_t pin) {
+  return (uint8_t)(1 << ((pin < 8) ? pin : (pin < 14) ? pin - 8 : pin - 14));
+}
+
+// ---------- interrupts ---------- //
+
+/**
+ * @brief run every vector that is due, lowest first (PCINT0 has the highest priority on the chip)
+ */
+static void dispatch() {
+  while ((SREG & (1 << SREG_I)) && hostNowUs >= isrBusyUntil) {
+    uint8_t due = PCIFR & PCICR & 0b111;
+    if (!due) return;
+    uint8_t n = (due & 1) ? 0 : (due & 2) ? 1 : 2;
+
+    PCIFR &= ~(1 << n);
+    SREG &= ~(1 << SREG_I);
+    hostStats.isrCalls[n]++;
+    VECTOR[n]();
+    SREG |= (1 << SREG_I);
+    isrBusyUntil = hostNowUs + hostIsrUs;
+  }
+}
+
+/**
+ * @brief recompute a port's PINx from the outside levels and the outputs, raising its flag for unmasked changes
+ */
+static void updatePort(uint8_t port) {
+  uint8_t level = 0;
+  for (uint8_t pin = 0; pin < HOST_PINS; pin++) {
+    if (portOf(pin) != port) continue;
+    uint8_t bit = bitOf(pin);
+    bool high = (*DDR_REG[port] & bit) ? (*PORT_REG[port] & bit) : outside[pin];
+    if (high) level |= bit;
+  }
+
+  uint8_t changed = *PIN_REG[port] ^ level;
+  *PIN_REG[port] = level;
+  if (!changed) return;
+  for (uint8_t b = changed; b; b &= b - 1) hostStats.pinChanges++;
+  if (changed & *PCMSK_REG[port]) {
+    PCIFR |= (1 << port);
+    dispatch();
+  }
+}
+
+void sei() {
+  SREG |= (1 << SREG_I);
+  dispatch();
+}
+
+void cli() {
+  SREG &= ~(1 << SREG_I);
+}
+
+HostAtomic::HostAtomic(int type) : saved(type == ATOMIC_FORCEON ? (uint8_t)(SREG | (1 << SREG_I)) : SREG) {
+  cli();
+}
+
+HostAtomic::~HostAtomic() {
+  SREG = saved;
+  dispatch();
+}
+
+// ---------- test side ---------- //
+
+void hostReset() {
+  PORTB = PORTC = PORTD = 0;
+  DDRB = DDRC = DDRD = 0;
+  PCMSK0 = PCMSK1 = PCMSK2 = 0;
+  PCICR = PCIFR = 0;
+  ADCSRA = (1 << ADEN) | 0b111;         // init() in wiring.c: ADC on, clock / 128
+  SREG = (1 << SREG_I);                 // init() ends with sei()
+
+  for (int pin = 0; pin < HOST_PINS; pin++) outside[pin] = future[pin] = true;
+  PINB = PINC = PIND = 0;
+  for (uint8_t port = 0; port < 3; port++) updatePort(port);
+
+  schedule.clear();
+  for (int i = 0; i < 6; i++) analog[i] = 512;
+  lastConversion = 0;
+  hostNowUs = 0;
+  isrBusyUntil = 0;
+  peer = nullptr;
+  hostStats = HostStats();
+  Serial.attach(nullptr);
+}
+
+/**
+ * @brief move the clock, with everything that happens on the way
+ */
+void hostAdvanceTo(uint64_t us) {
+  for (;;) {
+    uint64_t next = us;
+    if (!schedule.empty() && schedule.begin()->first < next) next = schedule.begin()->first;
+    if ((PCIFR & PCICR & 0b111) && (SREG & (1 << SREG_I)) && isrBusyUntil > hostNowUs && isrBusyUntil < next) {
+      next = isrBusyUntil;
+    }
+    if (peer && peerNext < next) next = peerNext;
+    if (next > hostNowUs) hostNowUs = next;
+
+    bool any = false;
+    while (!schedule.empty() && schedule.begin()->first <= hostNowUs) {
+      PinEvent e = schedule.begin()->second;
+      schedule.erase(schedule.begin());
+      outside[e.pin] = e.level;
+      updatePort(portOf(e.pin));
+      any = true;
+    }
+    dispatch();
+    if (peer && peerNext <= hostNowUs) {
+      peerNext += peerEveryUs;
+      peer(hostNowUs);
+      any = true;
+    }
+    if (!any && hostNowUs >= us) return;
+  }
+}
+
+/**
+ * @brief run a task every everyUs from now on (nullptr stops it)
+ */
+void hostSetPeer(HostTask task, uint32_t everyUs) {
+  peer = task;
+  peerEveryUs = everyUs;
+  peerNext = hostNowUs + everyUs;
+}
+
+void hostSetPin(uint8_t pin, bool level) {
+  outside[pin] = future[pin] = level;
+  updatePort(portOf(pin));
+}
+
+/**
+ * @brief set a pin's outside level at a later time. changes at the same time happen in the order they were scheduled
+ */
+void hostSchedulePin(uint64_t at, uint8_t pin, bool level) {
+  schedule.insert(std::make_pair(at, PinEvent{ pin, level }));
+  future[pin] = level;
+}
+
+/**
+ * @return the level the pin is driven to once the last change scheduled for it (so far) has happened
+ */
+bool hostScheduledLevel(uint8_t pin) {
+  return future[pin];
+}
+
+bool hostPinsPending() {
+  return !schedule.empty();
+}
+
+/**
+ * @return the level an output pin is driven to by the sketch
+ */
+bool hostOutput(uint8_t pin) {
+  return (*PORT_REG[portOf(pin)] & bitOf(pin)) != 0;
+}
+
+void hostSetAnalog(uint8_t pin, uint16_t value) {
+  analog[(pin >= A0) ? pin - A0 : pin] = value;
+}
+
+void hostAttachSerial(VirtualUart* uart) {
+  Serial.attach(uart);
+}
+
+// ---------- Arduino core ---------- //
+
+unsigned long millis() {
+  return (unsigned long)(hostNowUs / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)hostNowUs;
+}
+
+void delay(unsigned long ms) {
+  hostAdvanceUs((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+  hostAdvanceUs(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  uint8_t port = portOf(pin), bit = bitOf(pin);
+  if (mode == OUTPUT) {
+    *DDR_REG[port] |= bit;
+  } else {
+    *DDR_REG[port] &= ~bit;
+    if (mode == INPUT_PULLUP) *PORT_REG[port] |= bit;
+    else                      *PORT_REG[port] &= ~bit;
+  }
+  updatePort(port);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  uint8_t port = portOf(pin), bit = bitOf(pin);
+  if (value) *PORT_REG[port] |= bit;
+  else       *PORT_REG[port] &= ~bit;
+  updatePort(port);
+}
+
+int digitalRead(uint8_t pin) {
+  return (*PIN_REG[portOf(pin)] & bitOf(pin)) ? HIGH : LOW;
+}
+
+/**
+ * @brief a conversion. with the ADC off nothing is converted and the last result comes back (counted in hostStats)
+ */
+int analogRead(uint8_t pin) {
+  if (!(ADCSRA & (1 << ADEN))) {
+    hostStats.adcOffReads++;
+    return lastConversion;
+  }
+  lastConversion = analog[(pin >= A0) ? pin - A0 : pin];
+  return lastConversion;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file HostAVR.h
+ * @brief the simulated ATmega328P behind the mock Arduino and AVR headers, for the native test build
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * main.cpp is compiled unchanged against Arduino.h, avr/io.h, avr/interrupt.h and util/atomic.h from this library.
+ * Their registers and functions end up here, and this header is what a test uses to drive them:
+ * - time is a microsecond clock that only moves when the test (or a waiting Serial call) moves it. millis() and
+ *   micros() read it
+ * - pins 0..19 (D0..D13, A0..A5) have an outside level the test sets, now or scheduled for later. PINB/C/D show it
+ *   (or the PORT bit for an output)
+ * - a pin change on a pin unmasked in PCMSKn sets its PCIFR flag, and the vector runs as soon as interrupts are on and
+ *   the previous ISR is done. An ISR takes hostIsrUs; edges in the meantime only leave the flag set, so the ISR sees
+ *   the pins as they are when it finally runs, like on the chip. This is where fast edges get lost
+ * - one peer task (the ESP32 side of a test) runs every few microseconds of simulated time, also while the sketch
+ *   waits in Serial.flush() or a full Serial.write()
+ * - Serial is a HardwareSerial on the Arduino end of a VirtualUart
+ *
+ * hostReset() puts the chip in the state the Arduino core leaves it in before setup(): interrupts on, ADC enabled,
+ * every pin an input at high level, no pin change interrupt unmasked. The sketch's own globals are the test's business.
+ *
+ */
+
+#ifndef HOST_AVR_H
+#define HOST_AVR_H
+
+#include <stdint.h>
+#include "VirtualUart.h"
+
+#define HOST_PINS 20
+
+typedef void (*HostTask)(uint64_t now);
+
+// what the simulated chip counted since hostReset()
+struct HostStats {
+  uint32_t isrCalls[3];                 // by vector (PCINT0..2)
+  uint32_t pinChanges;                  // level changes of any pin
+  uint32_t adcOffReads;                 // analogRead() with the ADC switched off
+  uint64_t writeWaitUs;                 // time Serial.write() waited for room in the transmit buffer
+  uint64_t flushWaitUs;                 // time Serial.flush() waited
+};
+
+extern uint64_t hostNowUs;
+extern uint32_t hostIsrUs;
+extern HostStats hostStats;
+
+void hostReset();
+
+void hostAdvanceTo(uint64_t us);
+inline void hostAdvanceUs(uint64_t us) { hostAdvanceTo(hostNowUs + us); }
+
+void hostSetPeer(HostTask task, uint32_t everyUs);
+
+void hostSetPin(uint8_t pin, bool level);
+void hostSchedulePin(uint64_t at, uint8_t pin, bool level);
+bool hostScheduledLevel(uint8_t pin);
+bool hostPinsPending();
+bool hostOutput(uint8_t pin);
+void hostSetAnalog(uint8_t pin, uint16_t value);
+
+void hostAttachSerial(VirtualUart* uart);
+
+#endif
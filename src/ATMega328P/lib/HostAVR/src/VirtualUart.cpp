@@ -0,0 +1,109 @@
+/**
+ * @file VirtualUart.cpp
+ * @brief implementation of the simulated UART
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Errors are decided when a byte is written (so a run does not depend on how often the other end reads), the rate
+ * check when it arrives. Arrived bytes are moved into the receive buffer whenever the receiving end looks at it; a
+ * receiver that looks less often than its buffer's worth of byte times loses what does not fit, as the AVR would.
+ *
+ */
+
+#include "VirtualUart.h"
+#include <string.h>
+
+VirtualUart::VirtualUart(uint32_t seed) : seed(seed) {
+  memset(line, 0, sizeof(line));
+  memset(stats, 0, sizeof(stats));
+  rxBuffer[0] = rxBuffer[1] = UART_BUFFER;
+  rate[0] = rate[1] = 115200;
+  lineFree[0] = lineFree[1] = 0;
+}
+
+uint32_t VirtualUart::random() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+static uint64_t byteTime(uint32_t baud) {
+  return (10000000ull + baud - 1) / baud;         // start + 8 data + stop bits, in us
+}
+
+/**
+ * @brief switch an end's rate. bytes already written keep the rate they were written at (the firmware flushes first)
+ */
+void VirtualUart::setBaud(int end, uint32_t baud, uint64_t now) {
+  deliver(end, now);                              // what arrived so far was received at the old rate
+  rate[end] = baud;
+}
+
+void VirtualUart::write(int end, uint8_t b, uint64_t now) {
+  const UartLineConfig& c = line[end];
+  stats[end].sent++;
+
+  uint64_t start = (lineFree[end] > now) ? lineFree[end] : now;
+  lineFree[end] = start + byteTime(rate[end]);
+
+  if (c.dropPpm && random() % 1000000 < c.dropPpm) {
+    stats[end].dropped++;
+    return;
+  }
+  bool flip = c.errorPpm && random() % 1000000 < c.errorPpm;
+  if (c.cleanUpTo && rate[end] > c.cleanUpTo && random() % 1000000 < c.badPpm) flip = true;
+  if (flip) {
+    b ^= 1 << (random() % 8);
+    stats[end].flipped++;
+  }
+  wire[end].push_back({ b, rate[end], lineFree[end], lineFree[end] + c.latencyUs });
+}
+
+/**
+ * @brief free room in an end's transmit buffer (bytes written that have not started on the wire yet)
+ */
+int VirtualUart::availableForWrite(int end, uint64_t now) {
+  if (lineFree[end] <= now) return UART_BUFFER;
+  uint64_t waiting = (lineFree[end] - now) / byteTime(rate[end]);
+  return waiting >= UART_BUFFER ? 0 : UART_BUFFER - (int)waiting;
+}
+
+/**
+ * @brief move the bytes that have arrived at an end into its receive buffer
+ */
+void VirtualUart::deliver(int to, uint64_t now) {
+  int from = 1 - to;
+  std::deque<Byte>& w = wire[from];
+  while (!w.empty() && w.front().arrives <= now) {
+    Byte b = w.front();
+    w.pop_front();
+    if (b.baud != rate[to]) {
+      // sampled with the wrong bit time: some other byte, or a framing error the UART throws away
+      stats[from].mismatched++;
+      uint32_t r = random();
+      if (r & 1) continue;
+      b.value = (uint8_t)(r >> 8);
+    }
+    if ((int)rx[to].size() >= rxBuffer[to]) {
+      stats[from].overruns++;
+      continue;
+    }
+    rx[to].push_back(b.value);
+  }
+}
+
+int VirtualUart::available(int end, uint64_t now) {
+  deliver(end, now);
+  return (int)rx[end].size();
+}
+
+/**
+ * @return the next received byte, -1 if there is none
+ */
+int VirtualUart::read(int end, uint64_t now) {
+  deliver(end, now);
+  if (rx[end].empty()) return -1;
+  uint8_t b = rx[end].front();
+  rx[end].pop_front();
+  return b;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file VirtualUart.h
+ * @brief simulated UART between the Arduino and the ESP32, for the native test build
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Two ends (UART_ARDUINO, UART_ESP32), each with its own rate. A byte written at one end leaves after everything written
+ * before it, takes 10 bit times at the sender's rate plus the link's latency, and arrives at the other end, where it is
+ * only read correctly if the receiver runs at the same rate (a mismatch turns it into noise, like on the wire).
+ *
+ * Each direction can have random bit errors and lost bytes (parts per million per byte), and a rate above cleanUpTo
+ * errors every byte with badPpm, for a cable that only carries the slower rates. Errors come from a seeded generator,
+ * so a run can be repeated exactly. Both ends have a 64 byte transmit and receive buffer like HardwareSerial on the
+ * AVR: availableForWrite() is what is left of it, and bytes arriving at a full receive buffer are lost (overrun). The
+ * ESP32 sets a larger receive buffer (rxBuffer).
+ *
+ * Time is in microseconds and only moves when the caller says so.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef VIRTUAL_UART_H
+#define VIRTUAL_UART_H
+
+#include <stdint.h>
+#include <deque>
+
+#define UART_ARDUINO 0
+#define UART_ESP32 1
+#define UART_BUFFER 64
+
+// one direction of the wire, set for the bytes its end sends
+struct UartLineConfig {
+  uint32_t latencyUs;
+  uint32_t errorPpm;                    // bytes with one flipped bit
+  uint32_t dropPpm;                     // bytes that never arrive
+  uint32_t cleanUpTo;                   // rates above this error with badPpm as well (0 = every rate is clean)
+  uint32_t badPpm;
+};
+
+struct UartStats {
+  uint32_t sent;
+  uint32_t flipped;                     // bit errors (random or above cleanUpTo)
+  uint32_t dropped;
+  uint32_t mismatched;                  // arrived while the receiver ran at another rate
+  uint32_t overruns;                    // lost to a full receive buffer
+};
+
+class VirtualUart {
+public:
+  explicit VirtualUart(uint32_t seed = 1);
+
+  UartLineConfig line[2];               // by sending end
+  UartStats stats[2];                   // by sending end
+  int rxBuffer[2];                      // receive buffer size by receiving end, UART_BUFFER to start with
+
+  void setBaud(int end, uint32_t baud, uint64_t now);
+  uint32_t baud(int end) const { return rate[end]; }
+
+  void write(int end, uint8_t b, uint64_t now);
+  int availableForWrite(int end, uint64_t now);
+  uint64_t drainedAt(int end) const { return lineFree[end]; }
+
+  int available(int end, uint64_t now);
+  int read(int end, uint64_t now);
+
+private:
+  struct Byte {
+    uint8_t value;
+    uint32_t baud;                      // rate it was sent at
+    uint64_t leaves;                    // last bit out of the sender
+    uint64_t arrives;
+  };
+
+  uint32_t rate[2];
+  uint64_t lineFree[2];                 // when the sender's shift register is done with what is queued
+  std::deque<Byte> wire[2];             // by sending end, in the order they arrive
+  std::deque<uint8_t> rx[2];            // by receiving end
+  uint32_t seed;
+
+  uint32_t random();
+  void deliver(int to, uint64_t now);
+};
+
+#endif
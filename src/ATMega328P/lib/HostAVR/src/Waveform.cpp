@@ -0,0 +1,73 @@
+/**
+ * @file Waveform.cpp
+ * @brief implementation of the scripted input waveforms
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "Waveform.h"
+#include "HostAVR.h"
+
+uint32_t Waveform::random() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+/**
+ * @brief one edge, bouncing if bounces is set
+ *
+ * @return when the pin is settled at the new level
+ */
+uint64_t Waveform::edge(uint8_t pin, uint64_t at, bool level) {
+  hostSchedulePin(at, pin, level);
+  if (!bounces || !bounceUs) return at;
+
+  // each bounce gets its own slice of the window, the contact opens and closes again at random points in it
+  uint32_t slice = bounceUs / bounces;
+  uint32_t half = (slice / 2) ? slice / 2 : 1;
+  uint64_t t = at;
+  for (uint8_t i = 0; i < bounces; i++) {
+    uint64_t open = at + (uint64_t)slice * i + 1 + random() % half;
+    if (open <= t) open = t + 1;
+    uint64_t close = open + 1 + random() % half;
+    hostSchedulePin(open, pin, !level);
+    hostSchedulePin(close, pin, level);
+    t = close;
+  }
+  return t;
+}
+
+/**
+ * @brief a button press (active low): down at `at`, up again holdUs later
+ *
+ * @return when the release has settled
+ */
+uint64_t Waveform::press(uint8_t pin, uint64_t at, uint32_t holdUs) {
+  edge(pin, at, false);
+  return edge(pin, at + holdUs, true);
+}
+
+/**
+ * @brief turn an RPG: steps quadrature transitions (negative is counter clockwise), one every periodUs
+ *
+ * A is bit 1 and B bit 0 of the decoder's AB value, so pinA / pinB are the pins the sketch decodes as A and B. Each
+ * transition moves one of them, clockwise is 00 -> 01 -> 11 -> 10.
+ *
+ * @return when the last transition has settled
+ */
+uint64_t Waveform::turn(uint8_t pinA, uint8_t pinB, uint64_t at, int steps, uint32_t periodUs) {
+  uint64_t end = at;
+  int count = steps < 0 ? -steps : steps;
+  for (int i = 0; i < count; i++) {
+    uint8_t ab = (uint8_t)((hostScheduledLevel(pinA) << 1) | hostScheduledLevel(pinB));
+    uint8_t position = (uint8_t)(ab ^ (ab >> 1));
+    position = (uint8_t)((position + (steps > 0 ? 1 : 3)) & 3);
+    uint8_t next = (uint8_t)(position ^ (position >> 1));
+    // exactly one of the two changes
+    bool moveA = ((ab ^ next) & 0b10) != 0;
+    end = edge(moveA ? pinA : pinB, at + (uint64_t)periodUs * i, moveA ? (next & 0b10) : (next & 0b01));
+  }
+  return end;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file Waveform.h
+ * @brief scripted input waveforms for the simulated pins: button presses and RPG turns, with contact bounce
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Everything is scheduled on the simulated chip (hostSchedulePin), so a script is written up front and plays out as the
+ * clock moves. Each call starts from the level the pins will have after what was scheduled before it, and returns when
+ * its last edge happens, so calls chain.
+ *
+ * A bouncing edge goes to the new level, back and forth `bounces` more times within bounceUs, and stays. RPG
+ * transitions have to be further apart than bounceUs, a real contact does not bounce into the next detent either.
+ *
+ */
+
+#ifndef WAVEFORM_H
+#define WAVEFORM_H
+
+#include <stdint.h>
+
+class Waveform {
+public:
+  explicit Waveform(uint32_t seed) : seed(seed), bounceUs(0), bounces(0) {}
+
+  uint32_t seed;
+  uint32_t bounceUs;
+  uint8_t bounces;
+
+  uint64_t edge(uint8_t pin, uint64_t at, bool level);
+  uint64_t press(uint8_t pin, uint64_t at, uint32_t holdUs);
+  uint64_t turn(uint8_t pinA, uint8_t pinB, uint64_t at, int steps, uint32_t periodUs);
+
+  // the same seeded sequence the bounces use, for scripts that pick their own times
+  uint32_t random();
+};
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * @file interrupt.h
+ * @brief interrupt vectors and sei() / cli(), for the native test build
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * ISR(vector) defines a plain function the simulated chip calls when the vector is due (see HostAVR.h). sei() runs
+ * whatever became due while interrupts were off.
+ *
+ */
+
+#ifndef HOST_AVR_INTERRUPT_H
+#define HOST_AVR_INTERRUPT_H
+
+#include "avr/io.h"
+
+#define ISR(vector) extern "C" void vector(void)
+
+extern "C" void PCINT0_vect(void);
+extern "C" void PCINT1_vect(void);
+extern "C" void PCINT2_vect(void);
+
+void sei();
+void cli();
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * @file io.h
+ * @brief the ATmega328P registers the sketch touches, for the native test build
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Plain variables in HostAVR.cpp. Pin levels and interrupt flags are kept up to date by the simulation there; writing
+ * one of these from a test does not run anything.
+ *
+ */
+
+#ifndef HOST_AVR_IO_H
+#define HOST_AVR_IO_H
+
+#include <stdint.h>
+
+extern volatile uint8_t PINB, PINC, PIND;
+extern volatile uint8_t PORTB, PORTC, PORTD;
+extern volatile uint8_t DDRB, DDRC, DDRD;
+extern volatile uint8_t PCMSK0, PCMSK1, PCMSK2;
+extern volatile uint8_t PCICR, PCIFR;
+extern volatile uint8_t ADCSRA;
+extern volatile uint8_t SREG;
+
+#define PCIE0 0
+#define PCIE1 1
+#define PCIE2 2
+#define PCIF0 0
+#define PCIF1 1
+#define PCIF2 2
+#define ADEN 7
+#define SREG_I 7
+
+#endif
@@ -0,0 +1,33 @@
+/**
+ * @file atomic.h
+ * @brief ATOMIC_BLOCK, for the native test build
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Same use as avr-libc's: the block runs with interrupts off, and leaving it restores SREG (ATOMIC_RESTORESTATE) or
+ * turns them on (ATOMIC_FORCEON). A pin change inside the block is served when it ends.
+ *
+ */
+
+#ifndef HOST_UTIL_ATOMIC_H
+#define HOST_UTIL_ATOMIC_H
+
+#include <stdint.h>
+
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_FORCEON 1
+
+class HostAtomic {
+public:
+  explicit HostAtomic(int type);
+  ~HostAtomic();
+
+private:
+  uint8_t saved;
+};
+
+// runs the block once: the pointer starts out at the guard and is cleared after the first pass
+#define ATOMIC_BLOCK(type) for (HostAtomic hostAtomic_(type), *hostOnce_ = &hostAtomic_; hostOnce_; hostOnce_ = nullptr)
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file BaudLink.cpp
+ * @brief implementation of the Arduino's side of the UART rate negotiation
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Only rates the 16 MHz clock divides exactly (with U2X: 16 MHz / 8 / (UBRR + 1)) are accepted above 115200, a rate
+ * that is a few percent off would work on the bench and fail on a warm day.
+ *
+ */
+
+#include "BaudLink.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint32_t BAUD_RATES[] = { 1000000, 500000, 250000, BAUD_DEFAULT };
+
+/**
+ * @brief CRC-8 (polynomial 0x07), same as the ESP32's
+ */
+uint8_t baudCrc8(const char* data, int len) {
+  uint8_t crc = 0;
+  for (int i = 0; i < len; i++) {
+    crc ^= (uint8_t)data[i];
+    for (uint8_t b = 0; b < 8; b++) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+void baudLinkInit(BaudLink* link) {
+  link->baud = BAUD_DEFAULT;
+  link->committed = true;
+  link->since = 0;
+  link->rxErrors = 0;
+}
+
+static void switchTo(BaudLink* link, uint32_t baud, uint32_t now, BaudSetCallback setBaud) {
+  setBaud(baud);
+  link->baud = baud;
+  link->committed = (baud == BAUD_DEFAULT);
+  link->since = now;
+}
+
+/**
+ * @brief check a "test <n> <payload> <crc>" line
+ */
+static bool testIntact(const char* line) {
+  const char* payload = strchr(line + 5, ' ');
+  if (!payload) return false;
+  payload++;
+  const char* crc = payload + BAUD_TEST_PAYLOAD;
+  if (strlen(payload) != BAUD_TEST_PAYLOAD + 3 || *crc != ' ') return false;
+  return strtoul(crc + 1, nullptr, 16) == baudCrc8(payload, BAUD_TEST_PAYLOAD);
+}
+
+/**
+ * @brief give a line from the ESP32 to the link first
+ *
+ * @return true if it was a link message
+ */
+bool baudLinkLine(BaudLink* link, const char* line, uint32_t now, BaudSendCallback send, BaudSetCallback setBaud) {
+  char reply[24];
+
+  if (strncmp(line, "baud ", 5) == 0) {
+    uint32_t baud = strtoul(line + 5, nullptr, 10);
+    for (uint8_t i = 0; i < sizeof(BAUD_RATES) / sizeof(BAUD_RATES[0]); i++) {
+      if (BAUD_RATES[i] == baud) {
+        sprintf(reply, "baudOK %lu", (unsigned long)baud);
+        send(reply);
+        if (baud != link->baud || !link->committed) {
+          switchTo(link, baud, now, setBaud);           // the answer still goes out at the old rate
+        }
+        return true;
+      }
+    }
+    sprintf(reply, "baudNO %lu", (unsigned long)baud);
+    send(reply);
+    return true;
+  }
+
+  if (strncmp(line, "test ", 5) == 0) {
+    if (testIntact(line)) {
+      send(line);
+    } else {
+      sprintf(reply, "testBAD %u", (unsigned)atoi(line + 5));
+      send(reply);
+    }
+    return true;
+  }
+
+  if (strcmp(line, "baudCommit") == 0) {
+    link->committed = true;
+    link->since = now;
+    link->rxErrors = 0;                                 // whatever arrived garbled before is not this rate's fault
+    return true;
+  }
+
+  if (strcmp(line, "ping") == 0) {
+    link->committed = true;                             // only sent once the ESP32 has committed, so a lost commit is no loss
+    link->since = now;
+    sprintf(reply, "pong %u", link->rxErrors);
+    link->rxErrors = 0;
+    send(reply);
+    return true;
+  }
+
+  if (strcmp(line, "baudDrop") == 0) {
+    if (link->baud != BAUD_DEFAULT) switchTo(link, BAUD_DEFAULT, now, setBaud);
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief a line arrived garbled (or was no command at all)
+ */
+void baudLinkError(BaudLink* link) {
+  if (link->rxErrors < 0xFFFF) link->rxErrors++;
+}
+
+/**
+ * @brief go back to 115200 if the ESP32 went quiet on a switched rate. call every pass
+ */
+void baudLinkPoll(BaudLink* link, uint32_t now, BaudSetCallback setBaud) {
+  if (link->baud == BAUD_DEFAULT) return;
+
+  uint32_t limit = link->committed ? BAUD_WATCHDOG_MS : BAUD_COMMIT_MS;
+  if (now - link->since >= limit) switchTo(link, BAUD_DEFAULT, now, setBaud);
+}
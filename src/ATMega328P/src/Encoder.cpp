@@ -0,0 +1,36 @@
+/**
+ * @file Encoder.cpp
+ * @brief transition table for the RPG quadrature decoding
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Same decoding as our Lab5 (previous AB shifted left by two, the 4 bit ABAB value picks the direction), except that
+ * the switch over the transitions is now a table generated by encoderTransition() and checked against the Lab5 cases
+ * below when compiling.
+ *
+ */
+
+#include "Encoder.h"
+
+#define STEP(t) encoderTransition(t)
+
+const int8_t ENCODER_STEPS[16] PROGMEM = {
+  STEP(0),  STEP(1),  STEP(2),  STEP(3),  STEP(4),  STEP(5),  STEP(6),  STEP(7),
+  STEP(8),  STEP(9),  STEP(10), STEP(11), STEP(12), STEP(13), STEP(14), STEP(15)
+};
+
+// clockwise: 0b0001, 0b0111, 0b1110, 0b1000
+static_assert(STEP(0b0001) == 1 && STEP(0b0111) == 1 && STEP(0b1110) == 1 && STEP(0b1000) == 1, "clockwise steps");
+// counter clockwise: 0b0010, 0b0100, 0b1101, 0b1011
+static_assert(STEP(0b0010) == -1 && STEP(0b0100) == -1 && STEP(0b1101) == -1 && STEP(0b1011) == -1, "ccw steps");
+// on detent / no change / missed state: everything else
+static_assert(STEP(0b0000) == 0 && STEP(0b0101) == 0 && STEP(0b1010) == 0 && STEP(0b1111) == 0, "no change");
+static_assert(STEP(0b0011) == 0 && STEP(0b1100) == 0 && STEP(0b0110) == 0 && STEP(0b1001) == 0, "missed state");
+
+/**
+ * @brief start decoding from the pins' current state (after the RPG was not watched for a while)
+ */
+void encoderReset(volatile Encoder* e, uint8_t ab) {
+  e->prev = ab & 0b11;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file Gesture.cpp
+ * @brief implementation of the button gesture recognizer
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Every button is a small state machine:
+ *
+ *   IDLE --press--> DOWN --release--> (click) IDLE, or WAIT_DOUBLE if double clicks are reported
+ *                   DOWN --holdMs---> HELD --release--> IDLE (a held press is no click)
+ *   WAIT_DOUBLE --press within doubleMs--> HELD (double reported, this press gives no click either)
+ *   WAIT_DOUBLE --doubleMs passed--------> IDLE (the click is reported now)
+ *
+ * Repeats run in DOWN and HELD alike. All times are compared as differences (now - then), so millis() wrapping around
+ * after 49 days does no harm.
+ *
+ */
+
+#include "Gesture.h"
+#include <string.h>
+
+enum GestureState : uint8_t { STATE_IDLE, STATE_DOWN, STATE_HELD, STATE_WAIT_DOUBLE };
+
+void gestureInit(GestureSet* set, const GestureConfig* config, uint8_t count) {
+  set->config = config;
+  set->count = (count > GESTURE_MAX_BUTTONS) ? GESTURE_MAX_BUTTONS : count;
+  memset(set->buttons, 0, sizeof(set->buttons));
+}
+
+/**
+ * @brief report an event if the button's config asks for it
+ */
+static void emit(const GestureConfig& c, uint8_t button, GestureEvent event, GestureCallback callback) {
+  if (c.events & (1 << event)) callback(button, event);
+}
+
+/**
+ * @brief debounced press: start timing, or finish a double click
+ */
+static void onPress(GestureButton& b, const GestureConfig& c, uint8_t button, uint32_t now, GestureCallback callback) {
+  emit(c, button, GESTURE_PRESS, callback);
+  if (b.state == STATE_WAIT_DOUBLE) {
+    emit(c, button, GESTURE_DOUBLE, callback);
+    b.state = STATE_HELD;
+  } else {
+    b.state = STATE_DOWN;
+  }
+  b.since = now;
+  b.nextRepeat = now + c.repeatDelayMs;
+}
+
+/**
+ * @brief debounced release: a click unless it was held (or was the second half of a double click)
+ */
+static void onRelease(GestureButton& b, const GestureConfig& c, uint8_t button, uint32_t now, GestureCallback callback) {
+  emit(c, button, GESTURE_RELEASE, callback);
+  if (b.state == STATE_DOWN && (c.events & GESTURE_ON_DOUBLE)) {
+    b.state = STATE_WAIT_DOUBLE;              // the click has to wait until we know it is not a double
+    b.since = now;
+    return;
+  }
+  if (b.state == STATE_DOWN) emit(c, button, GESTURE_CLICK, callback);
+  b.state = STATE_IDLE;
+}
+
+/**
+ * @brief feed one sample of all buttons
+ *
+ * @param pressed bit n set = button n is down right now (raw, bouncing is fine)
+ * @param now millis()
+ * @param callback gets every reported gesture, in the order they happened
+ */
+void gestureUpdate(GestureSet* set, uint8_t pressed, uint32_t now, GestureCallback callback) {
+  for (uint8_t i = 0; i < set->count; i++) {
+    GestureButton& b = set->buttons[i];
+    const GestureConfig& c = set->config[i];
+
+    // debounce: a new level counts once it has been stable for debounceMs
+    bool raw = (pressed >> i) & 1;
+    if (raw != b.raw) {
+      b.raw = raw;
+      b.rawAt = now;
+    }
+    if (b.raw != b.down && now - b.rawAt >= c.debounceMs) {
+      b.down = b.raw;
+      if (b.down) onPress(b, c, i, now, callback);
+      else        onRelease(b, c, i, now, callback);
+    }
+
+    switch (b.state) {
+      case STATE_DOWN:
+        if ((c.events & GESTURE_ON_HOLD) && now - b.since >= c.holdMs) {
+          emit(c, i, GESTURE_HOLD, callback);
+          b.state = STATE_HELD;
+        }
+        // held buttons keep repeating
+        // fall through
+      case STATE_HELD:
+        if ((c.events & GESTURE_ON_REPEAT) && (int32_t)(now - b.nextRepeat) >= 0) {
+          emit(c, i, GESTURE_REPEAT, callback);
+          b.nextRepeat += c.repeatMs;
+          if ((int32_t)(now - b.nextRepeat) >= 0) b.nextRepeat = now + c.repeatMs;    // fell behind, don't burst
+        }
+        break;
+      case STATE_WAIT_DOUBLE:
+        if (now - b.since >= c.doubleMs) {
+          emit(c, i, GESTURE_CLICK, callback);
+          b.state = STATE_IDLE;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+/**
+ * @brief true if every button is released and settled, so nothing can happen until a pin changes
+ *
+ * (no debounce, hold, repeat or double click timer is running, the caller may skip gestureUpdate() until then)
+ */
+bool gestureIdle(const GestureSet* set) {
+  for (uint8_t i = 0; i < set->count; i++) {
+    const GestureButton& b = set->buttons[i];
+    if (b.state != STATE_IDLE || b.raw || b.down) return false;
+  }
+  return true;
+}
+
+/**
+ * @return debounced level of a button
+ */
+bool gestureDown(const GestureSet* set, uint8_t button) {
+  return button < set->count && set->buttons[button].down;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file InputContext.cpp
+ * @brief implementation of the input context messages (Arduino side)
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "InputContext.h"
+#include <stdlib.h>
+#include <string.h>
+
+void inputContextDefault(InputContext* ctx) {
+  ctx->inputs = CTX_DEFAULT;
+  ctx->rpgDeltaMs = 0;
+  ctx->joystickMs = CTX_JOYSTICK_MS;
+}
+
+/**
+ * @brief read one number of a context line
+ *
+ * strtoul() alone also takes leading blanks, a sign or no digits at all (an empty field reads as 0), so a line that
+ * lost a byte on the way could still pass for a different context
+ *
+ * @param after the character that has to follow the number
+ * @return false if there is no number, it is larger than max or something else follows it
+ */
+static bool parseField(const char** p, int base, unsigned long max, char after, unsigned long* value) {
+  const char* start = *p;
+  bool digit = (*start >= '0' && *start <= '9') || (base == 16 && ((*start >= 'A' && *start <= 'F') ||
+                                                                   (*start >= 'a' && *start <= 'f')));
+  if (!digit) return false;
+  char* end;
+  *value = strtoul(start, &end, base);
+  if (*end != after || *value > max) return false;
+  *p = end + 1;
+  return true;
+}
+
+/**
+ * @brief read a "ctx <inputs hex> <rpg delta ms> <joystick ms>" line
+ *
+ * @param ctx only written if the whole line is valid
+ * @return false if it is no (complete) context line
+ */
+bool inputContextParse(const char* line, InputContext* ctx) {
+  if (strncmp(line, "ctx ", 4) != 0) return false;
+
+  const char* p = line + 4;
+  unsigned long inputs, rpgDeltaMs, joystickMs;
+  if (!parseField(&p, 16, CTX_ALL, ' ', &inputs) || !parseField(&p, 10, 0xFFFF, ' ', &rpgDeltaMs) ||
+      !parseField(&p, 10, 0xFFFF, '\0', &joystickMs)) {
+    return false;
+  }
+
+  ctx->inputs = (uint16_t)inputs;
+  ctx->rpgDeltaMs = (uint16_t)rpgDeltaMs;
+  ctx->joystickMs = (uint16_t)joystickMs;
+  return true;
+}
+
+bool inputContextSame(const InputContext* a, const InputContext* b) {
+  return a->inputs == b->inputs && a->rpgDeltaMs == b->rpgDeltaMs && a->joystickMs == b->joystickMs;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file TxQueue.cpp
+ * @brief implementation of the prioritized command queue
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Each priority is a ring of TX_QUEUE_SIZE codes. A push is O(1), except for commands with a coalesce key, which scan
+ * their own ring once (at most TX_QUEUE_SIZE entries) for a command to replace. Peek/pop look at no more than the three
+ * ring heads, so the cost per command is bounded no matter how many inputs fire at once.
+ *
+ * The queue is only used from the main loop (ISRs just set flags), so it needs no locking.
+ *
+ */
+
+#include "TxQueue.h"
+#include <string.h>
+
+#define TX_MASK (TX_QUEUE_SIZE - 1)
+
+static_assert((TX_QUEUE_SIZE & TX_MASK) == 0, "TX_QUEUE_SIZE has to be a power of two");
+
+void txQueueInit(TxQueue* q) {
+  memset(q, 0, sizeof(*q));
+}
+
+/**
+ * @brief queue a command
+ *
+ * @param code command to send
+ * @param priority which FIFO it goes into
+ * @param coalesceKey TX_NO_COALESCE, or a key: a queued command of the same priority and key is replaced by this one
+ * @param value carried along with the command (added to the queued one when coalescing, what goes past the
+ *              int8_t range is queued as a new command)
+ * @return false if it (or the part of its value that did not fit) was dropped because the FIFO is full
+ */
+bool txPush(TxQueue* q, uint8_t code, TxPriority priority, uint8_t coalesceKey, int8_t value) {
+  TxRing& r = q->rings[priority];
+
+  if (coalesceKey != TX_NO_COALESCE) {
+    // the newest queued command with this key (any older ones were filled up, see below)
+    int8_t found = -1;
+    for (uint8_t i = 0; i < r.count; i++) {
+      uint8_t slot = (r.head + i) & TX_MASK;
+      if (r.key[slot] == coalesceKey) found = slot;
+    }
+    if (found >= 0) {
+      int16_t sum = r.value[found] + value;
+      r.code[found] = code;                   // keeps its place in line, only the newest state is sent
+      if (sum >= INT8_MIN && sum <= INT8_MAX) {
+        r.value[found] = (int8_t)sum;
+        q->coalesced++;
+        return true;
+      }
+      // the total no longer fits: the queued command carries as much as it can, the rest is queued behind it
+      r.value[found] = (sum > 0) ? INT8_MAX : INT8_MIN;
+      value = (int8_t)(sum - r.value[found]);
+    }
+  }
+
+  if (r.count == TX_QUEUE_SIZE) {
+    if (q->dropped < 0xFFFF) q->dropped++;
+    return false;
+  }
+
+  uint8_t slot = (r.head + r.count) & TX_MASK;
+  r.code[slot] = code;
+  r.key[slot] = coalesceKey;
+  r.value[slot] = value;
+  r.count++;
+  return true;
+}
+
+/**
+ * @brief next command to send (oldest of the highest priority)
+ *
+ * @param value if not null, gets the command's value
+ * @return false if nothing is queued
+ */
+bool txPeek(const TxQueue* q, uint8_t* code, int8_t* value) {
+  for (uint8_t p = 0; p < TX_PRIORITIES; p++) {
+    const TxRing& r = q->rings[p];
+    if (r.count) {
+      *code = r.code[r.head];
+      if (value) *value = r.value[r.head];
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief remove the command txPeek() returned, once it is in the serial buffer
+ */
+void txPop(TxQueue* q) {
+  for (uint8_t p = 0; p < TX_PRIORITIES; p++) {
+    TxRing& r = q->rings[p];
+    if (r.count) {
+      r.head = (r.head + 1) & TX_MASK;
+      r.count--;
+      return;
+    }
+  }
+}
+
+/**
+ * @brief number of commands dropped since the last call (the caller reports them to the ESP32)
+ */
+uint16_t txTakeDropped(TxQueue* q) {
+  uint16_t dropped = q->dropped;
+  q->dropped = 0;
+  return dropped;
+}
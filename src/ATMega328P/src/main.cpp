@@ -18,36 +18,65 @@
  #include <Arduino.h>
  #include <avr/io.h>
  #include <avr/interrupt.h>
+ #include <util/atomic.h>
+ #include "BaudLink.h"
+ #include "Encoder.h"
+ #include "Gesture.h"
+ #include "InputContext.h"
+ #include "PinMap.h"
+ #include "TxQueue.h"
  
  //////////////////////////////////////////////////////////////////////////////////////////////////////////
  // ------------------------------------------ HARDWIRED PINS ------------------------------------------ //
  //////////////////////////////////////////////////////////////////////////////////////////////////////////
+ // Arduino pin numbers. Ports, PINx bits and PCMSK bits are derived from these (see PinMap.h)
+ 
  // RPG Definitions 
- const uint8_t RPG2_B = 13;              // PB5      
- const uint8_t RPG2_A = 12;              // PB4
- const uint8_t RPG1_B = 11;              // PB3
- const uint8_t RPG1_A = 10;              // PB2
+ constexpr uint8_t RPG2_B = 13;
+ constexpr uint8_t RPG2_A = 12;
+ constexpr uint8_t RPG1_B = 11;
+ constexpr uint8_t RPG1_A = 10;
  
  // System Buttons
- const uint8_t BTN_UP_ARROW   = 4;       // PD4
- const uint8_t BTN_HOME       = 3;       // PD3
- const uint8_t BTN_DOWN_ARROW = 2;       // PD2
+ constexpr uint8_t BTN_UP_ARROW   = 4;
+ constexpr uint8_t BTN_HOME       = 3;
+ constexpr uint8_t BTN_DOWN_ARROW = 2;
  
  // Controller Buttons
- const uint8_t BTN_CTRL_1A = 9;          // PB1
- const uint8_t BTN_CTRL_1B = 8;          // PB0
- const uint8_t BTN_CTRL_2A = 7;          // PD7
- const uint8_t BTN_CTRL_2B = 6;          // PD6
+ constexpr uint8_t BTN_CTRL_1A = 9;
+ constexpr uint8_t BTN_CTRL_1B = 8;
+ constexpr uint8_t BTN_CTRL_2A = 7;
+ constexpr uint8_t BTN_CTRL_2B = 6;
  
  // Controller Joysticks (analog)
- const uint8_t JOYSTICK_1X = A0;         // A0
- const uint8_t JOYSTICK_1Y = A1;         // A1
- const uint8_t JOYSTICK_2X = A2;         // A2
- const uint8_t JOYSTICK_2Y = A3;         // A3
+ const uint8_t JOYSTICK_1X = A0;
+ const uint8_t JOYSTICK_1Y = A1;
+ const uint8_t JOYSTICK_2X = A2;
+ const uint8_t JOYSTICK_2Y = A3;
  
  // Power Button pins 
- const uint8_t POWER_PIN  = A4;          // PC4 (A4)
- const uint8_t BTN_POWER = A5;           // PC5 (A5)
+ const uint8_t POWER_PIN  = A4;
+ constexpr uint8_t BTN_POWER = A5;
+ 
+ // RPGs, one line each: the pin decoded as A, the pin decoded as B. All have to be on port b (PCINT0)
+ struct EncoderPins {
+   uint8_t a, b;
+ };
+ 
+ constexpr EncoderPins RPG_PINS[] = {
+   { RPG1_A, RPG1_B },
+   { RPG2_B, RPG2_A },                  // decoded B first, so turning it clockwise is clockwise like RPG 1
+ };
+ constexpr uint8_t RPG_COUNT = sizeof(RPG_PINS) / sizeof(RPG_PINS[0]);
+ 
+ constexpr uint8_t rpgMask(uint8_t rpg) {
+   return pinMask(RPG_PINS[rpg].a) | pinMask(RPG_PINS[rpg].b);
+ }
+ 
+ // pins of this RPG and all after it
+ constexpr uint8_t rpgMasks(uint8_t first) {
+   return (first == RPG_COUNT) ? 0 : rpgMask(first) | rpgMasks(first + 1);
+ }
  
  ////////////////////////////////////////////////////////////////////////////////////////////////////////////
  // ------------------------------------------ Global Variables ------------------------------------------ //
@@ -55,385 +84,355 @@
  // store previous pinchanges 
  volatile uint8_t prevStateB = 0;
  volatile uint8_t prevStateC = 0;
- volatile uint8_t prevStateD = 0;
  
- // rpg changes
- volatile uint8_t prevRPG1A = 0;
- volatile uint8_t prevRPG1B = 0;
- volatile uint8_t prevRPG2A = 0;
- volatile uint8_t prevRPG2B = 0;
+ // rpg changes (quadrature state, see Encoder.h)
+ volatile Encoder rpgs[RPG_COUNT];
+ 
+ // rpg ticks counted by the ISR since the loop last took them (positive is clockwise). 16 bit, a fast spin makes more
+ // than 127 between two deltas
+ volatile int16_t rpgCount[RPG_COUNT];
  
- // dirty and data flags 
- volatile uint8_t portB_flags = 0;
- volatile bool portB_dirty = false;
- volatile uint8_t portD_flags = 0;
- volatile bool portD_dirty = false;
+ // a watched button pin changed, the loop has to sample the buttons again
+ volatile bool buttonActivity = true;
  
  // status of the system
  volatile bool powerON = true;
  
- volatile bool prevHomeBTN = false;
- 
- // status of controllers. This is depending on the current context of the system. Controllers enabled for Chess
- volatile bool controller1Enabled = false;
- volatile bool controller2Enabled = false;
- 
- bool prevHomeState = HIGH;
- unsigned long homeStartPress = 0;
+ // inputs the current screen on the ESP32 reads (see InputContext.h). The rest are not scanned or reported
+ InputContext inputContext;
+ uint8_t scannedButtons = 0;           // bit per Button
+ unsigned long lastRPGReport = 0;
+ 
+ ////////////////////////////////////////////////////////////////////////////////////////////////////
+ // ------------------------------------------ Commands ------------------------------------------ //
+ ////////////////////////////////////////////////////////////////////////////////////////////////////
+ // everything sent to the ESP32 (*** SEE README FOR COMMANDS ***). inputs queue one of these, see TxQueue.h
+ enum Command : uint8_t {
+   CMD_UP_ARROW, CMD_DOWN_ARROW, CMD_HOME_CLICK, CMD_HOME_HOLD,
+   CMD_CTRL_1A, CMD_CTRL_1B, CMD_CTRL_2A, CMD_CTRL_2B,
+   CMD_CTRL_1A_DOUBLE, CMD_CTRL_1B_DOUBLE, CMD_CTRL_2A_DOUBLE, CMD_CTRL_2B_DOUBLE,
+   CMD_RPG1_CW, CMD_RPG1_CCW, CMD_RPG2_CW, CMD_RPG2_CCW,
+   CMD_JOY1_UP, CMD_JOY1_DOWN, CMD_JOY1_LEFT, CMD_JOY1_RIGHT,
+   CMD_JOY2_UP, CMD_JOY2_DOWN, CMD_JOY2_LEFT, CMD_JOY2_RIGHT,
+   CMD_POWER_OFF, CMD_POWER_ON,
+   CMD_RPG1_DELTA, CMD_RPG2_DELTA,       // carry the ticks as a value, e.g. "rpg1Delta -3"
+   CMD_COUNT
+ };
+ 
+ // what each RPG sends: a clockwise tick, a counter clockwise tick, a delta
+ const uint8_t RPG_COMMANDS[][3] = {
+   { CMD_RPG1_CW, CMD_RPG1_CCW, CMD_RPG1_DELTA },
+   { CMD_RPG2_CW, CMD_RPG2_CCW, CMD_RPG2_DELTA },
+ };
+ static_assert(sizeof(RPG_COMMANDS) / sizeof(RPG_COMMANDS[0]) == RPG_COUNT, "every RPG needs its commands");
+ 
+ const char* const COMMAND_NAMES[CMD_COUNT] = {
+   "btnUpArrow", "btnDownArrow", "btnHomeClick", "btnHomeHold",
+   "controller1A", "controller1B", "controller2A", "controller2B",
+   "controller1ADouble", "controller1BDouble", "controller2ADouble", "controller2BDouble",
+   "rpg1CW", "rpg1CCW", "rpg2CW", "rpg2CCW",
+   "joystick1UP", "joystick1DOWN", "joystick1LEFT", "joystick1RIGHT",
+   "joystick2UP", "joystick2DOWN", "joystick2LEFT", "joystick2RIGHT",
+   "powerOFF", "powerON",
+   "rpg1Delta", "rpg2Delta"
+ };
+ 
+ // "txOverflow 65535\r\n", the notice sent when commands had to be dropped
+ const uint8_t OVERFLOW_LINE_MAX = 18;
+ 
+ TxQueue txQueue;
+ 
+ // UART rate, negotiated by the ESP32 (see BaudLink.h)
+ BaudLink baudLink;
+ 
+ // partial line from the ESP32. longest is a link test line (~42 chars)
+ char rxLine[64];
+ uint8_t rxLen = 0;
+ bool rxGarbled = false;
+ 
+ // joysticks are streamed while held, at the context's interval (instead of as fast as the loop and UART allow)
+ unsigned long lastJoystickPoll = 0;
  
  /////////////////////////////////////////////////////////////////////////////////////////////////////////
  // ------------------------------------------ Button Timing ------------------------------------------ //
  /////////////////////////////////////////////////////////////////////////////////////////////////////////
- // debouncing for the buttons
- const int DEBOUNCE_MS = 50;
+ // debouncing for the buttons (a pin has to keep its new level this long)
+ const int DEBOUNCE_MS = 30;
  const int HOLD_TIME_MS = 1000;                // hold timing timing for power & home button
  const int MIN_ON_TIME_MS = 2000; 
+ const int POWER_SETTLE_MS = 500;              // inputs are not scanned this long after reset (power settling)
+ const int DOUBLE_CLICK_MS = 300;              // second press of a double click has to come within this
+ const int REPEAT_DELAY_MS = 400;              // arrows held this long start repeating...
+ const int REPEAT_MS = 120;                    // ...every REPEAT_MS
+ 
+ // every button the loop polls, bit n of the sample passed to gestureUpdate()
+ enum Button : uint8_t {
+   BUTTON_UP, BUTTON_DOWN, BUTTON_HOME,
+   BUTTON_CTRL_1A, BUTTON_CTRL_1B, BUTTON_CTRL_2A, BUTTON_CTRL_2B,
+   BUTTON_POWER,
+   BUTTON_COUNT
+ };
+ 
+ // what each button reports. arrows fire on press and repeat while held, home tells clicks from holds,
+ // controller buttons fire on press and additionally report a double click, power only reacts to a hold
+ const GestureConfig BUTTON_GESTURES[BUTTON_COUNT] = {
+   // events                                  debounce     hold          double           repeat delay     repeat
+   { GESTURE_ON_PRESS | GESTURE_ON_REPEAT,    DEBOUNCE_MS, 0,            0,               REPEAT_DELAY_MS, REPEAT_MS },  // up arrow
+   { GESTURE_ON_PRESS | GESTURE_ON_REPEAT,    DEBOUNCE_MS, 0,            0,               REPEAT_DELAY_MS, REPEAT_MS },  // down arrow
+   { GESTURE_ON_CLICK | GESTURE_ON_HOLD,      DEBOUNCE_MS, HOLD_TIME_MS, 0,               0,               0 },          // home
+   { GESTURE_ON_PRESS | GESTURE_ON_DOUBLE,    DEBOUNCE_MS, 0,            DOUBLE_CLICK_MS, 0,               0 },          // controller 1 A
+   { GESTURE_ON_PRESS | GESTURE_ON_DOUBLE,    DEBOUNCE_MS, 0,            DOUBLE_CLICK_MS, 0,               0 },          // controller 1 B
+   { GESTURE_ON_PRESS | GESTURE_ON_DOUBLE,    DEBOUNCE_MS, 0,            DOUBLE_CLICK_MS, 0,               0 },          // controller 2 A
+   { GESTURE_ON_PRESS | GESTURE_ON_DOUBLE,    DEBOUNCE_MS, 0,            DOUBLE_CLICK_MS, 0,               0 },          // controller 2 B
+   { GESTURE_ON_HOLD,                         DEBOUNCE_MS, HOLD_TIME_MS, 0,               0,               0 },          // power
+ };
+ 
+ GestureSet buttons;
+ 
+ // pin of every Button, in Button order
+ constexpr uint8_t BUTTON_PINS[BUTTON_COUNT] = {
+   BTN_UP_ARROW, BTN_DOWN_ARROW, BTN_HOME, BTN_CTRL_1A, BTN_CTRL_1B, BTN_CTRL_2A, BTN_CTRL_2B, BTN_POWER
+ };
+ 
+ // context bit of every Button (see InputContext.h), 0 = always scanned
+ const uint16_t BUTTON_CONTEXT[BUTTON_COUNT] = {
+   CTX_UP_ARROW, CTX_DOWN_ARROW, CTX_HOME, CTX_C1A, CTX_C1B, CTX_C2A, CTX_C2B, 0
+ };
+ 
+ // buttons that share port b (and its pin change interrupt) with the RPGs
+ constexpr uint8_t PORTB_BUTTONS = portMask(BUTTON_PINS, BUTTON_COUNT, PORT_B);
+ 
+ static_assert((PORTB_BUTTONS & rpgMasks(0)) == 0, "a button and an RPG on the same pin");
  
  // Global variables for power management
  volatile bool power_state = true;
- volatile uint32_t hold_counter = 0;
- volatile bool button_was_pressed = false;
- volatile unsigned long power_button_press_start = 0;
+ unsigned long powerOnAt = 0;
+ bool inputsSettled = false;
  
  ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
  // ------------------------------------------ Interrupts Service Routines ------------------------------------------ //
  ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
  
  /**
-  * @brief Construct a new ISR object for PCINT[0..7] (port b)
+  * @brief A (bit 1) and B (bit 0) of an RPG, as the decoder takes them
+  */
+ inline uint8_t rpgAB(uint8_t rpg, uint8_t pinB) {
+   return ((pinB & pinMask(RPG_PINS[rpg].a)) ? 0b10 : 0) | ((pinB & pinMask(RPG_PINS[rpg].b)) ? 0b01 : 0);
+ }
+ 
+ /**
+  * @brief decode RPG I and every one after it
   * 
-  * PCINT0 (PB0): BTN_CONTROLLER_1B
-  * PCINT1 (PB1): BTN_CONTROLLER_1A
-  * PCINT2 (PB2): RPG_1A
-  * PCINT3 (PB3): RPG_1B
-  * PCINT4 (PB4): RPG_2A
-  * PCINT5 (PB5): RPG_2B
-  * PCINT6: none
-  * PCINT7: none
+  * unrolled at compile time, so every pin mask is a constant and each RPG costs two bit tests and a table lookup.
+  * An RPG whose pins are masked (not in the context) is skipped.
+  */
+ template <uint8_t I>
+ inline void decodeRPGs(uint8_t pinB) {
+   static_assert(pinPort(RPG_PINS[I].a) == PORT_B && pinPort(RPG_PINS[I].b) == PORT_B, "RPGs have to be on port b");
+ 
+   if (PCMSK0 & rpgMask(I)) {
+     int8_t step = encoderStep(&rpgs[I], rpgAB(I, pinB));
+     if (step > 0 && rpgCount[I] <  INT16_MAX) rpgCount[I]++;   // counted for the loop (saturating, the loop takes
+     if (step < 0 && rpgCount[I] > -INT16_MAX) rpgCount[I]--;   // them long before)
+   }
+   decodeRPGs<I + 1>(pinB);
+ }
+ 
+ template <>
+ inline void decodeRPGs<RPG_COUNT>(uint8_t) {
+ }
+ 
+ /**
+  * @brief Construct a new ISR object for PCINT[0..7] (port b)
   * 
-  * Because these are pin changes and we have buttons, the interrupt will be called twice for all buttons - which is not ideal.
-  * To combat this, we track the previous state of the pins and mask each button.
-  * If there is a change then we update the current state to reflect this.
-  * The entire current state of pin is then sent over UART
+  * the RPG pins (RPG_PINS) and controller 1's buttons (PORTB_BUTTONS)
   * 
-  * Yes, this is not a 'short' ISR, but as we have all GPIO pins attached it is necessary that the ISR is more involved
+  * Only the RPGs are decoded here: every quadrature edge matters, so they cannot wait for the loop. The buttons used to
+  * be debounced in here with _delay_ms, which stalled every other interrupt (and a turning RPG) for 50 ms per press.
+  * Ticks are counted (not flagged), so a fast spin between two loop passes loses nothing. Only pins of the current
+  * context are unmasked (see applyInputContext), and an RPG left out of it is not decoded either.
   * 
   */
  ISR(PCINT0_vect) {
-   uint8_t pinB                = PINB;         // all pins to be masked below...
- 
-   bool isController1BClicked  = false;
-   bool isController1AClicked  = false;
-   bool isRPG1Clockwise        = false;
-   bool isRPG1CounterClockwise = false;
-   bool isRPG2Clockwise        = false;
-   bool isRPG2CounterClockwise = false;
- 
-   // check controller 1 B
-   if ((prevStateB & (1 << PB0)) && !(pinB & (1 << PB0))) {
-     _delay_ms(DEBOUNCE_MS);
- 
-     pinB = PINB;
-     if ((prevStateB & (1 << PB0)) && !(pinB & (1 << PB0))) {
-       isController1BClicked = true;
-     }
-   }
+   uint8_t pinB = PINB;
  
-   // check controller 1 A
-   if ((prevStateB & (1 << PB1)) && !(pinB & (1 << PB1))) {
-     _delay_ms(DEBOUNCE_MS);
-     
-     pinB = PINB;
-     if ((prevStateB & (1 << PB1)) && !(pinB & (1 << PB1))) {
-       isController1AClicked = true;
-     }
+   decodeRPGs<0>(pinB);
+ 
+   // controller 1 buttons are polled, an edge only tells the loop to look
+   if ((pinB ^ prevStateB) & PORTB_BUTTONS) {
+     buttonActivity = true;
    }
  
-    // check RPG 1                                                                        here we perform a similar process to our Lab5, combining both A and B.
-    uint8_t currRPG1A = (pinB & (1 << PB2)) ? 1 : 0;                                   // We shift left by one to make space for rpg1b.
-    uint8_t currRPG1B = (pinB & (1 << PB3)) ? 1 : 0;                                   // Then we combine this with the previous & use codes to determine the rotation.
-    uint8_t currRPG1       = (currRPG1A << 1) | currRPG1B;                             // now a 2 bit AB 00, 01, 10, 11 value
-    uint8_t transitionRPG1 = (prevRPG1A << 3) | (prevRPG1B << 2) | (currRPG1);         // now a 4 bit ABAB value, with cases below
-  
-    switch (transitionRPG1) {
-      case 0b0001: case 0b0111: case 0b1110: case 0b1000:
-        // Clockwise
-        isRPG1Clockwise = true;
-        break;
-      case 0b0010: case 0b0100: case 0b1101: case 0b1011:
-        // Counter-clockwise
-        isRPG1CounterClockwise = true;
-        break;
-      default:
-        // on detent; ignore
-        break;
-    }
- 
-    prevRPG1A = currRPG1A; 
-    prevRPG1B = currRPG1B;
- 
-    // check RPG 2                                                                        here we perform a similar process to our Lab5, combining both A and B.
-    uint8_t currRPG2A = (pinB & (1 << PB5)) ? 1 : 0;                                   // We shift left by one to make space for rpg1b.
-    uint8_t currRPG2B = (pinB & (1 << PB4)) ? 1 : 0;                                   // Then we combine this with the previous & use codes to determine the rotation.
-    uint8_t currRPG2       = (currRPG2A << 1) | currRPG2B;                             // now a 2 bit AB 00, 01, 10, 11 value
-    uint8_t transitionRPG2 = (prevRPG2A << 3) | (prevRPG2B << 2) | (currRPG2);         // now a 4 bit ABAB value, with cases below
-  
-    switch (transitionRPG2) {
-      case 0b0001: case 0b0111: case 0b1110: case 0b1000:
-        // Clockwise
-        isRPG2Clockwise = true;
-        break;
-      case 0b0010: case 0b0100: case 0b1101: case 0b1011:
-        // Counter-clockwise
-        isRPG2CounterClockwise = true;
-        break;
-      default:
-        // on detent; ignore
-        break;
-    }
- 
-    prevRPG2A = currRPG2A; 
-    prevRPG2B = currRPG2B;
- 
-    // now, we build the flags to send over UART                                 Flags       
-    uint8_t flags = 0;                                                         
-    flags |= isController1BClicked << 0;                                       // b0: controller 1 'B'
-    flags |= isController1AClicked << 1;                                       // b1: controller 1 'A'
-    flags |= isRPG1Clockwise << 2;                                             // b2: RPG1 cw
-    flags |= isRPG1CounterClockwise << 3;                                      // b3: RPG1 ccw (these are mutually exclusive)
-    flags |= isRPG2Clockwise << 4;                                             // b4: RPG2 cw
-    flags |= isRPG2CounterClockwise << 5;                                      // b5: RPG2 ccw (again, these are mutually exclusive)
-    flags |= (0 << 6) | ( 0 << 7);                                             // b6,7: 0
- 
-    // update flags and set dirty if there was an action
-    if (flags != 0) { 
-     portB_flags = flags;
-     portB_dirty = true;
-    }
- 
-    prevStateB = pinB;
+   prevStateB = pinB;
  }
  
  /**
-  * @brief Construct a new ISR object for PCINT[16..23] (port d)
+  * @brief Construct a new ISR object for PCINT[8..14] (port c) and PCINT[16..23] (port d)
   * 
-  * PCINT16 (PD0): none (uart rx)
-  * PCINT17 (PD1): none (uart tx)
-  * PCINT18 (PD2): BTN_DOWN_ARROW
-  * PCINT19 (PD3): none
-  * PCINT20 (PD4): BTN_UP_ARROW
-  * PCINT21 (PD5): none 
-  * PCINT22 (PD6): BTN_CTRL_2B
-  * PCINT23 (PD7): BTN_CTRL_2A
+  * the buttons on those ports (BUTTON_PINS), e.g. power, the arrows, home and controller 2's buttons.
+  * They are still debounced and timed by the loop, an edge only tells it to start sampling again
   * 
   */
- ISR(PCINT2_vect) {
-   uint8_t pinD = PIND;        // all pins to be masked below...
- 
-   // boolean values to build a payload for message
-   bool isDownArrowClicked      = false;
-   bool isUpArrowClicked        = false;
-   bool isController2BClicked   = false;
-   bool isController2AClicked   = false;
- 
-   // check down arrow
-   if ((prevStateD & (1 << PD2)) && !(pinD & (1 << PD2))) {
-     _delay_ms(DEBOUNCE_MS);
+ ISR(PCINT1_vect) {
+   buttonActivity = true;
+ }
  
-     pinD = PIND;
-     if ((prevStateD & (1 << PD2)) && !(pinD & (1 << PD2))) {
-       isDownArrowClicked = true;
-     }
-   }
+ ISR(PCINT2_vect) {
+   buttonActivity = true;
+ }
  
-   // check up arrow 
-   if ((prevStateD & (1 << PD4)) && !(pinD & (1 << PD4))) {
-     _delay_ms(DEBOUNCE_MS);
+ /**
+  * @brief scan only what the current context needs
+  * 
+  * unmasks the pin change interrupts of the RPGs and buttons in the context (the mask bits line up with the port bits)
+  * and powers the ADC only while a joystick is in it. Called whenever the ESP32 sends a different context.
+  * 
+  */
+ void applyInputContext() {
+   uint16_t in = inputContext.inputs;
  
-     pinD = PIND;
-     if ((prevStateD & (1 << PD4)) && !(pinD & (1 << PD4))) {
-       isUpArrowClicked = true;
-     }
+   // PCMSK0..2, in PinPort order (port b, c, d)
+   uint8_t mask[3] = { 0, 0, 0 };
+   for (uint8_t rpg = 0; rpg < RPG_COUNT; rpg++) {
+     if (in & (CTX_RPG1 << rpg)) mask[PORT_B] |= rpgMask(rpg);
    }
  
-   // check controller 2 B
-   if ((prevStateD & (1 << PD6)) && !(pinD & (1 << PD6))) {
-     _delay_ms(DEBOUNCE_MS);
- 
-     pinD = PIND;
-     if ((prevStateD & (1 << PD6)) && !(pinD & (1 << PD6))) {
-       isController2BClicked = true;
+   // bit per Button
+   scannedButtons = 0;
+   for (uint8_t button = 0; button < BUTTON_COUNT; button++) {
+     if (BUTTON_CONTEXT[button] == 0 || (in & BUTTON_CONTEXT[button])) {
+       scannedButtons |= (1 << button);
+       mask[pinPort(BUTTON_PINS[button])] |= pinMask(BUTTON_PINS[button]);
      }
    }
  
-   // check controller 2 A
-   if ((prevStateD & (1 << PD7)) && !(pinD & (1 << PD7))) {
-     _delay_ms(DEBOUNCE_MS);
- 
-     pinD = PIND;
-     if ((prevStateD & (1 << PD7)) && !(pinD & (1 << PD7))) {
-       isController2AClicked = true;
+   ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+     PCMSK0 = mask[PORT_B];
+     PCMSK1 = mask[PORT_C];
+     PCMSK2 = mask[PORT_D];
+     PCICR |= (1 << PCIE0) | (1 << PCIE1) | (1 << PCIE2);
+ 
+     // an RPG that was masked may have moved, start decoding from where it is now
+     uint8_t pinB = PINB;
+     for (uint8_t rpg = 0; rpg < RPG_COUNT; rpg++) {
+       encoderReset(&rpgs[rpg], rpgAB(rpg, pinB));
+       rpgCount[rpg] = 0;
      }
-   }
+     prevStateB = pinB;
  
-   // now, we build the flags to send over UART                                 Flags       
-   uint8_t flags = 0;                                                           // b0: none 
-   flags |= (0 << 0) | (0 << 1);                                                // b1: none
-   flags |= isDownArrowClicked << 2;                                            // b2: down arrow clicked
-   flags |= (0 << 3);                                                           // b3: home clicked
-   flags |= isUpArrowClicked << 4;                                              // b4: up arrow clicked 
-   flags |= (0 << 5);                                                           // b5: none
-   flags |= isController2BClicked << 6;                                         // b6: controller 'B' clicked
-   flags |= isController2AClicked << 7;                                         // b7: controller 'A' clicked
- 
-   // update flags and set dirty if there was an action
-   if (flags != 0) {
-     portD_flags = flags;
-     portD_dirty = true;
+     buttonActivity = true;                               // sample once with the new set
    }
  
-   prevStateD = pinD;
+   // the ADC draws current while enabled, only keep it on for the joysticks
+   if (in & CTX_JOYSTICKS) ADCSRA |= (1 << ADEN);
+   else                    ADCSRA &= ~(1 << ADEN);
  }
  
+ ////////////////////////////////////////////////////////////////////////////////////////////////////////
+ // ------------------------------------------ Power Button ------------------------------------------ //
+ ////////////////////////////////////////////////////////////////////////////////////////////////////////
+ 
  /**
-  * @brief enable pin change interrupts
+  * @brief handle safe power toggling
   * 
-  * enable PCINT for ALL buttons connected to the Arduino
+  * called when the power button has been held for HOLD_TIME_MS (once per press, so there is no waiting for the release).
+  * Right after switching on, holds are ignored for MIN_ON_TIME_MS so the same long press cannot switch it straight off
+  * again. This used to be a delay(MIN_ON_TIME_MS) that froze every other input for two seconds.
   * 
   */
- void enableButtonInterrupts() {
-   PCICR  |= (1 << PCIE0) | (1 << PCIE1) | (1 << PCIE2);  // turn on pcint for b, c, and d ports
-   PCMSK0 |= 0b00111111;                                  // PCINT[0..5] (port b)
-   PCMSK1 |= 0x00;                                        // NONE of pinchange 1 (port C)
-   PCMSK2 |= 0xFF;                                        // ALL portd PCINT[16..23] (port d)
+ void togglePower(void) {
+   if (power_state) {
+     if (millis() - powerOnAt < (unsigned long)MIN_ON_TIME_MS) {
+       return;
+     }
+     // Power OFF sequence
+     txPush(&txQueue, CMD_POWER_OFF, TX_HIGH, TX_NO_COALESCE); // Notify ESP32 about power off
+     digitalWrite(POWER_PIN, LOW);
+     power_state = false;
+   } else {
+     // Power ON sequence
+     digitalWrite(POWER_PIN, HIGH);
+     power_state = true;
+     powerOnAt = millis();
+     txPush(&txQueue, CMD_POWER_ON, TX_HIGH, TX_NO_COALESCE); // Notify ESP32 about power on
+   }
  }
  
- ////////////////////////////////////////////////////////////////////////////////////////////////////////
- // ------------------------------------------ Power Button ------------------------------------------ //
- ////////////////////////////////////////////////////////////////////////////////////////////////////////
+ ///////////////////////////////////////////////////////////////////////////////////////////////////
+ // ------------------------------------------ Buttons ------------------------------------------ //
+ ///////////////////////////////////////////////////////////////////////////////////////////////////
  
  /**
-  * @brief handle safe power toggling
+  * @brief queue a recognized button gesture for the ESP32
   * 
-  * We are limited to using polling for multifunctionality buttons as we cannot check for a press and hold inside of interrupt.
-  *
-  * programmed for two signals: 
-  * 1. press > 1 second ---> turn off
-  * 2. press < 1 second ---> turn on 
+  * Which gestures a button reports is set in BUTTON_GESTURES, so every case here only has to pick the command:
+  * - arrows: press and auto repeat both send the arrow command
+  * - home: btnHomeClick (released within a second) or btnHomeHold (sent as soon as the second is up)
+  * - controllers: the button command on every press, plus e.g. controller1ADouble on the second press of a double click
   * 
-  */
-
-  /**
-  * @brief handle power button
+  * These commands are processed by the ESP32, completely abstracted away from the Arduino. 
+  * The functionality of the command is dependent on the current context displayed on the LED Matrix
   * 
-  * Implements power control logic from the second code sample
-  * Uses debouncing, hold detection, and power state management
+  * @param button Button that changed
+  * @param event what it did
   */
- void checkPowerBTN(void) {
-  // Read button state (active LOW)
-  bool buttonPressed = (digitalRead(BTN_POWER) == LOW);
-  
-  if (buttonPressed) {
-    // Debounce
-    delay(DEBOUNCE_MS);
-    buttonPressed = (digitalRead(BTN_POWER) == LOW);
-    
-    if (buttonPressed) {
-      // Confirmed press
-      if (!button_was_pressed) {
-        button_was_pressed = true;
-        power_button_press_start = millis();
-      }
-      
-      // Calculate hold time
-      unsigned long hold_time = millis() - power_button_press_start;
-      
-      // Check if hold time exceeds threshold
-      if (hold_time >= HOLD_TIME_MS) {
-        if (power_state) {
-          // Power OFF sequence
-          Serial.println("powerOFF"); // Notify ESP32 about power off
-          digitalWrite(POWER_PIN, LOW);
-          power_state = false;
-          
-          // Wait for button release before proceeding
-          while (digitalRead(BTN_POWER) == LOW) {
-            delay(10);
-          }
-        } else {
-          // Power ON sequence
-          digitalWrite(POWER_PIN, HIGH);
-          power_state = true;
-          Serial.println("powerON"); // Notify ESP32 about power on
-          
-          // Prevent instant turn-off
-          delay(MIN_ON_TIME_MS);
-          
-          // Wait for button release
-          while (digitalRead(BTN_POWER) == LOW) {
-            delay(10);
-          }
-        }
-      }
-    }
-  } else {
-    // Button released
-    button_was_pressed = false;
-  }
-}
-
- void handle_power_toggle(void) {
-   // Implementation moved to checkPowerBTN for simplicity
-   checkPowerBTN();
- }
+ void onButtonGesture(uint8_t button, GestureEvent event) {
+   // left out of the context while it was down (its release / click would reach a screen that does not read it)
+   if (!(scannedButtons & (1 << button))) {
+     return;
+   }
  
+   bool isDouble = (event == GESTURE_DOUBLE);
+   uint8_t command;
+ 
+   switch (button) {
+     case BUTTON_UP:      command = CMD_UP_ARROW;                                        break;
+     case BUTTON_DOWN:    command = CMD_DOWN_ARROW;                                      break;
+     case BUTTON_HOME:    command = (event == GESTURE_HOLD) ? CMD_HOME_HOLD : CMD_HOME_CLICK; break;
+     case BUTTON_CTRL_1A: command = isDouble ? CMD_CTRL_1A_DOUBLE : CMD_CTRL_1A;          break;
+     case BUTTON_CTRL_1B: command = isDouble ? CMD_CTRL_1B_DOUBLE : CMD_CTRL_1B;          break;
+     case BUTTON_CTRL_2A: command = isDouble ? CMD_CTRL_2A_DOUBLE : CMD_CTRL_2A;          break;
+     case BUTTON_CTRL_2B: command = isDouble ? CMD_CTRL_2B_DOUBLE : CMD_CTRL_2B;          break;
+     case BUTTON_POWER:   togglePower();                                                 return;
+     default:             return;
+   }
  
- ///////////////////////////////////////////////////////////////////////////////////////////////////////
- // ------------------------------------------ Home Button ------------------------------------------ //
- ///////////////////////////////////////////////////////////////////////////////////////////////////////
+   txPush(&txQueue, command, TX_HIGH, TX_NO_COALESCE);
+ }
  
  /**
-  * @brief handle home button click  
+  * @brief sample every button and run the gesture recognizer
   * 
-  * We are limited to using polling for multifunctionality buttons as we cannot check for a press and hold inside of interrupt. Maybe you can? we struggled to 
+  * The pins are read straight from the port registers (all buttons are active low with pullups), one bit per Button.
+  * Debouncing and click/hold timing are done with timestamps in gestureUpdate(), so this never waits and interrupts
+  * stay enabled.
   * 
-  * programmed for two signals: 
-  * 1. press > 1 second
-  * 2. press < 1 second
-  * 
-  * These commands are processed by the ESP32, completely abstracted away from the Arduino. 
-  * The functionality of the command is dependent on the current context displayed on the LED Matrix
+  * While every button is released and settled nothing can happen until a pin changes, so sampling stops until a pin
+  * change interrupt sets buttonActivity. Buttons outside the context are read as released.
   * 
   */
- void checkHomeBTN(void) {
-   cli();
-   bool currHomeState = digitalRead(BTN_HOME);
- 
-   // press detected. start 'stopwatch'
-   if (prevHomeState == HIGH && currHomeState == LOW) {
-     _delay_ms(DEBOUNCE_MS);
-     if (digitalRead(BTN_HOME) == LOW) {
-       homeStartPress = millis();
-     }
+ void checkButtons(void) {
+   bool activity;
+   ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+     activity = buttonActivity;
+     buttonActivity = false;                              // cleared before the pins are read, a later edge sets it again
+   }
+   if (!activity && gestureIdle(&buttons)) {
+     return;
    }
  
-   // release detected, end 'stopwatch'
-   if (prevHomeState == LOW && currHomeState == HIGH) {
-     _delay_ms(DEBOUNCE_MS);
-     if (digitalRead(BTN_HOME) == HIGH) {
-       unsigned long duration = millis() - homeStartPress;
-       if (duration < 1000) {
-         // Serial.write(0x02);             // short press: select
-         Serial.println("btnHomeClick");
-       } else {
-         // Serial.write(0x03);             // long press: exit
-         Serial.println("btnHomeHold");
-       }
+   // PINx in PinPort order, read once so all buttons are sampled at the same moment
+   uint8_t pins[3] = { PINB, PINC, PIND };
+ 
+   uint8_t pressed = 0;
+   for (uint8_t button = 0; button < BUTTON_COUNT; button++) {
+     if (!(pins[pinPort(BUTTON_PINS[button])] & pinMask(BUTTON_PINS[button]))) {
+       pressed |= (1 << button);
      }
    }
+   pressed &= scannedButtons;
  
-   prevHomeState = currHomeState;
-   sei(); 
+   gestureUpdate(&buttons, pressed, millis(), onButtonGesture);
  }
  
  ////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -460,53 +459,18 @@
    int lowThreshold  = deadzone;       
    int highThreshold = 1023 - deadzone; 
  
-   String direction;
- 
-   if (x < lowThreshold)              direction = "right";
-   else if (x > highThreshold)        direction = "left";
-   else if (y < lowThreshold)         direction = "up";
-   else if (y > highThreshold)        direction = "down";
- 
-   // MAP TO MESSAGE 
-   // uint8_t code = 0xFF;
-   String code = "NONE";
-   if (controllerNumber == 1) {
-     if (direction == "up") {
-         // code = 0x07; 
-         code = "joystick1UP";
-     } else if (direction == "down") {
-         // code = 0x08;  
-         code = "joystick1DOWN";
-     } else if (direction == "left") {
-         // code = 0x09;  
-         code = "joystick1LEFT";
-     } else if (direction == "right") {
-         // code = 0x0A; 
-         code = "joystick1RIGHT";
-     }
-   } else {  // controller 2
-     if (direction == "up") {
-         // code = 0x0D; 
-         code = "joystick2UP";
-     } else if (direction == "down") {
-         // code = 0x0E; 
-         code = "joystick2DOWN";
-     } else if (direction == "left") {
-         // code = 0x0F;
-         code = "joystick2LEFT";
-     } else if (direction == "right") {
-         // code = 0x10;  
-         code = "joystick2RIGHT";
-     }
-   }
+   // commands are in UP, DOWN, LEFT, RIGHT order for each controller
+   uint8_t first = (controllerNumber == 1) ? CMD_JOY1_UP : CMD_JOY2_UP;
+   uint8_t code;
  
- // only send if actual movement
- // if (code != 0xFF) {
- //   Serial.write(code);
- // }
- if (code != "NONE") {
-   Serial.println(code);
- }
+   if (x < lowThreshold)              code = first + 3;     // right
+   else if (x > highThreshold)        code = first + 2;     // left
+   else if (y < lowThreshold)         code = first;         // up
+   else if (y > highThreshold)        code = first + 1;     // down
+   else                               return;               // only send if actual movement
+ 
+   // a held stick is streamed, so only its newest direction has to wait in the queue (one per controller)
+   txPush(&txQueue, code, TX_LOW, controllerNumber);
  }
  
  ///////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -514,81 +478,178 @@
  ///////////////////////////////////////////////////////////////////////////////////////////////////////////
  
  /**
-  * @brief handle incoming messages from the ESP32
+  * @brief send a link message straight away (rate negotiation answers, pongs)
+  * 
+  * @param line 
+  */
+ void sendLinkLine(const char* line) {
+   Serial.println(line);
+ }
+ 
+ /**
+  * @brief switch the UART rate once everything already written has left
   * 
-  * checks for messages to enable or disable the controllers
+  * @param baud 
+  */
+ void setLinkBaud(uint32_t baud) {
+   Serial.flush();
+   Serial.begin(baud);
+ }
+ 
+ /**
+  * @brief handle one complete line from the ESP32
+  * 
+  * checks for the input context of the ESP32's screen (and the older messages that only enable or disable the controller
+  * joysticks) and hands link messages (rate negotiation, pings) to the BaudLink. Anything else can only be a damaged line.
   * 
   * *** SEE README FOR COMMANDS ***
   * 
+  * @param command 
   */
- void processESP32Message() {
-   while (Serial.available()) {
-     String command = Serial.readStringUntil('\n');
-     command.trim();  // remove whitespace + newline characters
- 
-     if (command == "enableController1") {
-       controller1Enabled = true;
-     } 
-     else if (command == "enableController2") {
-       controller2Enabled = true;
-     } else {
-       // debugging
-       Serial.print("CURRENT STATE: ");
-       Serial.print(command);
-     }
+ void handleESP32Line(const char* command) {
+   if (baudLinkLine(&baudLink, command, millis(), sendLinkLine, setLinkBaud)) {
+     return;
+   }
+ 
+   InputContext ctx = inputContext;
+ 
+   if (inputContextParse(command, &ctx)) {
+     // repeated every few seconds, only a different one is applied
+   }
+   else if (strcmp(command, "enableController1") == 0) {
+     ctx.inputs |= CTX_JOY1;
+   } 
+   else if (strcmp(command, "enableController2") == 0) {
+     ctx.inputs |= CTX_JOY2;
+   }
+   else if (strcmp(command, "disableController1") == 0) {
+     ctx.inputs &= ~CTX_JOY1;
+   }
+   else if (strcmp(command, "disableController2") == 0) {
+     ctx.inputs &= ~CTX_JOY2;
+   } else {
+     baudLinkError(&baudLink);
+     return;
+   }
+ 
+   if (!inputContextSame(&ctx, &inputContext)) {
+     inputContext = ctx;
+     applyInputContext();
    }
  }
  
  /**
-  * @brief send pinchange results to ESP32
+  * @brief collect incoming bytes from the ESP32 into lines
+  * 
+  * readStringUntil() waited up to a second for the rest of a line, this only takes what has arrived. Lines with bytes
+  * no command contains (or too long for any) are counted as garbled for the link monitor.
   * 
-  * @param flags 
-  * @param port 
   */
- void sendCommandFromFlags(uint8_t flags, char port) {
-   if (port == 'B') {
-     if (flags & (1 << 0)) {     // isController1BClicked
-       // Serial.write(0x06);  
-       Serial.println("controller1B");
+ void processESP32Message() {
+   while (Serial.available()) {
+     char c = Serial.read();
+ 
+     if (c == '\n') {
+       rxLine[rxLen] = '\0';
+       if (rxGarbled) {
+         baudLinkError(&baudLink);
+       } else {
+         handleESP32Line(rxLine);
+       }
+       rxLen = 0;
+       rxGarbled = false;
      }
-     if (flags & (1 << 1)) {     // isController1AClicked
-       // Serial.write(0x05);  
-       Serial.println("controller1A");
+     else if (c == '\r') {
+       continue;
      }
-     if (flags & (1 << 2)) {     // isRPG1Clockwise
-       // Serial.write(0x11);  
-       Serial.println("rpg1CW");
+     else if (c < 0x20 || c > 0x7E || rxLen == sizeof(rxLine) - 1) {
+       rxGarbled = true;
      }
-     if (flags & (1 << 3)) {      // isRPG1CounterClockwise
-       // Serial.write(0x12);  
-       Serial.println("rpg1CCW");
+     else {
+       rxLine[rxLen++] = c;
      }
-     if (flags & (1 << 4)) {      // isRPG2Clockwise
-       // Serial.write(0x13);  
-       Serial.println("rpg2CW");
+   }
+ }
+ 
+ /**
+  * @brief queue the RPG ticks counted by the ISR for the ESP32
+  * 
+  * Without an RPG delta interval in the context every tick is its own command and never coalesced, every one moves
+  * something on the ESP32. With one, the ticks are taken at most every rpgDeltaMs and sent as a single
+  * "rpgNDelta <ticks>"; a delta still waiting in the queue gets the new ticks added instead of a second line.
+  * 
+  */
+ void queueRPGTicks() {
+   uint16_t deltaMs = inputContext.rpgDeltaMs;
+   if (deltaMs && millis() - lastRPGReport < deltaMs) {
+     return;
+   }
+   lastRPGReport = millis();
+ 
+   // taken with interrupts off for a moment, so a tick arriving in between is not cleared unseen
+   int16_t ticks[RPG_COUNT];
+   ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+     for (uint8_t rpg = 0; rpg < RPG_COUNT; rpg++) {
+       ticks[rpg] = rpgCount[rpg];
+       rpgCount[rpg] = 0;
      }
-     if (flags & (1 << 5)) {      // isRPG2CounterClockwise
-       // Serial.write(0x14);  
-       Serial.println("rpg2CCW");
+   }
+ 
+   for (uint8_t rpg = 0; rpg < RPG_COUNT; rpg++) {
+     int16_t n = ticks[rpg];
+     if (n == 0) {
+       continue;
      }
-   } 
-   else if (port == 'D') {
-     if (flags & (1 << 2)) {     // isDownArrowClicked
-       // Serial.write(0x01);  
-       Serial.println("btnDownArrow"); 
+     if (deltaMs) {
+       // pushed in int8_t pieces, they coalesce into the waiting delta
+       while (n != 0) {
+         int8_t part = (n > 127) ? 127 : (n < -127) ? -127 : (int8_t)n;
+         txPush(&txQueue, RPG_COMMANDS[rpg][2], TX_NORMAL, rpg + 1, part);
+         n -= part;
+       }
+       continue;
+     }
+     uint8_t code = RPG_COMMANDS[rpg][(n > 0) ? 0 : 1];
+     for (int16_t i = (n > 0) ? n : -n; i > 0; i--) {
+       txPush(&txQueue, code, TX_NORMAL, TX_NO_COALESCE);
      }
-     if (flags & (1 << 4)) {     // isUpArrowClicked
-       // Serial.write(0x00);  
-       Serial.println("btnUpArrow");
+   }
+ }
+ 
+ /**
+  * @brief move queued commands into the serial buffer
+  * 
+  * HardwareSerial sends from its 64 byte buffer by interrupt, but println() waits whenever that buffer is full. Here a
+  * line is only written if it fits completely, the rest stays queued for the next pass, so the loop never waits on the
+  * UART no matter how many inputs fire. If commands had to be dropped, "txOverflow <count>" goes out before anything
+  * else so the ESP32 knows inputs were lost.
+  * 
+  */
+ void drainTxQueue() {
+   if (txQueue.dropped) {
+     if (Serial.availableForWrite() < OVERFLOW_LINE_MAX) {
+       return;
      }
-     if (flags & (1 << 6)) {     // isController2BClicked
-       // Serial.write(0x0C);  
-       Serial.println("controller2B");
+     Serial.print("txOverflow ");
+     Serial.println(txTakeDropped(&txQueue));
+   }
+ 
+   uint8_t code;
+   int8_t value;
+   while (txPeek(&txQueue, &code, &value)) {
+     const char* line = COMMAND_NAMES[code];
+     bool hasValue = (code == CMD_RPG1_DELTA || code == CMD_RPG2_DELTA);
+     if ((size_t)Serial.availableForWrite() < strlen(line) + (hasValue ? 7 : 2)) {    // value: " -128"
+       return;
      }
-     if (flags & (1 << 7)) {     // isController2AClicked
-       // Serial.write(0x0B);  
-       Serial.println("controller2A");
+     if (hasValue) {
+       Serial.print(line);
+       Serial.print(' ');
+       Serial.println((int)value);
+     } else {
+       Serial.println(line);
      }
+     txPop(&txQueue);
    }
  }
  
@@ -607,7 +668,7 @@
   * Additionally, the serial communication with the ESP32 is setup here.
   */
  void setup() {
-   Serial.begin(115200);
+   Serial.begin(BAUD_DEFAULT);
  
    // inputs (rpgs, buttons, joysticks)
    pinMode(RPG1_A, INPUT);
@@ -631,50 +692,71 @@
    pinMode(POWER_PIN, OUTPUT);
    digitalWrite(POWER_PIN, HIGH);  // Start with power ON
  
-   // Critical stabilization delay
-   delay(500);  // Wait for power to settle
- 
-   enableButtonInterrupts();
+   gestureInit(&buttons, BUTTON_GESTURES, BUTTON_COUNT);
+   txQueueInit(&txQueue);
+   baudLinkInit(&baudLink);
+   inputContextDefault(&inputContext);
+   applyInputContext();
    sei();
  }
  
  /**
   * @brief main loop for Arduino Program
   * 
-  * Interrupt driven, listens for change at inputs which alter diry flags
-  * If a dirty flag is set, then the pinchange flags (see ISR as pinchange edge trigger cannot be specified)
-  * are sent over UART to the ESP32
+  * The RPGs are interrupt driven: the pin change ISR decodes every quadrature edge (decodeRPGs) and counts the ticks
+  * in rpgCount, and queueRPGTicks() takes the counts once per pass (or once per rpgDeltaMs) and queues them as commands.
   * 
-  * For the power and the home button, these have different functions depending on the duration of the press. 
-  * This makes interrupts not an option for these, so this loop polls them. Additionally, the joysticks are polled 
+  * The buttons go through the gesture recognizer, since clicks, holds, double clicks and repeats depend on timing (see
+  * Buttons). They are polled while one is pressed or settling and after any pin change, so every button is sampled far
+  * more often than the debounce time, and not at all while nobody touches them. Additionally, the joysticks are polled 
   * if the current context requires joysticks. 
   * 
+  * What counts as an input follows the screen on the ESP32: it sends a context with the buttons, RPGs and joysticks it
+  * reads (see InputContext.h), everything else is left unscanned.
+  * 
+  * Every command goes into the TX queue and is sent at the end of the pass as far as the serial buffer has room, so a
+  * pass takes about the same time however busy the inputs are.
+  * 
   */
  void loop() {
+   // the link runs from the start, so the ESP32 can negotiate the rate and send its context while the power settles.
+   // inputs are left alone until then (this used to be a delay(500) at the end of setup())
+   if (!inputsSettled) {
+     if (millis() < (unsigned long)POWER_SETTLE_MS) {
+       processESP32Message();
+       baudLinkPoll(&baudLink, millis(), setLinkBaud);
+       drainTxQueue();
+       return;
+     }
+     inputsSettled = true;
+     applyInputContext();                                 // start the RPGs and buttons from the settled pins
+   }
+ 
    // POLL BUTTONS
-   handle_power_toggle();
-   checkHomeBTN();
+   checkButtons();
  
-   // CHECK FOR ENABLE/DISABLE MSGs
+   // CHECK FOR CONTEXT MSGs (and link messages)
    processESP32Message();
    
+   // back to 115200 if the ESP32 went quiet on a negotiated rate
+   baudLinkPoll(&baudLink, millis(), setLinkBaud);
+ 
    // READ joysticks if enabled
-   if (controller1Enabled) {
-     checkControllerJoystick(1, 30);
-   }
+   if ((inputContext.inputs & CTX_JOYSTICKS) && millis() - lastJoystickPoll >= inputContext.joystickMs) {
+     lastJoystickPoll = millis();
  
-   if (controller2Enabled) {
-     checkControllerJoystick(2, 30);
-   }
+     if (inputContext.inputs & CTX_JOY1) {
+       checkControllerJoystick(1, 30);
+     }
  
-   // CHECK PINCHANGE
-   if (portB_dirty) {
-     sendCommandFromFlags(portB_flags, 'B');
-     portB_dirty = false;
+     if (inputContext.inputs & CTX_JOY2) {
+       checkControllerJoystick(2, 30);
+     }
    }
  
-   if (portD_dirty) {
-     sendCommandFromFlags(portD_flags, 'D');
-     portD_dirty = false;
-   }
+   // QUEUE RPG TICKS counted by the ISR since the last pass
+   queueRPGTicks();
+ 
+   // SEND whatever fits into the serial buffer
+   drainTxQueue();
  }
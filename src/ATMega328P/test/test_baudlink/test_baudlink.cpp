@@ -0,0 +1,331 @@
+/**
+ * @file test_baudlink.cpp
+ * @brief rate negotiation of both ends over a simulated UART: clean, lossy, rate limited, noise bursts, lost messages
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The ESP32's BaudLink (built from the ESP32 project by lib/HostAVR) and ours talk over a VirtualUart. Each side's loop
+ * pass is modelled on its main.cpp: bytes are collected into lines, lines with bytes no command contains are reported
+ * as garbled, link lines go to the BaudLink and everything else is a command. The loop runs every 100 us of simulated
+ * time.
+ *
+ * The checks are about the two ends agreeing: whatever the link does, once it behaves again both run at the same rate,
+ * and a rate the cable cannot carry is given up. The command rates printed are simulated, not host timings.
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "Esp32Side.h"
+#include "BaudLink.h"
+#include "VirtualUart.h"
+
+#define STEP_US 100
+
+// one side's partial line, as in both main.cpp files
+struct LineReader {
+  char line[64];
+  uint8_t len;
+  bool garbled;
+};
+
+enum { LINE_NONE, LINE_OK, LINE_GARBLED };
+
+static int collect(LineReader& r, int c) {
+  if (c == '\n') {
+    r.line[r.len] = '\0';
+    int result = r.garbled ? LINE_GARBLED : LINE_OK;
+    r.len = 0;
+    r.garbled = false;
+    return result;
+  }
+  if (c == '\r') return LINE_NONE;
+  if (c < 0x20 || c > 0x7E || r.len == sizeof(r.line) - 1) r.garbled = true;
+  else r.line[r.len++] = c;
+  return LINE_NONE;
+}
+
+static VirtualUart* uart;
+static uint64_t nowUs;
+
+static void sendLine(int end, const char* line) {
+  for (const char* p = line; *p; p++) uart->write(end, *p, nowUs);
+  uart->write(end, '\r', nowUs);
+  uart->write(end, '\n', nowUs);
+}
+
+class EspPort : public esp32::LinkPort {
+public:
+  void sendLine(const char* line) override { ::sendLine(UART_ESP32, line); }
+  void setBaud(uint32_t baud) override { uart->setBaud(UART_ESP32, baud, nowUs); }
+};
+
+static void arduinoSend(const char* line) { sendLine(UART_ARDUINO, line); }
+static void arduinoSetBaud(uint32_t baud) { uart->setBaud(UART_ARDUINO, baud, nowUs); }
+
+struct Sim {
+  VirtualUart wire;
+  EspPort port;
+  esp32::BaudLink esp;
+  BaudLink avr;
+  LineReader espRx, avrRx;
+  bool arduinoAnswers;                  // false: firmware from before the negotiation, it ignores link lines
+  bool arduinoStreams;                  // the Arduino sends a command whenever its buffer has room
+  uint32_t commandsSent, commandsReceived, garbledAtEsp;
+
+  explicit Sim(uint32_t seed) : wire(seed) {
+    memset(&espRx, 0, sizeof(espRx));
+    memset(&avrRx, 0, sizeof(avrRx));
+    arduinoAnswers = true;
+    arduinoStreams = false;
+    commandsSent = commandsReceived = garbledAtEsp = 0;
+    uart = &wire;
+    nowUs = 0;
+    baudLinkInit(&avr);
+    esp32::baudLinkBegin(&esp, &port, 0);
+  }
+
+  uint32_t ms() const { return (uint32_t)(nowUs / 1000); }
+
+  void step() {
+    nowUs += STEP_US;
+    int c;
+
+    // ESP32 loop(): readCommand(), then the link poll
+    while ((c = wire.read(UART_ESP32, nowUs)) >= 0) {
+      int got = collect(espRx, c);
+      if (got == LINE_GARBLED) {
+        garbledAtEsp++;
+        esp32::baudLinkError(&esp, ms());
+      } else if (got == LINE_OK && !esp32::baudLinkLine(&esp, espRx.line, ms())) {
+        commandsReceived++;
+      }
+    }
+    esp32::baudLinkPoll(&esp, ms());
+
+    // Arduino loop(): processESP32Message(), baudLinkPoll(), then inputs
+    while ((c = wire.read(UART_ARDUINO, nowUs)) >= 0) {
+      int got = collect(avrRx, c);
+      if (!arduinoAnswers) continue;
+      if (got == LINE_GARBLED) baudLinkError(&avr);
+      else if (got == LINE_OK && !baudLinkLine(&avr, avrRx.line, ms(), arduinoSend, arduinoSetBaud)) baudLinkError(&avr);
+    }
+    if (arduinoAnswers) baudLinkPoll(&avr, ms(), arduinoSetBaud);
+    while (arduinoStreams && wire.availableForWrite(UART_ARDUINO, nowUs) >= 8) {
+      sendLine(UART_ARDUINO, "rpg1CW");
+      commandsSent++;
+    }
+  }
+
+  void runMs(uint32_t ms) {
+    for (uint32_t i = 0; i < ms * (1000 / STEP_US); i++) step();
+  }
+
+  // both ends on the same rate, and the ESP32's idea of it is the UART's
+  bool agree() const {
+    return wire.baud(UART_ESP32) == wire.baud(UART_ARDUINO) && esp.stats.baud == wire.baud(UART_ESP32) &&
+           avr.baud == wire.baud(UART_ARDUINO);
+  }
+
+  void setBoth(uint32_t UartLineConfig::*field, uint32_t value) {
+    wire.line[0].*field = value;
+    wire.line[1].*field = value;
+  }
+};
+
+void setUp() {}
+void tearDown() {}
+
+static void test_clean_link() {
+  Sim sim(41);
+  uint32_t upAt = 0;
+  for (uint32_t t = 0; t < 2000 && !upAt; t++) {
+    sim.runMs(1);
+    if (sim.esp.stats.baud == 1000000) upAt = t + 1;
+  }
+  TEST_ASSERT_TRUE_MESSAGE(upAt > 0, "never reached 1 Mbaud");
+  TEST_ASSERT_TRUE(upAt < 100);
+  sim.runMs(5);
+  TEST_ASSERT_TRUE(sim.agree());
+  TEST_ASSERT_TRUE(sim.avr.committed);
+
+  // a minute of pings
+  sim.runMs(60000);
+  TEST_ASSERT_TRUE(sim.agree());
+  TEST_ASSERT_EQUAL_UINT32(1000000, sim.esp.stats.baud);
+  TEST_ASSERT_EQUAL_UINT16(0, sim.esp.stats.fallbacks);
+  TEST_ASSERT_EQUAL_UINT16(0, sim.esp.stats.missedPongs);
+  TEST_ASSERT_EQUAL_UINT16(1, sim.esp.stats.negotiations);
+  TEST_ASSERT_EQUAL_UINT32(0, sim.esp.stats.lineErrors + sim.esp.stats.peerErrors + sim.esp.stats.testErrors);
+
+  char line[64];
+  snprintf(line, sizeof(line), "clean link: 1 Mbaud after %u ms", (unsigned)upAt);
+  TEST_MESSAGE(line);
+}
+
+// an Arduino with the old firmware never answers: the ESP32 gives up and stays quiet at 115200
+static void test_old_firmware() {
+  Sim sim(41);
+  sim.arduinoAnswers = false;
+  sim.runMs(3000);
+  TEST_ASSERT_EQUAL_UINT32(115200, sim.esp.stats.baud);
+  TEST_ASSERT_EQUAL_UINT32(115200, sim.wire.baud(UART_ESP32));
+  uint32_t sent = sim.wire.stats[UART_ESP32].sent;
+  sim.runMs(10000);
+  TEST_ASSERT_EQUAL_UINT32(sent, sim.wire.stats[UART_ESP32].sent);
+  TEST_ASSERT_EQUAL_UINT16(1, sim.esp.stats.negotiations);
+}
+
+// a cable that only carries 500 kbaud: 1M fails its test lines, both end up on 500k
+static void test_rate_limited_cable() {
+  Sim sim(41);
+  sim.setBoth(&UartLineConfig::cleanUpTo, 500000);
+  sim.setBoth(&UartLineConfig::badPpm, 100000);
+  sim.runMs(8000);
+  TEST_ASSERT_TRUE(sim.agree());
+  TEST_ASSERT_EQUAL_UINT32(500000, sim.esp.stats.baud);
+  TEST_ASSERT_TRUE(sim.esp.stats.testErrors >= 1);
+  TEST_ASSERT_EQUAL_UINT16(2, sim.esp.stats.negotiations);
+
+  // nothing above 115200 works
+  Sim slow(42);
+  slow.setBoth(&UartLineConfig::cleanUpTo, 115200);
+  slow.setBoth(&UartLineConfig::badPpm, 1000000);
+  slow.runMs(10000);
+  TEST_ASSERT_TRUE(slow.agree());
+  TEST_ASSERT_EQUAL_UINT32(115200, slow.esp.stats.baud);
+  TEST_ASSERT_EQUAL_UINT16(3, slow.esp.stats.negotiations);
+}
+
+// the commit is lost: the next ping tells the Arduino the rate is kept
+static void test_lost_commit() {
+  Sim sim(41);
+  while (!(sim.esp.round == BAUD_TEST_ROUNDS - 1 && sim.esp.awaiting)) sim.step();
+  sim.wire.line[UART_ESP32].dropPpm = 1000000;      // after the last test line: "baudCommit" vanishes
+  sim.runMs(300);
+  sim.wire.line[UART_ESP32].dropPpm = 0;
+  TEST_ASSERT_FALSE(sim.avr.committed);
+  sim.runMs(1000);
+  TEST_ASSERT_TRUE(sim.avr.committed);
+  sim.runMs(10000);
+  TEST_ASSERT_TRUE(sim.agree());
+  TEST_ASSERT_EQUAL_UINT32(1000000, sim.esp.stats.baud);
+  TEST_ASSERT_EQUAL_UINT16(0, sim.esp.stats.fallbacks);
+}
+
+// the commit and the pings after it are lost: the Arduino goes back on its own, the ESP32 notices by the missing
+// pongs, they meet again one rate lower
+static void test_lost_commit_and_pings() {
+  Sim sim(41);
+  while (!(sim.esp.round == BAUD_TEST_ROUNDS - 1 && sim.esp.awaiting)) sim.step();
+  sim.wire.line[UART_ESP32].dropPpm = 1000000;
+  sim.runMs(BAUD_COMMIT_MS + 100);
+  sim.wire.line[UART_ESP32].dropPpm = 0;
+  TEST_ASSERT_EQUAL_UINT32(115200, sim.avr.baud);   // reverted after BAUD_COMMIT_MS
+  TEST_ASSERT_EQUAL_UINT32(1000000, sim.esp.stats.baud);
+
+  sim.runMs(12000);
+  TEST_ASSERT_TRUE(sim.agree());
+  TEST_ASSERT_TRUE(sim.avr.committed);
+  TEST_ASSERT_EQUAL_UINT16(1, sim.esp.stats.fallbacks);
+  TEST_ASSERT_TRUE(sim.esp.stats.missedPongs >= BAUD_PING_MISSES);
+  TEST_ASSERT_EQUAL_UINT32(500000, sim.esp.stats.baud);
+}
+
+// noise while running: the link drops a rate, commands keep flowing and garbled ones are caught
+static void test_noise_burst() {
+  Sim sim(41);
+  sim.arduinoStreams = true;
+  sim.runMs(1000);
+  TEST_ASSERT_EQUAL_UINT32(1000000, sim.esp.stats.baud);
+
+  sim.setBoth(&UartLineConfig::errorPpm, 20000);
+  sim.runMs(2000);
+  sim.setBoth(&UartLineConfig::errorPpm, 0);
+  TEST_ASSERT_TRUE(sim.esp.stats.fallbacks >= 1);
+  sim.runMs(10000);
+  TEST_ASSERT_TRUE(sim.agree());
+  TEST_ASSERT_EQUAL_UINT32(500000, sim.esp.stats.baud);
+  TEST_ASSERT_TRUE(sim.garbledAtEsp > 0);
+  // a command that arrives either arrives intact or is reported garbled (a flipped bit can still be printable, those
+  // come out as unknown commands, which the programs ignore)
+  TEST_ASSERT_TRUE(sim.commandsReceived + sim.garbledAtEsp <= sim.commandsSent);
+}
+
+// random cables, latencies, error rates and bursts: once the link behaves, the ends agree
+static void test_random_links() {
+  uint32_t seed = 4100;
+  auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+  int ended[4] = { 0, 0, 0, 0 };
+
+  for (int run = 0; run < 60; run++) {
+    Sim sim(run + 1);
+    static const uint32_t LIMITS[] = { 0, 500000, 250000, 115200 };
+    uint32_t limit = LIMITS[next() % 4];
+    sim.setBoth(&UartLineConfig::cleanUpTo, limit);
+    sim.setBoth(&UartLineConfig::badPpm, 50000 + next() % 500000);
+    sim.wire.line[0].latencyUs = next() % 3000;
+    sim.wire.line[1].latencyUs = next() % 3000;
+    uint32_t errors = next() % 1000, drops = next() % 200;
+    sim.arduinoStreams = next() % 2;
+
+    for (int phase = 0; phase < 6; phase++) {
+      bool burst = next() % 4 == 0;
+      sim.setBoth(&UartLineConfig::errorPpm, burst ? 30000 : errors);
+      sim.setBoth(&UartLineConfig::dropPpm, burst ? 5000 : drops);
+      sim.runMs(1000 + next() % 4000);
+    }
+
+    // quiet link: a fallback in progress finishes (watchdog and holdoff are 3.5 s) and a new rate is tried
+    sim.setBoth(&UartLineConfig::errorPpm, 0);
+    sim.setBoth(&UartLineConfig::dropPpm, 0);
+    sim.runMs(15000);
+    char msg[96];
+    snprintf(msg, sizeof(msg), "run %d: esp %u / %u, arduino %u", run, (unsigned)sim.esp.stats.baud,
+             (unsigned)sim.wire.baud(UART_ESP32), (unsigned)sim.wire.baud(UART_ARDUINO));
+    TEST_ASSERT_TRUE_MESSAGE(sim.agree(), msg);
+    TEST_ASSERT_TRUE_MESSAGE(sim.avr.committed, msg);
+    if (limit) TEST_ASSERT_TRUE_MESSAGE(sim.esp.stats.baud <= (limit > 115200 ? limit : 115200), msg);
+    uint32_t b = sim.esp.stats.baud;
+    ended[b == 1000000 ? 0 : b == 500000 ? 1 : b == 250000 ? 2 : 3]++;
+  }
+  char line[96];
+  snprintf(line, sizeof(line), "60 random links ended at 1M: %d, 500k: %d, 250k: %d, 115200: %d", ended[0], ended[1],
+           ended[2], ended[3]);
+  TEST_MESSAGE(line);
+}
+
+// what the negotiated rate buys: commands per second the Arduino can get across
+static void test_command_rates() {
+  static const uint32_t LIMITS[] = { 0, 500000, 250000, 115200 };
+  for (uint32_t limit : LIMITS) {
+    Sim sim(41);
+    sim.setBoth(&UartLineConfig::cleanUpTo, limit);
+    sim.setBoth(&UartLineConfig::badPpm, 1000000);
+    sim.runMs(8000);
+    TEST_ASSERT_TRUE(sim.agree());
+    sim.arduinoStreams = true;
+    uint32_t before = sim.commandsReceived;
+    sim.runMs(5000);
+    char line[80];
+    snprintf(line, sizeof(line), "%7u baud: %u commands/s", (unsigned)sim.esp.stats.baud,
+             (unsigned)((sim.commandsReceived - before) / 5));
+    TEST_MESSAGE(line);
+    TEST_ASSERT_TRUE(sim.commandsReceived - before > sim.esp.stats.baud / 10 / 8 * 5 * 9 / 10);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_clean_link);
+  RUN_TEST(test_old_firmware);
+  RUN_TEST(test_rate_limited_cable);
+  RUN_TEST(test_lost_commit);
+  RUN_TEST(test_lost_commit_and_pings);
+  RUN_TEST(test_noise_burst);
+  RUN_TEST(test_random_links);
+  RUN_TEST(test_command_rates);
+  return UNITY_END();
+}
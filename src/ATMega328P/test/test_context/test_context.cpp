@@ -0,0 +1,296 @@
+/**
+ * @file test_context.cpp
+ * @brief input contexts between both ends: the ESP32's lines parsed here, malformed ones refused, RPG deltas back to
+ * the ESP32, and screen switches over a lossy UART
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The ESP32 side is its own Link/InputContext module, built by lib/HostAVR. Both headers define the CTX_* bits, so a
+ * bit that differs between the projects already shows up as a redefinition warning when this suite compiles.
+ *
+ * The switching test models both loops the way test_baudlink does: the ESP32 sends a context on every screen change
+ * and every CONTEXT_REFRESH_MS, the Arduino applies whatever parses and differs from what it has. A flipped bit can
+ * turn one hex digit into another, so a damaged line can still be a valid (wrong) context; the refresh is what bounds
+ * how long that lasts, and that bound is what is checked.
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "Esp32Side.h"
+#include "InputContext.h"
+#include "TxQueue.h"
+#include "VirtualUart.h"
+#include "../bench.h"
+
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+static esp32::InputContext randomContext() {
+  esp32::InputContext c;
+  c.inputs = next() & CTX_ALL;
+  c.rpgDeltaMs = (next() & 3) ? next() % 100 : next() & 0xFFFF;
+  c.joystickMs = (next() & 3) ? next() % 100 : next() & 0xFFFF;
+  return c;
+}
+
+static bool same(const InputContext& a, const esp32::InputContext& b) {
+  return a.inputs == b.inputs && a.rpgDeltaMs == b.rpgDeltaMs && a.joystickMs == b.joystickMs;
+}
+
+void setUp() {
+  seed = 42;
+}
+
+void tearDown() {}
+
+// every input code belongs to exactly one group, and every group has a code
+static void test_groups_of_codes() {
+  using namespace esp32;
+  uint16_t all = 0;
+  for (int code = IN_UP_ARROW; code < IN_COUNT; code++) {
+    uint16_t group = inputContextFromCodes(1u << code);
+    TEST_ASSERT_TRUE(group && !(group & (group - 1)) && !(group & ~CTX_ALL));
+    all |= group;
+  }
+  TEST_ASSERT_EQUAL_HEX16(CTX_ALL, all);
+  TEST_ASSERT_EQUAL_HEX16(0, inputContextFromCodes(1u << IN_NONE));
+
+  TEST_ASSERT_EQUAL_HEX16(CTX_HOME, inputContextFromCodes((1u << IN_HOME_CLICK) | (1u << IN_HOME_HOLD)));
+  TEST_ASSERT_EQUAL_HEX16(CTX_C2B, inputContextFromCodes(1u << IN_C2B_DOUBLE));
+  TEST_ASSERT_EQUAL_HEX16(CTX_RPG2, inputContextFromCodes(1u << IN_RPG2_CCW));
+  TEST_ASSERT_EQUAL_HEX16(CTX_JOY1 | CTX_JOY2, inputContextFromCodes((1u << IN_JOY1_LEFT) | (1u << IN_JOY2_DOWN)));
+}
+
+static void test_round_trip() {
+  esp32::InputContext edges[] = { { 0, 0, 0 }, { CTX_ALL, 0xFFFF, 0xFFFF }, { CTX_DEFAULT, 0, CTX_JOYSTICK_MS } };
+  char line[32];
+  InputContext got;
+  for (int i = 0; i < 3 + 20000; i++) {
+    esp32::InputContext sent = i < 3 ? edges[i] : randomContext();
+    esp32::inputContextFormat(&sent, line, sizeof(line));
+    TEST_ASSERT_TRUE_MESSAGE(inputContextParse(line, &got), line);
+    TEST_ASSERT_TRUE_MESSAGE(same(got, sent), line);
+  }
+
+  // the default is what the Arduino scans before the first line arrives
+  inputContextDefault(&got);
+  TEST_ASSERT_EQUAL_HEX16(CTX_ALL & ~CTX_JOYSTICKS, got.inputs);
+  TEST_ASSERT_EQUAL_UINT16(0, got.rpgDeltaMs);
+}
+
+// a refused line leaves the context alone
+static void test_malformed_refused() {
+  const char* BAD[] = {
+    "ctx", "ctx ", "ctx 7C7", "ctx 7C7 0", "ctx 7C7 0 ", "ctx 7C7  0 10", "ctx  7C7 0 10", "ctx 7C7 0 10 ",
+    "ctx 7C7 0 10x", "ctx 800 0 10", "ctx 7C7 65536 10", "ctx 7C7 0 99999999999999999999", "ctx -1 0 10",
+    "ctx 7C7 +5 10", "ctx 7G7 0 10", "ctx 7C7 0 1 0", "ctx 7C7,0,10", "Ctx 7C7 0 10", "ctx7C7 0 10", "rpg1CW",
+    "enableController1", ""
+  };
+  InputContext ctx = { 0x123, 45, 67 };
+  for (unsigned i = 0; i < sizeof(BAD) / sizeof(BAD[0]); i++) {
+    TEST_ASSERT_FALSE_MESSAGE(inputContextParse(BAD[i], &ctx), BAD[i]);
+    TEST_ASSERT_TRUE_MESSAGE(ctx.inputs == 0x123 && ctx.rpgDeltaMs == 45 && ctx.joystickMs == 67, BAD[i]);
+  }
+  TEST_ASSERT_TRUE(inputContextParse("ctx 7c7 0 10", &ctx));   // lower case hex is still hex
+  TEST_ASSERT_EQUAL_HEX16(0x7C7, ctx.inputs);
+}
+
+// the Arduino's delta lines as the ESP32 reads them, and every tick spun arrives
+static void test_rpg_deltas() {
+  uint8_t rpg;
+  int ticks;
+  TEST_ASSERT_TRUE(esp32::rpgDeltaParse("rpg2Delta -128", &rpg, &ticks));
+  TEST_ASSERT_TRUE(rpg == 2 && ticks == -128);
+  const char* BAD[] = { "rpg1Delta", "rpg1Delta ", "rpg3Delta 1", "rpg1Delta 1x", "rpg1CW", "rpg1Delta  " };
+  for (unsigned i = 0; i < sizeof(BAD) / sizeof(BAD[0]); i++) {
+    TEST_ASSERT_FALSE_MESSAGE(esp32::rpgDeltaParse(BAD[i], &rpg, &ticks), BAD[i]);
+  }
+
+  // queueRPGTicks() with a delta interval, then drainTxQueue() formatting what it pops
+  TxQueue q;
+  txQueueInit(&q);
+  long spun[3] = { 0, 0, 0 }, arrived[3] = { 0, 0, 0 };
+  char line[24];
+  for (int pass = 0; pass < 100000; pass++) {
+    for (int r = 1; r <= 2; r++) {
+      int8_t n = (int8_t)(next() % 41 - 20);
+      if (n && txPush(&q, r, TX_NORMAL, r, n)) spun[r] += n;
+    }
+    uint8_t code;
+    int8_t value;
+    if (pass % 3 == 0 && txPeek(&q, &code, &value)) {
+      txPop(&q);
+      snprintf(line, sizeof(line), "rpg%uDelta %d", code, value);
+      TEST_ASSERT_TRUE(esp32::rpgDeltaParse(line, &rpg, &ticks));
+      TEST_ASSERT_EQUAL_UINT8(code, rpg);
+      arrived[rpg] += ticks;
+    }
+  }
+  uint8_t code;
+  int8_t value;
+  while (txPeek(&q, &code, &value)) {
+    txPop(&q);
+    arrived[code] += value;
+  }
+  TEST_ASSERT_EQUAL_UINT16(0, q.dropped);
+  TEST_ASSERT_EQUAL_INT32(spun[1], arrived[1]);
+  TEST_ASSERT_EQUAL_INT32(spun[2], arrived[2]);
+}
+
+// ---------- screen switches over the UART ---------- //
+
+struct SwitchResult {
+  uint32_t switches, lines, applied, wrong;
+  uint32_t longestMismatchMs;
+  uint64_t mismatchMs;
+};
+
+static VirtualUart* wire;
+static uint64_t nowUs;
+
+/**
+ * @brief minutes of screen switches, 1 ms per loop pass on both sides
+ */
+static SwitchResult runSwitches(VirtualUart& uart, uint32_t minutes) {
+  SwitchResult r;
+  memset(&r, 0, sizeof(r));
+  wire = &uart;
+  nowUs = 0;
+
+  esp32::InputContext screen = randomContext(), sentCtx;
+  uint32_t nextSwitch = 0, sentAt = 0, mismatchSince = 0;
+  bool sent = false, mismatched = false;
+  InputContext arduino;
+  inputContextDefault(&arduino);
+  char rx[64];
+  uint8_t rxLen = 0;
+  bool rxGarbled = false;
+
+  for (uint32_t ms = 0; ms < minutes * 60000; ms++) {
+    nowUs = (uint64_t)ms * 1000;
+
+    // ESP32: a screen change now and then, sendInputContext() every pass
+    if (ms == nextSwitch) {
+      screen = randomContext();
+      nextSwitch = ms + 200 + next() % 4800;
+      r.switches++;
+    }
+    if (!sent || !esp32::inputContextSame(&screen, &sentCtx) || ms - sentAt >= CONTEXT_REFRESH_MS) {
+      char line[32];
+      int n = esp32::inputContextFormat(&screen, line, sizeof(line));
+      for (int i = 0; i < n; i++) uart.write(UART_ESP32, line[i], nowUs);
+      uart.write(UART_ESP32, '\r', nowUs);
+      uart.write(UART_ESP32, '\n', nowUs);
+      sentCtx = screen;
+      sentAt = ms;
+      sent = true;
+      r.lines++;
+    }
+
+    // Arduino: processESP32Message() into handleESP32Line()
+    int c;
+    while ((c = uart.read(UART_ARDUINO, nowUs)) >= 0) {
+      if (c == '\n') {
+        rx[rxLen] = '\0';
+        InputContext ctx = arduino;
+        if (!rxGarbled && inputContextParse(rx, &ctx) && !inputContextSame(&ctx, &arduino)) {
+          arduino = ctx;
+          r.applied++;
+          if (!same(arduino, screen)) r.wrong++;
+        }
+        rxLen = 0;
+        rxGarbled = false;
+      }
+      else if (c == '\r') continue;
+      else if (c < 0x20 || c > 0x7E || rxLen == sizeof(rx) - 1) rxGarbled = true;
+      else rx[rxLen++] = c;
+    }
+
+    bool now = !same(arduino, screen);
+    if (now && !mismatched) mismatchSince = ms;
+    if (now) {
+      r.mismatchMs++;
+      if (ms - mismatchSince + 1 > r.longestMismatchMs) r.longestMismatchMs = ms - mismatchSince + 1;
+    }
+    mismatched = now;
+  }
+  return r;
+}
+
+static void printSwitches(const char* name, const VirtualUart& uart, const SwitchResult& r, uint32_t minutes) {
+  printf("%-28s %u switches, %u lines (%u bytes damaged, %u lost), %u applied, %u wrong, out of step %.3f%% "
+         "of the time, longest %u ms\n", name, r.switches, r.lines, uart.stats[UART_ESP32].flipped,
+         uart.stats[UART_ESP32].dropped, r.applied, r.wrong, 100.0 * r.mismatchMs / (minutes * 60000.0),
+         r.longestMismatchMs);
+}
+
+static void test_switches_clean() {
+  VirtualUart uart(42);
+  SwitchResult r = runSwitches(uart, 10);
+  printSwitches("switches, clean 115200", uart, r, 10);
+  TEST_ASSERT_EQUAL_UINT32(0, r.wrong);
+  // a switch takes one loop pass and one line (~1.5 ms at 115200)
+  TEST_ASSERT_TRUE(r.longestMismatchMs <= 3);
+  TEST_ASSERT_TRUE(r.applied >= r.switches - 1);
+}
+
+static void test_switches_lossy() {
+  const uint32_t MINUTES = 60;
+  VirtualUart uart(42);
+  uart.line[UART_ESP32].errorPpm = 2000;
+  uart.line[UART_ESP32].dropPpm = 1000;
+  uart.line[UART_ESP32].latencyUs = 300;
+  SwitchResult r = runSwitches(uart, MINUTES);
+  printSwitches("switches, 0.3% bad bytes", uart, r, MINUTES);
+
+  // damage happened, some of it into a valid line. each damaged byte costs at most one refresh (the line it was in
+  // is put right by the next one), on top of the line time every switch takes anyway
+  uint32_t damaged = uart.stats[UART_ESP32].flipped + uart.stats[UART_ESP32].dropped;
+  TEST_ASSERT_TRUE(uart.stats[UART_ESP32].flipped > 40 && uart.stats[UART_ESP32].dropped > 15);
+  TEST_ASSERT_TRUE(r.wrong > 0);
+  TEST_ASSERT_TRUE(r.mismatchMs <= (uint64_t)damaged * (CONTEXT_REFRESH_MS + 3) + r.switches * 3);
+  TEST_ASSERT_TRUE(r.longestMismatchMs <= 3 * (CONTEXT_REFRESH_MS + 3));
+}
+
+static void test_benchmark() {
+  const uint32_t N = 2000000;
+  char lines[64][32];
+  for (int i = 0; i < 64; i++) {
+    esp32::InputContext c = randomContext();
+    esp32::inputContextFormat(&c, lines[i], sizeof(lines[i]));
+  }
+  InputContext ctx;
+  volatile uint32_t sink = 0;
+  double t0 = benchSeconds();
+  for (uint32_t i = 0; i < N; i++) sink += inputContextParse(lines[i & 63], &ctx) + ctx.inputs;
+  benchReport("context parse", N, "line", benchSeconds() - t0);
+
+  char line[32];
+  esp32::InputContext c = randomContext();
+  t0 = benchSeconds();
+  for (uint32_t i = 0; i < N; i++) {
+    c.joystickMs = i & 0xFF;
+    sink += esp32::inputContextFormat(&c, line, sizeof(line));
+  }
+  benchReport("context format (ESP32)", N, "line", benchSeconds() - t0);
+  (void)sink;
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_groups_of_codes);
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_malformed_refused);
+  RUN_TEST(test_rpg_deltas);
+  RUN_TEST(test_switches_clean);
+  RUN_TEST(test_switches_lossy);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,476 @@
+/**
+ * @file test_cosim.cpp
+ * @brief the whole sketch (main.cpp) on a simulated ATmega328P, talking to the ESP32 side over a simulated UART
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * setup() and loop() run unchanged against lib/HostAVR: the pins are driven by scripted waveforms (bouncing buttons,
+ * RPG quadrature), the pin change ISRs run when the simulated chip raises them, and Serial is one end of a VirtualUart
+ * whose other end is an Esp32Peer (the ESP32's link and context code, polled like its loop). A loop pass is taken to
+ * last LOOP_US, an ESP32 pass ESP_PASS_US.
+ *
+ * What is checked is what the ESP32 ends up with: every press exactly once and in order, every RPG tick (or a
+ * txOverflow saying how many were lost), nothing from inputs outside the screen's context, no loop pass waiting on the
+ * UART, and how long it all takes. The sessions run COSIM_MINUTES of simulated time each; [env:regression] runs them
+ * longer.
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include <avr/io.h>
+#include "HostAVR.h"
+#include "Waveform.h"
+#include "Esp32Peer.h"
+#include "InputContext.h"
+#include "TxQueue.h"
+#include "../bench.h"
+
+#ifndef COSIM_MINUTES
+#define COSIM_MINUTES 1
+#endif
+
+#define LOOP_US 60
+#define ESP_PASS_US 1000
+
+// the sketch
+void setup();
+void loop();
+
+// sketch globals the C startup code would set again on a real reset (setup() sets the rest)
+extern volatile bool power_state;
+extern unsigned long powerOnAt;
+extern bool inputsSettled;
+extern unsigned long lastRPGReport;
+extern unsigned long lastJoystickPoll;
+extern uint8_t rxLen;
+extern bool rxGarbled;
+extern volatile uint8_t prevStateB;
+extern volatile bool buttonActivity;
+extern InputContext inputContext;
+
+// wiring, as in main.cpp
+enum {
+  PIN_DOWN = 2, PIN_HOME = 3, PIN_UP = 4, PIN_C2B = 6, PIN_C2A = 7, PIN_C1B = 8, PIN_C1A = 9,
+  PIN_RPG1_A = 10, PIN_RPG1_B = 11, PIN_RPG2_A = 13, PIN_RPG2_B = 12,   // as decoded (RPG 2 is wired the other way)
+  PIN_JOY1_X = 14, PIN_POWER_OUT = 18, PIN_POWER = 19
+};
+
+// screens, like screenContext() on the ESP32
+static const esp32::InputContext HOME = { CTX_UP_ARROW | CTX_DOWN_ARROW | CTX_HOME, 0, 0 };
+static const esp32::InputContext SKETCH = { CTX_ALL & ~CTX_JOYSTICKS, CONTEXT_RPG_DELTA_MS, 0 };
+static const esp32::InputContext SKETCH_TICKS = { CTX_ALL & ~CTX_JOYSTICKS, 0, 0 };
+static const esp32::InputContext PONG = { CTX_HOME | CTX_C1A | CTX_C1B | CTX_RPG1 | CTX_RPG2 | CTX_JOY1 | CTX_JOY2,
+                                          CONTEXT_RPG_DELTA_MS, CONTEXT_JOYSTICK_MS };
+
+static Esp32Peer* esp;
+
+static void espPass(uint64_t now) {
+  esp->poll(now);
+}
+
+struct CoSim {
+  VirtualUart uart;
+  Esp32Peer peer;
+  Waveform wave;
+
+  explicit CoSim(uint32_t seed) : uart(seed), peer(&uart), wave(seed) {
+    hostReset();
+    power_state = true;
+    powerOnAt = 0;
+    inputsSettled = false;
+    lastRPGReport = lastJoystickPoll = 0;
+    rxLen = 0;
+    rxGarbled = false;
+    prevStateB = 0;
+    buttonActivity = true;
+
+    hostAttachSerial(&uart);
+    esp = &peer;
+    setup();
+    peer.begin(0);
+    hostSetPeer(espPass, ESP_PASS_US);
+  }
+
+  void runUntil(uint64_t us) {
+    while (hostNowUs < us) {
+      loop();
+      hostAdvanceUs(LOOP_US);
+    }
+  }
+
+  void runMs(uint32_t ms) { runUntil(hostNowUs + (uint64_t)ms * 1000); }
+
+  // first command with this name at or after a time, -1 if none
+  int64_t arrival(const char* command, uint64_t after) const {
+    for (size_t i = 0; i < peer.commands.size(); i++) {
+      if (peer.commands[i].atUs >= after && strcmp(peer.commands[i].line, command) == 0) {
+        return (int64_t)peer.commands[i].atUs;
+      }
+    }
+    return -1;
+  }
+};
+
+static bool contextIs(const esp32::InputContext& c) {
+  return inputContext.inputs == c.inputs && inputContext.rpgDeltaMs == c.rpgDeltaMs &&
+         inputContext.joystickMs == c.joystickMs;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// ---------- scripted scenarios ---------- //
+
+static void test_boot() {
+  CoSim sim(43);
+  sim.peer.show(HOME);
+  // an arrow pressed while the power settles is not an input
+  sim.wave.press(PIN_UP, 100000, 200000);
+  // and setup() doesn't wait for it: the link is up to speed well before POWER_SETTLE_MS (500 ms in main.cpp)
+  sim.runMs(300);
+  TEST_ASSERT_EQUAL_UINT32(1000000, sim.peer.link.stats.baud);
+  TEST_ASSERT_FALSE(inputsSettled);
+  // one pressed once it has settled is
+  sim.wave.press(PIN_UP, 700000, 100000);
+  sim.runMs(1700);
+
+  TEST_ASSERT_TRUE(contextIs(HOME));
+  TEST_ASSERT_EQUAL_HEX8(0, PCMSK0);                    // no RPG, no controller 1 button
+  TEST_ASSERT_EQUAL_HEX8((1 << 2) | (1 << 3) | (1 << 4), PCMSK2);
+  TEST_ASSERT_EQUAL_HEX8(1 << 5, PCMSK1);                // power
+  TEST_ASSERT_FALSE(ADCSRA & (1 << ADEN));
+  TEST_ASSERT_TRUE(hostOutput(PIN_POWER_OUT));
+
+  TEST_ASSERT_EQUAL_UINT32(1000000, sim.peer.link.stats.baud);
+  TEST_ASSERT_EQUAL_UINT32(1000000, sim.uart.baud(UART_ARDUINO));
+  TEST_ASSERT_TRUE(inputsSettled);
+  TEST_ASSERT_EQUAL_UINT32(1, sim.peer.commands.size());
+  TEST_ASSERT_EQUAL_STRING("btnUpArrow", sim.peer.commands[0].line);
+  TEST_ASSERT_TRUE(sim.peer.commands[0].atUs > 700000 && sim.peer.commands[0].atUs < 750000);
+  TEST_ASSERT_EQUAL_UINT32(0, sim.peer.garbled);
+  TEST_ASSERT_EQUAL_UINT64(0, hostStats.writeWaitUs);
+}
+
+static void test_buttons() {
+  CoSim sim(43);
+  sim.peer.show(SKETCH);
+  sim.runMs(1000);
+  sim.wave.bounceUs = 3000;
+  sim.wave.bounces = 4;
+
+  // arrow: on the press, after the debounce
+  sim.wave.press(PIN_UP, 1000000, 100000);
+  // home: a click on the release, a hold once the second is up
+  sim.wave.press(PIN_HOME, 2000000, 300000);
+  sim.wave.press(PIN_HOME, 3000000, 1500000);
+  // controller 1A twice within the double click window
+  sim.wave.press(PIN_C1A, 5000000, 80000);
+  sim.wave.press(PIN_C1A, 5200000, 80000);
+  sim.runMs(5000);
+
+  TEST_ASSERT_EQUAL_INT(1, sim.peer.count("btnUpArrow"));
+  TEST_ASSERT_EQUAL_INT(1, sim.peer.count("btnHomeClick"));
+  TEST_ASSERT_EQUAL_INT(1, sim.peer.count("btnHomeHold"));
+  TEST_ASSERT_EQUAL_INT(2, sim.peer.count("controller1A"));
+  TEST_ASSERT_EQUAL_INT(1, sim.peer.count("controller1ADouble"));
+  TEST_ASSERT_EQUAL_UINT32(6, sim.peer.commands.size());
+
+  // latencies: the debounce, a loop pass, a line on the wire and an ESP32 pass
+  int64_t arrow = sim.arrival("btnUpArrow", 0) - 1000000;
+  int64_t click = sim.arrival("btnHomeClick", 0) - 2300000;
+  int64_t hold = sim.arrival("btnHomeHold", 0) - 3000000;
+  printf("latency: arrow press %.1f ms, home click after the release %.1f ms, home hold after the press %.1f ms\n",
+         arrow / 1000.0, click / 1000.0, hold / 1000.0);
+  TEST_ASSERT_TRUE(arrow >= 30000 && arrow <= 35000);
+  TEST_ASSERT_TRUE(click >= 30000 && click <= 35000);
+  TEST_ASSERT_TRUE(hold >= 1000000 && hold <= 1035000);
+}
+
+// only what the screen reads is scanned, and nothing from the rest reaches the ESP32
+static void test_context_masking() {
+  CoSim sim(43);
+  sim.peer.show(HOME);
+  sim.runMs(1000);
+
+  uint32_t isr = hostStats.isrCalls[0];
+  uint64_t end = sim.wave.turn(PIN_RPG1_A, PIN_RPG1_B, 1000000, 40, 2000);
+  sim.wave.press(PIN_C1A, end + 10000, 80000);
+  sim.runMs(1000);
+  TEST_ASSERT_EQUAL_UINT32(isr, hostStats.isrCalls[0]);
+  TEST_ASSERT_EQUAL_INT32(0, sim.peer.rpgTicks[1]);
+  TEST_ASSERT_EQUAL_UINT32(0, sim.peer.commands.size());
+
+  // the RPG was left between detents: decoding starts from where it is, no phantom tick
+  sim.wave.turn(PIN_RPG1_A, PIN_RPG1_B, hostNowUs, 3, 2000);
+  sim.runMs(100);
+  sim.peer.show(SKETCH);
+  sim.runMs(100);
+  TEST_ASSERT_TRUE(contextIs(SKETCH));
+  end = sim.wave.turn(PIN_RPG1_A, PIN_RPG1_B, hostNowUs, 40, 2000);
+  sim.wave.turn(PIN_RPG2_A, PIN_RPG2_B, end, -12, 2000);
+  sim.runMs(500);
+  TEST_ASSERT_EQUAL_INT32(40, sim.peer.rpgTicks[1]);
+  TEST_ASSERT_EQUAL_INT32(-12, sim.peer.rpgTicks[2]);
+  TEST_ASSERT_TRUE(sim.peer.count("rpg1Delta 1") < 40);  // sent as deltas, not tick by tick
+  TEST_ASSERT_EQUAL_UINT32(0, hostStats.adcOffReads);
+}
+
+static void test_joysticks() {
+  CoSim sim(43);
+  sim.peer.show(PONG);
+  sim.runMs(1000);
+  TEST_ASSERT_TRUE(ADCSRA & (1 << ADEN));
+
+  // held right for half a second: streamed at the context's interval
+  hostSetAnalog(PIN_JOY1_X, 0);
+  sim.runMs(500);
+  hostSetAnalog(PIN_JOY1_X, 512);
+  sim.runMs(100);
+  int right = sim.peer.count("joystick1RIGHT");
+  printf("joystick held 500 ms: %d commands\n", right);
+  TEST_ASSERT_TRUE(right >= 45 && right <= 51);
+
+  // a menu: ADC off, the stick is not read at all
+  sim.peer.show(HOME);
+  sim.runMs(100);
+  TEST_ASSERT_FALSE(ADCSRA & (1 << ADEN));
+  hostSetAnalog(PIN_JOY1_X, 0);
+  sim.runMs(500);
+  TEST_ASSERT_EQUAL_INT(right, sim.peer.count("joystick1RIGHT"));
+  TEST_ASSERT_EQUAL_UINT32(0, hostStats.adcOffReads);
+}
+
+static void test_power_button() {
+  CoSim sim(43);
+  sim.peer.show(HOME);
+  sim.runMs(1000);
+
+  // off once held for a second (and the two seconds after power on are over)
+  sim.wave.press(PIN_POWER, 1000000, 1200000);
+  sim.runMs(1500);
+  TEST_ASSERT_EQUAL_INT(1, sim.peer.count("powerOFF"));
+  TEST_ASSERT_FALSE(hostOutput(PIN_POWER_OUT));
+
+  sim.wave.press(PIN_POWER, 3000000, 1200000);
+  sim.runMs(2000);
+  TEST_ASSERT_EQUAL_INT(1, sim.peer.count("powerON"));
+  TEST_ASSERT_TRUE(hostOutput(PIN_POWER_OUT));
+
+  // the same long press cannot switch it straight off again
+  sim.wave.press(PIN_POWER, 4500000, 1200000);
+  sim.runMs(2000);
+  TEST_ASSERT_EQUAL_INT(1, sim.peer.count("powerOFF"));
+  TEST_ASSERT_TRUE(hostOutput(PIN_POWER_OUT));
+}
+
+// ---------- spin rates ---------- //
+
+struct SpinResult {
+  long spun, arrived;
+  uint32_t reported;                    // txOverflow
+  double lastTickMs;                    // from the last edge to the last command reaching the ESP32
+};
+
+static SpinResult spin(const esp32::InputContext& ctx, bool fast, uint32_t transitionsPerSecond) {
+  CoSim sim(43);
+  if (!fast) {
+    // a cable that only carries the default rate
+    sim.uart.line[0].cleanUpTo = sim.uart.line[1].cleanUpTo = 115200;
+    sim.uart.line[0].badPpm = sim.uart.line[1].badPpm = 1000000;
+  }
+  sim.peer.show(ctx);
+  sim.runMs(fast ? 3000 : 10000);                      // every faster rate tried and given up
+  sim.peer.rpgTicks[1] = 0;
+  sim.peer.dropped = 0;
+  TEST_ASSERT_EQUAL_UINT32(fast ? 1000000 : 115200, sim.uart.baud(UART_ARDUINO));
+
+  uint32_t period = 1000000 / transitionsPerSecond;
+  if (period >= 400) {
+    sim.wave.bounceUs = period / 4;
+    sim.wave.bounces = 2;
+  }
+  int steps = (int)transitionsPerSecond;                 // one second of turning
+  uint64_t end = sim.wave.turn(PIN_RPG1_A, PIN_RPG1_B, hostNowUs + 1000, steps, period);
+
+  sim.peer.commands.clear();
+  sim.runUntil(end + 2000000);
+
+  SpinResult r;
+  r.spun = steps;
+  r.arrived = sim.peer.rpgTicks[1];
+  r.reported = sim.peer.dropped;
+  r.lastTickMs = sim.peer.commands.empty() ? -1 : ((int64_t)sim.peer.commands.back().atUs - (int64_t)end) / 1000.0;
+  TEST_ASSERT_EQUAL_UINT64(0, hostStats.writeWaitUs);
+  return r;
+}
+
+static void test_spin_rates() {
+  const uint32_t RATES[] = { 200, 1000, 4000, 20000 };
+  for (int mode = 0; mode < 4; mode++) {
+    bool deltas = mode & 1, fast = mode & 2;
+    for (unsigned i = 0; i < sizeof(RATES) / sizeof(RATES[0]); i++) {
+      SpinResult r = spin(deltas ? SKETCH : SKETCH_TICKS, fast, RATES[i]);
+      printf("%-7s %7s %6u ticks/s: %6ld spun, %6ld arrived, %5u reported lost, all in %.1f ms after the last edge\n",
+             deltas ? "deltas" : "ticks", fast ? "1M" : "115200", RATES[i], r.spun, r.arrived, r.reported,
+             r.lastTickMs);
+      // every tick arrives, or is reported as lost. a bounce that spans two loop passes is sent as a tick and a tick
+      // back, so more commands than ticks can be lost, and they don't all go the same way
+      long missing = r.spun - r.arrived;
+      TEST_ASSERT_TRUE((missing < 0 ? -missing : missing) <= (long)r.reported);
+      if (deltas) TEST_ASSERT_EQUAL_INT32(r.spun, r.arrived);
+      if (fast && RATES[i] <= 4000) TEST_ASSERT_EQUAL_UINT32(0, r.reported);
+      if (deltas || fast) TEST_ASSERT_TRUE(r.lastTickMs >= 0 && r.lastTickMs <= CONTEXT_RPG_DELTA_MS + 3);
+    }
+  }
+
+  // edges closer together than the ISR takes: it only sees where the pins ended up, and a skipped state is no tick
+  SpinResult r = spin(SKETCH, true, 250000);
+  printf("edges every 4 us (ISR takes %u us): %ld of %ld ticks decoded\n", hostIsrUs, r.arrived, r.spun);
+  TEST_ASSERT_TRUE(r.arrived < r.spun);
+}
+
+// ---------- sessions ---------- //
+
+struct SessionResult {
+  uint32_t presses, received, misnamed;
+  long spun[3], arrived[3];
+  uint32_t garbled, dropped;
+};
+
+static const uint8_t SESSION_PINS[] = { PIN_UP, PIN_DOWN, PIN_HOME, PIN_C1A, PIN_C1B, PIN_C2A, PIN_C2B };
+static const char* const SESSION_COMMANDS[] = {
+  "btnUpArrow", "btnDownArrow", "btnHomeClick", "controller1A", "controller1B", "controller2A", "controller2B"
+};
+
+/**
+ * @brief minutes of random presses and spins on a sketch screen
+ *
+ * presses are at least 700 ms apart (no double clicks, no repeats, no holds), spins of either RPG whenever it is free.
+ * The presses are checked in order against what the ESP32 received.
+ */
+static SessionResult session(CoSim& sim, const esp32::InputContext& ctx, uint32_t minutes) {
+  SessionResult r;
+  memset(&r, 0, sizeof(r));
+  sim.peer.show(ctx);
+  sim.runMs(3000);
+  sim.peer.commands.clear();
+  sim.wave.bounceUs = 300;
+  sim.wave.bounces = 2;
+
+  std::vector<int> expected;
+  uint64_t endUs = hostNowUs + (uint64_t)minutes * 60000000;
+  uint64_t nextPress = hostNowUs + 100000;
+  uint64_t rpgFree[3] = { 0, hostNowUs, hostNowUs };
+  while (hostNowUs < endUs) {
+    if (hostNowUs >= nextPress) {
+      int button = sim.wave.random() % 7;
+      sim.wave.press(SESSION_PINS[button], hostNowUs + 1000, 60000 + sim.wave.random() % 200000);
+      expected.push_back(button);
+      nextPress = hostNowUs + 700000 + sim.wave.random() % 800000;
+    }
+    for (int rpg = 1; rpg <= 2; rpg++) {
+      if (hostNowUs < rpgFree[rpg] || sim.wave.random() % 200) continue;
+      int steps = (int)(sim.wave.random() % 121) - 60;
+      uint32_t period = 500 + sim.wave.random() % 5000;
+      rpgFree[rpg] = sim.wave.turn(rpg == 1 ? PIN_RPG1_A : PIN_RPG2_A, rpg == 1 ? PIN_RPG1_B : PIN_RPG2_B,
+                                   hostNowUs + 1000, steps, period) + 2000;
+      r.spun[rpg] += steps;
+    }
+    sim.runMs(1);
+  }
+  sim.runMs(2000);
+
+  // button commands in order: each one has to be the next press or a later one (the ones skipped were lost)
+  size_t next = 0;
+  for (size_t i = 0; i < sim.peer.commands.size(); i++) {
+    const char* line = sim.peer.commands[i].line;
+    if (strncmp(line, "rpg", 3) == 0 || strncmp(line, "txOverflow", 10) == 0) continue;
+    size_t j = next;
+    while (j < expected.size() && strcmp(line, SESSION_COMMANDS[expected[j]]) != 0) j++;
+    if (j < expected.size()) {
+      r.received++;
+      next = j + 1;
+    } else {
+      r.misnamed++;
+    }
+  }
+  r.presses = expected.size();
+  r.arrived[1] = sim.peer.rpgTicks[1];
+  r.arrived[2] = sim.peer.rpgTicks[2];
+  r.garbled = sim.peer.garbled;
+  r.dropped = sim.peer.dropped;
+  return r;
+}
+
+static void printSession(const char* name, const CoSim& sim, const SessionResult& r) {
+  printf("%-22s %u presses, %u arrived in order, %u not; RPG 1 %ld / %ld, RPG 2 %ld / %ld ticks; %u garbled lines, "
+         "%u reported lost; link at %u\n", name, r.presses, r.received, r.misnamed, r.arrived[1], r.spun[1],
+         r.arrived[2], r.spun[2], r.garbled, r.dropped, sim.uart.baud(UART_ARDUINO));
+}
+
+static void test_session_clean() {
+  for (int mode = 0; mode < 2; mode++) {
+    CoSim sim(43 + mode);
+    SessionResult r = session(sim, mode ? SKETCH_TICKS : SKETCH, COSIM_MINUTES);
+    printSession(mode ? "session, ticks" : "session, deltas", sim, r);
+
+    TEST_ASSERT_TRUE(r.presses > 30 * COSIM_MINUTES);
+    TEST_ASSERT_EQUAL_UINT32(r.presses, r.received);
+    TEST_ASSERT_EQUAL_UINT32(0, r.misnamed);
+    TEST_ASSERT_EQUAL_INT32(r.spun[1], r.arrived[1]);
+    TEST_ASSERT_EQUAL_INT32(r.spun[2], r.arrived[2]);
+    TEST_ASSERT_EQUAL_UINT32(0, r.garbled + r.dropped);
+    TEST_ASSERT_EQUAL_UINT64(0, hostStats.writeWaitUs);
+    TEST_ASSERT_EQUAL_UINT32(0, hostStats.adcOffReads);
+  }
+}
+
+// bit errors and lost bytes both ways: what goes wrong is bounded by what the wire damaged
+static void test_session_lossy() {
+  CoSim sim(45);
+  for (int end = 0; end < 2; end++) {
+    sim.uart.line[end].errorPpm = 1000;
+    sim.uart.line[end].dropPpm = 500;
+    sim.uart.line[end].latencyUs = 200;
+  }
+  SessionResult r = session(sim, SKETCH, COSIM_MINUTES);
+  printSession("session, lossy", sim, r);
+
+  uint32_t damaged = sim.uart.stats[UART_ARDUINO].flipped + sim.uart.stats[UART_ARDUINO].dropped;
+  TEST_ASSERT_TRUE(damaged > 0);
+  TEST_ASSERT_TRUE(r.received + damaged >= r.presses && r.misnamed <= damaged);
+  for (int rpg = 1; rpg <= 2; rpg++) {
+    long off = r.arrived[rpg] - r.spun[rpg];
+    TEST_ASSERT_TRUE((off < 0 ? -off : off) <= 128L * damaged);
+  }
+  TEST_ASSERT_EQUAL_UINT64(0, hostStats.writeWaitUs);
+}
+
+static void test_benchmark() {
+  CoSim sim(43);
+  sim.peer.show(SKETCH);
+  double t0 = benchSeconds();
+  SessionResult r = session(sim, SKETCH, 1);
+  double seconds = benchSeconds() - t0;
+  benchReport("co-simulation, busy session", (hostNowUs / 1e6), "simulated second", seconds);
+  (void)r;
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_boot);
+  RUN_TEST(test_buttons);
+  RUN_TEST(test_context_masking);
+  RUN_TEST(test_joysticks);
+  RUN_TEST(test_power_button);
+  RUN_TEST(test_spin_rates);
+  RUN_TEST(test_session_clean);
+  RUN_TEST(test_session_lossy);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
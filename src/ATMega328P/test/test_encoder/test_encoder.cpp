@@ -0,0 +1,107 @@
+/**
+ * @file test_encoder.cpp
+ * @brief RPG quadrature decoding: every transition, random walks with missed states, bouncing contacts
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The decoder is fed AB values the way the ISR hands them over. A walk moves one position (a step), stays, or jumps two
+ * (a state the ISR never saw); the decoded total has to be the steps taken, with a jump counting as nothing.
+ *
+ */
+
+#include <unity.h>
+#include "Encoder.h"
+#include "../bench.h"
+
+static volatile Encoder e;
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+// AB value of a position in the clockwise cycle 00 -> 01 -> 11 -> 10
+static uint8_t abOf(uint8_t position) {
+  return (uint8_t)((position ^ (position >> 1)) & 3);
+}
+
+void setUp() {
+  seed = 43;
+  encoderReset(&e, 0b11);
+}
+
+void tearDown() {}
+
+static void test_every_transition() {
+  for (uint8_t from = 0; from < 4; from++) {
+    for (uint8_t to = 0; to < 4; to++) {
+      encoderReset(&e, abOf(from));
+      int8_t expected = (to == ((from + 1) & 3)) ? 1 : (to == ((from + 3) & 3)) ? -1 : 0;
+      TEST_ASSERT_EQUAL_INT8(expected, encoderStep(&e, abOf(to)));
+      TEST_ASSERT_EQUAL_UINT8(abOf(to), e.prev);
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT8(0b10, encoderPosition(0b11));
+  encoderReset(&e, 0xFF);                               // only the two pin bits are kept
+  TEST_ASSERT_EQUAL_UINT8(0b11, e.prev);
+}
+
+static void test_random_walk() {
+  for (int round = 0; round < 100; round++) {
+    uint8_t position = next() & 3;
+    encoderReset(&e, abOf(position));
+    long taken = 0, decoded = 0;
+    for (int i = 0; i < 10000; i++) {
+      uint32_t r = next() % 20;
+      int move = (r < 8) ? 1 : (r < 16) ? -1 : (r < 18) ? 0 : 2;
+      if (move == 1 || move == -1) taken += move;
+      position = (uint8_t)((position + move + 4) & 3);
+      decoded += encoderStep(&e, abOf(position));
+    }
+    TEST_ASSERT_EQUAL_INT32(taken, decoded);
+  }
+}
+
+// a contact bouncing on its way to the next state, or touching it and falling back
+static void test_bounce() {
+  for (int bounces = 0; bounces < 8; bounces++) {
+    for (uint8_t from = 0; from < 4; from++) {
+      uint8_t to = (from + 1) & 3;
+      encoderReset(&e, abOf(from));
+      int total = encoderStep(&e, abOf(to));
+      for (int i = 0; i < bounces; i++) {
+        total += encoderStep(&e, abOf(from));
+        total += encoderStep(&e, abOf(to));
+      }
+      TEST_ASSERT_EQUAL_INT(1, total);
+
+      encoderReset(&e, abOf(from));
+      total = 0;
+      for (int i = 0; i <= bounces; i++) {
+        total += encoderStep(&e, abOf(to));
+        total += encoderStep(&e, abOf(from));
+      }
+      TEST_ASSERT_EQUAL_INT(0, total);
+    }
+  }
+}
+
+static void test_benchmark() {
+  const uint32_t N = 50000000;
+  volatile int32_t sum = 0;
+  double t0 = benchSeconds();
+  for (uint32_t i = 0; i < N; i++) sum += encoderStep(&e, abOf((uint8_t)(i & 3)));
+  benchReport("encoderStep", N, "edge", benchSeconds() - t0);
+  TEST_ASSERT_EQUAL_INT32((int32_t)N - 1, sum);         // the first edge from 11 to 00 is a jump
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_every_transition);
+  RUN_TEST(test_random_walk);
+  RUN_TEST(test_bounce);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,285 @@
+/**
+ * @file test_gesture.cpp
+ * @brief gesture recognizer: debounce, click / hold / double click / repeat timing, sparse sampling and millis() wrap
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The buttons use the timing of BUTTON_GESTURES in main.cpp. Presses are written as contact waveforms (bounce on both
+ * edges included) and sampled once per millisecond like a busy loop() would, or at a coarser interval to see what a
+ * slow pass does. Every reported gesture is logged with the time it came out.
+ *
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "Gesture.h"
+#include "../bench.h"
+
+#define DEBOUNCE_MS 30
+#define HOLD_MS 1000
+#define DOUBLE_MS 300
+#define REPEAT_DELAY_MS 400
+#define REPEAT_MS 120
+
+enum { ARROW, HOME, CTRL, CLICKER, POWER, COUNT };
+
+static const GestureConfig CONFIG[COUNT] = {
+  { GESTURE_ON_PRESS | GESTURE_ON_REPEAT, DEBOUNCE_MS, 0, 0, REPEAT_DELAY_MS, REPEAT_MS },
+  { GESTURE_ON_CLICK | GESTURE_ON_HOLD, DEBOUNCE_MS, HOLD_MS, 0, 0, 0 },
+  { GESTURE_ON_PRESS | GESTURE_ON_DOUBLE, DEBOUNCE_MS, 0, DOUBLE_MS, 0, 0 },
+  { GESTURE_ON_CLICK | GESTURE_ON_DOUBLE | GESTURE_ON_RELEASE, DEBOUNCE_MS, 0, DOUBLE_MS, 0, 0 },
+  { GESTURE_ON_HOLD, DEBOUNCE_MS, HOLD_MS, 0, 0, 0 },
+};
+
+struct Logged {
+  uint8_t button;
+  GestureEvent event;
+  uint32_t at;
+};
+
+static GestureSet set;
+static Logged events[4096];
+static int eventCount;
+static uint32_t nowMs;
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+static void onGesture(uint8_t button, GestureEvent event) {
+  TEST_ASSERT_TRUE(eventCount < 4096);
+  events[eventCount++] = { button, event, nowMs };
+}
+
+// contact level of each button over time: a list of edges, bouncing edges are several close together
+struct Wave {
+  uint32_t at[256];
+  bool level[256];
+  int count;
+
+  void add(uint32_t t, bool l) { at[count] = t; level[count] = l; count++; }
+
+  // press for len ms from t, with a few ms of bounce on both edges
+  void press(uint32_t t, uint32_t len, int bounces) {
+    for (int i = 0; i < bounces; i++) { add(t + 2 * i, true); add(t + 2 * i + 1, false); }
+    add(t + 2 * bounces, true);
+    for (int i = 0; i < bounces; i++) { add(t + len + 2 * i, false); add(t + len + 2 * i + 1, true); }
+    add(t + len + 2 * bounces, false);
+  }
+
+  bool levelAt(uint32_t t) const {
+    bool l = false;
+    for (int i = 0; i < count && (int32_t)(t - at[i]) >= 0; i++) l = level[i];
+    return l;
+  }
+};
+
+static Wave waves[COUNT];
+
+// sample all buttons from..to every step ms
+static void run(uint32_t from, uint32_t to, uint32_t step = 1) {
+  for (nowMs = from; (int32_t)(to - nowMs) >= 0; nowMs += step) {
+    uint8_t pressed = 0;
+    for (int b = 0; b < COUNT; b++) pressed |= waves[b].levelAt(nowMs) << b;
+    gestureUpdate(&set, pressed, nowMs, onGesture);
+  }
+}
+
+static int countOf(uint8_t button, GestureEvent event) {
+  int n = 0;
+  for (int i = 0; i < eventCount; i++) n += events[i].button == button && events[i].event == event;
+  return n;
+}
+
+static const Logged* nth(uint8_t button, GestureEvent event, int k) {
+  for (int i = 0; i < eventCount; i++) {
+    if (events[i].button == button && events[i].event == event && k-- == 0) return &events[i];
+  }
+  return nullptr;
+}
+
+void setUp() {
+  seed = 39;
+  gestureInit(&set, CONFIG, COUNT);
+  memset(waves, 0, sizeof(waves));
+  eventCount = 0;
+}
+
+void tearDown() {}
+
+static void test_debounce() {
+  // contact bounce for 10 ms: one press, reported 30 ms after the contact settled
+  waves[ARROW].press(100, 200, 5);
+  run(0, 1000);
+  TEST_ASSERT_EQUAL_INT(1, countOf(ARROW, GESTURE_PRESS));
+  TEST_ASSERT_EQUAL_UINT32(110 + DEBOUNCE_MS, nth(ARROW, GESTURE_PRESS, 0)->at);
+  TEST_ASSERT_FALSE(gestureDown(&set, ARROW));
+  TEST_ASSERT_TRUE(gestureIdle(&set));
+
+  // a glitch shorter than the debounce time is nothing at all
+  setUp();
+  waves[ARROW].press(100, DEBOUNCE_MS - 1, 0);
+  run(0, 1000);
+  TEST_ASSERT_EQUAL_INT(0, eventCount);
+
+  // the level has to be seen unchanged debounceMs after the edge: 30 ms of contact is still a glitch, 31 is a press
+  setUp();
+  waves[ARROW].press(100, DEBOUNCE_MS, 0);
+  run(0, 1000);
+  TEST_ASSERT_EQUAL_INT(0, eventCount);
+  setUp();
+  waves[ARROW].press(100, DEBOUNCE_MS + 1, 0);
+  run(0, 1000);
+  TEST_ASSERT_EQUAL_INT(1, countOf(ARROW, GESTURE_PRESS));
+}
+
+static void test_click_and_hold() {
+  // released a millisecond before the hold: a click on release
+  waves[HOME].press(100, HOLD_MS - 1, 3);
+  // held: the hold comes out after exactly a second and there is no click on release
+  waves[HOME].press(3000, 2000, 3);
+  run(0, 6000);
+  TEST_ASSERT_EQUAL_INT(1, countOf(HOME, GESTURE_CLICK));
+  TEST_ASSERT_EQUAL_UINT32(100 + HOLD_MS - 1 + 6 + DEBOUNCE_MS, nth(HOME, GESTURE_CLICK, 0)->at);
+  TEST_ASSERT_EQUAL_INT(1, countOf(HOME, GESTURE_HOLD));
+  TEST_ASSERT_EQUAL_UINT32(3006 + DEBOUNCE_MS + HOLD_MS, nth(HOME, GESTURE_HOLD, 0)->at);
+  TEST_ASSERT_EQUAL_INT(2, eventCount);
+
+  // the power button only knows hold
+  setUp();
+  waves[POWER].press(100, 500, 2);
+  waves[POWER].press(1000, 1500, 2);
+  run(0, 3000);
+  TEST_ASSERT_EQUAL_INT(1, eventCount);
+  TEST_ASSERT_EQUAL_UINT32(1004 + DEBOUNCE_MS + HOLD_MS, events[0].at);
+}
+
+static void test_double_click() {
+  // controller: a press each time, the second one within the window also a double
+  waves[CTRL].press(100, 80, 2);
+  waves[CTRL].press(100 + 80 + 250, 80, 2);
+  // outside the window: two single presses
+  waves[CTRL].press(2000, 80, 2);
+  waves[CTRL].press(2000 + 80 + DOUBLE_MS + 10, 80, 2);
+  run(0, 4000);
+  TEST_ASSERT_EQUAL_INT(4, countOf(CTRL, GESTURE_PRESS));
+  TEST_ASSERT_EQUAL_INT(1, countOf(CTRL, GESTURE_DOUBLE));
+  // the double follows its press directly
+  const Logged* d = nth(CTRL, GESTURE_DOUBLE, 0);
+  TEST_ASSERT_EQUAL_UINT32(nth(CTRL, GESTURE_PRESS, 1)->at, d->at);
+  TEST_ASSERT_EQUAL_INT(GESTURE_PRESS, (d - 1)->event);
+
+  // with clicks reported too, a click waits for the window to close and a double has no click
+  setUp();
+  waves[CLICKER].press(100, 80, 0);
+  waves[CLICKER].press(1000, 80, 0);
+  waves[CLICKER].press(1000 + 80 + 100, 80, 0);
+  run(0, 2000);
+  TEST_ASSERT_EQUAL_INT(1, countOf(CLICKER, GESTURE_CLICK));
+  TEST_ASSERT_EQUAL_UINT32(180 + DEBOUNCE_MS + DOUBLE_MS, nth(CLICKER, GESTURE_CLICK, 0)->at);
+  TEST_ASSERT_EQUAL_INT(1, countOf(CLICKER, GESTURE_DOUBLE));
+  TEST_ASSERT_EQUAL_INT(3, countOf(CLICKER, GESTURE_RELEASE));
+}
+
+static void test_repeat() {
+  // held 1 s after the debounce: repeats at 400, 520, ... 1000 ms into the press
+  waves[ARROW].press(100, 1000 + DEBOUNCE_MS, 0);
+  run(0, 2000);
+  uint32_t pressAt = 100 + DEBOUNCE_MS;
+  TEST_ASSERT_EQUAL_UINT32(pressAt, nth(ARROW, GESTURE_PRESS, 0)->at);
+  TEST_ASSERT_EQUAL_INT(6, countOf(ARROW, GESTURE_REPEAT));
+  for (int k = 0; k < 6; k++) {
+    TEST_ASSERT_EQUAL_UINT32(pressAt + REPEAT_DELAY_MS + k * REPEAT_MS, nth(ARROW, GESTURE_REPEAT, k)->at);
+  }
+
+  // a loop pass every 50 ms: the repeats keep their pace on average and never come two at once
+  setUp();
+  waves[ARROW].press(100, 3000, 0);
+  run(0, 4000, 50);
+  int repeats = countOf(ARROW, GESTURE_REPEAT);
+  TEST_ASSERT_INT_WITHIN(3, (3000 - REPEAT_DELAY_MS) / REPEAT_MS, repeats);
+  for (int k = 1; k < repeats; k++) {
+    TEST_ASSERT_TRUE(nth(ARROW, GESTURE_REPEAT, k)->at - nth(ARROW, GESTURE_REPEAT, k - 1)->at >= 100);
+  }
+
+  // a pass that took a second: one repeat, not eight
+  setUp();
+  waves[ARROW].press(100, 3000, 0);
+  run(0, 600);
+  int before = countOf(ARROW, GESTURE_REPEAT);
+  run(1600, 1600);
+  TEST_ASSERT_EQUAL_INT(before + 1, countOf(ARROW, GESTURE_REPEAT));
+}
+
+static void test_millis_wrap() {
+  uint32_t t = 0xFFFFFFFFu - 500;
+  waves[HOME].press(t, 2000, 2);
+  waves[CTRL].press(t + 100, 50, 0);
+  waves[CTRL].press(t + 250, 50, 0);
+  run(t - 100, t + 3000);
+  TEST_ASSERT_EQUAL_INT(1, countOf(HOME, GESTURE_HOLD));
+  TEST_ASSERT_EQUAL_UINT32(t + 4 + DEBOUNCE_MS + HOLD_MS, nth(HOME, GESTURE_HOLD, 0)->at);
+  TEST_ASSERT_EQUAL_INT(0, countOf(HOME, GESTURE_CLICK));
+  TEST_ASSERT_EQUAL_INT(1, countOf(CTRL, GESTURE_DOUBLE));
+}
+
+// random bouncy presses of every length: each one gives exactly the gestures its length calls for
+static void test_random_presses() {
+  for (int round = 0; round < 200; round++) {
+    setUp();
+    seed = 39 + round;
+    uint32_t t = 50;
+    int clicks = 0, holds = 0, presses = 0;
+    int n = 0;
+    while (n < 60) {
+      uint32_t len = DEBOUNCE_MS + 10 + next() % 1800;
+      int bounces = next() % 4;
+      waves[HOME].press(t, len, bounces);
+      presses++;
+      if (len <= HOLD_MS) clicks++;                   // released on the very sample the hold would come out: a click
+      else holds++;
+      t += len + 2 * bounces + DEBOUNCE_MS + 20 + next() % 200;
+      n += 2 * bounces + 2;
+      if (waves[HOME].count > 240) break;
+    }
+    run(0, t + 100, 1 + round % 7);
+    // sampled every ms the split is exact. a pass every few ms can see a press within a few ms of a second either way
+    if (round % 7 == 0) {
+      TEST_ASSERT_EQUAL_INT(clicks, countOf(HOME, GESTURE_CLICK));
+      TEST_ASSERT_EQUAL_INT(holds, countOf(HOME, GESTURE_HOLD));
+    } else {
+      TEST_ASSERT_INT_WITHIN(presses / 10 + 1, holds, countOf(HOME, GESTURE_HOLD));
+    }
+    TEST_ASSERT_EQUAL_INT(presses, countOf(HOME, GESTURE_CLICK) + countOf(HOME, GESTURE_HOLD));
+    TEST_ASSERT_TRUE(gestureIdle(&set));
+  }
+}
+
+static void test_benchmark() {
+  GestureConfig all[GESTURE_MAX_BUTTONS];
+  for (int i = 0; i < GESTURE_MAX_BUTTONS; i++) all[i] = CONFIG[i % COUNT];
+  gestureInit(&set, all, GESTURE_MAX_BUTTONS);
+  const uint32_t N = 5000000;
+  double t0 = benchSeconds();
+  for (uint32_t i = 0; i < N; i++) {
+    nowMs = i;
+    gestureUpdate(&set, (i >> 9) & 0x5A, i, onGesture);
+    eventCount = 0;
+  }
+  benchReport("gestureUpdate, 8 buttons", N, "pass", benchSeconds() - t0);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_debounce);
+  RUN_TEST(test_click_and_hold);
+  RUN_TEST(test_double_click);
+  RUN_TEST(test_repeat);
+  RUN_TEST(test_millis_wrap);
+  RUN_TEST(test_random_presses);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,246 @@
+/**
+ * @file test_pinmap.cpp
+ * @brief pin numbers -> ports and masks, and the sketch's masks and RPG decoding against the hand kept ones they replaced
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * PinMap.h is checked against the Uno / Nano pinout written out by hand. The sketch (main.cpp, on the simulated chip in
+ * lib/HostAVR) is then given one context bit at a time, and the PCMSK registers it sets have to be the masks that were
+ * written out per input before they were derived (PB2 | PB3 for RPG 1 and so on). The port b ISR is fed every RPG
+ * transition and random pin walks, and has to count what the old per-RPG code decoded: RPG 1 A on PB2 and B on PB3,
+ * RPG 2 A on PB5 and B on PB4.
+ *
+ */
+
+#include <unity.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "HostAVR.h"
+#include "PinMap.h"
+#include "InputContext.h"
+#include "../bench.h"
+
+// the sketch
+extern InputContext inputContext;
+extern volatile int16_t rpgCount[2];
+void applyInputContext();
+
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+void setUp() {
+  seed = 44;
+  hostReset();
+}
+
+void tearDown() {}
+
+// ---------- PinMap.h ---------- //
+
+struct PinoutRow {
+  uint8_t pin;
+  uint8_t port;
+  uint8_t bit;
+};
+
+// ATmega328P datasheet / Uno schematic
+static const PinoutRow PINOUT[20] = {
+  { 0, PORT_D, 0 },  { 1, PORT_D, 1 },  { 2, PORT_D, 2 },  { 3, PORT_D, 3 },  { 4, PORT_D, 4 },
+  { 5, PORT_D, 5 },  { 6, PORT_D, 6 },  { 7, PORT_D, 7 },  { 8, PORT_B, 0 },  { 9, PORT_B, 1 },
+  { 10, PORT_B, 2 }, { 11, PORT_B, 3 }, { 12, PORT_B, 4 }, { 13, PORT_B, 5 }, { 14, PORT_C, 0 },
+  { 15, PORT_C, 1 }, { 16, PORT_C, 2 }, { 17, PORT_C, 3 }, { 18, PORT_C, 4 }, { 19, PORT_C, 5 },
+};
+
+static void test_pinout() {
+  for (int i = 0; i < 20; i++) {
+    const PinoutRow& row = PINOUT[i];
+    TEST_ASSERT_EQUAL_UINT8(row.port, pinPort(row.pin));
+    TEST_ASSERT_EQUAL_UINT8(row.bit, pinBit(row.pin));
+    TEST_ASSERT_EQUAL_UINT8(1 << row.bit, pinMask(row.pin));
+  }
+}
+
+// pulling a pin low on the simulated chip clears exactly that bit of that port's PINx
+static void test_pins_on_the_chip() {
+  volatile uint8_t* const PIN_REG[3] = { &PINB, &PINC, &PIND };
+  for (uint8_t pin = 0; pin < 20; pin++) {
+    uint8_t before[3] = { PINB, PINC, PIND };
+    hostSetPin(pin, false);
+    for (uint8_t port = 0; port < 3; port++) {
+      uint8_t expected = (port == pinPort(pin)) ? (uint8_t)(before[port] & ~pinMask(pin)) : before[port];
+      TEST_ASSERT_EQUAL_HEX8(expected, *PIN_REG[port]);
+    }
+    hostSetPin(pin, true);
+  }
+}
+
+static void test_port_mask() {
+  TEST_ASSERT_EQUAL_HEX8(0, portMask(nullptr, 0, PORT_B));
+
+  for (int round = 0; round < 1000; round++) {
+    uint8_t pins[12];
+    uint8_t count = (uint8_t)(next() % 13);
+    uint8_t expected[3] = { 0, 0, 0 };
+    for (uint8_t i = 0; i < count; i++) {
+      pins[i] = (uint8_t)(next() % 20);                  // repeats allowed
+      expected[PINOUT[pins[i]].port] |= (uint8_t)(1 << PINOUT[pins[i]].bit);
+    }
+    for (uint8_t port = 0; port < 3; port++) {
+      TEST_ASSERT_EQUAL_HEX8(expected[port], portMask(pins, count, port));
+    }
+  }
+
+  // the sketch's button table, as it was written out by hand
+  static const uint8_t BUTTONS[8] = { 4, 2, 3, 9, 8, 7, 6, 19 };
+  TEST_ASSERT_EQUAL_HEX8(0b00000011, portMask(BUTTONS, 8, PORT_B));
+  TEST_ASSERT_EQUAL_HEX8(0b00100000, portMask(BUTTONS, 8, PORT_C));
+  TEST_ASSERT_EQUAL_HEX8(0b11011100, portMask(BUTTONS, 8, PORT_D));
+}
+
+// ---------- the sketch's masks ---------- //
+
+struct ContextMasks {
+  uint16_t inputs;
+  uint8_t pcmsk0, pcmsk2;                                // PCMSK1 is always the power button (PC5)
+};
+
+// applyInputContext() before the masks were derived from the pin tables
+static const ContextMasks OLD_MASKS[] = {
+  { CTX_UP_ARROW, 0, 1 << 4 },                           // PD4
+  { CTX_DOWN_ARROW, 0, 1 << 2 },                         // PD2
+  { CTX_HOME, 0, 1 << 3 },                               // PD3
+  { CTX_C1A, 1 << 1, 0 },                                // PB1
+  { CTX_C1B, 1 << 0, 0 },                                // PB0
+  { CTX_C2A, 0, 1 << 7 },                                // PD7
+  { CTX_C2B, 0, 1 << 6 },                                // PD6
+  { CTX_RPG1, (1 << 2) | (1 << 3), 0 },                  // PB2 | PB3
+  { CTX_RPG2, (1 << 4) | (1 << 5), 0 },                  // PB4 | PB5
+  { CTX_JOY1, 0, 0 },
+  { CTX_JOY2, 0, 0 },
+};
+
+static void applyContext(uint16_t inputs) {
+  inputContext.inputs = inputs;
+  applyInputContext();
+}
+
+static void test_context_masks() {
+  const int n = sizeof(OLD_MASKS) / sizeof(OLD_MASKS[0]);
+  for (int i = 0; i < n; i++) {
+    applyContext(OLD_MASKS[i].inputs);
+    TEST_ASSERT_EQUAL_HEX8(OLD_MASKS[i].pcmsk0, PCMSK0);
+    TEST_ASSERT_EQUAL_HEX8(1 << 5, PCMSK1);
+    TEST_ASSERT_EQUAL_HEX8(OLD_MASKS[i].pcmsk2, PCMSK2);
+    TEST_ASSERT_EQUAL_HEX8((1 << PCIE0) | (1 << PCIE1) | (1 << PCIE2), PCICR);
+    TEST_ASSERT_EQUAL((OLD_MASKS[i].inputs & CTX_JOYSTICKS) != 0, (ADCSRA & (1 << ADEN)) != 0);
+  }
+
+  // any combination is the OR of its bits
+  for (int round = 0; round < 2000; round++) {
+    uint16_t inputs = (uint16_t)(next() & CTX_ALL);
+    uint8_t pcmsk0 = 0, pcmsk2 = 0;
+    for (int i = 0; i < n; i++) {
+      if (inputs & OLD_MASKS[i].inputs) {
+        pcmsk0 |= OLD_MASKS[i].pcmsk0;
+        pcmsk2 |= OLD_MASKS[i].pcmsk2;
+      }
+    }
+    applyContext(inputs);
+    TEST_ASSERT_EQUAL_HEX8(pcmsk0, PCMSK0);
+    TEST_ASSERT_EQUAL_HEX8(1 << 5, PCMSK1);
+    TEST_ASSERT_EQUAL_HEX8(pcmsk2, PCMSK2);
+  }
+}
+
+// ---------- the port b ISR ---------- //
+
+// clockwise successor of an AB value (00 -> 01 -> 11 -> 10 -> 00), as the old switch cases had it
+static const uint8_t CW_NEXT[4] = { 0b01, 0b11, 0b00, 0b10 };
+
+static int oldStep(uint8_t prev, uint8_t ab) {
+  return (ab == CW_NEXT[prev]) ? 1 : (prev == CW_NEXT[ab]) ? -1 : 0;
+}
+
+static uint8_t oldAB1(uint8_t pinB) {
+  return ((pinB & (1 << 2)) ? 0b10 : 0) | ((pinB & (1 << 3)) ? 0b01 : 0);
+}
+
+static uint8_t oldAB2(uint8_t pinB) {
+  return ((pinB & (1 << 5)) ? 0b10 : 0) | ((pinB & (1 << 4)) ? 0b01 : 0);
+}
+
+// change all four RPG pins at once (one ISR call), then let the ISR's time pass
+static void setRPGPins(uint8_t bits) {
+  cli();
+  for (uint8_t b = 2; b <= 5; b++) hostSetPin((uint8_t)(8 + b), (bits >> b) & 1);
+  sei();
+  hostAdvanceUs(hostIsrUs);
+}
+
+static void test_isr_transitions() {
+  applyContext(CTX_RPG1 | CTX_RPG2);
+  for (uint8_t from = 0; from < 16; from++) {
+    for (uint8_t to = 0; to < 16; to++) {
+      setRPGPins((uint8_t)(from << 2));
+      applyContext(CTX_RPG1 | CTX_RPG2);                 // start decoding from here, counts cleared
+      setRPGPins((uint8_t)(to << 2));
+      TEST_ASSERT_EQUAL_INT16(oldStep(oldAB1(from << 2), oldAB1(to << 2)), rpgCount[0]);
+      TEST_ASSERT_EQUAL_INT16(oldStep(oldAB2(from << 2), oldAB2(to << 2)), rpgCount[1]);
+    }
+  }
+}
+
+static void test_isr_walk() {
+  for (int round = 0; round < 50; round++) {
+    uint16_t inputs = (round % 3 == 0) ? CTX_RPG1 : (round % 3 == 1) ? CTX_RPG2 : (CTX_RPG1 | CTX_RPG2);
+    uint8_t pinB = (uint8_t)(next() & 0b111100);
+    setRPGPins(pinB);
+    applyContext(inputs);
+
+    long expected[2] = { 0, 0 };
+    for (int i = 0; i < 1000; i++) {
+      // mostly one pin at a time, like a turning RPG; sometimes two (a state the ISR never saw)
+      uint8_t flip = (uint8_t)(1 << (2 + next() % 4));
+      if (next() % 10 == 0) flip |= (uint8_t)(1 << (2 + next() % 4));
+      uint8_t now = pinB ^ flip;
+      expected[0] += oldStep(oldAB1(pinB), oldAB1(now));
+      expected[1] += oldStep(oldAB2(pinB), oldAB2(now));
+      setRPGPins(now);
+      pinB = now;
+    }
+    // a masked RPG is not decoded at all
+    TEST_ASSERT_EQUAL_INT16((inputs & CTX_RPG1) ? expected[0] : 0, rpgCount[0]);
+    TEST_ASSERT_EQUAL_INT16((inputs & CTX_RPG2) ? expected[1] : 0, rpgCount[1]);
+  }
+}
+
+static void test_benchmark() {
+  applyContext(CTX_RPG1 | CTX_RPG2);
+  static const uint8_t TURN[4] = { 0b00, 0b01, 0b11, 0b10 };     // PB3..2 going round
+  const uint32_t N = 20000000;
+  double t0 = benchSeconds();
+  for (uint32_t i = 0; i < N; i++) {
+    PINB = (uint8_t)(TURN[i & 3] << 2);                  // RPG 1 turning counter clockwise, RPG 2 still
+    PCINT0_vect();
+  }
+  benchReport("port b ISR, both RPGs unmasked", N, "call", benchSeconds() - t0);
+  TEST_ASSERT_EQUAL_INT16(-INT16_MAX, rpgCount[0]);     // nobody took the ticks: saturated, not wrapped
+  TEST_ASSERT_EQUAL_INT16(0, rpgCount[1]);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_pinout);
+  RUN_TEST(test_pins_on_the_chip);
+  RUN_TEST(test_port_mask);
+  RUN_TEST(test_context_masks);
+  RUN_TEST(test_isr_transitions);
+  RUN_TEST(test_isr_walk);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,256 @@
+/**
+ * @file test_txqueue.cpp
+ * @brief TX queue: priority order, coalescing, RPG delta totals past int8_t, drops and their count
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The random test pushes and pops like a busy loop() would (pops standing in for the serial buffer draining) and checks
+ * what has to hold whatever the order: every priority comes out oldest first, a higher priority always goes first,
+ * joystick keys have at most one command waiting, every drop is counted, and the RPG delta totals that come out add up
+ * to what went in unless part of one was dropped.
+ *
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <deque>
+#include "TxQueue.h"
+#include "../bench.h"
+
+// codes for the test, the real ones are in main.cpp
+enum { C_BUTTON = 1, C_TICK, C_DELTA1, C_DELTA2, C_JOY_UP, C_JOY_DOWN };
+#define KEY_RPG1 1
+#define KEY_RPG2 2
+
+static TxQueue q;
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+static bool pop(uint8_t* code, int8_t* value) {
+  if (!txPeek(&q, code, value)) return false;
+  txPop(&q);
+  return true;
+}
+
+void setUp() {
+  seed = 40;
+  txQueueInit(&q);
+}
+
+void tearDown() {}
+
+static void test_priority_order() {
+  txPush(&q, C_JOY_UP, TX_LOW, 1);
+  txPush(&q, C_TICK, TX_NORMAL, TX_NO_COALESCE);
+  txPush(&q, C_BUTTON, TX_HIGH, TX_NO_COALESCE, 1);
+  txPush(&q, C_BUTTON, TX_HIGH, TX_NO_COALESCE, 2);
+  txPush(&q, C_TICK, TX_NORMAL, TX_NO_COALESCE, 3);
+
+  const uint8_t CODES[] = { C_BUTTON, C_BUTTON, C_TICK, C_TICK, C_JOY_UP };
+  const int8_t VALUES[] = { 1, 2, 0, 3, 0 };
+  uint8_t code;
+  int8_t value;
+  for (int i = 0; i < 5; i++) {
+    TEST_ASSERT_TRUE(pop(&code, &value));
+    TEST_ASSERT_EQUAL_UINT8(CODES[i], code);
+    TEST_ASSERT_EQUAL_INT8(VALUES[i], value);
+  }
+  TEST_ASSERT_FALSE(txPeek(&q, &code));
+  txPop(&q);                                          // popping nothing does nothing
+  TEST_ASSERT_FALSE(txPeek(&q, &code));
+}
+
+static void test_coalescing() {
+  // a joystick: only the newest direction waits, in the place of the first one
+  txPush(&q, C_JOY_UP, TX_LOW, 1);
+  txPush(&q, C_JOY_UP, TX_LOW, 2);
+  txPush(&q, C_JOY_DOWN, TX_LOW, 1);
+  txPush(&q, C_JOY_DOWN, TX_LOW, 1);
+  TEST_ASSERT_EQUAL_UINT16(2, q.coalesced);
+  TEST_ASSERT_EQUAL_UINT8(2, q.rings[TX_LOW].count);
+  uint8_t code;
+  int8_t value;
+  TEST_ASSERT_TRUE(pop(&code, &value));
+  TEST_ASSERT_EQUAL_UINT8(C_JOY_DOWN, code);
+
+  // keys only match in their own priority
+  txQueueInit(&q);
+  txPush(&q, C_DELTA1, TX_NORMAL, KEY_RPG1, 5);
+  txPush(&q, C_JOY_UP, TX_LOW, KEY_RPG1);
+  TEST_ASSERT_EQUAL_UINT16(0, q.coalesced);
+
+  // deltas add up
+  txPush(&q, C_DELTA1, TX_NORMAL, KEY_RPG1, -12);
+  txPush(&q, C_DELTA2, TX_NORMAL, KEY_RPG2, 7);
+  txPush(&q, C_DELTA1, TX_NORMAL, KEY_RPG1, 3);
+  TEST_ASSERT_TRUE(pop(&code, &value));
+  TEST_ASSERT_EQUAL_INT8(-4, value);
+  TEST_ASSERT_TRUE(pop(&code, &value));
+  TEST_ASSERT_EQUAL_UINT8(C_DELTA2, code);
+  TEST_ASSERT_EQUAL_INT8(7, value);
+}
+
+// a fast spin: a total past 127 is split, nothing is lost
+static void test_delta_past_int8() {
+  for (int i = 0; i < 20; i++) txPush(&q, C_DELTA1, TX_NORMAL, KEY_RPG1, 100);
+  TEST_ASSERT_EQUAL_UINT16(0, q.dropped);
+  int total = 0, commands = 0;
+  uint8_t code;
+  int8_t value;
+  while (pop(&code, &value)) {
+    total += value;
+    commands++;
+  }
+  TEST_ASSERT_EQUAL_INT(2000, total);
+  TEST_ASSERT_EQUAL_INT(16, commands);                // 15 full ones (127) and the rest
+
+  // the same backwards
+  for (int i = 0; i < 3; i++) txPush(&q, C_DELTA1, TX_NORMAL, KEY_RPG1, -128);
+  total = 0;
+  while (pop(&code, &value)) total += value;
+  TEST_ASSERT_EQUAL_INT(-384, total);
+
+  // no room for the rest: it is counted as dropped
+  txQueueInit(&q);
+  for (int i = 0; i < TX_QUEUE_SIZE - 1; i++) txPush(&q, C_TICK, TX_NORMAL, TX_NO_COALESCE);
+  TEST_ASSERT_TRUE(txPush(&q, C_DELTA1, TX_NORMAL, KEY_RPG1, 120));
+  TEST_ASSERT_FALSE(txPush(&q, C_DELTA1, TX_NORMAL, KEY_RPG1, 120));
+  TEST_ASSERT_EQUAL_UINT16(1, q.dropped);
+}
+
+static void test_overflow() {
+  for (int i = 0; i < TX_QUEUE_SIZE; i++) TEST_ASSERT_TRUE(txPush(&q, C_BUTTON, TX_HIGH, TX_NO_COALESCE, i));
+  for (int i = 0; i < 5; i++) TEST_ASSERT_FALSE(txPush(&q, C_BUTTON, TX_HIGH, TX_NO_COALESCE));
+  // a full priority does not block the others, and a full ring still coalesces
+  TEST_ASSERT_TRUE(txPush(&q, C_JOY_UP, TX_LOW, 1));
+  TEST_ASSERT_EQUAL_UINT16(5, txTakeDropped(&q));
+  TEST_ASSERT_EQUAL_UINT16(0, txTakeDropped(&q));
+
+  // the ring wraps around
+  uint8_t code;
+  int8_t value;
+  for (int round = 0; round < 5; round++) {
+    for (int i = 0; i < 7; i++) {
+      TEST_ASSERT_TRUE(pop(&code, &value));
+      TEST_ASSERT_EQUAL_INT8((round * 7 + i) % 100, value);
+      txPush(&q, C_BUTTON, TX_HIGH, TX_NO_COALESCE, (round * 7 + i + TX_QUEUE_SIZE) % 100);
+    }
+  }
+}
+
+static void test_random_traffic() {
+  int checkedRounds = 0, dropRounds = 0;
+  static const uint8_t PRIORITY_OF[] = { 0, TX_HIGH, TX_NORMAL, TX_NORMAL, TX_NORMAL, TX_LOW, TX_LOW };
+  for (int round = 0; round < 200; round++) {
+    txQueueInit(&q);
+    long pushedDelta[3] = { 0, 0, 0 }, poppedDelta[3] = { 0, 0, 0 };
+    std::deque<int8_t> waiting[TX_PRIORITIES];        // buttons and ticks that made it in, in push order
+    uint32_t drops = 0;
+    bool deltaLost = false;
+    int seq[TX_PRIORITIES] = { 0, 0, 0 };
+
+    for (int step = 0; step < 3000; step++) {
+      int kind = next() % 6;
+      // bursts of pushes, slower drain when the round says the link is busy
+      int pushes = next() % (2 + round % 5);
+      for (int k = 0; k < pushes; k++) {
+        bool ok;
+        switch (kind) {
+          case 0: case 1: {
+            TxPriority p = kind ? TX_NORMAL : TX_HIGH;
+            int8_t v = seq[p]++ & 0x7F;
+            ok = txPush(&q, kind ? C_TICK : C_BUTTON, p, TX_NO_COALESCE, v);
+            if (ok) waiting[p].push_back(v);
+            break;
+          }
+          case 2: case 3: {
+            int rpg = 1 + kind - 2;
+            int8_t d = (int8_t)(next() % 255 - 127);
+            ok = txPush(&q, C_DELTA1 + rpg - 1, TX_NORMAL, rpg, d);
+            pushedDelta[rpg] += d;
+            if (!ok) deltaLost = true;
+            break;
+          }
+          default: ok = txPush(&q, C_JOY_UP + next() % 2, TX_LOW, 1 + next() % 2, 0); break;
+        }
+        if (!ok) drops++;
+      }
+
+      int pops = next() % (4 - round % 3);
+      uint8_t code;
+      int8_t value;
+      for (int k = 0; k < pops && txPeek(&q, &code, &value); k++) {
+        int p = PRIORITY_OF[code];
+        // nothing of a higher priority is waiting
+        for (int h = 0; h < p; h++) TEST_ASSERT_EQUAL_UINT8(0, q.rings[h].count);
+        txPop(&q);
+        if (code == C_BUTTON || code == C_TICK) {
+          // oldest first
+          TEST_ASSERT_FALSE(waiting[p].empty());
+          TEST_ASSERT_EQUAL_INT8(waiting[p].front(), value);
+          waiting[p].pop_front();
+        }
+        if (code == C_DELTA1) poppedDelta[1] += value;
+        if (code == C_DELTA2) poppedDelta[2] += value;
+      }
+      // each joystick has at most one command waiting
+      int joy[3] = { 0, 0, 0 };
+      const TxRing& low = q.rings[TX_LOW];
+      for (int i = 0; i < low.count; i++) joy[low.key[(low.head + i) % TX_QUEUE_SIZE]]++;
+      TEST_ASSERT_TRUE(joy[1] <= 1 && joy[2] <= 1);
+      TEST_ASSERT_EQUAL_UINT16(drops > 0xFFFF ? 0xFFFF : drops, q.dropped);
+    }
+
+    if (drops) dropRounds++;
+    uint8_t code;
+    int8_t value;
+    while (pop(&code, &value)) {
+      if (code == C_DELTA1) poppedDelta[1] += value;
+      if (code == C_DELTA2) poppedDelta[2] += value;
+    }
+    // nothing is lost unless a drop was counted
+    if (!deltaLost) {
+      checkedRounds++;
+      TEST_ASSERT_EQUAL_INT32(pushedDelta[1], poppedDelta[1]);
+      TEST_ASSERT_EQUAL_INT32(pushedDelta[2], poppedDelta[2]);
+    }
+  }
+  // the busy rounds overflow, the quiet ones don't: both kinds were run
+  TEST_ASSERT_TRUE(checkedRounds > 20 && dropRounds > 20);
+}
+
+static void test_benchmark() {
+  const uint32_t N = 10000000;
+  uint8_t code;
+  int8_t value;
+  volatile uint32_t sink = 0;
+  double t0 = benchSeconds();
+  for (uint32_t i = 0; i < N; i++) {
+    txPush(&q, C_TICK, TX_NORMAL, TX_NO_COALESCE);
+    if (txPeek(&q, &code, &value)) { sink += code; txPop(&q); }
+  }
+  benchReport("push + pop", N, "command", benchSeconds() - t0);
+
+  // worst case coalescing: a full ring scanned for the key every time
+  for (int i = 0; i < TX_QUEUE_SIZE - 1; i++) txPush(&q, C_JOY_UP, TX_LOW, 3 + i);
+  t0 = benchSeconds();
+  for (uint32_t i = 0; i < N; i++) txPush(&q, C_JOY_DOWN, TX_LOW, 1 + (i & 1));
+  benchReport("coalescing push, full ring", N, "command", benchSeconds() - t0);
+  (void)sink;
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_priority_order);
+  RUN_TEST(test_coalescing);
+  RUN_TEST(test_delta_past_int8);
+  RUN_TEST(test_overflow);
+  RUN_TEST(test_random_traffic);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,36 @@
+/**
+ * @file AssetSink.h
+ * @brief minimal write-only file interface uploads are streamed through
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The counterpart of AssetSource: a file is written front to back in pieces and only replaces anything once it is
+ * complete, so a dropped upload never leaves half a file behind. On the ESP32 it is LittleFSSink; a PC build can
+ * implement it over a plain directory.
+ *
+ */
+
+#ifndef ASSET_SINK_H
+#define ASSET_SINK_H
+
+#include <stdint.h>
+
+class AssetSink {
+public:
+  virtual ~AssetSink() {}
+
+  // start writing the file at path (nothing is visible there until finish())
+  virtual bool begin(const char* path) = 0;
+
+  // append len bytes, false on error (out of space)
+  virtual bool write(const uint8_t* src, uint32_t len) = 0;
+
+  // complete the file, replacing whatever was at path before
+  virtual bool finish() = 0;
+
+  // throw away what was written since begin()
+  virtual void abort() = 0;
+};
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ * @file AssetSource.h
+ * @brief minimal read-only file interface the asset store loads through
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The asset store only ever needs "how big is this file" and "read these bytes", so that is all a source has to
+ * provide. On the ESP32 it is LittleFSSource; a PC build can implement it over a plain directory.
+ *
+ */
+
+#ifndef ASSET_SOURCE_H
+#define ASSET_SOURCE_H
+
+#include <stdint.h>
+
+class AssetSource {
+public:
+  virtual ~AssetSource() {}
+
+  // size of the file in bytes, -1 if it does not exist
+  virtual int32_t fileSize(const char* path) = 0;
+
+  // read up to len bytes starting at offset, returns bytes read or -1 on error
+  virtual int32_t read(const char* path, uint32_t offset, uint8_t* dst, uint32_t len) = 0;
+};
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @file AssetStore.h
+ * @brief images, animations, palettes and fonts loaded from flash on demand
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Assets are listed in an index file on the filesystem, one per line:
+ *
+ *   # type   name      path
+ *   image    heart     /img/heart.anim
+ *   anim     pacman    /img/pacman.anim
+ *   palette  sunset    /pal/sunset.pal
+ *
+ * Nothing is read until an asset is first used. Loaded assets live in a small LRU cache with a hard byte budget.
+ * Images use the animation format (frame 0 is decoded to RGB565 once when loaded); animations, palettes and fonts are
+ * cached as the raw file bytes.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef ASSET_STORE_H
+#define ASSET_STORE_H
+
+#include "Assets/AssetSource.h"
+
+#define ASSET_INDEX_PATH "/assets.idx"
+#define ASSET_INDEX_MAX_BYTES 4096
+
+#define ASSET_MAX_ENTRIES 48
+#define ASSET_NAME_LEN 16
+#define ASSET_PATH_LEN 32
+
+// cache budget. an asset bigger than the whole budget is never loaded
+#define ASSET_CACHE_SLOTS 8
+#define ASSET_CACHE_BYTES (32 * 1024)
+
+// bytes read per assetsPoll() call while prefetching
+#define ASSET_PREFETCH_CHUNK 2048
+#define ASSET_PREFETCH_QUEUE 4
+
+enum AssetType : uint8_t { ASSET_IMAGE, ASSET_ANIMATION, ASSET_PALETTE, ASSET_FONT };
+
+struct Asset {
+  AssetType type;
+  uint16_t width;                 // images only
+  uint16_t height;
+  const uint8_t* data;            // image: width * height RGB565 pixels, otherwise the file contents
+  uint32_t size;                  // bytes at data
+};
+
+struct AssetStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t prefetched;
+  uint32_t evictions;
+  uint32_t bytesCached;
+};
+
+bool assetsBegin(AssetSource* source);
+int assetCount();
+const char* assetName(int index);
+AssetType assetType(int index);
+int assetFind(const char* name);
+int assetAdd(AssetType type, const char* name, const char* path);
+
+const Asset* assetGet(int index);
+bool assetCached(int index);
+void assetPrefetch(int index);
+void assetsPoll();
+AssetStats assetStats();
+
+#endif
@@ -0,0 +1,22 @@
+/**
+ * @file BuiltinAssets.h
+ * @brief the packed asset blob compiled into the firmware (Assets/PackedAssets.h)
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The generated header holds the blob as a static array, so only BuiltinAssets.cpp reads it: any other file that did
+ * would link in a second copy. Programs use the PACKED_* names from it and get the entries through here.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef BUILTIN_ASSETS_H
+#define BUILTIN_ASSETS_H
+
+#include "Assets/Unpack.h"
+#include "Assets/PackedAssets.h"
+
+bool builtinAsset(int index, PackInfo* info, PackEntry* entry);
+
+#endif
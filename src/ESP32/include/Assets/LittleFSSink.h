@@ -0,0 +1,32 @@
+/**
+ * @file LittleFSSink.h
+ * @brief asset sink writing to the LittleFS flash partition
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Files are written next to their final path with a ".tmp" suffix and renamed into place when finished.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef LITTLEFS_SINK_H
+#define LITTLEFS_SINK_H
+
+#include "Assets/AssetSink.h"
+#include <LittleFS.h>
+
+class LittleFSSink : public AssetSink {
+public:
+  bool begin(const char* path) override;
+  bool write(const uint8_t* src, uint32_t len) override;
+  bool finish() override;
+  void abort() override;
+
+private:
+  File file;
+  char path[32] = "";
+  char tmpPath[36] = "";
+};
+
+#endif
@@ -0,0 +1,33 @@
+/**
+ * @file LittleFSSource.h
+ * @brief asset source backed by the LittleFS flash partition
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Files come from the data/ folder, uploaded with "pio run -t uploadfs".
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef LITTLEFS_SOURCE_H
+#define LITTLEFS_SOURCE_H
+
+#include "Assets/AssetSource.h"
+#include <LittleFS.h>
+
+class LittleFSSource : public AssetSource {
+public:
+  bool begin();
+
+  int32_t fileSize(const char* path) override;
+  int32_t read(const char* path, uint32_t offset, uint8_t* dst, uint32_t len) override;
+
+private:
+  bool openFile(const char* path);
+
+  File file;
+  char openPath[32] = "";
+};
+
+#endif
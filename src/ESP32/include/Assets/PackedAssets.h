@@ -0,0 +1,79 @@
+// generated by tools/pack_assets.py from assets/packers.txt assets/iowa.txt assets/charmander.txt assets/r2d2.txt assets/lebron.txt assets/beer.txt assets/sketch_colors.txt, do not edit
+// 6 images, 3585 pixels, 1 palette, 887 bytes
+
+#ifndef PACKED_ASSETS_H
+#define PACKED_ASSETS_H
+
+#include <stdint.h>
+
+enum PackedAsset {
+  PACKED_PACKERS,
+  PACKED_IOWA,
+  PACKED_CHARMANDER,
+  PACKED_R2D2,
+  PACKED_LEBRON,
+  PACKED_BEER,
+  PACKED_SKETCH_COLORS,
+  PACKED_COUNT
+};
+
+static const uint8_t packed_assets[] = {
+  0x50, 0x4B, 0x01, 0x07, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE0, 0xFF, 0xE0, 0x07, 0xFF, 0xFF,
+  0x20, 0xFD, 0x00, 0xF8, 0x10, 0x84, 0x1F, 0x00, 0x01, 0x1C, 0x13, 0x00, 0x6C, 0x00, 0x00, 0x00,
+  0x65, 0x00, 0x00, 0x00, 0x01, 0x14, 0x14, 0x00, 0xD1, 0x00, 0x00, 0x00, 0x3C, 0x00, 0x00, 0x00,
+  0x01, 0x17, 0x14, 0x00, 0x0D, 0x01, 0x00, 0x00, 0x7D, 0x00, 0x00, 0x00, 0x01, 0x19, 0x1B, 0x00,
+  0x8A, 0x01, 0x00, 0x00, 0xBB, 0x00, 0x00, 0x00, 0x01, 0x2C, 0x17, 0x00, 0x45, 0x02, 0x00, 0x00,
+  0x69, 0x00, 0x00, 0x00, 0x01, 0x17, 0x16, 0x00, 0xAE, 0x02, 0x00, 0x00, 0x8B, 0x00, 0x00, 0x00,
+  0x02, 0x07, 0x00, 0x00, 0x39, 0x03, 0x00, 0x00, 0x3E, 0x00, 0x00, 0x00, 0x45, 0x00, 0x00, 0x08,
+  0x01, 0x00, 0x12, 0x14, 0x0A, 0x19, 0x08, 0x02, 0x00, 0x12, 0x04, 0x1D, 0x10, 0x19, 0x04, 0x03,
+  0x00, 0x0E, 0x1D, 0x10, 0x19, 0x18, 0x1D, 0x0A, 0x1A, 0x08, 0x00, 0x19, 0x18, 0x3B, 0x06, 0x75,
+  0x00, 0x1A, 0x0C, 0x71, 0x08, 0x1C, 0x10, 0x1A, 0x1A, 0x79, 0x0E, 0x00, 0x1B, 0x02, 0x1A, 0x1A,
+  0xAD, 0x10, 0x1B, 0x7E, 0xC7, 0x1A, 0x6F, 0x14, 0x1B, 0x1A, 0xF9, 0x00, 0x00, 0x0D, 0x0F, 0xA6,
+  0x14, 0x1B, 0x04, 0xFA, 0x22, 0xFB, 0x06, 0x17, 0x27, 0x33, 0x09, 0x4F, 0x21, 0x00, 0x4E, 0x0B,
+  0xA1, 0x0D, 0x85, 0x11, 0xA4, 0x13, 0xD9, 0x03, 0xBD, 0x13, 0xDC, 0x17, 0xF8, 0x13, 0x00, 0xF5,
+  0x0D, 0x05, 0x00, 0x00, 0xA2, 0x01, 0x00, 0x0A, 0x11, 0x1E, 0x15, 0x0E, 0x12, 0x14, 0x29, 0x06,
+  0x00, 0x36, 0x0C, 0x03, 0x06, 0x4B, 0x10, 0x54, 0x06, 0x5B, 0x04, 0x60, 0x0A, 0x20, 0x0A, 0x19,
+  0x08, 0x00, 0x38, 0x0C, 0x0D, 0x0C, 0x33, 0x0C, 0x1A, 0x10, 0x12, 0x16, 0xAB, 0x06, 0x54, 0x08,
+  0x3A, 0x0C, 0x00, 0x64, 0x0A, 0x26, 0x10, 0xC9, 0x10, 0x0C, 0x18, 0x3F, 0x9B, 0x45, 0x03, 0x00,
+  0x30, 0x00, 0x00, 0x00, 0x0C, 0x0E, 0x15, 0x0C, 0x04, 0x00, 0x00, 0xC6, 0x17, 0x0A, 0x00, 0x05,
+  0x21, 0x08, 0x15, 0x04, 0x17, 0x0C, 0x00, 0x05, 0xE0, 0x17, 0x08, 0x16, 0x26, 0x42, 0x02, 0x47,
+  0x04, 0x0D, 0x06, 0x05, 0x05, 0x04, 0x98, 0x46, 0x02, 0x58, 0x06, 0x16, 0x10, 0x04, 0x01, 0x16,
+  0x16, 0x75, 0x04, 0x00, 0x33, 0x05, 0x01, 0x16, 0x0E, 0x74, 0x10, 0x00, 0x01, 0xAC, 0x06, 0x17,
+  0x18, 0x09, 0x00, 0x92, 0x0C, 0x30, 0x0E, 0x00, 0xC3, 0x02, 0xCF, 0x0E, 0x72, 0x02, 0x8C, 0x04,
+  0x04, 0x15, 0x12, 0x50, 0x02, 0x01, 0xD4, 0x06, 0x16, 0x1C, 0x69, 0x00, 0x16, 0x04, 0x2C, 0x12,
+  0x00, 0x17, 0x04, 0xC0, 0x06, 0x42, 0x19, 0x16, 0x04, 0x15, 0x16, 0x76, 0x0A, 0x15, 0x1E, 0x67,
+  0x03, 0x00, 0x1A, 0x01, 0x8C, 0x27, 0xAB, 0x33, 0xC7, 0x03, 0xE5, 0x03, 0x00, 0x3E, 0x00, 0x00,
+  0x00, 0x16, 0x24, 0x06, 0x07, 0x07, 0x3D, 0x06, 0x1A, 0x1E, 0x00, 0x07, 0x06, 0x07, 0x04, 0x04,
+  0x34, 0x18, 0x10, 0x17, 0x00, 0x13, 0x00, 0x05, 0x06, 0x5F, 0x16, 0x06, 0x18, 0x00, 0x00, 0x00,
+  0x06, 0x00, 0x20, 0x67, 0x14, 0x5F, 0x04, 0x00, 0x0A, 0x81, 0x12, 0x30, 0x02, 0x06, 0x65, 0x00,
+  0x7E, 0x02, 0x08, 0x18, 0x18, 0x91, 0x00, 0x7E, 0x00, 0x05, 0x18, 0x1C, 0x00, 0x14, 0xD8, 0x2A,
+  0xE7, 0x0C, 0x14, 0xEE, 0x00, 0x94, 0x02, 0x03, 0x95, 0x02, 0x03, 0x96, 0x06, 0x01, 0x07, 0x18,
+  0x04, 0x03, 0x03, 0x06, 0x34, 0x07, 0x08, 0x00, 0x18, 0x1C, 0x31, 0x06, 0x18, 0x12, 0x3D, 0x01,
+  0x00, 0x31, 0x14, 0x64, 0x10, 0x31, 0x06, 0x15, 0x01, 0x4A, 0x06, 0x64, 0x0B, 0x18, 0x3A, 0x7C,
+  0x0E, 0x00, 0x31, 0x12, 0xAE, 0x14, 0x4A, 0x10, 0xA7, 0x02, 0xA6, 0x01, 0x95, 0x02, 0x0E, 0x06,
+  0xEA, 0x0E, 0x00, 0xE0, 0x00, 0xC3, 0x01, 0x18, 0x04, 0xF9, 0x0E, 0x83, 0x03, 0xC7, 0x0C, 0xED,
+  0x02, 0xF9, 0x0A, 0x00, 0xBA, 0x04, 0x48, 0x0F, 0x18, 0x08, 0xFE, 0x03, 0x03, 0x06, 0x2F, 0x01,
+  0x0C, 0x0E, 0x18, 0x0C, 0x00, 0x50, 0x00, 0x29, 0x03, 0x41, 0x09, 0x2D, 0x04, 0x82, 0x07, 0x8C,
+  0x0F, 0x93, 0x15, 0x07, 0x20, 0x39, 0x03, 0x00, 0xFE, 0x82, 0x24, 0x00, 0x00, 0x00, 0x26, 0x46,
+  0x2A, 0x04, 0x00, 0x2C, 0x04, 0x31, 0x26, 0x1D, 0x04, 0x4B, 0x04, 0x09, 0x06, 0x05, 0x0A, 0x1B,
+  0x16, 0x2B, 0x72, 0x00, 0x73, 0x32, 0x83, 0x26, 0x8A, 0x0A, 0x83, 0x2E, 0xD6, 0x0A, 0x2B, 0x0E,
+  0x11, 0x10, 0x2B, 0x1A, 0x00, 0xD3, 0x0E, 0x10, 0x1A, 0x2B, 0x68, 0xA7, 0x53, 0x64, 0x0F, 0x88,
+  0x0B, 0x0C, 0x12, 0x60, 0x15, 0x00, 0x2B, 0x08, 0x35, 0x04, 0x05, 0x06, 0x0C, 0x16, 0x4C, 0x08,
+  0x2B, 0x18, 0x16, 0x0C, 0x2B, 0x3A, 0x00, 0x35, 0x07, 0xF1, 0x05, 0x64, 0x0A, 0xFA, 0x09, 0x57,
+  0x30, 0x83, 0x46, 0xAF, 0x40, 0xF4, 0x1E, 0x00, 0xEA, 0x09, 0xDB, 0x1E, 0x09, 0xFA, 0xB5, 0x03,
+  0x00, 0x30, 0x00, 0x00, 0x06, 0x03, 0x00, 0x15, 0x16, 0x03, 0x03, 0x03, 0x06, 0x07, 0x06, 0x17,
+  0x12, 0x23, 0x08, 0x19, 0x02, 0x16, 0x16, 0x2B, 0x00, 0x60, 0x2E, 0x00, 0x45, 0x00, 0x03, 0x04,
+  0x2D, 0x10, 0x5D, 0x02, 0x01, 0x01, 0x18, 0x04, 0xE6, 0x70, 0x0C, 0x06, 0x03, 0x12, 0x00, 0x01,
+  0x02, 0x00, 0x06, 0x06, 0x8C, 0x0B, 0x00, 0x88, 0x0E, 0x01, 0x04, 0x16, 0x08, 0x22, 0x02, 0x9F,
+  0x0C, 0x01, 0x21, 0x04, 0x16, 0x08, 0xA3, 0x02, 0x16, 0x10, 0x43, 0x06, 0x04, 0x5A, 0x04, 0x16,
+  0x48, 0xC3, 0x04, 0x04, 0x44, 0x24, 0x16, 0x00, 0x95, 0x04, 0x5B, 0x20, 0x06, 0x06, 0x00, 0xCF,
+  0x10, 0x9E, 0x06, 0xB7, 0x04, 0x2D, 0x11, 0x16, 0x0E, 0xFB, 0x10, 0x38, 0x03, 0x2E, 0x08, 0x00,
+  0x58, 0x15, 0x2A, 0x01, 0x70, 0x09, 0x42, 0x12, 0x42, 0x05, 0x6F, 0x05, 0x0F, 0x11, 0x9E, 0x0B,
+  0x00, 0x06, 0x12, 0xB6, 0x19, 0xD7, 0x33, 0xF3, 0x07, 0xFF, 0x00, 0xF8, 0x52, 0x65, 0x64, 0x00,
+  0xE0, 0x07, 0xFF, 0x47, 0x72, 0x65, 0x65, 0x6E, 0x00, 0xE0, 0xFF, 0xFF, 0x59, 0x65, 0x6C, 0x6C,
+  0x6F, 0x77, 0x00, 0x20, 0xFF, 0xFD, 0x4F, 0x72, 0x61, 0x6E, 0x67, 0x65, 0x00, 0xFF, 0x1F, 0x00,
+  0x42, 0x6C, 0x75, 0x65, 0x00, 0x10, 0xFF, 0x80, 0x50, 0x75, 0x72, 0x70, 0x6C, 0x65, 0x00, 0x7F,
+  0x56, 0xFB, 0x50, 0x69, 0x6E, 0x6B, 0x00,
+};
+
+#endif
@@ -0,0 +1,82 @@
+/**
+ * @file Unpack.h
+ * @brief streaming decoder for the packed asset blob (built by tools/pack_assets.py)
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Blob format (all multi byte values little endian):
+ *
+ *   header   'P' 'K' version(1) count paletteCount(0 = 256) 3 reserved bytes
+ *   palette  paletteCount x RGB565 (u16), shared by every image
+ *   entries  count x { type width height reserved(u8 each) offset(u32, from the blob start) size(u32) }
+ *   streams  one LZSS stream per entry
+ *            PACK_IMAGE: width * height palette indices, row by row
+ *            PACK_PALETTE: width colors, each an RGB565 (u16) followed by its NUL terminated name
+ *
+ *   stream   groups of one flag byte and up to 8 items, bit 0 first
+ *            flag bit 1: literal byte
+ *            flag bit 0: match u16: bits 0-8 distance - 1, bits 9-15 length - 3
+ *
+ * The blob stays in flash. An UnpackStream decodes one entry in pieces of any size through a UNPACK_WINDOW byte ring
+ * of the most recent output, so the whole working state is a little over 512 bytes and nothing is ever unpacked in full.
+ *
+ * No Arduino dependencies, the decoder can be round trip checked on a computer.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef UNPACK_H
+#define UNPACK_H
+
+#include <stdint.h>
+
+#define PACK_VERSION 1
+#define PACK_HEADER_SIZE 8
+#define PACK_ENTRY_SIZE 12
+#define UNPACK_WINDOW 512               // matches reach at most this far back (power of two)
+
+enum PackType {
+  PACK_IMAGE = 1,
+  PACK_PALETTE = 2
+};
+
+struct PackInfo {
+  const uint8_t* blob;
+  uint32_t size;
+  uint8_t count;
+  uint16_t paletteCount;
+  const uint8_t* palette;               // raw little endian RGB565 entries
+};
+
+struct PackEntry {
+  uint8_t type;
+  uint8_t width;
+  uint8_t height;
+  const uint8_t* data;                  // compressed stream
+  uint32_t size;
+};
+
+struct UnpackStream {
+  const uint8_t* src;
+  uint32_t pos;
+  uint32_t size;
+  uint8_t flags;                        // flag byte of the current group, shifted as items are read
+  uint8_t items;                        // items left in the current group
+  uint16_t matchLeft;                   // bytes of the current match still to copy
+  uint16_t matchDistance;
+  uint16_t head;                        // next slot in window
+  uint32_t produced;                    // bytes output so far
+  bool failed;                          // stream ended inside an item or a match reached before the start
+  uint8_t window[UNPACK_WINDOW];
+};
+
+bool packOpen(const uint8_t* blob, uint32_t size, PackInfo* info);
+bool packEntry(const PackInfo& info, int index, PackEntry* entry);
+uint16_t packColor(const PackInfo& info, uint8_t index);
+
+void unpackBegin(UnpackStream* s, const uint8_t* data, uint32_t size);
+uint32_t unpackRead(UnpackStream* s, uint8_t* dst, uint32_t n);
+int unpackPalette(const PackEntry& entry, uint16_t* colors, const char** names, int maxColors, char* text, int textSize);
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file CellAutomata.h
+ * @brief bit-packed 64x64 cellular automata (Life, Brian's Brain, 3 state Generations rules)
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * A row is stepped as one uint64_t per state (bit x = column x), a whole row at once by counting neighbours with bitwise
+ * adders. In memory a cell has 3 states and 5 cells share a byte (3^5 = 243), so a row is 13 bytes and the grid 832,
+ * the same for every rule and nothing allocated. A row is unpacked to its bitboards when it is stepped and packed again
+ * after.
+ * No Arduino or display dependencies so the kernel also builds on a PC.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef CELL_AUTOMATA_H
+#define CELL_AUTOMATA_H
+
+#include <stdint.h>
+
+#define AUTOMATA_SIZE 64
+
+/**
+ * @brief "Generations" style rule: B/S neighbour sets plus a number of states
+ *
+ * bit n of birth/survive set means "n live neighbours". states = 2 is a plain life-like rule, with 3 states a live cell
+ * that does not survive spends one generation dying (state 2) before it is dead, and only state 1 counts as a
+ * neighbour. Rules with more states don't fit the grid (4 states would need 1 KB).
+ */
+struct AutomataRule {
+  const char* name;
+  uint16_t birth;
+  uint16_t survive;
+  uint8_t states;
+};
+
+extern const AutomataRule AUTOMATA_LIFE;            // B3/S23
+extern const AutomataRule AUTOMATA_BRIANS_BRAIN;    // B2/S/3 states
+
+#define AUTOMATA_ROW_BYTES ((AUTOMATA_SIZE + 4) / 5)
+
+// a grid starts out zeroed (all dead)
+struct AutomataGrid {
+  uint8_t rows[AUTOMATA_SIZE][AUTOMATA_ROW_BYTES];  // base 3, cell x is digit x % 5 of byte x / 5. 832 bytes
+};
+
+// called once per row that changed during a step, after that row holds its new state
+typedef void (*AutomataRowCallback)(uint8_t row, uint64_t changed, const AutomataGrid* grid, void* ctx);
+
+void automataClear(AutomataGrid* grid);
+void automataSeed(AutomataGrid* grid, uint32_t* rng);
+uint8_t automataCell(const AutomataGrid* grid, uint8_t x, uint8_t y);
+void automataSetCell(AutomataGrid* grid, uint8_t x, uint8_t y, uint8_t state);
+uint64_t automataRow(const AutomataGrid* grid, uint8_t y);
+uint32_t automataStep(AutomataGrid* grid, const AutomataRule& rule, AutomataRowCallback onRow, void* ctx);
+uint32_t automataPopulation(const AutomataGrid* grid);
+
+#endif
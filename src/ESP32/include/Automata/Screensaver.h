@@ -0,0 +1,24 @@
+/**
+ * @file Screensaver.h
+ * @brief definitions for the cellular automata screensaver
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Runs Life and Brian's Brain in turn on the home screen after it has been left alone for a while.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef SCREENSAVER_H
+#define SCREENSAVER_H
+
+#include "Display/VirtualCanvas.h"
+
+// home screen idle time before the screensaver starts
+#define SCREENSAVER_IDLE_MS 60000UL
+
+void initScreensaver(VirtualCanvas* disp, unsigned long now);
+void updateScreensaver(unsigned long now);
+
+#endif
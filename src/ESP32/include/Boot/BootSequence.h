@@ -0,0 +1,64 @@
+/**
+ * @file BootSequence.h
+ * @brief staged start up: a table of init steps with dependencies, run one per pass of loop()
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * setup() only brings up what the splash needs and shows it. Everything else (flash filesystem, asset index, input
+ * config, Wi-Fi, ...) is a BootStage in a table, each listing the stages that have to run before it. bootStep() runs
+ * the first stage in table order whose dependencies are done, so the order is fixed by the table alone, and loop()
+ * keeps reading the link and flushing the panel between stages. A screen is usable as soon as bootReady() says the
+ * stages it depends on are done, while the rest carry on behind it.
+ *
+ * Every stage records when it finished and how long it took (bootMarker() formats the "boot ..." line main.cpp prints
+ * on the USB serial port), so a slower start up shows up in the log.
+ *
+ * No Arduino dependencies (the clock is passed in), the staging order can be checked on a computer.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef BOOT_SEQUENCE_H
+#define BOOT_SEQUENCE_H
+
+#include <stdint.h>
+
+#define BOOT_MAX_STAGES 16
+#define BOOT_MARKER_LEN 64              // the longest name with both times at 2^32 us and " failed" is 52
+
+// bit of stage i in BootStage::needs and bootReady()
+#define BOOT_STAGE(i) ((uint16_t)1 << (i))
+
+// run one stage, false if it failed (the stages after it still run, they check what they need themselves)
+typedef bool (*BootStageFn)();
+
+// microseconds, wrapping
+typedef uint32_t (*BootClock)();
+
+struct BootStage {
+  const char* name;
+  BootStageFn run;
+  uint16_t needs;                       // BOOT_STAGE() bits of the stages that have to run first
+};
+
+struct BootSequence {
+  const BootStage* stages;
+  uint8_t count;
+  uint16_t done;                        // bit per stage that has run
+  uint16_t failed;                      // bit per stage that returned false
+  BootClock clock;
+  uint32_t finishedUs[BOOT_MAX_STAGES]; // clock() when the stage returned
+  uint32_t tookUs[BOOT_MAX_STAGES];
+};
+
+bool bootBegin(BootSequence* b, const BootStage* stages, uint8_t count, BootClock clock);
+int bootNext(const BootSequence* b);
+int bootStep(BootSequence* b);
+bool bootReady(const BootSequence* b, uint16_t stages);
+bool bootFinished(const BootSequence* b);
+int bootDoneCount(const BootSequence* b);
+int bootPlan(const BootStage* stages, uint8_t count, uint8_t* order);
+void bootMarker(const BootSequence* b, int stage, char* dst, int len);
+
+#endif
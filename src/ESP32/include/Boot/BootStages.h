@@ -0,0 +1,45 @@
+/**
+ * @file BootStages.h
+ * @brief the console's boot stage table (see BootSequence.h)
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The stage functions live in main.cpp, only the table and its ids are here, so the order the console starts up in can
+ * be checked on a computer with stand in stages (test/test_boot).
+ *
+ */
+
+#ifndef BOOT_STAGES_H
+#define BOOT_STAGES_H
+
+#include "Boot/BootSequence.h"
+
+// setup() only runs BOOT_DISPLAY, loop() the rest
+enum BootStageId {
+  BOOT_DISPLAY, BOOT_TRANSITIONS, BOOT_STORAGE, BOOT_INPUT, BOOT_COLORS, BOOT_HOME, BOOT_ASSETS, BOOT_WEB, BOOT_STAGE_COUNT
+};
+
+bool bootDisplay();
+bool bootTransitions();
+bool bootStorage();
+bool bootInputConfig();
+bool bootColors();
+bool bootHome();
+bool bootAssets();
+bool bootWeb();
+
+// in the order they run. the home screen only waits for what the programs on its menu need when they are opened (the
+// slideshow picks up the flash slides whenever the index is in), Wi-Fi comes last since uploads go into the index
+static const BootStage bootStages[BOOT_STAGE_COUNT] = {
+  { "display",     bootDisplay,     0 },
+  { "transitions", bootTransitions, BOOT_STAGE(BOOT_DISPLAY) },     // after the canvas so the DMA buffers go first
+  { "storage",     bootStorage,     0 },
+  { "input",       bootInputConfig, BOOT_STAGE(BOOT_STORAGE) },
+  { "colors",      bootColors,      BOOT_STAGE(BOOT_DISPLAY) },
+  { "home",        bootHome,        BOOT_STAGE(BOOT_TRANSITIONS) | BOOT_STAGE(BOOT_INPUT) | BOOT_STAGE(BOOT_COLORS) },
+  { "assets",      bootAssets,      BOOT_STAGE(BOOT_STORAGE) },
+  { "web",         bootWeb,         BOOT_STAGE(BOOT_DISPLAY) | BOOT_STAGE(BOOT_ASSETS) },
+};
+
+#endif
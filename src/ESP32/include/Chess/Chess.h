@@ -0,0 +1,27 @@
+/**
+ * @file Chess.h
+ * @brief definitions for the Chess program
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Program driver for Chess: player (white) against the engine (black). The board fills the 64x64 panel with 8x8 pixel
+ * squares, the engine searches on the other core so the cursor stays responsive while it thinks.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef CHESS_H
+#define CHESS_H
+
+#include "Display/VirtualCanvas.h"
+#include "Input/InputMap.h"
+#include <Arduino.h>
+
+void initChess(VirtualCanvas* disp);
+void handleChessCommand(const String& cmd, unsigned long now);
+void updateChess(unsigned long now);
+void exitChess();
+InputProfile* chessInputProfile();
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file ChessEngine.h
+ * @brief 0x88 chess move generator and alpha-beta search
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Pure engine: no Arduino, no display, no allocation. All memory is fixed at compile time (transposition table, move
+ * stack, game history) so it fits next to the panel DMA buffers in the ESP32's SRAM, and the same file builds on a PC
+ * for perft / nodes-per-second runs.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef CHESS_ENGINE_H
+#define CHESS_ENGINE_H
+
+#include <stdint.h>
+
+// pieces. white is positive, black is negative
+#define CHESS_EMPTY  0
+#define CHESS_PAWN   1
+#define CHESS_KNIGHT 2
+#define CHESS_BISHOP 3
+#define CHESS_ROOK   4
+#define CHESS_QUEEN  5
+#define CHESS_KING   6
+
+#define CHESS_WHITE  1
+#define CHESS_BLACK -1
+
+// 0x88 squares: rank * 16 + file, rank 0 is white's back rank
+#define CHESS_SQ(file, rank) ((uint8_t)(((rank) << 4) | (file)))
+#define CHESS_FILE(sq) ((sq) & 7)
+#define CHESS_RANK(sq) ((sq) >> 4)
+#define CHESS_NO_SQUARE 0x88
+
+// fixed memory budget
+#define CHESS_MAX_HISTORY 384               // plies of game + search that can be undone
+#define CHESS_MAX_PLY 32                    // deepest search ply (including quiescence)
+#define CHESS_MOVE_STACK 2048               // moves shared by all plies of the search
+#define CHESS_TT_ENTRIES 2048               // transposition table entries (12 bytes each, power of two)
+
+// the search checks its clock and calls ChessSearchLimits::yield every this many nodes (power of two)
+#ifndef CHESS_CHECK_NODES
+#define CHESS_CHECK_NODES 1024
+#endif
+
+// move flags
+#define CHESS_MOVE_CAPTURE 0x01
+#define CHESS_MOVE_EP      0x02
+#define CHESS_MOVE_CASTLE  0x04
+#define CHESS_MOVE_DOUBLE  0x08
+
+struct ChessMove {
+  uint8_t from;
+  uint8_t to;
+  int8_t promo;             // piece type promoted to (unsigned), 0 if none
+  uint8_t flags;
+};
+
+struct ChessUndo {
+  ChessMove move;
+  int8_t captured;
+  uint8_t castling;
+  uint8_t ep;
+  uint8_t halfmove;
+  uint64_t hash;
+};
+
+struct ChessPosition {
+  int8_t board[128];
+  int8_t side;              // CHESS_WHITE or CHESS_BLACK to move
+  uint8_t castling;         // bit0 white king side, bit1 white queen side, bit2 black king side, bit3 black queen side
+  uint8_t ep;               // en passant target square or CHESS_NO_SQUARE
+  uint8_t halfmove;         // for the 50 move rule
+  uint8_t kingSq[2];        // [0] white, [1] black
+  uint64_t hash;
+  uint16_t ply;             // entries used in history
+  ChessUndo history[CHESS_MAX_HISTORY];
+};
+
+enum ChessStatus { CHESS_ONGOING, CHESS_CHECKMATE, CHESS_STALEMATE, CHESS_DRAW };
+
+struct ChessSearchLimits {
+  uint8_t maxDepth;
+  uint32_t maxTimeMs;                 // 0 = no time limit
+  uint32_t (*clockMs)();              // time source (millis on the ESP32), required when maxTimeMs is set
+  void (*yield)();                    // called every CHESS_CHECK_NODES nodes to let other tasks run, may be null
+};
+
+struct ChessSearchInfo {
+  uint8_t depth;                      // deepest completed iteration
+  int16_t score;                      // centipawns from the side to move
+  uint32_t nodes;
+  uint32_t elapsedMs;
+};
+
+void chessInitPosition(ChessPosition* pos);
+bool chessSetFEN(ChessPosition* pos, const char* fen);
+int chessGenerateLegal(ChessPosition* pos, ChessMove* out);
+bool chessMakeMove(ChessPosition* pos, const ChessMove& move);
+void chessUndoMove(ChessPosition* pos);
+bool chessInCheck(const ChessPosition* pos);
+ChessStatus chessGetStatus(ChessPosition* pos);
+
+ChessMove chessSearch(ChessPosition* pos, const ChessSearchLimits& limits, ChessSearchInfo* info);
+void chessStopSearch();
+uint64_t chessPerft(ChessPosition* pos, int depth);
+
+#endif
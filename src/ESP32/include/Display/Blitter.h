@@ -0,0 +1,32 @@
+/**
+ * @file Blitter.h
+ * @brief word-at-a-time RGB565 kernels for fills, scaled blits and alpha blending
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * All kernels work on raw RGB565 buffers (pointer to the top left pixel + stride in pixels) so they can be used on the
+ * canvas framebuffer or on any off-screen buffer. Destination rectangles must already be clipped.
+ * Build with -DBLITTER_REFERENCE to force the plain per-pixel path (useful when checking the word kernels).
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef BLITTER_H
+#define BLITTER_H
+
+#include <stdint.h>
+
+// alpha is 0..32: 0 keeps dst, 32 is fully src
+#define BLEND_ALPHA_MAX 32
+
+uint16_t blend565(uint16_t src, uint16_t dst, uint8_t alpha);
+
+void blitFill(uint16_t* dst, int dstStride, int w, int h, uint16_t color);
+void blitFillPattern(uint16_t* dst, int dstStride, int w, int h, const uint16_t* pattern, int patternSize, int phaseX, int phaseY);
+void blitCopy(uint16_t* dst, int dstStride, const uint16_t* src, int srcStride, int w, int h);
+void blitCopyKeyed(uint16_t* dst, int dstStride, const uint16_t* src, int srcStride, int w, int h, uint16_t key);
+void blitScaled(uint16_t* dst, int dstStride, const uint16_t* src, int srcStride, int srcW, int srcH, int scale);
+void blitBlend(uint16_t* dst, int dstStride, const uint16_t* src, int srcStride, int w, int h, uint8_t alpha);
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file Overlay.h
+ * @brief transparent layer drawn over the canvas (cursors, HUDs, toasts)
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * An overlay is a second framebuffer with a coverage bit per pixel. Only covered pixels show, everything else lets the
+ * canvas through. Overlays attached to the canvas (VirtualCanvas::attachLayer) are composited on top of it while damaged
+ * tiles are pushed out, so the canvas itself is never touched: a blinking cursor can come and go at frame rate over a
+ * drawing without erasing it, and the drawing never has to be redrawn to get rid of the cursor.
+ *
+ * Drawing into an overlay marks the tiles it changed as damaged on its canvas, same as drawing into the canvas.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include "Display/VirtualCanvas.h"
+#include <Arduino.h>
+
+class OverlayLayer : public Adafruit_GFX {
+public:
+  explicit OverlayLayer(VirtualCanvas* canvas);
+  ~OverlayLayer();
+
+  bool begin();
+  bool ready() const { return buffer != nullptr; }
+
+  // Adafruit GFX overrides. drawing covers the pixels
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+
+  // uncover (show the canvas again)
+  void clear();
+  void clear(int16_t x, int16_t y, int16_t w, int16_t h);
+
+  bool isTileUsed(int tx, int ty) const { return (tileUsed[ty] >> tx) & 1; }
+  void composeRow(uint16_t* dst, int16_t x, int16_t y, int w) const;
+
+private:
+  bool clip(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const;
+  void updateTiles(int16_t x, int16_t y, int16_t w, int16_t h);
+
+  VirtualCanvas* canvas;
+  uint16_t* buffer;
+  uint8_t* coverage;                    // bit per pixel, row major: one byte is one tile row (8 pixels)
+  uint32_t tileUsed[CANVAS_TILES_Y];    // bit tx of row ty set -> some pixel of the tile is covered
+};
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * @file Scaler.h
+ * @brief fit an image of any size into a target area: integer magnification or area-average reduction
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * scaleFit() works out the placement once: an image that fits is magnified by the largest integer factor that still
+ * fits (pixel art stays crisp), a bigger one is reduced to fit with its aspect ratio kept, every output pixel being the
+ * exact area weighted average of the source pixels it covers. The source span and edge weights of every output row and
+ * column are precomputed into the ScaleMap, so rendering is just sums (or, when magnifying, blitScaled()).
+ *
+ * The source is read one row at a time through a callback, so images that are not RGB565 in memory (the built in
+ * character art, for example) can be converted row by row without a full size copy.
+ *
+ * No Arduino dependencies, the output can be compared against a reference scaler on a computer.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef SCALER_H
+#define SCALER_H
+
+#include <stdint.h>
+
+// largest target (and reduced output) side. override with -D for bigger panel walls
+#ifndef SCALER_MAX_SIZE
+#define SCALER_MAX_SIZE 128
+#endif
+
+// widest source row the scaler reads (only matters to callers that convert rows into a line buffer)
+#define SCALER_MAX_SOURCE 256
+
+// source span of one output row / column, weights in 1/dst units of a source pixel (see Scaler.cpp)
+struct ScaleSpan {
+  uint16_t first;
+  uint16_t last;
+  uint16_t firstWeight;
+  uint16_t lastWeight;
+};
+
+struct ScaleMap {
+  int16_t srcW, srcH;
+  int16_t dstW, dstH;                   // size of the output
+  int16_t x, y;                         // where the output goes in the target area (centered)
+  uint8_t scale;                        // integer magnification, 0 when reducing
+  ScaleSpan cols[SCALER_MAX_SIZE];      // reducing only
+  ScaleSpan rows[SCALER_MAX_SIZE];
+};
+
+// row y of the source (srcW pixels). the pointer only has to stay valid until the next call
+typedef const uint16_t* (*ScaleRowFn)(void* ctx, int y);
+
+bool scaleFit(ScaleMap* m, int srcW, int srcH, int areaW, int areaH);
+void scaleRender(const ScaleMap* m, ScaleRowFn row, void* ctx, uint16_t* area, int areaStride);
+void scaleRenderBuffer(const ScaleMap* m, const uint16_t* src, int srcStride, uint16_t* area, int areaStride);
+
+#endif
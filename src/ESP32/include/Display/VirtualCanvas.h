@@ -0,0 +1,114 @@
+/**
+ * @file VirtualCanvas.h
+ * @brief logical drawing surface spanning one or more chained HUB75 panels
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Programs draw into the canvas in logical coordinates (0,0 is the top left of the whole wall of panels). The canvas keeps
+ * a framebuffer plus a dirty bit per tile, and flush() pushes only the damaged tiles out to the physical panel chain.
+ * Overlay layers (Display/Overlay.h) can be attached on top; they are composited into the damaged tiles on the way out.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef VIRTUAL_CANVAS_H
+#define VIRTUAL_CANVAS_H
+
+#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include <Arduino.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ------------------------------------------ Panel Configuration ------------------------------------------ //
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// size of a single panel
+#define PANEL_WIDTH 64
+#define PANEL_HEIGHT 64
+
+// how the panels are tiled into the logical canvas. override with -D in platformio.ini (ex: -DPANEL_TILE_COLS=2)
+#ifndef PANEL_TILE_COLS
+#define PANEL_TILE_COLS 1
+#endif
+#ifndef PANEL_TILE_ROWS
+#define PANEL_TILE_ROWS 1
+#endif
+#define PANELS_NUMBER (PANEL_TILE_COLS * PANEL_TILE_ROWS)
+
+// wiring order and mounting of the panels (see enums below)
+#ifndef PANEL_CHAIN_LAYOUT
+#define PANEL_CHAIN_LAYOUT CHAIN_ROWS
+#endif
+#ifndef PANEL_ROTATION
+#define PANEL_ROTATION ROTATE_0
+#endif
+
+// logical canvas size
+#define CANVAS_WIDTH  (PANEL_WIDTH * PANEL_TILE_COLS)
+#define CANVAS_HEIGHT (PANEL_HEIGHT * PANEL_TILE_ROWS)
+
+// damage tracking granularity. 8 matches the height of one line of text
+#define CANVAS_TILE_SIZE 8
+#define CANVAS_TILES_X (CANVAS_WIDTH / CANVAS_TILE_SIZE)
+#define CANVAS_TILES_Y (CANVAS_HEIGHT / CANVAS_TILE_SIZE)
+
+// overlays that can be attached at once
+#define CANVAS_MAX_LAYERS 3
+
+class OverlayLayer;
+
+/**
+ * @brief order in which the panels are wired along the chain
+ *
+ * CHAIN_ROWS:       every row of panels runs left to right
+ * CHAIN_SERPENTINE: odd rows run right to left and are mounted upside down (shortest ribbon cables)
+ */
+enum PanelChainLayout { CHAIN_ROWS, CHAIN_SERPENTINE };
+
+/**
+ * @brief how each panel is physically mounted (clockwise). 90/270 require square panels
+ */
+enum PanelRotation { ROTATE_0 = 0, ROTATE_90 = 1, ROTATE_180 = 2, ROTATE_270 = 3 };
+
+class VirtualCanvas : public Adafruit_GFX {
+public:
+  VirtualCanvas(MatrixPanel_I2S_DMA* panel, PanelChainLayout layout = CHAIN_ROWS, PanelRotation rotation = ROTATE_0);
+  ~VirtualCanvas();
+
+  bool begin();
+  void flush();
+
+  // Adafruit GFX overrides. all of these only touch the framebuffer and mark damage
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+
+  // blitter backed helpers
+  void drawScaled(const uint16_t* src, int srcW, int srcH, int scale, int16_t x, int16_t y);
+
+  uint16_t getPixel(int16_t x, int16_t y) const;
+  uint16_t* getBuffer() { return buffer; }
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+  bool isTileDirty(int tx, int ty) const;
+  void mapToPhysical(int16_t x, int16_t y, int16_t* px, int16_t* py) const;
+
+  // overlays, composited in the order attached (last on top)
+  bool attachLayer(OverlayLayer* layer);
+  void detachLayer(OverlayLayer* layer);
+
+  static uint16_t color565(uint8_t r, uint8_t g, uint8_t b) { return MatrixPanel_I2S_DMA::color565(r, g, b); }
+
+private:
+  void pushTile(int tx, int ty);
+
+  MatrixPanel_I2S_DMA* panel;
+  PanelChainLayout layout;
+  PanelRotation rotation;
+  uint16_t* buffer;
+  uint32_t tileDirty[CANVAS_TILES_Y];     // bit tx of row ty set -> tile needs pushing
+  OverlayLayer* layers[CANVAS_MAX_LAYERS];
+  int layerCount;
+};
+
+#endif
@@ -0,0 +1,31 @@
+/**
+ * @file Generators.h
+ * @brief plasma and fire generators that render straight into an RGB565 buffer
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Integer only (the sine table is built with integer math too), so the same inputs give the same pixels on the ESP32
+ * and on a PC. No Arduino or display dependencies.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include <stdint.h>
+
+#define PLASMA_PALETTE_SIZE 256
+#define FIRE_LEVELS 64
+
+int8_t fxSin(uint8_t angle);
+
+void plasmaPalette(uint16_t* palette);
+void plasmaRender(uint16_t* dst, int dstStride, int w, int h, uint16_t t, const uint16_t* palette);
+
+void firePalette(uint16_t* palette);
+void fireStep(uint8_t* heat, int w, int h, uint32_t* rng, uint8_t cooling, bool burning);
+void fireRender(uint16_t* dst, int dstStride, const uint8_t* heat, int w, int h, const uint16_t* palette);
+
+#endif
@@ -0,0 +1,22 @@
+/**
+ * @file HomeEffects.h
+ * @brief animated background for the home screen
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * A fire along the bottom edge throwing sparks, and a plasma colored navbar border. Drawn around the menu without
+ * touching it.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef HOME_EFFECTS_H
+#define HOME_EFFECTS_H
+
+#include "Display/VirtualCanvas.h"
+
+void homeEffectsReset(VirtualCanvas* disp, int16_t navbarY, unsigned long now);
+void homeEffectsUpdate(unsigned long now);
+
+#endif
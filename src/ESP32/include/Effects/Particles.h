@@ -0,0 +1,46 @@
+/**
+ * @file Particles.h
+ * @brief fixed-point particle pool
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Positions and velocities are Q8.8 (1/256 pixel), all integer math, and the pool is a fixed array so spawning never
+ * allocates. No Arduino or display dependencies.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <stdint.h>
+
+#define MAX_PARTICLES 96
+
+// Q8.8 helpers
+#define FX_ONE 256
+#define FX(px) ((int32_t)((px) * FX_ONE))
+#define FX_PX(v) ((v) >> 8)
+
+struct Particle {
+  int32_t x, y;             // Q8.8 pixels (32 bit so chained canvases wider than 127 px fit)
+  int16_t vx, vy;           // Q8.8 pixels per step
+  uint8_t life;             // steps left, 0 = free slot
+  uint8_t maxLife;
+};
+
+struct ParticlePool {
+  Particle particles[MAX_PARTICLES];
+  int16_t gravity;          // Q8.8 added to vy every step
+  uint8_t active;
+  uint32_t rng;
+};
+
+void particlesInit(ParticlePool* pool, int16_t gravity, uint32_t seed);
+bool particlesSpawn(ParticlePool* pool, int32_t x, int32_t y, int16_t vx, int16_t vy, uint8_t life);
+bool particlesSpawnSpread(ParticlePool* pool, int32_t x, int32_t y, int16_t vy, int16_t spread, uint8_t life);
+void particlesStep(ParticlePool* pool, int16_t minX, int16_t minY, int16_t maxX, int16_t maxY);
+uint32_t particlesRandom(ParticlePool* pool);
+
+#endif
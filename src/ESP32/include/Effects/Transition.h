@@ -0,0 +1,42 @@
+/**
+ * @file Transition.h
+ * @brief animated transitions (wipe, dissolve, slide) between screens
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Usage from a screen change:
+ *   transitionCapture(canvas);      // before drawing the new screen
+ *   ...draw the new screen...
+ *   transitionStart(canvas, TRANSITION_WIPE, millis());
+ * then call transitionUpdate() from loop() until transitionActive() is false.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef TRANSITION_H
+#define TRANSITION_H
+
+#include "Display/VirtualCanvas.h"
+
+// length of every transition
+#define TRANSITION_MS 250
+
+// progress is 0..TRANSITION_FULL
+#define TRANSITION_FULL 256
+
+enum TransitionType { TRANSITION_WIPE, TRANSITION_DISSOLVE, TRANSITION_SLIDE };
+
+// kernel (no display dependencies)
+void transitionCompose(uint16_t* dst, int dstStride, const uint16_t* from, const uint16_t* to, int srcStride, int w,
+                       int h, TransitionType type, uint16_t progress);
+
+// driver
+bool transitionInit();
+void transitionCapture(VirtualCanvas* canvas);
+void transitionStart(VirtualCanvas* canvas, TransitionType type, unsigned long now);
+bool transitionActive();
+void transitionUpdate(unsigned long now);
+void transitionFinish();
+
+#endif
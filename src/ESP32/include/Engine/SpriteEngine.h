@@ -0,0 +1,81 @@
+/**
+ * @file SpriteEngine.h
+ * @brief tilemap background + z-ordered sprites on top of the canvas
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Games describe their scene (one tilemap, up to MAX_SPRITES sprites) and call engineRender() once per frame. Only the
+ * 8x8 tiles under sprites that moved or changed are rebuilt, so a frame costs roughly (moving sprites * sprite area).
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef SPRITE_ENGINE_H
+#define SPRITE_ENGINE_H
+
+#include "Display/VirtualCanvas.h"
+
+// tiles line up with the canvas damage tiles
+#define ENGINE_TILE_SIZE CANVAS_TILE_SIZE
+#define MAX_SPRITES 32
+
+// sprite pixels with this value are not drawn (magenta)
+#define SPRITE_TRANSPARENT 0xF81F
+
+// 8x8 RGB565 tiles stored back to back
+struct Tileset {
+  const uint16_t* pixels;
+  uint16_t tileCount;
+};
+
+// grid of tile indices covering the canvas from (0,0). cells outside the map are background color
+struct Tilemap {
+  const Tileset* tileset;
+  uint8_t* cells;
+  uint8_t cols;
+  uint8_t rows;
+};
+
+// RGB565 sprite bitmap, width x height, tightly packed
+struct SpriteImage {
+  const uint16_t* pixels;
+  uint8_t width;
+  uint8_t height;
+};
+
+// a sprite slot. games move sprites by writing x/y/image/visible directly, the engine notices the change on render
+struct Sprite {
+  const SpriteImage* image;
+  int16_t x;
+  int16_t y;
+  uint8_t z;            // higher is drawn on top
+  bool visible;
+
+  // engine bookkeeping (last drawn state)
+  bool inUse;
+  bool drawn;
+  const SpriteImage* drawnImage;
+  int16_t drawnX;
+  int16_t drawnY;
+  uint8_t drawnZ;
+};
+
+// per frame counters
+struct EngineStats {
+  uint16_t spritesDrawn;
+  uint16_t spritesCulled;
+  uint16_t spans;
+};
+
+void engineInit(VirtualCanvas* canvas, uint16_t backgroundColor);
+void engineSetTilemap(const Tilemap* map);
+void engineSetTile(uint8_t col, uint8_t row, uint8_t tile);
+Sprite* engineAddSprite(const SpriteImage* image, int16_t x, int16_t y, uint8_t z);
+void engineRemoveSprite(Sprite* sprite);
+void engineClearSprites();
+void engineInvalidate(int16_t x, int16_t y, int16_t w, int16_t h);
+void engineRender();
+const EngineStats& engineGetStats();
+
+#endif
@@ -15,15 +15,18 @@
 #ifndef COLOR_SELECT_SCREEN_H
 #define COLOR_SELECT_SCREEN_H
 
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "Display/VirtualCanvas.h"
 
-extern MatrixPanel_I2S_DMA* dma_display_cs;
+// room for the colors in assets/sketch_colors.txt
+#define MAX_SKETCH_COLORS 16
+
+extern VirtualCanvas* dma_display_cs;
 extern const char* colorNames[];
 extern uint16_t colorValues[];
 extern int selectedColorIndex;
-extern const int numColors;
+extern int numColors;
 
-void initColorSelector(MatrixPanel_I2S_DMA* display);
+void initColorSelector(VirtualCanvas* display);
 void drawColorSelector(uint16_t colorValues[]);
 void nextColor();
 void prevColor();
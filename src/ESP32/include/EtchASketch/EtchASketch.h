@@ -15,11 +15,21 @@
 #ifndef ETCH_A_SKETCH_H
 #define ETCH_A_SKETCH_H
 
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "Display/VirtualCanvas.h"
+#include "Input/InputMap.h"
+#include "Assets/AssetSink.h"
+#include "Assets/AssetSource.h"
 #include <Arduino.h>
 
-void initEtchASketch(MatrixPanel_I2S_DMA* disp, uint16_t color);
-void handleEtchCommand(const String& cmd);
+void initEtchASketch(VirtualCanvas* disp, uint16_t color);
+void handleEtchCommand(const String& cmd, unsigned long now);
+void updateEtchASketch(unsigned long now);
+void exitEtchASketch();
+void etchSetStorage(AssetSource* source, AssetSink* sink);
+int etchSessionCount();
+void etchReplayBegin(VirtualCanvas* disp, uint8_t colorIndex);
+void etchReplayAction(uint8_t action);
+InputProfile* etchInputProfile();
 void nextEtchColor();
 void prevEtchColor();
 
@@ -0,0 +1,32 @@
+/**
+ * @file SketchReplay.h
+ * @brief definitions for the saved sketches screen (browse sessions, timelapse replay)
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Reached from the color select screen with controller 1A. The arrows step through the saved sessions, each shown as
+ * its finished drawing; home plays the selected one from a blank canvas at REPLAY_DEFAULT_SPEED times real time
+ * (arrows change the speed while it plays). Sessions are redrawn from their stroke logs (EtchASketch/StrokeLog.h).
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef SKETCH_REPLAY_H
+#define SKETCH_REPLAY_H
+
+#include "Display/VirtualCanvas.h"
+#include "Assets/AssetSource.h"
+#include <Arduino.h>
+
+#define REPLAY_DEFAULT_SPEED 8
+#define REPLAY_MAX_SPEED 64
+#define REPLAY_EVENTS_PER_FRAME 200     // bounds a frame at high speed, the replay just runs a little behind
+#define REPLAY_MAX_GAP_MS 1000          // longest pause replayed (session time), the rest of a break is skipped
+
+void initSketchReplay(VirtualCanvas* disp, AssetSource* source);
+void handleReplayCommand(const String& cmd, unsigned long now);
+void updateSketchReplay(unsigned long now);
+void exitSketchReplay();
+
+#endif
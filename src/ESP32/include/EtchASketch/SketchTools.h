@@ -0,0 +1,65 @@
+/**
+ * @file SketchTools.h
+ * @brief drawing tools for the Sketch program: brush, line, rectangle, circle and flood fill
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The shapes are rasterized into horizontal runs handed to a plot callback, so the same outline can go into the canvas
+ * or into an overlay as a preview (and be mirrored on the way). The fill works directly on an RGB565 buffer (the canvas
+ * framebuffer) with a scanline algorithm and a fixed size seed stack, so it never recurses and never allocates.
+ *
+ * No Arduino dependencies, the tools can be checked against a plain buffer on a computer.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef SKETCH_TOOLS_H
+#define SKETCH_TOOLS_H
+
+#include <stdint.h>
+
+// seeds the fill can have waiting. running out is handled (see sketchFill()), it just costs a rescan
+#ifndef SKETCH_FILL_STACK
+#define SKETCH_FILL_STACK 128
+#endif
+
+// bytes of fill mask needed for a surface (one bit per pixel)
+#define SKETCH_MASK_BYTES(w, h) (((w) * (h) + 7) / 8)
+
+#define SKETCH_BRUSH_SIZE 3
+
+enum SketchTool : uint8_t { TOOL_PEN, TOOL_BRUSH, TOOL_LINE, TOOL_RECT, TOOL_CIRCLE, TOOL_FILL, TOOL_COUNT };
+
+// mirroring applied to everything drawn
+enum SketchSymmetry : uint8_t { SYM_NONE, SYM_MIRROR, SYM_QUAD, SYM_COUNT };
+
+extern const char* const SKETCH_TOOL_NAMES[TOOL_COUNT];
+extern const char* const SKETCH_SYMMETRY_NAMES[SYM_COUNT];
+
+// one run of w pixels starting at (x, y). runs may reach off the surface, the callback clips
+typedef void (*SketchPlot)(void* ctx, int16_t x, int16_t y, int16_t w);
+
+struct SketchSurface {
+  uint16_t* pixels;                     // width * height, rows packed
+  int16_t width;
+  int16_t height;
+  uint8_t* mask;                        // SKETCH_MASK_BYTES(width, height) of scratch for sketchFill()
+};
+
+// pixels a tool changed, empty if x1 < x0
+struct SketchRect {
+  int16_t x0, y0, x1, y1;
+};
+
+bool sketchToolNeedsAnchor(uint8_t tool);
+
+void sketchBrush(int16_t x, int16_t y, SketchPlot plot, void* ctx);
+void sketchLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SketchPlot plot, void* ctx);
+void sketchRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SketchPlot plot, void* ctx);
+void sketchCircle(int16_t cx, int16_t cy, int16_t px, int16_t py, SketchPlot plot, void* ctx);
+void sketchShape(uint8_t tool, int16_t ax, int16_t ay, int16_t x, int16_t y, SketchPlot plot, void* ctx);
+
+int sketchFill(SketchSurface* s, int16_t x, int16_t y, uint16_t color, SketchRect* damage);
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @file StrokeLog.h
+ * @brief compact log of a Sketch session, for saving drawings and replaying them as a timelapse
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * A session always starts the same way (black canvas, cursor in the middle, pen, no mirroring), so instead of pixels
+ * the log keeps the program actions (move, color, tool, fill, ...) with the time between them. Replaying the actions
+ * through the Sketch program redraws the exact same picture. Layout:
+ *
+ *   header  "SKL1", width (u16 LE), height (u16 LE), starting color index (u8)
+ *   events  one byte each: bits 7..5 ticks of STROKE_TICK_MS since the previous event (0..6), bits 4..0 the action.
+ *           7 ticks means "7 or more": the rest follows as a varint (7 bits per byte, low bits first)
+ *
+ * Turning an RPG produces one byte per pixel, a typical drawing is a few KB, so hundreds fit in the flash partition.
+ * Sessions are numbered files /sketch/0001.skl, /sketch/0002.skl, ... Writing and reading both go through one
+ * STROKE_CHUNK buffer (AssetSink / AssetSource), nothing is allocated per event.
+ *
+ * No Arduino dependencies, encoding and decoding can be checked on a computer.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef STROKE_LOG_H
+#define STROKE_LOG_H
+
+#include "Assets/AssetSink.h"
+#include "Assets/AssetSource.h"
+#include <stdint.h>
+
+#define STROKE_TICK_MS 10
+#define STROKE_CHUNK 256
+#define STROKE_HEADER_BYTES 9
+#define STROKE_MAX_ACTION 31
+#define STROKE_MAX_SESSIONS 999
+#define STROKE_PATH_LEN 20              // "/sketch/0001.skl"
+
+struct StrokeEvent {
+  uint8_t action;
+  uint32_t atMs;                        // since the start of the session
+};
+
+struct StrokeWriter {
+  AssetSink* sink;
+  uint8_t buf[STROKE_CHUNK];
+  uint16_t len;
+  uint32_t startMs;
+  uint32_t lastTick;
+  uint32_t events;
+  uint32_t bytes;                       // file size so far
+  bool failed;                          // out of space, the rest of the session is not recorded
+};
+
+struct StrokeReader {
+  AssetSource* source;
+  char path[STROKE_PATH_LEN];
+  uint8_t buf[STROKE_CHUNK];
+  uint16_t len;
+  uint16_t pos;
+  uint32_t offset;                      // file offset of buf[len]
+  uint32_t tick;
+  uint16_t width;
+  uint16_t height;
+  uint8_t colorIndex;
+};
+
+bool strokeWriterBegin(StrokeWriter* w, AssetSink* sink, const char* path, uint16_t width, uint16_t height,
+                       uint8_t colorIndex, uint32_t now);
+void strokeWriterAdd(StrokeWriter* w, uint8_t action, uint32_t now);
+bool strokeWriterFinish(StrokeWriter* w);
+
+bool strokeReaderBegin(StrokeReader* r, AssetSource* source, const char* path);
+bool strokeReaderNext(StrokeReader* r, StrokeEvent* e);
+
+void strokeSessionPath(char* dst, int n);
+int strokeSessionCount(AssetSource* source);
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file InputMap.h
+ * @brief per program tables mapping Arduino commands to program actions (chords, hold / repeat)
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Every command from the Arduino is turned into an input code once, and each program owns an InputProfile: a table
+ * indexed by input code holding its action (plus how often it repeats while held), and a few chords (two inputs pressed
+ * together). Programs then switch on their own action ids instead of comparing command strings.
+ *
+ * Bindings can be changed in /input.cfg on the flash filesystem, one per line:
+ *
+ *   # program  input(s)                    action     [repeat ms]
+ *   sketch     rpg1CW                      up
+ *   sketch     controller1A+controller1B   clear
+ *   chess      joystick1UP                 up         200
+ *
+ * The file is read once at boot and only rewrites the tables, so remapping costs nothing afterwards.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef INPUT_MAP_H
+#define INPUT_MAP_H
+
+#include "Assets/AssetSource.h"
+#include <stdint.h>
+
+#define INPUT_CONFIG_PATH "/input.cfg"
+#define INPUT_CONFIG_MAX_BYTES 2048
+
+// second input of a chord has to follow the first within this time
+#ifndef INPUT_CHORD_MS
+#define INPUT_CHORD_MS 60
+#endif
+
+// streamed commands (joysticks) closer together than this are one continuous hold
+#define INPUT_HOLD_GAP_MS 120
+
+#define INPUT_MAX_CHORDS 4
+#define INPUT_ACTION_NONE 0
+
+// everything the Arduino sends
+enum InputCode : uint8_t {
+  IN_NONE,
+  IN_UP_ARROW, IN_DOWN_ARROW, IN_HOME_CLICK, IN_HOME_HOLD,
+  IN_C1A, IN_C1B, IN_C2A, IN_C2B,
+  IN_RPG1_CW, IN_RPG1_CCW, IN_RPG2_CW, IN_RPG2_CCW,
+  IN_JOY1_UP, IN_JOY1_DOWN, IN_JOY1_LEFT, IN_JOY1_RIGHT,
+  IN_JOY2_UP, IN_JOY2_DOWN, IN_JOY2_LEFT, IN_JOY2_RIGHT,
+  IN_C1A_DOUBLE, IN_C1B_DOUBLE, IN_C2A_DOUBLE, IN_C2B_DOUBLE,
+  IN_COUNT
+};
+
+// one default binding. input2 != IN_NONE makes it a chord
+struct InputBinding {
+  uint8_t input;
+  uint8_t input2;
+  uint8_t action;
+  uint16_t repeatMs;                    // 0 = every command fires, otherwise at most this often while held
+};
+
+struct InputChord {
+  uint8_t a, b, action;
+};
+
+struct InputProfile {
+  const char* name;                     // program name used in the config file
+  const char* const* actionNames;       // action id -> name, [0] is "none"
+  uint8_t actionCount;
+
+  uint8_t action[IN_COUNT];
+  uint16_t repeatMs[IN_COUNT];
+  InputChord chords[INPUT_MAX_CHORDS];
+  uint8_t chordCount;
+  uint32_t chordMask;                   // bit per input that starts a chord (those wait INPUT_CHORD_MS)
+};
+
+struct InputMapper {
+  const InputProfile* profile;
+  uint8_t pending;                      // input waiting for its chord partner, IN_NONE if none
+  unsigned long pendingAt;
+  unsigned long lastSeen[IN_COUNT];
+  unsigned long lastFired[IN_COUNT];
+};
+
+uint8_t inputCode(const char* command);
+const char* inputName(uint8_t code);
+
+void inputProfileInit(InputProfile* p, const char* name, const char* const* actionNames, uint8_t actionCount,
+                      const InputBinding* defaults, int count);
+bool inputBind(InputProfile* p, uint8_t input, uint8_t input2, uint8_t action, uint16_t repeatMs);
+uint32_t inputProfileInputs(const InputProfile* p);
+int inputLoadConfig(AssetSource* source, const char* path, InputProfile* const* profiles, int count);
+
+void inputMapperInit(InputMapper* m, const InputProfile* profile);
+int inputEvent(InputMapper* m, uint8_t code, unsigned long now, uint8_t actions[2]);
+int inputPoll(InputMapper* m, unsigned long now, uint8_t actions[2]);
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * @file BaudLink.h
+ * @brief negotiates a faster UART rate with the Arduino and watches the link quality
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Both sides start at 115200. The ESP32 leads, the Arduino answers (its side is BaudLink.h in the ATMega328P project):
+ *
+ *   ESP32 -> "baud 1000000"                     Arduino -> "baudOK 1000000" and switches (or "baudNO 1000000")
+ *   both at the new rate:
+ *   ESP32 -> "test <n> <32 chars> <crc8>"       Arduino -> the same line back if the crc matches (else "testBAD <n>")
+ *   ... BAUD_TEST_ROUNDS times, then
+ *   ESP32 -> "baudCommit"                       the Arduino keeps the rate
+ *
+ * Rates are tried from the fastest down (1M, 500k, 250k are exact on the 16 MHz AVR). Any bad or missing echo drops
+ * the ESP32 back to 115200; the Arduino gets no commit and goes back on its own after BAUD_COMMIT_MS, then the next
+ * lower rate is tried. If the Arduino never answers (older firmware) everything stays at 115200.
+ *
+ * Once up, the ESP32 sends "ping" every BAUD_PING_MS and the Arduino answers "pong <garbled lines it received>".
+ * Garbled lines on either side and missed pongs are counted; too many within BAUD_ERROR_WINDOW_MS (or
+ * BAUD_PING_MISSES pongs in a row) and the link falls back: "baudDrop", both go to 115200 (the Arduino also does so
+ * by itself once pings stop), and the next lower rate is negotiated.
+ *
+ * The state machine only talks through a LinkPort, so it can be run against a simulated lossy link on a PC.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef BAUD_LINK_H
+#define BAUD_LINK_H
+
+#include <stdint.h>
+
+#define BAUD_DEFAULT 115200
+
+// timing, the BAUD_COMMIT_MS and BAUD_WATCHDOG_MS values have to match the Arduino's
+#define BAUD_REPLY_MS 100               // answer to a request or test line
+#define BAUD_REQUEST_TRIES 12           // first request is repeated this often while the Arduino boots
+#define BAUD_TEST_ROUNDS 8
+#define BAUD_COMMIT_MS 1500             // Arduino reverts if no commit comes within this
+#define BAUD_WATCHDOG_MS 3500           // Arduino reverts if no ping comes within this
+#define BAUD_PING_MS 1000
+#define BAUD_PING_MISSES 3
+#define BAUD_ERROR_WINDOW_MS 2000
+#define BAUD_MAX_ERRORS 4
+
+#define BAUD_TEST_PAYLOAD 32
+
+// how the state machine reaches the UART
+class LinkPort {
+public:
+  virtual ~LinkPort() {}
+
+  // send one line (the newline is added)
+  virtual void sendLine(const char* line) = 0;
+
+  // switch the local UART, after whatever was sent before has left
+  virtual void setBaud(uint32_t baud) = 0;
+};
+
+struct BaudLinkStats {
+  uint32_t baud;                        // current rate
+  uint32_t testErrors;                  // test lines that did not come back intact
+  uint32_t lineErrors;                  // garbled lines received here
+  uint32_t peerErrors;                  // garbled lines the Arduino received (from its pongs)
+  uint16_t missedPongs;
+  uint16_t negotiations;                // rates tried
+  uint16_t fallbacks;                   // times a running link was dropped
+};
+
+struct BaudLink {
+  LinkPort* port;
+  uint8_t state;
+  uint8_t rate;                         // index into the rate table being tried / in use
+  uint8_t round;                        // test round, or request tries
+  uint32_t since;                       // when the current step started
+  uint32_t holdMs;                      // length of a holdoff
+  uint32_t lastPing;
+  bool awaiting;                        // test echo or pong outstanding
+  uint8_t missed;
+  uint8_t windowErrors;
+  uint32_t windowStart;
+  BaudLinkStats stats;
+};
+
+uint8_t baudCrc8(const char* data, int len);
+
+void baudLinkBegin(BaudLink* link, LinkPort* port, uint32_t now);
+bool baudLinkLine(BaudLink* link, const char* line, uint32_t now);
+void baudLinkError(BaudLink* link, uint32_t now);
+void baudLinkPoll(BaudLink* link, uint32_t now);
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file InputContext.h
+ * @brief tells the Arduino which inputs the active screen actually reads
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Whenever the screen changes (and every CONTEXT_REFRESH_MS, in case a line got lost) the ESP32 sends
+ *
+ *   "ctx <inputs> <rpg delta ms> <joystick ms>"        e.g. "ctx 7C7 10 10"
+ *
+ *   inputs          CTX_* bits in hex, the input groups the screen reads. the Arduino stops watching the rest: their
+ *                   pin change interrupts are masked and the ADC is switched off when no joystick is needed
+ *   rpg delta ms    0: every RPG tick is sent as rpg1CW / rpg1CCW. otherwise ticks are added up and sent at most this
+ *                   often as "rpg1Delta <ticks>" (negative is counter clockwise), one line for a fast spin
+ *   joystick ms     how often the enabled joysticks are sampled
+ *
+ * The power button is always watched. An Arduino without context support ignores the line (it still understands
+ * enableController / disableController), and one that never hears a context scans everything (CTX_DEFAULT).
+ *
+ * No Arduino dependencies, both ends of the format can be checked on a computer.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef INPUT_CONTEXT_H
+#define INPUT_CONTEXT_H
+
+#include <stdint.h>
+
+// input groups, same bits on the Arduino
+#define CTX_UP_ARROW   (1 << 0)
+#define CTX_DOWN_ARROW (1 << 1)
+#define CTX_HOME       (1 << 2)
+#define CTX_C1A        (1 << 3)
+#define CTX_C1B        (1 << 4)
+#define CTX_C2A        (1 << 5)
+#define CTX_C2B        (1 << 6)
+#define CTX_RPG1       (1 << 7)
+#define CTX_RPG2       (1 << 8)
+#define CTX_JOY1       (1 << 9)
+#define CTX_JOY2       (1 << 10)
+
+#define CTX_ARROWS     (CTX_UP_ARROW | CTX_DOWN_ARROW)
+#define CTX_BUTTONS    (CTX_ARROWS | CTX_HOME | CTX_C1A | CTX_C1B | CTX_C2A | CTX_C2B)
+#define CTX_RPGS       (CTX_RPG1 | CTX_RPG2)
+#define CTX_JOYSTICKS  (CTX_JOY1 | CTX_JOY2)
+
+#define CONTEXT_REFRESH_MS 2000
+#define CONTEXT_RPG_DELTA_MS 10         // for screens that redraw per frame anyway (a frame is longer than this)
+#define CONTEXT_JOYSTICK_MS 10
+
+struct InputContext {
+  uint16_t inputs;                      // CTX_* bits
+  uint16_t rpgDeltaMs;                  // 0 = one command per tick
+  uint16_t joystickMs;
+};
+
+uint16_t inputContextFromCodes(uint32_t codes);
+int inputContextFormat(const InputContext* ctx, char* out, int size);
+bool inputContextSame(const InputContext* a, const InputContext* b);
+bool rpgDeltaParse(const char* line, uint8_t* rpg, int* ticks);
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ * @file SerialLinkPort.h
+ * @brief LinkPort on a HardwareSerial (the UART to the Arduino)
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef SERIAL_LINK_PORT_H
+#define SERIAL_LINK_PORT_H
+
+#include "Link/BaudLink.h"
+#include <Arduino.h>
+
+class SerialLinkPort : public LinkPort {
+public:
+  explicit SerialLinkPort(HardwareSerial& serial) : serial(serial) {}
+
+  void sendLine(const char* line) override;
+  void setBaud(uint32_t baud) override;
+
+private:
+  HardwareSerial& serial;
+};
+
+#endif
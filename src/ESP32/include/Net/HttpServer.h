@@ -0,0 +1,52 @@
+/**
+ * @file HttpServer.h
+ * @brief HTTP request handlers for asset uploads and canvas downloads
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Endpoints (one request per connection):
+ *
+ *   PUT /assets/image/<name>   store an image (animation format, frame 0 is used) as /img/<name>.anim
+ *   PUT /assets/anim/<name>    store an animation the same way (POST works too)
+ *   GET /canvas.png            what is on the panel right now (the drawing, in EtchASketch) as a PNG
+ *   GET /canvas.raw            the same as little endian RGB565 rows, size in X-Width / X-Height
+ *   GET /sketches              saved Sketch sessions, one "<n> <bytes>" line each
+ *   GET /sketches/<n>          stroke log of session n (see EtchASketch/StrokeLog.h)
+ *
+ * Uploads may use Content-Length or chunked transfer encoding and are streamed to the sink as they arrive, through
+ * one fixed receive buffer. Everything talks to a Socket, an AssetSink and an AssetSource, no Arduino dependencies.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include "Net/Socket.h"
+#include "Assets/AssetSink.h"
+#include "Assets/AssetSource.h"
+#include "Assets/AssetStore.h"
+
+// receive buffer, also the longest request / header line accepted
+#define HTTP_BUFFER_SIZE 512
+
+// an upload bigger than the asset cache could never be loaded, so it is refused
+#define HTTP_MAX_UPLOAD ASSET_CACHE_BYTES
+
+struct HttpContext {
+  AssetSink* sink;                      // where uploads are written
+  AssetSource* source;                  // where saved sketches are read, nullptr if there is none
+  const uint16_t* pixels;               // canvas for the downloads, nullptr if there is none
+  uint16_t width, height, stride;
+
+  // asked before an upload is written, false refuses it (name already in use)
+  bool (*accept)(AssetType type, const char* name);
+
+  // called once an upload is complete at path
+  void (*stored)(AssetType type, const char* name, const char* path);
+};
+
+void httpServe(Socket& sock, const HttpContext& ctx);
+
+#endif
@@ -0,0 +1,36 @@
+/**
+ * @file PngEncoder.h
+ * @brief streams an RGB565 buffer out as an uncompressed PNG
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Images with up to 256 colors (every EtchASketch drawing) are written palette indexed, one byte per pixel; anything
+ * else as 8 bit RGB. The zlib stream uses stored (uncompressed) deflate blocks, so the exact file size is known up
+ * front (for Content-Length) and the image is sent row by row from a fixed buffer. No Arduino dependencies.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef PNG_ENCODER_H
+#define PNG_ENCODER_H
+
+#include "Net/Socket.h"
+
+#define PNG_MAX_PALETTE 256
+#define PNG_HASH_SIZE 512               // open addressing color -> palette index table, twice the palette
+
+struct PngEncoder {
+  const uint16_t* pixels;
+  int width, height, stride;
+
+  uint16_t paletteCount;                // 0 = too many colors, written as RGB
+  uint16_t palette[PNG_MAX_PALETTE];
+  uint16_t hashColor[PNG_HASH_SIZE];
+  int16_t hashIndex[PNG_HASH_SIZE];     // -1 = empty
+};
+
+uint32_t pngBegin(PngEncoder* png, const uint16_t* pixels, int width, int height, int stride);
+bool pngWrite(PngEncoder* png, Socket& out);
+
+#endif
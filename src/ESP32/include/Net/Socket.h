@@ -0,0 +1,30 @@
+/**
+ * @file Socket.h
+ * @brief minimal blocking byte stream the HTTP handlers talk through
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The request handlers only ever need "give me some bytes" and "send these bytes", so that is all a socket has to
+ * provide. On the ESP32 it wraps a WiFiClient; on a PC it can wrap a plain socket (or one end of a socketpair) so the
+ * handlers run against a loopback client.
+ *
+ */
+
+#ifndef SOCKET_H
+#define SOCKET_H
+
+#include <stdint.h>
+
+class Socket {
+public:
+  virtual ~Socket() {}
+
+  // wait for data and read up to len bytes. returns bytes read, 0 or -1 once the peer is gone or timed out
+  virtual int32_t read(uint8_t* dst, uint32_t len) = 0;
+
+  // send all len bytes, false if the connection dropped
+  virtual bool write(const uint8_t* src, uint32_t len) = 0;
+};
+
+#endif
@@ -0,0 +1,31 @@
+/**
+ * @file WebService.h
+ * @brief Wi-Fi connection and HTTP server task for uploads / canvas downloads
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Off unless the Wi-Fi credentials are given as build flags in platformio.ini:
+ *
+ *   build_flags = -DUSE_GFX_ROOT -DWIFI_SSID=\"name\" -DWIFI_PASSWORD=\"secret\"
+ *
+ * The console then answers on http://console.local/ (endpoints listed in Net/HttpServer.h).
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef WEB_SERVICE_H
+#define WEB_SERVICE_H
+
+#include "Display/VirtualCanvas.h"
+
+#define WEB_PORT 80
+#define WEB_HOSTNAME "console"
+
+// a client that sends nothing for this long is dropped
+#define WEB_TIMEOUT_MS 5000
+
+bool webServiceBegin(VirtualCanvas* canvas);
+void webServicePoll();
+
+#endif
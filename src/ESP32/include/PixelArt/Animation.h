@@ -0,0 +1,52 @@
+/**
+ * @file Animation.h
+ * @brief palette indexed pixel art animations with delta frames
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Format (all multi byte values little endian), built by tools/anim_encode.py:
+ *
+ *   header   'A' 'N' version(1) width height paletteCount(0 = 256) frameCount(u16)
+ *   palette  paletteCount x RGB565 (u16)
+ *   frame    size(u16, bytes after this field) durationMs(u16) rectCount(u8)
+ *            rectCount x { x y w h (u8 each), ops covering w * h pixels row by row }
+ *
+ *   ops      0x00-0x7F  literal: (op + 1) palette indices follow
+ *            0x80-0xBF  run:     (op & 0x3F) + 1 pixels of the next index
+ *            0xC0-0xFF  skip:    (op & 0x3F) + 1 pixels stay as they are
+ *
+ * Frame 0 is a keyframe (one rect covering the whole image, no skips). Later frames only carry the rects that changed
+ * since the previous frame, and looping decodes frame 0 again. Frames are decoded straight into the target buffer, the
+ * animation is never unpacked in memory.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <stdint.h>
+
+#define ANIM_VERSION 1
+#define ANIM_HEADER_SIZE 8
+
+struct AnimInfo {
+  uint8_t width;
+  uint8_t height;
+  uint16_t paletteCount;
+  uint16_t frameCount;
+  const uint8_t* palette;               // raw little endian RGB565 entries
+  uint32_t firstFrame;                  // byte offset of frame 0
+};
+
+// area of the target buffer touched by a frame (in target pixels, w == 0 if nothing)
+struct AnimDirty {
+  int16_t x, y, w, h;
+};
+
+bool animParse(const uint8_t* data, uint32_t size, AnimInfo* info);
+int32_t animDecodeFrame(const uint8_t* data, uint32_t size, const AnimInfo& info, uint32_t* offset, uint16_t* dst,
+                        int dstStride, int scale, AnimDirty* dirty);
+
+#endif
@@ -0,0 +1,24 @@
+// generated by tools/anim_encode.py from assets/pacman.txt, do not edit
+// 16x16, 4 frames, 182 bytes
+
+#ifndef PACMAN_ANIM_H
+#define PACMAN_ANIM_H
+
+#include <stdint.h>
+
+static const uint8_t pacman_anim[] = {
+  0x41, 0x4E, 0x01, 0x10, 0x10, 0x03, 0x04, 0x00, 0x00, 0x00, 0xE0, 0xFF, 0x1F, 0x00, 0x4E, 0x00,
+  0x5A, 0x00, 0x01, 0x00, 0x00, 0x10, 0x10, 0x84, 0x00, 0x85, 0x01, 0x87, 0x00, 0x89, 0x01, 0x84,
+  0x00, 0x8B, 0x01, 0x82, 0x00, 0x85, 0x01, 0x01, 0x00, 0x02, 0x83, 0x01, 0x83, 0x00, 0x89, 0x01,
+  0x84, 0x00, 0x88, 0x01, 0x86, 0x00, 0x86, 0x01, 0x88, 0x00, 0x84, 0x01, 0x8A, 0x00, 0x84, 0x01,
+  0x8A, 0x00, 0x86, 0x01, 0x88, 0x00, 0x88, 0x01, 0x87, 0x00, 0x89, 0x01, 0x85, 0x00, 0x8B, 0x01,
+  0x84, 0x00, 0x8B, 0x01, 0x84, 0x00, 0x89, 0x01, 0x87, 0x00, 0x85, 0x01, 0x84, 0x00, 0x2C, 0x00,
+  0x5A, 0x00, 0x01, 0x05, 0x03, 0x0A, 0x0A, 0xC1, 0x00, 0x01, 0xC4, 0x01, 0x01, 0x01, 0xC5, 0x83,
+  0x01, 0xC3, 0x83, 0x01, 0xC3, 0x82, 0x01, 0xC4, 0x01, 0x01, 0x01, 0xC7, 0x01, 0x01, 0x01, 0xC9,
+  0x82, 0x01, 0xC8, 0x83, 0x01, 0xC7, 0x83, 0x01, 0xC7, 0x01, 0x01, 0x01, 0x13, 0x00, 0x5A, 0x00,
+  0x01, 0x07, 0x05, 0x09, 0x06, 0xC5, 0x82, 0x01, 0xC2, 0x97, 0x01, 0xC2, 0x85, 0x01, 0xC5, 0x82,
+  0x01, 0x13, 0x00, 0x5A, 0x00, 0x01, 0x07, 0x05, 0x09, 0x06, 0xC5, 0x82, 0x00, 0xC2, 0x97, 0x00,
+  0xC2, 0x85, 0x00, 0xC5, 0x82, 0x00,
+};
+
+#endif
@@ -15,12 +15,20 @@
 #ifndef IMAGES_H
 #define IMAGES_H
 
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "Display/VirtualCanvas.h"
 
-void drawLogo(MatrixPanel_I2S_DMA* display);
+// default time each slide stays up in auto advance
+#ifndef SLIDESHOW_DWELL_MS
+#define SLIDESHOW_DWELL_MS 6000
+#endif
+
+void drawLogo(VirtualCanvas* display);
 int getCurrentImageIndex();
-void drawCurrentImage(MatrixPanel_I2S_DMA* display);
+void drawCurrentImage(VirtualCanvas* display);
+void updateCurrentImage(VirtualCanvas* display, unsigned long now);
 void prevImage();
 void nextImage();
+bool toggleSlideshowAuto();
+void setSlideshowDwell(unsigned long ms);
 
 #endif
@@ -0,0 +1,25 @@
+/**
+ * @file Pong.h
+ * @brief definitions for the two player Pong program
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Program driver for Pong: maps controller commands from the Arduino onto the paddles, runs the simulation at a fixed
+ * tick and renders it through the sprite engine.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef PONG_H
+#define PONG_H
+
+#include "Display/VirtualCanvas.h"
+#include <Arduino.h>
+
+void initPong(VirtualCanvas* disp);
+void handlePongCommand(const String& cmd, unsigned long now);
+void updatePong(unsigned long now);
+void exitPong();
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file PongGame.h
+ * @brief deterministic two player Pong simulation
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Pure game logic: no Arduino, no display. Everything is integer (Q8.8 fixed point) and advanced one fixed tick at a
+ * time, so the same sequence of inputs always produces the same game. Rendering and input live in Pong.cpp.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef PONG_GAME_H
+#define PONG_GAME_H
+
+#include <stdint.h>
+
+// simulation rate. one pongStep() per tick
+#define PONG_TICK_MS 16
+
+// sizes in pixels
+#define PONG_PADDLE_W 2
+#define PONG_PADDLE_H 12
+#define PONG_PADDLE_INSET 2
+#define PONG_BALL_SIZE 2
+#define PONG_WIN_SCORE 7
+
+// Q8.8 fixed point helpers
+#define PONG_FP(px) ((int32_t)(px) << 8)
+#define PONG_PX(fp) ((int16_t)((fp) >> 8))
+
+// events reported by pongStep() so the renderer knows what changed
+#define PONG_EVT_PADDLE_HIT 0x01
+#define PONG_EVT_WALL_HIT   0x02
+#define PONG_EVT_SCORED     0x04
+#define PONG_EVT_SERVE      0x08
+#define PONG_EVT_GAME_OVER  0x10
+
+struct PongState {
+  // playfield (pixels). ball and paddles stay between top and bottom
+  int16_t width;
+  int16_t top;
+  int16_t bottom;
+
+  // Q8.8 positions (top left) and velocities
+  int32_t ballX;
+  int32_t ballY;
+  int32_t ballVX;
+  int32_t ballVY;
+  int32_t paddleY[2];
+
+  uint8_t score[2];
+  uint8_t serveTimer;       // ticks until the next serve, 0 while the ball is in play
+  int8_t serveDir;          // -1 towards player 1, +1 towards player 2
+  uint16_t rng;             // LFSR for serve angles
+  uint32_t tick;
+  bool gameOver;
+};
+
+void pongInit(PongState* s, int16_t width, int16_t top, int16_t bottom);
+uint8_t pongStep(PongState* s, int8_t move1, int8_t move2);
+int16_t pongPaddleX(const PongState* s, int player);
+
+#endif
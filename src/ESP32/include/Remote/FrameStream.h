@@ -0,0 +1,71 @@
+/**
+ * @file FrameStream.h
+ * @brief decoder for frames streamed from a host as run length coded dirty tiles
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Format (all multi byte values little endian), built by tools/stream_encode.py:
+ *
+ *   frame    0xA5 0x5A seq(u8) flags(u8) tileCount(u16) tiles... check(u16)
+ *   tile     index(u16, tx + ty * tilesX) then ops covering the 8x8 tile row by row
+ *   ops      0x00-0x7F  literal: (op + 1) RGB565 pixels follow
+ *            0x80-0xFF  run:     (op & 0x7F) + 1 copies of the next RGB565 pixel
+ *   flags    bit 0: keyframe (every tile is present)
+ *   check    Fletcher-16 of everything from seq to the end of the last tile
+ *
+ * Only tiles that changed since the previous frame are sent. Bytes are decoded as they arrive, straight into the
+ * framebuffer, so no frame is ever assembled in memory and a frame can arrive in any number of pieces. A damaged frame
+ * (bad checksum, bad tile, lost bytes) is reported and the decoder hunts for the next 0xA5 0x5A; the host answers with a
+ * keyframe. No Arduino dependencies.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef FRAME_STREAM_H
+#define FRAME_STREAM_H
+
+#include <stdint.h>
+
+#define STREAM_SYNC0 0xA5
+#define STREAM_SYNC1 0x5A
+#define STREAM_TILE 8
+#define STREAM_FLAG_KEYFRAME 0x01
+
+struct FrameStreamStats {
+  uint32_t frames;                      // frames decoded with a good checksum
+  uint32_t errors;                      // frames dropped (checksum, bad tile, framing)
+  uint32_t tiles;
+  uint32_t bytes;
+};
+
+struct FrameStream {
+  uint16_t* pixels;
+  int stride;
+  uint16_t tilesX, tilesY;
+
+  // called when a tile has been written (x, y = its top left pixel) and when a frame ends (ok = checksum matched)
+  void (*tileDone)(void* ctx, int x, int y);
+  void (*frameDone)(void* ctx, uint8_t seq, bool ok);
+  void* ctx;
+
+  // parser state
+  uint8_t state;
+  uint8_t field[4];                     // multi byte field being collected
+  uint8_t fieldLen;
+  uint8_t seq, flags;
+  uint16_t tilesLeft;
+  uint16_t* tile;                       // top left pixel of the tile being written
+  uint8_t pixel;                        // next pixel of the tile, 0..63
+  uint8_t opLeft;                       // pixels left in the current op
+  bool opRun;
+  uint16_t sum1, sum2;
+
+  FrameStreamStats stats;
+};
+
+void frameStreamInit(FrameStream* fs, uint16_t* pixels, int width, int height, int stride);
+void frameStreamReset(FrameStream* fs);
+void frameStreamFeed(FrameStream* fs, const uint8_t* data, uint32_t len);
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * @file RemoteDisplay.h
+ * @brief definitions for the Stream program (the panel as a display for a host)
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Program driver for Stream: frames sent by tools/stream_encode.py over the USB serial port or TCP are decoded straight
+ * onto the canvas. Turns the console into a generic display for dashboards and video.
+ * comments included in .cpp file
+ *
+ */
+
+#ifndef REMOTE_DISPLAY_H
+#define REMOTE_DISPLAY_H
+
+#include "Display/VirtualCanvas.h"
+#include <Arduino.h>
+
+// USB serial link (UART0, the programming port)
+#ifndef REMOTE_BAUD
+#define REMOTE_BAUD 2000000
+#endif
+#define REMOTE_RX_BUFFER 8192
+
+// TCP link, only while Wi-Fi is connected (see Net/WebService.h)
+#define REMOTE_TCP_PORT 5050
+
+// bytes moved from a link to the decoder per read, and the most time one pass of loop() spends decoding
+#define REMOTE_CHUNK 1024
+#define REMOTE_BUDGET_US 12000
+
+void initRemoteDisplay(VirtualCanvas* disp);
+void updateRemoteDisplay(unsigned long now);
+void exitRemoteDisplay();
+
+#endif
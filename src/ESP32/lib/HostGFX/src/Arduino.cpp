@@ -0,0 +1,19 @@
+/**
+ * @file Arduino.cpp
+ * @brief host clock and Print number formatting
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+
+uint32_t hostMicros = 0;
+
+size_t Print::print(long v) {
+  char text[12];
+  snprintf(text, sizeof(text), "%ld", v);
+  return write(text);
+}
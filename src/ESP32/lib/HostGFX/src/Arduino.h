@@ -0,0 +1,54 @@
+/**
+ * @file Arduino.h
+ * @brief the bit of the Arduino core the display code uses, for the native test build
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Only built by [env:native] (the board env ignores this library). Time is a host clock the tests set themselves, so
+ * anything timed runs the same on every machine.
+ *
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+// like the ESP32 core
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// simulated clock, starts at 0 and only moves when a test moves it
+extern uint32_t hostMicros;
+inline uint32_t micros() { return hostMicros; }
+inline uint32_t millis() { return hostMicros / 1000; }
+inline void hostAdvanceMs(uint32_t ms) { hostMicros += ms * 1000; }
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t done = 0;
+    while (n--) done += write(*buf++);
+    return done;
+  }
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(const char* s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long v);
+  size_t print(int v) { return print((long)v); }
+  size_t println(const char* s) { return print(s) + print("\r\n"); }
+  size_t println() { return print("\r\n"); }
+};
+
+#endif
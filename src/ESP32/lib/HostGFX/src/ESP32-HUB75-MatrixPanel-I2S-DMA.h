@@ -0,0 +1,59 @@
+/**
+ * @file ESP32-HUB75-MatrixPanel-I2S-DMA.h
+ * @brief host version of the HUB75 panel chain: a plain framebuffer, for the native test build
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The chain is one strip of chain_length panels side by side, like the DMA library sees it. Tests read back what the
+ * panels would show with shown() and count how many pixels were sent with pixelWrites.
+ *
+ */
+
+#ifndef HOST_MATRIX_PANEL_H
+#define HOST_MATRIX_PANEL_H
+
+#include <Adafruit_GFX.h>
+#include <new>
+
+struct HUB75_I2S_CFG {
+  uint16_t mx_width;
+  uint16_t mx_height;
+  uint16_t chain_length;
+
+  HUB75_I2S_CFG(uint16_t w = 64, uint16_t h = 32, uint16_t chain = 1) : mx_width(w), mx_height(h), chain_length(chain) {}
+};
+
+class MatrixPanel_I2S_DMA : public Adafruit_GFX {
+public:
+  explicit MatrixPanel_I2S_DMA(const HUB75_I2S_CFG& cfg)
+    : Adafruit_GFX(cfg.mx_width * cfg.chain_length, cfg.mx_height), pixels(nullptr), pixelWrites(0), brightness(128) {}
+  ~MatrixPanel_I2S_DMA() { delete[] pixels; }
+
+  bool begin() {
+    pixels = new (std::nothrow) uint16_t[WIDTH * HEIGHT]();
+    return pixels != nullptr;
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (!pixels || x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) return;
+    pixels[y * WIDTH + x] = color;
+    pixelWrites++;
+  }
+
+  void clearScreen() { fillScreen(0); }
+  void setBrightness8(uint8_t b) { brightness = b; }
+
+  static uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+  }
+
+  // host only
+  uint16_t shown(int16_t x, int16_t y) const { return pixels[y * WIDTH + x]; }
+
+  uint16_t* pixels;
+  uint32_t pixelWrites;                 // drawPixel calls that landed on the chain
+  uint8_t brightness;
+};
+
+#endif
@@ -0,0 +1,384 @@
+/**
+ * @file AssetStore.cpp
+ * @brief implementation of the lazy loading asset store
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Cache: ASSET_CACHE_SLOTS slots, each stamped with a use counter; making room evicts the slot with the oldest stamp.
+ * The asset most recently returned by assetGet() is never evicted, so whatever is on screen (an animation keeps
+ * reading its cached bytes every frame) stays valid while neighbours are prefetched around it.
+ *
+ * Prefetch: assetPrefetch() only queues the index. assetsPoll(), called every pass of loop(), reads at most
+ * ASSET_PREFETCH_CHUNK bytes of the queued file into a staging buffer and caches it once complete. Doing the work in
+ * slices on the main loop instead of in a second task keeps the cache single threaded (no locks around lookups), and
+ * a slice is short enough not to be noticed next to a frame. If the foreground asks for the asset being prefetched,
+ * the rest of it is read right away.
+ *
+ */
+
+#include "Assets/AssetStore.h"
+#include "PixelArt/Animation.h"
+#include <new>
+#include <string.h>
+
+struct IndexEntry {
+  char name[ASSET_NAME_LEN];
+  char path[ASSET_PATH_LEN];
+  AssetType type;
+};
+
+struct CacheSlot {
+  int16_t index;                  // asset in the slot, -1 if free
+  uint32_t lastUse;
+  uint8_t* memory;
+  Asset asset;
+};
+
+struct PrefetchJob {
+  int16_t index;                  // -1 if idle
+  uint8_t* staging;
+  uint32_t size;
+  uint32_t loaded;
+};
+
+static AssetSource* source = nullptr;
+static IndexEntry entries[ASSET_MAX_ENTRIES];
+static int entryCount = 0;
+
+static CacheSlot slots[ASSET_CACHE_SLOTS];
+static uint32_t useClock = 0;
+static int16_t mostRecent = -1;
+static AssetStats stats;
+
+static int16_t prefetchQueue[ASSET_PREFETCH_QUEUE];
+static uint8_t queueLength = 0;
+static PrefetchJob job = { -1, nullptr, 0, 0 };
+
+// ---------- index ---------- //
+
+/**
+ * @brief parse one "type name path" line
+ */
+static void parseIndexLine(char* line) {
+  char* type = strtok(line, " \t");
+  char* name = strtok(nullptr, " \t");
+  char* path = strtok(nullptr, " \t");
+  if (!type || !name || !path || type[0] == '#') return;
+  if (entryCount >= ASSET_MAX_ENTRIES) return;
+  if (strlen(name) >= ASSET_NAME_LEN || strlen(path) >= ASSET_PATH_LEN) return;
+
+  IndexEntry& e = entries[entryCount];
+  if      (strcmp(type, "image") == 0)   e.type = ASSET_IMAGE;
+  else if (strcmp(type, "anim") == 0)    e.type = ASSET_ANIMATION;
+  else if (strcmp(type, "palette") == 0) e.type = ASSET_PALETTE;
+  else if (strcmp(type, "font") == 0)    e.type = ASSET_FONT;
+  else return;
+
+  strcpy(e.name, name);
+  strcpy(e.path, path);
+  entryCount++;
+}
+
+/**
+ * @brief read the index. nothing else is loaded
+ *
+ * anything a previous call cached or queued is dropped, its indices mean nothing under the new index
+ *
+ * @param src filesystem to load from
+ * @return false if there is no usable index (the store is then empty)
+ */
+bool assetsBegin(AssetSource* src) {
+  source = src;
+  entryCount = 0;
+  for (int i = 0; i < ASSET_CACHE_SLOTS; i++) {
+    delete[] slots[i].memory;
+    slots[i].memory = nullptr;
+    slots[i].index = -1;
+  }
+  if (job.index >= 0) delete[] job.staging;
+  job.index = -1;
+  queueLength = 0;
+  mostRecent = -1;
+  useClock = 0;
+  stats = AssetStats();
+
+  int32_t size = source->fileSize(ASSET_INDEX_PATH);
+  if (size <= 0 || size > ASSET_INDEX_MAX_BYTES) return false;
+
+  char* text = new (std::nothrow) char[size + 1];
+  if (!text) return false;
+  if (source->read(ASSET_INDEX_PATH, 0, (uint8_t*)text, size) != size) {
+    delete[] text;
+    return false;
+  }
+  text[size] = '\0';
+
+  // split into lines first, strtok is then free to tokenize each line
+  char* line = text;
+  while (line && *line) {
+    char* next = strpbrk(line, "\r\n");
+    if (next) *next++ = '\0';
+    parseIndexLine(line);
+    line = next;
+  }
+
+  delete[] text;
+  return entryCount > 0;
+}
+
+int assetCount() {
+  return entryCount;
+}
+
+const char* assetName(int index) {
+  return (index >= 0 && index < entryCount) ? entries[index].name : "";
+}
+
+AssetType assetType(int index) {
+  return entries[index].type;
+}
+
+/**
+ * @return index of the asset with this name, -1 if there is none
+ */
+int assetFind(const char* name) {
+  for (int i = 0; i < entryCount; i++) {
+    if (strcmp(entries[i].name, name) == 0) return i;
+  }
+  return -1;
+}
+
+/**
+ * @brief add an asset to the index while running (an upload that just finished)
+ *
+ * the entry is filled in before the count goes up, so lookups never see half of it
+ *
+ * @return its index, -1 if the index is full or the name is already used
+ */
+int assetAdd(AssetType type, const char* name, const char* path) {
+  if (entryCount >= ASSET_MAX_ENTRIES || assetFind(name) >= 0) return -1;
+  if (strlen(name) >= ASSET_NAME_LEN || strlen(path) >= ASSET_PATH_LEN) return -1;
+
+  IndexEntry& e = entries[entryCount];
+  e.type = type;
+  strcpy(e.name, name);
+  strcpy(e.path, path);
+  return entryCount++;
+}
+
+// ---------- cache ---------- //
+
+static CacheSlot* findSlot(int index) {
+  for (int i = 0; i < ASSET_CACHE_SLOTS; i++) {
+    if (slots[i].index == index) return &slots[i];
+  }
+  return nullptr;
+}
+
+static void freeSlot(CacheSlot* slot) {
+  stats.bytesCached -= slot->asset.size;
+  delete[] slot->memory;
+  slot->memory = nullptr;
+  slot->index = -1;
+}
+
+/**
+ * @brief evict least recently used assets until bytes fit and a slot is free
+ *
+ * @return a free slot, nullptr if the budget cannot be met
+ */
+static CacheSlot* makeRoom(uint32_t bytes) {
+  if (bytes > ASSET_CACHE_BYTES) return nullptr;
+
+  for (;;) {
+    CacheSlot* freeOne = nullptr;
+    CacheSlot* oldest = nullptr;
+    for (int i = 0; i < ASSET_CACHE_SLOTS; i++) {
+      CacheSlot* s = &slots[i];
+      if (s->index < 0) {
+        if (!freeOne) freeOne = s;
+      }
+      else if (s->index != mostRecent && (!oldest || s->lastUse < oldest->lastUse)) {
+        oldest = s;
+      }
+    }
+
+    if (freeOne && stats.bytesCached + bytes <= ASSET_CACHE_BYTES) return freeOne;
+    if (!oldest) return nullptr;
+    freeSlot(oldest);
+    stats.evictions++;
+  }
+}
+
+/**
+ * @brief turn a fully read file into a cached asset. takes ownership of raw
+ */
+static CacheSlot* cacheFile(int index, uint8_t* raw, uint32_t size) {
+  Asset asset;
+  asset.type = entries[index].type;
+  asset.width = asset.height = 0;
+  uint8_t* memory = raw;
+
+  // images are decoded once here so drawing them later is a plain copy
+  if (asset.type == ASSET_IMAGE) {
+    AnimInfo info;
+    memory = nullptr;
+    if (animParse(raw, size, &info)) {
+      uint32_t pixelBytes = (uint32_t)info.width * info.height * sizeof(uint16_t);
+      memory = new (std::nothrow) uint8_t[pixelBytes];
+      uint32_t offset = info.firstFrame;
+      if (memory && animDecodeFrame(raw, size, info, &offset, (uint16_t*)memory, info.width, 1, nullptr) >= 0) {
+        asset.width = info.width;
+        asset.height = info.height;
+        size = pixelBytes;
+      } else {
+        delete[] memory;
+        memory = nullptr;
+      }
+    }
+    delete[] raw;
+    if (!memory) return nullptr;
+  }
+
+  CacheSlot* slot = makeRoom(size);
+  if (!slot) {
+    delete[] memory;
+    return nullptr;
+  }
+
+  asset.data = memory;
+  asset.size = size;
+  slot->index = index;
+  slot->memory = memory;
+  slot->asset = asset;
+  slot->lastUse = ++useClock;
+  stats.bytesCached += size;
+  return slot;
+}
+
+/**
+ * @brief read the rest of the file a prefetch job is working on
+ *
+ * @param chunk max bytes to read now (0 = all of it)
+ * @return true once the file is completely read
+ */
+static bool continueJob(uint32_t chunk) {
+  uint32_t want = job.size - job.loaded;
+  if (chunk && want > chunk) want = chunk;
+
+  int32_t got = source->read(entries[job.index].path, job.loaded, job.staging + job.loaded, want);
+  if (got <= 0) {
+    delete[] job.staging;
+    job.index = -1;
+    return false;
+  }
+  job.loaded += got;
+  return job.loaded == job.size;
+}
+
+/**
+ * @brief load a file synchronously
+ */
+static CacheSlot* loadNow(int index) {
+  // already halfway there in the background
+  if (job.index == index) {
+    bool done = continueJob(0);
+    job.index = -1;
+    if (!done) return nullptr;          // staging already freed on error
+    return cacheFile(index, job.staging, job.size);
+  }
+
+  int32_t size = source->fileSize(entries[index].path);
+  if (size <= 0 || size > ASSET_CACHE_BYTES) return nullptr;
+
+  uint8_t* raw = new (std::nothrow) uint8_t[size];
+  if (!raw) return nullptr;
+  if (source->read(entries[index].path, 0, raw, size) != size) {
+    delete[] raw;
+    return nullptr;
+  }
+  return cacheFile(index, raw, size);
+}
+
+/**
+ * @brief get an asset, loading it on a miss
+ *
+ * the pointer stays valid at least until the next assetGet() (this asset is never the one evicted)
+ *
+ * @return nullptr if it cannot be loaded
+ */
+const Asset* assetGet(int index) {
+  if (!source || index < 0 || index >= entryCount) return nullptr;
+
+  CacheSlot* slot = findSlot(index);
+  if (slot) {
+    stats.hits++;
+  } else {
+    stats.misses++;
+    slot = loadNow(index);
+    if (!slot) return nullptr;
+  }
+
+  slot->lastUse = ++useClock;
+  mostRecent = index;
+  return &slot->asset;
+}
+
+bool assetCached(int index) {
+  return findSlot(index) != nullptr;
+}
+
+/**
+ * @brief queue an asset to be loaded in the background by assetsPoll()
+ *
+ * the queue keeps the newest requests, the oldest pending one is dropped when it is full
+ */
+void assetPrefetch(int index) {
+  if (!source || index < 0 || index >= entryCount) return;
+  if (findSlot(index) || job.index == index) return;
+  for (int i = 0; i < queueLength; i++) {
+    if (prefetchQueue[i] == index) return;
+  }
+
+  if (queueLength == ASSET_PREFETCH_QUEUE) {
+    memmove(prefetchQueue, prefetchQueue + 1, (ASSET_PREFETCH_QUEUE - 1) * sizeof(prefetchQueue[0]));
+    queueLength--;
+  }
+  prefetchQueue[queueLength++] = index;
+}
+
+/**
+ * @brief do one slice of background loading
+ */
+void assetsPoll() {
+  if (!source) return;
+
+  // start the next queued file
+  while (job.index < 0 && queueLength) {
+    int16_t index = prefetchQueue[0];
+    memmove(prefetchQueue, prefetchQueue + 1, (queueLength - 1) * sizeof(prefetchQueue[0]));
+    queueLength--;
+    if (findSlot(index)) continue;
+
+    int32_t size = source->fileSize(entries[index].path);
+    if (size <= 0 || size > ASSET_CACHE_BYTES) continue;
+    job.staging = new (std::nothrow) uint8_t[size];
+    if (!job.staging) continue;
+    job.index = index;
+    job.size = size;
+    job.loaded = 0;
+    return;                       // the open (plus fileSize) was this pass's slice
+  }
+
+  if (job.index < 0) return;
+  if (continueJob(ASSET_PREFETCH_CHUNK)) {
+    int index = job.index;
+    job.index = -1;
+    if (cacheFile(index, job.staging, job.size)) stats.prefetched++;
+  }
+}
+
+AssetStats assetStats() {
+  return stats;
+}
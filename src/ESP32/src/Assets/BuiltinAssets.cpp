@@ -0,0 +1,22 @@
+/**
+ * @file BuiltinAssets.cpp
+ * @brief access to the packed asset blob compiled into the firmware
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "Assets/BuiltinAssets.h"
+
+/**
+ * @brief open the built in blob and look up one of its entries
+ *
+ * @param index a PackedAsset
+ * @param info set to the blob (for packColor() on images)
+ * @param entry set to the entry
+ * @return false if the blob or the entry is unreadable
+ */
+bool builtinAsset(int index, PackInfo* info, PackEntry* entry) {
+  return packOpen(packed_assets, sizeof(packed_assets), info) && packEntry(*info, index, entry);
+}
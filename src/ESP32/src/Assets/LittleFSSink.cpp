@@ -0,0 +1,52 @@
+/**
+ * @file LittleFSSink.cpp
+ * @brief implementation of the LittleFS asset sink
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The temporary file only replaces the real one after the last byte is written, so a dropped upload never leaves a
+ * partial file at the real path.
+ *
+ */
+
+#include "Assets/LittleFSSink.h"
+
+/**
+ * @brief open the temporary file for path (parent folders are created as needed)
+ */
+bool LittleFSSink::begin(const char* dst) {
+  if (file) abort();
+  if (strlen(dst) >= sizeof(path)) return false;
+
+  strcpy(path, dst);
+  strcpy(tmpPath, dst);
+  strcat(tmpPath, ".tmp");
+  file = LittleFS.open(tmpPath, "w", true);
+  return (bool)file;
+}
+
+bool LittleFSSink::write(const uint8_t* src, uint32_t len) {
+  if (!file) return false;
+  return file.write(src, len) == len;
+}
+
+/**
+ * @brief close the temporary file and move it over the real one
+ */
+bool LittleFSSink::finish() {
+  if (!file) return false;
+  file.close();
+
+  if (LittleFS.exists(path)) LittleFS.remove(path);
+  if (!LittleFS.rename(tmpPath, path)) {
+    LittleFS.remove(tmpPath);
+    return false;
+  }
+  return true;
+}
+
+void LittleFSSink::abort() {
+  if (file) file.close();
+  LittleFS.remove(tmpPath);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file LittleFSSource.cpp
+ * @brief implementation of the LittleFS asset source
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Loads are read in chunks (prefetching reads a slice per pass of loop()), so the last file stays open between reads
+ * instead of paying for an open + seek on every chunk.
+ *
+ */
+
+#include "Assets/LittleFSSource.h"
+
+/**
+ * @brief mount the partition (never formats, a missing filesystem just means no flash assets)
+ */
+bool LittleFSSource::begin() {
+  return LittleFS.begin(false);
+}
+
+/**
+ * @brief make path the open file, reusing it if it already is
+ */
+bool LittleFSSource::openFile(const char* path) {
+  if (file && strcmp(openPath, path) == 0) return true;
+
+  if (file) file.close();
+  openPath[0] = '\0';
+  if (strlen(path) >= sizeof(openPath)) return false;
+
+  file = LittleFS.open(path, "r");
+  if (!file) return false;
+  strcpy(openPath, path);
+  return true;
+}
+
+int32_t LittleFSSource::fileSize(const char* path) {
+  if (!openFile(path)) return -1;
+  return file.size();
+}
+
+int32_t LittleFSSource::read(const char* path, uint32_t offset, uint8_t* dst, uint32_t len) {
+  if (!openFile(path)) return -1;
+  if (!file.seek(offset)) return -1;
+  return file.read(dst, len);
+}
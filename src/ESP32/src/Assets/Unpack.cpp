@@ -0,0 +1,169 @@
+/**
+ * @file Unpack.cpp
+ * @brief implementation of the packed asset decoder
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Like the animation decoder this trusts nothing: the table is checked against the blob size, and a stream that ends
+ * early or refers back past its own start stops with a short read instead of reading outside the data.
+ *
+ */
+
+#include "Assets/Unpack.h"
+
+static inline uint16_t readU16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t readU32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief check the header and locate the palette
+ *
+ * @return false if this is not a packed blob (or the table does not fit in it)
+ */
+bool packOpen(const uint8_t* blob, uint32_t size, PackInfo* info) {
+  if (size < PACK_HEADER_SIZE || blob[0] != 'P' || blob[1] != 'K' || blob[2] != PACK_VERSION) return false;
+
+  info->blob = blob;
+  info->size = size;
+  info->count = blob[3];
+  info->paletteCount = blob[4] ? blob[4] : 256;
+  info->palette = blob + PACK_HEADER_SIZE;
+  return PACK_HEADER_SIZE + info->paletteCount * 2 + (uint32_t)info->count * PACK_ENTRY_SIZE <= size;
+}
+
+/**
+ * @brief look up entry index
+ *
+ * @return false if there is no such entry or its stream lies outside the blob
+ */
+bool packEntry(const PackInfo& info, int index, PackEntry* entry) {
+  if (index < 0 || index >= info.count) return false;
+  const uint8_t* e = info.palette + info.paletteCount * 2 + index * PACK_ENTRY_SIZE;
+  uint32_t offset = readU32(e + 4);
+  uint32_t size = readU32(e + 8);
+  if (offset > info.size || size > info.size - offset) return false;
+
+  entry->type = e[0];
+  entry->width = e[1];
+  entry->height = e[2];
+  entry->data = info.blob + offset;
+  entry->size = size;
+  return true;
+}
+
+/**
+ * @brief RGB565 value of a palette index (black if out of range)
+ */
+uint16_t packColor(const PackInfo& info, uint8_t index) {
+  if (index >= info.paletteCount) return 0;
+  return readU16(info.palette + index * 2);
+}
+
+/**
+ * @brief start decoding a stream from its first byte
+ *
+ * @param data stream of a PackEntry
+ * @param size its size
+ */
+void unpackBegin(UnpackStream* s, const uint8_t* data, uint32_t size) {
+  s->src = data;
+  s->pos = 0;
+  s->size = size;
+  s->items = 0;
+  s->matchLeft = 0;
+  s->head = 0;
+  s->produced = 0;
+  s->failed = false;
+}
+
+/**
+ * @brief decode the next n bytes
+ *
+ * A match may be split across calls, it carries on from where the last call stopped.
+ *
+ * @return bytes written to dst, less than n at the end of the stream (or if it is corrupt)
+ */
+uint32_t unpackRead(UnpackStream* s, uint8_t* dst, uint32_t n) {
+  uint32_t done = 0;
+  while (done < n && !s->failed) {
+    uint8_t b;
+    if (s->matchLeft) {
+      b = s->window[(s->head - s->matchDistance) & (UNPACK_WINDOW - 1)];
+      s->matchLeft--;
+    }
+    else {
+      if (s->items == 0) {
+        if (s->pos >= s->size) break;   // clean end
+        s->flags = s->src[s->pos++];
+        s->items = 8;
+      }
+      s->items--;
+      bool literal = s->flags & 1;
+      s->flags >>= 1;
+
+      if (literal) {
+        if (s->pos >= s->size) break;
+        b = s->src[s->pos++];
+      }
+      else {
+        if (s->size - s->pos < 2) {
+          // the last group is usually short, running out of data here is its end
+          if (s->pos < s->size) s->failed = true;
+          break;
+        }
+        uint16_t code = readU16(s->src + s->pos);
+        s->pos += 2;
+        s->matchDistance = (code & (UNPACK_WINDOW - 1)) + 1;
+        s->matchLeft = (code >> 9) + 3;
+        if (s->matchDistance > s->produced) {
+          s->failed = true;
+          break;
+        }
+        continue;
+      }
+    }
+
+    s->window[s->head] = b;
+    s->head = (s->head + 1) & (UNPACK_WINDOW - 1);
+    s->produced++;
+    dst[done++] = b;
+  }
+  return done;
+}
+
+/**
+ * @brief decode a PACK_PALETTE entry
+ *
+ * @param colors set to the RGB565 values, in order
+ * @param names set to the names, which are copied into text
+ * @param maxColors room in colors / names
+ * @param text buffer the NUL terminated names are copied into
+ * @param textSize its size
+ * @return colors decoded, 0 if this is not a palette or it does not fit (or is corrupt)
+ */
+int unpackPalette(const PackEntry& entry, uint16_t* colors, const char** names, int maxColors, char* text, int textSize) {
+  if (entry.type != PACK_PALETTE || entry.width > maxColors) return 0;
+
+  UnpackStream s;
+  unpackBegin(&s, entry.data, entry.size);
+  int used = 0;
+  for (int i = 0; i < entry.width; i++) {
+    uint8_t color[2];
+    if (unpackRead(&s, color, 2) != 2) return 0;
+    colors[i] = readU16(color);
+    names[i] = text + used;
+    do {
+      if (used == textSize || unpackRead(&s, (uint8_t*)text + used, 1) != 1) return 0;
+    } while (text[used++]);
+  }
+
+  // nothing may follow the last name
+  uint8_t extra;
+  if (unpackRead(&s, &extra, 1) || s.failed) return 0;
+  return entry.width;
+}
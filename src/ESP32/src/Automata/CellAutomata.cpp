@@ -0,0 +1,231 @@
+/**
+ * @file CellAutomata.cpp
+ * @brief implementation of the bit-packed cellular automata
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Stepping works on 64 cells at a time. For a row, the 8 neighbour bitboards are the rows above/below/itself rotated
+ * one column left and right (the grid wraps around like a torus). Adding 8 one-bit numbers per column with full adders
+ * gives the neighbour count as 4 bit planes, and the rule is then just AND/OR on those planes.
+ *
+ * The step is done in place, one row at a time: the only extra memory is the original (pre-step) live cells of the row
+ * above and of row 0, which the next row and the last row still need, and the unpacked row below.
+ *
+ */
+
+#include "Automata/CellAutomata.h"
+#include <string.h>
+
+const AutomataRule AUTOMATA_LIFE = { "Life", 1 << 3, (1 << 2) | (1 << 3), 2 };
+const AutomataRule AUTOMATA_BRIANS_BRAIN = { "Brain", 1 << 2, 0, 3 };
+
+static inline uint64_t rotl1(uint64_t v) { return (v << 1) | (v >> 63); }
+static inline uint64_t rotr1(uint64_t v) { return (v >> 1) | (v << 63); }
+
+/**
+ * @brief mask of the columns whose neighbour count is in the set
+ *
+ * @param set bit n = count n is in the set
+ * @param c0..c3 neighbour count bit planes
+ */
+static uint64_t countIn(uint16_t set, uint64_t c0, uint64_t c1, uint64_t c2, uint64_t c3) {
+  uint64_t mask = 0;
+  for (int n = 0; n <= 8; n++) {
+    if (!(set & (1 << n))) continue;
+    mask |= ((n & 1) ? c0 : ~c0) & ((n & 2) ? c1 : ~c1) & ((n & 4) ? c2 : ~c2) & ((n & 8) ? c3 : ~c3);
+  }
+  return mask;
+}
+
+// 3 base 3 digits (0..26) as live cells in bits 0-2 and dying cells in bits 4-6. a byte is two lookups, v % 27 for
+// cells 0-2 and v / 27 for cells 3-4
+static const uint8_t TRIT_CELLS[27] = {
+  0x00, 0x01, 0x10, 0x02, 0x03, 0x12, 0x20, 0x21, 0x30, 0x04, 0x05, 0x14, 0x06, 0x07,
+  0x16, 0x24, 0x25, 0x34, 0x40, 0x41, 0x50, 0x42, 0x43, 0x52, 0x60, 0x61, 0x70
+};
+
+// 5 cells (bit k = cell k) as base 3 digits of 1, the other way round
+static const uint8_t CELL_TRITS[32] = {
+  0, 1, 3, 4, 9, 10, 12, 13, 27, 28, 30, 31, 36, 37, 39, 40,
+  81, 82, 84, 85, 90, 91, 93, 94, 108, 109, 111, 112, 117, 118, 120, 121
+};
+
+/**
+ * @brief unpack a row into its live (state 1) and dying (state 2) cells
+ */
+static void loadRow(const AutomataGrid* grid, int y, uint64_t* live, uint64_t* dying) {
+  uint64_t a = 0, b = 0;
+  for (int i = 0; i < AUTOMATA_ROW_BYTES; i++) {
+    unsigned v = grid->rows[y][i];
+    unsigned lo = TRIT_CELLS[v % 27], hi = TRIT_CELLS[v / 27];
+    a |= (uint64_t)((lo & 0x07) | (hi & 0x03) << 3) << (5 * i);
+    b |= (uint64_t)((lo >> 4) | (hi >> 4) << 3) << (5 * i);
+  }
+  *live = a;
+  *dying = b;
+}
+
+/**
+ * @brief pack a row back, a cell must not be in both masks
+ */
+static void storeRow(AutomataGrid* grid, int y, uint64_t live, uint64_t dying) {
+  for (int i = 0; i < AUTOMATA_ROW_BYTES; i++) {
+    grid->rows[y][i] = CELL_TRITS[(live >> (5 * i)) & 31] + 2 * CELL_TRITS[(dying >> (5 * i)) & 31];
+  }
+}
+
+/**
+ * @brief clear every cell
+ */
+void automataClear(AutomataGrid* grid) {
+  memset(grid->rows, 0, sizeof(grid->rows));
+}
+
+/**
+ * @brief xorshift32, the same seed always gives the same soup
+ */
+static uint32_t nextRandom(uint32_t* state) {
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+static uint64_t randomRow(uint32_t* rng) {
+  return ((uint64_t)nextRandom(rng) << 32) | nextRandom(rng);
+}
+
+/**
+ * @brief fill the grid with a random soup of live cells (about 3/8 density)
+ *
+ * @param rng xorshift state, must not be 0
+ */
+void automataSeed(AutomataGrid* grid, uint32_t* rng) {
+  for (int y = 0; y < AUTOMATA_SIZE; y++) {
+    uint64_t a = randomRow(rng);
+    uint64_t b = randomRow(rng);
+    uint64_t c = randomRow(rng);
+    storeRow(grid, y, a & (b | c), 0);
+  }
+}
+
+/**
+ * @brief state of one cell (0 = dead, 1 = live, 2 = dying)
+ */
+uint8_t automataCell(const AutomataGrid* grid, uint8_t x, uint8_t y) {
+  unsigned v = grid->rows[y][x / 5];
+  for (int k = x % 5; k > 0; k--) v /= 3;
+  return v % 3;
+}
+
+/**
+ * @brief set one cell (0 = dead, 1 = live, 2 = dying)
+ */
+void automataSetCell(AutomataGrid* grid, uint8_t x, uint8_t y, uint8_t state) {
+  uint64_t a, b;
+  loadRow(grid, y, &a, &b);
+  uint64_t bit = (uint64_t)1 << x;
+  a = (state == 1) ? a | bit : a & ~bit;
+  b = (state == 2) ? b | bit : b & ~bit;
+  storeRow(grid, y, a, b);
+}
+
+/**
+ * @brief cells of a row that are not dead
+ */
+uint64_t automataRow(const AutomataGrid* grid, uint8_t y) {
+  uint64_t a, b;
+  loadRow(grid, y, &a, &b);
+  return a | b;
+}
+
+/**
+ * @brief advance the grid one generation
+ *
+ * @param grid grid to step in place
+ * @param rule rule to apply (2 or 3 states)
+ * @param onRow optional, called for every row with at least one changed cell
+ * @param ctx passed through to onRow
+ * @return number of cells that changed state
+ */
+uint32_t automataStep(AutomataGrid* grid, const AutomataRule& rule, AutomataRowCallback onRow, void* ctx) {
+  // pre-step live cells of the row above and of row 0 (for the wrap at the bottom)
+  uint64_t a, b, nextA, nextB;
+  loadRow(grid, AUTOMATA_SIZE - 1, &nextA, &nextB);
+  uint64_t above = nextA;
+  loadRow(grid, 0, &a, &b);
+  uint64_t first = a;
+  uint32_t changedCells = 0;
+
+  for (int y = 0; y < AUTOMATA_SIZE; y++) {
+    uint64_t mid = a;
+    uint64_t below = first;
+    if (y < AUTOMATA_SIZE - 1) {
+      loadRow(grid, y + 1, &nextA, &nextB);
+      below = nextA;
+    }
+
+    // three neighbours above and three below: full adders -> (sum, carry)
+    uint64_t ul = rotl1(above), ur = rotr1(above);
+    uint64_t sumUp = ul ^ above ^ ur;
+    uint64_t carryUp = (ul & above) | (ur & (ul ^ above));
+
+    uint64_t dl = rotl1(below), dr = rotr1(below);
+    uint64_t sumDown = dl ^ below ^ dr;
+    uint64_t carryDown = (dl & below) | (dr & (dl ^ below));
+
+    // two neighbours on the row itself: half adder
+    uint64_t l = rotl1(mid), r = rotr1(mid);
+    uint64_t sumMid = l ^ r;
+    uint64_t carryMid = l & r;
+
+    // ones: add the three sums
+    uint64_t c0 = sumUp ^ sumMid ^ sumDown;
+    uint64_t k1 = (sumUp & sumMid) | (sumDown & (sumUp ^ sumMid));
+
+    // twos: three carries plus k1
+    uint64_t t = carryUp ^ carryMid ^ carryDown;
+    uint64_t k4 = (carryUp & carryMid) | (carryDown & (carryUp ^ carryMid));
+    uint64_t c1 = t ^ k1;
+    uint64_t k2 = t & k1;
+
+    // fours and eights
+    uint64_t c2 = k4 ^ k2;
+    uint64_t c3 = k4 & k2;
+
+    uint64_t dead = ~a & ~b;
+    uint64_t born = dead & countIn(rule.birth, c0, c1, c2, c3);
+    uint64_t survive = mid & countIn(rule.survive, c0, c1, c2, c3);
+
+    // dying cells are dead next generation
+    uint64_t newA = born | survive;
+    uint64_t newB = (rule.states > 2) ? mid & ~survive : 0;
+
+    storeRow(grid, y, newA, newB);
+    above = mid;
+
+    uint64_t changed = (a ^ newA) | (b ^ newB);
+    if (changed) {
+      changedCells += __builtin_popcountll(changed);
+      if (onRow) onRow(y, changed, grid, ctx);
+    }
+    a = nextA;
+    b = nextB;
+  }
+
+  return changedCells;
+}
+
+/**
+ * @brief number of cells that are not dead
+ */
+uint32_t automataPopulation(const AutomataGrid* grid) {
+  uint32_t count = 0;
+  for (int y = 0; y < AUTOMATA_SIZE; y++) {
+    count += __builtin_popcountll(automataRow(grid, y));
+  }
+  return count;
+}
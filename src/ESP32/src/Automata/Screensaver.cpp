@@ -0,0 +1,113 @@
+/**
+ * @file Screensaver.cpp
+ * @brief implementation of the cellular automata screensaver
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The grid steps at a fixed rate and only the cells that changed are drawn (the step reports a changed mask per row).
+ * A run ends when the pattern dies out, settles into still lifes / blinkers, or hits the generation cap; the next run
+ * uses the next rule with a fresh soup.
+ *
+ * State is the 832 byte grid (3 states per cell, packed) plus a few counters and the palette, under 1 KB, all static.
+ *
+ */
+
+#include "Automata/Screensaver.h"
+#include "Automata/CellAutomata.h"
+#include <Arduino.h>
+
+static const unsigned long STEP_MS = 50;
+static const uint16_t MAX_GENERATIONS = 1500;
+
+// a run counts as settled once the changed cell count repeats with period 1 or 2 for this many generations
+static const uint8_t STALE_GENERATIONS = 60;
+
+static const AutomataRule* const RULES[] = { &AUTOMATA_LIFE, &AUTOMATA_BRIANS_BRAIN };
+static const int NUM_RULES = sizeof(RULES) / sizeof(RULES[0]);
+
+static VirtualCanvas* display;
+static AutomataGrid grid;
+static uint32_t rng = 0x2545F491;
+static int ruleIndex = 0;
+static int originX, originY;
+static uint16_t palette[NUM_RULES][3];
+
+static unsigned long lastStep = 0;
+static uint16_t generation = 0;
+static uint32_t changedHistory[2];
+static uint8_t staleCount = 0;
+
+/**
+ * @brief draw the new state of every changed cell in a row
+ */
+static void drawChangedRow(uint8_t row, uint64_t changed, const AutomataGrid* g, void* ctx) {
+  const uint16_t* colors = (const uint16_t*)ctx;
+  while (changed) {
+    uint8_t x = __builtin_ctzll(changed);
+    changed &= changed - 1;
+    display->drawPixel(originX + x, originY + row, colors[automataCell(g, x, row)]);
+  }
+}
+
+/**
+ * @brief new soup for the current rule, drawn from scratch
+ */
+static void startRun() {
+  automataSeed(&grid, &rng);
+  generation = 0;
+  staleCount = 0;
+  changedHistory[0] = changedHistory[1] = 0;
+
+  display->fillScreen(0);
+  for (int y = 0; y < AUTOMATA_SIZE; y++) {
+    uint64_t cells = automataRow(&grid, y);
+    if (cells) drawChangedRow(y, cells, &grid, palette[ruleIndex]);
+  }
+}
+
+/**
+ * @brief Function that starts the screensaver
+ *
+ * @param disp canvas to draw on (the grid is centered on larger canvases)
+ * @param now millis()
+ */
+void initScreensaver(VirtualCanvas* disp, unsigned long now) {
+  display = disp;
+  originX = (display->width() - AUTOMATA_SIZE) / 2;
+  originY = (display->height() - AUTOMATA_SIZE) / 2;
+
+  // life: green
+  palette[0][1] = display->color565(0, 220, 60);
+  // brian's brain: white firing, blue refractory
+  palette[1][1] = display->color565(200, 220, 255);
+  palette[1][2] = display->color565(0, 40, 160);
+  for (int r = 0; r < NUM_RULES; r++) palette[r][0] = 0;
+
+  rng ^= now | 1;
+  lastStep = now;
+  startRun();
+}
+
+/**
+ * @brief step the automaton when due and move on to the next rule once the run is over
+ *
+ * @param now millis()
+ */
+void updateScreensaver(unsigned long now) {
+  if (now - lastStep < STEP_MS) return;
+  lastStep = now;
+
+  uint32_t changed = automataStep(&grid, *RULES[ruleIndex], drawChangedRow, palette[ruleIndex]);
+  generation++;
+
+  staleCount = (changed == changedHistory[0] || changed == changedHistory[1]) ? staleCount + 1 : 0;
+  changedHistory[1] = changedHistory[0];
+  changedHistory[0] = changed;
+
+  if (changed == 0 || staleCount >= STALE_GENERATIONS || generation >= MAX_GENERATIONS) {
+    ruleIndex = (ruleIndex + 1) % NUM_RULES;
+    startRun();
+  }
+}
+
@@ -0,0 +1,132 @@
+/**
+ * @file BootSequence.cpp
+ * @brief implementation of the staged start up
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The order is worked out the same way by bootPlan() (ahead of time, for checking a table) and bootStep() (while
+ * booting): lowest table index first among the stages whose dependencies are done. A stage that can never run (it
+ * depends on itself, a cycle, or a stage past the end of the table) is left out, and bootBegin() reports the table as
+ * broken instead of the boot silently hanging on it.
+ *
+ */
+
+#include "Boot/BootSequence.h"
+#include <stdio.h>
+
+static uint16_t allStages(uint8_t count) {
+  return (uint16_t)((1UL << count) - 1);
+}
+
+/**
+ * @brief first stage (table order) not run yet whose dependencies are all in done
+ *
+ * @return -1 if there is none
+ */
+static int nextStage(const BootStage* stages, uint8_t count, uint16_t done) {
+  for (int i = 0; i < count; i++) {
+    if (done & BOOT_STAGE(i)) continue;
+    if ((stages[i].needs & done) == stages[i].needs) return i;
+  }
+  return -1;
+}
+
+/**
+ * @brief the order the stages of a table would run in, without running them
+ *
+ * @param order count entries, filled with stage indices
+ * @return number of stages that run, less than count if some can never run
+ */
+int bootPlan(const BootStage* stages, uint8_t count, uint8_t* order) {
+  if (count > BOOT_MAX_STAGES) return 0;
+  uint16_t done = 0;
+  int n = 0;
+  int i;
+  while ((i = nextStage(stages, count, done)) >= 0) {
+    done |= BOOT_STAGE(i);
+    order[n++] = i;
+  }
+  return n;
+}
+
+/**
+ * @brief start a boot, nothing is run yet
+ *
+ * @param stages table, stays in use for the whole boot
+ * @param clock microsecond clock for the markers
+ * @return false if some stage could never run (bootFinished() would never become true)
+ */
+bool bootBegin(BootSequence* b, const BootStage* stages, uint8_t count, BootClock clock) {
+  if (count > BOOT_MAX_STAGES) count = BOOT_MAX_STAGES;
+  b->stages = stages;
+  b->count = count;
+  b->done = 0;
+  b->failed = 0;
+  b->clock = clock;
+
+  uint8_t order[BOOT_MAX_STAGES];
+  return bootPlan(stages, count, order) == count;
+}
+
+/**
+ * @brief stage the next bootStep() runs, -1 if none (finished, or stuck on a broken table)
+ */
+int bootNext(const BootSequence* b) {
+  return nextStage(b->stages, b->count, b->done);
+}
+
+/**
+ * @brief run the next stage and record its timing
+ *
+ * @return the stage that ran, -1 if there was none
+ */
+int bootStep(BootSequence* b) {
+  int i = bootNext(b);
+  if (i < 0) return -1;
+
+  uint32_t start = b->clock();
+  bool ok = b->stages[i].run();
+  uint32_t end = b->clock();
+
+  b->finishedUs[i] = end;
+  b->tookUs[i] = end - start;
+  b->done |= BOOT_STAGE(i);
+  if (!ok) b->failed |= BOOT_STAGE(i);
+  return i;
+}
+
+/**
+ * @brief have all of these stages run (whether they failed or not)
+ *
+ * @param stages BOOT_STAGE() bits
+ */
+bool bootReady(const BootSequence* b, uint16_t stages) {
+  return (b->done & stages) == stages;
+}
+
+bool bootFinished(const BootSequence* b) {
+  return b->done == allStages(b->count);
+}
+
+int bootDoneCount(const BootSequence* b) {
+  int n = 0;
+  for (uint16_t d = b->done; d; d &= d - 1) n++;
+  return n;
+}
+
+/**
+ * @brief marker line of a stage that has run, e.g. "boot assets 412.5 ms (38.0 ms)", " failed" appended if it did
+ *
+ * times are in ms with one decimal, when it finished on the boot clock (micros() is time since reset) and how long it
+ * took
+ *
+ * @param dst BOOT_MARKER_LEN bytes is enough
+ */
+void bootMarker(const BootSequence* b, int stage, char* dst, int len) {
+  uint32_t at = b->finishedUs[stage] / 100;
+  uint32_t took = b->tookUs[stage] / 100;
+  snprintf(dst, len, "boot %s %lu.%lu ms (%lu.%lu ms)%s", b->stages[stage].name,
+           (unsigned long)(at / 10), (unsigned long)(at % 10), (unsigned long)(took / 10), (unsigned long)(took % 10),
+           (b->failed & BOOT_STAGE(stage)) ? " failed" : "");
+}
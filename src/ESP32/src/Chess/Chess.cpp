@@ -0,0 +1,372 @@
+/**
+ * @file Chess.cpp
+ * @brief implementation of the Chess program
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Controls (defaults of the "chess" input profile, see Input/InputMap.h):
+ * - joystick 1, or RPG1 (file) / RPG2 (rank): move the cursor
+ * - controller 1A or home click: pick up a piece / drop it on the cursor
+ * - controller 1B: put the piece back down
+ * - controller 1A+1B together: start a new game
+ * - hold home: exit to home as usual
+ *
+ * The Arduino loop() runs on core 1, so the engine gets its own FreeRTOS task pinned to core 0. The UI hands it a copy
+ * of the position with a task notification and the task answers every request with one move on a queue. The copy is
+ * only written while no request is outstanding (searchBusy), and the answer to a search that was abandoned (user left
+ * the program) is taken off the queue and dropped instead of being applied to a new game.
+ *
+ * The search sleeps for a tick every CHESS_CHECK_NODES nodes, so the rest of core 0 (IDLE0 and its task watchdog,
+ * Wi-Fi, the HTTP task) keeps running while it thinks.
+ *
+ */
+
+#include "Chess/Chess.h"
+#include "Chess/ChessEngine.h"
+#include "Input/InputMap.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+
+// engine budget per move
+static const uint8_t AI_MAX_DEPTH = 6;
+static const uint32_t AI_TIME_MS = 1500;
+
+// streamed joystick commands move the cursor at most this often
+static const uint16_t CURSOR_REPEAT_MS = 150;
+
+// actions of the "chess" input profile
+enum ChessAction : uint8_t { CHESS_NONE, CHESS_UP, CHESS_DOWN, CHESS_LEFT, CHESS_RIGHT, CHESS_SELECT, CHESS_CANCEL, CHESS_NEW_GAME };
+static const char* const CHESS_ACTION_NAMES[] = { "none", "up", "down", "left", "right", "select", "cancel", "newGame" };
+
+static const InputBinding CHESS_DEFAULTS[] = {
+  { IN_JOY1_UP,    IN_NONE, CHESS_UP,       CURSOR_REPEAT_MS },
+  { IN_JOY1_DOWN,  IN_NONE, CHESS_DOWN,     CURSOR_REPEAT_MS },
+  { IN_JOY1_LEFT,  IN_NONE, CHESS_LEFT,     CURSOR_REPEAT_MS },
+  { IN_JOY1_RIGHT, IN_NONE, CHESS_RIGHT,    CURSOR_REPEAT_MS },
+  { IN_RPG1_CW,    IN_NONE, CHESS_RIGHT,    0 },
+  { IN_RPG1_CCW,   IN_NONE, CHESS_LEFT,     0 },
+  { IN_RPG2_CW,    IN_NONE, CHESS_UP,       0 },
+  { IN_RPG2_CCW,   IN_NONE, CHESS_DOWN,     0 },
+  { IN_C1A,        IN_NONE, CHESS_SELECT,   0 },
+  { IN_HOME_CLICK, IN_NONE, CHESS_SELECT,   0 },
+  { IN_C1B,        IN_NONE, CHESS_CANCEL,   0 },
+  { IN_C1A,        IN_C1B,  CHESS_NEW_GAME, 0 },
+};
+
+static const int SQUARE = 8;
+
+// 8x8 piece glyphs, one byte per row, msb is the left pixel
+static const uint8_t GLYPHS[7][8] = {
+  { 0 },
+  { 0x00, 0x00, 0x18, 0x3C, 0x18, 0x3C, 0x7E, 0x00 },   // pawn
+  { 0x00, 0x18, 0x3C, 0x6C, 0x0C, 0x1C, 0x7E, 0x00 },   // knight
+  { 0x00, 0x18, 0x2C, 0x3C, 0x18, 0x3C, 0x7E, 0x00 },   // bishop
+  { 0x00, 0x5A, 0x7E, 0x3C, 0x3C, 0x3C, 0x7E, 0x00 },   // rook
+  { 0x00, 0x99, 0x5A, 0x7E, 0x3C, 0x3C, 0x7E, 0x00 },   // queen
+  { 0x18, 0x3C, 0x18, 0x7E, 0x3C, 0x3C, 0x7E, 0x00 }    // king
+};
+
+static VirtualCanvas* display;
+static int originX, originY;
+static uint16_t lightColor, darkColor, whitePiece, blackPiece, cursorColor, selectColor, moveColor;
+
+// game state (owned by the UI)
+static ChessPosition game;
+static ChessStatus status = CHESS_ONGOING;
+static int cursorFile = 4, cursorRank = 1;
+static int selectedSq = -1;
+static int lastFrom = -1, lastTo = -1;
+
+static InputProfile chessProfile;
+static bool chessProfileReady = false;
+static InputMapper chessInput;
+
+// engine task state (see file header)
+static ChessPosition searchPos;
+static TaskHandle_t searchTask = nullptr;
+static QueueHandle_t searchResults = nullptr;   // one move per request
+static bool searchBusy = false;                 // a request is out and its move not taken yet
+static bool awaitingAI = false;                 // ... and it is for the game on the board
+
+static uint32_t clockMs() {
+  return millis();
+}
+
+/**
+ * @brief let the lower priority tasks of core 0 run for a tick
+ */
+static void yieldSearch() {
+  vTaskDelay(1);
+}
+
+/**
+ * @brief engine task: waits for a request, searches searchPos, queues the move
+ */
+static void searchTaskLoop(void* param) {
+  (void)param;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    ChessSearchLimits limits = { AI_MAX_DEPTH, AI_TIME_MS, clockMs, yieldSearch };
+    ChessSearchInfo info;
+    ChessMove move = chessSearch(&searchPos, limits, &info);
+
+    xQueueSend(searchResults, &move, portMAX_DELAY);
+  }
+}
+
+/**
+ * @brief hand the current position to the engine task
+ */
+static void requestAIMove() {
+  // a previous (abandoned) search may still be unwinding, wait for its move and drop it
+  if (searchBusy) {
+    ChessMove stale;
+    chessStopSearch();
+    xQueueReceive(searchResults, &stale, portMAX_DELAY);
+    searchBusy = false;
+  }
+
+  searchPos = game;
+  searchBusy = true;
+  awaitingAI = true;
+  xTaskNotifyGive(searchTask);
+}
+
+/**
+ * @brief top left pixel of a square (white at the bottom)
+ */
+static void squareOrigin(int file, int rank, int* x, int* y) {
+  *x = originX + file * SQUARE;
+  *y = originY + (7 - rank) * SQUARE;
+}
+
+/**
+ * @brief draw one square: background, piece glyph, then any outline on top
+ */
+static void drawSquare(int file, int rank) {
+  int x, y;
+  squareOrigin(file, rank, &x, &y);
+
+  uint8_t sq = CHESS_SQ(file, rank);
+  display->fillRect(x, y, SQUARE, SQUARE, ((file + rank) & 1) ? lightColor : darkColor);
+
+  int8_t piece = game.board[sq];
+  if (piece) {
+    const uint8_t* glyph = GLYPHS[piece > 0 ? piece : -piece];
+    uint16_t color = (piece > 0) ? whitePiece : blackPiece;
+    for (int row = 0; row < SQUARE; row++) {
+      for (int col = 0; col < SQUARE; col++) {
+        if (glyph[row] & (0x80 >> col)) display->drawPixel(x + col, y + row, color);
+      }
+    }
+  }
+
+  if (sq == selectedSq) {
+    display->drawRect(x, y, SQUARE, SQUARE, selectColor);
+  } else if (file == cursorFile && rank == cursorRank) {
+    display->drawRect(x, y, SQUARE, SQUARE, cursorColor);
+  } else if (sq == lastFrom || sq == lastTo) {
+    display->drawRect(x, y, SQUARE, SQUARE, moveColor);
+  }
+}
+
+/**
+ * @brief draw the whole board (the canvas only pushes the squares that actually changed)
+ */
+static void drawBoard() {
+  for (int rank = 0; rank < 8; rank++) {
+    for (int file = 0; file < 8; file++) {
+      drawSquare(file, rank);
+    }
+  }
+
+  if (status != CHESS_ONGOING) {
+    const char* msg = (status == CHESS_CHECKMATE) ? "MATE" : (status == CHESS_STALEMATE) ? "STALE" : "DRAW";
+    int w = strlen(msg) * 6;
+    int x = originX + (8 * SQUARE - w) / 2;
+    int y = originY + 8 * SQUARE / 2 - 4;
+    display->fillRect(x - 2, y - 2, w + 3, 11, 0);
+    display->setTextSize(1);
+    display->setTextWrap(false);
+    display->setTextColor(cursorColor);
+    display->setCursor(x, y);
+    display->print(msg);
+  }
+}
+
+/**
+ * @brief play a move on the game board and update highlights / result
+ */
+static void applyMove(const ChessMove& m) {
+  chessMakeMove(&game, m);
+  lastFrom = m.from;
+  lastTo = m.to;
+  status = chessGetStatus(&game);
+}
+
+/**
+ * @brief player tries to move the selected piece to the cursor square
+ *
+ * the move has to be in the legal move list. Pawns reaching the last rank become queens.
+ */
+static void tryPlayerMove() {
+  ChessMove moves[256];
+  int n = chessGenerateLegal(&game, moves);
+  uint8_t to = CHESS_SQ(cursorFile, cursorRank);
+
+  for (int i = 0; i < n; i++) {
+    if (moves[i].from == selectedSq && moves[i].to == to && (moves[i].promo == 0 || moves[i].promo == CHESS_QUEEN)) {
+      selectedSq = -1;
+      applyMove(moves[i]);
+      if (status == CHESS_ONGOING) requestAIMove();
+      return;
+    }
+  }
+
+  // not legal: pick up a different own piece instead, otherwise keep the selection
+  int8_t piece = game.board[to];
+  if (piece > 0) selectedSq = to;
+}
+
+/**
+ * @brief start a new game (player is white)
+ */
+static void newGame() {
+  chessInitPosition(&game);
+  status = CHESS_ONGOING;
+  cursorFile = 4;
+  cursorRank = 1;
+  selectedSq = -1;
+  lastFrom = lastTo = -1;
+  awaitingAI = false;
+}
+
+/**
+ * @brief Function that initializes Chess
+ *
+ * starts the engine task on core 0 the first time
+ *
+ * @param disp canvas to draw on
+ */
+void initChess(VirtualCanvas* disp) {
+  display = disp;
+  originX = (display->width() - 8 * SQUARE) / 2;
+  originY = (display->height() - 8 * SQUARE) / 2;
+
+  lightColor  = display->color565(170, 130, 80);
+  darkColor   = display->color565(80, 45, 15);
+  whitePiece  = display->color565(255, 255, 230);
+  blackPiece  = display->color565(0, 0, 0);
+  cursorColor = display->color565(255, 255, 0);
+  selectColor = display->color565(0, 255, 0);
+  moveColor   = display->color565(0, 90, 255);
+
+  if (!searchTask) {
+    searchResults = xQueueCreate(1, sizeof(ChessMove));
+    xTaskCreatePinnedToCore(searchTaskLoop, "chess", 6144, nullptr, 1, &searchTask, 0);
+  }
+
+  inputMapperInit(&chessInput, chessInputProfile());
+
+  display->fillScreen(0);
+  newGame();
+  drawBoard();
+}
+
+/**
+ * @brief move the cursor, clamped to the board
+ */
+static void moveCursor(int df, int dr) {
+  cursorFile = constrain(cursorFile + df, 0, 7);
+  cursorRank = constrain(cursorRank + dr, 0, 7);
+}
+
+/**
+ * @brief the "chess" input profile (defaults filled in on first use, /input.cfg may change it at boot)
+ */
+InputProfile* chessInputProfile() {
+  if (!chessProfileReady) {
+    inputProfileInit(&chessProfile, "chess", CHESS_ACTION_NAMES, sizeof(CHESS_ACTION_NAMES) / sizeof(CHESS_ACTION_NAMES[0]),
+                     CHESS_DEFAULTS, sizeof(CHESS_DEFAULTS) / sizeof(CHESS_DEFAULTS[0]));
+    chessProfileReady = true;
+  }
+  return &chessProfile;
+}
+
+/**
+ * @brief perform one action of the "chess" profile
+ */
+static void doChessAction(uint8_t action) {
+  switch (action) {
+    case CHESS_UP:       moveCursor(0, 1);  break;
+    case CHESS_DOWN:     moveCursor(0, -1); break;
+    case CHESS_LEFT:     moveCursor(-1, 0); break;
+    case CHESS_RIGHT:    moveCursor(1, 0);  break;
+    case CHESS_CANCEL:   selectedSq = -1;   break;
+    case CHESS_NEW_GAME:
+      if (awaitingAI) return;             // the engine still owns the position
+      newGame();
+      break;
+    case CHESS_SELECT:
+      if (status != CHESS_ONGOING) {
+        newGame();
+      }
+      else if (!awaitingAI) {
+        uint8_t sq = CHESS_SQ(cursorFile, cursorRank);
+        if (selectedSq < 0) {
+          if (game.board[sq] > 0) selectedSq = sq;
+        } else {
+          tryPlayerMove();
+        }
+      }
+      break;
+    default:
+      return;
+  }
+
+  drawBoard();
+}
+
+/**
+ * @brief Function that handles commands relating to Chess
+ *
+ * @param cmd command from the Arduino received over UART
+ * @param now millis() when the command arrived
+ */
+void handleChessCommand(const String& cmd, unsigned long now) {
+  uint8_t actions[2];
+  int n = inputEvent(&chessInput, inputCode(cmd.c_str()), now, actions);
+  for (int i = 0; i < n; i++) doChessAction(actions[i]);
+}
+
+/**
+ * @brief pick up the engine's move once the search task has finished
+ *
+ * @param now millis()
+ */
+void updateChess(unsigned long now) {
+  // a button held back for a chord that never came
+  uint8_t actions[2];
+  int n = inputPoll(&chessInput, now, actions);
+  for (int i = 0; i < n; i++) doChessAction(actions[i]);
+
+  ChessMove move;
+  if (!searchBusy || xQueueReceive(searchResults, &move, 0) != pdTRUE) return;
+  searchBusy = false;
+  if (!awaitingAI) return;                // abandoned
+
+  awaitingAI = false;
+  if (move.from != move.to) applyMove(move);
+  drawBoard();
+}
+
+/**
+ * @brief abandon any running search when leaving the program
+ */
+void exitChess() {
+  awaitingAI = false;
+  if (searchBusy) chessStopSearch();
+}
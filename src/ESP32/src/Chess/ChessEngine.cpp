@@ -0,0 +1,814 @@
+/**
+ * @file ChessEngine.cpp
+ * @brief 0x88 move generation, make/undo, evaluation and iterative deepening alpha-beta
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Board: 0x88 layout (128 squares, only the left 8 columns of every 16 are real). A square is off the board exactly
+ * when (sq & 0x88) != 0, which makes ray walking and knight jumps one AND per step instead of bounds checks.
+ *
+ * Memory is fixed:
+ * - moves for every ply of the search live in one shared stack (CHESS_MOVE_STACK), each ply takes a slice on entry
+ * - the transposition table is a static array of CHESS_TT_ENTRIES 12 byte entries (24 KB)
+ * - zobrist keys are computed from a hash of (piece, square) instead of a 6 KB random table
+ *
+ * The search is negamax alpha-beta with iterative deepening, a transposition table, MVV-LVA + killer move ordering,
+ * a check extension and a captures-only quiescence search.
+ *
+ */
+
+#include "Chess/ChessEngine.h"
+#include <string.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ------------------------------------------ Tables / Keys ------------------------------------------ //
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+static const int8_t KNIGHT_DIRS[8] = { 33, 31, 18, 14, -33, -31, -18, -14 };
+static const int8_t KING_DIRS[8]   = { 1, -1, 16, -16, 15, 17, -15, -17 };
+static const int8_t BISHOP_DIRS[4] = { 15, 17, -15, -17 };
+static const int8_t ROOK_DIRS[4]   = { 1, -1, 16, -16 };
+
+static const int16_t PIECE_VALUE[7] = { 0, 100, 320, 330, 500, 900, 0 };
+
+// piece square tables from white's point of view, rank 8 first (as the board is drawn)
+static const int8_t PST[7][64] = {
+  { 0 },
+  { // pawn
+     0,  0,  0,  0,  0,  0,  0,  0,   50, 50, 50, 50, 50, 50, 50, 50,
+    10, 10, 20, 30, 30, 20, 10, 10,    5,  5, 10, 25, 25, 10,  5,  5,
+     0,  0,  0, 20, 20,  0,  0,  0,    5, -5,-10,  0,  0,-10, -5,  5,
+     5, 10, 10,-20,-20, 10, 10,  5,    0,  0,  0,  0,  0,  0,  0,  0 },
+  { // knight
+   -50,-40,-30,-30,-30,-30,-40,-50,  -40,-20,  0,  0,  0,  0,-20,-40,
+   -30,  0, 10, 15, 15, 10,  0,-30,  -30,  5, 15, 20, 20, 15,  5,-30,
+   -30,  0, 15, 20, 20, 15,  0,-30,  -30,  5, 10, 15, 15, 10,  5,-30,
+   -40,-20,  0,  5,  5,  0,-20,-40,  -50,-40,-30,-30,-30,-30,-40,-50 },
+  { // bishop
+   -20,-10,-10,-10,-10,-10,-10,-20,  -10,  0,  0,  0,  0,  0,  0,-10,
+   -10,  0,  5, 10, 10,  5,  0,-10,  -10,  5,  5, 10, 10,  5,  5,-10,
+   -10,  0, 10, 10, 10, 10,  0,-10,  -10, 10, 10, 10, 10, 10, 10,-10,
+   -10,  5,  0,  0,  0,  0,  5,-10,  -20,-10,-10,-10,-10,-10,-10,-20 },
+  { // rook
+     0,  0,  0,  0,  0,  0,  0,  0,    5, 10, 10, 10, 10, 10, 10,  5,
+    -5,  0,  0,  0,  0,  0,  0, -5,   -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,   -5,  0,  0,  0,  0,  0,  0, -5,
+    -5,  0,  0,  0,  0,  0,  0, -5,    0,  0,  0,  5,  5,  0,  0,  0 },
+  { // queen
+   -20,-10,-10, -5, -5,-10,-10,-20,  -10,  0,  0,  0,  0,  0,  0,-10,
+   -10,  0,  5,  5,  5,  5,  0,-10,   -5,  0,  5,  5,  5,  5,  0, -5,
+     0,  0,  5,  5,  5,  5,  0, -5,  -10,  5,  5,  5,  5,  5,  0,-10,
+   -10,  0,  5,  0,  0,  0,  0,-10,  -20,-10,-10, -5, -5,-10,-10,-20 },
+  { // king (middle game)
+   -30,-40,-40,-50,-50,-40,-40,-30,  -30,-40,-40,-50,-50,-40,-40,-30,
+   -30,-40,-40,-50,-50,-40,-40,-30,  -30,-40,-40,-50,-50,-40,-40,-30,
+   -20,-30,-30,-40,-40,-30,-30,-20,  -10,-20,-20,-20,-20,-20,-20,-10,
+    20, 20,  0,  0,  0,  0, 20, 20,   20, 30, 10,  0,  0, 10, 30, 20 }
+};
+
+/**
+ * @brief splitmix64 finalizer, used to derive zobrist keys on the fly
+ */
+static uint64_t mix64(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+static inline uint64_t pieceKey(int8_t piece, uint8_t sq) { return mix64(((uint64_t)(piece + 6) << 8) | sq); }
+static inline uint64_t castleKey(uint8_t castling)        { return mix64(0x1000 | castling); }
+static inline uint64_t epKey(uint8_t ep)                  { return (ep == CHESS_NO_SQUARE) ? 0 : mix64(0x2000 | ep); }
+static const uint64_t SIDE_KEY = 0x5A17C0DE5A17C0DEULL;
+
+static inline int abs8(int v) { return v < 0 ? -v : v; }
+static inline int sideIndex(int side) { return side > 0 ? 0 : 1; }
+
+/**
+ * @brief castling rights that survive a move touching this square
+ */
+static inline uint8_t castleMask(uint8_t sq) {
+  switch (sq) {
+    case 0x00: return 0x0F & ~0x02;       // a1 rook
+    case 0x04: return 0x0F & ~0x03;       // e1 king
+    case 0x07: return 0x0F & ~0x01;       // h1 rook
+    case 0x70: return 0x0F & ~0x08;       // a8 rook
+    case 0x74: return 0x0F & ~0x0C;       // e8 king
+    case 0x77: return 0x0F & ~0x04;       // h8 rook
+    default:   return 0x0F;
+  }
+}
+
+/**
+ * @brief recompute the hash from scratch (setup only, moves update it incrementally)
+ */
+static uint64_t computeHash(const ChessPosition* pos) {
+  uint64_t h = 0;
+  for (int sq = 0; sq < 128; sq++) {
+    if ((sq & 0x88) == 0 && pos->board[sq]) h ^= pieceKey(pos->board[sq], sq);
+  }
+  if (pos->side < 0) h ^= SIDE_KEY;
+  return h ^ castleKey(pos->castling) ^ epKey(pos->ep);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+// ------------------------------------------ Position ------------------------------------------ //
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief set up the standard starting position
+ */
+void chessInitPosition(ChessPosition* pos) {
+  chessSetFEN(pos, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+}
+
+/**
+ * @brief load a position from FEN (placement, side, castling, en passant, halfmove clock)
+ *
+ * @return false if the placement could not be parsed
+ */
+bool chessSetFEN(ChessPosition* pos, const char* fen) {
+  memset(pos->board, 0, sizeof(pos->board));
+  pos->castling = 0;
+  pos->ep = CHESS_NO_SQUARE;
+  pos->halfmove = 0;
+  pos->ply = 0;
+  pos->kingSq[0] = pos->kingSq[1] = CHESS_NO_SQUARE;
+
+  int rank = 7, file = 0;
+  for (; *fen && *fen != ' '; fen++) {
+    char c = *fen;
+    if (c == '/') { rank--; file = 0; continue; }
+    if (c >= '1' && c <= '8') { file += c - '0'; continue; }
+
+    const char* types = "pnbrqk";
+    const char* t = strchr(types, c | 0x20);
+    if (!t || rank < 0 || file > 7) return false;
+
+    int8_t piece = (int8_t)(t - types + 1);
+    if (c >= 'A' && c <= 'Z') {
+      pos->board[CHESS_SQ(file, rank)] = piece;
+    } else {
+      pos->board[CHESS_SQ(file, rank)] = -piece;
+    }
+    if (piece == CHESS_KING) pos->kingSq[(c >= 'a') ? 1 : 0] = CHESS_SQ(file, rank);
+    file++;
+  }
+  if (pos->kingSq[0] == CHESS_NO_SQUARE || pos->kingSq[1] == CHESS_NO_SQUARE) return false;
+
+  if (*fen == ' ') fen++;
+  pos->side = (*fen == 'b') ? CHESS_BLACK : CHESS_WHITE;
+  if (*fen) fen++;
+  if (*fen == ' ') fen++;
+
+  for (; *fen && *fen != ' '; fen++) {
+    if (*fen == 'K') pos->castling |= 0x01;
+    if (*fen == 'Q') pos->castling |= 0x02;
+    if (*fen == 'k') pos->castling |= 0x04;
+    if (*fen == 'q') pos->castling |= 0x08;
+  }
+  if (*fen == ' ') fen++;
+
+  if (*fen >= 'a' && *fen <= 'h' && fen[1] >= '1' && fen[1] <= '8') {
+    pos->ep = CHESS_SQ(fen[0] - 'a', fen[1] - '1');
+    fen += 2;
+  } else if (*fen) {
+    fen++;
+  }
+  if (*fen == ' ') fen++;
+
+  int halfmove = 0;
+  while (*fen >= '0' && *fen <= '9') halfmove = halfmove * 10 + (*fen++ - '0');
+  pos->halfmove = (halfmove > 255) ? 255 : halfmove;
+
+  pos->hash = computeHash(pos);
+  return true;
+}
+
+/**
+ * @brief is a square attacked by the given side
+ */
+static bool isAttacked(const ChessPosition* pos, int sq, int by) {
+  const int8_t* b = pos->board;
+
+  // pawns (look backwards from the target along the attacker's capture directions)
+  int p1 = sq - by * 15, p2 = sq - by * 17;
+  if (!(p1 & 0x88) && b[p1] == by * CHESS_PAWN) return true;
+  if (!(p2 & 0x88) && b[p2] == by * CHESS_PAWN) return true;
+
+  for (int i = 0; i < 8; i++) {
+    int t = sq + KNIGHT_DIRS[i];
+    if (!(t & 0x88) && b[t] == by * CHESS_KNIGHT) return true;
+    t = sq + KING_DIRS[i];
+    if (!(t & 0x88) && b[t] == by * CHESS_KING) return true;
+  }
+
+  for (int i = 0; i < 4; i++) {
+    for (int t = sq + BISHOP_DIRS[i]; !(t & 0x88); t += BISHOP_DIRS[i]) {
+      int8_t p = b[t];
+      if (p) {
+        if (p == by * CHESS_BISHOP || p == by * CHESS_QUEEN) return true;
+        break;
+      }
+    }
+    for (int t = sq + ROOK_DIRS[i]; !(t & 0x88); t += ROOK_DIRS[i]) {
+      int8_t p = b[t];
+      if (p) {
+        if (p == by * CHESS_ROOK || p == by * CHESS_QUEEN) return true;
+        break;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief is the side to move in check
+ */
+bool chessInCheck(const ChessPosition* pos) {
+  return isAttacked(pos, pos->kingSq[sideIndex(pos->side)], -pos->side);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ------------------------------------------ Move Generation ------------------------------------------ //
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static inline void addMove(ChessMove* out, int& n, int from, int to, int8_t promo, uint8_t flags) {
+  out[n].from = from;
+  out[n].to = to;
+  out[n].promo = promo;
+  out[n].flags = flags;
+  n++;
+}
+
+/**
+ * @brief add a pawn move, expanding it into the four promotions on the last rank
+ *
+ * quiescence only wants the queen promotion
+ */
+static inline void addPawnMove(ChessMove* out, int& n, int from, int to, uint8_t flags, bool queenOnly) {
+  int rank = CHESS_RANK(to);
+  if (rank == 0 || rank == 7) {
+    addMove(out, n, from, to, CHESS_QUEEN, flags);
+    if (!queenOnly) {
+      addMove(out, n, from, to, CHESS_KNIGHT, flags);
+      addMove(out, n, from, to, CHESS_ROOK, flags);
+      addMove(out, n, from, to, CHESS_BISHOP, flags);
+    }
+  } else {
+    addMove(out, n, from, to, 0, flags);
+  }
+}
+
+/**
+ * @brief pseudo-legal moves (may leave the king in check, make rejects those)
+ *
+ * @param capturesOnly only captures and promotions (quiescence)
+ * @return int number of moves written (at most 218 in any legal position)
+ */
+static int generatePseudo(const ChessPosition* pos, ChessMove* out, bool capturesOnly) {
+  const int8_t* b = pos->board;
+  int side = pos->side;
+  int n = 0;
+
+  for (int sq = 0; sq < 128; sq++) {
+    if (sq & 0x88) { sq += 7; continue; }
+    int8_t p = b[sq];
+    if (p * side <= 0) continue;
+
+    switch (abs8(p)) {
+      case CHESS_PAWN: {
+        int fwd = side * 16;
+        int to = sq + fwd;
+        bool promoting = (CHESS_RANK(to) == 0 || CHESS_RANK(to) == 7);
+        if (!(to & 0x88) && !b[to] && (!capturesOnly || promoting)) {
+          addPawnMove(out, n, sq, to, 0, capturesOnly);
+          int startRank = (side > 0) ? 1 : 6;
+          if (!capturesOnly && CHESS_RANK(sq) == startRank && !b[to + fwd]) {
+            addMove(out, n, sq, to + fwd, 0, CHESS_MOVE_DOUBLE);
+          }
+        }
+        for (int d = -1; d <= 1; d += 2) {
+          int t = to + d;
+          if (t & 0x88) continue;
+          if (b[t] * side < 0) addPawnMove(out, n, sq, t, CHESS_MOVE_CAPTURE, capturesOnly);
+          else if (t == pos->ep) addMove(out, n, sq, t, 0, CHESS_MOVE_CAPTURE | CHESS_MOVE_EP);
+        }
+        break;
+      }
+
+      case CHESS_KNIGHT:
+      case CHESS_KING: {
+        const int8_t* dirs = (abs8(p) == CHESS_KNIGHT) ? KNIGHT_DIRS : KING_DIRS;
+        for (int i = 0; i < 8; i++) {
+          int t = sq + dirs[i];
+          if (t & 0x88) continue;
+          if (b[t] * side < 0) addMove(out, n, sq, t, 0, CHESS_MOVE_CAPTURE);
+          else if (!b[t] && !capturesOnly) addMove(out, n, sq, t, 0, 0);
+        }
+
+        // castling: squares between empty, king not passing through check
+        if (abs8(p) == CHESS_KING && !capturesOnly) {
+          int kingSide = (side > 0) ? 0x01 : 0x04;
+          int queenSide = (side > 0) ? 0x02 : 0x08;
+          int home = (side > 0) ? 0x04 : 0x74;
+          if (sq == home && (pos->castling & (kingSide | queenSide)) && !isAttacked(pos, sq, -side)) {
+            if ((pos->castling & kingSide) && !b[sq + 1] && !b[sq + 2] &&
+                !isAttacked(pos, sq + 1, -side) && !isAttacked(pos, sq + 2, -side)) {
+              addMove(out, n, sq, sq + 2, 0, CHESS_MOVE_CASTLE);
+            }
+            if ((pos->castling & queenSide) && !b[sq - 1] && !b[sq - 2] && !b[sq - 3] &&
+                !isAttacked(pos, sq - 1, -side) && !isAttacked(pos, sq - 2, -side)) {
+              addMove(out, n, sq, sq - 2, 0, CHESS_MOVE_CASTLE);
+            }
+          }
+        }
+        break;
+      }
+
+      default: {
+        // sliders
+        int type = abs8(p);
+        for (int i = 0; i < 8; i++) {
+          int dir;
+          if (type == CHESS_BISHOP) { if (i >= 4) break; dir = BISHOP_DIRS[i]; }
+          else if (type == CHESS_ROOK) { if (i >= 4) break; dir = ROOK_DIRS[i]; }
+          else dir = KING_DIRS[i];
+
+          for (int t = sq + dir; !(t & 0x88); t += dir) {
+            if (b[t]) {
+              if (b[t] * side < 0) addMove(out, n, sq, t, 0, CHESS_MOVE_CAPTURE);
+              break;
+            }
+            if (!capturesOnly) addMove(out, n, sq, t, 0, 0);
+          }
+        }
+        break;
+      }
+    }
+  }
+  return n;
+}
+
+/**
+ * @brief play a move
+ *
+ * @return false (and the move is taken back) if it leaves the mover's king in check
+ */
+bool chessMakeMove(ChessPosition* pos, const ChessMove& m) {
+  if (pos->ply >= CHESS_MAX_HISTORY) return false;
+
+  int8_t* b = pos->board;
+  int side = pos->side;
+  ChessUndo& u = pos->history[pos->ply++];
+  u.move = m;
+  u.castling = pos->castling;
+  u.ep = pos->ep;
+  u.halfmove = pos->halfmove;
+  u.hash = pos->hash;
+
+  uint64_t h = pos->hash;
+  int8_t piece = b[m.from];
+  h ^= pieceKey(piece, m.from);
+
+  // captured piece (en passant takes the pawn behind the target square)
+  if (m.flags & CHESS_MOVE_EP) {
+    int capSq = m.to - side * 16;
+    u.captured = b[capSq];
+    b[capSq] = CHESS_EMPTY;
+    h ^= pieceKey(u.captured, capSq);
+  } else {
+    u.captured = b[m.to];
+    if (u.captured) h ^= pieceKey(u.captured, m.to);
+  }
+
+  int8_t placed = m.promo ? (int8_t)(m.promo * side) : piece;
+  b[m.to] = placed;
+  b[m.from] = CHESS_EMPTY;
+  h ^= pieceKey(placed, m.to);
+
+  if (abs8(piece) == CHESS_KING) {
+    pos->kingSq[sideIndex(side)] = m.to;
+
+    // move the rook along
+    if (m.flags & CHESS_MOVE_CASTLE) {
+      int rookFrom = (m.to > m.from) ? m.from + 3 : m.from - 4;
+      int rookTo = (m.to > m.from) ? m.from + 1 : m.from - 1;
+      b[rookTo] = b[rookFrom];
+      b[rookFrom] = CHESS_EMPTY;
+      h ^= pieceKey(b[rookTo], rookFrom) ^ pieceKey(b[rookTo], rookTo);
+    }
+  }
+
+  h ^= castleKey(pos->castling);
+  pos->castling &= castleMask(m.from) & castleMask(m.to);
+  h ^= castleKey(pos->castling);
+
+  h ^= epKey(pos->ep);
+  pos->ep = (m.flags & CHESS_MOVE_DOUBLE) ? (uint8_t)(m.from + side * 16) : CHESS_NO_SQUARE;
+  h ^= epKey(pos->ep);
+
+  pos->halfmove = (abs8(piece) == CHESS_PAWN || u.captured) ? 0 : (uint8_t)(pos->halfmove + 1);
+  pos->side = -side;
+  pos->hash = h ^ SIDE_KEY;
+
+  if (isAttacked(pos, pos->kingSq[sideIndex(side)], -side)) {
+    chessUndoMove(pos);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief take back the last move
+ */
+void chessUndoMove(ChessPosition* pos) {
+  if (pos->ply == 0) return;
+
+  int8_t* b = pos->board;
+  const ChessUndo& u = pos->history[--pos->ply];
+  const ChessMove& m = u.move;
+  int side = -pos->side;             // side that made the move
+  pos->side = side;
+
+  int8_t piece = m.promo ? (int8_t)(CHESS_PAWN * side) : b[m.to];
+  b[m.from] = piece;
+
+  if (m.flags & CHESS_MOVE_EP) {
+    b[m.to] = CHESS_EMPTY;
+    b[m.to - side * 16] = u.captured;
+  } else {
+    b[m.to] = u.captured;
+  }
+
+  if (abs8(piece) == CHESS_KING) {
+    pos->kingSq[sideIndex(side)] = m.from;
+    if (m.flags & CHESS_MOVE_CASTLE) {
+      int rookFrom = (m.to > m.from) ? m.from + 3 : m.from - 4;
+      int rookTo = (m.to > m.from) ? m.from + 1 : m.from - 1;
+      b[rookFrom] = b[rookTo];
+      b[rookTo] = CHESS_EMPTY;
+    }
+  }
+
+  pos->castling = u.castling;
+  pos->ep = u.ep;
+  pos->halfmove = u.halfmove;
+  pos->hash = u.hash;
+}
+
+/**
+ * @brief all legal moves in the position
+ *
+ * @param out room for at least 256 moves
+ * @return int number of legal moves
+ */
+int chessGenerateLegal(ChessPosition* pos, ChessMove* out) {
+  int n = generatePseudo(pos, out, false);
+  int legal = 0;
+  for (int i = 0; i < n; i++) {
+    if (chessMakeMove(pos, out[i])) {
+      chessUndoMove(pos);
+      out[legal++] = out[i];
+    }
+  }
+  return legal;
+}
+
+/**
+ * @brief has the same position (same side to move) occurred since the last capture / pawn move
+ *
+ * @param needed how many earlier occurrences make it a draw (1 inside the search, 2 for threefold in the game)
+ */
+static bool isRepetition(const ChessPosition* pos, int needed) {
+  int count = 0;
+  int limit = (pos->halfmove < pos->ply) ? pos->halfmove : pos->ply;
+  for (int back = 4; back <= limit; back += 2) {
+    if (pos->history[pos->ply - back].hash == pos->hash && ++count >= needed) return true;
+  }
+  return false;
+}
+
+/**
+ * @brief result of the game so far (for the UI)
+ */
+ChessStatus chessGetStatus(ChessPosition* pos) {
+  ChessMove moves[256];
+  if (chessGenerateLegal(pos, moves) == 0) {
+    return chessInCheck(pos) ? CHESS_CHECKMATE : CHESS_STALEMATE;
+  }
+  if (pos->halfmove >= 100 || isRepetition(pos, 2)) return CHESS_DRAW;
+
+  // out of undo history (the search needs CHESS_MAX_PLY of it), call it a draw rather than misjudge mates
+  if (pos->ply + CHESS_MAX_PLY >= CHESS_MAX_HISTORY) return CHESS_DRAW;
+  return CHESS_ONGOING;
+}
+
+/**
+ * @brief count leaf nodes of the legal move tree (move generator verification / speed)
+ *
+ * uses its own 256 move list per level on the stack, so keep depth small on the ESP32
+ */
+uint64_t chessPerft(ChessPosition* pos, int depth) {
+  ChessMove moves[256];
+  int n = generatePseudo(pos, moves, false);
+  uint64_t total = 0;
+
+  for (int i = 0; i < n; i++) {
+    if (!chessMakeMove(pos, moves[i])) continue;
+    total += (depth <= 1) ? 1 : chessPerft(pos, depth - 1);
+    chessUndoMove(pos);
+  }
+  return total;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+// ------------------------------------------ Evaluation ------------------------------------------ //
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief material + piece square tables, from the side to move's point of view
+ */
+static int evaluate(const ChessPosition* pos) {
+  int score = 0;
+  for (int sq = 0; sq < 128; sq++) {
+    if (sq & 0x88) { sq += 7; continue; }
+    int8_t p = pos->board[sq];
+    if (!p) continue;
+
+    int type = abs8(p);
+    int file = CHESS_FILE(sq);
+    int rank = CHESS_RANK(sq);
+    if (p > 0) score += PIECE_VALUE[type] + PST[type][(7 - rank) * 8 + file];
+    else       score -= PIECE_VALUE[type] + PST[type][rank * 8 + file];
+  }
+  return score * pos->side;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// ------------------------------------------ Search ------------------------------------------ //
+//////////////////////////////////////////////////////////////////////////////////////////////////
+#define MATE_SCORE 30000
+#define MATE_BOUND (MATE_SCORE - CHESS_MAX_PLY)
+#define INF_SCORE 32000
+
+#define TT_EXACT 0
+#define TT_LOWER 1
+#define TT_UPPER 2
+
+// 12 bytes: upper half of the hash to verify, score, packed best move, depth, bound type
+struct TTEntry {
+  uint32_t key;
+  int16_t score;
+  uint16_t move;
+  uint8_t depth;
+  uint8_t flag;
+};
+
+static TTEntry tt[CHESS_TT_ENTRIES];
+static ChessMove moveStack[CHESS_MOVE_STACK];
+static int16_t moveScores[CHESS_MOVE_STACK];
+static int moveStackTop = 0;
+static ChessMove killers[CHESS_MAX_PLY][2];
+
+static volatile bool stopRequested = false;
+static ChessSearchLimits searchLimits;
+static uint32_t searchStart = 0;
+static uint32_t nodes = 0;
+static ChessMove rootBest;
+static bool rootBestFound = false;
+
+/**
+ * @brief pack a move into 15 bits (64-square from/to + promotion) for the TT
+ */
+static inline uint16_t packMove(const ChessMove& m) {
+  int from = CHESS_RANK(m.from) * 8 + CHESS_FILE(m.from);
+  int to = CHESS_RANK(m.to) * 8 + CHESS_FILE(m.to);
+  return (uint16_t)(from | (to << 6) | (m.promo << 12));
+}
+
+static inline bool sameMove(const ChessMove& a, const ChessMove& b) {
+  return a.from == b.from && a.to == b.to && a.promo == b.promo;
+}
+
+/**
+ * @brief ask a running search to return as soon as possible (safe from another core)
+ */
+void chessStopSearch() {
+  stopRequested = true;
+}
+
+/**
+ * @brief every CHESS_CHECK_NODES nodes: give the caller's yield a turn, then poll the clock
+ */
+static inline void checkLimits() {
+  if (nodes & (CHESS_CHECK_NODES - 1)) return;
+
+  if (searchLimits.yield) searchLimits.yield();
+  if (searchLimits.maxTimeMs && searchLimits.clockMs) {
+    if (searchLimits.clockMs() - searchStart >= searchLimits.maxTimeMs) stopRequested = true;
+  }
+}
+
+/**
+ * @brief order moves: TT move, captures by MVV-LVA, promotions, killers, the rest
+ */
+static void scoreMoves(const ChessPosition* pos, int base, int count, uint16_t ttMove, int ply) {
+  for (int i = base; i < base + count; i++) {
+    const ChessMove& m = moveStack[i];
+    int16_t s = 0;
+    if (ttMove && packMove(m) == ttMove) {
+      s = 30000;
+    } else if (m.flags & CHESS_MOVE_CAPTURE) {
+      int victim = (m.flags & CHESS_MOVE_EP) ? CHESS_PAWN : abs8(pos->board[m.to]);
+      s = 10000 + victim * 100 - abs8(pos->board[m.from]);
+    } else if (m.promo) {
+      s = 9000 + m.promo;
+    } else if (ply < CHESS_MAX_PLY && sameMove(m, killers[ply][0])) {
+      s = 8000;
+    } else if (ply < CHESS_MAX_PLY && sameMove(m, killers[ply][1])) {
+      s = 7000;
+    }
+    moveScores[i] = s;
+  }
+}
+
+/**
+ * @brief move the best scored remaining move to index i (lazy selection sort)
+ */
+static void pickMove(int i, int end) {
+  int best = i;
+  for (int j = i + 1; j < end; j++) {
+    if (moveScores[j] > moveScores[best]) best = j;
+  }
+  if (best != i) {
+    ChessMove m = moveStack[i]; moveStack[i] = moveStack[best]; moveStack[best] = m;
+    int16_t s = moveScores[i]; moveScores[i] = moveScores[best]; moveScores[best] = s;
+  }
+}
+
+/**
+ * @brief captures only search so the horizon never ends in the middle of an exchange
+ */
+static int quiesce(ChessPosition* pos, int alpha, int beta, int ply) {
+  nodes++;
+  checkLimits();
+  if (stopRequested) return 0;
+
+  int standPat = evaluate(pos);
+  if (standPat >= beta) return standPat;
+  if (standPat > alpha) alpha = standPat;
+  if (ply >= CHESS_MAX_PLY - 1 || moveStackTop + 256 > CHESS_MOVE_STACK) return standPat;
+
+  int base = moveStackTop;
+  int count = generatePseudo(pos, &moveStack[base], true);
+  moveStackTop += count;
+  scoreMoves(pos, base, count, 0, ply);
+
+  for (int i = base; i < base + count; i++) {
+    pickMove(i, base + count);
+    if (!chessMakeMove(pos, moveStack[i])) continue;
+    int score = -quiesce(pos, -beta, -alpha, ply + 1);
+    chessUndoMove(pos);
+
+    if (stopRequested) break;
+    if (score >= beta) { alpha = score; break; }
+    if (score > alpha) alpha = score;
+  }
+
+  moveStackTop = base;
+  return alpha;
+}
+
+/**
+ * @brief negamax alpha-beta
+ */
+static int search(ChessPosition* pos, int depth, int alpha, int beta, int ply) {
+  if (ply > 0 && (pos->halfmove >= 100 || isRepetition(pos, 1))) return 0;
+
+  bool inCheck = chessInCheck(pos);
+  if (inCheck) depth++;                                // check extension
+  if (depth <= 0) return quiesce(pos, alpha, beta, ply);
+
+  nodes++;
+  checkLimits();
+  if (stopRequested) return 0;
+  if (ply >= CHESS_MAX_PLY - 1 || moveStackTop + 256 > CHESS_MOVE_STACK) return evaluate(pos);
+
+  // transposition table probe
+  TTEntry& e = tt[pos->hash & (CHESS_TT_ENTRIES - 1)];
+  uint16_t ttMove = 0;
+  if (e.key == (uint32_t)(pos->hash >> 32)) {
+    ttMove = e.move;
+    if (ply > 0 && e.depth >= depth) {
+      int s = e.score;
+      if (s > MATE_BOUND) s -= ply;
+      else if (s < -MATE_BOUND) s += ply;
+
+      if (e.flag == TT_EXACT) return s;
+      if (e.flag == TT_LOWER && s >= beta) return s;
+      if (e.flag == TT_UPPER && s <= alpha) return s;
+    }
+  }
+
+  int base = moveStackTop;
+  int count = generatePseudo(pos, &moveStack[base], false);
+  moveStackTop += count;
+  scoreMoves(pos, base, count, ttMove, ply);
+
+  int alphaOrig = alpha;
+  int best = -INF_SCORE;
+  ChessMove bestMove = {0, 0, 0, 0};
+  int legal = 0;
+
+  for (int i = base; i < base + count; i++) {
+    pickMove(i, base + count);
+    ChessMove m = moveStack[i];
+    if (!chessMakeMove(pos, m)) continue;
+    legal++;
+
+    int score = -search(pos, depth - 1, -beta, -alpha, ply + 1);
+    chessUndoMove(pos);
+    if (stopRequested) break;
+
+    if (score > best) {
+      best = score;
+      bestMove = m;
+      if (ply == 0) { rootBest = m; rootBestFound = true; }
+    }
+    if (score > alpha) alpha = score;
+    if (alpha >= beta) {
+      if (!(m.flags & CHESS_MOVE_CAPTURE) && !sameMove(m, killers[ply][0])) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = m;
+      }
+      break;
+    }
+  }
+  moveStackTop = base;
+
+  if (stopRequested) return 0;
+  if (legal == 0) return inCheck ? -MATE_SCORE + ply : 0;
+
+  // store (mate scores relative to this node)
+  int stored = best;
+  if (stored > MATE_BOUND) stored += ply;
+  else if (stored < -MATE_BOUND) stored -= ply;
+
+  e.key = (uint32_t)(pos->hash >> 32);
+  e.score = (int16_t)stored;
+  e.move = packMove(bestMove);
+  e.depth = (uint8_t)depth;
+  e.flag = (best <= alphaOrig) ? TT_UPPER : (best >= beta) ? TT_LOWER : TT_EXACT;
+  return best;
+}
+
+/**
+ * @brief find the best move for the side to move with iterative deepening
+ *
+ * every iteration seeds the next through the transposition table, so when time runs out we still have the best move
+ * of the deepest finished iteration (or the partial one if it already found something)
+ *
+ * @param pos position to search (restored before returning)
+ * @param limits depth / time budget
+ * @param info filled with depth, score, nodes and time
+ * @return ChessMove best move (from == to == 0 if there is no legal move)
+ */
+ChessMove chessSearch(ChessPosition* pos, const ChessSearchLimits& limits, ChessSearchInfo* info) {
+  searchLimits = limits;
+  searchStart = limits.clockMs ? limits.clockMs() : 0;
+  stopRequested = false;
+  nodes = 0;
+  moveStackTop = 0;
+  memset(killers, 0, sizeof(killers));
+
+  ChessMove best = {0, 0, 0, 0};
+  int bestScore = 0;
+  uint8_t completed = 0;
+
+  uint8_t maxDepth = limits.maxDepth;
+  if (maxDepth > CHESS_MAX_PLY / 2) maxDepth = CHESS_MAX_PLY / 2;
+
+  for (uint8_t depth = 1; depth <= maxDepth; depth++) {
+    rootBestFound = false;
+    int score = search(pos, depth, -INF_SCORE, INF_SCORE, 0);
+
+    if (stopRequested) {
+      if (rootBestFound) best = rootBest;
+      break;
+    }
+
+    best = rootBest;
+    bestScore = score;
+    completed = depth;
+    if (score > MATE_BOUND || score < -MATE_BOUND) break;      // forced mate found, deeper will not change it
+  }
+
+  if (info) {
+    info->depth = completed;
+    info->score = (int16_t)bestScore;
+    info->nodes = nodes;
+    info->elapsedMs = limits.clockMs ? limits.clockMs() - searchStart : 0;
+  }
+  return best;
+}
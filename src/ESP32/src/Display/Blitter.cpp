@@ -0,0 +1,270 @@
+/**
+ * @file Blitter.cpp
+ * @brief SWAR implementation of the RGB565 blitter kernels
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The ESP32 (Xtensa LX6) has no packed 16-bit SIMD instructions, so instead we treat every 32-bit word as two RGB565
+ * pixels (SWAR: SIMD within a register). Stores, copies and blends then move two pixels per instruction. Xtensa faults on
+ * unaligned 32-bit accesses, so every kernel peels off a leading pixel when the row starts on an odd pixel and a trailing
+ * pixel when the width is odd.
+ *
+ * The per-pixel loops are kept as the reference path (-DBLITTER_REFERENCE) and for the ragged edges.
+ *
+ */
+
+#include "Display/Blitter.h"
+#include <string.h>
+
+// masks for the two pixel blend (see blend565x2)
+static const uint32_t BLEND_MASK_EVEN = 0x07E0F81F;   // lo R, lo B, hi G
+static const uint32_t BLEND_MASK_ODD  = 0x07C0F83F;   // lo G, hi B, hi R (after >> 5)
+
+/**
+ * @brief blend one RGB565 pixel
+ *
+ * classic trick: spread the pixel out to 0000 0GGG GGG0 0000 RRRR R000 00BB BBB so each channel has 5 bits of
+ * headroom, then all three channels are multiplied at once
+ *
+ * @param src foreground
+ * @param dst background
+ * @param alpha 0 (all dst) .. 32 (all src)
+ * @return uint16_t blended pixel
+ */
+uint16_t blend565(uint16_t src, uint16_t dst, uint8_t alpha) {
+  uint32_t s = (src | ((uint32_t)src << 16)) & 0x07E0F81F;
+  uint32_t d = (dst | ((uint32_t)dst << 16)) & 0x07E0F81F;
+  uint32_t r = ((s * alpha + d * (BLEND_ALPHA_MAX - alpha)) >> 5) & 0x07E0F81F;
+  return (uint16_t)(r | (r >> 16));
+}
+
+#ifndef BLITTER_REFERENCE
+/**
+ * @brief blend two packed pixels at once
+ *
+ * the even mask picks channels that are at least 5 bits apart, multiply, shift back. The odd channels are shifted down by
+ * 5 so they line up with the same kind of gaps. Worst case per channel is 63 * 32 which fits in the gap.
+ */
+static inline uint32_t blend565x2(uint32_t s, uint32_t d, uint32_t alpha) {
+  uint32_t inv = BLEND_ALPHA_MAX - alpha;
+
+  uint32_t even = ((s & BLEND_MASK_EVEN) * alpha + (d & BLEND_MASK_EVEN) * inv) >> 5;
+  uint32_t odd  = (((s >> 5) & BLEND_MASK_ODD) * alpha + ((d >> 5) & BLEND_MASK_ODD) * inv) >> 5;
+
+  return (even & BLEND_MASK_EVEN) | ((odd & BLEND_MASK_ODD) << 5);
+}
+#endif
+
+/**
+ * @brief solid fill
+ *
+ * @param dst top left pixel of the destination
+ * @param dstStride destination row length in pixels
+ * @param w width
+ * @param h height
+ * @param color RGB565 color
+ */
+void blitFill(uint16_t* dst, int dstStride, int w, int h, uint16_t color) {
+  if (w <= 0 || h <= 0) return;
+
+#ifdef BLITTER_REFERENCE
+  for (int y = 0; y < h; y++, dst += dstStride) {
+    for (int x = 0; x < w; x++) dst[x] = color;
+  }
+#else
+  uint32_t pair = color | ((uint32_t)color << 16);
+
+  for (int y = 0; y < h; y++, dst += dstStride) {
+    uint16_t* p = dst;
+    int n = w;
+
+    // leading pixel to get onto a word boundary
+    if (((uintptr_t)p & 2) && n) { *p++ = color; n--; }
+
+    uint32_t* wp = (uint32_t*)p;
+    int words = n >> 1;
+
+    // unrolled by 4 words (8 pixels, one tile row)
+    while (words >= 4) {
+      wp[0] = pair; wp[1] = pair; wp[2] = pair; wp[3] = pair;
+      wp += 4;
+      words -= 4;
+    }
+    while (words--) *wp++ = pair;
+
+    // trailing pixel
+    if (n & 1) *(uint16_t*)wp = color;
+  }
+#endif
+}
+
+/**
+ * @brief fill with a repeating square pattern
+ *
+ * @param pattern patternSize x patternSize RGB565 tile, patternSize must be a power of two
+ * @param phaseX pattern column at the left edge of dst (so patterns stay anchored when filling a sub rectangle)
+ * @param phaseY pattern row at the top edge of dst
+ */
+void blitFillPattern(uint16_t* dst, int dstStride, int w, int h, const uint16_t* pattern, int patternSize, int phaseX, int phaseY) {
+  if (w <= 0 || h <= 0) return;
+  int m = patternSize - 1;
+
+  for (int y = 0; y < h; y++, dst += dstStride) {
+    const uint16_t* row = &pattern[((y + phaseY) & m) * patternSize];
+    int px = phaseX;
+    uint16_t* p = dst;
+    int n = w;
+
+#ifndef BLITTER_REFERENCE
+    if (((uintptr_t)p & 2) && n) { *p++ = row[px++ & m]; n--; }
+
+    uint32_t* wp = (uint32_t*)p;
+    for (int words = n >> 1; words; words--) {
+      *wp++ = row[px & m] | ((uint32_t)row[(px + 1) & m] << 16);
+      px += 2;
+    }
+    p = (uint16_t*)wp;
+    n &= 1;
+#endif
+
+    while (n--) *p++ = row[px++ & m];
+  }
+}
+
+/**
+ * @brief straight copy of a rectangle
+ */
+void blitCopy(uint16_t* dst, int dstStride, const uint16_t* src, int srcStride, int w, int h) {
+  if (w <= 0 || h <= 0) return;
+
+  for (int y = 0; y < h; y++, dst += dstStride, src += srcStride) {
+    memcpy(dst, src, w * sizeof(uint16_t));
+  }
+}
+
+/**
+ * @brief copy a rectangle, skipping pixels equal to the transparent key (sprites)
+ *
+ * most sprite pixels are either all opaque or all transparent in pairs, so whole words are tested first and only mixed
+ * pairs are split up
+ *
+ * @param key RGB565 value treated as transparent
+ */
+void blitCopyKeyed(uint16_t* dst, int dstStride, const uint16_t* src, int srcStride, int w, int h, uint16_t key) {
+  if (w <= 0 || h <= 0) return;
+
+  for (int y = 0; y < h; y++, dst += dstStride, src += srcStride) {
+    uint16_t* d = dst;
+    const uint16_t* s = src;
+    int n = w;
+
+#ifndef BLITTER_REFERENCE
+    if ((((uintptr_t)d ^ (uintptr_t)s) & 2) == 0) {
+      if (((uintptr_t)d & 2) && n) { if (*s != key) *d = *s; d++; s++; n--; }
+
+      uint32_t keyPair = key | ((uint32_t)key << 16);
+      uint32_t* wd = (uint32_t*)d;
+      const uint32_t* ws = (const uint32_t*)s;
+      for (int words = n >> 1; words; words--, wd++, ws++) {
+        uint32_t v = *ws;
+        uint32_t diff = v ^ keyPair;
+        if ((diff & 0xFFFF) && (diff >> 16)) {
+          *wd = v;                                          // both opaque
+        } else if (diff) {
+          uint16_t* pd = (uint16_t*)wd;                     // one of the two is transparent
+          if (diff & 0xFFFF) pd[0] = (uint16_t)v;
+          if (diff >> 16)    pd[1] = (uint16_t)(v >> 16);
+        }
+      }
+      d = (uint16_t*)wd;
+      s = (const uint16_t*)ws;
+      n &= 1;
+    }
+#endif
+
+    while (n--) { if (*s != key) *d = *s; d++; s++; }
+  }
+}
+
+/**
+ * @brief nearest neighbour integer upscale
+ *
+ * each source row is expanded once into the first destination row (two pixels per store when the scale is even), the
+ * remaining scale-1 rows are copies of it. This replaces scale*scale drawPixel calls per source pixel.
+ *
+ * @param src top left of the source image
+ * @param srcW source width
+ * @param srcH source height
+ * @param scale integer scale factor (>= 1)
+ */
+void blitScaled(uint16_t* dst, int dstStride, const uint16_t* src, int srcStride, int srcW, int srcH, int scale) {
+  if (srcW <= 0 || srcH <= 0 || scale <= 0) return;
+
+  int dstW = srcW * scale;
+
+  for (int sy = 0; sy < srcH; sy++, src += srcStride) {
+    uint16_t* first = dst;
+
+#ifndef BLITTER_REFERENCE
+    if ((scale & 1) == 0 && ((uintptr_t)first & 2) == 0) {
+      uint32_t* wp = (uint32_t*)first;
+      int half = scale >> 1;
+      for (int sx = 0; sx < srcW; sx++) {
+        uint32_t pair = src[sx] | ((uint32_t)src[sx] << 16);
+        for (int k = 0; k < half; k++) *wp++ = pair;
+      }
+    } else
+#endif
+    {
+      uint16_t* p = first;
+      for (int sx = 0; sx < srcW; sx++) {
+        for (int k = 0; k < scale; k++) *p++ = src[sx];
+      }
+    }
+    dst += dstStride;
+
+    for (int k = 1; k < scale; k++, dst += dstStride) {
+      memcpy(dst, first, dstW * sizeof(uint16_t));
+    }
+  }
+}
+
+/**
+ * @brief alpha blend src over dst (result written to dst)
+ *
+ * @param alpha 0 (all dst) .. 32 (all src)
+ */
+void blitBlend(uint16_t* dst, int dstStride, const uint16_t* src, int srcStride, int w, int h, uint8_t alpha) {
+  if (w <= 0 || h <= 0) return;
+
+  if (alpha >= BLEND_ALPHA_MAX) {
+    blitCopy(dst, dstStride, src, srcStride, w, h);
+    return;
+  }
+  if (alpha == 0) return;
+
+  for (int y = 0; y < h; y++, dst += dstStride, src += srcStride) {
+    uint16_t* d = dst;
+    const uint16_t* s = src;
+    int n = w;
+
+#ifndef BLITTER_REFERENCE
+    // the pair trick needs both pointers on the same word alignment
+    if ((((uintptr_t)d ^ (uintptr_t)s) & 2) == 0) {
+      if (((uintptr_t)d & 2) && n) { *d = blend565(*s, *d, alpha); d++; s++; n--; }
+
+      uint32_t* wd = (uint32_t*)d;
+      const uint32_t* ws = (const uint32_t*)s;
+      for (int words = n >> 1; words; words--, wd++, ws++) {
+        *wd = blend565x2(*ws, *wd, alpha);
+      }
+      d = (uint16_t*)wd;
+      s = (const uint16_t*)ws;
+      n &= 1;
+    }
+#endif
+
+    while (n--) { *d = blend565(*s, *d, alpha); d++; s++; }
+  }
+}
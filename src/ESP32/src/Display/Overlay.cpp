@@ -0,0 +1,156 @@
+/**
+ * @file Overlay.cpp
+ * @brief implementation of the overlay layers
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The coverage bits are laid out so that the 8 pixels of one tile row are one byte, which makes "is anything in this
+ * tile covered" eight byte reads. tileUsed caches that answer per tile so the canvas can skip composition for every tile
+ * the overlay does not touch (usually all but one or two).
+ *
+ */
+
+#include "Display/Overlay.h"
+#include "Display/Blitter.h"
+#include <new>
+
+#define COVERAGE_STRIDE (CANVAS_WIDTH / 8)
+
+static_assert(CANVAS_TILE_SIZE == 8, "one coverage byte is one tile row");
+
+OverlayLayer::OverlayLayer(VirtualCanvas* canvas)
+  : Adafruit_GFX(CANVAS_WIDTH, CANVAS_HEIGHT), canvas(canvas), buffer(nullptr), coverage(nullptr) {
+  memset(tileUsed, 0, sizeof(tileUsed));
+}
+
+OverlayLayer::~OverlayLayer() {
+  delete[] buffer;
+  delete[] coverage;
+}
+
+/**
+ * @brief allocate the layer (a framebuffer plus 1/16 of that for coverage)
+ *
+ * @return false if there was not enough memory. drawing into a layer that is not ready does nothing
+ */
+bool OverlayLayer::begin() {
+  if (buffer) return true;
+
+  buffer = new (std::nothrow) uint16_t[CANVAS_WIDTH * CANVAS_HEIGHT];
+  coverage = new (std::nothrow) uint8_t[COVERAGE_STRIDE * CANVAS_HEIGHT];
+  if (!buffer || !coverage) {
+    delete[] buffer;
+    delete[] coverage;
+    buffer = nullptr;
+    coverage = nullptr;
+    return false;
+  }
+
+  memset(coverage, 0, COVERAGE_STRIDE * CANVAS_HEIGHT);
+  memset(tileUsed, 0, sizeof(tileUsed));
+  return true;
+}
+
+bool OverlayLayer::clip(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const {
+  if (!buffer) return false;
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > CANVAS_WIDTH)  w = CANVAS_WIDTH - x;
+  if (y + h > CANVAS_HEIGHT) h = CANVAS_HEIGHT - y;
+  return w > 0 && h > 0;
+}
+
+/**
+ * @brief recompute tileUsed for the tiles overlapping a (clipped) rectangle
+ */
+void OverlayLayer::updateTiles(int16_t x, int16_t y, int16_t w, int16_t h) {
+  for (int ty = y / CANVAS_TILE_SIZE; ty <= (y + h - 1) / CANVAS_TILE_SIZE; ty++) {
+    const uint8_t* rows = &coverage[ty * CANVAS_TILE_SIZE * COVERAGE_STRIDE];
+    for (int tx = x / CANVAS_TILE_SIZE; tx <= (x + w - 1) / CANVAS_TILE_SIZE; tx++) {
+      uint8_t any = 0;
+      for (int r = 0; r < CANVAS_TILE_SIZE; r++) any |= rows[r * COVERAGE_STRIDE + tx];
+      if (any) tileUsed[ty] |= (1u << tx);
+      else     tileUsed[ty] &= ~(1u << tx);
+    }
+  }
+}
+
+/**
+ * @brief cover a pixel
+ */
+void OverlayLayer::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (!buffer || x < 0 || y < 0 || x >= CANVAS_WIDTH || y >= CANVAS_HEIGHT) return;
+
+  uint8_t& cov = coverage[y * COVERAGE_STRIDE + x / 8];
+  uint8_t bit = 0x80 >> (x & 7);
+  uint16_t* p = &buffer[y * CANVAS_WIDTH + x];
+  if ((cov & bit) && *p == color) return;   // no damage if nothing changed
+
+  *p = color;
+  cov |= bit;
+  tileUsed[y / CANVAS_TILE_SIZE] |= (1u << (x / CANVAS_TILE_SIZE));
+  canvas->markDirty(x, y, 1, 1);
+}
+
+/**
+ * @brief cover a rectangle (clipped)
+ */
+void OverlayLayer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (!clip(x, y, w, h)) return;
+
+  blitFill(&buffer[y * CANVAS_WIDTH + x], CANVAS_WIDTH, w, h, color);
+  for (int row = y; row < y + h; row++) {
+    for (int col = x; col < x + w; col++) coverage[row * COVERAGE_STRIDE + col / 8] |= 0x80 >> (col & 7);
+  }
+  updateTiles(x, y, w, h);
+  canvas->markDirty(x, y, w, h);
+}
+
+void OverlayLayer::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+void OverlayLayer::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+/**
+ * @brief uncover a rectangle (clipped). only tiles that were covered are damaged
+ */
+void OverlayLayer::clear(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (!clip(x, y, w, h)) return;
+
+  for (int ty = y / CANVAS_TILE_SIZE; ty <= (y + h - 1) / CANVAS_TILE_SIZE; ty++) {
+    for (int tx = x / CANVAS_TILE_SIZE; tx <= (x + w - 1) / CANVAS_TILE_SIZE; tx++) {
+      if (isTileUsed(tx, ty)) {
+        canvas->markDirty(tx * CANVAS_TILE_SIZE, ty * CANVAS_TILE_SIZE, CANVAS_TILE_SIZE, CANVAS_TILE_SIZE);
+      }
+    }
+  }
+  for (int row = y; row < y + h; row++) {
+    for (int col = x; col < x + w; col++) coverage[row * COVERAGE_STRIDE + col / 8] &= ~(0x80 >> (col & 7));
+  }
+  updateTiles(x, y, w, h);
+}
+
+void OverlayLayer::clear() {
+  clear(0, 0, CANVAS_WIDTH, CANVAS_HEIGHT);
+}
+
+/**
+ * @brief put the covered pixels of a row span over dst (which holds the canvas pixels of the same span)
+ *
+ * @param dst w pixels
+ * @param x logical x of the first pixel
+ * @param y logical y
+ * @param w pixels (x .. x+w-1 have to be on the canvas)
+ */
+void OverlayLayer::composeRow(uint16_t* dst, int16_t x, int16_t y, int w) const {
+  const uint8_t* cov = &coverage[y * COVERAGE_STRIDE];
+  const uint16_t* src = &buffer[y * CANVAS_WIDTH];
+  for (int i = 0; i < w; i++) {
+    int col = x + i;
+    if (cov[col / 8] & (0x80 >> (col & 7))) dst[i] = src[col];
+  }
+}
@@ -0,0 +1,155 @@
+/**
+ * @file Scaler.cpp
+ * @brief implementation of the image scaler
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Reducing src pixels to dst pixels: measured in 1/dst of a source pixel, output pixel j covers [j*src, (j+1)*src) and
+ * source pixel i covers [i*dst, (i+1)*dst), so every overlap is a whole number. An output pixel is the sum of its source
+ * pixels times (column overlap * row overlap), divided by srcW * srcH, per color channel, without any rounding until
+ * the final divide.
+ *
+ */
+
+#include "Display/Scaler.h"
+#include "Display/Blitter.h"
+#include <string.h>
+
+// channel sums of the output row being reduced
+static uint32_t sumR[SCALER_MAX_SIZE];
+static uint32_t sumG[SCALER_MAX_SIZE];
+static uint32_t sumB[SCALER_MAX_SIZE];
+
+/**
+ * @brief source span and edge weights of each of the dst output pixels along one axis
+ */
+static void buildSpans(ScaleSpan* spans, int src, int dst) {
+  for (int j = 0; j < dst; j++) {
+    int32_t start = (int32_t)j * src;
+    int32_t end = start + src;
+    ScaleSpan& s = spans[j];
+    s.first = start / dst;
+    s.last = (end - 1) / dst;
+    int32_t firstEnd = (int32_t)(s.first + 1) * dst;
+    int32_t lastStart = (int32_t)s.last * dst;
+    s.firstWeight = (firstEnd < end ? firstEnd : end) - start;
+    s.lastWeight = end - (lastStart > start ? lastStart : start);
+  }
+}
+
+static uint16_t weightOf(const ScaleSpan& s, int i, int full) {
+  if (i == s.first) return s.firstWeight;
+  if (i == s.last) return s.lastWeight;
+  return full;
+}
+
+/**
+ * @brief work out how a srcW x srcH image goes into an areaW x areaH area
+ *
+ * @return false if it cannot be placed (empty image or area, or a reduced output bigger than SCALER_MAX_SIZE)
+ */
+bool scaleFit(ScaleMap* m, int srcW, int srcH, int areaW, int areaH) {
+  if (srcW <= 0 || srcH <= 0 || areaW <= 0 || areaH <= 0) return false;
+  m->srcW = srcW;
+  m->srcH = srcH;
+
+  if (srcW <= areaW && srcH <= areaH) {
+    int sx = areaW / srcW, sy = areaH / srcH;
+    m->scale = sx < sy ? sx : sy;
+    m->dstW = srcW * m->scale;
+    m->dstH = srcH * m->scale;
+  }
+  else {
+    // the side that overflows more decides, the other one keeps the aspect ratio (rounded, at least one pixel)
+    m->scale = 0;
+    if ((int32_t)srcW * areaH >= (int32_t)srcH * areaW) {
+      m->dstW = areaW;
+      m->dstH = ((int32_t)srcH * areaW * 2 + srcW) / (2 * srcW);
+    } else {
+      m->dstH = areaH;
+      m->dstW = ((int32_t)srcW * areaH * 2 + srcH) / (2 * srcH);
+    }
+    if (m->dstW < 1) m->dstW = 1;
+    if (m->dstH < 1) m->dstH = 1;
+    if (m->dstW > SCALER_MAX_SIZE || m->dstH > SCALER_MAX_SIZE) return false;
+    buildSpans(m->cols, srcW, m->dstW);
+    buildSpans(m->rows, srcH, m->dstH);
+  }
+
+  m->x = (areaW - m->dstW) / 2;
+  m->y = (areaH - m->dstH) / 2;
+  return true;
+}
+
+/**
+ * @brief draw the image into the area (only the output rectangle is written, the rest of the area is left alone)
+ *
+ * @param m placement from scaleFit()
+ * @param row source rows
+ * @param area top left of the area scaleFit() was given
+ * @param areaStride pixels per row of the area
+ */
+void scaleRender(const ScaleMap* m, ScaleRowFn row, void* ctx, uint16_t* area, int areaStride) {
+  uint16_t* out = area + m->y * areaStride + m->x;
+
+  if (m->scale) {
+    for (int y = 0; y < m->srcH; y++) {
+      blitScaled(out + y * m->scale * areaStride, areaStride, row(ctx, y), m->srcW, m->srcW, 1, m->scale);
+    }
+    return;
+  }
+
+  uint32_t area2 = (uint32_t)m->srcW * m->srcH;
+  for (int j = 0; j < m->dstH; j++, out += areaStride) {
+    const ScaleSpan& rs = m->rows[j];
+    memset(sumR, 0, m->dstW * sizeof(uint32_t));
+    memset(sumG, 0, m->dstW * sizeof(uint32_t));
+    memset(sumB, 0, m->dstW * sizeof(uint32_t));
+
+    for (int r = rs.first; r <= rs.last; r++) {
+      uint32_t wr = weightOf(rs, r, m->dstH);
+      const uint16_t* line = row(ctx, r);
+
+      for (int i = 0; i < m->dstW; i++) {
+        const ScaleSpan& cs = m->cols[i];
+        uint32_t red = 0, green = 0, blue = 0;
+        for (int c = cs.first; c <= cs.last; c++) {
+          uint32_t wc = weightOf(cs, c, m->dstW);
+          uint16_t p = line[c];
+          red += wc * (p >> 11);
+          green += wc * ((p >> 5) & 0x3F);
+          blue += wc * (p & 0x1F);
+        }
+        sumR[i] += wr * red;
+        sumG[i] += wr * green;
+        sumB[i] += wr * blue;
+      }
+    }
+
+    for (int i = 0; i < m->dstW; i++) {
+      uint16_t red = (sumR[i] + area2 / 2) / area2;
+      uint16_t green = (sumG[i] + area2 / 2) / area2;
+      uint16_t blue = (sumB[i] + area2 / 2) / area2;
+      out[i] = (red << 11) | (green << 5) | blue;
+    }
+  }
+}
+
+struct BufferSource {
+  const uint16_t* pixels;
+  int stride;
+};
+
+static const uint16_t* bufferRow(void* ctx, int y) {
+  BufferSource* b = (BufferSource*)ctx;
+  return b->pixels + y * b->stride;
+}
+
+/**
+ * @brief scaleRender() from an RGB565 image in memory
+ */
+void scaleRenderBuffer(const ScaleMap* m, const uint16_t* src, int srcStride, uint16_t* area, int areaStride) {
+  BufferSource b = { src, srcStride };
+  scaleRender(m, bufferRow, &b, area, areaStride);
+}
@@ -0,0 +1,299 @@
+/**
+ * @file VirtualCanvas.cpp
+ * @brief tiled virtual canvas on top of the HUB75 panel chain
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The HUB75 library sees a chain of panels as one long strip (panel k owns physical columns k*64 .. k*64+63). We want to
+ * lay the panels out as a grid instead, so every program draws into a logical framebuffer and this file translates logical
+ * pixels into (chain position, rotation) when the damaged tiles are pushed out.
+ *
+ * Pushing only the damaged tiles is what keeps things fast as more panels are chained: a menu redraw touches a handful of
+ * 8x8 tiles, not all 16k pixels of a 2x2 wall.
+ *
+ */
+
+#include "Display/VirtualCanvas.h"
+#include "Display/Blitter.h"
+#include "Display/Overlay.h"
+#include <new>
+
+static_assert(CANVAS_TILES_X <= 32, "tile dirty mask is one uint32_t per tile row");
+static_assert(PANEL_WIDTH % CANVAS_TILE_SIZE == 0 && PANEL_HEIGHT % CANVAS_TILE_SIZE == 0, "tiles must not straddle panels");
+
+/**
+ * @brief Construct a new Virtual Canvas
+ *
+ * @param panel the (already configured) chain of panels
+ * @param layout chain wiring order
+ * @param rotation how every panel is mounted
+ */
+VirtualCanvas::VirtualCanvas(MatrixPanel_I2S_DMA* panel, PanelChainLayout layout, PanelRotation rotation)
+  : Adafruit_GFX(CANVAS_WIDTH, CANVAS_HEIGHT), panel(panel), layout(layout), rotation(rotation), buffer(nullptr),
+    layerCount(0) {
+  memset(tileDirty, 0, sizeof(tileDirty));
+}
+
+VirtualCanvas::~VirtualCanvas() {
+  delete[] buffer;
+}
+
+/**
+ * @brief allocate the framebuffer
+ *
+ * done after the panel has been started so the DMA buffers get first pick of the heap
+ *
+ * @return true if the framebuffer could be allocated
+ */
+bool VirtualCanvas::begin() {
+  buffer = new (std::nothrow) uint16_t[CANVAS_WIDTH * CANVAS_HEIGHT];
+  if (!buffer) return false;
+
+  memset(buffer, 0, CANVAS_WIDTH * CANVAS_HEIGHT * sizeof(uint16_t));
+  markDirty(0, 0, CANVAS_WIDTH, CANVAS_HEIGHT);
+  return true;
+}
+
+/**
+ * @brief translate a logical pixel into its physical location on the chain
+ *
+ * 1. find which panel of the grid the pixel lives in
+ * 2. find that panel's position along the chain (serpentine reverses odd rows)
+ * 3. rotate the pixel inside the panel for how it is mounted
+ *
+ * @param x logical x
+ * @param y logical y
+ * @param px physical x along the chain
+ * @param py physical y
+ */
+void VirtualCanvas::mapToPhysical(int16_t x, int16_t y, int16_t* px, int16_t* py) const {
+  int tileCol = x / PANEL_WIDTH;
+  int tileRow = y / PANEL_HEIGHT;
+  int lx = x % PANEL_WIDTH;
+  int ly = y % PANEL_HEIGHT;
+
+  int chainIndex;
+  int rot = rotation;
+  if (layout == CHAIN_SERPENTINE && (tileRow & 1)) {
+    chainIndex = tileRow * PANEL_TILE_COLS + (PANEL_TILE_COLS - 1 - tileCol);
+    rot = (rot + ROTATE_180) & 3;          // upside down panels on the way back
+  } else {
+    chainIndex = tileRow * PANEL_TILE_COLS + tileCol;
+  }
+
+  int rx, ry;
+  switch (rot) {
+    case ROTATE_90:  rx = PANEL_WIDTH - 1 - ly;  ry = lx;                     break;
+    case ROTATE_180: rx = PANEL_WIDTH - 1 - lx;  ry = PANEL_HEIGHT - 1 - ly;  break;
+    case ROTATE_270: rx = ly;                    ry = PANEL_HEIGHT - 1 - lx;  break;
+    default:         rx = lx;                    ry = ly;                     break;
+  }
+
+  *px = chainIndex * PANEL_WIDTH + rx;
+  *py = ry;
+}
+
+/**
+ * @brief mark every tile overlapping the rectangle as damaged
+ *
+ * rectangle must already be clipped to the canvas
+ */
+void VirtualCanvas::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (w <= 0 || h <= 0) return;
+
+  int tx0 = x / CANVAS_TILE_SIZE;
+  int tx1 = (x + w - 1) / CANVAS_TILE_SIZE;
+  int ty0 = y / CANVAS_TILE_SIZE;
+  int ty1 = (y + h - 1) / CANVAS_TILE_SIZE;
+
+  // bits tx0..tx1 inclusive
+  uint32_t mask = (tx1 - tx0 == 31) ? 0xFFFFFFFFu : (((1u << (tx1 - tx0 + 1)) - 1) << tx0);
+  for (int ty = ty0; ty <= ty1; ty++) {
+    tileDirty[ty] |= mask;
+  }
+}
+
+/**
+ * @brief put an overlay on top of the canvas (and of the overlays already attached)
+ *
+ * @return false if CANVAS_MAX_LAYERS are attached already
+ */
+bool VirtualCanvas::attachLayer(OverlayLayer* layer) {
+  for (int i = 0; i < layerCount; i++) {
+    if (layers[i] == layer) return true;
+  }
+  if (layerCount == CANVAS_MAX_LAYERS) return false;
+
+  layers[layerCount++] = layer;
+  markDirty(0, 0, CANVAS_WIDTH, CANVAS_HEIGHT);   // whatever it already holds shows up
+  return true;
+}
+
+/**
+ * @brief take an overlay off again. the canvas under it reappears on the next flush
+ */
+void VirtualCanvas::detachLayer(OverlayLayer* layer) {
+  for (int i = 0; i < layerCount; i++) {
+    if (layers[i] != layer) continue;
+    for (int j = i; j < layerCount - 1; j++) layers[j] = layers[j + 1];
+    layerCount--;
+    markDirty(0, 0, CANVAS_WIDTH, CANVAS_HEIGHT);
+    return;
+  }
+}
+
+/**
+ * @brief check whether a tile will be pushed on the next flush
+ */
+bool VirtualCanvas::isTileDirty(int tx, int ty) const {
+  return (tileDirty[ty] >> tx) & 1;
+}
+
+/**
+ * @brief write a single pixel
+ */
+void VirtualCanvas::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= CANVAS_WIDTH || y >= CANVAS_HEIGHT) return;
+
+  uint16_t* p = &buffer[y * CANVAS_WIDTH + x];
+  if (*p == color) return;              // no damage if nothing changed
+
+  *p = color;
+  tileDirty[y / CANVAS_TILE_SIZE] |= (1u << (x / CANVAS_TILE_SIZE));
+}
+
+/**
+ * @brief read back a pixel from the framebuffer
+ */
+uint16_t VirtualCanvas::getPixel(int16_t x, int16_t y) const {
+  if (x < 0 || y < 0 || x >= CANVAS_WIDTH || y >= CANVAS_HEIGHT) return 0;
+  return buffer[y * CANVAS_WIDTH + x];
+}
+
+/**
+ * @brief fill a rectangle (clipped) straight into the framebuffer
+ */
+void VirtualCanvas::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  // clip
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > CANVAS_WIDTH)  w = CANVAS_WIDTH - x;
+  if (y + h > CANVAS_HEIGHT) h = CANVAS_HEIGHT - y;
+  if (w <= 0 || h <= 0) return;
+
+  blitFill(&buffer[y * CANVAS_WIDTH + x], CANVAS_WIDTH, w, h, color);
+  markDirty(x, y, w, h);
+}
+
+void VirtualCanvas::fillScreen(uint16_t color) {
+  fillRect(0, 0, CANVAS_WIDTH, CANVAS_HEIGHT, color);
+}
+
+void VirtualCanvas::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+void VirtualCanvas::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+/**
+ * @brief draw an RGB565 image magnified by an integer scale
+ *
+ * the common case (image fully on the canvas) goes through the blitter. Anything hanging off an edge falls back to one
+ * clipped fillRect per source pixel.
+ *
+ * @param src source pixels, srcW x srcH, tightly packed
+ * @param scale integer magnification
+ * @param x logical x of the top left corner
+ * @param y logical y of the top left corner
+ */
+void VirtualCanvas::drawScaled(const uint16_t* src, int srcW, int srcH, int scale, int16_t x, int16_t y) {
+  int w = srcW * scale;
+  int h = srcH * scale;
+
+  if (x >= 0 && y >= 0 && x + w <= CANVAS_WIDTH && y + h <= CANVAS_HEIGHT) {
+    blitScaled(&buffer[y * CANVAS_WIDTH + x], CANVAS_WIDTH, src, srcW, srcW, srcH, scale);
+    markDirty(x, y, w, h);
+    return;
+  }
+
+  for (int sy = 0; sy < srcH; sy++) {
+    for (int sx = 0; sx < srcW; sx++) {
+      fillRect(x + sx * scale, y + sy * scale, scale, scale, src[sy * srcW + sx]);
+    }
+  }
+}
+
+/**
+ * @brief copy one tile out to the panel chain
+ *
+ * tiles never straddle panels, so the chain offset and rotation are the same for the whole tile. The unrotated case
+ * (by far the most common) skips the per pixel mapping completely.
+ *
+ * If an overlay covers part of the tile, the tile is composited into a small scratch copy first (canvas, then every
+ * overlay that uses the tile, bottom to top) and that is pushed instead. The framebuffer itself is never changed.
+ */
+void VirtualCanvas::pushTile(int tx, int ty) {
+  int x0 = tx * CANVAS_TILE_SIZE;
+  int y0 = ty * CANVAS_TILE_SIZE;
+
+  const uint16_t* tile = &buffer[y0 * CANVAS_WIDTH + x0];
+  int stride = CANVAS_WIDTH;
+
+  uint16_t composed[CANVAS_TILE_SIZE * CANVAS_TILE_SIZE];
+  for (int i = 0; i < layerCount; i++) {
+    if (!layers[i]->isTileUsed(tx, ty)) continue;
+    if (tile != composed) {
+      blitCopy(composed, CANVAS_TILE_SIZE, tile, CANVAS_WIDTH, CANVAS_TILE_SIZE, CANVAS_TILE_SIZE);
+      tile = composed;
+      stride = CANVAS_TILE_SIZE;
+    }
+    for (int y = 0; y < CANVAS_TILE_SIZE; y++) {
+      layers[i]->composeRow(&composed[y * CANVAS_TILE_SIZE], x0, y0 + y, CANVAS_TILE_SIZE);
+    }
+  }
+
+  int16_t px, py;
+  mapToPhysical(x0, y0, &px, &py);
+
+  bool flipped = (layout == CHAIN_SERPENTINE) && ((y0 / PANEL_HEIGHT) & 1);
+  if (rotation == ROTATE_0 && !flipped) {
+    for (int y = 0; y < CANVAS_TILE_SIZE; y++) {
+      const uint16_t* src = &tile[y * stride];
+      for (int x = 0; x < CANVAS_TILE_SIZE; x++) {
+        panel->drawPixel(px + x, py + y, src[x]);
+      }
+    }
+    return;
+  }
+
+  for (int y = 0; y < CANVAS_TILE_SIZE; y++) {
+    const uint16_t* src = &tile[y * stride];
+    for (int x = 0; x < CANVAS_TILE_SIZE; x++) {
+      mapToPhysical(x0 + x, y0 + y, &px, &py);
+      panel->drawPixel(px, py, src[x]);
+    }
+  }
+}
+
+/**
+ * @brief push all damaged tiles out to the panels and clear the damage
+ *
+ * called once at the end of every pass of loop(). Nothing is sent if nothing was drawn.
+ */
+void VirtualCanvas::flush() {
+  if (!buffer) return;
+
+  for (int ty = 0; ty < CANVAS_TILES_Y; ty++) {
+    uint32_t bits = tileDirty[ty];
+    tileDirty[ty] = 0;
+
+    while (bits) {
+      int tx = __builtin_ctz(bits);
+      bits &= bits - 1;
+      pushTile(tx, ty);
+    }
+  }
+}
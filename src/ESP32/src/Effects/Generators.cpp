@@ -0,0 +1,148 @@
+/**
+ * @file Generators.cpp
+ * @brief implementation of the plasma and fire generators
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Plasma: sum of three sine waves (x, y, diagonal) moving at different speeds, looked up in a 256 color palette. The
+ * x wave only depends on x and t, so it is computed once per column per frame instead of once per pixel.
+ *
+ * Fire: the classic heat buffer. The bottom row is the fuel, every other cell copies the cell below it (with a random
+ * sideways drift) minus a random amount of cooling, and the heat indexes a black -> red -> yellow -> white palette.
+ *
+ */
+
+#include "Effects/Generators.h"
+
+// widest buffer the plasma column cache handles
+static const int MAX_PLASMA_WIDTH = 256;
+
+static int8_t sinTable[256];
+static bool sinReady = false;
+
+static inline uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b) {
+  return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+/**
+ * @brief integer sine, 256 steps per turn, -127..127
+ *
+ * each half wave is the parabola x * (128 - x), which is within 6% of a real sine and needs no floating point
+ */
+int8_t fxSin(uint8_t angle) {
+  if (!sinReady) {
+    for (int a = 0; a < 128; a++) {
+      int8_t v = (int8_t)((a * (128 - a) * 127) / 4096);
+      sinTable[a] = v;
+      sinTable[a + 128] = -v;
+    }
+    sinReady = true;
+  }
+  return sinTable[angle];
+}
+
+/**
+ * @brief smooth looping rainbow for the plasma
+ */
+void plasmaPalette(uint16_t* palette) {
+  for (int i = 0; i < PLASMA_PALETTE_SIZE; i++) {
+    uint8_t r = 128 + fxSin(i);
+    uint8_t g = 128 + fxSin(i + 85);
+    uint8_t b = 128 + fxSin(i + 170);
+    palette[i] = rgb565(r, g, b);
+  }
+}
+
+/**
+ * @brief render one plasma frame
+ *
+ * @param dst top left pixel to render to
+ * @param dstStride pixels per row of dst
+ * @param w, h size of the area (w is clamped to 256)
+ * @param t time in frames, the pattern loops every 256
+ * @param palette PLASMA_PALETTE_SIZE colors
+ */
+void plasmaRender(uint16_t* dst, int dstStride, int w, int h, uint16_t t, const uint16_t* palette) {
+  int8_t column[MAX_PLASMA_WIDTH];
+  if (w > MAX_PLASMA_WIDTH) w = MAX_PLASMA_WIDTH;
+
+  for (int x = 0; x < w; x++) column[x] = fxSin((uint8_t)(x * 4 + t));
+
+  for (int y = 0; y < h; y++) {
+    int rowWave = fxSin((uint8_t)(y * 3 - t * 2));
+    uint16_t* row = dst + y * dstStride;
+    for (int x = 0; x < w; x++) {
+      int sum = column[x] + rowWave + fxSin((uint8_t)((x + y) * 2 + t * 3));
+      row[x] = palette[(uint8_t)((sum >> 1) + t)];
+    }
+  }
+}
+
+/**
+ * @brief FIRE_LEVELS colors from black through red and yellow to white
+ */
+void firePalette(uint16_t* palette) {
+  for (int i = 0; i < FIRE_LEVELS; i++) {
+    int heat = i * 768 / FIRE_LEVELS;            // 0..767 across three bands
+    uint8_t r = heat > 255 ? 255 : heat;
+    uint8_t g = heat > 511 ? 255 : (heat > 255 ? heat - 256 : 0);
+    uint8_t b = heat > 511 ? heat - 512 : 0;
+    palette[i] = rgb565(r, g, b);
+  }
+}
+
+static inline uint32_t xorshift(uint32_t* state) {
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+/**
+ * @brief advance the fire one step
+ *
+ * @param heat w * h cells, row 0 at the top, values 0..FIRE_LEVELS-1
+ * @param rng xorshift state
+ * @param cooling max heat lost per row moved up (random 0..cooling-1). larger = shorter flames
+ * @param burning fuel on (false lets the fire die down)
+ */
+void fireStep(uint8_t* heat, int w, int h, uint32_t* rng, uint8_t cooling, bool burning) {
+  static const int8_t DRIFT[4] = { -1, 0, 1, 0 };
+  if (cooling == 0) cooling = 1;
+
+  uint8_t* fuel = heat + (h - 1) * w;
+  for (int x = 0; x < w; x++) {
+    fuel[x] = burning ? (FIRE_LEVELS - 1 - (xorshift(rng) & 7)) : 0;
+  }
+
+  // one random word feeds several cells: 2 bits of drift, 6 bits of cooling
+  for (int y = 0; y < h - 1; y++) {
+    const uint8_t* below = heat + (y + 1) * w;
+    uint8_t* row = heat + y * w;
+    uint32_t bits = 0;
+    for (int x = 0; x < w; x++) {
+      if ((x & 3) == 0) bits = xorshift(rng);
+      int sx = x + DRIFT[bits & 3];
+      if (sx < 0) sx = 0;
+      if (sx >= w) sx = w - 1;
+
+      int v = below[sx] - (int)((bits >> 2) & 63) % cooling;
+      row[x] = v > 0 ? v : 0;
+      bits >>= 8;
+    }
+  }
+}
+
+/**
+ * @brief map heat to colors
+ */
+void fireRender(uint16_t* dst, int dstStride, const uint8_t* heat, int w, int h, const uint16_t* palette) {
+  for (int y = 0; y < h; y++) {
+    const uint8_t* src = heat + y * w;
+    uint16_t* row = dst + y * dstStride;
+    for (int x = 0; x < w; x++) row[x] = palette[src[x]];
+  }
+}
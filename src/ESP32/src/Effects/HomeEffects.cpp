@@ -0,0 +1,143 @@
+/**
+ * @file HomeEffects.cpp
+ * @brief implementation of the animated home screen background
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Runs at a fixed frame rate. Sparks are only drawn on pixels that are black in the home screen layout and are erased
+ * by putting the black back (only if the pixel still holds the spark's color), so the menu text is never disturbed
+ * and the home screen does not have to redraw anything.
+ *
+ * Every frame is timed: when a frame goes over FRAME_BUDGET_US the spark rate is lowered, when frames are cheap it
+ * creeps back up, so the effect never eats into input handling.
+ *
+ */
+
+#include "Effects/HomeEffects.h"
+#include "Effects/Generators.h"
+#include "Effects/Particles.h"
+#include <Arduino.h>
+
+static const unsigned long FRAME_MS = 33;
+static const unsigned long FRAME_BUDGET_US = 3000;
+
+static const int FIRE_ROWS = 6;
+static const uint8_t FIRE_COOLING = 20;
+static const uint8_t MAX_SPARKS_PER_FRAME = 3;
+static const uint8_t SPARK_LIFE = 40;
+
+static VirtualCanvas* display;
+static int16_t navbarRow;
+static unsigned long lastFrame = 0;
+static uint16_t frame = 0;
+static uint8_t sparkRate = 1;
+
+// preallocated effect state
+static uint8_t heat[FIRE_ROWS * CANVAS_WIDTH];
+static uint16_t firePal[FIRE_LEVELS];
+static uint16_t plasmaPal[PLASMA_PALETTE_SIZE];
+static ParticlePool sparks;
+static bool sparkDrawn[MAX_PARTICLES];
+static int16_t sparkX[MAX_PARTICLES], sparkY[MAX_PARTICLES];
+static uint16_t sparkColor[MAX_PARTICLES];
+static bool palettesReady = false;
+static uint32_t fireRng = 0x1234567;
+
+/**
+ * @brief restart the effects after the home screen was (re)drawn
+ *
+ * @param disp canvas
+ * @param navbarY row of the navbar border line, -1 for none
+ * @param now millis()
+ */
+void homeEffectsReset(VirtualCanvas* disp, int16_t navbarY, unsigned long now) {
+  display = disp;
+  navbarRow = navbarY;
+
+  // the fire keeps burning across menu redraws, only the first reset starts it cold
+  if (!palettesReady) {
+    firePalette(firePal);
+    plasmaPalette(plasmaPal);
+    memset(heat, 0, sizeof(heat));
+    palettesReady = true;
+  }
+
+  particlesInit(&sparks, 6, now | 1);
+  for (int i = 0; i < MAX_PARTICLES; i++) sparkDrawn[i] = false;
+  lastFrame = now;
+}
+
+/**
+ * @brief take sparks off the screen, restoring black where they were
+ */
+static void eraseSparks() {
+  for (int i = 0; i < MAX_PARTICLES; i++) {
+    if (!sparkDrawn[i]) continue;
+    if (display->getPixel(sparkX[i], sparkY[i]) == sparkColor[i]) display->drawPixel(sparkX[i], sparkY[i], 0);
+    sparkDrawn[i] = false;
+  }
+}
+
+/**
+ * @brief draw live sparks on black pixels only. color follows the fire palette and cools with age
+ */
+static void drawSparks(int fireTop) {
+  for (int i = 0; i < MAX_PARTICLES; i++) {
+    const Particle& p = sparks.particles[i];
+    if (!p.life) continue;
+
+    int16_t x = FX_PX(p.x), y = FX_PX(p.y);
+    if (y >= fireTop || display->getPixel(x, y) != 0) continue;
+
+    uint16_t color = firePal[(FIRE_LEVELS - 1) * p.life / p.maxLife];
+    if (color == 0) continue;
+    display->drawPixel(x, y, color);
+    sparkDrawn[i] = true;
+    sparkX[i] = x;
+    sparkY[i] = y;
+    sparkColor[i] = color;
+  }
+}
+
+/**
+ * @brief advance and draw one frame when due
+ *
+ * @param now millis()
+ */
+void homeEffectsUpdate(unsigned long now) {
+  if (!display || now - lastFrame < FRAME_MS) return;
+  lastFrame = now;
+  frame++;
+
+  unsigned long start = micros();
+  int w = display->width();
+  int fireTop = display->height() - FIRE_ROWS;
+  uint16_t* buffer = display->getBuffer();
+
+  // fire band
+  fireStep(heat, w, FIRE_ROWS, &fireRng, FIRE_COOLING, true);
+  fireRender(buffer + fireTop * CANVAS_WIDTH, CANVAS_WIDTH, heat, w, FIRE_ROWS, firePal);
+  display->markDirty(0, fireTop, w, FIRE_ROWS);
+
+  // plasma navbar border
+  if (navbarRow >= 0) {
+    plasmaRender(buffer + navbarRow * CANVAS_WIDTH, CANVAS_WIDTH, w, 1, frame, plasmaPal);
+    display->markDirty(0, navbarRow, w, 1);
+  }
+
+  // sparks rise out of the hottest columns of the fire's top row
+  eraseSparks();
+  for (int n = 0; n < sparkRate; n++) {
+    int x = particlesRandom(&sparks) % w;
+    if (heat[x] < FIRE_LEVELS / 2) continue;
+    particlesSpawnSpread(&sparks, FX(x), FX(fireTop), -FX(1) + 64, 48, SPARK_LIFE);
+  }
+  particlesStep(&sparks, 0, navbarRow + 1, w - 1, fireTop);
+  drawSparks(fireTop);
+
+  // adapt the spark rate to the frame budget
+  unsigned long spent = micros() - start;
+  if (spent > FRAME_BUDGET_US && sparkRate > 0) sparkRate--;
+  else if (spent < FRAME_BUDGET_US / 2 && sparkRate < MAX_SPARKS_PER_FRAME) sparkRate++;
+}
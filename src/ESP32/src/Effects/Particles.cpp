@@ -0,0 +1,93 @@
+/**
+ * @file Particles.cpp
+ * @brief implementation of the fixed-point particle pool
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Free slots are the ones with life == 0. Spawning scans for one, which is fine at this pool size and keeps the pool a
+ * plain array the step loop can walk without any indirection. Randomness comes from the pool's own xorshift state, so
+ * the same seed and inputs always give the same frames.
+ *
+ */
+
+#include "Effects/Particles.h"
+
+/**
+ * @brief empty the pool
+ *
+ * @param gravity Q8.8 pixels per step per step (positive is down)
+ * @param seed xorshift seed, 0 is replaced
+ */
+void particlesInit(ParticlePool* pool, int16_t gravity, uint32_t seed) {
+  for (int i = 0; i < MAX_PARTICLES; i++) pool->particles[i].life = 0;
+  pool->gravity = gravity;
+  pool->active = 0;
+  pool->rng = seed ? seed : 0x9E3779B9;
+}
+
+/**
+ * @brief xorshift32 step of the pool's generator
+ */
+uint32_t particlesRandom(ParticlePool* pool) {
+  uint32_t x = pool->rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  pool->rng = x;
+  return x;
+}
+
+/**
+ * @brief add a particle
+ *
+ * @return false if the pool is full (the particle is dropped)
+ */
+bool particlesSpawn(ParticlePool* pool, int32_t x, int32_t y, int16_t vx, int16_t vy, uint8_t life) {
+  if (pool->active >= MAX_PARTICLES || life == 0) return false;
+
+  for (int i = 0; i < MAX_PARTICLES; i++) {
+    Particle& p = pool->particles[i];
+    if (p.life) continue;
+    p.x = x;
+    p.y = y;
+    p.vx = vx;
+    p.vy = vy;
+    p.life = life;
+    p.maxLife = life;
+    pool->active++;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief add a particle with a random horizontal velocity in [-spread, spread] and a random life up to life
+ */
+bool particlesSpawnSpread(ParticlePool* pool, int32_t x, int32_t y, int16_t vy, int16_t spread, uint8_t life) {
+  uint32_t r = particlesRandom(pool);
+  int16_t vx = (int16_t)((int32_t)(r & 0x1FF) * spread / 256) - spread;
+  uint8_t l = life / 2 + (uint8_t)((r >> 9) % (life / 2 + 1));
+  return particlesSpawn(pool, x, y, vx, vy, l);
+}
+
+/**
+ * @brief move every particle one step, killing the ones that expire or leave the box
+ *
+ * box is in whole pixels, inclusive
+ */
+void particlesStep(ParticlePool* pool, int16_t minX, int16_t minY, int16_t maxX, int16_t maxY) {
+  for (int i = 0; i < MAX_PARTICLES; i++) {
+    Particle& p = pool->particles[i];
+    if (!p.life) continue;
+
+    p.vy += pool->gravity;
+    p.x += p.vx;
+    p.y += p.vy;
+    p.life--;
+
+    int32_t px = FX_PX(p.x), py = FX_PX(p.y);
+    if (px < minX || px > maxX || py < minY || py > maxY) p.life = 0;
+    if (!p.life) pool->active--;
+  }
+}
@@ -0,0 +1,157 @@
+/**
+ * @file Transition.cpp
+ * @brief implementation of the screen transitions
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Two full canvas snapshots: the outgoing screen (taken by transitionCapture) and the incoming one (taken by
+ * transitionStart, after the new screen drew itself normally). Every frame the canvas is recomposed from the two, so
+ * screens need no changes to take part. Both buffers are allocated once in transitionInit(); if that fails the
+ * transitions are skipped and screens change instantly like before.
+ *
+ * Anything that draws to the canvas while a transition runs would be overwritten by the next frame, so main.cpp calls
+ * transitionFinish() before handling input.
+ *
+ */
+
+#include "Effects/Transition.h"
+#include "Display/Blitter.h"
+#include <new>
+
+static uint16_t* fromBuffer = nullptr;
+static uint16_t* toBuffer = nullptr;
+
+static VirtualCanvas* target = nullptr;
+static TransitionType activeType;
+static unsigned long startTime;
+static bool captured = false;
+static bool running = false;
+
+/**
+ * @brief per pixel dissolve threshold, a cheap integer hash of the position so pixels flip in a scattered order
+ */
+static inline uint8_t dissolveThreshold(int x, int y) {
+  uint32_t v = (uint32_t)x | ((uint32_t)y << 16);
+  v ^= v >> 7;
+  v *= 0x2C1B3C6D;
+  v ^= v >> 12;
+  v *= 0x297A2D39;
+  v ^= v >> 15;
+  return (uint8_t)v;
+}
+
+/**
+ * @brief compose one frame of a transition
+ *
+ * @param dst output
+ * @param from outgoing screen
+ * @param to incoming screen
+ * @param srcStride pixels per row of from / to
+ * @param progress 0 (all from) .. TRANSITION_FULL (all to)
+ */
+void transitionCompose(uint16_t* dst, int dstStride, const uint16_t* from, const uint16_t* to, int srcStride, int w,
+                       int h, TransitionType type, uint16_t progress) {
+  if (progress > TRANSITION_FULL) progress = TRANSITION_FULL;
+  int split = (w * progress) / TRANSITION_FULL;
+
+  switch (type) {
+    case TRANSITION_WIPE:
+      // incoming screen uncovered left to right
+      blitCopy(dst, dstStride, to, srcStride, split, h);
+      blitCopy(dst + split, dstStride, from + split, srcStride, w - split, h);
+      break;
+
+    case TRANSITION_SLIDE:
+      // outgoing screen pushed out to the left by the incoming one
+      blitCopy(dst, dstStride, from + split, srcStride, w - split, h);
+      blitCopy(dst + (w - split), dstStride, to, srcStride, split, h);
+      break;
+
+    case TRANSITION_DISSOLVE:
+      for (int y = 0; y < h; y++) {
+        uint16_t* d = dst + y * dstStride;
+        const uint16_t* f = from + y * srcStride;
+        const uint16_t* t = to + y * srcStride;
+        for (int x = 0; x < w; x++) {
+          d[x] = (dissolveThreshold(x, y) < progress) ? t[x] : f[x];
+        }
+      }
+      break;
+  }
+}
+
+/**
+ * @brief allocate the two snapshots
+ *
+ * @return false if there is not enough memory (transitions are then disabled)
+ */
+bool transitionInit() {
+  if (fromBuffer) return true;
+  fromBuffer = new (std::nothrow) uint16_t[CANVAS_WIDTH * CANVAS_HEIGHT];
+  toBuffer = new (std::nothrow) uint16_t[CANVAS_WIDTH * CANVAS_HEIGHT];
+  if (!fromBuffer || !toBuffer) {
+    delete[] fromBuffer;
+    delete[] toBuffer;
+    fromBuffer = toBuffer = nullptr;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief snapshot the outgoing screen
+ */
+void transitionCapture(VirtualCanvas* canvas) {
+  if (!fromBuffer) return;
+  transitionFinish();
+  memcpy(fromBuffer, canvas->getBuffer(), CANVAS_WIDTH * CANVAS_HEIGHT * sizeof(uint16_t));
+  captured = true;
+}
+
+/**
+ * @brief snapshot the incoming screen (already drawn) and start animating from the outgoing one
+ */
+void transitionStart(VirtualCanvas* canvas, TransitionType type, unsigned long now) {
+  if (!captured) return;
+  captured = false;
+
+  memcpy(toBuffer, canvas->getBuffer(), CANVAS_WIDTH * CANVAS_HEIGHT * sizeof(uint16_t));
+  target = canvas;
+  activeType = type;
+  startTime = now;
+  running = true;
+  transitionUpdate(now);
+}
+
+bool transitionActive() {
+  return running;
+}
+
+/**
+ * @brief recompose the canvas for the current time
+ *
+ * @param now millis()
+ */
+void transitionUpdate(unsigned long now) {
+  if (!running) return;
+
+  unsigned long elapsed = now - startTime;
+  uint16_t progress = (elapsed >= TRANSITION_MS) ? TRANSITION_FULL : (uint16_t)(elapsed * TRANSITION_FULL / TRANSITION_MS);
+
+  transitionCompose(target->getBuffer(), CANVAS_WIDTH, fromBuffer, toBuffer, CANVAS_WIDTH, CANVAS_WIDTH, CANVAS_HEIGHT,
+                    activeType, progress);
+  target->markDirty(0, 0, CANVAS_WIDTH, CANVAS_HEIGHT);
+
+  if (progress == TRANSITION_FULL) running = false;
+}
+
+/**
+ * @brief jump to the end of a running transition
+ */
+void transitionFinish() {
+  if (!running) return;
+  memcpy(target->getBuffer(), toBuffer, CANVAS_WIDTH * CANVAS_HEIGHT * sizeof(uint16_t));
+  target->markDirty(0, 0, CANVAS_WIDTH, CANVAS_HEIGHT);
+  running = false;
+}
@@ -0,0 +1,261 @@
+/**
+ * @file SpriteEngine.cpp
+ * @brief implementation of the sprite and tile engine
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Each frame:
+ * 1. every sprite that moved / changed marks the tiles under its old and new position
+ * 2. sprites that are hidden or fully off the canvas are culled, the rest are sorted by z
+ * 3. dirty tiles in each tile row are merged into horizontal spans. Per span the background is rebuilt from the tilemap
+ *    and every sprite crossing the span is blitted clipped to it (one keyed blit per sprite per span, no drawPixel)
+ *
+ * Clipping to the spans matters: a sprite partially under a dirty span is only redrawn inside the span, so sprites above
+ * it outside the span are never overwritten out of z order.
+ *
+ */
+
+#include "Engine/SpriteEngine.h"
+#include "Display/Blitter.h"
+
+static VirtualCanvas* canvas = nullptr;
+static const Tilemap* tilemap = nullptr;
+static uint16_t background = 0;
+
+static Sprite sprites[MAX_SPRITES];
+static uint8_t drawList[MAX_SPRITES];
+static uint8_t drawCount = 0;
+
+static uint32_t dirtyTiles[CANVAS_TILES_Y];
+static EngineStats stats;
+
+/**
+ * @brief mark every tile under a rectangle (clipped to the canvas)
+ */
+static void markRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > CANVAS_WIDTH)  w = CANVAS_WIDTH - x;
+  if (y + h > CANVAS_HEIGHT) h = CANVAS_HEIGHT - y;
+  if (w <= 0 || h <= 0) return;
+
+  int tx0 = x / ENGINE_TILE_SIZE;
+  int tx1 = (x + w - 1) / ENGINE_TILE_SIZE;
+  uint32_t mask = (tx1 - tx0 == 31) ? 0xFFFFFFFFu : (((1u << (tx1 - tx0 + 1)) - 1) << tx0);
+  for (int ty = y / ENGINE_TILE_SIZE; ty <= (y + h - 1) / ENGINE_TILE_SIZE; ty++) {
+    dirtyTiles[ty] |= mask;
+  }
+}
+
+/**
+ * @brief reset the engine for a new scene
+ *
+ * @param c canvas to render into
+ * @param backgroundColor used where there is no tilemap cell
+ */
+void engineInit(VirtualCanvas* c, uint16_t backgroundColor) {
+  canvas = c;
+  background = backgroundColor;
+  tilemap = nullptr;
+  engineClearSprites();
+  markRect(0, 0, CANVAS_WIDTH, CANVAS_HEIGHT);
+}
+
+/**
+ * @brief set the background tilemap (whole canvas is redrawn)
+ */
+void engineSetTilemap(const Tilemap* map) {
+  tilemap = map;
+  markRect(0, 0, CANVAS_WIDTH, CANVAS_HEIGHT);
+}
+
+/**
+ * @brief change one cell of the current tilemap
+ */
+void engineSetTile(uint8_t col, uint8_t row, uint8_t tile) {
+  if (!tilemap || col >= tilemap->cols || row >= tilemap->rows) return;
+  tilemap->cells[row * tilemap->cols + col] = tile;
+  markRect(col * ENGINE_TILE_SIZE, row * ENGINE_TILE_SIZE, ENGINE_TILE_SIZE, ENGINE_TILE_SIZE);
+}
+
+/**
+ * @brief take a free sprite slot
+ *
+ * @return Sprite* or nullptr when all MAX_SPRITES slots are used
+ */
+Sprite* engineAddSprite(const SpriteImage* image, int16_t x, int16_t y, uint8_t z) {
+  for (int i = 0; i < MAX_SPRITES; i++) {
+    if (!sprites[i].inUse) {
+      Sprite& s = sprites[i];
+      s.image = image;
+      s.x = x;
+      s.y = y;
+      s.z = z;
+      s.visible = true;
+      s.inUse = true;
+      s.drawn = false;
+      return &s;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * @brief release a sprite, whatever it covered is restored on the next render
+ */
+void engineRemoveSprite(Sprite* sprite) {
+  if (!sprite || !sprite->inUse) return;
+  if (sprite->drawn) {
+    markRect(sprite->drawnX, sprite->drawnY, sprite->drawnImage->width, sprite->drawnImage->height);
+  }
+  sprite->inUse = false;
+  sprite->drawn = false;
+}
+
+/**
+ * @brief release all sprites
+ */
+void engineClearSprites() {
+  for (int i = 0; i < MAX_SPRITES; i++) {
+    engineRemoveSprite(&sprites[i]);
+  }
+  drawCount = 0;
+}
+
+/**
+ * @brief force a region to be rebuilt (ex: a game drew a score over the scene)
+ */
+void engineInvalidate(int16_t x, int16_t y, int16_t w, int16_t h) {
+  markRect(x, y, w, h);
+}
+
+/**
+ * @brief rebuild the background of one span from the tilemap
+ */
+static void drawBackground(uint16_t* fb, int x0, int y0, int w) {
+  for (int x = x0; x < x0 + w; x += ENGINE_TILE_SIZE) {
+    int col = x / ENGINE_TILE_SIZE;
+    int row = y0 / ENGINE_TILE_SIZE;
+    uint16_t* dst = &fb[y0 * CANVAS_WIDTH + x];
+
+    if (tilemap && col < tilemap->cols && row < tilemap->rows) {
+      uint8_t tile = tilemap->cells[row * tilemap->cols + col];
+      if (tile < tilemap->tileset->tileCount) {
+        const uint16_t* src = &tilemap->tileset->pixels[tile * ENGINE_TILE_SIZE * ENGINE_TILE_SIZE];
+        blitCopy(dst, CANVAS_WIDTH, src, ENGINE_TILE_SIZE, ENGINE_TILE_SIZE, ENGINE_TILE_SIZE);
+        continue;
+      }
+    }
+    blitFill(dst, CANVAS_WIDTH, ENGINE_TILE_SIZE, ENGINE_TILE_SIZE, background);
+  }
+}
+
+/**
+ * @brief blit a sprite clipped to a span
+ */
+static void drawSpriteClipped(uint16_t* fb, const Sprite& s, int cx, int cy, int cw, int ch) {
+  int x0 = max((int)s.x, cx);
+  int y0 = max((int)s.y, cy);
+  int x1 = min(s.x + s.image->width, cx + cw);
+  int y1 = min(s.y + s.image->height, cy + ch);
+  if (x0 >= x1 || y0 >= y1) return;
+
+  const uint16_t* src = &s.image->pixels[(y0 - s.y) * s.image->width + (x0 - s.x)];
+  blitCopyKeyed(&fb[y0 * CANVAS_WIDTH + x0], CANVAS_WIDTH, src, s.image->width, x1 - x0, y1 - y0, SPRITE_TRANSPARENT);
+}
+
+/**
+ * @brief find changed sprites, cull and sort the visible ones by z
+ */
+static void buildDrawList() {
+  drawCount = 0;
+  stats.spritesCulled = 0;
+
+  for (int i = 0; i < MAX_SPRITES; i++) {
+    Sprite& s = sprites[i];
+    if (!s.inUse) continue;
+
+    bool onCanvas = s.visible && s.image &&
+                    s.x < CANVAS_WIDTH && s.y < CANVAS_HEIGHT &&
+                    s.x + s.image->width > 0 && s.y + s.image->height > 0;
+
+    bool changed = (s.drawn != onCanvas) ||
+                   (onCanvas && (s.drawnX != s.x || s.drawnY != s.y || s.drawnImage != s.image || s.drawnZ != s.z));
+
+    if (changed) {
+      if (s.drawn) markRect(s.drawnX, s.drawnY, s.drawnImage->width, s.drawnImage->height);
+      if (onCanvas) markRect(s.x, s.y, s.image->width, s.image->height);
+    }
+
+    if (!onCanvas) {
+      stats.spritesCulled++;
+      s.drawn = false;
+      continue;
+    }
+
+    // insertion sort by z, ties keep slot order so overlaps never flicker between frames
+    int j = drawCount++;
+    while (j > 0 && sprites[drawList[j - 1]].z > s.z) {
+      drawList[j] = drawList[j - 1];
+      j--;
+    }
+    drawList[j] = i;
+
+    s.drawn = true;
+    s.drawnX = s.x;
+    s.drawnY = s.y;
+    s.drawnImage = s.image;
+    s.drawnZ = s.z;
+  }
+}
+
+/**
+ * @brief render one frame into the canvas
+ *
+ * does not flush, the main loop flushes the canvas once per pass
+ */
+void engineRender() {
+  if (!canvas || !canvas->getBuffer()) return;
+  uint16_t* fb = canvas->getBuffer();
+
+  buildDrawList();
+  stats.spritesDrawn = 0;
+  stats.spans = 0;
+
+  for (int ty = 0; ty < CANVAS_TILES_Y; ty++) {
+    uint32_t bits = dirtyTiles[ty];
+    dirtyTiles[ty] = 0;
+
+    while (bits) {
+      // merge a run of neighbouring dirty tiles into one span
+      int start = __builtin_ctz(bits);
+      uint32_t rest = ~(bits >> start);
+      int len = rest ? __builtin_ctz(rest) : 32;
+      bits &= (len == 32) ? 0 : ~(((1u << len) - 1) << start);
+
+      int sx = start * ENGINE_TILE_SIZE;
+      int sy = ty * ENGINE_TILE_SIZE;
+      int sw = len * ENGINE_TILE_SIZE;
+
+      drawBackground(fb, sx, sy, sw);
+      for (int k = 0; k < drawCount; k++) {
+        const Sprite& s = sprites[drawList[k]];
+        if (s.x < sx + sw && s.x + s.image->width > sx && s.y < sy + ENGINE_TILE_SIZE && s.y + s.image->height > sy) {
+          drawSpriteClipped(fb, s, sx, sy, sw, ENGINE_TILE_SIZE);
+          stats.spritesDrawn++;
+        }
+      }
+
+      canvas->markDirty(sx, sy, sw, ENGINE_TILE_SIZE);
+      stats.spans++;
+    }
+  }
+}
+
+/**
+ * @brief counters from the last render (sprite blits, culled sprites, spans rebuilt)
+ */
+const EngineStats& engineGetStats() {
+  return stats;
+}
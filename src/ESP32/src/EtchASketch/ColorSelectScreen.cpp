@@ -12,46 +12,43 @@
  */
 
 #include "EtchASketch/ColorSelectScreen.h"
+#include "Assets/BuiltinAssets.h"
 
 // matrix object ptr
-MatrixPanel_I2S_DMA* dma_display_cs = nullptr;
+VirtualCanvas* dma_display_cs = nullptr;
 
-// supported colors
-const char* colorNames[] = { "Red", "Green", "Yellow", "Orange", "Blue", "Purple", "Pink"};
+// supported colors and their names (parallel arrays), unpacked from assets/sketch_colors.txt by initColorSelector()
+const char* colorNames[MAX_SKETCH_COLORS] = { "White" };
+uint16_t colorValues[MAX_SKETCH_COLORS] = { 0xFFFF };
+static char colorNameText[96];
 
-// initialize Color values to be 0 in parallel array
-uint16_t colorValues[] = {
-  0,  // Red
-  0,  // Green
-  0,  // Yellow
-  0,  // Orange
-  0,  // Blue
-  0,  // Purple
-  0,  // Pink
-};
-
-// initialize color index to 0 and number of colors to 7
+// initialize color index to 0. until the palette is unpacked there is only white
 int selectedColorIndex = 0;
-const int numColors = 7;
+int numColors = 1;
 
 /**
  * @brief This function intializes color values for the LED matrix
  * 
- * Each element of the color values array is set to a specific color
- * This is done using the color565
+ * The colors and their names are unpacked from the built in asset blob (tools/pack_assets.py). If that fails the
+ * sketch keeps drawing in white
  * 
  * @param display matrix object to draw to 
  */
-void initColorSelector(MatrixPanel_I2S_DMA* display) {
-  //color565 converts the color to a 16 bit number to be read
+void initColorSelector(VirtualCanvas* display) {
   dma_display_cs = display;
-  colorValues[0] = dma_display_cs->color565(255, 0, 0);       // Red
-  colorValues[1] = dma_display_cs->color565(0, 255, 0);       // Green
-  colorValues[2] = dma_display_cs->color565(255, 255, 0);     // Yellow
-  colorValues[3] = dma_display_cs->color565(255, 165, 0);     // Orange
-  colorValues[4] = dma_display_cs->color565(0, 0 , 255);      // Blue
-  colorValues[5] = dma_display_cs->color565(128, 0, 128);     // Purple
-  colorValues[6] = dma_display_cs->color565(255, 105, 180);   // Pink
+  PackInfo pack;
+  PackEntry entry;
+  int count = 0;
+  if (builtinAsset(PACKED_SKETCH_COLORS, &pack, &entry)) {
+    count = unpackPalette(entry, colorValues, colorNames, MAX_SKETCH_COLORS, colorNameText, sizeof(colorNameText));
+  }
+  if (count) {
+    numColors = count;
+    return;
+  }
+  colorValues[0] = 0xFFFF;
+  colorNames[0] = "White";
+  numColors = 1;
 }
 
 /**
@@ -90,6 +87,11 @@ void drawColorSelector(uint16_t colorValues[]) {
   dma_display_cs->setCursor(startX, 24);
   dma_display_cs->setTextColor(colorValues[selectedColorIndex]);
   dma_display_cs->print(colorName);
+
+  // hint for the saved sketches (controller 1A)
+  dma_display_cs->setCursor(8, 54);
+  dma_display_cs->setTextColor(dma_display_cs->color565(90, 90, 90));
+  dma_display_cs->print("A: saved");
 }
 
 /**
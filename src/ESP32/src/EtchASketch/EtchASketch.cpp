@@ -8,18 +8,37 @@
  * @copyright Copyright (c) 2025
  * 
  * This sketch implements the Sketch program (extended 'EtchASketch' with colors) for the LED Matrix. 
+ * Commands are turned into actions through the "sketch" input profile (Input/InputMap.h), so the controls can be
+ * remapped in /input.cfg.
+ *
+ * Only the drawing lives on the canvas. The blinking cursor and the HUD (color swatch, cursor position, short messages)
+ * are two overlay layers on top of it (Display/Overlay.h), so they can change every frame without ever touching a
+ * pixel of the drawing. Without memory for the overlays the program still works, just without them.
+ *
+ * Tools (EtchASketch/SketchTools.h): controller 1B picks the tool, 1A uses it, 2A cycles the mirroring. Pen and brush
+ * draw while the cursor moves. Line, rectangle and circle anchor on the first 1A and draw on the second, with a preview
+ * on the cursor layer in between. Fill fills the area under the cursor. Everything goes into the canvas framebuffer,
+ * only damaged tiles reach the panel at the next flush.
+ *
+ * Every session is recorded as a stroke log (EtchASketch/StrokeLog.h) of the actions above and saved when the program
+ * is left. etchReplayBegin() / etchReplayAction() run a log back through the same doEtchAction(), without HUD or
+ * recording, which is how SketchReplay redraws a saved session.
  */
 
 #include "EtchASketch/EtchASketch.h"
 #include "EtchASketch/ColorSelectScreen.h"
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "Display/VirtualCanvas.h"
+#include "Display/Overlay.h"
+#include "EtchASketch/SketchTools.h"
+#include "EtchASketch/StrokeLog.h"
+#include "Input/InputMap.h"
 #include <Arduino.h>
 
 // center the cursor to start drawing
-static int x = 32;
-static int y = 32;
+static int x = CANVAS_WIDTH / 2;
+static int y = CANVAS_HEIGHT / 2;
 static uint16_t drawColor;
-static MatrixPanel_I2S_DMA* display;
+static VirtualCanvas* display;
 
 // variables for thresholding movement
 static int rpg1Counter = 0;
@@ -29,36 +48,324 @@ static const int MOVEMENT_THRESHOLD = 1;
 // track our current color index
 static int etchColorIndex = 0; 
 
+// overlays: the HUD, and the cursor on top of it
+static OverlayLayer* hud = nullptr;
+static OverlayLayer* cursorLayer = nullptr;
+
+#define CURSOR_BLINK_MS 400
+#define TOAST_MS 1200                   // messages and the position readout disappear this long after the last change
+#define TOAST_HEIGHT 9                  // one line of text plus a row of background
+#define SWATCH_SIZE 5                   // current color, 3x3 in a black frame, bottom right
+
+static int cursorX = -1, cursorY = -1;  // where the cursor layer has the cursor
+static bool cursorOn = false;
+static unsigned long blinkAt = 0;
+static bool hudPending = false;         // drawn on the first update (after the transition into the program)
+static unsigned long messageUntil = 0;  // 0 = not showing
+static unsigned long positionUntil = 0;
+
+// tools
+static uint8_t tool = TOOL_PEN;
+static uint8_t symmetry = SYM_NONE;
+static bool anchored = false;           // line / rectangle / circle waiting for its second point
+static bool previewShown = false;       // the cursor layer holds a shape preview
+static int anchorX, anchorY;
+static uint8_t fillMask[SKETCH_MASK_BYTES(CANVAS_WIDTH, CANVAS_HEIGHT)];
+
+// session recording (off without a flash filesystem)
+static AssetSource* sessionSource = nullptr;
+static AssetSink* sessionSink = nullptr;
+static StrokeWriter sessionLog;
+static int sessionCount = -1;           // saved sessions, -1 until counted
+
+// actions of the "sketch" input profile
+enum EtchAction : uint8_t {
+  ETCH_NONE, ETCH_LEFT, ETCH_RIGHT, ETCH_UP, ETCH_DOWN, ETCH_NEXT_COLOR, ETCH_PREV_COLOR, ETCH_CLEAR,
+  ETCH_USE_TOOL, ETCH_NEXT_TOOL, ETCH_SYMMETRY
+};
+static const char* const ETCH_ACTION_NAMES[] = {
+  "none", "left", "right", "up", "down", "nextColor", "prevColor", "clear", "useTool", "nextTool", "symmetry"
+};
+
+// default controls: RPG1 moves along x, RPG2 along y, arrows pick the color, controller 1 A+B together clears,
+// 1A alone uses the tool, 1B alone picks the next one, 2A changes the mirroring
+static const InputBinding ETCH_DEFAULTS[] = {
+  { IN_RPG1_CW,    IN_NONE, ETCH_RIGHT,      0 },
+  { IN_RPG1_CCW,   IN_NONE, ETCH_LEFT,       0 },
+  { IN_RPG2_CW,    IN_NONE, ETCH_UP,         0 },
+  { IN_RPG2_CCW,   IN_NONE, ETCH_DOWN,       0 },
+  { IN_UP_ARROW,   IN_NONE, ETCH_NEXT_COLOR, 0 },
+  { IN_DOWN_ARROW, IN_NONE, ETCH_PREV_COLOR, 0 },
+  { IN_C1A,        IN_C1B,  ETCH_CLEAR,      0 },
+  { IN_C1A,        IN_NONE, ETCH_USE_TOOL,   0 },
+  { IN_C1B,        IN_NONE, ETCH_NEXT_TOOL,  0 },
+  { IN_C2A,        IN_NONE, ETCH_SYMMETRY,   0 },
+};
+
+static InputProfile etchProfile;
+static bool etchProfileReady = false;
+static InputMapper etchInput;
+
+/**
+ * @brief the "sketch" input profile (defaults filled in on first use, /input.cfg may change it at boot)
+ */
+InputProfile* etchInputProfile() {
+  if (!etchProfileReady) {
+    inputProfileInit(&etchProfile, "sketch", ETCH_ACTION_NAMES, sizeof(ETCH_ACTION_NAMES) / sizeof(ETCH_ACTION_NAMES[0]),
+                     ETCH_DEFAULTS, sizeof(ETCH_DEFAULTS) / sizeof(ETCH_DEFAULTS[0]));
+    etchProfileReady = true;
+  }
+  return &etchProfile;
+}
+
+/**
+ * @brief a text box on the HUD, cleared by updateEtchASketch() after TOAST_MS
+ *
+ * @param y top row of the box
+ * @param text text
+ * @param color text color
+ * @param centered centered, otherwise at the left edge
+ */
+static void drawToast(int y, const char* text, uint16_t color, bool centered) {
+  int w = strlen(text) * 6 + 1;
+  int x = centered ? (display->width() - w) / 2 : 0;
+
+  hud->clear(0, y, display->width() - (y > 0 ? SWATCH_SIZE : 0), TOAST_HEIGHT);
+  hud->fillRect(x, y, w, TOAST_HEIGHT, 0);
+  hud->setTextSize(1);
+  hud->setTextColor(color);
+  hud->setCursor(x + 1, y + 1);
+  hud->print(text);
+}
+
+static void showMessage(const char* text, uint16_t color, unsigned long now) {
+  if (!hud) return;
+  drawToast(0, text, color, true);
+  messageUntil = now + TOAST_MS;
+}
+
+static void showPosition(unsigned long now) {
+  if (!hud) return;
+  char text[12];
+  snprintf(text, sizeof(text), "%d,%d", x, y);
+  drawToast(display->height() - TOAST_HEIGHT, text, display->color565(160, 160, 160), false);
+  positionUntil = now + TOAST_MS;
+}
+
+static void drawSwatch() {
+  if (!hud) return;
+  int sx = display->width() - SWATCH_SIZE;
+  int sy = display->height() - SWATCH_SIZE;
+  hud->fillRect(sx, sy, SWATCH_SIZE, SWATCH_SIZE, 0);
+  hud->fillRect(sx + 1, sy + 1, SWATCH_SIZE - 2, SWATCH_SIZE - 2, drawColor);
+}
+
+/**
+ * @brief plot a run into a GFX target (the canvas or the cursor layer) with the current mirroring
+ *
+ * runs are clipped by the target
+ */
+static void plotMirrored(void* ctx, int16_t px, int16_t py, int16_t w) {
+  Adafruit_GFX* gfx = (Adafruit_GFX*)ctx;
+  int16_t mx = display->width() - px - w;          // left end of the run mirrored left / right
+  int16_t my = display->height() - 1 - py;
+
+  gfx->drawFastHLine(px, py, w, drawColor);
+  if (symmetry >= SYM_MIRROR) gfx->drawFastHLine(mx, py, w, drawColor);
+  if (symmetry == SYM_QUAD) {
+    gfx->drawFastHLine(px, my, w, drawColor);
+    gfx->drawFastHLine(mx, my, w, drawColor);
+  }
+}
+
+/**
+ * @brief what the pen or brush leaves at the cursor
+ */
+static void drawAtCursor() {
+  if (tool == TOOL_BRUSH) sketchBrush(x, y, plotMirrored, (Adafruit_GFX*)display);
+  else if (tool == TOOL_PEN) plotMirrored((Adafruit_GFX*)display, x, y, 1);
+}
+
+/**
+ * @brief flood fill from (fx, fy) in the framebuffer, then mark what changed
+ */
+static void fillAt(int16_t fx, int16_t fy) {
+  SketchSurface surface = { display->getBuffer(), (int16_t)display->width(), (int16_t)display->height(), fillMask };
+  SketchRect damage;
+  if (sketchFill(&surface, fx, fy, drawColor, &damage)) {
+    display->markDirty(damage.x0, damage.y0, damage.x1 - damage.x0 + 1, damage.y1 - damage.y0 + 1);
+  }
+}
+
+/**
+ * @brief use the current tool at the cursor (controller 1A)
+ */
+static void useTool() {
+  if (tool == TOOL_FILL) {
+    // mirrored copies are filled one after the other, an area already filled by an earlier one is skipped
+    int16_t mx = display->width() - 1 - x, my = display->height() - 1 - y;
+    fillAt(x, y);
+    if (symmetry >= SYM_MIRROR) fillAt(mx, y);
+    if (symmetry == SYM_QUAD) {
+      fillAt(x, my);
+      fillAt(mx, my);
+    }
+  } else if (sketchToolNeedsAnchor(tool)) {
+    if (!anchored) {
+      anchored = true;
+      anchorX = x;
+      anchorY = y;
+    } else {
+      anchored = false;
+      sketchShape(tool, anchorX, anchorY, x, y, plotMirrored, (Adafruit_GFX*)display);
+    }
+  } else {
+    drawAtCursor();
+  }
+}
+
+/**
+ * @brief show the cursor at (x, y) right away (restarts the blink, so it stays visible while moving)
+ *
+ * while on, the cursor is the inverse of the pixel under it so it shows on any color, off lets the drawing through.
+ * with an anchor set the cursor layer also holds a preview of the shape
+ */
+static void drawCursor(unsigned long now) {
+  if (!cursorLayer) return;
+  if (anchored || previewShown) {
+    cursorLayer->clear();
+    if (anchored) sketchShape(tool, anchorX, anchorY, x, y, plotMirrored, (Adafruit_GFX*)cursorLayer);
+    previewShown = anchored;
+  } else if (cursorX != x || cursorY != y) {
+    cursorLayer->clear(cursorX, cursorY, 1, 1);
+  }
+  cursorLayer->drawPixel(x, y, ~display->getPixel(x, y));
+  cursorX = x;
+  cursorY = y;
+  cursorOn = true;
+  blinkAt = now;
+}
+
+/**
+ * @brief set up the two overlays once (they stay allocated, like the canvas) and put them on the canvas
+ */
+static void attachOverlays() {
+  static OverlayLayer hudLayer(display);
+  static OverlayLayer cursorOverlay(display);
+
+  hud = hudLayer.begin() ? &hudLayer : nullptr;
+  cursorLayer = cursorOverlay.begin() ? &cursorOverlay : nullptr;
+  if (hud) {
+    hud->clear();
+    display->attachLayer(hud);
+  }
+  if (cursorLayer) {
+    cursorLayer->clear();
+    display->attachLayer(cursorLayer);
+  }
+  cursorX = -1;
+  cursorY = -1;
+  previewShown = false;
+  messageUntil = 0;
+  positionUntil = 0;
+  hudPending = true;
+}
+
+/**
+ * @brief the state every session starts from (a recorded session depends on this staying the same)
+ */
+static void resetSketch(VirtualCanvas* disp, int colorIndex) {
+  display = disp;
+  etchColorIndex = colorIndex;
+  drawColor = colorValues[colorIndex];
+
+  // set the cursor to the middle of the canvas (logical coordinates, may span several panels)
+  x = display->width() / 2;
+  y = display->height() / 2;
+
+  // clear screen
+  display->fillScreen(display->color565(0, 0, 0));
+
+  // draw current pixel the cursor is on in selected color
+  tool = TOOL_PEN;
+  symmetry = SYM_NONE;
+  anchored = false;
+  drawAtCursor();
+}
+
+/**
+ * @brief where sessions are saved (call once at boot, leave unset without a flash filesystem)
+ */
+void etchSetStorage(AssetSource* source, AssetSink* sink) {
+  sessionSource = source;
+  sessionSink = sink;
+  sessionCount = -1;
+}
+
+/**
+ * @brief number of saved sessions (counted on first use)
+ */
+int etchSessionCount() {
+  if (!sessionSource) return 0;
+  if (sessionCount < 0) sessionCount = strokeSessionCount(sessionSource);
+  return sessionCount;
+}
+
 /**
  * @brief Function that intializes the etch a sketch
  *
  * resets RPG counters and direction
  * sets the location of the cursor to the center
+ * starts recording the session
  * 
  * @param disp matrix object to draw on
  * @param color current color in use
  */
-void initEtchASketch(MatrixPanel_I2S_DMA* disp, uint16_t color) {
-  display = disp;
-  drawColor = color;
+void initEtchASketch(VirtualCanvas* disp, uint16_t color) {
+  inputMapperInit(&etchInput, etchInputProfile());
   
   // find the index of the initial color
+  int colorIndex = 0;
   for (int i = 0; i < numColors; i++) {
     if (colorValues[i] == color) {
-      etchColorIndex = i;
+      colorIndex = i;
       break;
     }
   }
-  
-  // set the cursor to the middle of the screen (64x64 LED Matrix)
-  x = 32;
-  y = 32;
 
-  // clear screen
-  display->fillScreen(display->color565(0, 0, 0));
+  resetSketch(disp, colorIndex);
+  attachOverlays();
 
-  // draw current pixel the cursor is on in selected color
-  display->drawPixel(x, y, drawColor);
+  if (sessionSink && etchSessionCount() < STROKE_MAX_SESSIONS) {
+    char path[STROKE_PATH_LEN];
+    strokeSessionPath(path, sessionCount + 1);
+    strokeWriterBegin(&sessionLog, sessionSink, path, display->width(), display->height(), colorIndex, millis());
+  }
+}
+
+/**
+ * @brief start redrawing a recorded session: same starting state as a live one, but no HUD and no recording
+ *
+ * @param disp canvas to draw on
+ * @param colorIndex starting color from the log
+ */
+void etchReplayBegin(VirtualCanvas* disp, uint8_t colorIndex) {
+  hud = nullptr;
+  cursorLayer = nullptr;
+  resetSketch(disp, colorIndex < numColors ? colorIndex : 0);
+}
+
+/**
+ * @brief take the HUD and cursor off the canvas (leaving the program)
+ */
+void exitEtchASketch() {
+  if (hud) display->detachLayer(hud);
+  if (cursorLayer) display->detachLayer(cursorLayer);
+  hud = nullptr;
+  cursorLayer = nullptr;
+
+  // save the session (dropped if nothing was drawn)
+  if (strokeWriterFinish(&sessionLog)) sessionCount++;
 }
 
 /** 
@@ -73,7 +380,9 @@ void nextEtchColor() {
   drawColor = colorValues[etchColorIndex];
   
   // redraw the current cursor position with the new color
-  display->drawPixel(x, y, drawColor);
+  drawAtCursor();
+  drawSwatch();
+  showMessage(colorNames[etchColorIndex], drawColor, millis());
 }
 
 /**
@@ -87,48 +396,128 @@ void prevEtchColor() {
   drawColor = colorValues[etchColorIndex];
   
   // redraw the current cursor position with the new color
-  display->drawPixel(x, y, drawColor);
+  drawAtCursor();
+  drawSwatch();
+  showMessage(colorNames[etchColorIndex], drawColor, millis());
+}
+
+/**
+ * @brief perform one action of the "sketch" profile
+ *
+ * Moves are bounded to the canvas (0 .. width-1, 0 .. height-1). With the pen or brush the cursor draws after every move.
+ */
+static void doEtchAction(uint8_t action, unsigned long now) {
+  switch (action) {
+    case ETCH_NEXT_COLOR:
+      nextEtchColor();
+      return;
+    case ETCH_PREV_COLOR:
+      prevEtchColor();
+      return;
+    case ETCH_CLEAR:
+      display->fillScreen(display->color565(0, 0, 0));
+      anchored = false;
+      showMessage("Clear", display->color565(255, 255, 255), now);
+      break;
+    case ETCH_USE_TOOL:
+      useTool();
+      break;
+    case ETCH_NEXT_TOOL:
+      tool = (tool + 1) % TOOL_COUNT;
+      anchored = false;
+      showMessage(SKETCH_TOOL_NAMES[tool], display->color565(255, 255, 255), now);
+      break;
+    case ETCH_SYMMETRY:
+      symmetry = (symmetry + 1) % SYM_COUNT;
+      showMessage(SKETCH_SYMMETRY_NAMES[symmetry], display->color565(255, 255, 255), now);
+      break;
+    case ETCH_RIGHT:
+      if (x < display->width() - 1) x++;
+      break;
+    case ETCH_LEFT:
+      if (x > 0) x--;
+      break;
+    case ETCH_UP:
+      if (y > 0) y--;
+      break;
+    case ETCH_DOWN:
+      if (y < display->height() - 1) y++;
+      break;
+    default:
+      return;
+  }
+
+  // pen / brush draw under the cursor location
+  if (action <= ETCH_DOWN || action == ETCH_CLEAR) drawAtCursor();
+  if (action <= ETCH_DOWN) showPosition(now);
+  drawCursor(now);
 }
 
 /**
  * @brief Function that handles commands relating to the Etch A Sketch
  * 
- * Color cycling with arrows and RPG movement for drawing. 
+ * The command is mapped to actions through the input profile. Defaults:
  * - Up arrow increments the pointer of the color
  * - Down arrow decrements the pointer
  * - RPG2 (left) controls left/right (ccw/cw)
  * - RPG1 (right) controls up/down   (ccw/cw)
+ * - controller 1 A+B clears the canvas
+ * - controller 1A uses the tool, 1B picks the next tool, 2A cycles the mirroring
  * 
  * @param cmd command from the Arduino received over UART
+ * @param now millis() when the command arrived
  */
-void handleEtchCommand(const String& cmd) {
-  if (cmd == "btnUpArrow") {
-    nextEtchColor();
-    return;
-  } 
-  else if (cmd == "btnDownArrow") {
-    prevEtchColor();
-    return;
+void handleEtchCommand(const String& cmd, unsigned long now) {
+  uint8_t actions[2];
+  int n = inputEvent(&etchInput, inputCode(cmd.c_str()), now, actions);
+  for (int i = 0; i < n; i++) {
+    strokeWriterAdd(&sessionLog, actions[i], now);
+    doEtchAction(actions[i], now);
   }
+}
 
-  // --- RPG1 (X axis) ---
-  // bounds 0<63
-  if (cmd == "rpg1CW") {
-    if (x < 63) x++;
-  }
-  else if (cmd == "rpg1CCW") {
-    if (x > 0) x--;
+/**
+ * @brief one action of a recorded session (see etchReplayBegin())
+ */
+void etchReplayAction(uint8_t action) {
+  doEtchAction(action, 0);
+}
+
+/**
+ * @brief per frame work: let a button held back for a chord through once nothing paired with it, blink the cursor
+ * and take down HUD messages that have been up long enough
+ *
+ * only the overlays change here, the drawing on the canvas is left alone
+ *
+ * @param now millis()
+ */
+void updateEtchASketch(unsigned long now) {
+  uint8_t actions[2];
+  int n = inputPoll(&etchInput, now, actions);
+  for (int i = 0; i < n; i++) {
+    strokeWriterAdd(&sessionLog, actions[i], now);
+    doEtchAction(actions[i], now);
   }
 
-  // --- RPG2 (Y axis) ---
-  // bounds 0<63
-  if (cmd == "rpg2CW") {
-    if (y > 0) y--;
+  if (hudPending) {
+    hudPending = false;
+    drawSwatch();
+    drawCursor(now);
   }
-  else if (cmd == "rpg2CCW") {
-    if (y < 63) y++;
+
+  if (cursorLayer && now - blinkAt >= CURSOR_BLINK_MS) {
+    cursorOn = !cursorOn;
+    blinkAt = now;
+    if (cursorOn) cursorLayer->drawPixel(x, y, ~display->getPixel(x, y));
+    else          cursorLayer->clear(x, y, 1, 1);
   }
 
-  // draw the pixel under the cursor location
-  display->drawPixel(x, y, drawColor);
-}
\ No newline at end of file
+  if (messageUntil && (long)(now - messageUntil) >= 0) {
+    hud->clear(0, 0, display->width(), TOAST_HEIGHT);
+    messageUntil = 0;
+  }
+  if (positionUntil && (long)(now - positionUntil) >= 0) {
+    hud->clear(0, display->height() - TOAST_HEIGHT, display->width() - SWATCH_SIZE, TOAST_HEIGHT);
+    positionUntil = 0;
+  }
+}
@@ -0,0 +1,189 @@
+/**
+ * @file SketchReplay.cpp
+ * @brief saved sketches screen
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The drawing is redrawn on the canvas by the Sketch program itself (etchReplayAction()), the label ("3/12", "8x")
+ * sits on an overlay so it never ends up in the picture. One StrokeReader is reused for everything, so browsing and
+ * playing read the log through its fixed chunk buffer and allocate nothing.
+ *
+ */
+
+#include "EtchASketch/SketchReplay.h"
+#include "EtchASketch/EtchASketch.h"
+#include "EtchASketch/StrokeLog.h"
+#include "Display/Overlay.h"
+
+#define LABEL_HEIGHT 9
+
+static VirtualCanvas* display;
+static AssetSource* source;
+static OverlayLayer* label = nullptr;
+
+static StrokeReader reader;
+static int count = 0;
+static int selected = 1;                // 1 based, like the file names
+static bool playing = false;
+static int speed = REPLAY_DEFAULT_SPEED;
+static uint32_t clockMs;                // replay time
+static unsigned long lastUpdate;
+static bool eventReady;                 // next holds an event not applied yet
+static StrokeEvent next;
+
+/**
+ * @brief label in the top left corner (white on black), nothing if there is no overlay
+ */
+static void drawLabel(const char* text) {
+  if (!label) return;
+  label->clear();
+  label->fillRect(0, 0, strlen(text) * 6 + 1, LABEL_HEIGHT, 0);
+  label->setTextSize(1);
+  label->setTextColor(0xFFFF);
+  label->setCursor(1, 1);
+  label->print(text);
+}
+
+static void showSelection() {
+  char text[16];
+  snprintf(text, sizeof(text), "%d/%d", selected, count);
+  drawLabel(text);
+}
+
+static void showSpeed() {
+  char text[8];
+  snprintf(text, sizeof(text), "%dx", speed);
+  drawLabel(text);
+}
+
+/**
+ * @brief open the selected session and reset the canvas to its starting state
+ */
+static bool openSelected() {
+  char path[STROKE_PATH_LEN];
+  strokeSessionPath(path, selected);
+  eventReady = false;
+  if (!strokeReaderBegin(&reader, source, path)) return false;
+  etchReplayBegin(display, reader.colorIndex);
+  return true;
+}
+
+/**
+ * @brief the selected session's finished drawing, drawn at once
+ */
+static void drawFinished() {
+  playing = false;
+  if (openSelected()) {
+    StrokeEvent e;
+    while (strokeReaderNext(&reader, &e)) etchReplayAction(e.action);
+  }
+  showSelection();
+}
+
+static void drawEmpty() {
+  display->fillScreen(0);
+  display->setTextSize(1);
+  display->setTextColor(0xFFFF);
+  display->setCursor(14, 20);
+  display->print("No");
+  display->setCursor(14, 30);
+  display->print("sketches");
+}
+
+/**
+ * @brief show the most recent session
+ *
+ * @param disp canvas
+ * @param src where the sessions are saved (nullptr without a flash filesystem)
+ */
+void initSketchReplay(VirtualCanvas* disp, AssetSource* src) {
+  static OverlayLayer labelLayer(disp);
+
+  display = disp;
+  source = src;
+  count = etchSessionCount();
+  selected = count;
+  speed = REPLAY_DEFAULT_SPEED;
+
+  label = labelLayer.begin() ? &labelLayer : nullptr;
+  if (label) {
+    label->clear();
+    display->attachLayer(label);
+  }
+
+  if (count == 0) drawEmpty();
+  else drawFinished();
+}
+
+/**
+ * @brief browsing: arrows pick the session, home plays it
+ *        playing: arrows change the speed, home jumps to the end
+ *
+ * @param cmd command from the Arduino
+ * @param now millis()
+ */
+void handleReplayCommand(const String& cmd, unsigned long now) {
+  if (count == 0) return;
+
+  if (playing) {
+    if (cmd == "btnUpArrow" && speed < REPLAY_MAX_SPEED) speed *= 2;
+    else if (cmd == "btnDownArrow" && speed > 1) speed /= 2;
+    else if (cmd == "btnHomeClick") drawFinished();
+    if (playing) showSpeed();
+    return;
+  }
+
+  if (cmd == "btnUpArrow") {
+    selected = (selected % count) + 1;
+    drawFinished();
+  }
+  else if (cmd == "btnDownArrow") {
+    selected = (selected + count - 2) % count + 1;
+    drawFinished();
+  }
+  else if (cmd == "btnHomeClick" && openSelected()) {
+    playing = true;
+    clockMs = 0;
+    lastUpdate = now;
+    showSpeed();
+  }
+}
+
+/**
+ * @brief apply the events that are due at the current replay speed (at most REPLAY_EVENTS_PER_FRAME per frame)
+ *
+ * @param now millis()
+ */
+void updateSketchReplay(unsigned long now) {
+  if (!playing) return;
+
+  clockMs += (now - lastUpdate) * speed;
+  lastUpdate = now;
+
+  for (int i = 0; i < REPLAY_EVENTS_PER_FRAME; i++) {
+    if (!eventReady) {
+      if (!strokeReaderNext(&reader, &next)) {
+        playing = false;                // done, the picture stays
+        showSelection();
+        return;
+      }
+      eventReady = true;
+
+      // long pauses in the session are shortened to REPLAY_MAX_GAP_MS
+      if (next.atMs > clockMs + REPLAY_MAX_GAP_MS) clockMs = next.atMs - REPLAY_MAX_GAP_MS;
+    }
+    if (next.atMs > clockMs) return;
+    etchReplayAction(next.action);
+    eventReady = false;
+  }
+
+  // fell behind (next is the last event applied), do not try to catch up all at once later
+  clockMs = next.atMs;
+}
+
+void exitSketchReplay() {
+  if (label) display->detachLayer(label);
+  label = nullptr;
+  playing = false;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file SketchTools.cpp
+ * @brief implementation of the Sketch drawing tools
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Fill: pop a seed, extend it left and right to a full run of the old color, paint the run, and push one seed per run
+ * of the old color directly above and below it. Every pixel is painted once and read a handful of times, so a whole
+ * 64x64 canvas is a few thousand reads. The seed stack is a static array (not on the task stack). If it fills up the
+ * extra seeds are dropped and, once the stack drains, a rescan of the surface finds old color pixels bordering what
+ * was painted (the mask remembers which pixels this fill painted) and continues from there. Slower, still correct.
+ *
+ */
+
+#include "EtchASketch/SketchTools.h"
+#include <string.h>
+
+const char* const SKETCH_TOOL_NAMES[TOOL_COUNT] = { "Pen", "Brush", "Line", "Rect", "Circle", "Fill" };
+const char* const SKETCH_SYMMETRY_NAMES[SYM_COUNT] = { "No mirror", "Mirror", "Quad" };
+
+struct FillSeed {
+  int16_t x, y;
+};
+
+static FillSeed seeds[SKETCH_FILL_STACK];
+static int seedCount;
+static bool seedsDropped;
+
+/**
+ * @brief line, rectangle and circle take two presses: the first sets the anchor, the second draws
+ */
+bool sketchToolNeedsAnchor(uint8_t tool) {
+  return tool == TOOL_LINE || tool == TOOL_RECT || tool == TOOL_CIRCLE;
+}
+
+/**
+ * @brief SKETCH_BRUSH_SIZE square centered on (x, y)
+ */
+void sketchBrush(int16_t x, int16_t y, SketchPlot plot, void* ctx) {
+  int16_t half = SKETCH_BRUSH_SIZE / 2;
+  for (int16_t row = 0; row < SKETCH_BRUSH_SIZE; row++) plot(ctx, x - half, y - half + row, SKETCH_BRUSH_SIZE);
+}
+
+/**
+ * @brief Bresenham line, both ends included
+ */
+void sketchLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SketchPlot plot, void* ctx) {
+  int dx = x1 > x0 ? x1 - x0 : x0 - x1;
+  int dy = y1 > y0 ? y0 - y1 : y1 - y0;          // negative
+  int sx = x0 < x1 ? 1 : -1;
+  int sy = y0 < y1 ? 1 : -1;
+  int err = dx + dy;
+
+  for (;;) {
+    plot(ctx, x0, y0, 1);
+    if (x0 == x1 && y0 == y1) return;
+    int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x0 += sx; }
+    if (e2 <= dx) { err += dx; y0 += sy; }
+  }
+}
+
+/**
+ * @brief outline of the rectangle with corners (x0, y0) and (x1, y1), in any order
+ */
+void sketchRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SketchPlot plot, void* ctx) {
+  if (x1 < x0) { int16_t t = x0; x0 = x1; x1 = t; }
+  if (y1 < y0) { int16_t t = y0; y0 = y1; y1 = t; }
+
+  plot(ctx, x0, y0, x1 - x0 + 1);
+  if (y1 == y0) return;
+  plot(ctx, x0, y1, x1 - x0 + 1);
+  for (int16_t y = y0 + 1; y < y1; y++) {
+    plot(ctx, x0, y, 1);
+    if (x1 != x0) plot(ctx, x1, y, 1);
+  }
+}
+
+/**
+ * @brief midpoint circle around (cx, cy) through (px, py) (radius rounded to whole pixels)
+ */
+void sketchCircle(int16_t cx, int16_t cy, int16_t px, int16_t py, SketchPlot plot, void* ctx) {
+  int32_t d2 = (int32_t)(px - cx) * (px - cx) + (int32_t)(py - cy) * (py - cy);
+  int16_t r = 0;
+  while ((int32_t)(r + 1) * (r + 1) <= d2) r++;
+  if (d2 - (int32_t)r * r > r) r++;              // closer to r+1 (d2 > r^2 + r, i.e. r + 0.5 squared)
+
+  int16_t x = r, y = 0;
+  int err = 1 - r;
+  while (x >= y) {
+    plot(ctx, cx - x, cy + y, 1); plot(ctx, cx + x, cy + y, 1);
+    plot(ctx, cx - x, cy - y, 1); plot(ctx, cx + x, cy - y, 1);
+    plot(ctx, cx - y, cy + x, 1); plot(ctx, cx + y, cy + x, 1);
+    plot(ctx, cx - y, cy - x, 1); plot(ctx, cx + y, cy - x, 1);
+    y++;
+    if (err < 0) {
+      err += 2 * y + 1;
+    } else {
+      x--;
+      err += 2 * (y - x) + 1;
+    }
+  }
+}
+
+/**
+ * @brief the shape of an anchored tool from the anchor (ax, ay) to the cursor (x, y)
+ */
+void sketchShape(uint8_t tool, int16_t ax, int16_t ay, int16_t x, int16_t y, SketchPlot plot, void* ctx) {
+  switch (tool) {
+    case TOOL_LINE:   sketchLine(ax, ay, x, y, plot, ctx); break;
+    case TOOL_RECT:   sketchRect(ax, ay, x, y, plot, ctx); break;
+    case TOOL_CIRCLE: sketchCircle(ax, ay, x, y, plot, ctx); break;
+    default: break;
+  }
+}
+
+static void pushSeed(int16_t x, int16_t y) {
+  if (seedCount == SKETCH_FILL_STACK) {
+    seedsDropped = true;
+    return;
+  }
+  seeds[seedCount].x = x;
+  seeds[seedCount].y = y;
+  seedCount++;
+}
+
+/**
+ * @brief push a seed for every run of the old color in row y between l and r
+ */
+static void seedRow(const SketchSurface* s, int16_t l, int16_t r, int16_t y, uint16_t target) {
+  if (y < 0 || y >= s->height) return;
+  const uint16_t* row = &s->pixels[y * s->width];
+  bool inRun = false;
+  for (int16_t x = l; x <= r; x++) {
+    bool open = (row[x] == target);
+    if (open && !inRun) pushSeed(x, y);
+    inRun = open;
+  }
+}
+
+static bool painted(const SketchSurface* s, int16_t x, int16_t y) {
+  if (y < 0 || y >= s->height) return false;
+  int32_t i = (int32_t)y * s->width + x;
+  return s->mask[i >> 3] & (1 << (i & 7));
+}
+
+/**
+ * @brief after seeds were dropped: seed every run of the old color that touches a painted pixel from above or below
+ *
+ * (runs always grow to their full width, so nothing can be left over to the left or right of a painted pixel)
+ */
+static void rescan(const SketchSurface* s, uint16_t target) {
+  for (int16_t y = 0; y < s->height; y++) {
+    const uint16_t* row = &s->pixels[y * s->width];
+    bool inRun = false;
+    for (int16_t x = 0; x < s->width; x++) {
+      bool open = row[x] == target && (painted(s, x, y - 1) || painted(s, x, y + 1));
+      if (open && !inRun) pushSeed(x, y);
+      inRun = open;
+    }
+  }
+}
+
+/**
+ * @brief flood fill the 4-connected area of (x, y)'s color with color
+ *
+ * @param s surface, mask is used as scratch
+ * @param damage set to the bounds of the painted pixels
+ * @return pixels painted
+ */
+int sketchFill(SketchSurface* s, int16_t x, int16_t y, uint16_t color, SketchRect* damage) {
+  damage->x0 = damage->y0 = 0;
+  damage->x1 = damage->y1 = -1;
+  if (x < 0 || y < 0 || x >= s->width || y >= s->height) return 0;
+
+  uint16_t target = s->pixels[y * s->width + x];
+  if (target == color) return 0;
+
+  memset(s->mask, 0, SKETCH_MASK_BYTES(s->width, s->height));
+  damage->x0 = damage->x1 = x;
+  damage->y0 = damage->y1 = y;
+  seedCount = 0;
+  seedsDropped = false;
+  pushSeed(x, y);
+
+  int count = 0;
+  for (;;) {
+    while (seedCount) {
+      FillSeed seed = seeds[--seedCount];
+      uint16_t* row = &s->pixels[seed.y * s->width];
+      if (row[seed.x] != target) continue;               // painted since it was pushed
+
+      int16_t l = seed.x, r = seed.x;
+      while (l > 0 && row[l - 1] == target) l--;
+      while (r < s->width - 1 && row[r + 1] == target) r++;
+
+      for (int16_t i = l; i <= r; i++) {
+        row[i] = color;
+        int32_t bit = (int32_t)seed.y * s->width + i;
+        s->mask[bit >> 3] |= 1 << (bit & 7);
+      }
+      count += r - l + 1;
+      if (l < damage->x0) damage->x0 = l;
+      if (r > damage->x1) damage->x1 = r;
+      if (seed.y < damage->y0) damage->y0 = seed.y;
+      if (seed.y > damage->y1) damage->y1 = seed.y;
+
+      seedRow(s, l, r, seed.y - 1, target);
+      seedRow(s, l, r, seed.y + 1, target);
+    }
+
+    if (!seedsDropped) return count;
+    seedsDropped = false;
+    rescan(s, target);
+  }
+}
@@ -0,0 +1,197 @@
+/**
+ * @file StrokeLog.cpp
+ * @brief implementation of the Sketch session log
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Time is kept as an absolute tick count on both sides (ticks since the start of the session), so rounding to
+ * STROKE_TICK_MS never adds up over a long session: every event is replayed within one tick of when it happened.
+ *
+ */
+
+#include "EtchASketch/StrokeLog.h"
+#include <stdio.h>
+#include <string.h>
+
+static const uint8_t MAGIC[4] = { 'S', 'K', 'L', '1' };
+
+#define WAIT_SHIFT 5
+#define WAIT_EXTENDED 7
+
+static void flushChunk(StrokeWriter* w) {
+  if (w->len && !w->failed && !w->sink->write(w->buf, w->len)) w->failed = true;
+  w->len = 0;
+}
+
+static void putByte(StrokeWriter* w, uint8_t b) {
+  if (w->len == STROKE_CHUNK) flushChunk(w);
+  w->buf[w->len++] = b;
+  w->bytes++;
+}
+
+/**
+ * @brief start recording a session into path
+ *
+ * @param colorIndex color the session starts with
+ * @param now millis()
+ * @return false if the file could not be created (nothing is recorded then)
+ */
+bool strokeWriterBegin(StrokeWriter* w, AssetSink* sink, const char* path, uint16_t width, uint16_t height,
+                       uint8_t colorIndex, uint32_t now) {
+  w->sink = sink;
+  w->len = 0;
+  w->startMs = now;
+  w->lastTick = 0;
+  w->events = 0;
+  w->bytes = 0;
+  w->failed = false;
+  if (!sink || !sink->begin(path)) {
+    w->sink = nullptr;
+    return false;
+  }
+
+  for (uint8_t i = 0; i < 4; i++) putByte(w, MAGIC[i]);
+  putByte(w, width & 0xFF);
+  putByte(w, width >> 8);
+  putByte(w, height & 0xFF);
+  putByte(w, height >> 8);
+  putByte(w, colorIndex);
+  return true;
+}
+
+/**
+ * @brief record one action (1 .. STROKE_MAX_ACTION)
+ *
+ * @param now millis() when it happened
+ */
+void strokeWriterAdd(StrokeWriter* w, uint8_t action, uint32_t now) {
+  if (!w->sink || w->failed || action == 0 || action > STROKE_MAX_ACTION) return;
+
+  uint32_t tick = (now - w->startMs) / STROKE_TICK_MS;
+  uint32_t wait = tick - w->lastTick;
+  w->lastTick = tick;
+  w->events++;
+
+  if (wait < WAIT_EXTENDED) {
+    putByte(w, (uint8_t)(wait << WAIT_SHIFT) | action);
+    return;
+  }
+  putByte(w, (WAIT_EXTENDED << WAIT_SHIFT) | action);
+  wait -= WAIT_EXTENDED;
+  while (wait >= 0x80) {
+    putByte(w, (wait & 0x7F) | 0x80);
+    wait >>= 7;
+  }
+  putByte(w, wait);
+}
+
+/**
+ * @brief complete the file. a session without a single action is thrown away
+ *
+ * @return true if the session was saved
+ */
+bool strokeWriterFinish(StrokeWriter* w) {
+  AssetSink* sink = w->sink;
+  if (!sink) return false;
+
+  if (w->events) flushChunk(w);
+  w->sink = nullptr;                    // closed either way, later actions are ignored
+  if (w->events == 0 || w->failed) {
+    sink->abort();
+    return false;
+  }
+  return sink->finish();
+}
+
+/**
+ * @brief next byte of the file, refilling the chunk buffer as needed
+ *
+ * @return -1 at the end of the file
+ */
+static int getByte(StrokeReader* r) {
+  if (r->pos == r->len) {
+    int32_t n = r->source->read(r->path, r->offset, r->buf, STROKE_CHUNK);
+    if (n <= 0) return -1;
+    r->len = n;
+    r->pos = 0;
+    r->offset += n;
+  }
+  return r->buf[r->pos++];
+}
+
+/**
+ * @brief open a saved session and read its header
+ *
+ * @return false if it is missing or not a session
+ */
+bool strokeReaderBegin(StrokeReader* r, AssetSource* source, const char* path) {
+  if (strlen(path) >= sizeof(r->path)) return false;
+  r->source = source;
+  strcpy(r->path, path);
+  r->len = r->pos = 0;
+  r->offset = 0;
+  r->tick = 0;
+
+  uint8_t header[STROKE_HEADER_BYTES];
+  for (uint8_t i = 0; i < STROKE_HEADER_BYTES; i++) {
+    int b = getByte(r);
+    if (b < 0) return false;
+    header[i] = b;
+  }
+  if (memcmp(header, MAGIC, 4) != 0) return false;
+  r->width = header[4] | (header[5] << 8);
+  r->height = header[6] | (header[7] << 8);
+  r->colorIndex = header[8];
+  return true;
+}
+
+/**
+ * @brief decode the next action
+ *
+ * @return false at the end of the session (or at a truncated event)
+ */
+bool strokeReaderNext(StrokeReader* r, StrokeEvent* e) {
+  int b = getByte(r);
+  if (b < 0) return false;
+
+  uint32_t wait = b >> WAIT_SHIFT;
+  if (wait == WAIT_EXTENDED) {
+    uint32_t extra = 0;
+    for (uint8_t shift = 0;; shift += 7) {
+      int v = getByte(r);
+      if (v < 0 || shift > 28) return false;
+      extra |= (uint32_t)(v & 0x7F) << shift;
+      if (!(v & 0x80)) break;
+    }
+    wait += extra;
+  }
+
+  r->tick += wait;
+  e->action = b & STROKE_MAX_ACTION;
+  e->atMs = r->tick * STROKE_TICK_MS;
+  return true;
+}
+
+/**
+ * @brief file of session n (1 based)
+ *
+ * @param dst STROKE_PATH_LEN bytes
+ */
+void strokeSessionPath(char* dst, int n) {
+  snprintf(dst, STROKE_PATH_LEN, "/sketch/%04d.skl", n);
+}
+
+/**
+ * @brief number of saved sessions (they are numbered without gaps, so the first missing one ends the list)
+ */
+int strokeSessionCount(AssetSource* source) {
+  char path[STROKE_PATH_LEN];
+  int n = 0;
+  while (n < STROKE_MAX_SESSIONS) {
+    strokeSessionPath(path, n + 1);
+    if (source->fileSize(path) < 0) break;
+    n++;
+  }
+  return n;
+}
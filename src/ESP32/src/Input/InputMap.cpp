@@ -0,0 +1,295 @@
+/**
+ * @file InputMap.cpp
+ * @brief implementation of the input mapping tables
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Per command cost: one hash of the command string (verified with a single strcmp) to get the input code, then an array
+ * lookup for the action. Only inputs that start a chord do more: they are held back for up to INPUT_CHORD_MS to see if
+ * the partner follows, and the few chords of a profile are checked then. Inputs that are in no chord are never delayed.
+ *
+ * Hold / repeat: the Arduino repeats joystick commands for as long as a stick is pushed. The first command of a hold
+ * always fires; after that a binding with repeatMs only fires once every repeatMs until the stream stops for
+ * INPUT_HOLD_GAP_MS.
+ *
+ */
+
+#include "Input/InputMap.h"
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const INPUT_NAMES[IN_COUNT] = {
+  "none",
+  "btnUpArrow", "btnDownArrow", "btnHomeClick", "btnHomeHold",
+  "controller1A", "controller1B", "controller2A", "controller2B",
+  "rpg1CW", "rpg1CCW", "rpg2CW", "rpg2CCW",
+  "joystick1UP", "joystick1DOWN", "joystick1LEFT", "joystick1RIGHT",
+  "joystick2UP", "joystick2DOWN", "joystick2LEFT", "joystick2RIGHT",
+  "controller1ADouble", "controller1BDouble", "controller2ADouble", "controller2BDouble"
+};
+
+static_assert(IN_COUNT <= 32, "chordMask has one bit per input");
+
+// command string -> input code, open addressing on an FNV-1a hash. built on first use
+#define INPUT_HASH_SIZE 64
+static uint8_t hashTable[INPUT_HASH_SIZE];
+static bool hashBuilt = false;
+
+static uint32_t hashName(const char* s) {
+  uint32_t h = 2166136261u;
+  while (*s) {
+    h ^= (uint8_t)*s++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static void buildHash() {
+  memset(hashTable, IN_NONE, sizeof(hashTable));
+  for (int code = 1; code < IN_COUNT; code++) {
+    uint32_t i = hashName(INPUT_NAMES[code]) % INPUT_HASH_SIZE;
+    while (hashTable[i] != IN_NONE) i = (i + 1) % INPUT_HASH_SIZE;
+    hashTable[i] = code;
+  }
+  hashBuilt = true;
+}
+
+/**
+ * @brief input code of a command from the Arduino
+ *
+ * @return IN_NONE if it is not an input (status messages like powerOFF)
+ */
+uint8_t inputCode(const char* command) {
+  if (!hashBuilt) buildHash();
+  for (uint32_t i = hashName(command) % INPUT_HASH_SIZE; hashTable[i] != IN_NONE; i = (i + 1) % INPUT_HASH_SIZE) {
+    if (strcmp(INPUT_NAMES[hashTable[i]], command) == 0) return hashTable[i];
+  }
+  return IN_NONE;
+}
+
+const char* inputName(uint8_t code) {
+  return (code < IN_COUNT) ? INPUT_NAMES[code] : "";
+}
+
+// ---------- profiles ---------- //
+
+static void updateChordMask(InputProfile* p) {
+  p->chordMask = 0;
+  for (int i = 0; i < p->chordCount; i++) {
+    p->chordMask |= (1u << p->chords[i].a) | (1u << p->chords[i].b);
+  }
+}
+
+/**
+ * @brief set a binding (chord if input2 is given). binding a chord to INPUT_ACTION_NONE removes it
+ *
+ * @return false if the inputs or action are out of range, or there is no room for another chord
+ */
+bool inputBind(InputProfile* p, uint8_t input, uint8_t input2, uint8_t action, uint16_t repeatMs) {
+  if (input == IN_NONE || input >= IN_COUNT || input2 >= IN_COUNT || action >= p->actionCount) return false;
+
+  if (input2 == IN_NONE) {
+    p->action[input] = action;
+    p->repeatMs[input] = repeatMs;
+    return true;
+  }
+
+  // chords are unordered
+  for (int i = 0; i < p->chordCount; i++) {
+    InputChord& c = p->chords[i];
+    if ((c.a == input && c.b == input2) || (c.a == input2 && c.b == input)) {
+      if (action == INPUT_ACTION_NONE) c = p->chords[--p->chordCount];
+      else c.action = action;
+      updateChordMask(p);
+      return true;
+    }
+  }
+  if (action == INPUT_ACTION_NONE) return true;
+  if (p->chordCount == INPUT_MAX_CHORDS) return false;
+
+  p->chords[p->chordCount++] = { input, input2, action };
+  updateChordMask(p);
+  return true;
+}
+
+/**
+ * @brief fill a profile from its default bindings
+ *
+ * @param p profile
+ * @param name program name in the config file
+ * @param actionNames action id -> name, [0] must be "none"
+ * @param actionCount number of actions
+ * @param defaults default bindings
+ * @param count number of defaults
+ */
+void inputProfileInit(InputProfile* p, const char* name, const char* const* actionNames, uint8_t actionCount,
+                      const InputBinding* defaults, int count) {
+  memset(p, 0, sizeof(*p));
+  p->name = name;
+  p->actionNames = actionNames;
+  p->actionCount = actionCount;
+  for (int i = 0; i < count; i++) {
+    inputBind(p, defaults[i].input, defaults[i].input2, defaults[i].action, defaults[i].repeatMs);
+  }
+}
+
+/**
+ * @brief every input the profile reacts to (bit per input code), so the Arduino can leave the others unscanned
+ */
+uint32_t inputProfileInputs(const InputProfile* p) {
+  uint32_t used = p->chordMask;
+  for (int i = 1; i < IN_COUNT; i++) {
+    if (p->action[i] != INPUT_ACTION_NONE) used |= (1u << i);
+  }
+  return used;
+}
+
+static int findAction(const InputProfile* p, const char* name) {
+  for (int i = 0; i < p->actionCount; i++) {
+    if (strcmp(p->actionNames[i], name) == 0) return i;
+  }
+  return -1;
+}
+
+/**
+ * @brief apply one "program input[+input] action [repeat]" line
+ */
+static bool applyConfigLine(char* line, InputProfile* const* profiles, int count) {
+  char* program = strtok(line, " \t");
+  char* inputs = strtok(nullptr, " \t");
+  char* actionName = strtok(nullptr, " \t");
+  char* repeat = strtok(nullptr, " \t");
+  if (!program || program[0] == '#' || !inputs || !actionName) return false;
+
+  InputProfile* p = nullptr;
+  for (int i = 0; i < count && !p; i++) {
+    if (strcmp(profiles[i]->name, program) == 0) p = profiles[i];
+  }
+  if (!p) return false;
+
+  char* second = strchr(inputs, '+');
+  if (second) *second++ = '\0';
+  uint8_t a = inputCode(inputs);
+  uint8_t b = second ? inputCode(second) : (uint8_t)IN_NONE;
+  int action = findAction(p, actionName);
+  if (a == IN_NONE || (second && b == IN_NONE) || action < 0) return false;
+
+  return inputBind(p, a, b, action, repeat ? atoi(repeat) : 0);
+}
+
+/**
+ * @brief apply the bindings in the config file to the profiles
+ *
+ * lines for unknown programs, inputs or actions are skipped
+ *
+ * @return number of bindings applied, -1 if there is no (readable) config file
+ */
+int inputLoadConfig(AssetSource* source, const char* path, InputProfile* const* profiles, int count) {
+  int32_t size = source->fileSize(path);
+  if (size <= 0 || size > INPUT_CONFIG_MAX_BYTES) return -1;
+
+  char* text = new (std::nothrow) char[size + 1];
+  if (!text) return -1;
+  if (source->read(path, 0, (uint8_t*)text, size) != size) {
+    delete[] text;
+    return -1;
+  }
+  text[size] = '\0';
+
+  int applied = 0;
+  char* line = text;
+  while (line && *line) {
+    char* next = strpbrk(line, "\r\n");
+    if (next) *next++ = '\0';
+    if (applyConfigLine(line, profiles, count)) applied++;
+    line = next;
+  }
+
+  delete[] text;
+  return applied;
+}
+
+// ---------- mapping ---------- //
+
+/**
+ * @brief start mapping with a profile (clears any pending chord and hold state)
+ */
+void inputMapperInit(InputMapper* m, const InputProfile* profile) {
+  memset(m, 0, sizeof(*m));
+  m->profile = profile;
+  m->pending = IN_NONE;
+}
+
+/**
+ * @brief action of a single input, respecting its repeat rate while held
+ */
+static int fireSingle(InputMapper* m, uint8_t code, unsigned long now, uint8_t* out) {
+  uint8_t action = m->profile->action[code];
+  uint16_t repeat = m->profile->repeatMs[code];
+
+  bool holding = now - m->lastSeen[code] < INPUT_HOLD_GAP_MS;
+  m->lastSeen[code] = now;
+  if (action == INPUT_ACTION_NONE) return 0;
+  if (repeat && holding && now - m->lastFired[code] < repeat) return 0;
+
+  m->lastFired[code] = now;
+  *out = action;
+  return 1;
+}
+
+static uint8_t chordAction(const InputProfile* p, uint8_t a, uint8_t b) {
+  for (int i = 0; i < p->chordCount; i++) {
+    const InputChord& c = p->chords[i];
+    if ((c.a == a && c.b == b) || (c.a == b && c.b == a)) return c.action;
+  }
+  return INPUT_ACTION_NONE;
+}
+
+/**
+ * @brief map one input to actions
+ *
+ * @param m mapper
+ * @param code input code (inputCode())
+ * @param now millis() when it arrived
+ * @param actions up to two actions to perform, in order (an input held back for a chord can come out with this one)
+ * @return number of actions
+ */
+int inputEvent(InputMapper* m, uint8_t code, unsigned long now, uint8_t actions[2]) {
+  if (code == IN_NONE || code >= IN_COUNT) return 0;
+  int n = 0;
+
+  if (m->pending != IN_NONE) {
+    uint8_t first = m->pending;
+    m->pending = IN_NONE;
+    if (now - m->pendingAt < INPUT_CHORD_MS) {
+      uint8_t chord = chordAction(m->profile, first, code);
+      if (chord != INPUT_ACTION_NONE) {
+        actions[0] = chord;
+        return 1;
+      }
+    }
+    // no partner came, it was a plain press after all
+    n += fireSingle(m, first, m->pendingAt, actions);
+  }
+
+  if (m->profile->chordMask & (1u << code)) {
+    m->pending = code;
+    m->pendingAt = now;
+    return n;
+  }
+  return n + fireSingle(m, code, now, actions + n);
+}
+
+/**
+ * @brief release an input held back for a chord once its window has passed. call every pass of loop()
+ *
+ * @return number of actions (0 or 1)
+ */
+int inputPoll(InputMapper* m, unsigned long now, uint8_t actions[2]) {
+  if (m->pending == IN_NONE || now - m->pendingAt < INPUT_CHORD_MS) return 0;
+  uint8_t first = m->pending;
+  m->pending = IN_NONE;
+  return fireSingle(m, first, m->pendingAt, actions);
+}
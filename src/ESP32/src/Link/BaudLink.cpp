@@ -0,0 +1,241 @@
+/**
+ * @file BaudLink.cpp
+ * @brief implementation of the UART rate negotiation (ESP32 side)
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *   REQUEST --baudOK--> TEST --all echoes ok--> UP --errors / missed pongs--> HOLDOFF --> REQUEST (next lower rate)
+ *   REQUEST --baudNO--> REQUEST (next lower rate)
+ *   REQUEST --no answer at all--> IDLE (115200 for good)
+ *   TEST --bad / missing echo--> HOLDOFF (until the Arduino has reverted) --> REQUEST (next lower rate)
+ *
+ * Everything is driven by baudLinkLine() (a line arrived), baudLinkError() (a garbled line arrived) and baudLinkPoll()
+ * (time passed); none of them wait.
+ *
+ */
+
+#include "Link/BaudLink.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// fastest first, all exact on a 16 MHz AVR with U2X
+static const uint32_t BAUD_RATES[] = { 1000000, 500000, 250000 };
+static const uint8_t BAUD_RATE_COUNT = sizeof(BAUD_RATES) / sizeof(BAUD_RATES[0]);
+
+// wait after switching before the first test line (the Arduino switches right after its answer has left)
+#define BAUD_SETTLE_MS 5
+
+enum LinkState : uint8_t { LINK_REQUEST, LINK_TEST, LINK_UP, LINK_HOLDOFF, LINK_IDLE };
+
+/**
+ * @brief CRC-8 (polynomial 0x07), same as the Arduino's
+ */
+uint8_t baudCrc8(const char* data, int len) {
+  uint8_t crc = 0;
+  for (int i = 0; i < len; i++) {
+    crc ^= (uint8_t)data[i];
+    for (int b = 0; b < 8; b++) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+/**
+ * @brief test line for a round. printable characters only, different in every round
+ */
+static void testLine(uint8_t round, char* out) {
+  char payload[BAUD_TEST_PAYLOAD + 1];
+  for (int i = 0; i < BAUD_TEST_PAYLOAD; i++) payload[i] = (char)(0x21 + (round * 29 + i * 13) % 94);
+  payload[BAUD_TEST_PAYLOAD] = '\0';
+  sprintf(out, "test %u %s %02X", round, payload, baudCrc8(payload, BAUD_TEST_PAYLOAD));
+}
+
+static void request(BaudLink* link, uint32_t now) {
+  char line[24];
+  sprintf(line, "baud %lu", (unsigned long)BAUD_RATES[link->rate]);
+  link->port->sendLine(line);
+  link->round++;
+  link->since = now;
+}
+
+static void startRequest(BaudLink* link, uint32_t now) {
+  if (link->rate >= BAUD_RATE_COUNT) {
+    link->state = LINK_IDLE;              // nothing faster works, stay at 115200
+    return;
+  }
+  link->state = LINK_REQUEST;
+  link->round = 0;
+  link->stats.negotiations++;
+  request(link, now);
+}
+
+/**
+ * @brief go back to 115200 and try the next lower rate once the Arduino is back there too
+ *
+ * @param holdMs how long the Arduino may take to notice on its own
+ */
+static void dropRate(BaudLink* link, uint32_t now, uint32_t holdMs) {
+  link->port->setBaud(BAUD_DEFAULT);
+  link->stats.baud = BAUD_DEFAULT;
+  link->rate++;
+  link->state = LINK_HOLDOFF;
+  link->since = now;
+  link->round = 0;
+  link->holdMs = holdMs;
+}
+
+static void sendTest(BaudLink* link, uint32_t now) {
+  char line[48];
+  testLine(link->round, line);
+  link->port->sendLine(line);
+  link->awaiting = true;
+  link->since = now;
+}
+
+/**
+ * @brief count errors towards the fallback threshold
+ */
+static void addErrors(BaudLink* link, uint32_t count, uint32_t now) {
+  if (link->state != LINK_UP) return;
+  if (now - link->windowStart >= BAUD_ERROR_WINDOW_MS) {
+    link->windowStart = now;
+    link->windowErrors = 0;
+  }
+  link->windowErrors = (link->windowErrors + count > 255) ? 255 : link->windowErrors + count;
+  if (link->windowErrors >= BAUD_MAX_ERRORS) {
+    link->port->sendLine("baudDrop");
+    link->stats.fallbacks++;
+    dropRate(link, now, BAUD_WATCHDOG_MS);
+  }
+}
+
+/**
+ * @brief start negotiating. the first request goes out right away and is repeated while the Arduino boots
+ */
+void baudLinkBegin(BaudLink* link, LinkPort* port, uint32_t now) {
+  memset(link, 0, sizeof(*link));
+  link->port = port;
+  link->stats.baud = BAUD_DEFAULT;
+  startRequest(link, now);
+}
+
+/**
+ * @brief give a received line to the link first
+ *
+ * @return true if it was a link message (not a command for the programs)
+ */
+bool baudLinkLine(BaudLink* link, const char* line, uint32_t now) {
+  if (strncmp(line, "baudOK ", 7) == 0 || strncmp(line, "baudNO ", 7) == 0) {
+    if (link->state == LINK_REQUEST && strtoul(line + 7, nullptr, 10) == BAUD_RATES[link->rate]) {
+      if (line[4] == 'O') {
+        link->port->setBaud(BAUD_RATES[link->rate]);
+        link->state = LINK_TEST;
+        link->round = 0;
+        link->awaiting = false;
+        link->since = now;
+      } else {
+        link->rate++;
+        startRequest(link, now);
+      }
+    }
+    return true;
+  }
+
+  if (strncmp(line, "test", 4) == 0) {
+    if (link->state != LINK_TEST || !link->awaiting) return true;      // late echo of an earlier attempt
+    char expected[48];
+    testLine(link->round, expected);
+    if (strcmp(line, expected) != 0) {
+      link->stats.testErrors++;
+      dropRate(link, now, BAUD_COMMIT_MS);
+      return true;
+    }
+    link->awaiting = false;
+    if (++link->round == BAUD_TEST_ROUNDS) {
+      link->port->sendLine("baudCommit");
+      link->state = LINK_UP;
+      link->stats.baud = BAUD_RATES[link->rate];
+      link->lastPing = now;
+      link->windowStart = now;
+      link->windowErrors = 0;
+      link->missed = 0;
+    } else {
+      sendTest(link, now);
+    }
+    return true;
+  }
+
+  if (strncmp(line, "pong", 4) == 0) {
+    if (link->state == LINK_UP) {
+      link->awaiting = false;
+      link->missed = 0;
+      uint32_t peer = strtoul(line + 4, nullptr, 10);
+      if (peer) {
+        link->stats.peerErrors += peer;
+        addErrors(link, peer, now);
+      }
+    }
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief a line arrived garbled (bytes that cannot be in a command, or far too long)
+ */
+void baudLinkError(BaudLink* link, uint32_t now) {
+  link->stats.lineErrors++;
+  addErrors(link, 1, now);
+}
+
+/**
+ * @brief timeouts, retries and pings. call every pass
+ */
+void baudLinkPoll(BaudLink* link, uint32_t now) {
+  switch (link->state) {
+    case LINK_REQUEST:
+      if (now - link->since >= BAUD_REPLY_MS) {
+        if (link->round < BAUD_REQUEST_TRIES) {
+          request(link, now);
+        } else {
+          link->state = LINK_IDLE;        // no answer, the Arduino does not negotiate
+        }
+      }
+      break;
+
+    case LINK_TEST:
+      if (!link->awaiting) {
+        if (link->round == 0 && now - link->since >= BAUD_SETTLE_MS) sendTest(link, now);
+      } else if (now - link->since >= BAUD_REPLY_MS) {
+        link->stats.testErrors++;
+        dropRate(link, now, BAUD_COMMIT_MS);
+      }
+      break;
+
+    case LINK_UP:
+      if (now - link->lastPing >= BAUD_PING_MS) {
+        if (link->awaiting) {
+          link->stats.missedPongs++;
+          if (++link->missed >= BAUD_PING_MISSES) {
+            link->port->sendLine("baudDrop");
+            link->stats.fallbacks++;
+            dropRate(link, now, BAUD_WATCHDOG_MS);
+            break;
+          }
+        }
+        link->port->sendLine("ping");
+        link->awaiting = true;
+        link->lastPing = now;
+      }
+      break;
+
+    case LINK_HOLDOFF:
+      if (now - link->since >= link->holdMs) startRequest(link, now);
+      break;
+
+    default:
+      break;
+  }
+}
@@ -0,0 +1,72 @@
+/**
+ * @file InputContext.cpp
+ * @brief implementation of the input context messages (ESP32 side)
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "Link/InputContext.h"
+#include "Input/InputMap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief input groups behind a set of input codes (e.g. inputProfileInputs() of a program)
+ *
+ * @param codes bit per InputCode
+ * @return CTX_* bits
+ */
+uint16_t inputContextFromCodes(uint32_t codes) {
+  // InputCode -> group. the home, double click and direction codes share their button / stick
+  static const uint16_t GROUP[IN_COUNT] = {
+    0,
+    CTX_UP_ARROW, CTX_DOWN_ARROW, CTX_HOME, CTX_HOME,
+    CTX_C1A, CTX_C1B, CTX_C2A, CTX_C2B,
+    CTX_RPG1, CTX_RPG1, CTX_RPG2, CTX_RPG2,
+    CTX_JOY1, CTX_JOY1, CTX_JOY1, CTX_JOY1,
+    CTX_JOY2, CTX_JOY2, CTX_JOY2, CTX_JOY2,
+    CTX_C1A, CTX_C1B, CTX_C2A, CTX_C2B
+  };
+
+  uint16_t inputs = 0;
+  for (int i = 1; i < IN_COUNT; i++) {
+    if (codes & (1u << i)) inputs |= GROUP[i];
+  }
+  return inputs;
+}
+
+/**
+ * @brief the "ctx ..." line for the Arduino
+ *
+ * @return length written (without newline)
+ */
+int inputContextFormat(const InputContext* ctx, char* out, int size) {
+  return snprintf(out, size, "ctx %X %u %u", ctx->inputs, ctx->rpgDeltaMs, ctx->joystickMs);
+}
+
+bool inputContextSame(const InputContext* a, const InputContext* b) {
+  return a->inputs == b->inputs && a->rpgDeltaMs == b->rpgDeltaMs && a->joystickMs == b->joystickMs;
+}
+
+/**
+ * @brief read a "rpg1Delta <ticks>" / "rpg2Delta <ticks>" line
+ *
+ * @param rpg set to 1 or 2
+ * @param ticks set to the ticks turned (negative is counter clockwise)
+ * @return false if it is no delta line
+ */
+bool rpgDeltaParse(const char* line, uint8_t* rpg, int* ticks) {
+  if (strncmp(line, "rpg", 3) != 0 || (line[3] != '1' && line[3] != '2') || strncmp(line + 4, "Delta ", 6) != 0) {
+    return false;
+  }
+  char* end;
+  long value = strtol(line + 10, &end, 10);
+  if (end == line + 10 || *end != '\0') return false;
+
+  *rpg = line[3] - '0';
+  *ticks = (int)value;
+  return true;
+}
@@ -0,0 +1,24 @@
+/**
+ * @file SerialLinkPort.cpp
+ * @brief implementation of the HardwareSerial link port
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "Link/SerialLinkPort.h"
+
+void SerialLinkPort::sendLine(const char* line) {
+  serial.println(line);
+}
+
+/**
+ * @brief switch rates without reinstalling the driver
+ *
+ * flush() first: a line sent at the old rate (like "baudDrop") has to be out before the divider changes
+ */
+void SerialLinkPort::setBaud(uint32_t baud) {
+  serial.flush();
+  serial.updateBaudRate(baud);
+}
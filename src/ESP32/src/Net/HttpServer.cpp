@@ -0,0 +1,364 @@
+/**
+ * @file HttpServer.cpp
+ * @brief implementation of the HTTP request handlers
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * A deliberately small HTTP/1.1 server: one request per connection (the response always closes it), headers parsed
+ * line by line out of the receive buffer, and request bodies handed to the sink straight out of that same buffer, so an
+ * upload never takes more RAM than HTTP_BUFFER_SIZE no matter how big it is.
+ *
+ * The state lives in statics (about 2.5 KB with the PNG encoder) rather than on the caller's stack, so only one
+ * connection can be served at a time. That is all the console needs.
+ *
+ */
+
+#include "Net/HttpServer.h"
+#include "Net/PngEncoder.h"
+#include "PixelArt/Animation.h"
+#include "EtchASketch/StrokeLog.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define HTTP_LINE_SIZE 128              // header / chunk size lines (the request line may use half the buffer)
+
+struct HttpReader {
+  Socket* sock;
+  uint8_t buf[HTTP_BUFFER_SIZE];
+  uint16_t pos, len;
+
+  // request body
+  bool chunked;
+  bool chunkStarted;
+  bool bodyDone;
+  uint32_t bodyLeft;                    // bytes left of the body (Content-Length) or of the current chunk
+};
+
+static HttpReader reader;
+static PngEncoder png;
+
+// ---------- reading ---------- //
+
+static bool fill() {
+  int32_t got = reader.sock->read(reader.buf, sizeof(reader.buf));
+  if (got <= 0) return false;
+  reader.pos = 0;
+  reader.len = got;
+  return true;
+}
+
+/**
+ * @brief read one CRLF (or LF) terminated line
+ *
+ * @return false if the connection ended first or the line does not fit
+ */
+static bool readLine(char* line, int size) {
+  int n = 0;
+  for (;;) {
+    if (reader.pos == reader.len && !fill()) return false;
+    char c = reader.buf[reader.pos++];
+    if (c == '\n') break;
+    if (c == '\r') continue;
+    if (n == size - 1) return false;
+    line[n++] = c;
+  }
+  line[n] = '\0';
+  return true;
+}
+
+/**
+ * @brief next piece of the request body, straight out of the receive buffer
+ *
+ * @param data set to the bytes
+ * @return number of bytes, 0 at the end of the body, -1 on a broken connection or bad chunk framing
+ */
+static int32_t readBody(const uint8_t** data) {
+  while (reader.bodyLeft == 0) {
+    if (reader.bodyDone || !reader.chunked) {
+      reader.bodyDone = true;
+      return 0;
+    }
+
+    // every chunk's data is followed by a CRLF, then comes the next size line (hex, maybe with ;extensions)
+    char line[HTTP_LINE_SIZE];
+    if (reader.chunkStarted && (!readLine(line, sizeof(line)) || line[0])) return -1;
+    reader.chunkStarted = true;
+    if (!readLine(line, sizeof(line))) return -1;
+
+    char* end;
+    unsigned long size = strtoul(line, &end, 16);
+    if (end == line) return -1;
+
+    if (size == 0) {
+      // last chunk, skip any trailer headers
+      do {
+        if (!readLine(line, sizeof(line))) return -1;
+      } while (line[0]);
+      reader.bodyDone = true;
+      return 0;
+    }
+    reader.bodyLeft = size;
+  }
+
+  if (reader.pos == reader.len && !fill()) return -1;
+  uint32_t n = reader.len - reader.pos;
+  if (n > reader.bodyLeft) n = reader.bodyLeft;
+  *data = reader.buf + reader.pos;
+  reader.pos += n;
+  reader.bodyLeft -= n;
+  return n;
+}
+
+// ---------- responses ---------- //
+
+static void sendHeader(int status, const char* reason, const char* type, uint32_t length, const char* extra = "") {
+  char header[200];
+  int n = snprintf(header, sizeof(header),
+                   "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %lu\r\n%sConnection: close\r\n\r\n",
+                   status, reason, type, (unsigned long)length, extra);
+  reader.sock->write((const uint8_t*)header, n);
+}
+
+/**
+ * @brief a short plain text response
+ */
+static void sendText(int status, const char* reason, const char* text) {
+  sendHeader(status, reason, "text/plain", strlen(text));
+  reader.sock->write((const uint8_t*)text, strlen(text));
+}
+
+static void sendError(int status, const char* reason) {
+  char text[48];
+  snprintf(text, sizeof(text), "%d %s\n", status, reason);
+  sendText(status, reason, text);
+}
+
+// ---------- handlers ---------- //
+
+static bool validName(const char* name) {
+  int len = strlen(name);
+  if (len == 0 || len >= ASSET_NAME_LEN) return false;
+  for (int i = 0; i < len; i++) {
+    char c = name[i];
+    bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+    if (!ok) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief stream a request body into flash
+ *
+ * the first bytes must be an animation header, anything else is refused before it is written
+ */
+static void handleUpload(const HttpContext& ctx, AssetType type, const char* name, bool hasLength, uint32_t length,
+                         bool expectContinue) {
+  if (!validName(name)) return sendError(400, "Bad Name");
+  if (!reader.chunked && !hasLength) return sendError(411, "Length Required");
+  if (hasLength && length > HTTP_MAX_UPLOAD) return sendError(413, "Too Large");
+  if (!ctx.sink) return sendError(503, "No Storage");
+  if (ctx.accept && !ctx.accept(type, name)) return sendError(409, "Name In Use");
+
+  char path[ASSET_PATH_LEN];
+  snprintf(path, sizeof(path), "/img/%s.anim", name);
+  if (!ctx.sink->begin(path)) return sendError(507, "Insufficient Storage");
+
+  // curl waits a second for this before sending a big body
+  if (expectContinue) {
+    static const char CONTINUE[] = "HTTP/1.1 100 Continue\r\n\r\n";
+    reader.sock->write((const uint8_t*)CONTINUE, sizeof(CONTINUE) - 1);
+  }
+
+  static const uint8_t MAGIC[3] = { 'A', 'N', ANIM_VERSION };
+  uint32_t total = 0;
+  const uint8_t* data;
+  int32_t n;
+  while ((n = readBody(&data)) > 0) {
+    for (uint32_t i = 0; total + i < sizeof(MAGIC) && i < (uint32_t)n; i++) {
+      if (data[i] != MAGIC[total + i]) {
+        ctx.sink->abort();
+        return sendError(415, "Not An Animation");
+      }
+    }
+    total += n;
+    if (total > HTTP_MAX_UPLOAD) {
+      ctx.sink->abort();
+      return sendError(413, "Too Large");
+    }
+    if (!ctx.sink->write(data, n)) {
+      ctx.sink->abort();
+      return sendError(507, "Insufficient Storage");
+    }
+  }
+
+  if (n < 0) {
+    ctx.sink->abort();                  // client went away (or broke the chunking), nobody to answer
+    return;
+  }
+  if (total < ANIM_HEADER_SIZE) {
+    ctx.sink->abort();
+    return sendError(415, "Not An Animation");
+  }
+  if (!ctx.sink->finish()) return sendError(507, "Insufficient Storage");
+
+  if (ctx.stored) ctx.stored(type, name, path);
+
+  char text[64];
+  snprintf(text, sizeof(text), "stored %s (%lu bytes)\n", path, (unsigned long)total);
+  sendText(201, "Created", text);
+}
+
+static void handleCanvasPng(const HttpContext& ctx) {
+  uint32_t size = pngBegin(&png, ctx.pixels, ctx.width, ctx.height, ctx.stride);
+  sendHeader(200, "OK", "image/png", size);
+  pngWrite(&png, *reader.sock);
+}
+
+static void handleCanvasRaw(const HttpContext& ctx) {
+  char extra[48];
+  snprintf(extra, sizeof(extra), "X-Width: %u\r\nX-Height: %u\r\n", ctx.width, ctx.height);
+  sendHeader(200, "OK", "application/octet-stream", (uint32_t)ctx.width * ctx.height * 2, extra);
+
+  // the receive buffer is free by now, convert through it
+  for (int y = 0; y < ctx.height; y++) {
+    const uint16_t* row = ctx.pixels + y * ctx.stride;
+    int n = 0;
+    for (int x = 0; x < ctx.width; x++) {
+      reader.buf[n++] = row[x];
+      reader.buf[n++] = row[x] >> 8;
+      if (n == HTTP_BUFFER_SIZE) {
+        if (!reader.sock->write(reader.buf, n)) return;
+        n = 0;
+      }
+    }
+    if (n && !reader.sock->write(reader.buf, n)) return;
+  }
+}
+
+/**
+ * @brief list the saved sketches
+ *
+ * the length has to be known up front, so the list is formatted twice: once to add it up, once to send it
+ */
+static void handleSketchList(const HttpContext& ctx) {
+  int count = strokeSessionCount(ctx.source);
+  char path[STROKE_PATH_LEN];
+  char line[24];
+
+  uint32_t total = 0;
+  for (int n = 1; n <= count; n++) {
+    strokeSessionPath(path, n);
+    total += snprintf(line, sizeof(line), "%d %ld\n", n, (long)ctx.source->fileSize(path));
+  }
+  sendHeader(200, "OK", "text/plain", total);
+  for (int n = 1; n <= count; n++) {
+    strokeSessionPath(path, n);
+    int len = snprintf(line, sizeof(line), "%d %ld\n", n, (long)ctx.source->fileSize(path));
+    if (!reader.sock->write((const uint8_t*)line, len)) return;
+  }
+}
+
+/**
+ * @brief send one saved sketch's stroke log as it is stored
+ */
+static void handleSketchDownload(const HttpContext& ctx, const char* number) {
+  char path[STROKE_PATH_LEN];
+  int n = atoi(number);
+  if (n < 1 || n > STROKE_MAX_SESSIONS) return sendError(404, "Not Found");
+  strokeSessionPath(path, n);
+  int32_t size = ctx.source->fileSize(path);
+  if (size < 0) return sendError(404, "Not Found");
+
+  sendHeader(200, "OK", "application/octet-stream", size);
+  for (uint32_t offset = 0; offset < (uint32_t)size;) {
+    int32_t got = ctx.source->read(path, offset, reader.buf, HTTP_BUFFER_SIZE);
+    if (got <= 0 || !reader.sock->write(reader.buf, got)) return;
+    offset += got;
+  }
+}
+
+/**
+ * @brief read one request from the socket and answer it
+ *
+ * the caller closes the connection afterwards
+ *
+ * @param sock connected client
+ * @param ctx storage, canvas and callbacks
+ */
+void httpServe(Socket& sock, const HttpContext& ctx) {
+  reader.sock = &sock;
+  reader.pos = reader.len = 0;
+  reader.chunked = reader.chunkStarted = reader.bodyDone = false;
+  reader.bodyLeft = 0;
+
+  // request line, e.g. "PUT /assets/image/heart HTTP/1.1"
+  char request[HTTP_BUFFER_SIZE / 2];
+  if (!readLine(request, sizeof(request))) return;
+  char* method = strtok(request, " ");
+  char* path = strtok(nullptr, " ");
+  if (!method || !path) return sendError(400, "Bad Request");
+
+  // headers (only the few that matter here)
+  bool hasLength = false;
+  uint32_t length = 0;
+  bool expectContinue = false;
+  char line[HTTP_LINE_SIZE];
+  for (;;) {
+    if (!readLine(line, sizeof(line))) return sendError(431, "Header Too Large");
+    if (!line[0]) break;
+
+    char* value = strchr(line, ':');
+    if (!value) continue;
+    *value++ = '\0';
+    while (*value == ' ') value++;
+
+    if (strcasecmp(line, "Content-Length") == 0) {
+      hasLength = true;
+      length = strtoul(value, nullptr, 10);
+    }
+    else if (strcasecmp(line, "Transfer-Encoding") == 0 && strstr(value, "chunked")) {
+      reader.chunked = true;
+    }
+    else if (strcasecmp(line, "Expect") == 0 && strcasecmp(value, "100-continue") == 0) {
+      expectContinue = true;
+    }
+  }
+  if (!reader.chunked) reader.bodyLeft = length;
+
+  bool get = strcmp(method, "GET") == 0;
+  bool put = strcmp(method, "PUT") == 0 || strcmp(method, "POST") == 0;
+
+  if (strncmp(path, "/assets/", 8) == 0) {
+    if (!put) return sendError(405, "Method Not Allowed");
+    const char* rest = path + 8;
+    if (strncmp(rest, "image/", 6) == 0) return handleUpload(ctx, ASSET_IMAGE, rest + 6, hasLength, length, expectContinue);
+    if (strncmp(rest, "anim/", 5) == 0) return handleUpload(ctx, ASSET_ANIMATION, rest + 5, hasLength, length, expectContinue);
+    return sendError(404, "Not Found");
+  }
+
+  if (strcmp(path, "/canvas.png") == 0 || strcmp(path, "/canvas.raw") == 0) {
+    if (!get) return sendError(405, "Method Not Allowed");
+    if (!ctx.pixels) return sendError(503, "No Canvas");
+    if (path[8] == 'p') handleCanvasPng(ctx);
+    else handleCanvasRaw(ctx);
+    return;
+  }
+
+  if (strcmp(path, "/sketches") == 0 || strncmp(path, "/sketches/", 10) == 0) {
+    if (!get) return sendError(405, "Method Not Allowed");
+    if (!ctx.source) return sendError(503, "No Storage");
+    if (path[9] == '/') handleSketchDownload(ctx, path + 10);
+    else handleSketchList(ctx);
+    return;
+  }
+
+  if (strcmp(path, "/") == 0 && get) {
+    return sendText(200, "OK",
+                    "PUT /assets/image/<name>\nPUT /assets/anim/<name>\nGET /canvas.png\nGET /canvas.raw\n"
+                    "GET /sketches\nGET /sketches/<n>\n");
+  }
+  sendError(404, "Not Found");
+}
@@ -0,0 +1,240 @@
+/**
+ * @file PngEncoder.cpp
+ * @brief implementation of the streaming PNG encoder
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * pngBegin() makes one pass over the pixels to collect the palette (and gives up at 257 colors), pngWrite() makes a
+ * second one to send them. Everything goes through a 256 byte output buffer; the chunk CRC and the zlib Adler-32 are
+ * updated as bytes go by, so nothing but that buffer and the palette tables is ever held in memory.
+ *
+ * If the pixels change between the two passes (the canvas is live) a color missing from the palette is written as
+ * entry 0. The next download is right again.
+ *
+ */
+
+#include "Net/PngEncoder.h"
+#include <string.h>
+
+#define PNG_OUT_BUFFER 256
+#define DEFLATE_STORED_MAX 65535
+
+// CRC-32 (PNG / zlib polynomial) four bits at a time, small enough to not need a 1 KB table
+static const uint32_t CRC_NIBBLE[16] = {
+  0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+  0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+struct PngOut {
+  Socket* sock;
+  uint8_t buf[PNG_OUT_BUFFER];
+  uint16_t len;
+  uint32_t crc;                         // of the current chunk
+  uint32_t adlerA, adlerB;              // of the image data
+  uint32_t rawLeft;                     // image data bytes still to come
+  uint32_t blockLeft;                   // bytes left in the current stored block
+  bool ok;
+};
+
+static void flushOut(PngOut& o) {
+  if (o.len && o.ok) o.ok = o.sock->write(o.buf, o.len);
+  o.len = 0;
+}
+
+static void put(PngOut& o, uint8_t b) {
+  uint32_t crc = o.crc ^ b;
+  crc = (crc >> 4) ^ CRC_NIBBLE[crc & 15];
+  o.crc = (crc >> 4) ^ CRC_NIBBLE[crc & 15];
+
+  o.buf[o.len++] = b;
+  if (o.len == PNG_OUT_BUFFER) flushOut(o);
+}
+
+static void put32(PngOut& o, uint32_t v) {
+  put(o, v >> 24);
+  put(o, v >> 16);
+  put(o, v >> 8);
+  put(o, v);
+}
+
+/**
+ * @brief chunk length and type. the CRC covers the type and data, not the length
+ */
+static void beginChunk(PngOut& o, uint32_t length, const char* type) {
+  put32(o, length);
+  o.crc = 0xFFFFFFFF;
+  for (int i = 0; i < 4; i++) put(o, type[i]);
+}
+
+static void endChunk(PngOut& o) {
+  put32(o, ~o.crc);
+}
+
+/**
+ * @brief one byte of image data, starting a new stored deflate block whenever the last one is full
+ */
+static void putRaw(PngOut& o, uint8_t b) {
+  if (o.blockLeft == 0) {
+    uint16_t size = (o.rawLeft > DEFLATE_STORED_MAX) ? DEFLATE_STORED_MAX : o.rawLeft;
+    put(o, (o.rawLeft == size) ? 1 : 0);                    // BFINAL, BTYPE 00 (stored)
+    put(o, size);
+    put(o, size >> 8);
+    put(o, ~size);
+    put(o, (uint16_t)~size >> 8);
+    o.blockLeft = size;
+  }
+
+  put(o, b);
+  o.blockLeft--;
+  o.rawLeft--;
+  o.adlerA = (o.adlerA + b) % 65521;
+  o.adlerB = (o.adlerB + o.adlerA) % 65521;
+}
+
+static uint16_t hashSlot(uint16_t color) {
+  return (color ^ (color >> 7)) & (PNG_HASH_SIZE - 1);
+}
+
+/**
+ * @return palette index of color, -1 if it is not in the palette
+ */
+static int16_t paletteFind(const PngEncoder* png, uint16_t color) {
+  for (uint16_t i = hashSlot(color);; i = (i + 1) & (PNG_HASH_SIZE - 1)) {
+    if (png->hashIndex[i] < 0) return -1;
+    if (png->hashColor[i] == color) return png->hashIndex[i];
+  }
+}
+
+/**
+ * @brief add color to the palette if it is new
+ *
+ * @return false once there are more colors than fit in a palette
+ */
+static bool paletteAdd(PngEncoder* png, uint16_t color) {
+  uint16_t i = hashSlot(color);
+  while (png->hashIndex[i] >= 0) {
+    if (png->hashColor[i] == color) return true;
+    i = (i + 1) & (PNG_HASH_SIZE - 1);
+  }
+  if (png->paletteCount == PNG_MAX_PALETTE) return false;
+
+  png->hashColor[i] = color;
+  png->hashIndex[i] = png->paletteCount;
+  png->palette[png->paletteCount++] = color;
+  return true;
+}
+
+// RGB565 channels to 8 bits, repeating the top bits so full scale stays full scale
+static uint8_t expand5(uint16_t v) { return (v << 3) | (v >> 2); }
+static uint8_t expand6(uint16_t v) { return (v << 2) | (v >> 4); }
+
+static uint32_t rawSize(const PngEncoder* png) {
+  int bytesPerPixel = png->paletteCount ? 1 : 3;
+  return (uint32_t)png->height * (1 + png->width * bytesPerPixel);   // each row starts with its filter type
+}
+
+static uint32_t zlibSize(uint32_t raw) {
+  uint32_t blocks = (raw + DEFLATE_STORED_MAX - 1) / DEFLATE_STORED_MAX;
+  return 2 + raw + 5 * blocks + 4;                                    // header, blocks with their headers, Adler-32
+}
+
+/**
+ * @brief collect the palette and work out the size of the file
+ *
+ * @param png encoder state (about 2 KB, owned by the caller)
+ * @param pixels RGB565 image
+ * @param width image width
+ * @param height image height
+ * @param stride pixels per row of the buffer
+ * @return size of the PNG file in bytes
+ */
+uint32_t pngBegin(PngEncoder* png, const uint16_t* pixels, int width, int height, int stride) {
+  png->pixels = pixels;
+  png->width = width;
+  png->height = height;
+  png->stride = stride;
+  png->paletteCount = 0;
+  memset(png->hashIndex, 0xFF, sizeof(png->hashIndex));
+
+  bool fits = true;
+  for (int y = 0; y < height && fits; y++) {
+    const uint16_t* row = pixels + y * stride;
+    for (int x = 0; x < width && fits; x++) fits = paletteAdd(png, row[x]);
+  }
+  if (!fits) png->paletteCount = 0;
+
+  uint32_t size = 8 + (12 + 13) + (12 + zlibSize(rawSize(png))) + 12;
+  if (png->paletteCount) size += 12 + 3 * png->paletteCount;
+  return size;
+}
+
+/**
+ * @brief send the file sized by pngBegin()
+ *
+ * @return false if the connection dropped
+ */
+bool pngWrite(PngEncoder* png, Socket& out) {
+  static const uint8_t SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+  PngOut o;
+  o.sock = &out;
+  o.len = 0;
+  o.crc = 0;
+  o.ok = true;
+  for (int i = 0; i < 8; i++) put(o, SIGNATURE[i]);
+
+  beginChunk(o, 13, "IHDR");
+  put32(o, png->width);
+  put32(o, png->height);
+  put(o, 8);                                                // bit depth
+  put(o, png->paletteCount ? 3 : 2);                        // palette / RGB
+  put(o, 0);                                                // deflate
+  put(o, 0);                                                // filter method
+  put(o, 0);                                                // no interlace
+  endChunk(o);
+
+  if (png->paletteCount) {
+    beginChunk(o, 3 * png->paletteCount, "PLTE");
+    for (int i = 0; i < png->paletteCount; i++) {
+      uint16_t c = png->palette[i];
+      put(o, expand5(c >> 11));
+      put(o, expand6((c >> 5) & 0x3F));
+      put(o, expand5(c & 0x1F));
+    }
+    endChunk(o);
+  }
+
+  uint32_t raw = rawSize(png);
+  beginChunk(o, zlibSize(raw), "IDAT");
+  put(o, 0x78);                                             // zlib: deflate, 32K window, no dictionary
+  put(o, 0x01);
+  o.rawLeft = raw;
+  o.blockLeft = 0;
+  o.adlerA = 1;
+  o.adlerB = 0;
+
+  for (int y = 0; y < png->height && o.ok; y++) {
+    const uint16_t* row = png->pixels + y * png->stride;
+    putRaw(o, 0);                                           // filter: none
+    for (int x = 0; x < png->width; x++) {
+      uint16_t c = row[x];
+      if (png->paletteCount) {
+        int16_t index = paletteFind(png, c);
+        putRaw(o, index < 0 ? 0 : index);
+      } else {
+        putRaw(o, expand5(c >> 11));
+        putRaw(o, expand6((c >> 5) & 0x3F));
+        putRaw(o, expand5(c & 0x1F));
+      }
+    }
+  }
+  put32(o, (o.adlerB << 16) | o.adlerA);
+  endChunk(o);
+
+  beginChunk(o, 0, "IEND");
+  endChunk(o);
+
+  flushOut(o);
+  return o.ok;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file WebService.cpp
+ * @brief implementation of the Wi-Fi HTTP service
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The server runs in its own task pinned to core 0 (next to the Wi-Fi stack), while loop() and the panel refresh stay
+ * on core 1. The task never touches the HUB75 driver: downloads only read the canvas buffer (a pixel drawn mid download
+ * can come out torn, nothing worse) and uploads only write to flash, a receive buffer at a time. Saved sketches are read
+ * through the task's own LittleFSSource.
+ *
+ * Finished uploads are handed to the main loop through a single slot (uploadPending), and webServicePoll() adds them to
+ * the asset store there, so the store is still only ever changed from loop(). They show up in the slideshow right away,
+ * and the line appended to the index file keeps them after a reboot.
+ *
+ */
+
+#include "Net/WebService.h"
+#include "Net/HttpServer.h"
+#include "Assets/LittleFSSink.h"
+#include "Assets/LittleFSSource.h"
+#include <WiFi.h>
+#include <ESPmDNS.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// no credentials = no service
+#ifndef WIFI_SSID
+#define WIFI_SSID ""
+#endif
+#ifndef WIFI_PASSWORD
+#define WIFI_PASSWORD ""
+#endif
+
+/**
+ * @brief Socket over a Wi-Fi client, waiting up to WEB_TIMEOUT_MS for data
+ */
+class WiFiSocket : public Socket {
+public:
+  WiFiSocket(WiFiClient& c) : client(c) {}
+
+  int32_t read(uint8_t* dst, uint32_t len) override {
+    unsigned long start = millis();
+    while (!client.available()) {
+      if (!client.connected() || millis() - start >= WEB_TIMEOUT_MS) return -1;
+      vTaskDelay(1);
+    }
+    return client.read(dst, len);
+  }
+
+  bool write(const uint8_t* src, uint32_t len) override {
+    return client.write(src, len) == len;
+  }
+
+private:
+  WiFiClient& client;
+};
+
+static VirtualCanvas* display;
+static LittleFSSink flashSink;
+static LittleFSSource flashSource;      // own open file, the main loop's source is not shared across tasks
+static TaskHandle_t serverTask = nullptr;
+
+// upload waiting for loop() to add it to the asset store
+static volatile bool uploadPending = false;
+static AssetType pendingType;
+static char pendingName[ASSET_NAME_LEN];
+static char pendingPath[ASSET_PATH_LEN];
+
+/**
+ * @brief refuse names that are in the index already (or about to be)
+ */
+static bool acceptUpload(AssetType type, const char* name) {
+  if (uploadPending && strcmp(pendingName, name) == 0) return false;
+  return assetFind(name) < 0;
+}
+
+/**
+ * @brief record a finished upload in the index file and queue it for the asset store
+ */
+static void uploadStored(AssetType type, const char* name, const char* path) {
+  File index = LittleFS.open(ASSET_INDEX_PATH, "a");
+  if (index) {
+    index.printf("%s %s %s\n", (type == ASSET_ANIMATION) ? "anim" : "image", name, path);
+    index.close();
+  }
+
+  // loop() picks up the previous one within a frame
+  while (uploadPending) vTaskDelay(pdMS_TO_TICKS(10));
+  pendingType = type;
+  strcpy(pendingName, name);
+  strcpy(pendingPath, path);
+  uploadPending = true;
+}
+
+/**
+ * @brief accept and serve connections one at a time
+ */
+static void serverTaskLoop(void*) {
+  WiFiServer server(WEB_PORT);
+  bool listening = false;
+
+  HttpContext ctx;
+  ctx.sink = &flashSink;
+  ctx.source = &flashSource;
+  ctx.pixels = display->getBuffer();
+  ctx.width = display->width();
+  ctx.height = display->height();
+  ctx.stride = CANVAS_WIDTH;
+  ctx.accept = acceptUpload;
+  ctx.stored = uploadStored;
+
+  for (;;) {
+    if (WiFi.status() != WL_CONNECTED) {
+      vTaskDelay(pdMS_TO_TICKS(500));
+      continue;
+    }
+    if (!listening) {
+      server.begin();
+      MDNS.begin(WEB_HOSTNAME);
+      MDNS.addService("http", "tcp", WEB_PORT);
+      listening = true;
+    }
+
+    WiFiClient client = server.available();
+    if (!client) {
+      vTaskDelay(pdMS_TO_TICKS(20));
+      continue;
+    }
+
+    WiFiSocket sock(client);
+    httpServe(sock, ctx);
+    client.stop();
+  }
+}
+
+/**
+ * @brief start connecting to Wi-Fi and start the server task (returns right away)
+ *
+ * @param canvas canvas served by the downloads
+ * @return false if no credentials were built in
+ */
+bool webServiceBegin(VirtualCanvas* canvas) {
+  if (WIFI_SSID[0] == '\0') return false;
+
+  display = canvas;
+  WiFi.mode(WIFI_STA);
+  WiFi.setHostname(WEB_HOSTNAME);
+  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+
+  return xTaskCreatePinnedToCore(serverTaskLoop, "web", 6144, nullptr, 1, &serverTask, 0) == pdPASS;
+}
+
+/**
+ * @brief add a finished upload to the asset store (called every pass of loop())
+ */
+void webServicePoll() {
+  if (!uploadPending) return;
+  assetAdd(pendingType, pendingName, pendingPath);
+  uploadPending = false;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file Animation.cpp
+ * @brief decoder for the delta frame animation format
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The decoder trusts nothing: every read is checked against the data size and every rect against the image size, so a
+ * truncated or corrupt file stops the animation instead of writing outside the target buffer.
+ *
+ */
+
+#include "PixelArt/Animation.h"
+
+static inline uint16_t readU16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+static inline uint16_t paletteColor(const AnimInfo& info, uint8_t index) {
+  if (index >= info.paletteCount) return 0;
+  return readU16(info.palette + index * 2);
+}
+
+/**
+ * @brief fill one image pixel in the target, scale x scale target pixels
+ */
+static inline void putPixel(uint16_t* dst, int dstStride, int scale, int x, int y, uint16_t color) {
+  uint16_t* p = dst + (y * scale) * dstStride + x * scale;
+  for (int sy = 0; sy < scale; sy++) {
+    for (int sx = 0; sx < scale; sx++) p[sx] = color;
+    p += dstStride;
+  }
+}
+
+/**
+ * @brief check the header and locate the palette and first frame
+ *
+ * @return false if this is not a valid animation
+ */
+bool animParse(const uint8_t* data, uint32_t size, AnimInfo* info) {
+  if (!data || size < ANIM_HEADER_SIZE) return false;
+  if (data[0] != 'A' || data[1] != 'N' || data[2] != ANIM_VERSION) return false;
+
+  info->width = data[3];
+  info->height = data[4];
+  info->paletteCount = data[5] ? data[5] : 256;
+  info->frameCount = readU16(data + 6);
+  info->palette = data + ANIM_HEADER_SIZE;
+  info->firstFrame = ANIM_HEADER_SIZE + info->paletteCount * 2;
+
+  return info->width && info->height && info->frameCount && info->firstFrame <= size;
+}
+
+/**
+ * @brief decode the frame at *offset into dst and move *offset to the next frame
+ *
+ * @param dst where image pixel (0, 0) goes, must have room for width * scale by height * scale pixels
+ * @param dstStride pixels per row of dst
+ * @param scale integer magnification (1 = one target pixel per image pixel)
+ * @param dirty set to the target area the frame touched
+ * @return frame duration in ms, or -1 if the data is corrupt / past the last frame
+ */
+int32_t animDecodeFrame(const uint8_t* data, uint32_t size, const AnimInfo& info, uint32_t* offset, uint16_t* dst,
+                        int dstStride, int scale, AnimDirty* dirty) {
+  uint32_t pos = *offset;
+  if (pos + 5 > size) return -1;
+
+  uint32_t frameEnd = pos + 2 + readU16(data + pos);
+  uint16_t duration = readU16(data + pos + 2);
+  uint8_t rectCount = data[pos + 4];
+  pos += 5;
+  if (frameEnd > size) return -1;
+
+  int minX = info.width, minY = info.height, maxX = 0, maxY = 0;
+
+  for (int r = 0; r < rectCount; r++) {
+    if (pos + 4 > frameEnd) return -1;
+    int rx = data[pos], ry = data[pos + 1], rw = data[pos + 2], rh = data[pos + 3];
+    pos += 4;
+    if (rw == 0 || rh == 0 || rx + rw > info.width || ry + rh > info.height) return -1;
+
+    if (rx < minX) minX = rx;
+    if (ry < minY) minY = ry;
+    if (rx + rw > maxX) maxX = rx + rw;
+    if (ry + rh > maxY) maxY = ry + rh;
+
+    // walk the rect row by row, ops may span rows
+    int remaining = rw * rh;
+    int i = 0;
+    while (i < remaining) {
+      if (pos >= frameEnd) return -1;
+      uint8_t op = data[pos++];
+      int count;
+
+      if (op < 0x80) {
+        count = op + 1;
+        if (i + count > remaining || pos + count > frameEnd) return -1;
+        for (int k = 0; k < count; k++, i++) {
+          putPixel(dst, dstStride, scale, rx + i % rw, ry + i / rw, paletteColor(info, data[pos++]));
+        }
+      }
+      else if (op < 0xC0) {
+        count = (op & 0x3F) + 1;
+        if (i + count > remaining || pos >= frameEnd) return -1;
+        uint16_t color = paletteColor(info, data[pos++]);
+        for (int k = 0; k < count; k++, i++) {
+          putPixel(dst, dstStride, scale, rx + i % rw, ry + i / rw, color);
+        }
+      }
+      else {
+        count = (op & 0x3F) + 1;
+        if (i + count > remaining) return -1;
+        i += count;
+      }
+    }
+  }
+
+  if (dirty) {
+    if (maxX > minX) {
+      dirty->x = minX * scale;
+      dirty->y = minY * scale;
+      dirty->w = (maxX - minX) * scale;
+      dirty->h = (maxY - minY) * scale;
+    } else {
+      dirty->x = dirty->y = dirty->w = dirty->h = 0;
+    }
+  }
+
+  *offset = frameEnd;
+  return duration;
+}
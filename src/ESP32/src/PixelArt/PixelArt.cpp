@@ -10,209 +10,97 @@
  * Implementation of the pixel art slideshow. Images are hardcoded - very tedius process - and displayed in slideshow fashion: 
  * - up arrow: go forward
  * - down arrow: go backwards
+ * - click home: auto advance on / off (each slide stays up for the dwell time, then the next one fades in)
  * - hold home: exit to home as usual
  * 
  * Currently there are 
  * 
+ * The built in still images are drawn as character art in assets/ and packed by tools/pack_assets.py into one LZSS
+ * compressed blob (Assets/PackedAssets.h) that stays in flash. A slide is decoded row by row while it is scaled, so the
+ * only cost is when it is shown, and only the fixed decoder state (Assets/Unpack.h) is ever in RAM.
+ * 
+ * Slides can also be animations (see Animation.h). Those are decoded frame by frame straight into the canvas from
+ * updateCurrentImage(), which loop() calls while the slideshow is open.
+ * 
+ * After the built in slides come the images / animations listed in the flash asset index (see AssetStore.h). Those are
+ * loaded on first view, and the slides on either side are queued for prefetch so stepping through is instant.
+ * 
  */
 
 #include "PixelArt/PixelArt.h"
+#include "PixelArt/Animation.h"
+#include "PixelArt/PacmanAnim.h"
+#include "Assets/AssetStore.h"
+#include "Assets/BuiltinAssets.h"
+#include "Display/Blitter.h"
+#include "Display/Scaler.h"
+#include <new>
+
+static_assert(CANVAS_WIDTH <= SCALER_MAX_SIZE && CANVAS_HEIGHT <= SCALER_MAX_SIZE, "raise SCALER_MAX_SIZE for this canvas");
 
 // current image index
 int currentImageIndex = 0;
 
-// map character to RGB565 color
-uint16_t getColorForChar(char c, MatrixPanel_I2S_DMA* display) {
-  switch (c) {
-    case 'g': return display->color565(0, 255, 0);     // green
-    case 'y': return display->color565(255, 255, 0);   // yellow
-    case 'w': return display->color565(255, 255, 255); // white
-    case 'b': return display->color565(0, 0, 0);       // black
-    case 'r': return display->color565(255, 0, 0);     // red
-    case 'l': return display->color565(0, 0, 255);     // blue
-    case 'o': return display->color565(255, 165, 0);   // orange
-    case 'p': return display->color565(128, 0, 128);   // purple
-    case 'G': return display->color565(128,128,128);   // gray
-    case 'B': return display->color565(0, 0, 255);     // blue
-    default:  return display->color565(0, 0, 0);       // default to black
-  }
-}
-
 // define a struct to hold image data
 struct ImageData {
-  const char** rows;
-  int rowCount;
   const char* name;
+  int packed;                     // entry in the packed asset blob (Assets/PackedAssets.h), -1 for animated slides
+  const uint8_t* animation;       // set instead for animated slides
+  uint32_t animationSize;
 };
 
-// Green Bay Packers
-const char* packers_logo[] = {
-  "bbbbbbbbyyyyyyyyyyyyybbbbbbb",     
-  "bbbbbbyygggggggggggggyybbbbb",     
-  "bbbbyygggwwwwwwwwwwwgggyybbb",     
-  "bbbygggwwwwwwwwwwwwwwwgggybb",     
-  "bbyggwwwwwwwwwwwwwwwwwwwggyb",     
-  "byggwwwwwwgggggggwwwwwwwwggy",     
-  "yggwwwwwwggggggggggwwwwwwwgy",     
-  "ygwwwwwwgggggggggggggggggggy",     
-  "ygwwwwwwgggggggggggggggggggy",     
-  "ygwwwwwwgggggggggggggggggggy",     
-  "ygwwwwwwgggwwwwwwwwwwwwwwwgy",     
-  "ygwwwwwwggggwwwwwwwwwwwwwwgy",     
-  "bygwwwwwwwggggggggwwwwwwwggy",     
-  "byggwwwwwwwwwwwwwwwwwwwwggyb",     
-  "bbyggwwwwwwwwwwwwwwwwwwggybb",     
-  "bbbygggwwwwwwwwwwwwwwgggybbb",     
-  "bbbbyyggggwwwwwwwwggggyybbbb",     
-  "bbbbbbyyyggggggggggyyybbbbbb",     
-  "bbbbbbbbbyyyyyyyyyybbbbbbbbb"      
+// define image structs (the images themselves are in assets/, packed by tools/pack_assets.py)
+const ImageData allImages[] = {
+  {"Packers Logo", PACKED_PACKERS, nullptr, 0},
+  {"Iowa Logo", PACKED_IOWA, nullptr, 0},
+  {"Charmander", PACKED_CHARMANDER, nullptr, 0},
+  {"R2D2", PACKED_R2D2, nullptr, 0},
+  {"lebron", PACKED_LEBRON, nullptr, 0},
+  {"beer", PACKED_BEER, nullptr, 0},
+  {"Pac-Man", -1, pacman_anim, sizeof(pacman_anim)}
 };
 
-// Iowa Hawkeye
-const char* Iowa_logo[] = {
-  "bbbbbbbbbbbbbbbbbbbb", 
-  "bbbbbbbbbbbbbbbbbbbb", 
-  "bbbbbbbbbbbbbbbbbbbb", 
-  "bbbbbbbbbbbbbbbbbbbb", 
-  "bbbbbyyyyyyyyybbbbbb", 
-  "bbbyyyyyyyyyyyyybbbb", 
-  "bbyyyyyyyyyyyyyybbbb", 
-  "byyyyyyyybyyybyybbbb", 
-  "byyyyyybbbyyybbbbybb", 
-  "bbyyyybyybbbbbbbyyyb", 
-  "byyyyybyyyyyybbyyyyb", 
-  "bbyyybbbyyyyybyyyyyb", 
-  "byyybbbyyyyybbbbbyyb", 
-  "bbybbbyyyyyybbybbbyb", 
-  "bbbbbbyyyyybbbyybbbb", 
-  "bbbbbbbyybbbbbbbbbbb", 
-  "bbbbbbbbbbbbbbbbbbbb", 
-  "bbbbbbbbbbbbbbbbbbbb", 
-  "bbbbbbbbbbbbbbbbbbbb", 
-  "bbbbbbbbbbbbbbbbbbbb"  
-};
+// number of available images
+const int numImages = sizeof(allImages) / sizeof(allImages[0]);
 
-// Charamander Pokemon
-const char* charmander[] = {
-"wwwwwwwwwwwwwwwwwwwwwww", 
-"wwwwwbbbbwwwwwwwwwbwwww", 
-"wwwwboooobwwwwwwwbrbwww", 
-"wwwboooooobwwwwwwbrrbww", 
-"wwwboooooobwwwwwwbrrbww", 
-"wwbooowbooobwwwwbrrorbw", 
-"wboooobbooobwwwwbroyrbw", 
-"wboooobboooobwwwbryyrbw", 
-"wboooooooooobwwwwbybbww", 
-"wwboooooooooobwwwbobwww", 
-"wwwbbooooooooobwboobwww", 
-"wwwwwbbboobooobboobwwww", 
-"wwwwwwbyyboooooboobwwww", 
-"wwwwwwbyyybbooobobwwwww", 
-"wwwwwbwbyyyoooobbwwwwww", 
-"wwwwwwbbbyyooobbwwwwwww", 
-"wwwwwwwwwbbbobbwwwwwwww", 
-"wwwwwwwwwwbwowbwwwwwwww", 
-"wwwwwwwwwwwbbbwwwwwwwww", 
-"wwwwwwwwwwwwwwwwwwwwwww"  
-};
+// animation playback state for the current slide
+static bool animPlaying = false;
+static const uint8_t* animData;
+static uint32_t animSize;
+static AnimInfo animInfo;
+static uint32_t animOffset;
+static uint16_t animFrame;
+static unsigned long animNextFrame;
+static int animX, animY, animScale;
 
-// R2-D2 
-const char* r2d2[] = {
-"wwwwwwwwwwwwwwwwwwwwwwwww",
-"wwwwwwwwwwbbbbwwwwwwwwwww",
-"wwwwwwwwbbGBBGbbwwwwwwwww",
-"wwwwwwwbBGBwbBGBbwwwwwwww",
-"wwwwwwbBGGBbbBGGBbwwwwwww",
-"wwwwwwbGGGBBBBGGGbwwwwwww",
-"wwwwwbGBBGGGGGGGGGbwwwwww",
-"wwwwwbGGGGBGBBBGbGbwwwwww",
-"wwwwwbGBBGBGBrBGbGbwwwwww",
-"wwwwwbbbbbbbbbbbbbbwwwwww",
-"wwbbbbwwwwwwwwwwwwbbbwwww",
-"wwbwwbGGGwBBBBwGGGbwwbwww",
-"wwbwwbGwGwwwwwwGwGbwwbwww",
-"wwbwwbGwGwBBBBwGwGbwwbwww",
-"wwbbbbGwGwwwwwwGwGbbbbwww",
-"wwwbwbGwGwBGGBwGwGbwbwwww",
-"wwwbwbGwGwBGGBwGwGbwbwwww",
-"wwwbwbGwGwwwwwwGwGbwbwwww",
-"wwwbwbGGGwBBBBwGGGbwbwwww",
-"wwwbwbwwGwBGbBwGwwbwbwwww",
-"wwwbbbwwGwBbGBwGwwbbbwwww",
-"wwbwGbwwGwBBBBwGwwbGwbwww",
-"wwbwGbbbbbbbbbbbbbbGwbwww",
-"wbwwwbwwwbwGGwbwwwbwwwbww",
-"wbwwwbwwbwGwwGwbwwbwwwbww",
-"wbbbbbwwbbbbbbbbwwbbbbbww",
-"wwwwwwwwwwwwwwwwwwwwwwwww",
-};
+// if playback falls this far behind (screen was busy), restart the timing instead of rushing to catch up
+static const unsigned long ANIM_MAX_LAG_MS = 500;
 
-// Lebron James Logo
-const char* lebron[] = {
-  "wwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwww",
-    "wwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwww",
-    "wwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwww",
-    "wwwwwwwwwwwwwwwwwwwwbbbwwwwwwwwwwwwwwwwwwwww",
-    "wwwwwwwwwwwwwwwbbwwbbbbbwwwbbwwwwwwwwwwwwwww",
-    "wwwwwbbbbbbwwwwbbbbbbbbbbbbbbwwwwbbbbbbwwwww",
-    "wwwwwbbbbbbwwwwbbbbbbbbbbbbbbwwwwbbbbbbwwwww",
-    "wwwwwbbbbbbwwwwwwwwwwwwwwwwwwwwwwbbbbbbwwwww",
-    "wwwwwbbbbbbwwwwbbbbbbwbbbbbbbwwwwbbbbbbwwwww",
-    "wwwwwbbbbbbbwwbbbbbbbwbbbbbbbbwwbbbbbbbwwwww",
-    "wwwwwbbbbbbbbbbbbbbbbwbbbbbbbbbbbbbbbbbwwwww",
-    "wwwwwbbbbbbbbbbbbbbbbwbbbbbbbbbbbbbbbbbwwwww",
-    "wwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwww",
-    "wwwwbwwwwwbbbbbwbbbbbwwbbbbbwbbbbbwbbbbbwwww",
-    "wwwwbwwwwwbwwwbwbwwwbwwbwwwbwbwwwbwwwbwwwwww",
-    "wwwwbwwwwwbwwwwwbwwwwwwbwwwbwbwwwbwwwbwwwwww",
-    "wwwwbwwwwwbbbbwwbwwbbbwbwwwbwbbbbbwwwbwwwwww",
-    "wwwwbwwwwwbwwwwwbwwwbwwbwwwbwbwwwbwwwbwwwwww",
-    "wwwwbwwwwwbwwwbwbwwwbwwbwwwbwbwwwbwwwbwwwwww",
-    "wwwwbbbbbwbbbbbwbbbbbwwbbbbbwbwwwbwwwbwwwwww",
-    "wwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwww",
-    "wwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwww",
-    "wwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwww"
-};
+// auto advance: the next slide is made ready while the current one is up, then cross-faded in. fadeFrom holds the
+// outgoing slide for the fade
+static const unsigned long FADE_MS = 400;
+static bool autoAdvance = false;
+static unsigned long dwellMs = SLIDESHOW_DWELL_MS;
+static unsigned long slideShownAt = 0;
+static uint16_t* fadeFrom = nullptr;
+static int preparedSlide = -1;          // slide that is ready to fade in, -1 if none
+static bool fading = false;
+static unsigned long fadeStart;
+static uint8_t fadeShown;               // fade progress already on screen, 0..BLEND_ALPHA_MAX
 
-// Beer Pint
-const char* beer[] = {
-    "wwwwwwwwwwwwwwwwwwwwwww",
-    "wwwwwbbbbbbbwbwwwwwwwww",
-    "wwwwbwwGwwwwbwbwwwwwwww",
-    "wwwbwwwwwwGwwwbwwwwwwww",
-    "wwwbwGwwGwwbbwwbbwwwwww",
-    "wwwbwwwbbbbyybbwwbwwwww",
-    "wwwbGwbyyyyyybGGGwbwwww",
-    "wwwwbbyoyyyyybGbGwbwwww",
-    "wwwwbyooyyyyybbwbwbwwww",
-    "wwwwbyyyyyyyobwwbwbwwww",
-    "wwwwbyyyyyyyobwwbwbwwww",
-    "wwwwbyyyyyyoobbwbwbwwww",
-    "wwwwbyyyyyyoobwbGwbwwww",
-    "wwwwbyyyyyyyobwGGbwwwww",
-    "wwwwboyyyyyyybGGbwwwwww",
-    "wwwwboyyyyyyybbbwwwwwww",
-    "wwwbwboyyyyyybwwwwwwwww",
-    "wwwbwGbbbbbbbGbwwwwwwww",
-    "wwwwbwGGwwwwGwbwwwwwwww",
-    "wwwwwwbbwwwwwbbwwwwwwww",
-    "wwwwwwwbbbbbwwwwwwwwwww",
-    "wwwwwwwwwwwwwwwwwwwwwww"
-};
+// placement of the still slide being rendered (shared, slides are rendered one at a time)
+static ScaleMap slideMap;
 
-// define image structs
-const ImageData allImages[] = {
-  {packers_logo, sizeof(packers_logo) / sizeof(packers_logo[0]), "Packers Logo"},
-  {Iowa_logo, sizeof(Iowa_logo) / sizeof(Iowa_logo[0]), "Iowa Logo"},
-  {charmander, sizeof(charmander) / sizeof(charmander[0]), "Charmander"},
-  {r2d2, sizeof(r2d2) / sizeof(r2d2[0]), "R2D2"},
-  {lebron, sizeof(lebron) / sizeof(lebron[0]), "lebron"},
-  {beer, sizeof(beer)/ sizeof(beer[0]), "beer"}
+// a built in image being scaled: decoded from the packed blob and converted to RGB565 one row at a time
+struct PackedImage {
+  PackInfo pack;
+  PackEntry entry;
+  UnpackStream stream;
+  int row;                              // row in line, -1 before the first
+  uint8_t indices[SCALER_MAX_SOURCE];
+  uint16_t line[SCALER_MAX_SOURCE];
 };
 
-// number of available images
-const int numImages = sizeof(allImages) / sizeof(allImages[0]);
-
 /**
  * @brief Get the Current Image Index object
  * 
@@ -222,12 +110,39 @@ int getCurrentImageIndex() {
   return currentImageIndex;
 }
 
+/**
+ * @brief asset index of a slide that comes from flash
+ *
+ * @param slide slide number past the built in images
+ * @return asset index, -1 if there is no such slide
+ */
+static int flashSlideAsset(int slide) {
+  int n = slide - numImages;
+  for (int i = 0; i < assetCount(); i++) {
+    AssetType type = assetType(i);
+    if (type != ASSET_IMAGE && type != ASSET_ANIMATION) continue;
+    if (n-- == 0) return i;
+  }
+  return -1;
+}
+
+/**
+ * @brief number of slides: built in images plus flash images / animations
+ */
+static int slideCount() {
+  int count = numImages;
+  for (int i = 0; i < assetCount(); i++) {
+    if (assetType(i) == ASSET_IMAGE || assetType(i) == ASSET_ANIMATION) count++;
+  }
+  return count;
+}
+
 /**
  * @brief calculate the next image
  * 
  */
 void nextImage() {
-  currentImageIndex = (currentImageIndex + 1) % numImages;
+  currentImageIndex = (currentImageIndex + 1) % slideCount();
 }
 
 /**
@@ -235,71 +150,285 @@ void nextImage() {
  * 
  */
 void prevImage() {
-  currentImageIndex = (currentImageIndex - 1 + numImages) % numImages;
+  int count = slideCount();
+  currentImageIndex = (currentImageIndex - 1 + count) % count;
 }
 
 /**
- * @brief Draw the current image selected by the user
- * 
- * Most images are scaled by 2. This is not a standard size, but
- * because all of the pixel arts are very small (process took so long, so we keep thing small... 
+ * @brief decode the next frame of an animated slide onto the canvas
+ */
+static void showNextFrame(VirtualCanvas* display) {
+  // loop back to the keyframe
+  if (animFrame >= animInfo.frameCount) {
+    animFrame = 0;
+    animOffset = animInfo.firstFrame;
+  }
+
+  AnimDirty dirty;
+  uint16_t* dst = display->getBuffer() + animY * CANVAS_WIDTH + animX;
+  int32_t duration = animDecodeFrame(animData, animSize, animInfo, &animOffset, dst, CANVAS_WIDTH, animScale, &dirty);
+  if (duration < 0) {
+    animPlaying = false;                  // corrupt data, keep whatever is on screen
+    return;
+  }
+
+  if (dirty.w) display->markDirty(animX + dirty.x, animY + dirty.y, dirty.w, dirty.h);
+  animFrame++;
+  animNextFrame += duration;
+}
+
+/**
+ * @brief show the first frame of an animated slide and start playback
+ *
+ * the animation is magnified by the largest integer factor that fits the canvas
+ */
+static void startAnimation(VirtualCanvas* display, const uint8_t* data, uint32_t size) {
+  if (!animParse(data, size, &animInfo)) return;
+
+  animScale = min(display->width() / animInfo.width, display->height() / animInfo.height);
+  if (animScale < 1) return;
+  animX = (display->width() - animInfo.width * animScale) / 2;
+  animY = (display->height() - animInfo.height * animScale) / 2;
+
+  animData = data;
+  animSize = size;
+  animFrame = 0;
+  animOffset = animInfo.firstFrame;
+  animNextFrame = millis();
+  animPlaying = true;
+  showNextFrame(display);
+}
+
+/**
+ * @brief row y of a packed image
+ *
+ * the scaler asks for rows in order (reducing asks for a row shared by two output rows twice), so the stream just
+ * runs forward. a row that does not decode (corrupt blob) comes out black
+ */
+static const uint16_t* packedImageRow(void* ctx, int y) {
+  PackedImage* img = (PackedImage*)ctx;
+  if (y == img->row) return img->line;
+  if (y < img->row) {
+    unpackBegin(&img->stream, img->entry.data, img->entry.size);
+    img->row = -1;
+  }
+
+  int w = img->entry.width;
+  while (img->row < y) {
+    uint32_t n = unpackRead(&img->stream, img->indices, w);
+    memset(img->indices + n, 0, w - n);
+    img->row++;
+  }
+  for (int x = 0; x < w; x++) img->line[x] = packColor(img->pack, img->indices[x]);
+  return img->line;
+}
+
+/**
+ * @brief render a whole slide (black background included) into a canvas sized buffer
+ *
+ * All of the pixel arts are very small (process took so long, so we keep thing small... 
  * there is definitely a better way, or this is an opportunity for us to create a application to convert to pixel art for
  *  small LED displays - most online tools are for large images)
+ * Still images, built in or from flash, are placed by the scaler (Display/Scaler.h): magnified by the largest integer
+ * factor that fits, or area averaged down to fit if they are bigger than the canvas. Animations are magnified by the
+ * largest integer factor that fits (one that is bigger than the canvas is not shown).
+ * 
+ * @param display canvas (for its size and colors)
+ * @param slide slide to render
+ * @param dst buffer with CANVAS_WIDTH pixels per row
+ * @param anim set to the animation data if the slide is animated (frame 0 is rendered), nullptr otherwise
+ * @param animBytes set to the size of the animation data
+ */
+static void renderSlide(VirtualCanvas* display, int slide, uint16_t* dst, const uint8_t** anim, uint32_t* animBytes) {
+  int w = display->width();
+  int h = display->height();
+  blitFill(dst, CANVAS_WIDTH, w, h, display->color565(0, 0, 0));
+  *anim = nullptr;
+
+  const uint8_t* data;
+  uint32_t size;
+
+  if (slide >= numImages) {
+    const Asset* asset = assetGet(flashSlideAsset(slide));
+    if (!asset) return;
+
+    if (asset->type == ASSET_IMAGE) {
+      if (!scaleFit(&slideMap, asset->width, asset->height, w, h)) return;
+      scaleRenderBuffer(&slideMap, (const uint16_t*)asset->data, asset->width, dst, CANVAS_WIDTH);
+      return;
+    }
+    data = asset->data;
+    size = asset->size;
+  }
+  else if (allImages[slide].animation) {
+    data = allImages[slide].animation;
+    size = allImages[slide].animationSize;
+  }
+  else {
+    static PackedImage image;
+    if (!builtinAsset(allImages[slide].packed, &image.pack, &image.entry) || image.entry.type != PACK_IMAGE) return;
+
+    // each row is decoded and converted to RGB565 once as the scaler asks for it
+    unpackBegin(&image.stream, image.entry.data, image.entry.size);
+    image.row = -1;
+    if (!scaleFit(&slideMap, image.entry.width, image.entry.height, w, h)) return;
+    scaleRender(&slideMap, packedImageRow, &image, dst, CANVAS_WIDTH);
+    return;
+  }
+
+  // animated: keyframe only, playback starts once the slide is on screen
+  AnimInfo info;
+  if (!animParse(data, size, &info)) return;
+  int scale = min(w / info.width, h / info.height);
+  if (scale < 1) return;
+  uint16_t* origin = dst + ((h - info.height * scale) / 2) * CANVAS_WIDTH + (w - info.width * scale) / 2;
+  uint32_t offset = info.firstFrame;
+  if (animDecodeFrame(data, size, info, &offset, origin, CANVAS_WIDTH, scale, nullptr) < 0) return;
+
+  *anim = data;
+  *animBytes = size;
+}
+
+/**
+ * @brief Draw the current image selected by the user
  * 
- * The current pixel art image is sourced, then magnified before displaying it to the screen
+ * The current pixel art image is sourced, then magnified before displaying it to the screen. Flash slides on either
+ * side are queued for prefetch so stepping through is instant.
  * 
  * @param display 
  */
-void drawCurrentImage(MatrixPanel_I2S_DMA* display) {
-  // get current image data
-  const ImageData& currentImage = allImages[currentImageIndex];
-  const char** rows = currentImage.rows;
-  int rowCount = currentImage.rowCount;
-  
-  // calculate column count (width) from the first row
-  int colCount = strlen(rows[0]);
-  
-  // scale factor
-  int scaleFactor = 2;
-
-  // lebron image has scale factor of 1
-  if (currentImageIndex == 4) {
-    scaleFactor = 1;
+void drawCurrentImage(VirtualCanvas* display) {
+  animPlaying = false;
+  fading = false;
+  preparedSlide = -1;
+  slideShownAt = millis();
+
+  const uint8_t* anim;
+  uint32_t animBytes;
+  renderSlide(display, currentImageIndex, display->getBuffer(), &anim, &animBytes);
+  display->markDirty(0, 0, display->width(), display->height());
+  if (anim) startAnimation(display, anim, animBytes);
+
+  int count = slideCount();
+  assetPrefetch(flashSlideAsset((currentImageIndex + 1) % count));
+  assetPrefetch(flashSlideAsset((currentImageIndex - 1 + count) % count));
+}
+
+/**
+ * @brief get the upcoming slide ready for auto advance: the fade buffer allocated and a flash slide loaded
+ */
+static void prepareNextSlide(int next) {
+  if (!fadeFrom) {
+    fadeFrom = new (std::nothrow) uint16_t[CANVAS_WIDTH * CANVAS_HEIGHT];
+    if (!fadeFrom) return;
   }
-  // calculate offsets to center the image on the display
-  int xOffset = (64 - (colCount * scaleFactor)) / 2;
-  int yOffset = (64 - (rowCount * scaleFactor)) / 2;
-
-  // clear the display first
-  display->fillScreen(display->color565(0, 0, 0));
-  
-  // draw the image with scaling (no text displayed)
-  for (int y = 0; y < rowCount; y++) {
-    for (int x = 0; x < colCount; x++) {
-      char pixelChar = rows[y][x];
-      uint16_t color = getColorForChar(pixelChar, display);
-      
-      // draw a scaled block for each original pixel
-      for (int sy = 0; sy < scaleFactor; sy++) {
-        for (int sx = 0; sx < scaleFactor; sx++) {
-
-          // determine the location using the scale factor
-          int displayX = (x * scaleFactor) + sx + xOffset;
-          int displayY = (y * scaleFactor) + sy + yOffset;
-
-          // draw the pixel & continue
-          display->drawPixel(displayX, displayY, color);
-        }
-      }
-    }
+  preparedSlide = next;
+
+  // loading a flash slide made it the most recent asset. touch the one on screen again so its data (which an
+  // animation keeps reading) stays protected from eviction
+  if (next >= numImages) {
+    assetGet(flashSlideAsset(next));
+    if (currentImageIndex >= numImages) assetGet(flashSlideAsset(currentImageIndex));
   }
 }
 
+/**
+ * @brief step the cross-fade towards the prepared slide
+ *
+ * every step renders the new slide onto the canvas and blends the outgoing one back over it, so the canvas is always
+ * one blend of the two. (blending the canvas a little further towards the new slide each step would need no
+ * re-render, but each small step rounds away differences of a few levels, and dim areas only changed on the last one.)
+ * at most BLEND_ALPHA_MAX steps per fade, the last one leaves the exact new image.
+ */
+static void continueFade(VirtualCanvas* display, unsigned long now) {
+  unsigned long elapsed = now - fadeStart;
+  uint8_t progress = (elapsed >= FADE_MS) ? BLEND_ALPHA_MAX : (uint8_t)(elapsed * BLEND_ALPHA_MAX / FADE_MS);
+  if (progress <= fadeShown) return;
+
+  const uint8_t* anim;
+  uint32_t animBytes;
+  renderSlide(display, preparedSlide, display->getBuffer(), &anim, &animBytes);
+  blitBlend(display->getBuffer(), CANVAS_WIDTH, fadeFrom, CANVAS_WIDTH, display->width(), display->height(),
+            BLEND_ALPHA_MAX - progress);
+  display->markDirty(0, 0, display->width(), display->height());
+  fadeShown = progress;
+
+  if (progress == BLEND_ALPHA_MAX) {
+    // the canvas already shows the new slide, redrawing it only sets up playback / prefetch (same pixels)
+    currentImageIndex = preparedSlide;
+    drawCurrentImage(display);
+  }
+}
+
+/**
+ * @brief advance an animated slide when its next frame is due, and run auto advance
+ *
+ * frames are scheduled from the previous frame's due time rather than from now, so the frame rate stays steady
+ *
+ * @param display canvas
+ * @param now millis()
+ */
+void updateCurrentImage(VirtualCanvas* display, unsigned long now) {
+  if (fading) {
+    continueFade(display, now);
+    return;
+  }
+
+  if (animPlaying && (long)(now - animNextFrame) >= 0) {
+    if (now - animNextFrame > ANIM_MAX_LAG_MS) animNextFrame = now;
+    showNextFrame(display);
+  }
+
+  if (!autoAdvance) return;
+
+  // get the next slide ready well before it is needed (one render per pass of loop)
+  int next = (currentImageIndex + 1) % slideCount();
+  if (preparedSlide != next) {
+    prepareNextSlide(next);
+    return;
+  }
+
+  if (now - slideShownAt < dwellMs) return;
+
+  if (!fadeFrom) {
+    // no memory for the off screen slide, just cut
+    nextImage();
+    drawCurrentImage(display);
+    return;
+  }
+
+  animPlaying = false;
+  memcpy(fadeFrom, display->getBuffer(), CANVAS_WIDTH * CANVAS_HEIGHT * sizeof(uint16_t));
+  fading = true;
+  fadeStart = now;
+  fadeShown = 0;
+}
+
+/**
+ * @brief turn auto advance on / off (home button click in the slideshow)
+ *
+ * @return true if auto advance is now on
+ */
+bool toggleSlideshowAuto() {
+  autoAdvance = !autoAdvance;
+  slideShownAt = millis();
+  return autoAdvance;
+}
+
+/**
+ * @brief how long each slide stays up in auto advance
+ *
+ * @param ms dwell time in milliseconds
+ */
+void setSlideshowDwell(unsigned long ms) {
+  dwellMs = ms;
+}
+
 /**
  * @brief deprecated driver
  * 
  * @param display matrix object
  */
-void drawLogo(MatrixPanel_I2S_DMA* display) {
+void drawLogo(VirtualCanvas* display) {
   drawCurrentImage(display);
-}
\ No newline at end of file
+}
@@ -0,0 +1,240 @@
+/**
+ * @file Pong.cpp
+ * @brief implementation of the Pong program
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Controls:
+ * - joystick 1 / RPG 1: left paddle
+ * - joystick 2 / RPG 2: right paddle
+ * - turning an RPG clockwise moves its paddle up
+ * - controller A (either): new game once somebody reaches 7
+ * - hold home: exit to home as usual
+ *
+ * The Arduino streams joystick commands for as long as a stick is pushed, so a direction counts as held until no
+ * command for it has arrived for JOYSTICK_HOLD_MS. The simulation itself runs at a fixed PONG_TICK_MS no matter how
+ * fast commands come in, and the scene is rendered once per pass of loop() after catching up.
+ *
+ */
+
+#include "Pong/Pong.h"
+#include "Pong/PongGame.h"
+#include "Engine/SpriteEngine.h"
+
+// how long a streamed joystick command keeps the paddle moving
+static const unsigned long JOYSTICK_HOLD_MS = 60;
+
+// cap on ticks simulated in one pass so a long stall does not freeze the screen catching up
+static const int MAX_CATCHUP_TICKS = 4;
+
+// pixels a single RPG detent moves a paddle
+static const int8_t RPG_STEP = 3;
+
+static VirtualCanvas* display;
+static PongState game;
+static unsigned long lastTick = 0;
+static bool scoreDirty = true;
+
+// held joystick direction per player
+static int8_t joyDir[2] = {0, 0};
+static unsigned long joyTime[2] = {0, 0};
+
+// RPG movement (pixels, one per tick) waiting to be applied on the next ticks, kept within one sweep of the field
+static int16_t rpgPending[2] = {0, 0};
+
+// sprites
+static uint16_t paddlePixels[PONG_PADDLE_W * PONG_PADDLE_H];
+static uint16_t ballPixels[PONG_BALL_SIZE * PONG_BALL_SIZE];
+static const SpriteImage paddleImage = {paddlePixels, PONG_PADDLE_W, PONG_PADDLE_H};
+static const SpriteImage ballImage = {ballPixels, PONG_BALL_SIZE, PONG_BALL_SIZE};
+static Sprite* paddleSprites[2];
+static Sprite* ballSprite;
+
+// background: tile 0 empty, tile 1 has the dashed center line
+static uint16_t tilePixels[2 * ENGINE_TILE_SIZE * ENGINE_TILE_SIZE];
+static const Tileset tileset = {tilePixels, 2};
+static uint8_t cells[CANVAS_TILES_X * CANVAS_TILES_Y];
+static Tilemap tilemap = {&tileset, cells, CANVAS_TILES_X, CANVAS_TILES_Y};
+
+/**
+ * @brief build the sprite bitmaps and the center line tilemap
+ */
+static void buildScene() {
+  uint16_t white = display->color565(220, 220, 220);
+  uint16_t gray = display->color565(80, 80, 80);
+
+  for (int i = 0; i < PONG_PADDLE_W * PONG_PADDLE_H; i++) paddlePixels[i] = white;
+  for (int i = 0; i < PONG_BALL_SIZE * PONG_BALL_SIZE; i++) ballPixels[i] = white;
+
+  // dashed line: 4 on, 4 off, in the column of the tile holding the middle of the field
+  int centerX = display->width() / 2;
+  int dashCol = centerX % ENGINE_TILE_SIZE;
+  uint16_t* dashTile = &tilePixels[ENGINE_TILE_SIZE * ENGINE_TILE_SIZE];
+  for (int i = 0; i < ENGINE_TILE_SIZE * ENGINE_TILE_SIZE; i++) {
+    tilePixels[i] = 0;
+    dashTile[i] = (i % ENGINE_TILE_SIZE == dashCol && i / ENGINE_TILE_SIZE < 4) ? gray : 0;
+  }
+
+  // top tile row is the scoreboard, keep it empty
+  memset(cells, 0, sizeof(cells));
+  for (int row = 1; row < CANVAS_TILES_Y; row++) {
+    cells[row * CANVAS_TILES_X + centerX / ENGINE_TILE_SIZE] = 1;
+  }
+}
+
+/**
+ * @brief draw both scores (or the winner) in the top tile row
+ */
+static void drawScore() {
+  display->fillRect(0, 0, display->width(), ENGINE_TILE_SIZE, 0);
+  display->setTextSize(1);
+  display->setTextWrap(false);
+  display->setTextColor(display->color565(255, 255, 0));
+
+  if (game.gameOver) {
+    const char* msg = (game.score[0] > game.score[1]) ? "P1 WINS" : "P2 WINS";
+    display->setCursor((display->width() - (int)strlen(msg) * 6) / 2, 0);
+    display->print(msg);
+    return;
+  }
+
+  char left[4], right[4];
+  snprintf(left, sizeof(left), "%d", game.score[0]);
+  snprintf(right, sizeof(right), "%d", game.score[1]);
+
+  int centerX = display->width() / 2;
+  display->setCursor(centerX - 6 - (int)strlen(left) * 6, 0);
+  display->print(left);
+  display->setCursor(centerX + 6, 0);
+  display->print(right);
+}
+
+/**
+ * @brief copy simulation positions onto the sprites
+ */
+static void syncSprites() {
+  for (int p = 0; p < 2; p++) {
+    paddleSprites[p]->x = pongPaddleX(&game, p);
+    paddleSprites[p]->y = PONG_PX(game.paddleY[p]);
+  }
+  ballSprite->x = PONG_PX(game.ballX);
+  ballSprite->y = PONG_PX(game.ballY);
+  ballSprite->visible = (game.serveTimer == 0) || ((game.serveTimer >> 3) & 1);   // blink while waiting to serve
+}
+
+/**
+ * @brief start a fresh game
+ */
+static void newGame(unsigned long now) {
+  pongInit(&game, display->width(), ENGINE_TILE_SIZE, display->height());
+  joyDir[0] = joyDir[1] = 0;
+  rpgPending[0] = rpgPending[1] = 0;
+  lastTick = now;
+  scoreDirty = true;
+}
+
+/**
+ * @brief Function that initializes Pong
+ *
+ * the caller is responsible for enabling the controllers on the Arduino (see main.cpp)
+ *
+ * @param disp canvas to draw on
+ */
+void initPong(VirtualCanvas* disp) {
+  display = disp;
+  buildScene();
+
+  engineInit(display, 0);
+  engineSetTilemap(&tilemap);
+  paddleSprites[0] = engineAddSprite(&paddleImage, 0, 0, 1);
+  paddleSprites[1] = engineAddSprite(&paddleImage, 0, 0, 1);
+  ballSprite = engineAddSprite(&ballImage, 0, 0, 2);
+
+  newGame(millis());
+  syncSprites();
+  engineRender();
+  drawScore();
+  scoreDirty = false;
+}
+
+/**
+ * @brief queue RPG movement for a paddle
+ *
+ * a fast spin queues movement faster than the paddle moves. Anything past a full sweep of the field is dropped, the
+ * paddle is at the wall by then anyway
+ *
+ * @param player 0 or 1
+ * @param pixels negative is up
+ */
+static void queueRpg(int player, int16_t pixels) {
+  int16_t limit = game.bottom - game.top;
+  int16_t v = rpgPending[player] + pixels;
+  rpgPending[player] = (v > limit) ? limit : (v < -limit) ? -limit : v;
+}
+
+/**
+ * @brief Function that handles commands relating to Pong
+ *
+ * only records input, the simulation consumes it on the next tick
+ *
+ * @param cmd command from the Arduino received over UART
+ * @param now millis() when the command arrived
+ */
+void handlePongCommand(const String& cmd, unsigned long now) {
+  if      (cmd == "joystick1UP")   { joyDir[0] = -1; joyTime[0] = now; }
+  else if (cmd == "joystick1DOWN") { joyDir[0] =  1; joyTime[0] = now; }
+  else if (cmd == "joystick2UP")   { joyDir[1] = -1; joyTime[1] = now; }
+  else if (cmd == "joystick2DOWN") { joyDir[1] =  1; joyTime[1] = now; }
+  // clockwise moves either paddle up, the way RPG 2 moves the sketch cursor (ETCH_DEFAULTS: rpg2CW is up)
+  else if (cmd == "rpg1CW")  queueRpg(0, -RPG_STEP);
+  else if (cmd == "rpg1CCW") queueRpg(0,  RPG_STEP);
+  else if (cmd == "rpg2CW")  queueRpg(1, -RPG_STEP);
+  else if (cmd == "rpg2CCW") queueRpg(1,  RPG_STEP);
+  else if (cmd == "controller1A" || cmd == "controller2A") {
+    if (game.gameOver) newGame(now);
+  }
+}
+
+/**
+ * @brief run all simulation ticks that are due, then render once
+ *
+ * @param now millis()
+ */
+void updatePong(unsigned long now) {
+  int ticks = 0;
+  while (now - lastTick >= PONG_TICK_MS) {
+    if (ticks == MAX_CATCHUP_TICKS) {
+      lastTick = now;         // drop the backlog instead of spiralling
+      break;
+    }
+    lastTick += PONG_TICK_MS;
+    ticks++;
+
+    int8_t move[2];
+    for (int p = 0; p < 2; p++) {
+      move[p] = (now - joyTime[p] < JOYSTICK_HOLD_MS) ? joyDir[p] : 0;
+      if (rpgPending[p] > 0)      { move[p] = 1;  rpgPending[p]--; }
+      else if (rpgPending[p] < 0) { move[p] = -1; rpgPending[p]++; }
+    }
+
+    uint8_t events = pongStep(&game, move[0], move[1]);
+    if (events & (PONG_EVT_SCORED | PONG_EVT_GAME_OVER)) scoreDirty = true;
+  }
+
+  if (ticks == 0 && !scoreDirty) return;
+
+  syncSprites();
+  engineRender();
+  if (scoreDirty) {
+    drawScore();
+    scoreDirty = false;
+  }
+}
+
+/**
+ * @brief release the sprites when leaving the program
+ */
+void exitPong() {
+  engineClearSprites();
+}
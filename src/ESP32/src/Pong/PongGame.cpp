@@ -0,0 +1,189 @@
+/**
+ * @file PongGame.cpp
+ * @brief fixed tick Pong simulation with swept paddle collision
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The ball moves up to ~2.5 px per tick once it speeds up, which is more than the 2 px paddle width. Checking only the
+ * new position would let the ball tunnel through, so collisions are swept: we check whether the ball crossed the face of
+ * a paddle during the tick and where it was when it did. All math is integer so the simulation is bit-for-bit repeatable.
+ *
+ */
+
+#include "Pong/PongGame.h"
+
+// speeds in Q8.8 px/tick
+static const int32_t PADDLE_SPEED   = PONG_FP(1);
+static const int32_t SERVE_SPEED    = 192;          // 0.75 px/tick
+static const int32_t MAX_SPEED      = 640;          // 2.5 px/tick
+static const int32_t SPEEDUP        = 16;           // per paddle hit
+static const uint8_t SERVE_DELAY    = 45;           // ~0.7 s between points
+
+/**
+ * @brief 16 bit galois LFSR (deterministic serve angles)
+ */
+static uint16_t nextRandom(PongState* s) {
+  uint16_t lsb = s->rng & 1;
+  s->rng >>= 1;
+  if (lsb) s->rng ^= 0xB400;
+  return s->rng;
+}
+
+/**
+ * @brief x of a paddle's left edge in pixels
+ *
+ * @param player 0 (left) or 1 (right)
+ */
+int16_t pongPaddleX(const PongState* s, int player) {
+  return (player == 0) ? PONG_PADDLE_INSET : s->width - PONG_PADDLE_INSET - PONG_PADDLE_W;
+}
+
+/**
+ * @brief put the ball back in the middle and wait before serving
+ */
+static void resetBall(PongState* s) {
+  s->ballX = PONG_FP(s->width / 2 - PONG_BALL_SIZE / 2);
+  s->ballY = PONG_FP((s->top + s->bottom) / 2 - PONG_BALL_SIZE / 2);
+  s->ballVX = 0;
+  s->ballVY = 0;
+  s->serveTimer = SERVE_DELAY;
+}
+
+/**
+ * @brief start a new game
+ *
+ * @param width playfield width in pixels
+ * @param top first playfield row (rows above are for the score)
+ * @param bottom one past the last playfield row
+ */
+void pongInit(PongState* s, int16_t width, int16_t top, int16_t bottom) {
+  s->width = width;
+  s->top = top;
+  s->bottom = bottom;
+  s->paddleY[0] = s->paddleY[1] = PONG_FP((top + bottom - PONG_PADDLE_H) / 2);
+  s->score[0] = s->score[1] = 0;
+  s->serveDir = 1;
+  s->rng = 0xACE1;
+  s->tick = 0;
+  s->gameOver = false;
+  resetBall(s);
+}
+
+/**
+ * @brief move a paddle, clamped to the playfield
+ */
+static void movePaddle(PongState* s, int player, int8_t move) {
+  int32_t y = s->paddleY[player] + move * PADDLE_SPEED;
+  int32_t minY = PONG_FP(s->top);
+  int32_t maxY = PONG_FP(s->bottom - PONG_PADDLE_H);
+  if (y < minY) y = minY;
+  if (y > maxY) y = maxY;
+  s->paddleY[player] = y;
+}
+
+/**
+ * @brief check whether the ball crossed a paddle face this tick and bounce it
+ *
+ * @param face x (Q8.8) of the paddle face the leading edge of the ball is tested against
+ * @param lead current x (Q8.8) of the leading edge of the ball
+ * @param nextLead leading edge after this tick
+ * @return true if the ball was returned
+ */
+static bool sweepPaddle(PongState* s, int player, int32_t face, int32_t lead, int32_t nextLead, int32_t* nx) {
+  bool crossed = (player == 0) ? (lead >= face && nextLead < face) : (lead <= face && nextLead > face);
+  if (!crossed) return false;
+
+  // ball y at the moment it reached the face (linear along the tick)
+  int32_t dx = nextLead - lead;
+  int32_t yAt = s->ballY + (s->ballVY * (face - lead)) / dx;
+
+  int32_t paddleTop = s->paddleY[player];
+  if (yAt + PONG_FP(PONG_BALL_SIZE) <= paddleTop || yAt >= paddleTop + PONG_FP(PONG_PADDLE_H)) {
+    return false;
+  }
+
+  // reflect the rest of the move back out of the face
+  *nx += 2 * (face - nextLead);
+
+  // speed up and steer by where the ball hit the paddle (center = flat, edges = steep)
+  int32_t speed = (s->ballVX < 0 ? -s->ballVX : s->ballVX) + SPEEDUP;
+  if (speed > MAX_SPEED) speed = MAX_SPEED;
+  s->ballVX = (player == 0) ? speed : -speed;
+
+  int32_t offset = (yAt + PONG_FP(PONG_BALL_SIZE) / 2) - (paddleTop + PONG_FP(PONG_PADDLE_H) / 2);
+  s->ballVY = offset / 4;
+  return true;
+}
+
+/**
+ * @brief advance the game one fixed tick
+ *
+ * @param move1 player 1 paddle: -1 up, 0 stay, +1 down
+ * @param move2 player 2 paddle
+ * @return uint8_t PONG_EVT_* flags for what happened this tick
+ */
+uint8_t pongStep(PongState* s, int8_t move1, int8_t move2) {
+  uint8_t events = 0;
+  s->tick++;
+
+  if (s->gameOver) return 0;
+
+  movePaddle(s, 0, move1);
+  movePaddle(s, 1, move2);
+
+  // waiting to serve
+  if (s->serveTimer) {
+    if (--s->serveTimer == 0) {
+      s->ballVX = s->serveDir * SERVE_SPEED;
+      s->ballVY = (int32_t)(nextRandom(s) % 257) - 128;      // -0.5 .. 0.5 px/tick
+      events |= PONG_EVT_SERVE;
+    }
+    return events;
+  }
+
+  int32_t nx = s->ballX + s->ballVX;
+  int32_t ny = s->ballY + s->ballVY;
+
+  // top / bottom walls
+  int32_t minY = PONG_FP(s->top);
+  int32_t maxY = PONG_FP(s->bottom - PONG_BALL_SIZE);
+  if (ny < minY) { ny = 2 * minY - ny; s->ballVY = -s->ballVY; events |= PONG_EVT_WALL_HIT; }
+  if (ny > maxY) { ny = 2 * maxY - ny; s->ballVY = -s->ballVY; events |= PONG_EVT_WALL_HIT; }
+
+  // paddles (swept against the face)
+  if (s->ballVX < 0) {
+    int32_t face = PONG_FP(pongPaddleX(s, 0) + PONG_PADDLE_W);
+    if (sweepPaddle(s, 0, face, s->ballX, nx, &nx)) events |= PONG_EVT_PADDLE_HIT;
+  } else if (s->ballVX > 0) {
+    int32_t face = PONG_FP(pongPaddleX(s, 1));
+    int32_t size = PONG_FP(PONG_BALL_SIZE);
+    int32_t lead = nx + size;
+    if (sweepPaddle(s, 1, face, s->ballX + size, lead, &lead)) {
+      nx = lead - size;
+      events |= PONG_EVT_PADDLE_HIT;
+    }
+  }
+
+  s->ballX = nx;
+  s->ballY = ny;
+
+  // out of play on either side
+  int scorer = -1;
+  if (nx + PONG_FP(PONG_BALL_SIZE) < 0) scorer = 1;
+  else if (nx > PONG_FP(s->width))     scorer = 0;
+
+  if (scorer >= 0) {
+    s->score[scorer]++;
+    s->serveDir = (scorer == 0) ? 1 : -1;      // serve towards whoever just lost the point
+    events |= PONG_EVT_SCORED;
+    resetBall(s);
+
+    if (s->score[scorer] >= PONG_WIN_SCORE) {
+      s->gameOver = true;
+      events |= PONG_EVT_GAME_OVER;
+    }
+  }
+
+  return events;
+}
@@ -0,0 +1,202 @@
+/**
+ * @file FrameStream.cpp
+ * @brief implementation of the streamed frame decoder
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * A byte at a time state machine, except for pixel data: literal and run ops are copied in a tight loop over as much of
+ * the input as is there, which is where nearly all the bytes of a frame are. Pixels are written as they are decoded, so a
+ * damaged frame can leave a few wrong tiles on screen until the keyframe the host sends in reply.
+ *
+ */
+
+#include "Remote/FrameStream.h"
+#include <string.h>
+
+enum {
+  FS_SYNC0, FS_SYNC1, FS_HEADER, FS_TILE_INDEX, FS_OP, FS_PIXELS, FS_CHECK
+};
+
+static const int TILE_PIXELS = STREAM_TILE * STREAM_TILE;
+
+/**
+ * @brief set up a decoder writing into a framebuffer
+ *
+ * @param fs decoder
+ * @param pixels RGB565 framebuffer
+ * @param width framebuffer width (multiple of STREAM_TILE)
+ * @param height framebuffer height (multiple of STREAM_TILE)
+ * @param stride pixels per row of the framebuffer
+ */
+void frameStreamInit(FrameStream* fs, uint16_t* pixels, int width, int height, int stride) {
+  memset(fs, 0, sizeof(*fs));
+  fs->pixels = pixels;
+  fs->stride = stride;
+  fs->tilesX = width / STREAM_TILE;
+  fs->tilesY = height / STREAM_TILE;
+  frameStreamReset(fs);
+}
+
+/**
+ * @brief forget any partial frame and wait for the next sync
+ */
+void frameStreamReset(FrameStream* fs) {
+  fs->state = FS_SYNC0;
+  fs->fieldLen = 0;
+}
+
+static void checksum(FrameStream* fs, uint8_t b) {
+  fs->sum1 = (fs->sum1 + b) % 255;
+  fs->sum2 = (fs->sum2 + fs->sum1) % 255;
+}
+
+static void dropFrame(FrameStream* fs) {
+  fs->stats.errors++;
+  if (fs->frameDone) fs->frameDone(fs->ctx, fs->seq, false);
+  frameStreamReset(fs);
+}
+
+/**
+ * @brief the pixel the current op is at, moving to the next one
+ */
+static inline uint16_t* nextPixel(FrameStream* fs) {
+  uint8_t i = fs->pixel++;
+  return fs->tile + (i / STREAM_TILE) * fs->stride + (i % STREAM_TILE);
+}
+
+/**
+ * @brief a tile is complete: report it and move on to the next tile (or the checksum)
+ */
+static void endTile(FrameStream* fs) {
+  int index = fs->tile - fs->pixels;
+  if (fs->tileDone) fs->tileDone(fs->ctx, (index % fs->stride), (index / fs->stride));
+  fs->stats.tiles++;
+  fs->state = (--fs->tilesLeft) ? FS_TILE_INDEX : FS_CHECK;
+}
+
+/**
+ * @brief decode as much of data as there is
+ *
+ * @param fs decoder
+ * @param data received bytes (any amount, frames can be split anywhere)
+ * @param len number of bytes
+ */
+void frameStreamFeed(FrameStream* fs, const uint8_t* data, uint32_t len) {
+  const uint8_t* end = data + len;
+  fs->stats.bytes += len;
+
+  while (data < end) {
+    // pixel data: as many 16 bit pixels as are here in one go
+    if (fs->state == FS_PIXELS) {
+      if (fs->fieldLen == 0 && end - data >= 2) {
+        uint16_t color = data[0] | (data[1] << 8);
+        checksum(fs, data[0]);
+        checksum(fs, data[1]);
+        data += 2;
+
+        if (fs->opRun) {
+          while (fs->opLeft) {
+            *nextPixel(fs) = color;
+            fs->opLeft--;
+          }
+        } else {
+          *nextPixel(fs) = color;
+          fs->opLeft--;
+          while (fs->opLeft && end - data >= 2) {
+            checksum(fs, data[0]);
+            checksum(fs, data[1]);
+            *nextPixel(fs) = data[0] | (data[1] << 8);
+            data += 2;
+            fs->opLeft--;
+          }
+        }
+      } else {
+        // a pixel split across two pieces of input
+        checksum(fs, *data);
+        fs->field[fs->fieldLen++] = *data++;
+        if (fs->fieldLen < 2) continue;
+        fs->fieldLen = 0;
+        uint16_t color = fs->field[0] | (fs->field[1] << 8);
+        do {
+          *nextPixel(fs) = color;
+          fs->opLeft--;
+        } while (fs->opRun && fs->opLeft);
+      }
+
+      if (fs->opLeft == 0) {
+        if (fs->pixel == TILE_PIXELS) endTile(fs);
+        else fs->state = FS_OP;
+      }
+      continue;
+    }
+
+    uint8_t b = *data++;
+    switch (fs->state) {
+      case FS_SYNC0:
+        if (b == STREAM_SYNC0) fs->state = FS_SYNC1;
+        break;
+
+      case FS_SYNC1:
+        if (b == STREAM_SYNC1) {
+          fs->state = FS_HEADER;
+          fs->fieldLen = 0;
+          fs->sum1 = fs->sum2 = 0;
+        }
+        else if (b != STREAM_SYNC0) fs->state = FS_SYNC0;
+        break;
+
+      case FS_HEADER:
+        checksum(fs, b);
+        fs->field[fs->fieldLen++] = b;
+        if (fs->fieldLen < 4) break;
+        fs->fieldLen = 0;
+        fs->seq = fs->field[0];
+        fs->flags = fs->field[1];
+        fs->tilesLeft = fs->field[2] | (fs->field[3] << 8);
+        if (fs->tilesLeft > fs->tilesX * fs->tilesY) dropFrame(fs);
+        else fs->state = fs->tilesLeft ? FS_TILE_INDEX : FS_CHECK;
+        break;
+
+      case FS_TILE_INDEX: {
+        checksum(fs, b);
+        fs->field[fs->fieldLen++] = b;
+        if (fs->fieldLen < 2) break;
+        fs->fieldLen = 0;
+        uint16_t index = fs->field[0] | (fs->field[1] << 8);
+        if (index >= fs->tilesX * fs->tilesY) {
+          dropFrame(fs);
+          break;
+        }
+        fs->tile = fs->pixels + (index / fs->tilesX) * STREAM_TILE * fs->stride + (index % fs->tilesX) * STREAM_TILE;
+        fs->pixel = 0;
+        fs->state = FS_OP;
+        break;
+      }
+
+      case FS_OP:
+        checksum(fs, b);
+        fs->opRun = b & 0x80;
+        fs->opLeft = (b & 0x7F) + 1;
+        if (fs->pixel + fs->opLeft > TILE_PIXELS) {
+          dropFrame(fs);                  // op runs past the end of the tile
+          break;
+        }
+        fs->state = FS_PIXELS;
+        break;
+
+      case FS_CHECK:
+        fs->field[fs->fieldLen++] = b;
+        if (fs->fieldLen < 2) break;
+        fs->fieldLen = 0;
+        if ((fs->field[0] | (fs->field[1] << 8)) != ((fs->sum2 << 8) | fs->sum1)) {
+          dropFrame(fs);
+          break;
+        }
+        fs->stats.frames++;
+        if (fs->frameDone) fs->frameDone(fs->ctx, fs->seq, true);
+        fs->state = FS_SYNC0;
+        break;
+    }
+  }
+}
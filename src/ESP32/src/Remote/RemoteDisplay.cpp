@@ -0,0 +1,147 @@
+/**
+ * @file RemoteDisplay.cpp
+ * @brief implementation of the Stream program
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Each pass of loop() moves whatever arrived from the active link into the decoder a chunk at a time (up to
+ * REMOTE_BUDGET_US) and the decoder writes the pixels straight into the canvas framebuffer, marking each tile it
+ * finishes. There is no frame buffer for incoming data, only the one chunk buffer; the flush at the end of loop() then
+ * pushes just those tiles to the panels.
+ *
+ * Flow control: after every frame the host gets 'A' + seq (or 'K' if the frame was damaged and it should send a
+ * keyframe). The host keeps at most two frames in flight, so the receive buffer never overflows however fast the link
+ * is. Only one link is read at a time; data on the other one resets the decoder and takes over.
+ *
+ * Keys:
+ * - hold home: exit to home as usual
+ *
+ */
+
+#include "Remote/RemoteDisplay.h"
+#include "Remote/FrameStream.h"
+#include <WiFi.h>
+
+static VirtualCanvas* display;
+static FrameStream decoder;
+static uint8_t rx[REMOTE_CHUNK];
+
+static bool serialStarted = false;
+static WiFiServer tcpServer(REMOTE_TCP_PORT);
+static bool tcpListening = false;
+static WiFiClient tcpClient;
+
+// link the current frame is coming from (replies go back on it)
+static Stream* activeLink = nullptr;
+
+static void tileDone(void* ctx, int x, int y) {
+  display->markDirty(x, y, STREAM_TILE, STREAM_TILE);
+}
+
+static void frameDone(void* ctx, uint8_t seq, bool ok) {
+  if (!activeLink) return;
+  if (ok) {
+    uint8_t ack[2] = { 'A', seq };
+    activeLink->write(ack, 2);
+  } else {
+    activeLink->write('K');
+  }
+}
+
+/**
+ * @brief waiting screen, replaced by the first frame
+ */
+static void drawWaiting() {
+  display->fillScreen(display->color565(0, 0, 0));
+  display->setTextSize(1);
+  display->setTextWrap(false);
+  display->setTextColor(display->color565(255, 255, 0));
+  display->setCursor(2, 20);
+  display->print("STREAM");
+  display->setTextColor(display->color565(128, 128, 128));
+  display->setCursor(2, 34);
+  display->print(WiFi.status() == WL_CONNECTED ? "usb / tcp" : "usb");
+}
+
+/**
+ * @brief start listening for frames
+ *
+ * @param disp canvas the frames are decoded onto
+ */
+void initRemoteDisplay(VirtualCanvas* disp) {
+  display = disp;
+  frameStreamInit(&decoder, display->getBuffer(), display->width(), display->height(), CANVAS_WIDTH);
+  decoder.tileDone = tileDone;
+  decoder.frameDone = frameDone;
+  activeLink = nullptr;
+
+  // the receive buffer has to be sized before the port is opened (main.cpp opened it for the boot markers, so close it
+  // first). a whole keyframe fits, so a busy pass of loop() cannot lose bytes
+  if (!serialStarted) {
+    Serial.end();
+    Serial.setRxBufferSize(REMOTE_RX_BUFFER);
+    Serial.begin(REMOTE_BAUD);
+    serialStarted = true;
+  }
+  while (Serial.available()) Serial.read();     // stale bytes from before
+
+  drawWaiting();
+}
+
+/**
+ * @brief switch decoding to this link if it is not already the active one
+ */
+static void useLink(Stream* from) {
+  if (activeLink == from) return;
+  frameStreamReset(&decoder);
+  activeLink = from;
+}
+
+/**
+ * @brief decode whatever arrived since the last pass
+ *
+ * @param now millis() (unused, frames are shown as soon as they arrive)
+ */
+void updateRemoteDisplay(unsigned long now) {
+  // tcp only exists while Wi-Fi is up
+  if (!tcpListening && WiFi.status() == WL_CONNECTED) {
+    tcpServer.begin();
+    tcpListening = true;
+  }
+  if (tcpListening && !tcpClient.connected()) {
+    WiFiClient client = tcpServer.available();
+    if (client) {
+      tcpClient = client;
+      tcpClient.setNoDelay(true);                 // acks go out immediately
+    }
+  }
+
+  unsigned long start = micros();
+  while (micros() - start < REMOTE_BUDGET_US) {
+    int n = Serial.available();
+    if (n > 0) {
+      useLink(&Serial);
+      n = Serial.read(rx, min(n, REMOTE_CHUNK));
+      frameStreamFeed(&decoder, rx, n);
+      continue;
+    }
+
+    n = tcpClient.connected() ? tcpClient.available() : 0;
+    if (n > 0) {
+      useLink(&tcpClient);
+      n = tcpClient.read(rx, min(n, REMOTE_CHUNK));
+      if (n > 0) frameStreamFeed(&decoder, rx, n);
+      continue;
+    }
+    break;
+  }
+}
+
+/**
+ * @brief stop streaming (the serial port stays open for next time)
+ */
+void exitRemoteDisplay() {
+  if (tcpClient.connected()) tcpClient.stop();
+  activeLink = nullptr;
+}
@@ -14,22 +14,34 @@
  * Currently Programmed: 
  * - EtchASketch: draw in colors using rotary dials like the original EtchASketch
  * - Pixel Art: displays slideshow of pixel art images
+ * - Pong: two player Pong using the controllers
+ * - Chess: play white against the engine
+ * - Stream: shows frames streamed from a computer over USB serial or TCP
+ * - Screensaver: cellular automata on the home screen after a minute without input
  * 
  * Further iterations will improve the modularity to more easily extend the system to whatever we want to display.
  * 
  */
 
 #include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "Display/VirtualCanvas.h"
 #include "PixelArt/PixelArt.h"
 #include "EtchASketch/ColorSelectScreen.h"
 #include "EtchASketch/EtchASketch.h"
-
-///////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// ------------------------------------------ Panel Configuration ------------------------------------------ //
-///////////////////////////////////////////////////////////////////////////////////////////////////////////////
-#define PANEL_WIDTH 64
-#define PANEL_HEIGHT 64
-#define PANELS_NUMBER 1
+#include "EtchASketch/SketchReplay.h"
+#include "Pong/Pong.h"
+#include "Chess/Chess.h"
+#include "Automata/Screensaver.h"
+#include "Effects/Transition.h"
+#include "Effects/HomeEffects.h"
+#include "Assets/AssetStore.h"
+#include "Assets/LittleFSSource.h"
+#include "Assets/LittleFSSink.h"
+#include "Net/WebService.h"
+#include "Remote/RemoteDisplay.h"
+#include "Link/SerialLinkPort.h"
+#include "Link/InputContext.h"
+#include "Boot/BootStages.h"
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // ------------------------------------------ UART Configuration ------------------------------------------ //
@@ -40,13 +52,28 @@
 // IMPORTANT: using serial communication channel 2 on ESP32. This is easiest to use with the HUB75E interface
 HardwareSerial mySerial(2);
 
+// starts at 115200, then steps up to the fastest rate the Arduino keeps up with (see Link/BaudLink.h)
+SerialLinkPort arduinoPort(mySerial);
+BaudLink arduinoLink;
+
+// a whole command line at 1 Mbaud takes ~0.2 ms, leave room for a slow frame
+#define ARDUINO_RX_BUFFER 1024
+
+// what the Arduino scans, follows the screen (see Link/InputContext.h)
+InputContext arduinoContext;
+unsigned long contextSentAt = 0;
+bool contextSent = false;
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // ------------------------------------------ Global Variables ------------------------------------------ //
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// matrix object
+// matrix object (physical chain of panels)
 MatrixPanel_I2S_DMA* dma_display = nullptr;
 
+// logical drawing surface. every program draws here, damaged tiles are pushed to dma_display at the end of loop()
+VirtualCanvas* canvas = nullptr;
+
 
 // colors similar to example code in ESP32 HUB75... library examples. These are later defined for modular usage
 uint16_t myBLACK;
@@ -60,13 +87,141 @@ bool inEtchMode = false;
 uint16_t selectedColor;
 
 // currently supported menu items
-const char* menuItems[] = { "Sketch", "Images" };
-const int numMenuItems = 2;
+const char* menuItems[] = { "Sketch", "Images", "Pong", "Chess", "Stream" };
+const int numMenuItems = 5;
 int selectedIndex = 0;
 
-// supported pages
-enum ScreenState { HOME, COLOR_SELECT, EtchASketch, LOGO_DISPLAY };
-ScreenState currentScreen = HOME;
+// supported pages (SPLASH until the home screen's boot stages are done)
+enum ScreenState { SPLASH, HOME, COLOR_SELECT, EtchASketch, SKETCH_REPLAY, LOGO_DISPLAY, PONG, CHESS, REMOTE, SCREENSAVER };
+ScreenState currentScreen = SPLASH;
+
+// images / fonts / palettes on the flash filesystem (optional, the built in programs work without it)
+LittleFSSource flashAssets;
+
+// saved Sketch sessions are written through this
+LittleFSSink sketchSink;
+
+// set by the storage boot stage
+bool flashMounted = false;
+
+// staged start up (see Boot/BootStages.h for the table)
+BootSequence boot;
+
+// boot markers go out on the USB serial port, at the monitor's speed
+#define BOOT_LOG_BAUD 115200
+
+// progress bar under the title on the splash
+#define SPLASH_BAR_X 8
+#define SPLASH_BAR_Y 44
+#define SPLASH_BAR_HEIGHT 5
+
+// last command from the Arduino, for starting the screensaver
+unsigned long lastInputTime = 0;
+
+// commands the Arduino had to drop because its TX queue was full (reported by "txOverflow <count>")
+unsigned long arduinoDropped = 0;
+
+// partial command line from the Arduino (commands are short, anything longer is garbled)
+char rxLine[64];
+uint8_t rxLen = 0;
+bool rxGarbled = false;
+
+/**
+ * @brief non-blocking read of one command from the Arduino
+ *
+ * readStringUntil() blocks until the newline (or a 1 s timeout) shows up, which stalls the frame loop whenever a command
+ * is split across two passes. Instead, collect bytes as they arrive and only hand out complete lines.
+ *
+ * Lines with bytes no command contains (or too long for any) are counted by the link monitor and dropped, and the
+ * link's own messages (rate negotiation, pongs) are handled here, so only commands come out.
+ *
+ * @param cmd set to the command when a full line is available
+ * @return true if a command was read
+ */
+bool readCommand(String& cmd) {
+  while (mySerial.available()) {
+    char c = mySerial.read();
+    if (c == '\n') {
+      rxLine[rxLen] = '\0';
+      bool garbled = rxGarbled;
+      rxLen = 0;
+      rxGarbled = false;
+
+      if (garbled) {
+        baudLinkError(&arduinoLink, millis());
+        continue;
+      }
+      if (baudLinkLine(&arduinoLink, rxLine, millis())) {
+        continue;
+      }
+      cmd = rxLine;
+      cmd.trim();
+      return true;
+    }
+    if (c == '\r') {
+      continue;
+    }
+    if (c < 0x20 || c > 0x7E || rxLen == sizeof(rxLine) - 1) {
+      rxGarbled = true;
+    } else {
+      rxLine[rxLen++] = c;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief inputs a screen reads
+ *
+ * programs with an input profile get exactly what their (possibly remapped) bindings use, plus home to leave.
+ * The drawing programs take RPG turns as deltas: they only redraw once per frame, so one line per spin is enough.
+ *
+ * @param screen
+ * @return context for the Arduino
+ */
+InputContext screenContext(ScreenState screen) {
+  switch (screen) {
+    case EtchASketch:
+      return { (uint16_t)(CTX_HOME | inputContextFromCodes(inputProfileInputs(etchInputProfile()))),
+               CONTEXT_RPG_DELTA_MS, CONTEXT_JOYSTICK_MS };
+    case CHESS:
+      return { (uint16_t)(CTX_HOME | inputContextFromCodes(inputProfileInputs(chessInputProfile()))),
+               CONTEXT_RPG_DELTA_MS, CONTEXT_JOYSTICK_MS };
+    case PONG:
+      return { CTX_HOME | CTX_C1A | CTX_C2A | CTX_RPGS | CTX_JOYSTICKS, CONTEXT_RPG_DELTA_MS, CONTEXT_JOYSTICK_MS };
+    case REMOTE:
+      return { CTX_HOME, 0, 0 };
+    case SCREENSAVER:
+      return { CTX_BUTTONS | CTX_RPGS, 0, 0 };      // anything wakes it
+    case SPLASH:
+      return { 0, 0, 0 };                           // nothing to do yet (the power button is always watched)
+    case COLOR_SELECT:
+      return { CTX_ARROWS | CTX_HOME | CTX_C1A, 0, 0 };  // 1A opens the saved sketches
+    default:
+      return { CTX_ARROWS | CTX_HOME, 0, 0 };       // menus: home screen, color select, images
+  }
+}
+
+/**
+ * @brief tell the Arduino what to scan when the screen changed, and repeat it now and then
+ *
+ * replaces "enableController" / "disableController" on entering / leaving Pong and Chess: the Arduino now also leaves
+ * unused buttons and RPGs alone (and its ADC off), and a lost line is corrected by the next refresh
+ */
+void updateInputContext() {
+  InputContext ctx = screenContext(currentScreen);
+  bool changed = !contextSent || !inputContextSame(&ctx, &arduinoContext);
+  if (!changed && millis() - contextSentAt < CONTEXT_REFRESH_MS) {
+    return;
+  }
+
+  char line[32];
+  inputContextFormat(&ctx, line, sizeof(line));
+  arduinoPort.sendLine(line);
+  arduinoContext = ctx;
+  contextSentAt = millis();
+  contextSent = true;
+}
 
 /**
  * @brief draws arrow for menu selection
@@ -74,10 +229,10 @@ ScreenState currentScreen = HOME;
  * @param y column location to start the arrow
  */
 void drawArrow(int y) {
-  dma_display->fillRect(0, y, 6, 8, myBLACK); 
-  dma_display->setCursor(0, y);
-  dma_display->setTextColor(green);  
-  dma_display->print(">");
+  canvas->fillRect(0, y, 6, 8, myBLACK); 
+  canvas->setCursor(0, y);
+  canvas->setTextColor(green);  
+  canvas->print(">");
 }
 
 /**
@@ -87,26 +242,26 @@ void drawArrow(int y) {
  * 
  */
 void drawHomeScreen() {
-  dma_display->fillScreen(myBLACK);
-  dma_display->setTextSize(1);
-  dma_display->setTextWrap(false);
+  canvas->fillScreen(myBLACK);
+  canvas->setTextSize(1);
+  canvas->setTextWrap(false);
   
 
   // Navbar: 'Home'
   const char* line1 = "HOME";
   int len1 = strlen(line1);
   int charWidth = 6;
-  int startX1 = (dma_display->width() - len1 * charWidth) / 2;
-  dma_display->setCursor(startX1, 0);
+  int startX1 = (canvas->width() - len1 * charWidth) / 2;
+  canvas->setCursor(startX1, 0);
 
   // alternating styling of home text
   for (int i = 0; i < len1; i++) {
-    dma_display->setTextColor((i % 2 == 0) ? yellow : white);
-    dma_display->print(line1[i]);
+    canvas->setTextColor((i % 2 == 0) ? yellow : white);
+    canvas->print(line1[i]);
   }
 
   // navbar border
-  dma_display->drawLine(0, 8, PANEL_WIDTH, 8, white);
+  canvas->drawLine(0, 8, canvas->width(), 8, white);
 
   // options menu
   int startY = 10;
@@ -115,62 +270,90 @@ void drawHomeScreen() {
     int len = strlen(label);
     int charWidth = 6;
     int textWidth = len * charWidth;
-    int startX = (dma_display->width() - textWidth) / 2;
+    int startX = (canvas->width() - textWidth) / 2;
 
     // draw arrows with some padding. this is how we are depicting the item to be selected with the next click of 'Home'
     if (i == selectedIndex) {
-        dma_display->fillRect(startX - 8, startY, 6, 8, myBLACK); // left arrow
-        dma_display->setCursor(startX - 8, startY);
-        dma_display->setTextColor(green);
-        dma_display->print(">");
-
-        dma_display->fillRect(startX + textWidth + 2, startY, 6, 8, myBLACK); // right arrow 
-        dma_display->setCursor(startX + textWidth + 2, startY);
-        dma_display->setTextColor(green);
-        dma_display->print("<");
+        canvas->fillRect(startX - 8, startY, 6, 8, myBLACK); // left arrow
+        canvas->setCursor(startX - 8, startY);
+        canvas->setTextColor(green);
+        canvas->print(">");
+
+        canvas->fillRect(startX + textWidth + 2, startY, 6, 8, myBLACK); // right arrow 
+        canvas->setCursor(startX + textWidth + 2, startY);
+        canvas->setTextColor(green);
+        canvas->print("<");
     }
 
     // draw the code with styling:
     // "Sketch" is rainbow
     // "Image" is yellow
-    dma_display->setCursor(startX, startY);
+    canvas->setCursor(startX, startY);
     for (int j = 0; j < len; j++) {
         uint16_t color;
         if (strcmp(label, "Sketch") == 0) {
             uint16_t rainbowColors[] = {
-                dma_display->color565(255, 0, 0),     // red
-                dma_display->color565(255, 165, 0),   // orange
-                dma_display->color565(255, 255, 0),   // yellow
-                dma_display->color565(0, 255, 0),     // green
-                dma_display->color565(0, 0, 255),     // blue
-                dma_display->color565(75, 0, 130),    // indigo
-                dma_display->color565(148, 0, 211)    // violet
+                canvas->color565(255, 0, 0),     // red
+                canvas->color565(255, 165, 0),   // orange
+                canvas->color565(255, 255, 0),   // yellow
+                canvas->color565(0, 255, 0),     // green
+                canvas->color565(0, 0, 255),     // blue
+                canvas->color565(75, 0, 130),    // indigo
+                canvas->color565(148, 0, 211)    // violet
             };
             color = rainbowColors[j % 7];
         } 
         else {
             color = yellow;
         }
-        dma_display->setTextColor(color);
-        dma_display->print(label[j]);
+        canvas->setTextColor(color);
+        canvas->print(label[j]);
     }
     startY += 10;
   }
+
+  // fire + sparks around the menu, plasma on the navbar border
+  homeEffectsReset(canvas, 8, millis());
 }
 
 /**
- * @brief initialize the ESP32 system
- * 
- * Configure:
- * - uart
- * - led matrix
- * - display the home screen
- * 
+ * @brief start up splash: the title and an empty progress bar (filled in by drawBootProgress())
  */
-void setup() {
-  mySerial.begin(115200);
+void drawSplash() {
+  canvas->fillScreen(myBLACK);
+  canvas->setTextSize(1);
+  canvas->setTextWrap(false);
 
-  
+  // same alternating styling as the home navbar
+  const char* lines[] = { "ETCH A", "SKETCH" };
+  for (int l = 0; l < 2; l++) {
+    int len = strlen(lines[l]);
+    canvas->setCursor((canvas->width() - len * 6) / 2, 18 + l * 10);
+    for (int i = 0; i < len; i++) {
+      canvas->setTextColor((i % 2 == 0) ? yellow : white);
+      canvas->print(lines[l][i]);
+    }
+  }
+
+  canvas->drawRect(SPLASH_BAR_X, SPLASH_BAR_Y, canvas->width() - 2 * SPLASH_BAR_X, SPLASH_BAR_HEIGHT, white);
+}
+
+/**
+ * @brief fill the splash progress bar up to the boot stages done so far
+ */
+void drawBootProgress() {
+  int inner = canvas->width() - 2 * SPLASH_BAR_X - 2;
+  int filled = inner * bootDoneCount(&boot) / BOOT_STAGE_COUNT;
+  canvas->fillRect(SPLASH_BAR_X + 1, SPLASH_BAR_Y + 1, filled, SPLASH_BAR_HEIGHT - 2, green);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ------------------------------------------- Boot Stages ------------------------------------------- //
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief matrix, canvas and the splash. the only stage setup() waits for
+ */
+bool bootDisplay() {
   // VERY IMPORTANT: matrix configuration
   //
   //             +----------+-----------+
@@ -212,6 +395,11 @@ void setup() {
   mxconfig.driver = HUB75_I2S_CFG::ICN2038S;
   mxconfig.clkphase = false;
 
+  // every extra panel multiplies the bits shifted out per refresh, so clock the chain faster to hold the refresh rate
+  if (PANELS_NUMBER > 1) {
+    mxconfig.i2sspeed = HUB75_I2S_CFG::HZ_20M;
+  }
+
   //Check if matrix was correctly initialized
   dma_display = new MatrixPanel_I2S_DMA(mxconfig);
   if (!dma_display->begin()) {
@@ -219,6 +407,13 @@ void setup() {
     while (true);
   }
 
+  //Logical canvas on top of the chain. allocated after begin() so the DMA buffers are placed first
+  canvas = new VirtualCanvas(dma_display, PANEL_CHAIN_LAYOUT, PANEL_ROTATION);
+  if (!canvas->begin()) {
+    mySerial.println("Canvas alloc failed!");
+    while (true);
+  }
+
   //Set matrix brightness and common colors
   dma_display->setBrightness8(90);
   myBLACK = dma_display->color565(0, 0, 0);
@@ -227,107 +422,400 @@ void setup() {
   brown   = dma_display->color565(139, 69, 19);
   green   = dma_display->color565(0, 255, 0);
 
-  //Initialize color selector by passing dma_display object
-  //Draw the home screen
-  initColorSelector(dma_display);
+  drawSplash();
+  canvas->flush();
+  return true;
+}
+
+/**
+ * @brief screen transitions need two canvas snapshots. without the memory, screens just switch instantly
+ */
+bool bootTransitions() {
+  if (!transitionInit()) {
+    Serial.println("Transitions disabled (no memory)");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief mount the flash filesystem (optional, the built in programs work without it)
+ */
+bool bootStorage() {
+  flashMounted = flashAssets.begin();
+  return flashMounted;
+}
+
+/**
+ * @brief remapped controls from /input.cfg (the built in bindings stay if there is none)
+ */
+bool bootInputConfig() {
+  InputProfile* inputProfiles[] = { etchInputProfile(), chessInputProfile() };
+  inputLoadConfig(&flashAssets, INPUT_CONFIG_PATH, inputProfiles, 2);
+  return true;
+}
+
+/**
+ * @brief initialize color selector by passing the canvas object
+ */
+bool bootColors() {
+  initColorSelector(canvas);
+  return true;
+}
+
+/**
+ * @brief replace the splash with the home screen, input is handled from here on
+ */
+bool bootHome() {
+  currentScreen = HOME;
+  lastInputTime = millis();
   drawHomeScreen();
+  return true;
 }
 
-/*
-* @brief Main loop for ESP32 and Matrix communication
-* Reads serial commands from the arduino 
-* Uses specific functionality with commands and the window that is open to do tasks
-*/
-void loop() {
-  //Check if serial is open and read serial commands from arduino
-  if (mySerial.available()) {
-    String cmd = mySerial.readStringUntil('\n');
-    cmd.trim();
-
-    /////////////////////////////////////////
-    // ----------- HOME SCREEN ----------- //     
-    /////////////////////////////////////////
-    if (currentScreen == HOME) {
-      if (cmd == "btnUpArrow") {
-        selectedIndex--;
-        if (selectedIndex < 0) selectedIndex = numMenuItems - 1;
-        drawHomeScreen();
-      }
-      else if (cmd == "btnDownArrow") {
-        selectedIndex++;
-        if (selectedIndex >= numMenuItems) selectedIndex = 0;
-        drawHomeScreen();
-      }
-      else if (cmd == "btnHomeClick") {
-        if (strcmp(menuItems[selectedIndex], "Sketch") == 0) {
-          currentScreen = COLOR_SELECT;
-          drawColorSelector(colorValues);
-        }
-        else if (strcmp(menuItems[selectedIndex], "Images") == 0) {
-          currentScreen = LOGO_DISPLAY;
-          drawCurrentImage(dma_display);
-        }
-      }
+/**
+ * @brief flash asset index. only the index is read here, assets load on first use. flash slides show up in the
+ *        slideshow once this has run, and saved sketches are recorded from then on
+ */
+bool bootAssets() {
+  if (!flashMounted || !assetsBegin(&flashAssets)) {
+    Serial.println("No flash assets");
+    return false;
+  }
+  etchSetStorage(&flashAssets, &sketchSink);
+  return true;
+}
+
+/**
+ * @brief uploads / canvas downloads over Wi-Fi (only if credentials were built in). connects in the background
+ */
+bool bootWeb() {
+  if (!webServiceBegin(canvas)) {
+    Serial.println("Web service off");
+    return false;
+  }
+  return true;
+}
+
+uint32_t bootClock() {
+  return micros();
+}
+
+/**
+ * @brief run the next boot stage and print its marker, plus "boot done" after the last one
+ */
+void runBootStage() {
+  int stage = bootStep(&boot);
+  if (stage < 0) {
+    return;
+  }
+
+  char marker[BOOT_MARKER_LEN];
+  bootMarker(&boot, stage, marker, sizeof(marker));
+  Serial.println(marker);
+
+  if (currentScreen == SPLASH) {
+    drawBootProgress();
+  }
+  if (bootFinished(&boot)) {
+    Serial.printf("boot done %lu ms\n", (unsigned long)(micros() / 1000));
+  }
+}
+
+/**
+ * @brief initialize the ESP32 system
+ * 
+ * Only the first boot stage runs here:
+ * - uart
+ * - led matrix
+ * - the splash screen
+ * 
+ * loop() runs the other stages one per pass (see bootStages), and shows the home screen as soon as it can be used.
+ * 
+ */
+void setup() {
+  // boot markers for the serial monitor
+  Serial.begin(BOOT_LOG_BAUD);
+
+  mySerial.setRxBufferSize(ARDUINO_RX_BUFFER);
+  mySerial.begin(BAUD_DEFAULT);
+
+  if (!bootBegin(&boot, bootStages, BOOT_STAGE_COUNT, bootClock)) {
+    Serial.println("boot stages can never all run");
+  }
+  runBootStage();
+
+  //Ask the Arduino for a faster UART (negotiated in the background by loop(), while the other stages run)
+  baudLinkBegin(&arduinoLink, &arduinoPort, millis());
+}
+
+/**
+ * @brief Uses specific functionality with commands and the window that is open to do tasks
+ *
+ * @param cmd command from the arduino
+ */
+void handleCommand(const String& cmd) {
+  // not an input: inputs were lost on the Arduino side, just keep count
+  if (cmd.startsWith("txOverflow")) {
+    arduinoDropped += cmd.substring(10).toInt();
+    return;
+  }
+
+  // the RPG was turned while the screen takes deltas: programs still get one command per tick
+  uint8_t rpg;
+  int ticks;
+  if (rpgDeltaParse(cmd.c_str(), &rpg, &ticks)) {
+    String tick = (rpg == 1) ? (ticks > 0 ? "rpg1CW" : "rpg1CCW") : (ticks > 0 ? "rpg2CW" : "rpg2CCW");
+    for (int i = abs(ticks); i > 0; i--) {
+      handleCommand(tick);
     }
+    return;
+  }
 
-    /////////////////////////////////////////
-    // ----------- COLOR SELECT ---------- //     this is part of etchasketch program... user can select the color here before entering the program
-    /////////////////////////////////////////
-    else if (currentScreen == COLOR_SELECT) {
-      if (cmd == "btnUpArrow") {
-        prevColor();
-      } 
-      else if (cmd == "btnDownArrow") {
-        nextColor();
-      } 
-      else if (cmd == "btnHomeClick") {
-        selectedColor = getCurrentColor();
-        currentScreen = EtchASketch;
-        inEtchMode = true;
-        initEtchASketch(dma_display, selectedColor);
-      } 
-      else if (cmd == "btnHomeHold") {
-        currentScreen = HOME;
-        drawHomeScreen();
-      }
+  // still starting up, there is nothing to operate yet
+  if (currentScreen == SPLASH) {
+    return;
+  }
+
+  lastInputTime = millis();
+
+  // input always lands on the finished screen
+  transitionFinish();
+
+  // any input wakes the screensaver back up to the home screen (and is not passed on)
+  if (currentScreen == SCREENSAVER) {
+    currentScreen = HOME;
+    drawHomeScreen();
+    return;
+  }
+
+  /////////////////////////////////////////
+  // ----------- HOME SCREEN ----------- //     
+  /////////////////////////////////////////
+  if (currentScreen == HOME) {
+    if (cmd == "btnUpArrow") {
+      selectedIndex--;
+      if (selectedIndex < 0) selectedIndex = numMenuItems - 1;
+      drawHomeScreen();
     }
-    
-    /////////////////////////////////////////
-    // ----------- ETCHASKETCH ----------- //
-    /////////////////////////////////////////
-    else if (currentScreen == EtchASketch) {
-      if (cmd == "btnHomeHold") {
-        currentScreen = HOME;
-        inEtchMode = false;
-        drawHomeScreen();
-      } else if (cmd == "btnUpArrow") {
-        handleEtchCommand(cmd);
-      } else if (cmd == "btnDownArrow") {
-        handleEtchCommand(cmd);
-      } else {
-        handleEtchCommand(cmd);
-      }
+    else if (cmd == "btnDownArrow") {
+      selectedIndex++;
+      if (selectedIndex >= numMenuItems) selectedIndex = 0;
+      drawHomeScreen();
     }
-    
-    /////////////////////////////////////////
-    // ------------ PIXEL ART ------------ //
-    /////////////////////////////////////////
-    else if (currentScreen == LOGO_DISPLAY) {
-      if (cmd == "btnHomeHold") {
-        currentScreen = HOME;
-        drawHomeScreen();
+    else if (cmd == "btnHomeClick") {
+      if (strcmp(menuItems[selectedIndex], "Sketch") == 0) {
+        transitionCapture(canvas);
+        currentScreen = COLOR_SELECT;
+        drawColorSelector(colorValues);
+        transitionStart(canvas, TRANSITION_SLIDE, millis());
+      }
+      else if (strcmp(menuItems[selectedIndex], "Images") == 0) {
+        transitionCapture(canvas);
+        currentScreen = LOGO_DISPLAY;
+        drawCurrentImage(canvas);
+        transitionStart(canvas, TRANSITION_DISSOLVE, millis());
       }
-      else if (cmd == "btnUpArrow") {
-        prevImage();
-        drawCurrentImage(dma_display);
+      else if (strcmp(menuItems[selectedIndex], "Pong") == 0) {
+        currentScreen = PONG;
+        initPong(canvas);
       }
-      else if (cmd == "btnDownArrow") {
-        nextImage();
-        drawCurrentImage(dma_display);
+      else if (strcmp(menuItems[selectedIndex], "Chess") == 0) {
+        currentScreen = CHESS;
+        initChess(canvas);
       }
-      else if (cmd == "btnHomeClick") {
-        drawCurrentImage(dma_display);
+      else if (strcmp(menuItems[selectedIndex], "Stream") == 0) {
+        currentScreen = REMOTE;
+        initRemoteDisplay(canvas);
       }
     }
   }
+
+  /////////////////////////////////////////
+  // ----------- COLOR SELECT ---------- //     this is part of etchasketch program... user can select the color here before entering the program
+  /////////////////////////////////////////
+  else if (currentScreen == COLOR_SELECT) {
+    if (cmd == "btnUpArrow") {
+      prevColor();
+    } 
+    else if (cmd == "btnDownArrow") {
+      nextColor();
+    } 
+    else if (cmd == "btnHomeClick") {
+      selectedColor = getCurrentColor();
+      transitionCapture(canvas);
+      currentScreen = EtchASketch;
+      inEtchMode = true;
+      initEtchASketch(canvas, selectedColor);
+      transitionStart(canvas, TRANSITION_WIPE, millis());
+    } 
+    else if (cmd == "btnHomeHold") {
+      transitionCapture(canvas);
+      currentScreen = HOME;
+      drawHomeScreen();
+      transitionStart(canvas, TRANSITION_WIPE, millis());
+    }
+    else if (cmd == "controller1A") {
+      transitionCapture(canvas);
+      currentScreen = SKETCH_REPLAY;
+      initSketchReplay(canvas, &flashAssets);
+      transitionStart(canvas, TRANSITION_SLIDE, millis());
+    }
+  }
+
+  /////////////////////////////////////////
+  // ---------- SAVED SKETCHES --------- //     also part of the sketch program, reached from color select
+  /////////////////////////////////////////
+  else if (currentScreen == SKETCH_REPLAY) {
+    if (cmd == "btnHomeHold") {
+      transitionCapture(canvas);
+      exitSketchReplay();
+      currentScreen = COLOR_SELECT;
+      drawColorSelector(colorValues);
+      transitionStart(canvas, TRANSITION_WIPE, millis());
+    }
+    else {
+      handleReplayCommand(cmd, millis());
+    }
+  }
+  
+  /////////////////////////////////////////
+  // ----------- ETCHASKETCH ----------- //
+  /////////////////////////////////////////
+  else if (currentScreen == EtchASketch) {
+    if (cmd == "btnHomeHold") {
+      transitionCapture(canvas);
+      exitEtchASketch();
+      currentScreen = HOME;
+      inEtchMode = false;
+      drawHomeScreen();
+      transitionStart(canvas, TRANSITION_WIPE, millis());
+    } else {
+      handleEtchCommand(cmd, millis());
+    }
+  }
+  
+  /////////////////////////////////////////
+  // ------------ PIXEL ART ------------ //
+  /////////////////////////////////////////
+  else if (currentScreen == LOGO_DISPLAY) {
+    if (cmd == "btnHomeHold") {
+      transitionCapture(canvas);
+      currentScreen = HOME;
+      drawHomeScreen();
+      transitionStart(canvas, TRANSITION_WIPE, millis());
+    }
+    else if (cmd == "btnUpArrow") {
+      prevImage();
+      drawCurrentImage(canvas);
+    }
+    else if (cmd == "btnDownArrow") {
+      nextImage();
+      drawCurrentImage(canvas);
+    }
+    else if (cmd == "btnHomeClick") {
+      toggleSlideshowAuto();
+    }
+  }
+
+  /////////////////////////////////////////
+  // --------------- PONG -------------- //
+  /////////////////////////////////////////
+  else if (currentScreen == PONG) {
+    if (cmd == "btnHomeHold") {
+      exitPong();
+      currentScreen = HOME;
+      drawHomeScreen();
+    }
+    else {
+      handlePongCommand(cmd, millis());
+    }
+  }
+
+  /////////////////////////////////////////
+  // -------------- CHESS -------------- //
+  /////////////////////////////////////////
+  else if (currentScreen == CHESS) {
+    if (cmd == "btnHomeHold") {
+      exitChess();
+      currentScreen = HOME;
+      drawHomeScreen();
+    }
+    else {
+      handleChessCommand(cmd, millis());
+    }
+  }
+
+  /////////////////////////////////////////
+  // ------------- STREAM -------------- //
+  /////////////////////////////////////////
+  else if (currentScreen == REMOTE) {
+    if (cmd == "btnHomeHold") {
+      exitRemoteDisplay();
+      currentScreen = HOME;
+      drawHomeScreen();
+    }
+  }
+}
+
+/*
+* @brief Main loop for ESP32 and Matrix communication
+* Reads serial commands from the arduino 
+* Drains every complete command first, then lets the active screen animate, then pushes the frame
+*/
+void loop() {
+  //Read all serial commands from arduino that have arrived
+  String cmd;
+  while (readCommand(cmd)) {
+    handleCommand(cmd);
+  }
+
+  // one start up stage per pass until everything is up, so the link and the panel keep going in between
+  if (!bootFinished(&boot)) {
+    runBootStage();
+  }
+
+  // screens that animate on their own (a running transition owns the canvas until it is done)
+  if (transitionActive()) {
+    transitionUpdate(millis());
+  }
+  else if (currentScreen == EtchASketch) {
+    updateEtchASketch(millis());
+  }
+  else if (currentScreen == SKETCH_REPLAY) {
+    updateSketchReplay(millis());
+  }
+  else if (currentScreen == PONG) {
+    updatePong(millis());
+  }
+  else if (currentScreen == CHESS) {
+    updateChess(millis());
+  }
+  else if (currentScreen == REMOTE) {
+    updateRemoteDisplay(millis());
+  }
+  else if (currentScreen == LOGO_DISPLAY) {
+    updateCurrentImage(canvas, millis());
+  }
+  else if (currentScreen == SCREENSAVER) {
+    updateScreensaver(millis());
+  }
+  else if (currentScreen == HOME && millis() - lastInputTime >= SCREENSAVER_IDLE_MS) {
+    currentScreen = SCREENSAVER;
+    initScreensaver(canvas, millis());
+  }
+  else if (currentScreen == HOME) {
+    homeEffectsUpdate(millis());
+  }
+
+  // rate negotiation / link monitoring with the Arduino, and what it should scan for the screen now showing
+  baudLinkPoll(&arduinoLink, millis());
+  updateInputContext();
+
+  // one slice of background asset loading, then register anything uploaded over Wi-Fi
+  assetsPoll();
+  webServicePoll();
+
+  // push whatever the screens drew this pass out to the panels
+  canvas->flush();
 }
\ No newline at end of file
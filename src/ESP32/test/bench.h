@@ -0,0 +1,35 @@
+/**
+ * @file bench.h
+ * @brief timing helper shared by the benchmark tests
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Host numbers only show relative cost (kernel vs reference, one size vs another), the ESP32 is a lot slower. They are
+ * printed, never checked, so a busy machine can't fail a run.
+ *
+ */
+
+#ifndef TEST_BENCH_H
+#define TEST_BENCH_H
+
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+
+static inline double benchSeconds() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// "name: 12.3 Munit/s" (or k / plain for slower things)
+static inline void benchReport(const char* name, double count, const char* unit, double seconds) {
+  char line[128];
+  double rate = seconds > 0 ? count / seconds : 0;
+  if (rate >= 1e6) snprintf(line, sizeof(line), "%s: %.1f M%s/s", name, rate / 1e6, unit);
+  else if (rate >= 1e3) snprintf(line, sizeof(line), "%s: %.1f k%s/s", name, rate / 1e3, unit);
+  else snprintf(line, sizeof(line), "%s: %.1f %s/s", name, rate, unit);
+  TEST_MESSAGE(line);
+}
+
+#endif
@@ -0,0 +1,336 @@
+/**
+ * @file test_animation.cpp
+ * @brief delta frame animation decoder: round trips, the shipped animations against their source art, corrupt data
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * encodeAnim() below writes the format of include/PixelArt/Animation.h the way tools/anim_encode.py does (keyframe,
+ * then the changed area of every frame as literal / run / skip ops), so random animations can be round tripped through
+ * animDecodeFrame(). The animations that ship (PacmanAnim.h and data/img/heart.anim) are decoded and compared pixel by
+ * pixel with the character art in assets/ they were built from, which catches a header that went stale.
+ *
+ * Reads assets/ and data/ relative to the project directory, where "pio test" runs the suites.
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "PixelArt/Animation.h"
+#include "PixelArt/PacmanAnim.h"
+#include "../bench.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+static void putU16(Bytes& out, uint16_t v) {
+  out.push_back(v & 0xFF);
+  out.push_back(v >> 8);
+}
+
+// pixels: palette indices, -1 = unchanged
+static void encodeOps(Bytes& out, const std::vector<int>& pixels) {
+  size_t i = 0, n = pixels.size();
+  Bytes literal;
+  auto flush = [&]() {
+    for (size_t k = 0; k < literal.size(); k += 128) {
+      size_t len = std::min((size_t)128, literal.size() - k);
+      out.push_back(len - 1);
+      out.insert(out.end(), literal.begin() + k, literal.begin() + k + len);
+    }
+    literal.clear();
+  };
+  while (i < n) {
+    size_t j = i;
+    if (pixels[i] < 0) {
+      flush();
+      while (j < n && pixels[j] < 0 && j - i < 64) j++;
+      out.push_back(0xC0 | (j - i - 1));
+    }
+    else {
+      while (j < n && pixels[j] == pixels[i] && j - i < 64) j++;
+      if (j - i >= 3) {
+        flush();
+        out.push_back(0x80 | (j - i - 1));
+        out.push_back(pixels[i]);
+      }
+      else {
+        literal.push_back(pixels[i]);
+        j = i + 1;
+      }
+    }
+    i = j;
+  }
+  flush();
+}
+
+// frames of palette indices, one rect per frame around everything that changed
+static Bytes encodeAnim(int w, int h, const std::vector<uint16_t>& palette, const std::vector<std::vector<uint8_t>>& frames) {
+  Bytes out = { 'A', 'N', ANIM_VERSION, (uint8_t)w, (uint8_t)h, (uint8_t)(palette.size() & 0xFF) };
+  putU16(out, frames.size());
+  for (uint16_t c : palette) putU16(out, c);
+
+  for (size_t f = 0; f < frames.size(); f++) {
+    int x0 = 0, y0 = 0, x1 = w - 1, y1 = h - 1;
+    if (f > 0) {
+      x0 = w, y0 = h, x1 = -1, y1 = -1;
+      for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+          if (frames[f][y * w + x] == frames[f - 1][y * w + x]) continue;
+          x0 = std::min(x0, x), x1 = std::max(x1, x), y0 = std::min(y0, y), y1 = std::max(y1, y);
+        }
+      }
+    }
+    Bytes body;
+    putU16(body, 10 + f);
+    body.push_back(x1 >= 0 ? 1 : 0);
+    if (x1 >= 0) {
+      Bytes rect = { (uint8_t)x0, (uint8_t)y0, (uint8_t)(x1 - x0 + 1), (uint8_t)(y1 - y0 + 1) };
+      body.insert(body.end(), rect.begin(), rect.end());
+      std::vector<int> pixels;
+      for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+          int v = frames[f][y * w + x];
+          pixels.push_back(f > 0 && frames[f - 1][y * w + x] == v ? -1 : v);
+        }
+      }
+      encodeOps(body, pixels);
+    }
+    putU16(out, body.size());
+    out.insert(out.end(), body.begin(), body.end());
+  }
+  return out;
+}
+
+// decode every frame at scale into a target with a guard border, checking each against the expected colors
+static void checkDecode(const Bytes& data, int w, int h, const std::vector<std::vector<uint16_t>>& expected, int scale) {
+  AnimInfo info;
+  TEST_ASSERT_TRUE(animParse(data.data(), data.size(), &info));
+  TEST_ASSERT_EQUAL_INT(w, info.width);
+  TEST_ASSERT_EQUAL_INT(expected.size(), info.frameCount);
+
+  const int stride = w * scale + 8;
+  std::vector<uint16_t> target(stride * (h * scale + 8), 0xDEAD);
+  uint16_t* origin = target.data() + 4 * stride + 4;
+  uint32_t offset = info.firstFrame;
+
+  for (size_t f = 0; f < expected.size(); f++) {
+    std::vector<uint16_t> before(target);
+    AnimDirty dirty;
+    TEST_ASSERT_EQUAL_INT32(10 + f, animDecodeFrame(data.data(), data.size(), info, &offset, origin, stride, scale, &dirty));
+    for (int y = 0; y < h * scale + 8; y++) {
+      for (int x = 0; x < stride; x++) {
+        int ix = x - 4, iy = y - 4;
+        uint16_t v = target[y * stride + x];
+        if (ix < 0 || iy < 0 || ix >= w * scale || iy >= h * scale) {
+          TEST_ASSERT_EQUAL_HEX16(0xDEAD, v);
+          continue;
+        }
+        TEST_ASSERT_EQUAL_HEX16(expected[f][(iy / scale) * w + ix / scale], v);
+        // anything that changed is inside the dirty area
+        if (v != before[y * stride + x]) {
+          TEST_ASSERT_TRUE(ix >= dirty.x && ix < dirty.x + dirty.w && iy >= dirty.y && iy < dirty.y + dirty.h);
+        }
+      }
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(data.size(), offset);
+  AnimDirty dirty;
+  TEST_ASSERT_EQUAL_INT32(-1, animDecodeFrame(data.data(), data.size(), info, &offset, origin, stride, scale, &dirty));
+}
+
+// a random animation: noise background, a few blocks moving and recoloring from frame to frame
+static void randomAnim(int w, int h, int colors, int nframes, std::vector<uint16_t>& palette,
+                       std::vector<std::vector<uint8_t>>& frames) {
+  palette.clear();
+  for (int i = 0; i < colors; i++) palette.push_back((uint16_t)next());
+  frames.assign(1, std::vector<uint8_t>(w * h));
+  for (auto& p : frames[0]) p = (next() % 4) ? 0 : next() % colors;
+  for (int f = 1; f < nframes; f++) {
+    frames.push_back(frames.back());
+    for (int b = next() % 4; b > 0; b--) {
+      int bw = 1 + next() % w, bh = 1 + next() % h, bx = next() % (w - bw + 1), by = next() % (h - bh + 1);
+      uint8_t c = next() % colors;
+      bool noisy = next() & 1;
+      for (int y = by; y < by + bh; y++)
+        for (int x = bx; x < bx + bw; x++) frames[f][y * w + x] = noisy ? next() % colors : c;
+    }
+  }
+}
+
+static std::vector<std::vector<uint16_t>> colorsOf(const std::vector<uint16_t>& palette,
+                                                   const std::vector<std::vector<uint8_t>>& frames) {
+  std::vector<std::vector<uint16_t>> out;
+  for (auto& f : frames) {
+    out.emplace_back();
+    for (uint8_t v : f) out.back().push_back(palette[v]);
+  }
+  return out;
+}
+
+static uint16_t rgb565(int r, int g, int b) {
+  return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+// the default colors of tools/anim_encode.py
+static bool artColor(char ch, uint16_t* color) {
+  static const struct { char ch; uint8_t r, g, b; } COLORS[] = {
+    { '.', 0, 0, 0 },       { 'b', 0, 0, 0 },     { 'g', 0, 255, 0 },   { 'y', 255, 255, 0 },
+    { 'w', 255, 255, 255 }, { 'r', 255, 0, 0 },   { 'l', 0, 0, 255 },   { 'o', 255, 165, 0 },
+    { 'p', 128, 0, 128 },   { 'G', 128, 128, 128 }, { 'B', 0, 0, 255 },
+  };
+  for (auto& c : COLORS) {
+    if (c.ch == ch) {
+      *color = rgb565(c.r, c.g, c.b);
+      return true;
+    }
+  }
+  return false;
+}
+
+// frames of an assets/ file as RGB565 (frame durations are not compared)
+static bool readArt(const char* path, int* w, int* h, std::vector<std::vector<uint16_t>>& frames) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  char line[512];
+  frames.clear();
+  *h = 0;
+  while (fgets(line, sizeof(line), f)) {
+    int len = strcspn(line, " \r\n");
+    if (line[0] == '#' || len == 0) continue;
+    if (!strncmp(line, "frame", 5)) {
+      frames.emplace_back();
+      continue;
+    }
+    TEST_ASSERT_FALSE_MESSAGE(!strncmp(line, "color", 5), "color lines are not handled here");
+    *w = len;
+    for (int i = 0; i < len; i++) {
+      uint16_t c;
+      TEST_ASSERT_TRUE_MESSAGE(artColor(line[i], &c), path);
+      frames.back().push_back(c);
+    }
+  }
+  fclose(f);
+  *h = frames.empty() ? 0 : frames[0].size() / *w;
+  return !frames.empty();
+}
+
+static void checkAgainstArt(const Bytes& data, const char* art) {
+  int w = 0, h = 0;
+  std::vector<std::vector<uint16_t>> frames;
+  TEST_ASSERT_TRUE_MESSAGE(readArt(art, &w, &h, frames), art);
+
+  AnimInfo info;
+  TEST_ASSERT_TRUE(animParse(data.data(), data.size(), &info));
+  TEST_ASSERT_EQUAL_INT(w, info.width);
+  TEST_ASSERT_EQUAL_INT(h, info.height);
+  TEST_ASSERT_EQUAL_INT(frames.size(), info.frameCount);
+
+  std::vector<uint16_t> image(w * h);
+  uint32_t offset = info.firstFrame;
+  for (size_t f = 0; f < frames.size(); f++) {
+    TEST_ASSERT_TRUE(animDecodeFrame(data.data(), data.size(), info, &offset, image.data(), w, 1, nullptr) >= 0);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(frames[f].data(), image.data(), w * h * 2, art);
+  }
+  TEST_ASSERT_EQUAL_UINT32(data.size(), offset);
+}
+
+void setUp() {
+  seed = 33;
+}
+
+void tearDown() {}
+
+static void test_round_trip() {
+  std::vector<uint16_t> palette;
+  std::vector<std::vector<uint8_t>> frames;
+  const int SIZES[][3] = { { 1, 1, 2 }, { 16, 16, 3 }, { 40, 23, 17 }, { 64, 64, 256 }, { 255, 3, 200 } };
+  for (auto& s : SIZES) {
+    for (int rep = 0; rep < 4; rep++) {
+      randomAnim(s[0], s[1], s[2], 12, palette, frames);
+      Bytes data = encodeAnim(s[0], s[1], palette, frames);
+      for (int scale = 1; scale <= 3; scale++) checkDecode(data, s[0], s[1], colorsOf(palette, frames), scale);
+    }
+  }
+}
+
+static void test_shipped_animations_match_their_art() {
+  checkAgainstArt(Bytes(pacman_anim, pacman_anim + sizeof(pacman_anim)), "assets/pacman.txt");
+
+  FILE* f = fopen("data/img/heart.anim", "rb");
+  TEST_ASSERT_NOT_NULL(f);
+  Bytes heart;
+  int c;
+  while ((c = fgetc(f)) != EOF) heart.push_back(c);
+  fclose(f);
+  checkAgainstArt(heart, "assets/heart.txt");
+}
+
+// truncated or damaged data stops with -1 or decodes garbage, but never writes outside the image
+static void test_corrupt_data_stays_in_bounds() {
+  std::vector<uint16_t> palette;
+  std::vector<std::vector<uint8_t>> frames;
+  randomAnim(20, 12, 9, 6, palette, frames);
+  Bytes good = encodeAnim(20, 12, palette, frames);
+
+  const int scale = 2, stride = 20 * scale + 8;
+  std::vector<uint16_t> target(stride * (12 * scale + 8));
+  for (int trial = 0; trial < 3000; trial++) {
+    Bytes data = good;
+    if (trial < (int)good.size()) data.resize(trial);
+    else {
+      for (int n = 1 + next() % 4; n > 0; n--) data[next() % data.size()] = next();
+    }
+
+    std::fill(target.begin(), target.end(), 0xDEAD);
+    uint16_t* origin = target.data() + 4 * stride + 4;
+    AnimInfo info;
+    if (!animParse(data.data(), data.size(), &info)) continue;
+    if (info.width > 20 || info.height > 12) continue;     // the target only fits the real size
+    uint32_t offset = info.firstFrame;
+    for (int f = 0; f < 50; f++) {
+      uint32_t before = offset;
+      if (animDecodeFrame(data.data(), data.size(), info, &offset, origin, stride, scale, nullptr) < 0) break;
+      TEST_ASSERT_TRUE(offset > before);
+    }
+    for (int y = 0; y < 12 * scale + 8; y++) {
+      for (int x = 0; x < stride; x++) {
+        if (x < 4 || y < 4 || x >= 4 + 20 * scale || y >= 4 + 12 * scale) {
+          TEST_ASSERT_EQUAL_HEX16(0xDEAD, target[y * stride + x]);
+        }
+      }
+    }
+  }
+}
+
+static void test_decode_speed() {
+  AnimInfo info;
+  animParse(pacman_anim, sizeof(pacman_anim), &info);
+  static uint16_t canvas[64 * 64];
+  int frames = 200000;
+  double t0 = benchSeconds();
+  uint32_t offset = info.firstFrame;
+  for (int i = 0; i < frames; i++) {
+    if (animDecodeFrame(pacman_anim, sizeof(pacman_anim), info, &offset, canvas, 64, 4, nullptr) < 0) {
+      offset = info.firstFrame;
+    }
+  }
+  benchReport("pacman frame at 4x", frames, "frame", benchSeconds() - t0);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_shipped_animations_match_their_art);
+  RUN_TEST(test_corrupt_data_stays_in_bounds);
+  RUN_TEST(test_decode_speed);
+  return UNITY_END();
+}
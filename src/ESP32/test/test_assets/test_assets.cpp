@@ -0,0 +1,294 @@
+/**
+ * @file test_assets.cpp
+ * @brief asset store against a directory on the computer: lazy loading, LRU eviction within the budget, prefetch
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * DirSource is the PC AssetSource the store was written for: paths are relative to a root directory, and it counts
+ * every read so the tests can see what the store actually touches. The eviction test replays a long random access
+ * pattern against a plain model of the cache (slot count, byte budget, least recently used first, the asset on screen
+ * kept) and compares the cached set after every access.
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "Assets/AssetStore.h"
+#include "PixelArt/Animation.h"
+#include "../bench.h"
+
+class DirSource : public AssetSource {
+public:
+  std::string root;
+  int reads = 0;
+  uint32_t bytesRead = 0;
+  uint32_t largestRead = 0;
+
+  explicit DirSource(const std::string& dir) : root(dir) {}
+
+  int32_t fileSize(const char* path) override {
+    FILE* f = fopen((root + path).c_str(), "rb");
+    if (!f) return -1;
+    fseek(f, 0, SEEK_END);
+    int32_t size = ftell(f);
+    fclose(f);
+    return size;
+  }
+
+  int32_t read(const char* path, uint32_t offset, uint8_t* dst, uint32_t len) override {
+    FILE* f = fopen((root + path).c_str(), "rb");
+    if (!f) return -1;
+    fseek(f, offset, SEEK_SET);
+    int32_t got = fread(dst, 1, len, f);
+    fclose(f);
+    reads++;
+    bytesRead += got;
+    if ((uint32_t)got > largestRead) largestRead = got;
+    return got;
+  }
+};
+
+static char dir[] = "/tmp/test_assets_XXXXXX";
+static DirSource* source;
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+static void writeFile(const char* name, const std::string& contents) {
+  FILE* f = fopen((std::string(dir) + name).c_str(), "wb");
+  TEST_ASSERT_NOT_NULL(f);
+  fwrite(contents.data(), 1, contents.size(), f);
+  fclose(f);
+}
+
+// raw asset of a given size whose bytes say which asset it is
+static std::string rawFile(int id, uint32_t size) {
+  std::string s(size, (char)id);
+  for (uint32_t i = 0; i < size; i += 97) s[i] = (char)(i >> 5);
+  return s;
+}
+
+// NASSETS palettes p0..pN of mixed sizes, the sum well over the budget
+#define NASSETS 20
+static uint32_t sizes[NASSETS];
+
+static void writeStore() {
+  std::string index = "# test store\n\nbogus   x    /x\nimage\nfont  f_name_far_too_long_for_it /f\n";
+  for (int i = 0; i < NASSETS; i++) {
+    sizes[i] = (i % 5 == 0) ? 9000 + next() % 6000 : 200 + next() % 3000;
+    char name[16], path[32];
+    snprintf(name, sizeof(name), "p%d", i);
+    snprintf(path, sizeof(path), "/p%d.pal", i);
+    writeFile(path, rawFile(i, sizes[i]));
+    index += std::string("palette  ") + name + "  " + path + "\r\n";
+  }
+  index += "font big /big.fnt\nfont missing /nowhere.fnt\n";
+  writeFile("/big.fnt", std::string(ASSET_CACHE_BYTES + 1, 'x'));
+  writeFile(ASSET_INDEX_PATH, index);
+}
+
+void setUp() {
+  seed = 34;
+  source = new DirSource(dir);
+  writeStore();
+  TEST_ASSERT_TRUE(assetsBegin(source));
+}
+
+void tearDown() {
+  delete source;
+}
+
+static void test_index_only_at_begin() {
+  TEST_ASSERT_EQUAL_INT(NASSETS + 2, assetCount());
+  TEST_ASSERT_EQUAL_INT(1, source->reads);                      // the index, nothing else
+  TEST_ASSERT_EQUAL_INT(0, assetFind("p0"));
+  TEST_ASSERT_EQUAL_INT(NASSETS - 1, assetFind("p19"));
+  TEST_ASSERT_EQUAL_INT(-1, assetFind("x"));
+  TEST_ASSERT_EQUAL_INT(-1, assetFind("f_name_far_too_long_for_it"));
+  TEST_ASSERT_EQUAL_INT(ASSET_FONT, assetType(assetFind("big")));
+
+  const Asset* a = assetGet(3);
+  TEST_ASSERT_NOT_NULL(a);
+  TEST_ASSERT_EQUAL_UINT32(sizes[3], a->size);
+  TEST_ASSERT_EQUAL_MEMORY(rawFile(3, sizes[3]).data(), a->data, sizes[3]);
+  TEST_ASSERT_TRUE(assetGet(3) == a);
+  AssetStats s = assetStats();
+  TEST_ASSERT_EQUAL_UINT32(1, s.misses);
+  TEST_ASSERT_EQUAL_UINT32(1, s.hits);
+  TEST_ASSERT_EQUAL_UINT32(sizes[3], s.bytesCached);
+
+  // too big for the whole budget, or not there: nothing is cached
+  TEST_ASSERT_NULL(assetGet(assetFind("big")));
+  TEST_ASSERT_NULL(assetGet(assetFind("missing")));
+  TEST_ASSERT_NULL(assetGet(-1));
+  TEST_ASSERT_NULL(assetGet(assetCount()));
+  TEST_ASSERT_EQUAL_UINT32(sizes[3], assetStats().bytesCached);
+}
+
+// the real data/ folder: the index parses and the image decodes to the frame its file holds
+static void test_shipped_data() {
+  DirSource data("data");
+  TEST_ASSERT_TRUE(assetsBegin(&data));
+  int heart = assetFind("heart");
+  TEST_ASSERT_TRUE(heart >= 0);
+  TEST_ASSERT_EQUAL_INT(ASSET_IMAGE, assetType(heart));
+
+  const Asset* a = assetGet(heart);
+  TEST_ASSERT_NOT_NULL(a);
+  TEST_ASSERT_EQUAL_UINT32(a->width * a->height * 2, a->size);
+
+  int32_t size = data.fileSize("/img/heart.anim");
+  std::vector<uint8_t> file(size);
+  data.read("/img/heart.anim", 0, file.data(), size);
+  AnimInfo info;
+  TEST_ASSERT_TRUE(animParse(file.data(), size, &info));
+  std::vector<uint16_t> pixels(info.width * info.height);
+  uint32_t offset = info.firstFrame;
+  TEST_ASSERT_TRUE(animDecodeFrame(file.data(), size, info, &offset, pixels.data(), info.width, 1, nullptr) >= 0);
+  TEST_ASSERT_EQUAL_INT(info.width, a->width);
+  TEST_ASSERT_EQUAL_MEMORY(pixels.data(), a->data, a->size);
+}
+
+struct ModelSlot {
+  int index;
+  uint32_t lastUse;
+};
+
+// plain model of the cache rules, returns false if the asset could not be cached
+static bool modelGet(std::vector<ModelSlot>& cache, int index, int* mostRecent, uint32_t* clock) {
+  for (auto& s : cache) {
+    if (s.index == index) {
+      s.lastUse = ++*clock;
+      *mostRecent = index;
+      return true;
+    }
+  }
+  if (sizes[index] > ASSET_CACHE_BYTES) return false;
+  for (;;) {
+    uint32_t bytes = 0;
+    for (auto& s : cache) bytes += sizes[s.index];
+    if (cache.size() < ASSET_CACHE_SLOTS && bytes + sizes[index] <= ASSET_CACHE_BYTES) break;
+    int oldest = -1;
+    for (int i = 0; i < (int)cache.size(); i++) {
+      if (cache[i].index == *mostRecent) continue;
+      if (oldest < 0 || cache[i].lastUse < cache[oldest].lastUse) oldest = i;
+    }
+    if (oldest < 0) return false;
+    cache.erase(cache.begin() + oldest);
+  }
+  cache.push_back({ index, 0 });
+  ++*clock;                                             // cacheFile() stamps the slot, assetGet() stamps it again
+  cache.back().lastUse = ++*clock;
+  *mostRecent = index;
+  return true;
+}
+
+static void test_lru_matches_model() {
+  std::vector<ModelSlot> model;
+  int mostRecent = -1;
+  uint32_t clock = 0;
+  uint32_t evictions = 0;
+
+  for (int step = 0; step < 5000; step++) {
+    // mostly a small working set, now and then anything
+    int index = (next() % 4) ? next() % 6 : next() % NASSETS;
+    size_t before = model.size();
+    bool cachedBefore = false;
+    for (auto& s : model) cachedBefore |= s.index == index;
+
+    bool ok = modelGet(model, index, &mostRecent, &clock);
+    if (!cachedBefore) evictions += before + (ok ? 1 : 0) - model.size();
+    const Asset* a = assetGet(index);
+    TEST_ASSERT_EQUAL(ok, a != nullptr);
+    if (a) TEST_ASSERT_EQUAL_UINT8((uint8_t)index, a->data[1]);
+
+    uint32_t bytes = 0;
+    for (int i = 0; i < NASSETS; i++) {
+      bool inModel = false;
+      for (auto& s : model) inModel |= s.index == i;
+      TEST_ASSERT_EQUAL_MESSAGE(inModel, assetCached(i), "cached set differs from the model");
+      if (inModel) bytes += sizes[i];
+    }
+    TEST_ASSERT_EQUAL_UINT32(bytes, assetStats().bytesCached);
+    TEST_ASSERT_TRUE(bytes <= ASSET_CACHE_BYTES);
+  }
+  TEST_ASSERT_EQUAL_UINT32(evictions, assetStats().evictions);
+  TEST_ASSERT_TRUE(evictions > 100);
+}
+
+static void test_prefetch_in_slices() {
+  int big = 0;                                          // p0 is one of the 9-15 KB ones
+  assetPrefetch(big);
+  assetPrefetch(1);
+  TEST_ASSERT_FALSE(assetCached(big));
+  source->reads = 0;
+
+  int passes = 0;
+  while (!assetCached(big)) {
+    assetsPoll();
+    TEST_ASSERT_TRUE(++passes < 100);
+  }
+  TEST_ASSERT_TRUE(source->largestRead <= ASSET_PREFETCH_CHUNK);
+  TEST_ASSERT_EQUAL_INT((sizes[big] + ASSET_PREFETCH_CHUNK - 1) / ASSET_PREFETCH_CHUNK, source->reads);
+  while (!assetCached(1)) assetsPoll();
+  TEST_ASSERT_EQUAL_UINT32(2, assetStats().prefetched);
+
+  AssetStats before = assetStats();
+  TEST_ASSERT_NOT_NULL(assetGet(big));
+  TEST_ASSERT_EQUAL_UINT32(before.hits + 1, assetStats().hits);
+  TEST_ASSERT_EQUAL_UINT32(before.misses, assetStats().misses);
+
+  // a foreground request for the file being prefetched finishes it instead of starting over
+  assetPrefetch(5);
+  assetsPoll();                                         // opens it
+  assetsPoll();                                         // first slice
+  source->bytesRead = 0;
+  const Asset* a = assetGet(5);
+  TEST_ASSERT_NOT_NULL(a);
+  TEST_ASSERT_EQUAL_UINT32(sizes[5] - ASSET_PREFETCH_CHUNK, source->bytesRead);
+  TEST_ASSERT_EQUAL_MEMORY(rawFile(5, sizes[5]).data(), a->data, sizes[5]);
+
+  // the queue keeps the newest ASSET_PREFETCH_QUEUE requests
+  for (int i = 6; i < 6 + ASSET_PREFETCH_QUEUE + 2; i++) assetPrefetch(i);
+  for (int i = 0; i < 200; i++) assetsPoll();
+  TEST_ASSERT_FALSE(assetCached(6));
+  TEST_ASSERT_FALSE(assetCached(7));
+  for (int i = 8; i < 8 + ASSET_PREFETCH_QUEUE; i++) TEST_ASSERT_TRUE(assetCached(i));
+}
+
+static void test_lookup_speed() {
+  for (int i = 1; i < 6; i++) assetGet(i);
+  int n = 2000000;
+  double t0 = benchSeconds();
+  uint32_t sum = 0;
+  for (int i = 0; i < n; i++) sum += assetGet(1 + i % 5)->size;
+  benchReport("cache hit", n, "lookup", benchSeconds() - t0);
+  TEST_ASSERT_TRUE(sum > 0);
+
+  n = 2000;
+  t0 = benchSeconds();
+  for (int i = 0; i < n; i++) assetGet((i % 4) * 5);   // the big ones, each evicts the one before
+  benchReport("miss from directory (9-15 KB)", n, "load", benchSeconds() - t0);
+}
+
+int main() {
+  if (!mkdtemp(dir)) return 1;
+  UNITY_BEGIN();
+  RUN_TEST(test_index_only_at_begin);
+  RUN_TEST(test_shipped_data);
+  RUN_TEST(test_lru_matches_model);
+  RUN_TEST(test_prefetch_in_slices);
+  RUN_TEST(test_lookup_speed);
+  int failures = UNITY_END();
+  system((std::string("rm -rf ") + dir).c_str());
+  return failures;
+}
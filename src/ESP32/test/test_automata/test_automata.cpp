@@ -0,0 +1,197 @@
+/**
+ * @file test_automata.cpp
+ * @brief bit-packed automata step against a cell by cell reference, plus generations per second
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The reference keeps one byte per cell and applies the Generations rule literally (state 1 is live, a live cell that
+ * does not survive starts aging, aging cells count up to the last state and die, only live cells are counted as
+ * neighbours) on the same 64x64 torus. Random soups are stepped by both for a few hundred generations, comparing every
+ * cell, the changed count and the rows reported to the callback. The packed grid is checked on its own too: every cell
+ * reads back what was written in every state, and it stays within its 832 bytes.
+ *
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "Automata/CellAutomata.h"
+#include "../bench.h"
+
+#define N AUTOMATA_SIZE
+#define GENERATIONS 300
+
+static const AutomataRule* const RULES[] = { &AUTOMATA_LIFE, &AUTOMATA_BRIANS_BRAIN };
+static const int DENSITIES[] = { 15, 35, 60 };      // percent of cells not dead at the start
+
+static AutomataGrid grid;
+static uint8_t ref[N][N];
+static uint64_t reportedRows[N];
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+static uint32_t refStep(const AutomataRule& rule) {
+  static uint8_t out[N][N];
+  uint32_t changed = 0;
+  for (int y = 0; y < N; y++) {
+    for (int x = 0; x < N; x++) {
+      int live = 0;
+      for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+          if ((dx || dy) && ref[(y + dy + N) % N][(x + dx + N) % N] == 1) live++;
+        }
+      }
+      uint8_t s = ref[y][x];
+      uint8_t n;
+      if (s == 0) n = (rule.birth >> live) & 1;
+      else if (s == 1) n = ((rule.survive >> live) & 1) ? 1 : (rule.states > 2 ? 2 : 0);
+      else n = (s + 1 < rule.states) ? s + 1 : 0;
+      out[y][x] = n;
+      if (n != s) changed++;
+    }
+  }
+  memcpy(ref, out, sizeof(ref));
+  return changed;
+}
+
+static void recordRow(uint8_t y, uint64_t changed, const AutomataGrid*, void*) {
+  reportedRows[y] = changed;
+}
+
+// random soup in every state the rule has, written to both grids
+static void randomFill(const AutomataRule& rule, int density) {
+  for (int y = 0; y < N; y++) {
+    for (int x = 0; x < N; x++) {
+      uint8_t s = ((int)(next() % 100) < density) ? 1 + next() % (rule.states - 1) : 0;
+      ref[y][x] = s;
+      automataSetCell(&grid, x, y, s);
+    }
+  }
+}
+
+static void assertSame(const char* rule, int gen) {
+  char msg[64];
+  for (int y = 0; y < N; y++) {
+    for (int x = 0; x < N; x++) {
+      if (automataCell(&grid, x, y) != ref[y][x]) {
+        snprintf(msg, sizeof(msg), "%s generation %d cell %d,%d", rule, gen, x, y);
+        TEST_ASSERT_EQUAL_UINT8_MESSAGE(ref[y][x], automataCell(&grid, x, y), msg);
+      }
+    }
+  }
+}
+
+void setUp() {
+  seed = 31;
+}
+
+void tearDown() {}
+
+static void test_matches_reference() {
+  for (const AutomataRule* rule : RULES) {
+    for (int density : DENSITIES) {
+      randomFill(*rule, density);
+      for (int gen = 1; gen <= GENERATIONS; gen++) {
+        uint8_t before[N][N];
+        memcpy(before, ref, sizeof(ref));
+        memset(reportedRows, 0, sizeof(reportedRows));
+
+        uint32_t expected = refStep(*rule);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected, automataStep(&grid, *rule, recordRow, nullptr), rule->name);
+        assertSame(rule->name, gen);
+
+        for (int y = 0; y < N; y++) {
+          uint64_t changed = 0;
+          for (int x = 0; x < N; x++) {
+            if (before[y][x] != ref[y][x]) changed |= (uint64_t)1 << x;
+          }
+          TEST_ASSERT_EQUAL_UINT64_MESSAGE(changed, reportedRows[y], rule->name);
+        }
+      }
+    }
+  }
+}
+
+// a glider moves one cell diagonally every 4 generations, across the wrap as well
+static void test_glider_wraps() {
+  automataClear(&grid);
+  const uint8_t cells[][2] = { { 1, 0 }, { 2, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 } };
+  for (auto& c : cells) automataSetCell(&grid, c[0] + 60, c[1] + 60, 1);
+
+  for (int i = 0; i < 4 * 8; i++) automataStep(&grid, AUTOMATA_LIFE, nullptr, nullptr);
+  TEST_ASSERT_EQUAL_UINT32(5, automataPopulation(&grid));
+  for (auto& c : cells) TEST_ASSERT_EQUAL_UINT8(1, automataCell(&grid, (c[0] + 68) % N, (c[1] + 68) % N));
+}
+
+// 5 cells to a byte in base 3: every cell keeps its own state whatever its neighbours in the byte hold
+static void test_packed_grid() {
+  TEST_ASSERT_EQUAL_INT(832, sizeof(AutomataGrid));
+
+  for (int round = 0; round < 20; round++) {
+    for (int y = 0; y < N; y++) {
+      for (int x = 0; x < N; x++) {
+        ref[y][x] = next() % 3;
+        automataSetCell(&grid, x, y, ref[y][x]);
+      }
+    }
+    // overwrite a few more, in any order
+    for (int i = 0; i < 2000; i++) {
+      int x = next() % N, y = next() % N;
+      ref[y][x] = next() % 3;
+      automataSetCell(&grid, x, y, ref[y][x]);
+    }
+    uint32_t population = 0;
+    for (int y = 0; y < N; y++) {
+      uint64_t row = 0;
+      for (int x = 0; x < N; x++) {
+        if (ref[y][x]) row |= (uint64_t)1 << x;
+        population += ref[y][x] != 0;
+      }
+      TEST_ASSERT_EQUAL_UINT64(row, automataRow(&grid, y));
+      for (int i = 0; i < AUTOMATA_ROW_BYTES; i++) TEST_ASSERT_TRUE(grid.rows[y][i] < 243);
+    }
+    assertSame("packed", round);
+    TEST_ASSERT_EQUAL_UINT32(population, automataPopulation(&grid));
+  }
+
+  // a soup is live cells only, clearing leaves none
+  uint32_t rng = 5;
+  automataSeed(&grid, &rng);
+  for (int y = 0; y < N; y++) {
+    for (int x = 0; x < N; x++) TEST_ASSERT_TRUE(automataCell(&grid, x, y) <= 1);
+  }
+  TEST_ASSERT_TRUE(automataPopulation(&grid) > 0);
+  automataClear(&grid);
+  TEST_ASSERT_EQUAL_UINT32(0, automataPopulation(&grid));
+}
+
+static void test_generations_per_second() {
+  for (const AutomataRule* rule : RULES) {
+    randomFill(*rule, 35);
+    int gens = 20000;
+    double t0 = benchSeconds();
+    for (int i = 0; i < gens; i++) automataStep(&grid, *rule, nullptr, nullptr);
+    char name[48];
+    snprintf(name, sizeof(name), "%s bit-packed", rule->name);
+    benchReport(name, gens, "gen", benchSeconds() - t0);
+
+    gens = 200;
+    t0 = benchSeconds();
+    for (int i = 0; i < gens; i++) refStep(*rule);
+    snprintf(name, sizeof(name), "%s per cell", rule->name);
+    benchReport(name, gens, "gen", benchSeconds() - t0);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_matches_reference);
+  RUN_TEST(test_glider_wraps);
+  RUN_TEST(test_packed_grid);
+  RUN_TEST(test_generations_per_second);
+  return UNITY_END();
+}
@@ -0,0 +1,203 @@
+/**
+ * @file test_blitter.cpp
+ * @brief word kernels of the blitter against plain per-pixel versions, plus their speed
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Every kernel is run on random sizes at every pixel alignment of source and destination, inside a buffer with a guard
+ * border, and has to produce exactly what the one-pixel-at-a-time loop below does without touching anything outside
+ * its rectangle.
+ *
+ */
+
+#include <unity.h>
+#include "../bench.h"
+#include "Display/Blitter.h"
+#include <string.h>
+
+#define BUF_STRIDE 80
+#define BUF_ROWS 48
+#define BUF_SIZE (BUF_STRIDE * BUF_ROWS)
+
+static uint16_t dstKernel[BUF_SIZE + 2];
+static uint16_t dstRef[BUF_SIZE + 2];
+static uint16_t srcBuf[BUF_SIZE + 2];
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+static void randomFill(uint16_t* p, int n) {
+  for (int i = 0; i < n; i++) p[i] = (uint16_t)next();
+}
+
+void setUp() {
+  seed = 12345;
+  randomFill(dstKernel, BUF_SIZE + 2);
+  memcpy(dstRef, dstKernel, sizeof(dstRef));
+  randomFill(srcBuf, BUF_SIZE + 2);
+}
+
+void tearDown() {}
+
+// ------------------------------------------------ references ------------------------------------------------ //
+
+static uint16_t refBlend(uint16_t s, uint16_t d, int a) {
+  int r = (((s >> 11) & 31) * a + ((d >> 11) & 31) * (32 - a)) >> 5;
+  int g = (((s >> 5) & 63) * a + ((d >> 5) & 63) * (32 - a)) >> 5;
+  int b = ((s & 31) * a + (d & 31) * (32 - a)) >> 5;
+  return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void refFill(uint16_t* dst, int stride, int w, int h, uint16_t c) {
+  for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++) dst[y * stride + x] = c;
+}
+
+static void refPattern(uint16_t* dst, int stride, int w, int h, const uint16_t* pat, int size, int px, int py) {
+  for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++) dst[y * stride + x] = pat[((y + py) % size) * size + (x + px) % size];
+}
+
+static void refKeyed(uint16_t* dst, int ds, const uint16_t* src, int ss, int w, int h, uint16_t key) {
+  for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++)
+      if (src[y * ss + x] != key) dst[y * ds + x] = src[y * ss + x];
+}
+
+static void refScaled(uint16_t* dst, int ds, const uint16_t* src, int ss, int sw, int sh, int scale) {
+  for (int y = 0; y < sh * scale; y++)
+    for (int x = 0; x < sw * scale; x++) dst[y * ds + x] = src[(y / scale) * ss + x / scale];
+}
+
+static void refBlendRect(uint16_t* dst, int ds, const uint16_t* src, int ss, int w, int h, int a) {
+  for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++) dst[y * ds + x] = refBlend(src[y * ss + x], dst[y * ds + x], a);
+}
+
+static void assertSame(const char* what) {
+  TEST_ASSERT_EQUAL_MEMORY_MESSAGE(dstRef, dstKernel, sizeof(dstRef), what);
+}
+
+// --------------------------------------------------- tests --------------------------------------------------- //
+
+static void test_blend_pixel_matches_per_channel() {
+  for (int a = 0; a <= BLEND_ALPHA_MAX; a++) {
+    for (int i = 0; i < 2000; i++) {
+      uint16_t s = (uint16_t)next(), d = (uint16_t)next();
+      TEST_ASSERT_EQUAL_HEX16(refBlend(s, d, a), blend565(s, d, a));
+    }
+    TEST_ASSERT_EQUAL_HEX16(refBlend(0xFFFF, 0xFFFF, a), blend565(0xFFFF, 0xFFFF, a));
+  }
+}
+
+static void test_fill() {
+  for (int i = 0; i < 400; i++) {
+    int off = BUF_STRIDE + 1 + (i & 3);
+    int w = next() % 40, h = 1 + next() % 20;
+    uint16_t c = (uint16_t)next();
+    blitFill(dstKernel + off, BUF_STRIDE, w, h, c);
+    refFill(dstRef + off, BUF_STRIDE, w, h, c);
+    assertSame("blitFill");
+  }
+}
+
+static void test_fill_pattern() {
+  uint16_t pat[8 * 8];
+  randomFill(pat, 64);
+  for (int i = 0; i < 400; i++) {
+    int size = 1 << (next() % 4);
+    int off = BUF_STRIDE + 1 + (i & 3);
+    int w = next() % 40, h = 1 + next() % 20;
+    int px = next() % 16, py = next() % 16;
+    blitFillPattern(dstKernel + off, BUF_STRIDE, w, h, pat, size, px, py);
+    refPattern(dstRef + off, BUF_STRIDE, w, h, pat, size, px, py);
+    assertSame("blitFillPattern");
+  }
+}
+
+static void test_copy_keyed() {
+  uint16_t key = 0xF81F;
+  for (int i = 0; i < BUF_SIZE; i++)
+    if (next() % 3 == 0) srcBuf[i] = key;          // runs of transparent and mixed pairs
+  for (int i = 0; i < 800; i++) {
+    int doff = BUF_STRIDE + 1 + (i & 3);
+    int soff = 1 + ((i >> 2) & 3);
+    int w = next() % 40, h = 1 + next() % 20;
+    blitCopyKeyed(dstKernel + doff, BUF_STRIDE, srcBuf + soff, BUF_STRIDE, w, h, key);
+    refKeyed(dstRef + doff, BUF_STRIDE, srcBuf + soff, BUF_STRIDE, w, h, key);
+    assertSame("blitCopyKeyed");
+  }
+}
+
+static void test_scaled() {
+  for (int i = 0; i < 400; i++) {
+    int scale = 1 + next() % 6;
+    int doff = BUF_STRIDE + 1 + (i & 3);
+    int sw = next() % (70 / scale + 1), sh = 1 + next() % (40 / scale);
+    int soff = 1 + ((i >> 2) & 1);
+    blitScaled(dstKernel + doff, BUF_STRIDE, srcBuf + soff, 11, sw, sh, scale);
+    refScaled(dstRef + doff, BUF_STRIDE, srcBuf + soff, 11, sw, sh, scale);
+    assertSame("blitScaled");
+  }
+}
+
+static void test_blend() {
+  for (int i = 0; i < 800; i++) {
+    int a = next() % (BLEND_ALPHA_MAX + 1);
+    int doff = BUF_STRIDE + 1 + (i & 3);
+    int soff = 1 + ((i >> 2) & 3);
+    int w = next() % 40, h = 1 + next() % 20;
+    blitBlend(dstKernel + doff, BUF_STRIDE, srcBuf + soff, BUF_STRIDE, w, h, a);
+    refBlendRect(dstRef + doff, BUF_STRIDE, srcBuf + soff, BUF_STRIDE, w, h, a);
+    assertSame("blitBlend");
+  }
+}
+
+// ------------------------------------------------- benchmark ------------------------------------------------- //
+
+#define BENCH_W 64
+#define BENCH_H 64
+#define BENCH_ROUNDS 4000
+
+static uint16_t benchDst[BENCH_W * BENCH_H];
+static uint16_t benchSrc[BENCH_W * BENCH_H];
+
+static volatile uint16_t sink;
+
+static void measure(const char* name, void (*kernel)(int round)) {
+  double t0 = benchSeconds();
+  for (int r = 0; r < BENCH_ROUNDS; r++) kernel(r);
+  double t = benchSeconds() - t0;
+  sink = benchDst[(BENCH_W * BENCH_H) / 2];
+  benchReport(name, (double)BENCH_ROUNDS * BENCH_W * BENCH_H, "pix", t);
+}
+
+static void test_benchmark() {
+  randomFill(benchSrc, BENCH_W * BENCH_H);
+  for (int i = 0; i < BENCH_W * BENCH_H; i += 3) benchSrc[i] = 0;
+
+  measure("fill 64x64 kernel", [](int r) { blitFill(benchDst, BENCH_W, BENCH_W, BENCH_H, (uint16_t)r); });
+  measure("fill 64x64 reference", [](int r) { refFill(benchDst, BENCH_W, BENCH_W, BENCH_H, (uint16_t)r); });
+  measure("keyed 64x64 kernel", [](int) { blitCopyKeyed(benchDst, BENCH_W, benchSrc, BENCH_W, BENCH_W, BENCH_H, 0); });
+  measure("keyed 64x64 reference", [](int) { refKeyed(benchDst, BENCH_W, benchSrc, BENCH_W, BENCH_W, BENCH_H, 0); });
+  measure("scaled 16x16 x4 kernel", [](int) { blitScaled(benchDst, BENCH_W, benchSrc, 16, 16, 16, 4); });
+  measure("scaled 16x16 x4 reference", [](int) { refScaled(benchDst, BENCH_W, benchSrc, 16, 16, 16, 4); });
+  measure("blend 64x64 kernel", [](int r) { blitBlend(benchDst, BENCH_W, benchSrc, BENCH_W, BENCH_W, BENCH_H, 1 + r % 31); });
+  measure("blend 64x64 reference", [](int r) { refBlendRect(benchDst, BENCH_W, benchSrc, BENCH_W, BENCH_W, BENCH_H, 1 + r % 31); });
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_blend_pixel_matches_per_channel);
+  RUN_TEST(test_fill);
+  RUN_TEST(test_fill_pattern);
+  RUN_TEST(test_copy_keyed);
+  RUN_TEST(test_scaled);
+  RUN_TEST(test_blend);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,384 @@
+/**
+ * @file test_boot.cpp
+ * @brief staged start up: the console's stage table, timing markers, random and broken tables
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The table is the real one from Boot/BootStages.h, the stage functions it points to are stand ins defined here that
+ * log the order they are called in and take a set time on a fake clock. Random tables check bootPlan() and bootStep()
+ * against a plain topological sort (lowest index first), broken ones (cycles, a stage needing itself or a stage past
+ * the end) that bootBegin() reports them and the boot stops instead of running a stage too early.
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "Boot/BootStages.h"
+#include "../bench.h"
+
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+// fake microsecond clock, each stage moves it on by its cost
+static uint32_t nowUs;
+
+static uint32_t fakeClock() {
+  return nowUs;
+}
+
+// stand in stages
+static int ran[32];
+static int ranCount;
+static uint16_t failing;                // BOOT_STAGE() bits of the stages that return false
+static uint32_t costUs[BOOT_MAX_STAGES];
+
+static bool stage(int id) {
+  ran[ranCount++] = id;
+  nowUs += costUs[id];
+  return !(failing & BOOT_STAGE(id));
+}
+
+bool bootDisplay() { return stage(BOOT_DISPLAY); }
+bool bootTransitions() { return stage(BOOT_TRANSITIONS); }
+bool bootStorage() { return stage(BOOT_STORAGE); }
+bool bootInputConfig() { return stage(BOOT_INPUT); }
+bool bootColors() { return stage(BOOT_COLORS); }
+bool bootHome() { return stage(BOOT_HOME); }
+bool bootAssets() { return stage(BOOT_ASSETS); }
+bool bootWeb() { return stage(BOOT_WEB); }
+
+// for generated tables, stage i logs i
+static bool s0() { return stage(0); }
+static bool s1() { return stage(1); }
+static bool s2() { return stage(2); }
+static bool s3() { return stage(3); }
+static bool s4() { return stage(4); }
+static bool s5() { return stage(5); }
+static bool s6() { return stage(6); }
+static bool s7() { return stage(7); }
+static bool s8() { return stage(8); }
+static bool s9() { return stage(9); }
+static bool s10() { return stage(10); }
+static bool s11() { return stage(11); }
+static bool s12() { return stage(12); }
+static bool s13() { return stage(13); }
+static bool s14() { return stage(14); }
+static bool s15() { return stage(15); }
+static const BootStageFn numbered[BOOT_MAX_STAGES] = { s0, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12, s13, s14,
+                                                       s15 };
+
+void setUp() {
+  seed = 50;
+  nowUs = 0;
+  ranCount = 0;
+  failing = 0;
+  for (int i = 0; i < BOOT_MAX_STAGES; i++) costUs[i] = 1000;
+}
+
+void tearDown() {}
+
+// ---------- reference ---------- //
+
+// lowest index first among the ready stages, the stages that can never run left out
+static int referencePlan(const BootStage* stages, int count, uint8_t* order) {
+  bool done[BOOT_MAX_STAGES] = {};
+  int n = 0;
+  for (;;) {
+    int pick = -1;
+    for (int i = 0; i < count && pick < 0; i++) {
+      if (done[i]) continue;
+      bool ready = true;
+      for (int j = 0; j < 16; j++) {
+        if ((stages[i].needs >> j & 1) && (j >= count || !done[j])) ready = false;
+      }
+      if (ready) pick = i;
+    }
+    if (pick < 0) return n;
+    done[pick] = true;
+    order[n++] = pick;
+  }
+}
+
+// a table whose stage i only needs stages before it, about one in density of them
+static void randomTable(BootStage* stages, int count, int density) {
+  for (int i = 0; i < count; i++) {
+    stages[i].name = "stage";
+    stages[i].run = numbered[i];
+    stages[i].needs = 0;
+    for (int j = 0; j < i; j++) {
+      if (next() % density == 0) stages[i].needs |= BOOT_STAGE(j);
+    }
+  }
+}
+
+// the same table with its stages shuffled, so dependencies point both ways
+static void shuffleTable(BootStage* stages, int count) {
+  int at[BOOT_MAX_STAGES];
+  for (int i = 0; i < count; i++) at[i] = i;
+  for (int i = count - 1; i > 0; i--) {
+    int j = next() % (i + 1);
+    int t = at[i];
+    at[i] = at[j];
+    at[j] = t;
+  }
+  BootStage moved[BOOT_MAX_STAGES];
+  for (int i = 0; i < count; i++) {
+    moved[at[i]] = stages[i];
+    moved[at[i]].run = numbered[at[i]];
+    moved[at[i]].needs = stages[i].needs & ~(uint16_t)((1UL << count) - 1);   // needs past the end stay there
+    for (int j = 0; j < count; j++) {
+      if (stages[i].needs & BOOT_STAGE(j)) moved[at[i]].needs |= BOOT_STAGE(at[j]);
+    }
+  }
+  memcpy(stages, moved, sizeof(BootStage) * count);
+}
+
+// ---------- the console's table ---------- //
+
+static void test_console_plan() {
+  static const int expected[BOOT_STAGE_COUNT] = { BOOT_DISPLAY, BOOT_TRANSITIONS, BOOT_STORAGE, BOOT_INPUT,
+                                                  BOOT_COLORS, BOOT_HOME, BOOT_ASSETS, BOOT_WEB };
+  uint8_t order[BOOT_MAX_STAGES];
+  TEST_ASSERT_EQUAL_INT(BOOT_STAGE_COUNT, bootPlan(bootStages, BOOT_STAGE_COUNT, order));
+  for (int i = 0; i < BOOT_STAGE_COUNT; i++) TEST_ASSERT_EQUAL_INT(expected[i], order[i]);
+
+  // every stage after what it needs, the splash first, the home screen before the slow stages
+  int position[BOOT_STAGE_COUNT];
+  for (int i = 0; i < BOOT_STAGE_COUNT; i++) position[order[i]] = i;
+  for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+    for (int j = 0; j < BOOT_STAGE_COUNT; j++) {
+      if (bootStages[i].needs & BOOT_STAGE(j)) TEST_ASSERT_TRUE(position[j] < position[i]);
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(0, position[BOOT_DISPLAY]);
+  TEST_ASSERT_TRUE(position[BOOT_HOME] < position[BOOT_ASSETS]);
+  TEST_ASSERT_TRUE(position[BOOT_HOME] < position[BOOT_WEB]);
+}
+
+static void test_console_boot() {
+  BootSequence b;
+  TEST_ASSERT_TRUE(bootBegin(&b, bootStages, BOOT_STAGE_COUNT, fakeClock));
+  uint8_t order[BOOT_MAX_STAGES];
+  bootPlan(bootStages, BOOT_STAGE_COUNT, order);
+
+  // one stage per step, in plan order, and the home screen ready as soon as its stage has run
+  for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+    TEST_ASSERT_FALSE(bootFinished(&b));
+    TEST_ASSERT_EQUAL_INT(i, bootDoneCount(&b));
+    TEST_ASSERT_EQUAL_INT(order[i], bootNext(&b));
+    TEST_ASSERT_EQUAL_INT(order[i], bootStep(&b));
+    TEST_ASSERT_EQUAL(order[i] == BOOT_HOME || bootReady(&b, BOOT_STAGE(BOOT_HOME)),
+                      bootReady(&b, BOOT_STAGE(BOOT_HOME)));
+  }
+  TEST_ASSERT_TRUE(bootFinished(&b));
+  TEST_ASSERT_EQUAL_INT(-1, bootNext(&b));
+  TEST_ASSERT_EQUAL_INT(-1, bootStep(&b));
+  TEST_ASSERT_EQUAL_INT(BOOT_STAGE_COUNT, ranCount);
+  for (int i = 0; i < BOOT_STAGE_COUNT; i++) TEST_ASSERT_EQUAL_INT(order[i], ran[i]);
+  TEST_ASSERT_TRUE(bootReady(&b, BOOT_STAGE(BOOT_HOME) | BOOT_STAGE(BOOT_WEB)));
+  TEST_ASSERT_EQUAL_HEX16(0, b.failed);
+}
+
+static void test_failed_stage() {
+  // no flash: storage fails, what needs it still runs (and checks flashMounted itself)
+  failing = BOOT_STAGE(BOOT_STORAGE);
+  BootSequence b;
+  bootBegin(&b, bootStages, BOOT_STAGE_COUNT, fakeClock);
+  while (bootStep(&b) >= 0) {}
+
+  TEST_ASSERT_TRUE(bootFinished(&b));
+  TEST_ASSERT_EQUAL_INT(BOOT_STAGE_COUNT, ranCount);
+  TEST_ASSERT_EQUAL_HEX16(BOOT_STAGE(BOOT_STORAGE), b.failed);
+
+  char line[BOOT_MARKER_LEN];
+  bootMarker(&b, BOOT_STORAGE, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING("boot storage 3.0 ms (1.0 ms) failed", line);
+  bootMarker(&b, BOOT_INPUT, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING("boot input 4.0 ms (1.0 ms)", line);
+}
+
+// ---------- markers ---------- //
+
+static void test_markers() {
+  costUs[BOOT_DISPLAY] = 41250;
+  costUs[BOOT_TRANSITIONS] = 99;
+  costUs[BOOT_STORAGE] = 380049;
+  nowUs = 12345;
+  BootSequence b;
+  bootBegin(&b, bootStages, BOOT_STAGE_COUNT, fakeClock);
+  bootStep(&b);
+  bootStep(&b);
+  bootStep(&b);
+
+  char line[BOOT_MARKER_LEN];
+  bootMarker(&b, BOOT_DISPLAY, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING("boot display 53.5 ms (41.2 ms)", line);
+  bootMarker(&b, BOOT_TRANSITIONS, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING("boot transitions 53.6 ms (0.0 ms)", line);
+  bootMarker(&b, BOOT_STORAGE, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING("boot storage 433.7 ms (380.0 ms)", line);
+
+  // micros() wrapping inside a stage still gives its duration
+  nowUs = 0xFFFFFFFFu - 500;
+  costUs[BOOT_INPUT] = 2000;
+  bootStep(&b);
+  TEST_ASSERT_EQUAL_UINT32(2000, b.tookUs[BOOT_INPUT]);
+  bootMarker(&b, BOOT_INPUT, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING("boot input 1.4 ms (2.0 ms)", line);
+
+  // the longest name in the table with the largest times and the failure mark fits the buffer main.cpp uses
+  BootStage renamed[BOOT_STAGE_COUNT];
+  memcpy(renamed, bootStages, sizeof(renamed));
+  renamed[BOOT_COLORS].name = "transitions";
+  b.stages = renamed;
+  failing = BOOT_STAGE(BOOT_COLORS);
+  nowUs = 0xFFFFFFFFu - costUs[BOOT_COLORS];
+  bootStep(&b);
+  b.tookUs[BOOT_COLORS] = 0xFFFFFFFFu;
+  bootMarker(&b, BOOT_COLORS, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING("boot transitions 4294967.2 ms (4294967.2 ms) failed", line);
+  TEST_ASSERT_TRUE(strlen(line) < BOOT_MARKER_LEN);
+}
+
+// ---------- generated tables ---------- //
+
+static void test_random_tables() {
+  for (int round = 0; round < 3000; round++) {
+    int count = 1 + next() % BOOT_MAX_STAGES;
+    BootStage stages[BOOT_MAX_STAGES];
+    randomTable(stages, count, 2 + next() % 4);
+    if (round & 1) shuffleTable(stages, count);
+
+    uint8_t order[BOOT_MAX_STAGES], expected[BOOT_MAX_STAGES];
+    TEST_ASSERT_EQUAL_INT(count, referencePlan(stages, count, expected));
+    TEST_ASSERT_EQUAL_INT(count, bootPlan(stages, count, order));
+    TEST_ASSERT_EQUAL_MEMORY(expected, order, count);
+
+    // failures anywhere don't change the order
+    failing = (uint16_t)next();
+    ranCount = 0;
+    BootSequence b;
+    TEST_ASSERT_TRUE(bootBegin(&b, stages, count, fakeClock));
+    while (bootStep(&b) >= 0) {}
+    TEST_ASSERT_TRUE(bootFinished(&b));
+    TEST_ASSERT_EQUAL_INT(count, ranCount);
+    for (int i = 0; i < count; i++) TEST_ASSERT_EQUAL_INT(expected[i], ran[i]);
+    TEST_ASSERT_EQUAL_HEX16(failing & (uint16_t)((1UL << count) - 1), b.failed);
+  }
+}
+
+static void test_broken_tables() {
+  for (int round = 0; round < 3000; round++) {
+    int count = 2 + next() % (BOOT_MAX_STAGES - 2);     // at most 15, so there is a stage past the end to need
+    BootStage stages[BOOT_MAX_STAGES];
+    randomTable(stages, count, 3);
+
+    // break one stage: it needs itself, a later stage that comes to need it back, or a stage past the end
+    int bad = next() % count;
+    switch (round % 3) {
+      case 0:
+        stages[bad].needs |= BOOT_STAGE(bad);
+        break;
+      case 1: {
+        int other = next() % count;
+        if (other == bad) other = (bad + 1) % count;
+        stages[bad].needs |= BOOT_STAGE(other);
+        stages[other].needs |= BOOT_STAGE(bad);
+        break;
+      }
+      default:
+        stages[bad].needs |= BOOT_STAGE(count + next() % (16 - count));
+        break;
+    }
+    if (round & 1) shuffleTable(stages, count);
+
+    uint8_t order[BOOT_MAX_STAGES], expected[BOOT_MAX_STAGES];
+    int runnable = referencePlan(stages, count, expected);
+    TEST_ASSERT_TRUE(runnable < count);
+    TEST_ASSERT_EQUAL_INT(runnable, bootPlan(stages, count, order));
+    TEST_ASSERT_EQUAL_MEMORY(expected, order, runnable);
+
+    // the boot runs what it can, then stops without running a stuck stage
+    ranCount = 0;
+    BootSequence b;
+    TEST_ASSERT_FALSE(bootBegin(&b, stages, count, fakeClock));
+    while (bootStep(&b) >= 0) {}
+    TEST_ASSERT_FALSE(bootFinished(&b));
+    TEST_ASSERT_EQUAL_INT(runnable, ranCount);
+    TEST_ASSERT_EQUAL_INT(runnable, bootDoneCount(&b));
+    for (int i = 0; i < runnable; i++) TEST_ASSERT_EQUAL_INT(expected[i], ran[i]);
+    TEST_ASSERT_EQUAL_INT(-1, bootNext(&b));
+  }
+}
+
+static void test_limits() {
+  BootStage stages[BOOT_MAX_STAGES + 1];
+  for (int i = 0; i <= BOOT_MAX_STAGES; i++) stages[i] = { "stage", numbered[i % BOOT_MAX_STAGES], 0 };
+  uint8_t order[BOOT_MAX_STAGES + 1];
+  TEST_ASSERT_EQUAL_INT(0, bootPlan(stages, BOOT_MAX_STAGES + 1, order));
+  TEST_ASSERT_EQUAL_INT(BOOT_MAX_STAGES, bootPlan(stages, BOOT_MAX_STAGES, order));
+
+  // a full table finishes with every bit set, an empty one right away
+  BootSequence b;
+  TEST_ASSERT_TRUE(bootBegin(&b, stages, BOOT_MAX_STAGES, fakeClock));
+  while (bootStep(&b) >= 0) {}
+  TEST_ASSERT_TRUE(bootFinished(&b));
+  TEST_ASSERT_EQUAL_HEX16(0xFFFF, b.done);
+  TEST_ASSERT_TRUE(bootBegin(&b, stages, 0, fakeClock));
+  TEST_ASSERT_TRUE(bootFinished(&b));
+  TEST_ASSERT_EQUAL_INT(-1, bootStep(&b));
+}
+
+// ---------- benchmark ---------- //
+
+static void test_benchmark() {
+  // 16 stages in a chain listed backwards: each bootPlan() pass finds one stage, at the end of the table (worst case)
+  BootStage chain[BOOT_MAX_STAGES];
+  for (int i = 0; i < BOOT_MAX_STAGES; i++) {
+    chain[i] = { "stage", numbered[i], (uint16_t)(i + 1 < BOOT_MAX_STAGES ? BOOT_STAGE(i + 1) : 0) };
+  }
+  BootStage random[BOOT_MAX_STAGES];
+  randomTable(random, BOOT_MAX_STAGES, 3);
+  shuffleTable(random, BOOT_MAX_STAGES);
+
+  const struct {
+    const char* name;
+    const BootStage* stages;
+    int count;
+  } cases[] = {
+    { "bootPlan, console table", bootStages, BOOT_STAGE_COUNT },
+    { "bootPlan, 16 random stages", random, BOOT_MAX_STAGES },
+    { "bootPlan, 16 stage reversed chain", chain, BOOT_MAX_STAGES },
+  };
+  for (const auto& c : cases) {
+    uint8_t order[BOOT_MAX_STAGES];
+    volatile long sink = 0;
+    long plans = 0;
+    double t0 = benchSeconds(), seconds;
+    do {
+      for (int i = 0; i < 1000; i++) sink += bootPlan(c.stages, c.count, order);
+      plans += 1000;
+    } while ((seconds = benchSeconds() - t0) < 0.1);
+    TEST_ASSERT_TRUE(sink == c.count * plans);
+    benchReport(c.name, plans, "plan", seconds);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_console_plan);
+  RUN_TEST(test_console_boot);
+  RUN_TEST(test_failed_stage);
+  RUN_TEST(test_markers);
+  RUN_TEST(test_random_tables);
+  RUN_TEST(test_broken_tables);
+  RUN_TEST(test_limits);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
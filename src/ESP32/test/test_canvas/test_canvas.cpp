@@ -0,0 +1,198 @@
+/**
+ * @file test_canvas.cpp
+ * @brief virtual canvas: logical -> chain mapping for every layout and rotation, damage tracking and flushing
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The native env builds a 2x2 wall (4 panels on the chain), the host panel in lib/HostGFX records what is pushed.
+ *
+ */
+
+#include <unity.h>
+#include "Display/VirtualCanvas.h"
+
+static const int CHAIN_WIDTH = PANEL_WIDTH * PANELS_NUMBER;
+
+static MatrixPanel_I2S_DMA* panel;
+static VirtualCanvas* canvas;
+
+static void makeCanvas(PanelChainLayout layout, PanelRotation rotation) {
+  delete canvas;
+  delete panel;
+  panel = new MatrixPanel_I2S_DMA(HUB75_I2S_CFG(PANEL_WIDTH, PANEL_HEIGHT, PANELS_NUMBER));
+  panel->begin();
+  canvas = new VirtualCanvas(panel, layout, rotation);
+  canvas->begin();
+}
+
+void setUp() {
+  makeCanvas(CHAIN_ROWS, ROTATE_0);
+}
+
+void tearDown() {
+  delete canvas;
+  delete panel;
+  canvas = nullptr;
+  panel = nullptr;
+}
+
+static int dirtyTiles() {
+  int n = 0;
+  for (int ty = 0; ty < CANVAS_TILES_Y; ty++)
+    for (int tx = 0; tx < CANVAS_TILES_X; tx++) n += canvas->isTileDirty(tx, ty);
+  return n;
+}
+
+static uint16_t pattern(int x, int y) {
+  return (uint16_t)(x * 131 + y * 977 + 1);
+}
+
+static void test_mapping_is_one_to_one() {
+  static uint8_t hit[PANEL_HEIGHT][PANEL_WIDTH * PANELS_NUMBER];
+  for (int layout = CHAIN_ROWS; layout <= CHAIN_SERPENTINE; layout++) {
+    for (int rot = ROTATE_0; rot <= ROTATE_270; rot++) {
+      makeCanvas((PanelChainLayout)layout, (PanelRotation)rot);
+      memset(hit, 0, sizeof(hit));
+      for (int y = 0; y < CANVAS_HEIGHT; y++) {
+        for (int x = 0; x < CANVAS_WIDTH; x++) {
+          int16_t px, py;
+          canvas->mapToPhysical(x, y, &px, &py);
+          TEST_ASSERT_TRUE(px >= 0 && px < CHAIN_WIDTH && py >= 0 && py < PANEL_HEIGHT);
+          // no two logical pixels land on the same LED
+          TEST_ASSERT_TRUE(hit[py][px] == 0);
+          hit[py][px] = 1;
+        }
+      }
+    }
+  }
+}
+
+static void test_mapping_known_points() {
+  int16_t px, py;
+  canvas->mapToPhysical(70, 5, &px, &py);            // top right panel, second on the chain
+  TEST_ASSERT_EQUAL(PANEL_WIDTH + 6, px);
+  TEST_ASSERT_EQUAL(5, py);
+  canvas->mapToPhysical(5, 70, &px, &py);            // bottom left, third
+  TEST_ASSERT_EQUAL(2 * PANEL_WIDTH + 5, px);
+  TEST_ASSERT_EQUAL(6, py);
+
+  makeCanvas(CHAIN_SERPENTINE, ROTATE_0);
+  canvas->mapToPhysical(5, 70, &px, &py);            // second row runs back: bottom left is last, upside down
+  TEST_ASSERT_EQUAL(3 * PANEL_WIDTH + (PANEL_WIDTH - 1 - 5), px);
+  TEST_ASSERT_EQUAL(PANEL_HEIGHT - 1 - 6, py);
+  canvas->mapToPhysical(70, 5, &px, &py);            // first row unchanged
+  TEST_ASSERT_EQUAL(PANEL_WIDTH + 6, px);
+  TEST_ASSERT_EQUAL(5, py);
+
+  makeCanvas(CHAIN_ROWS, ROTATE_90);
+  canvas->mapToPhysical(5, 3, &px, &py);
+  TEST_ASSERT_EQUAL(PANEL_WIDTH - 1 - 3, px);
+  TEST_ASSERT_EQUAL(5, py);
+
+  makeCanvas(CHAIN_ROWS, ROTATE_270);
+  canvas->mapToPhysical(5, 3, &px, &py);
+  TEST_ASSERT_EQUAL(3, px);
+  TEST_ASSERT_EQUAL(PANEL_HEIGHT - 1 - 5, py);
+}
+
+static void test_begin_marks_everything() {
+  TEST_ASSERT_EQUAL(CANVAS_TILES_X * CANVAS_TILES_Y, dirtyTiles());
+  canvas->flush();
+  TEST_ASSERT_EQUAL(0, dirtyTiles());
+  TEST_ASSERT_EQUAL_UINT32(CANVAS_WIDTH * CANVAS_HEIGHT, panel->pixelWrites);
+}
+
+static void test_pixel_damages_only_its_tile() {
+  canvas->flush();
+  canvas->drawPixel(9, 17, 0xF800);
+  TEST_ASSERT_EQUAL(1, dirtyTiles());
+  TEST_ASSERT_TRUE(canvas->isTileDirty(1, 2));
+
+  canvas->flush();
+  canvas->drawPixel(9, 17, 0xF800);                   // same color again
+  TEST_ASSERT_EQUAL(0, dirtyTiles());
+
+  canvas->drawPixel(-1, 5, 0xFFFF);                   // off the canvas
+  canvas->drawPixel(CANVAS_WIDTH, 5, 0xFFFF);
+  TEST_ASSERT_EQUAL(0, dirtyTiles());
+}
+
+static void test_fill_damages_covered_tiles() {
+  canvas->flush();
+  canvas->fillRect(-3, -3, 12, 4, 0x07E0);            // clipped to x 0..8, y 0
+  TEST_ASSERT_EQUAL(2, dirtyTiles());
+  TEST_ASSERT_TRUE(canvas->isTileDirty(0, 0));
+  TEST_ASSERT_TRUE(canvas->isTileDirty(1, 0));
+  TEST_ASSERT_EQUAL_HEX16(0x07E0, canvas->getPixel(8, 0));
+  TEST_ASSERT_EQUAL_HEX16(0, canvas->getPixel(9, 0));
+  TEST_ASSERT_EQUAL_HEX16(0, canvas->getPixel(0, 1));
+
+  canvas->flush();
+  canvas->drawFastHLine(0, CANVAS_HEIGHT - 1, CANVAS_WIDTH, 0x001F);   // a whole row of tiles
+  TEST_ASSERT_EQUAL(CANVAS_TILES_X, dirtyTiles());
+  for (int tx = 0; tx < CANVAS_TILES_X; tx++) TEST_ASSERT_TRUE(canvas->isTileDirty(tx, CANVAS_TILES_Y - 1));
+}
+
+static void test_flush_pushes_only_damage() {
+  canvas->flush();
+  uint32_t before = panel->pixelWrites;
+  canvas->flush();
+  TEST_ASSERT_EQUAL_UINT32(before, panel->pixelWrites);
+
+  canvas->drawPixel(100, 100, 0x1234);
+  canvas->drawPixel(101, 101, 0x4321);                // same tile
+  canvas->flush();
+  TEST_ASSERT_EQUAL_UINT32(before + CANVAS_TILE_SIZE * CANVAS_TILE_SIZE, panel->pixelWrites);
+}
+
+static void test_panels_show_the_canvas() {
+  for (int layout = CHAIN_ROWS; layout <= CHAIN_SERPENTINE; layout++) {
+    for (int rot = ROTATE_0; rot <= ROTATE_270; rot++) {
+      makeCanvas((PanelChainLayout)layout, (PanelRotation)rot);
+      for (int y = 0; y < CANVAS_HEIGHT; y++)
+        for (int x = 0; x < CANVAS_WIDTH; x++) canvas->drawPixel(x, y, pattern(x, y));
+      canvas->flush();
+
+      for (int y = 0; y < CANVAS_HEIGHT; y++) {
+        for (int x = 0; x < CANVAS_WIDTH; x++) {
+          int16_t px, py;
+          canvas->mapToPhysical(x, y, &px, &py);
+          TEST_ASSERT_EQUAL_HEX16(pattern(x, y), panel->shown(px, py));
+        }
+      }
+    }
+  }
+}
+
+static void test_scaled_clips_at_edges() {
+  uint16_t img[3 * 2] = {1, 2, 3, 4, 5, 6};
+  canvas->fillScreen(0);
+  canvas->drawScaled(img, 3, 2, 4, CANVAS_WIDTH - 6, -5);
+  for (int y = 0; y < CANVAS_HEIGHT; y++) {
+    for (int x = 0; x < CANVAS_WIDTH; x++) {
+      int sx = (x - (CANVAS_WIDTH - 6)) / 4;
+      int sy = (y + 5) / 4;
+      bool in = x >= CANVAS_WIDTH - 6 && y < 3;
+      TEST_ASSERT_EQUAL_HEX16(in ? img[sy * 3 + sx] : 0, canvas->getPixel(x, y));
+    }
+  }
+
+  canvas->drawScaled(img, 3, 2, 2, 10, 10);           // fully inside goes through the blitter
+  TEST_ASSERT_EQUAL_HEX16(1, canvas->getPixel(11, 11));
+  TEST_ASSERT_EQUAL_HEX16(6, canvas->getPixel(15, 13));
+  TEST_ASSERT_EQUAL_HEX16(0, canvas->getPixel(16, 13));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_mapping_is_one_to_one);
+  RUN_TEST(test_mapping_known_points);
+  RUN_TEST(test_begin_marks_everything);
+  RUN_TEST(test_pixel_damages_only_its_tile);
+  RUN_TEST(test_fill_damages_covered_tiles);
+  RUN_TEST(test_flush_pushes_only_damage);
+  RUN_TEST(test_panels_show_the_canvas);
+  RUN_TEST(test_scaled_clips_at_edges);
+  return UNITY_END();
+}
@@ -0,0 +1,165 @@
+/**
+ * @file test_chess.cpp
+ * @brief chess engine: perft against the published counts, search sanity, and nodes per second
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Perft positions and counts are the standard ones from the Chess Programming Wiki ("Perft Results"): the start
+ * position, "Kiwipete" and positions 3 to 5, which between them cover castling through check, en passant pins and
+ * promotions.
+ *
+ */
+
+#include <unity.h>
+#include "../bench.h"
+#include "Chess/ChessEngine.h"
+
+struct PerftCase {
+  const char* name;
+  const char* fen;
+  int depth;
+  uint64_t nodes[6];                    // [d] is the count at depth d
+};
+
+static const PerftCase PERFT[] = {
+  { "startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5,
+    { 0, 20, 400, 8902, 197281, 4865609 } },
+  { "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4,
+    { 0, 48, 2039, 97862, 4085603 } },
+  { "position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5,
+    { 0, 14, 191, 2812, 43238, 674624 } },
+  { "position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4,
+    { 0, 6, 264, 9467, 422333 } },
+  { "position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4,
+    { 0, 44, 1486, 62379, 2103487 } },
+};
+
+static ChessPosition pos;
+static uint32_t fakeNow;
+static uint32_t yields;
+
+static uint32_t fakeClock() {
+  return fakeNow;
+}
+
+static void countYield() {
+  yields++;
+  fakeNow++;                            // every CHESS_CHECK_NODES nodes "take" 1 ms
+}
+
+void setUp() {
+  fakeNow = 0;
+  yields = 0;
+}
+
+void tearDown() {}
+
+static void test_perft() {
+  for (const PerftCase& c : PERFT) {
+    TEST_ASSERT_TRUE(chessSetFEN(&pos, c.fen));
+    for (int d = 1; d <= c.depth; d++) {
+      uint64_t n = chessPerft(&pos, d);
+      char what[48];
+      snprintf(what, sizeof(what), "%s depth %d", c.name, d);
+      TEST_ASSERT_EQUAL_UINT64_MESSAGE(c.nodes[d], n, what);
+    }
+  }
+}
+
+static void test_perft_leaves_position_unchanged() {
+  chessSetFEN(&pos, PERFT[1].fen);
+  ChessPosition before = pos;
+  chessPerft(&pos, 3);
+  TEST_ASSERT_EQUAL_MEMORY(before.board, pos.board, sizeof(pos.board));
+  TEST_ASSERT_EQUAL_HEX64(before.hash, pos.hash);
+  TEST_ASSERT_EQUAL(before.ply, pos.ply);
+  TEST_ASSERT_EQUAL(before.castling, pos.castling);
+}
+
+static void test_search_finds_mate_in_one() {
+  chessSetFEN(&pos, "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+  ChessSearchLimits limits = { 4, 0, nullptr, nullptr };
+  ChessSearchInfo info;
+  ChessMove m = chessSearch(&pos, limits, &info);
+  TEST_ASSERT_EQUAL_HEX8(CHESS_SQ(3, 0), m.from);
+  TEST_ASSERT_EQUAL_HEX8(CHESS_SQ(3, 7), m.to);
+  TEST_ASSERT_TRUE(chessMakeMove(&pos, m));
+  TEST_ASSERT_EQUAL(CHESS_CHECKMATE, chessGetStatus(&pos));
+}
+
+static bool isLegal(ChessPosition* p, const ChessMove& m) {
+  ChessMove moves[256];
+  int n = chessGenerateLegal(p, moves);
+  for (int i = 0; i < n; i++)
+    if (moves[i].from == m.from && moves[i].to == m.to && moves[i].promo == m.promo) return true;
+  return false;
+}
+
+static void test_search_yields_and_keeps_time() {
+  chessSetFEN(&pos, PERFT[1].fen);
+  ChessSearchLimits limits = { 16, 40, fakeClock, countYield };
+  ChessSearchInfo info;
+  ChessMove m = chessSearch(&pos, limits, &info);
+
+  TEST_ASSERT_TRUE(isLegal(&pos, m));
+  // one yield per CHESS_CHECK_NODES nodes, and the (fake) 40 ms stopped it
+  TEST_ASSERT_UINT_WITHIN(1, info.nodes / CHESS_CHECK_NODES, yields);
+  TEST_ASSERT_INT_WITHIN(1, 40, info.elapsedMs);
+  TEST_ASSERT_LESS_THAN(16, info.depth);
+}
+
+static void stopFromOtherTask() {
+  if (++yields == 3) chessStopSearch();
+}
+
+static void test_stop_request_ends_search() {
+  chessSetFEN(&pos, PERFT[0].fen);
+  ChessPosition before = pos;
+  ChessSearchLimits limits = { 16, 0, nullptr, stopFromOtherTask };
+  ChessSearchInfo info;
+  ChessMove m = chessSearch(&pos, limits, &info);
+
+  TEST_ASSERT_EQUAL(3, yields);
+  TEST_ASSERT_LESS_THAN(4 * CHESS_CHECK_NODES, info.nodes);
+  TEST_ASSERT_TRUE(isLegal(&pos, m));
+  TEST_ASSERT_EQUAL_HEX64(before.hash, pos.hash);      // search restored the position
+  TEST_ASSERT_EQUAL(before.ply, pos.ply);
+}
+
+static void test_benchmark_nodes_per_second() {
+  for (int i = 0; i < 2; i++) {
+    const PerftCase& c = PERFT[i];
+    chessSetFEN(&pos, c.fen);
+    double t0 = benchSeconds();
+    uint64_t n = chessPerft(&pos, c.depth);
+    double t = benchSeconds() - t0;
+    char name[48];
+    snprintf(name, sizeof(name), "perft %s d%d", c.name, c.depth);
+    benchReport(name, (double)n, "node", t);
+  }
+
+  static const int SEARCH[] = { 0, 1, 4 };
+  for (int i : SEARCH) {
+    chessSetFEN(&pos, PERFT[i].fen);
+    ChessSearchLimits limits = { 6, 0, nullptr, nullptr };
+    ChessSearchInfo info;
+    double t0 = benchSeconds();
+    chessSearch(&pos, limits, &info);
+    double t = benchSeconds() - t0;
+    char name[64];
+    snprintf(name, sizeof(name), "search %s d%d (%lu nodes)", PERFT[i].name, info.depth, (unsigned long)info.nodes);
+    benchReport(name, info.nodes, "node", t);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_perft);
+  RUN_TEST(test_perft_leaves_position_unchanged);
+  RUN_TEST(test_search_finds_mate_in_one);
+  RUN_TEST(test_search_yields_and_keeps_time);
+  RUN_TEST(test_stop_request_ends_search);
+  RUN_TEST(test_benchmark_nodes_per_second);
+  return UNITY_END();
+}
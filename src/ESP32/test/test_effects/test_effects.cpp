@@ -0,0 +1,267 @@
+/**
+ * @file test_effects.cpp
+ * @brief fixed point effects: generator, particle and transition behaviour, plus their cost per frame
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The kernels are checked for the properties the screens rely on (sine range and symmetry, a bounded particle pool,
+ * a fire that dies out, transitions that start on the old screen, end on the new one and never flip a pixel back),
+ * then timed at the size they run at on the panel. The home screen test runs the real effect over a layout with text
+ * in it and checks no text pixel is touched.
+ *
+ */
+
+#include <unity.h>
+#include "Effects/Generators.h"
+#include "Effects/Particles.h"
+#include "Effects/Transition.h"
+#include "Effects/HomeEffects.h"
+#include "../bench.h"
+
+#define W CANVAS_WIDTH
+#define H CANVAS_HEIGHT
+
+static uint16_t from[W * H], to[W * H], out[W * H];
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+static MatrixPanel_I2S_DMA* panel;
+static VirtualCanvas* canvas;
+
+void setUp() {
+  seed = 32;
+  for (int i = 0; i < W * H; i++) {
+    from[i] = (uint16_t)(next() | 1);
+    to[i] = (uint16_t)(next() | 1);
+    if (to[i] == from[i]) to[i] ^= 2;
+  }
+  panel = new MatrixPanel_I2S_DMA(HUB75_I2S_CFG(PANEL_WIDTH, PANEL_HEIGHT, PANELS_NUMBER));
+  panel->begin();
+  canvas = new VirtualCanvas(panel, CHAIN_ROWS, ROTATE_0);
+  canvas->begin();
+}
+
+void tearDown() {
+  delete canvas;
+  delete panel;
+}
+
+static void test_sine_range_and_symmetry() {
+  for (int a = 0; a < 256; a++) {
+    TEST_ASSERT_TRUE(fxSin(a) >= -127 && fxSin(a) <= 127);
+    TEST_ASSERT_EQUAL_INT(-fxSin(a), fxSin((uint8_t)(a + 128)));
+    if (a < 64) TEST_ASSERT_TRUE(fxSin(a) <= fxSin(a + 1));       // rising up to the quarter turn
+  }
+  TEST_ASSERT_EQUAL_INT(0, fxSin(0));
+  TEST_ASSERT_EQUAL_INT(127, fxSin(64));
+  TEST_ASSERT_EQUAL_INT(fxSin(32), fxSin(96));
+}
+
+static void test_particle_pool_bounded() {
+  ParticlePool pool;
+  particlesInit(&pool, 64, 99);
+  int spawned = 0;
+  for (int i = 0; i < MAX_PARTICLES + 20; i++) spawned += particlesSpawn(&pool, FX(10), FX(10), 0, 0, 50);
+  TEST_ASSERT_EQUAL_INT(MAX_PARTICLES, spawned);
+  TEST_ASSERT_EQUAL_UINT8(MAX_PARTICLES, pool.active);
+  TEST_ASSERT_FALSE(particlesSpawn(&pool, 0, 0, 0, 0, 10));
+
+  // gravity pulls everything out of the bottom of the box long before the life runs out
+  for (int i = 0; i < 30; i++) particlesStep(&pool, 0, 0, 63, 40);
+  TEST_ASSERT_EQUAL_UINT8(0, pool.active);
+
+  // random traffic: active always matches the live slots
+  for (int step = 0; step < 2000; step++) {
+    for (int n = next() % 4; n > 0; n--) particlesSpawnSpread(&pool, FX(32), FX(60), -FX(1), 96, 40);
+    particlesStep(&pool, 0, 0, 63, 63);
+    int live = 0;
+    for (int i = 0; i < MAX_PARTICLES; i++) live += pool.particles[i].life != 0;
+    TEST_ASSERT_EQUAL_INT(live, pool.active);
+  }
+}
+
+static void test_particles_deterministic() {
+  ParticlePool a, b;
+  particlesInit(&a, 6, 1234);
+  particlesInit(&b, 6, 1234);
+  for (int step = 0; step < 500; step++) {
+    particlesSpawnSpread(&a, FX(32), FX(60), -FX(1), 48, 40);
+    particlesSpawnSpread(&b, FX(32), FX(60), -FX(1), 48, 40);
+    particlesStep(&a, 0, 0, 63, 63);
+    particlesStep(&b, 0, 0, 63, 63);
+  }
+  TEST_ASSERT_EQUAL_UINT32(a.rng, b.rng);
+  TEST_ASSERT_EQUAL_UINT8(a.active, b.active);
+  for (int i = 0; i < MAX_PARTICLES; i++) {
+    TEST_ASSERT_EQUAL_UINT8(a.particles[i].life, b.particles[i].life);
+    if (!a.particles[i].life) continue;
+    TEST_ASSERT_EQUAL_INT32(a.particles[i].x, b.particles[i].x);
+    TEST_ASSERT_EQUAL_INT32(a.particles[i].y, b.particles[i].y);
+    TEST_ASSERT_EQUAL_INT16(a.particles[i].vx, b.particles[i].vx);
+    TEST_ASSERT_EQUAL_INT16(a.particles[i].vy, b.particles[i].vy);
+  }
+}
+
+static void test_fire_bounded_and_dies_out() {
+  static uint8_t heat[8 * W];
+  memset(heat, 0, sizeof(heat));
+  uint32_t rng = 7;
+  for (int i = 0; i < 200; i++) fireStep(heat, W, 8, &rng, 20, true);
+  int hot = 0;
+  for (int i = 0; i < 8 * W; i++) {
+    TEST_ASSERT_TRUE(heat[i] < FIRE_LEVELS);
+    hot += heat[i] > 0;
+  }
+  TEST_ASSERT_TRUE(hot > 4 * W);
+
+  for (int i = 0; i < 8 + FIRE_LEVELS; i++) fireStep(heat, W, 8, &rng, 20, false);
+  for (int i = 0; i < 8 * W; i++) TEST_ASSERT_EQUAL_UINT8(0, heat[i]);
+}
+
+static void test_transition_ends_and_never_flips_back() {
+  for (int type = TRANSITION_WIPE; type <= TRANSITION_SLIDE; type++) {
+    transitionCompose(out, W, from, to, W, W, H, (TransitionType)type, 0);
+    TEST_ASSERT_EQUAL_MEMORY(from, out, sizeof(out));
+    transitionCompose(out, W, from, to, W, W, H, (TransitionType)type, TRANSITION_FULL);
+    TEST_ASSERT_EQUAL_MEMORY(to, out, sizeof(out));
+  }
+
+  // wipe and dissolve: once a pixel shows the new screen it keeps showing it, and the share follows the progress
+  static bool shown[W * H];
+  for (int type = TRANSITION_WIPE; type <= TRANSITION_DISSOLVE; type++) {
+    memset(shown, 0, sizeof(shown));
+    for (int p = 0; p <= TRANSITION_FULL; p += 8) {
+      transitionCompose(out, W, from, to, W, W, H, (TransitionType)type, p);
+      int n = 0;
+      for (int i = 0; i < W * H; i++) {
+        TEST_ASSERT_TRUE(out[i] == from[i] || out[i] == to[i]);
+        if (shown[i]) TEST_ASSERT_EQUAL_HEX16(to[i], out[i]);
+        shown[i] = out[i] == to[i];
+        n += shown[i];
+      }
+      int expected = W * H * p / TRANSITION_FULL;
+      TEST_ASSERT_INT_WITHIN(W * H / 16, expected, n);
+    }
+  }
+
+  // slide: the new screen comes in from the right, the old one moves left
+  transitionCompose(out, W, from, to, W, W, H, TRANSITION_SLIDE, TRANSITION_FULL / 4);
+  int split = W / 4;
+  for (int y = 0; y < H; y++) {
+    TEST_ASSERT_EQUAL_HEX16(from[y * W + split], out[y * W]);
+    TEST_ASSERT_EQUAL_HEX16(to[y * W], out[y * W + W - split]);
+  }
+}
+
+// the driver animates the canvas over TRANSITION_MS and lands exactly on the incoming screen
+static void test_transition_driver() {
+  TEST_ASSERT_TRUE(transitionInit());
+  memcpy(canvas->getBuffer(), from, sizeof(from));
+  transitionCapture(canvas);
+  memcpy(canvas->getBuffer(), to, sizeof(to));
+  transitionStart(canvas, TRANSITION_WIPE, 1000);
+  TEST_ASSERT_TRUE(transitionActive());
+  TEST_ASSERT_EQUAL_MEMORY(from, canvas->getBuffer(), sizeof(from));
+
+  transitionUpdate(1000 + TRANSITION_MS / 2);
+  TEST_ASSERT_EQUAL_HEX16(to[0], canvas->getBuffer()[0]);
+  TEST_ASSERT_EQUAL_HEX16(from[W - 1], canvas->getBuffer()[W - 1]);
+
+  transitionUpdate(1000 + TRANSITION_MS);
+  TEST_ASSERT_FALSE(transitionActive());
+  TEST_ASSERT_EQUAL_MEMORY(to, canvas->getBuffer(), sizeof(to));
+
+  // input in the middle jumps to the end
+  transitionCapture(canvas);
+  memcpy(canvas->getBuffer(), from, sizeof(from));
+  transitionStart(canvas, TRANSITION_DISSOLVE, 5000);
+  transitionFinish();
+  TEST_ASSERT_FALSE(transitionActive());
+  TEST_ASSERT_EQUAL_MEMORY(from, canvas->getBuffer(), sizeof(from));
+}
+
+// sparks only ever land on black, and text on the home screen is left alone
+static void test_home_effects_leave_text_alone() {
+  const int navbar = 12;
+  uint16_t* buf = canvas->getBuffer();
+  memset(buf, 0, W * H * sizeof(uint16_t));
+  for (int y = navbar + 1; y < H - 6; y++) {
+    for (int x = 0; x < W; x++) {
+      if ((next() % 5) == 0) buf[y * W + x] = 0xFFFF;
+    }
+  }
+  memcpy(from, buf, sizeof(from));
+
+  homeEffectsReset(canvas, navbar, 0);
+  for (unsigned long t = 33; t < 33 * 600; t += 33) homeEffectsUpdate(t);
+
+  int sparks = 0;
+  for (int y = navbar + 1; y < H - 6; y++) {
+    for (int x = 0; x < W; x++) {
+      if (from[y * W + x]) TEST_ASSERT_EQUAL_HEX16(0xFFFF, buf[y * W + x]);
+      else sparks += buf[y * W + x] != 0;
+    }
+  }
+  TEST_ASSERT_TRUE(sparks > 0);
+}
+
+static void test_effect_speed() {
+  static uint16_t pal[PLASMA_PALETTE_SIZE];
+  static uint8_t heat[6 * W];
+  char name[64];
+  int frames = 2000;
+
+  plasmaPalette(pal);
+  double t0 = benchSeconds();
+  for (int i = 0; i < frames; i++) plasmaRender(out, W, W, H, i, pal);
+  benchReport("plasma full canvas", frames, "frame", benchSeconds() - t0);
+
+  firePalette(pal);
+  uint32_t rng = 1;
+  t0 = benchSeconds();
+  for (int i = 0; i < frames * 10; i++) {
+    fireStep(heat, W, 6, &rng, 20, true);
+    fireRender(out, W, heat, W, 6, pal);
+  }
+  benchReport("fire band step + render", frames * 10, "frame", benchSeconds() - t0);
+
+  ParticlePool pool;
+  particlesInit(&pool, 6, 3);
+  t0 = benchSeconds();
+  for (int i = 0; i < frames * 50; i++) {
+    while (particlesSpawnSpread(&pool, FX(64), FX(120), -FX(2), 96, 60)) {}
+    particlesStep(&pool, 0, 0, W - 1, H - 1);
+  }
+  benchReport("full particle pool step", frames * 50, "frame", benchSeconds() - t0);
+
+  const char* names[] = { "wipe", "dissolve", "slide" };
+  for (int type = TRANSITION_WIPE; type <= TRANSITION_SLIDE; type++) {
+    t0 = benchSeconds();
+    for (int i = 0; i < frames; i++) transitionCompose(out, W, from, to, W, W, H, (TransitionType)type, i & 255);
+    snprintf(name, sizeof(name), "%s transition frame", names[type]);
+    benchReport(name, frames, "frame", benchSeconds() - t0);
+  }
+
+  homeEffectsReset(canvas, 12, 0);
+  t0 = benchSeconds();
+  for (int i = 1; i <= frames * 5; i++) homeEffectsUpdate(i * 33);
+  benchReport("home screen effect frame", frames * 5, "frame", benchSeconds() - t0);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_sine_range_and_symmetry);
+  RUN_TEST(test_particle_pool_bounded);
+  RUN_TEST(test_particles_deterministic);
+  RUN_TEST(test_fire_bounded_and_dies_out);
+  RUN_TEST(test_transition_ends_and_never_flips_back);
+  RUN_TEST(test_transition_driver);
+  RUN_TEST(test_home_effects_leave_text_alone);
+  RUN_TEST(test_effect_speed);
+  return UNITY_END();
+}
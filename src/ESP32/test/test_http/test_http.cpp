@@ -0,0 +1,429 @@
+/**
+ * @file test_http.cpp
+ * @brief HTTP handlers over a loopback socket pair: uploads, canvas downloads (PNG decoded independently), errors
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The client side writes a whole request into one end of a socketpair and closes it for writing, httpServe() answers
+ * on the other end, and the response is read back and parsed. The server's socket hands out at most a few bytes per
+ * read when asked to, so request lines, headers and chunk framing get split at every possible place.
+ *
+ * The PNG check does not trust the encoder: chunk CRCs, the zlib header, the stored block lengths and the Adler-32 are
+ * all recomputed here, and every decoded pixel is compared with the canvas.
+ *
+ */
+
+#include <unity.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "Net/HttpServer.h"
+#include "Net/PngEncoder.h"
+#include "PixelArt/Animation.h"
+#include "../bench.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+class FdSocket : public Socket {
+public:
+  int fd;
+  uint32_t maxRead;                     // 0 = whatever is there
+
+  FdSocket(int f, uint32_t most) : fd(f), maxRead(most) {}
+
+  int32_t read(uint8_t* dst, uint32_t len) override {
+    if (maxRead && len > maxRead) len = maxRead;
+    return recv(fd, dst, len, 0);
+  }
+
+  bool write(const uint8_t* src, uint32_t len) override {
+    while (len) {
+      ssize_t n = send(fd, src, len, 0);
+      if (n <= 0) return false;
+      src += n;
+      len -= n;
+    }
+    return true;
+  }
+};
+
+// files in memory, only visible once finished
+class MemorySink : public AssetSink {
+public:
+  std::map<std::string, Bytes> files;
+  std::string path;
+  Bytes pending;
+  bool open = false;
+  int aborts = 0;
+  uint32_t room = 1 << 30;              // bytes that fit before the "flash" is full
+
+  bool begin(const char* p) override {
+    path = p;
+    pending.clear();
+    open = true;
+    return true;
+  }
+  bool write(const uint8_t* src, uint32_t len) override {
+    if (!open || pending.size() + len > room) return false;
+    pending.insert(pending.end(), src, src + len);
+    return true;
+  }
+  bool finish() override {
+    if (!open) return false;
+    files[path] = pending;
+    open = false;
+    return true;
+  }
+  void abort() override {
+    open = false;
+    aborts++;
+  }
+};
+
+struct Response {
+  int status = 0;
+  std::map<std::string, std::string> headers;
+  Bytes body;
+};
+
+static MemorySink* sink;
+static HttpContext ctx;
+static std::vector<std::string> storedNames;
+static bool acceptUploads;
+static uint32_t seed;
+static uint32_t fragment;               // max bytes per server read, 0 = no limit
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+static bool accept(AssetType, const char*) {
+  return acceptUploads;
+}
+
+static void stored(AssetType, const char* name, const char*) {
+  storedNames.push_back(name);
+}
+
+// send a request, let the server answer it, return the raw response bytes
+static Bytes exchange(const std::string& request) {
+  int fds[2];
+  TEST_ASSERT_EQUAL_INT(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  int big = 1 << 20;
+  setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &big, sizeof(big));
+  setsockopt(fds[1], SOL_SOCKET, SO_SNDBUF, &big, sizeof(big));
+
+  FdSocket client(fds[0], 0);
+  TEST_ASSERT_TRUE(client.write((const uint8_t*)request.data(), request.size()));
+  shutdown(fds[0], SHUT_WR);
+
+  FdSocket server(fds[1], fragment);
+  httpServe(server, ctx);
+  close(fds[1]);
+
+  Bytes out;
+  uint8_t buf[4096];
+  ssize_t n;
+  while ((n = recv(fds[0], buf, sizeof(buf), 0)) > 0) out.insert(out.end(), buf, buf + n);
+  close(fds[0]);
+  return out;
+}
+
+static Response parse(const Bytes& raw) {
+  Response r;
+  std::string text(raw.begin(), raw.end());
+  size_t end = text.find("\r\n\r\n");
+  TEST_ASSERT_TRUE_MESSAGE(end != std::string::npos, "no end of headers");
+  TEST_ASSERT_EQUAL_INT(0, text.compare(0, 9, "HTTP/1.1 "));
+  r.status = atoi(text.c_str() + 9);
+  size_t pos = text.find("\r\n") + 2;
+  while (pos < end) {
+    size_t eol = text.find("\r\n", pos);
+    std::string line = text.substr(pos, eol - pos);
+    size_t colon = line.find(':');
+    r.headers[line.substr(0, colon)] = line.substr(colon + 2);
+    pos = eol + 2;
+  }
+  r.body.assign(raw.begin() + end + 4, raw.end());
+  TEST_ASSERT_EQUAL_UINT32(strtoul(r.headers["Content-Length"].c_str(), nullptr, 10), r.body.size());
+  return r;
+}
+
+static Response request(const std::string& req) {
+  return parse(exchange(req));
+}
+
+// a small valid animation file of a given total size
+static Bytes animFile(uint32_t size) {
+  Bytes b = { 'A', 'N', ANIM_VERSION, 4, 4, 1, 1, 0, 0xFF, 0xFF };
+  while (b.size() < size) b.push_back(next());
+  b.resize(size);
+  return b;
+}
+
+static std::string put(const std::string& path, const Bytes& body, const std::string& extra = "") {
+  return "PUT " + path + " HTTP/1.1\r\nHost: console.local\r\nContent-Length: " + std::to_string(body.size()) +
+         "\r\n" + extra + "\r\n" + std::string(body.begin(), body.end());
+}
+
+static std::string putChunked(const std::string& path, const Bytes& body) {
+  std::string req = "PUT " + path + " HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\n";
+  for (size_t i = 0; i < body.size();) {
+    size_t n = std::min<size_t>(1 + next() % 700, body.size() - i);
+    char size[32];
+    snprintf(size, sizeof(size), (next() & 1) ? "%zx\r\n" : "%zX;ext=1\r\n", n);
+    req += size + std::string(body.begin() + i, body.begin() + i + n) + "\r\n";
+    i += n;
+  }
+  return req + "0\r\nX-Trailer: 1\r\n\r\n";
+}
+
+void setUp() {
+  seed = 36;
+  fragment = 0;
+  sink = new MemorySink();
+  storedNames.clear();
+  acceptUploads = true;
+  ctx = HttpContext();
+  ctx.sink = sink;
+  ctx.accept = accept;
+  ctx.stored = stored;
+}
+
+void tearDown() {
+  delete sink;
+}
+
+static void test_upload_with_length() {
+  for (uint32_t limit : { 0u, 1u, 3u, 7u, 64u }) {
+    fragment = limit;
+    Bytes file = animFile(3000 + limit);
+    // the 100 Continue comes first, the real answer after it
+    Bytes raw = exchange(put("/assets/image/heart", file, "Expect: 100-continue\r\n"));
+    static const char CONTINUE[] = "HTTP/1.1 100 Continue\r\n\r\n";
+    TEST_ASSERT_TRUE(raw.size() > sizeof(CONTINUE) && !memcmp(raw.data(), CONTINUE, sizeof(CONTINUE) - 1));
+    TEST_ASSERT_EQUAL_INT(201, parse(Bytes(raw.begin() + sizeof(CONTINUE) - 1, raw.end())).status);
+    TEST_ASSERT_TRUE(sink->files["/img/heart.anim"] == file);
+  }
+  Response r = request(put("/assets/anim/walk", animFile(10)));
+  TEST_ASSERT_EQUAL_INT(201, r.status);
+  TEST_ASSERT_TRUE(sink->files.count("/img/walk.anim"));
+  TEST_ASSERT_EQUAL_STRING("walk", storedNames.back().c_str());
+}
+
+static void test_upload_chunked() {
+  for (uint32_t limit : { 0u, 1u, 2u, 5u, 13u }) {
+    fragment = limit;
+    Bytes file = animFile(2000 + next() % 9000);
+    Response r = request(putChunked("/assets/anim/pac", file));
+    TEST_ASSERT_EQUAL_INT(201, r.status);
+    TEST_ASSERT_TRUE(sink->files["/img/pac.anim"] == file);
+  }
+  TEST_ASSERT_EQUAL_INT(5, storedNames.size());
+}
+
+// every refusal answers with its status and leaves nothing behind
+static void test_upload_errors() {
+  Bytes file = animFile(100);
+  TEST_ASSERT_EQUAL_INT(400, request(put("/assets/image/bad.name", file)).status);
+  TEST_ASSERT_EQUAL_INT(400, request(put("/assets/image/much_too_long_a_name", file)).status);
+  TEST_ASSERT_EQUAL_INT(411, request("PUT /assets/image/x HTTP/1.1\r\n\r\n").status);
+  TEST_ASSERT_EQUAL_INT(413, request(put("/assets/image/x", animFile(HTTP_MAX_UPLOAD + 1))).status);
+  TEST_ASSERT_EQUAL_INT(413, request(putChunked("/assets/image/x", animFile(HTTP_MAX_UPLOAD + 1))).status);
+  TEST_ASSERT_EQUAL_INT(405, request("GET /assets/image/x HTTP/1.1\r\n\r\n").status);
+  TEST_ASSERT_EQUAL_INT(404, request(put("/assets/font/x", file)).status);
+
+  Bytes notAnim = file;
+  notAnim[1] = 'X';
+  TEST_ASSERT_EQUAL_INT(415, request(put("/assets/image/x", notAnim)).status);
+  TEST_ASSERT_EQUAL_INT(415, request(put("/assets/image/x", Bytes(file.begin(), file.begin() + 5))).status);
+
+  acceptUploads = false;
+  TEST_ASSERT_EQUAL_INT(409, request(put("/assets/image/x", file)).status);
+  acceptUploads = true;
+
+  sink->room = 50;
+  TEST_ASSERT_EQUAL_INT(507, request(put("/assets/image/x", file)).status);
+  sink->room = 1 << 30;
+
+  // the client goes away half way through: nothing stored and nobody to answer
+  std::string cut = put("/assets/image/x", animFile(4000));
+  TEST_ASSERT_EQUAL_INT(0, exchange(cut.substr(0, cut.size() - 1000)).size());
+  std::string chunkCut = putChunked("/assets/image/x", animFile(4000));
+  TEST_ASSERT_EQUAL_INT(0, exchange(chunkCut.substr(0, chunkCut.size() - 20)).size());
+
+  TEST_ASSERT_EQUAL_INT(0, sink->files.size());
+  TEST_ASSERT_EQUAL_INT(0, storedNames.size());
+  TEST_ASSERT_EQUAL_INT(6, sink->aborts);               // chunked 413, 415 x2, 507 and the two cut uploads
+}
+
+static void test_other_requests() {
+  TEST_ASSERT_EQUAL_INT(200, request("GET / HTTP/1.1\r\n\r\n").status);
+  TEST_ASSERT_EQUAL_INT(404, request("GET /nothing HTTP/1.1\r\n\r\n").status);
+  TEST_ASSERT_EQUAL_INT(503, request("GET /canvas.png HTTP/1.1\r\n\r\n").status);    // no canvas set
+  TEST_ASSERT_EQUAL_INT(503, request("GET /sketches HTTP/1.1\r\n\r\n").status);      // no source set
+  TEST_ASSERT_EQUAL_INT(400, request("GARBAGE\r\n\r\n").status);
+  TEST_ASSERT_EQUAL_INT(431, request("GET / HTTP/1.1\r\nX-Long: " + std::string(300, 'a') + "\r\n\r\n").status);
+}
+
+// ---------- PNG ---------- //
+
+static uint32_t crc32(const uint8_t* p, size_t n, uint32_t crc = 0xFFFFFFFF) {
+  while (n--) {
+    crc ^= *p++;
+    for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+  }
+  return crc;
+}
+
+static uint32_t be32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static uint8_t to8(uint16_t v, int bits) {
+  return bits == 5 ? (v << 3) | (v >> 2) : (v << 2) | (v >> 4);
+}
+
+// decode a PNG as written by the encoder (8 bit palette or RGB, stored deflate blocks) and compare with the image
+static void checkPng(const Bytes& file, const uint16_t* pixels, int w, int h, int stride, bool expectPalette) {
+  static const uint8_t SIG[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  TEST_ASSERT_EQUAL_MEMORY(SIG, file.data(), 8);
+
+  Bytes idat, plte;
+  int colorType = -1;
+  size_t pos = 8;
+  bool ended = false;
+  while (pos + 12 <= file.size() && !ended) {
+    uint32_t len = be32(&file[pos]);
+    std::string type(file.begin() + pos + 4, file.begin() + pos + 8);
+    const uint8_t* data = &file[pos + 8];
+    TEST_ASSERT_TRUE(pos + 12 + len <= file.size());
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(~crc32(&file[pos + 4], len + 4), be32(data + len), type.c_str());
+    if (type == "IHDR") {
+      TEST_ASSERT_EQUAL_UINT32(w, be32(data));
+      TEST_ASSERT_EQUAL_UINT32(h, be32(data + 4));
+      TEST_ASSERT_EQUAL_INT(8, data[8]);
+      colorType = data[9];
+    }
+    else if (type == "PLTE") plte.assign(data, data + len);
+    else if (type == "IDAT") idat.insert(idat.end(), data, data + len);
+    else if (type == "IEND") ended = true;
+    pos += 12 + len;
+  }
+  TEST_ASSERT_TRUE(ended);
+  TEST_ASSERT_EQUAL_UINT32(file.size(), pos);
+  TEST_ASSERT_EQUAL_INT(expectPalette ? 3 : 2, colorType);
+
+  // zlib: header, stored blocks only, Adler-32 of the raw data
+  TEST_ASSERT_EQUAL_INT(0, ((idat[0] << 8) | idat[1]) % 31);
+  Bytes raw;
+  size_t p = 2;
+  bool final = false;
+  while (!final) {
+    final = idat[p] & 1;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, (idat[p] >> 1) & 3, "only stored blocks expected");
+    uint16_t len = idat[p + 1] | (idat[p + 2] << 8);
+    uint16_t nlen = idat[p + 3] | (idat[p + 4] << 8);
+    TEST_ASSERT_EQUAL_HEX16((uint16_t)~len, nlen);
+    raw.insert(raw.end(), idat.begin() + p + 5, idat.begin() + p + 5 + len);
+    p += 5 + len;
+  }
+  uint32_t a = 1, b = 0;
+  for (uint8_t v : raw) {
+    a = (a + v) % 65521;
+    b = (b + a) % 65521;
+  }
+  TEST_ASSERT_EQUAL_HEX32((b << 16) | a, be32(&idat[p]));
+  TEST_ASSERT_EQUAL_UINT32(idat.size(), p + 4);
+
+  int bpp = expectPalette ? 1 : 3;
+  TEST_ASSERT_EQUAL_UINT32((size_t)h * (1 + w * bpp), raw.size());
+  for (int y = 0; y < h; y++) {
+    const uint8_t* row = &raw[y * (1 + w * bpp)];
+    TEST_ASSERT_EQUAL_INT(0, row[0]);
+    for (int x = 0; x < w; x++) {
+      uint16_t c = pixels[y * stride + x];
+      const uint8_t* rgb = expectPalette ? &plte[3 * row[1 + x]] : &row[1 + 3 * x];
+      if (expectPalette) TEST_ASSERT_TRUE(row[1 + x] * 3u < plte.size());
+      TEST_ASSERT_EQUAL_UINT8(to8(c >> 11, 5), rgb[0]);
+      TEST_ASSERT_EQUAL_UINT8(to8((c >> 5) & 0x3F, 6), rgb[1]);
+      TEST_ASSERT_EQUAL_UINT8(to8(c & 0x1F, 5), rgb[2]);
+    }
+  }
+}
+
+static void setCanvas(std::vector<uint16_t>& pixels, int w, int h, int stride, int colors) {
+  std::vector<uint16_t> palette;
+  for (int i = 0; i < colors; i++) palette.push_back(next());
+  pixels.assign(stride * h, 0xDEAD);
+  for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++) pixels[y * stride + x] = colors ? palette[next() % colors] : (uint16_t)next();
+  ctx.pixels = pixels.data();
+  ctx.width = w;
+  ctx.height = h;
+  ctx.stride = stride;
+}
+
+static void test_canvas_png() {
+  std::vector<uint16_t> pixels;
+  // palette (every sketch), the palette limit exactly, and RGB big enough for more than one stored block
+  const int CASES[][4] = { { 128, 128, 128, 16 }, { 37, 19, 40, 256 }, { 160, 140, 160, 0 }, { 1, 1, 1, 1 } };
+  for (auto& c : CASES) {
+    setCanvas(pixels, c[0], c[1], c[2], c[3]);
+    Response r = request("GET /canvas.png HTTP/1.1\r\n\r\n");
+    TEST_ASSERT_EQUAL_INT(200, r.status);
+    TEST_ASSERT_EQUAL_STRING("image/png", r.headers["Content-Type"].c_str());
+    checkPng(r.body, pixels.data(), c[0], c[1], c[2], c[3] != 0);
+  }
+}
+
+static void test_canvas_raw() {
+  std::vector<uint16_t> pixels;
+  setCanvas(pixels, 131, 67, 140, 0);
+  Response r = request("GET /canvas.raw HTTP/1.1\r\n\r\n");
+  TEST_ASSERT_EQUAL_INT(200, r.status);
+  TEST_ASSERT_EQUAL_STRING("131", r.headers["X-Width"].c_str());
+  TEST_ASSERT_EQUAL_STRING("67", r.headers["X-Height"].c_str());
+  for (int y = 0; y < 67; y++)
+    for (int x = 0; x < 131; x++) {
+      size_t i = 2 * (y * 131 + x);
+      TEST_ASSERT_EQUAL_HEX16(pixels[y * 140 + x], r.body[i] | (r.body[i + 1] << 8));
+    }
+}
+
+static void test_throughput() {
+  std::vector<uint16_t> pixels;
+  setCanvas(pixels, 128, 128, 128, 16);
+  int n = 300;
+  double t0 = benchSeconds();
+  for (int i = 0; i < n; i++) exchange("GET /canvas.png HTTP/1.1\r\n\r\n");
+  benchReport("canvas.png 128x128 over loopback", n, "request", benchSeconds() - t0);
+
+  static PngEncoder png;
+  uint32_t size = 0;
+  t0 = benchSeconds();
+  for (int i = 0; i < n; i++) size = pngBegin(&png, pixels.data(), 128, 128, 128);
+  benchReport("PNG palette pass 128x128", n, "image", benchSeconds() - t0);
+  TEST_ASSERT_TRUE(size > 128 * 128);
+
+  std::string up = put("/assets/image/bench", animFile(30000));
+  t0 = benchSeconds();
+  for (int i = 0; i < n; i++) exchange(up);
+  benchReport("30 KB upload over loopback", n * 30000.0, "B", benchSeconds() - t0);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_upload_with_length);
+  RUN_TEST(test_upload_chunked);
+  RUN_TEST(test_upload_errors);
+  RUN_TEST(test_other_requests);
+  RUN_TEST(test_canvas_png);
+  RUN_TEST(test_canvas_raw);
+  RUN_TEST(test_throughput);
+  return UNITY_END();
+}
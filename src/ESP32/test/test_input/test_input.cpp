@@ -0,0 +1,286 @@
+/**
+ * @file test_input.cpp
+ * @brief input mapping: command lookup, config file, chord windows and hold / repeat timing
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Time is whatever the test says it is (inputEvent() and inputPoll() take now as an argument), so the chord window and
+ * the repeat rate are checked at exactly the millisecond they change, and long random streams are checked against the
+ * rules they have to follow rather than against a copy of the code.
+ *
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include <map>
+#include "Input/InputMap.h"
+#include "../bench.h"
+
+enum { A_NONE, A_LEFT, A_RIGHT, A_UP, A_CLEAR, A_SELECT, A_COUNT };
+static const char* const ACTIONS[A_COUNT] = { "none", "left", "right", "up", "clear", "select" };
+
+static const InputBinding DEFAULTS[] = {
+  { IN_RPG1_CW, IN_NONE, A_RIGHT, 0 },
+  { IN_RPG1_CCW, IN_NONE, A_LEFT, 0 },
+  { IN_JOY1_UP, IN_NONE, A_UP, 200 },
+  { IN_C1A, IN_NONE, A_SELECT, 0 },
+  { IN_C1B, IN_NONE, A_LEFT, 0 },
+  { IN_C1A, IN_C1B, A_CLEAR, 0 },
+};
+
+// files held in memory
+class MemSource : public AssetSource {
+public:
+  std::map<std::string, std::string> files;
+
+  int32_t fileSize(const char* path) override {
+    auto f = files.find(path);
+    return f == files.end() ? -1 : (int32_t)f->second.size();
+  }
+
+  int32_t read(const char* path, uint32_t offset, uint8_t* dst, uint32_t len) override {
+    auto f = files.find(path);
+    if (f == files.end() || offset > f->second.size()) return -1;
+    uint32_t n = std::min<uint32_t>(len, f->second.size() - offset);
+    memcpy(dst, f->second.data() + offset, n);
+    return n;
+  }
+};
+
+static InputProfile profile;
+static InputMapper mapper;
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+void setUp() {
+  seed = 38;
+  inputProfileInit(&profile, "test", ACTIONS, A_COUNT, DEFAULTS, sizeof(DEFAULTS) / sizeof(DEFAULTS[0]));
+  inputMapperInit(&mapper, &profile);
+}
+
+void tearDown() {}
+
+static void test_command_lookup() {
+  for (int code = 1; code < IN_COUNT; code++) {
+    TEST_ASSERT_EQUAL_UINT8(code, inputCode(inputName(code)));
+  }
+  TEST_ASSERT_EQUAL_UINT8(IN_NONE, inputCode("powerOFF"));
+  TEST_ASSERT_EQUAL_UINT8(IN_NONE, inputCode(""));
+  TEST_ASSERT_EQUAL_UINT8(IN_NONE, inputCode("rpg1C"));
+  TEST_ASSERT_EQUAL_UINT8(IN_NONE, inputCode("joystick1UPx"));
+  TEST_ASSERT_EQUAL_STRING("", inputName(IN_COUNT));
+}
+
+static void test_profile_and_config() {
+  TEST_ASSERT_EQUAL_UINT8(A_RIGHT, profile.action[IN_RPG1_CW]);
+  TEST_ASSERT_EQUAL_UINT16(200, profile.repeatMs[IN_JOY1_UP]);
+  TEST_ASSERT_EQUAL_INT(1, profile.chordCount);
+  TEST_ASSERT_EQUAL_HEX32((1u << IN_C1A) | (1u << IN_C1B), profile.chordMask);
+  TEST_ASSERT_EQUAL_HEX32((1u << IN_RPG1_CW) | (1u << IN_RPG1_CCW) | (1u << IN_JOY1_UP) | (1u << IN_C1A) | (1u << IN_C1B),
+                          inputProfileInputs(&profile));
+
+  MemSource fs;
+  InputProfile* profiles[] = { &profile };
+  TEST_ASSERT_EQUAL_INT(-1, inputLoadConfig(&fs, INPUT_CONFIG_PATH, profiles, 1));
+
+  fs.files[INPUT_CONFIG_PATH] =
+    "# comment\n"
+    "test   rpg1CW                 left\r\n"
+    "test   joystick1UP            up      50\n"
+    "test   controller1B+controller1A  none\n"      // removes the chord, either order
+    "test   btnUpArrow+btnDownArrow    clear\n"
+    "other  rpg1CW                 left\n"          // unknown program
+    "test   rpg9CW                 left\n"          // unknown input
+    "test   rpg1CCW                jump\n"          // unknown action
+    "test   rpg1CCW+nothing        clear\n"
+    "test   rpg1CCW\n"
+    "\n";
+  TEST_ASSERT_EQUAL_INT(4, inputLoadConfig(&fs, INPUT_CONFIG_PATH, profiles, 1));
+  TEST_ASSERT_EQUAL_UINT8(A_LEFT, profile.action[IN_RPG1_CW]);
+  TEST_ASSERT_EQUAL_UINT8(A_LEFT, profile.action[IN_RPG1_CCW]);
+  TEST_ASSERT_EQUAL_UINT16(50, profile.repeatMs[IN_JOY1_UP]);
+  TEST_ASSERT_EQUAL_INT(1, profile.chordCount);
+  TEST_ASSERT_EQUAL_HEX32((1u << IN_UP_ARROW) | (1u << IN_DOWN_ARROW), profile.chordMask);
+
+  // chords are limited, the one past the limit is refused
+  for (int i = 0; i < INPUT_MAX_CHORDS - 1; i++) TEST_ASSERT_TRUE(inputBind(&profile, IN_C2A, IN_RPG2_CW + i, A_CLEAR, 0));
+  TEST_ASSERT_FALSE(inputBind(&profile, IN_C2B, IN_RPG1_CW, A_CLEAR, 0));
+  TEST_ASSERT_FALSE(inputBind(&profile, IN_NONE, IN_NONE, A_UP, 0));
+  TEST_ASSERT_FALSE(inputBind(&profile, IN_C2B, IN_NONE, A_COUNT, 0));
+
+  // the shipped file only has examples, it changes nothing
+  FILE* f = fopen("data/input.cfg", "rb");
+  TEST_ASSERT_NOT_NULL(f);
+  char text[INPUT_CONFIG_MAX_BYTES];
+  size_t len = fread(text, 1, sizeof(text), f);
+  fclose(f);
+  fs.files[INPUT_CONFIG_PATH] = std::string(text, len);
+  TEST_ASSERT_EQUAL_INT(0, inputLoadConfig(&fs, INPUT_CONFIG_PATH, profiles, 1));
+}
+
+static void test_chord_window() {
+  uint8_t out[2];
+
+  // inputs in no chord come out right away
+  TEST_ASSERT_EQUAL_INT(1, inputEvent(&mapper, IN_RPG1_CW, 1000, out));
+  TEST_ASSERT_EQUAL_UINT8(A_RIGHT, out[0]);
+
+  // partner at the last millisecond of the window: the chord, in either order
+  TEST_ASSERT_EQUAL_INT(0, inputEvent(&mapper, IN_C1A, 2000, out));
+  TEST_ASSERT_EQUAL_INT(0, inputPoll(&mapper, 2000 + INPUT_CHORD_MS - 1, out));
+  TEST_ASSERT_EQUAL_INT(1, inputEvent(&mapper, IN_C1B, 2000 + INPUT_CHORD_MS - 1, out));
+  TEST_ASSERT_EQUAL_UINT8(A_CLEAR, out[0]);
+  TEST_ASSERT_EQUAL_INT(0, inputEvent(&mapper, IN_C1B, 3000, out));
+  TEST_ASSERT_EQUAL_INT(1, inputEvent(&mapper, IN_C1A, 3010, out));
+  TEST_ASSERT_EQUAL_UINT8(A_CLEAR, out[0]);
+
+  // partner one millisecond late: two plain presses, first one first
+  TEST_ASSERT_EQUAL_INT(0, inputEvent(&mapper, IN_C1A, 4000, out));
+  TEST_ASSERT_EQUAL_INT(1, inputEvent(&mapper, IN_C1B, 4000 + INPUT_CHORD_MS, out));
+  TEST_ASSERT_EQUAL_UINT8(A_SELECT, out[0]);
+  TEST_ASSERT_EQUAL_INT(1, inputPoll(&mapper, 4000 + 2 * INPUT_CHORD_MS, out));
+  TEST_ASSERT_EQUAL_UINT8(A_LEFT, out[0]);
+
+  // a held back input released by poll exactly when the window closes, not before
+  TEST_ASSERT_EQUAL_INT(0, inputEvent(&mapper, IN_C1A, 5000, out));
+  TEST_ASSERT_EQUAL_INT(0, inputPoll(&mapper, 5000 + INPUT_CHORD_MS - 1, out));
+  TEST_ASSERT_EQUAL_INT(1, inputPoll(&mapper, 5000 + INPUT_CHORD_MS, out));
+  TEST_ASSERT_EQUAL_UINT8(A_SELECT, out[0]);
+  TEST_ASSERT_EQUAL_INT(0, inputPoll(&mapper, 6000, out));
+
+  // an unrelated input inside the window releases the held one ahead of itself
+  TEST_ASSERT_EQUAL_INT(0, inputEvent(&mapper, IN_C1A, 7000, out));
+  TEST_ASSERT_EQUAL_INT(2, inputEvent(&mapper, IN_RPG1_CCW, 7005, out));
+  TEST_ASSERT_EQUAL_UINT8(A_SELECT, out[0]);
+  TEST_ASSERT_EQUAL_UINT8(A_LEFT, out[1]);
+
+  // the same button twice is no chord
+  TEST_ASSERT_EQUAL_INT(0, inputEvent(&mapper, IN_C1A, 8000, out));
+  TEST_ASSERT_EQUAL_INT(1, inputEvent(&mapper, IN_C1A, 8010, out));
+  TEST_ASSERT_EQUAL_UINT8(A_SELECT, out[0]);
+  TEST_ASSERT_EQUAL_INT(1, inputPoll(&mapper, 8100, out));
+
+  // millis() wrapping inside the window
+  unsigned long wrap = (unsigned long)-20;
+  TEST_ASSERT_EQUAL_INT(0, inputEvent(&mapper, IN_C1B, wrap, out));
+  TEST_ASSERT_EQUAL_INT(0, inputPoll(&mapper, wrap + 30, out));
+  TEST_ASSERT_EQUAL_INT(1, inputEvent(&mapper, IN_C1A, wrap + 30, out));
+  TEST_ASSERT_EQUAL_UINT8(A_CLEAR, out[0]);
+}
+
+static void test_hold_repeat() {
+  uint8_t out[2];
+  // a stick pushed for 1 s, the Arduino repeating every 20 ms: fires at 0, 200, 400 ... 1000
+  int fired = 0;
+  unsigned long last = 0;
+  for (unsigned long t = 10000; t <= 11000; t += 20) {
+    if (inputEvent(&mapper, IN_JOY1_UP, t, out)) {
+      TEST_ASSERT_EQUAL_UINT8(A_UP, out[0]);
+      if (fired) TEST_ASSERT_EQUAL_UINT32(200, t - last);
+      last = t;
+      fired++;
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(6, fired);
+
+  // let go for less than the hold gap: still the same hold
+  TEST_ASSERT_EQUAL_INT(0, inputEvent(&mapper, IN_JOY1_UP, 11000 + INPUT_HOLD_GAP_MS - 1, out));
+  // a real gap: the next push fires at once
+  unsigned long t = 11000 + INPUT_HOLD_GAP_MS - 1 + INPUT_HOLD_GAP_MS;
+  TEST_ASSERT_EQUAL_INT(1, inputEvent(&mapper, IN_JOY1_UP, t, out));
+
+  // no repeat rate: every command is an action
+  for (int i = 0; i < 50; i++) TEST_ASSERT_EQUAL_INT(1, inputEvent(&mapper, IN_RPG1_CW, 20000 + i, out));
+}
+
+// long random streams, checked against the rules instead of a second implementation
+static void test_random_streams() {
+  struct Out { uint8_t action; unsigned long at; };
+  static Out outs[100000];
+  uint8_t out[2];
+
+  for (int round = 0; round < 50; round++) {
+    inputMapperInit(&mapper, &profile);
+    int nOut = 0, starts = 0;
+    unsigned long now = 100000, lastJoySeen = 0, lastJoyFireAt = 0;
+
+    for (int i = 0; i < 1500; i++) {
+      now += next() % 90;
+      static const uint8_t PICK[] = { IN_C1A, IN_C1B, IN_RPG1_CW, IN_JOY1_UP, IN_JOY1_UP, IN_JOY1_UP };
+      uint8_t code = PICK[next() % 6];
+      int n;
+      if (next() % 3 == 0) n = inputPoll(&mapper, now, out);
+      else {
+        n = inputEvent(&mapper, code, now, out);
+        if (code == IN_C1A || code == IN_C1B) starts++;
+        if (code == IN_JOY1_UP) {
+          // the repeat rule, seen from outside
+          bool fired = false;
+          for (int k = 0; k < n; k++) fired |= out[k] == A_UP;
+          bool holding = i && now - lastJoySeen < INPUT_HOLD_GAP_MS;
+          if (!holding) TEST_ASSERT_TRUE_MESSAGE(fired, "first push of a hold must fire");
+          if (fired && holding) TEST_ASSERT_TRUE(now - lastJoyFireAt >= 200);
+          if (!fired) TEST_ASSERT_TRUE(now - lastJoyFireAt < 200);
+          if (fired) lastJoyFireAt = now;
+          lastJoySeen = now;
+        }
+      }
+      for (int k = 0; k < n; k++) outs[nOut++] = { out[k], now };
+    }
+    if (inputPoll(&mapper, now + 1000, out)) outs[nOut++] = { out[0], now + 1000 };
+
+    // every chord button press comes out exactly once: alone, or as half of a chord
+    int chords = 0, singles = 0;
+    for (int k = 0; k < nOut; k++) {
+      if (outs[k].action == A_CLEAR) chords++;
+      if (outs[k].action == A_SELECT) singles++;
+    }
+    int c1b = 0;
+    for (int k = 0; k < nOut; k++) c1b += outs[k].action == A_LEFT;
+    TEST_ASSERT_EQUAL_INT(starts, 2 * chords + singles + c1b);
+  }
+}
+
+static void test_benchmarks() {
+  const char* names[IN_COUNT];
+  for (int i = 0; i < IN_COUNT; i++) names[i] = inputName(i);
+  const int N = 2000000;
+
+  volatile uint32_t sink = 0;
+  double t0 = benchSeconds();
+  for (int i = 0; i < N; i++) sink += inputCode(names[1 + i % (IN_COUNT - 1)]);
+  benchReport("inputCode (hash)", N, "lookup", benchSeconds() - t0);
+
+  // what the hash replaced: comparing against every name
+  t0 = benchSeconds();
+  for (int i = 0; i < N; i++) {
+    const char* s = names[1 + i % (IN_COUNT - 1)];
+    for (int c = 1; c < IN_COUNT; c++) {
+      if (strcmp(names[c], s) == 0) { sink += c; break; }
+    }
+  }
+  benchReport("linear strcmp", N, "lookup", benchSeconds() - t0);
+
+  uint8_t out[2];
+  static const uint8_t STREAM[] = { IN_RPG1_CW, IN_JOY1_UP, IN_C1A, IN_C1B, IN_RPG1_CCW };
+  t0 = benchSeconds();
+  for (int i = 0; i < N; i++) sink += inputEvent(&mapper, STREAM[i % 5], i * 7, out);
+  benchReport("inputEvent", N, "event", benchSeconds() - t0);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_command_lookup);
+  RUN_TEST(test_profile_and_config);
+  RUN_TEST(test_chord_window);
+  RUN_TEST(test_hold_repeat);
+  RUN_TEST(test_random_streams);
+  RUN_TEST(test_benchmarks);
+  return UNITY_END();
+}
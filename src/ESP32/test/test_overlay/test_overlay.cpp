@@ -0,0 +1,317 @@
+/**
+ * @file test_overlay.cpp
+ * @brief overlay layers composited on the way out, against a software framebuffer of what the wall should show
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The model is plain arrays: the canvas pixels, and per layer a color and a covered flag per pixel. A pixel shows the
+ * last attached layer covering it, or the canvas. Random drawing, clearing, attaching and detaching is done to both,
+ * and after every flush each LED on the host panel has to show what the model says: damage that was not marked shows
+ * up as a stale LED. The canvas itself must never see a layer's pixels.
+ *
+ */
+
+#include <unity.h>
+#include "Display/VirtualCanvas.h"
+#include "Display/Overlay.h"
+#include "../bench.h"
+
+#define LAYERS CANVAS_MAX_LAYERS
+
+static MatrixPanel_I2S_DMA* panel;
+static VirtualCanvas* canvas;
+static OverlayLayer* layers[LAYERS];
+
+// the model
+static uint16_t canvasPixels[CANVAS_HEIGHT][CANVAS_WIDTH];
+static uint16_t layerPixels[LAYERS][CANVAS_HEIGHT][CANVAS_WIDTH];
+static bool covered[LAYERS][CANVAS_HEIGHT][CANVAS_WIDTH];
+static int order[LAYERS];               // attached layers, bottom first
+static int attached;
+
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+static void freeWall() {
+  for (int i = 0; i < LAYERS; i++) {
+    delete layers[i];
+    layers[i] = nullptr;
+  }
+  delete canvas;
+  delete panel;
+  canvas = nullptr;
+  panel = nullptr;
+}
+
+static void makeWall(PanelChainLayout layout, PanelRotation rotation) {
+  freeWall();
+  panel = new MatrixPanel_I2S_DMA(HUB75_I2S_CFG(PANEL_WIDTH, PANEL_HEIGHT, PANELS_NUMBER));
+  panel->begin();
+  canvas = new VirtualCanvas(panel, layout, rotation);
+  canvas->begin();
+  for (int i = 0; i < LAYERS; i++) {
+    layers[i] = new OverlayLayer(canvas);
+    TEST_ASSERT_TRUE(layers[i]->begin());
+  }
+  memset(canvasPixels, 0, sizeof(canvasPixels));
+  memset(covered, 0, sizeof(covered));
+  attached = 0;
+}
+
+void setUp() {
+  seed = 45;
+  makeWall(CHAIN_ROWS, ROTATE_0);
+}
+
+void tearDown() {
+  freeWall();
+}
+
+static uint16_t expected(int x, int y) {
+  uint16_t c = canvasPixels[y][x];
+  for (int i = 0; i < attached; i++) {
+    if (covered[order[i]][y][x]) c = layerPixels[order[i]][y][x];
+  }
+  return c;
+}
+
+static void attach(int layer) {
+  TEST_ASSERT_TRUE(canvas->attachLayer(layers[layer]));
+  for (int i = 0; i < attached; i++) if (order[i] == layer) return;
+  order[attached++] = layer;
+}
+
+static void detach(int layer) {
+  canvas->detachLayer(layers[layer]);
+  for (int i = 0; i < attached; i++) {
+    if (order[i] != layer) continue;
+    for (int j = i; j < attached - 1; j++) order[j] = order[j + 1];
+    attached--;
+    return;
+  }
+}
+
+static int dirtyTiles() {
+  int n = 0;
+  for (int ty = 0; ty < CANVAS_TILES_Y; ty++)
+    for (int tx = 0; tx < CANVAS_TILES_X; tx++) n += canvas->isTileDirty(tx, ty);
+  return n;
+}
+
+// every LED against the model, the canvas untouched by the layers, tileUsed matching the coverage
+static void checkWall() {
+  for (int y = 0; y < CANVAS_HEIGHT; y++) {
+    for (int x = 0; x < CANVAS_WIDTH; x++) {
+      int16_t px, py;
+      canvas->mapToPhysical(x, y, &px, &py);
+      if (panel->shown(px, py) != expected(x, y) || canvas->getPixel(x, y) != canvasPixels[y][x]) {
+        char msg[80];
+        snprintf(msg, sizeof(msg), "pixel %d,%d shows %04X, expected %04X", x, y, panel->shown(px, py), expected(x, y));
+        TEST_FAIL_MESSAGE(msg);
+      }
+    }
+  }
+  for (int i = 0; i < LAYERS; i++) {
+    for (int ty = 0; ty < CANVAS_TILES_Y; ty++) {
+      for (int tx = 0; tx < CANVAS_TILES_X; tx++) {
+        bool any = false;
+        for (int y = 0; y < CANVAS_TILE_SIZE; y++)
+          for (int x = 0; x < CANVAS_TILE_SIZE; x++) any |= covered[i][ty * CANVAS_TILE_SIZE + y][tx * CANVAS_TILE_SIZE + x];
+        TEST_ASSERT_EQUAL(any, layers[i]->isTileUsed(tx, ty));
+      }
+    }
+  }
+}
+
+// a rectangle that is often partly off the canvas
+static void randomRect(int16_t* x, int16_t* y, int16_t* w, int16_t* h) {
+  *w = (int16_t)(1 + next() % 20);
+  *h = (int16_t)(1 + next() % 20);
+  *x = (int16_t)((int)(next() % (CANVAS_WIDTH + 20)) - 10);
+  *y = (int16_t)((int)(next() % (CANVAS_HEIGHT + 20)) - 10);
+}
+
+static void modelFill(uint16_t (*pixels)[CANVAS_WIDTH], bool (*cover)[CANVAS_WIDTH], int16_t x, int16_t y, int16_t w,
+                      int16_t h, uint16_t color, bool coverIt) {
+  for (int row = y; row < y + h; row++) {
+    for (int col = x; col < x + w; col++) {
+      if (col < 0 || row < 0 || col >= CANVAS_WIDTH || row >= CANVAS_HEIGHT) continue;
+      if (pixels) pixels[row][col] = color;
+      if (cover) cover[row][col] = coverIt;
+    }
+  }
+}
+
+static void randomOp() {
+  int16_t x, y, w, h;
+  randomRect(&x, &y, &w, &h);
+  uint16_t color = (uint16_t)next();
+  int layer = (int)(next() % LAYERS);
+
+  switch (next() % 13) {
+    case 0: case 1:
+      canvas->fillRect(x, y, w, h, color);
+      modelFill(canvasPixels, nullptr, x, y, w, h, color, false);
+      break;
+    case 2:
+      canvas->drawPixel(x, y, color);
+      modelFill(canvasPixels, nullptr, x, y, 1, 1, color, false);
+      break;
+    case 3: case 4:
+      layers[layer]->fillRect(x, y, w, h, color);
+      modelFill(layerPixels[layer], covered[layer], x, y, w, h, color, true);
+      break;
+    case 5:
+      layers[layer]->drawPixel(x, y, color);
+      modelFill(layerPixels[layer], covered[layer], x, y, 1, 1, color, true);
+      break;
+    case 6:
+      layers[layer]->drawFastHLine(x, y, w, color);
+      modelFill(layerPixels[layer], covered[layer], x, y, w, 1, color, true);
+      break;
+    case 7:
+      layers[layer]->drawFastVLine(x, y, h, color);
+      modelFill(layerPixels[layer], covered[layer], x, y, 1, h, color, true);
+      break;
+    case 8: case 9:
+      layers[layer]->clear(x, y, w, h);
+      modelFill(nullptr, covered[layer], x, y, w, h, 0, false);
+      break;
+    case 10:
+      layers[layer]->clear();
+      memset(covered[layer], 0, sizeof(covered[layer]));
+      break;
+    default:
+      if (next() % 2) attach(layer);
+      else            detach(layer);
+      break;
+  }
+}
+
+// every layout and rotation, so composed tiles go through both ways of pushing a tile
+static void test_random_against_model() {
+  for (int layout = CHAIN_ROWS; layout <= CHAIN_SERPENTINE; layout++) {
+    for (int rot = ROTATE_0; rot <= ROTATE_270; rot++) {
+      makeWall((PanelChainLayout)layout, (PanelRotation)rot);
+      for (int round = 0; round < 100; round++) {
+        int ops = 1 + (int)(next() % 10);
+        for (int i = 0; i < ops; i++) randomOp();
+        canvas->flush();
+        TEST_ASSERT_EQUAL(0, dirtyTiles());
+        checkWall();
+      }
+    }
+  }
+}
+
+static void test_stacking_order() {
+  attach(0);
+  attach(1);
+  attach(2);
+  layers[0]->fillRect(0, 0, 3, 1, 0x1111);
+  layers[1]->fillRect(1, 0, 2, 1, 0x2222);
+  layers[2]->drawPixel(2, 0, 0x3333);
+  canvas->drawPixel(3, 0, 0x4444);
+  canvas->flush();
+
+  int16_t px, py;
+  const uint16_t EXPECT[4] = { 0x1111, 0x2222, 0x3333, 0x4444 };
+  for (int x = 0; x < 4; x++) {
+    canvas->mapToPhysical(x, 0, &px, &py);
+    TEST_ASSERT_EQUAL_HEX16(EXPECT[x], panel->shown(px, py));
+  }
+  TEST_ASSERT_EQUAL_HEX16(0, canvas->getPixel(0, 0));   // the canvas never sees a layer
+
+  TEST_ASSERT_TRUE(canvas->attachLayer(layers[2]));     // already attached, stays where it is
+  OverlayLayer extra(canvas);
+  TEST_ASSERT_FALSE(canvas->attachLayer(&extra));        // CANVAS_MAX_LAYERS
+}
+
+// what a blinking cursor costs: one tile per change, nothing else
+static void test_damage_is_minimal() {
+  attach(0);
+  canvas->fillScreen(0x0841);
+  canvas->flush();
+
+  layers[0]->drawPixel(20, 20, 0xFFFF);
+  TEST_ASSERT_EQUAL(1, dirtyTiles());
+  canvas->flush();
+  layers[0]->drawPixel(20, 20, 0xFFFF);                 // same color on a covered pixel
+  TEST_ASSERT_EQUAL(0, dirtyTiles());
+
+  layers[0]->clear(40, 40, 30, 30);                     // nothing covered there
+  TEST_ASSERT_EQUAL(0, dirtyTiles());
+  layers[0]->clear();                                   // only the cursor's tile had anything
+  TEST_ASSERT_EQUAL(1, dirtyTiles());
+  TEST_ASSERT_TRUE(canvas->isTileDirty(20 / CANVAS_TILE_SIZE, 20 / CANVAS_TILE_SIZE));
+  TEST_ASSERT_FALSE(layers[0]->isTileUsed(20 / CANVAS_TILE_SIZE, 20 / CANVAS_TILE_SIZE));
+
+  uint32_t before = panel->pixelWrites;
+  canvas->flush();
+  TEST_ASSERT_EQUAL_UINT32(before + CANVAS_TILE_SIZE * CANVAS_TILE_SIZE, panel->pixelWrites);
+  int16_t px, py;
+  canvas->mapToPhysical(20, 20, &px, &py);
+  TEST_ASSERT_EQUAL_HEX16(0x0841, panel->shown(px, py));
+}
+
+static void test_not_ready_draws_nothing() {
+  OverlayLayer idle(canvas);                            // begin() never called
+  TEST_ASSERT_FALSE(idle.ready());
+  canvas->flush();
+  idle.fillRect(0, 0, 10, 10, 0xFFFF);
+  idle.drawPixel(5, 5, 0xFFFF);
+  idle.clear();
+  TEST_ASSERT_EQUAL(0, dirtyTiles());
+}
+
+static void test_benchmark() {
+  attach(0);
+  canvas->fillScreen(0x0841);
+  canvas->flush();
+
+  const int BLINKS = 200000;
+  uint32_t before = panel->pixelWrites;
+  double t0 = benchSeconds();
+  for (int i = 0; i < BLINKS; i++) {
+    if (i & 1) layers[0]->clear(30, 30, 1, 1);
+    else       layers[0]->drawPixel(30, 30, 0xFFFF);
+    canvas->flush();
+  }
+  benchReport("cursor blink (draw or clear + flush)", BLINKS, "blink", benchSeconds() - t0);
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)BLINKS * CANVAS_TILE_SIZE * CANVAS_TILE_SIZE, panel->pixelWrites - before);
+
+  const int FRAMES = 300;
+  for (int layersUsed = 0; layersUsed <= LAYERS; layersUsed++) {
+    for (int i = 0; i < LAYERS; i++) {
+      if (i < layersUsed) {
+        attach(i);
+        for (int y = 0; y < CANVAS_HEIGHT; y += 2) layers[i]->drawFastHLine(0, y, CANVAS_WIDTH, (uint16_t)(0x1000 * i));
+      } else {
+        detach(i);
+      }
+    }
+    t0 = benchSeconds();
+    for (int f = 0; f < FRAMES; f++) {
+      canvas->markDirty(0, 0, CANVAS_WIDTH, CANVAS_HEIGHT);
+      canvas->flush();
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "full flush, %d of %d layers covering every tile", layersUsed, LAYERS);
+    benchReport(name, FRAMES, "frame", benchSeconds() - t0);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_random_against_model);
+  RUN_TEST(test_stacking_order);
+  RUN_TEST(test_damage_is_minimal);
+  RUN_TEST(test_not_ready_draws_nothing);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
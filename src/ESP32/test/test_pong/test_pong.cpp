@@ -0,0 +1,153 @@
+/**
+ * @file test_pong.cpp
+ * @brief Pong simulation: replaying recorded input reproduces the game tick for tick
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * A scripted match (player 1 random, player 2 tracking the ball) is recorded as its input log and a hash of the state
+ * after every tick. Replaying the log must give the same hashes, and the hash of the whole match is pinned so any
+ * change to the simulation shows up here (update GOLDEN_MATCH when the game is changed on purpose).
+ *
+ */
+
+#include <unity.h>
+#include "Pong/PongGame.h"
+
+#define FIELD_W 128
+#define FIELD_TOP 8
+#define FIELD_BOTTOM 128
+#define MATCH_TICKS 30000
+
+static const uint32_t GOLDEN_MATCH = 0x6EB868B7;
+
+static int8_t inputs[MATCH_TICKS][2];
+static uint32_t recorded[MATCH_TICKS];
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+static uint32_t fnv(uint32_t h, int32_t v) {
+  for (int i = 0; i < 4; i++) {
+    h ^= (uint8_t)(v >> (8 * i));
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static uint32_t stateHash(const PongState& s, uint8_t events) {
+  uint32_t h = 2166136261u;
+  h = fnv(h, s.ballX);
+  h = fnv(h, s.ballY);
+  h = fnv(h, s.ballVX);
+  h = fnv(h, s.ballVY);
+  h = fnv(h, s.paddleY[0]);
+  h = fnv(h, s.paddleY[1]);
+  h = fnv(h, s.score[0] | (s.score[1] << 8) | (s.serveTimer << 16) | ((uint8_t)s.serveDir << 24));
+  h = fnv(h, s.rng | (s.gameOver << 16) | (events << 24));
+  return fnv(h, s.tick);
+}
+
+void setUp() {
+  seed = 2025;
+}
+
+void tearDown() {}
+
+// player 1 mashes at random, player 2 follows the ball (so there are long rallies and points both ways)
+static int8_t tracker(const PongState& s) {
+  int32_t center = s.paddleY[1] + PONG_FP(PONG_PADDLE_H / 2);
+  int32_t ball = s.ballY + PONG_FP(PONG_BALL_SIZE / 2);
+  if (ball < center - PONG_FP(2)) return -1;
+  if (ball > center + PONG_FP(2)) return 1;
+  return 0;
+}
+
+static uint32_t playMatch() {
+  PongState s;
+  pongInit(&s, FIELD_W, FIELD_TOP, FIELD_BOTTOM);
+  uint32_t all = 2166136261u;
+  for (int t = 0; t < MATCH_TICKS; t++) {
+    inputs[t][0] = (int8_t)(next() % 3) - 1;
+    inputs[t][1] = tracker(s);
+    uint8_t events = pongStep(&s, inputs[t][0], inputs[t][1]);
+    if (events & PONG_EVT_GAME_OVER) pongInit(&s, FIELD_W, FIELD_TOP, FIELD_BOTTOM);
+    recorded[t] = stateHash(s, events);
+    all = fnv(all, recorded[t]);
+  }
+  return all;
+}
+
+static void test_replay_matches_recording() {
+  uint32_t all = playMatch();
+
+  PongState s;
+  pongInit(&s, FIELD_W, FIELD_TOP, FIELD_BOTTOM);
+  for (int t = 0; t < MATCH_TICKS; t++) {
+    uint8_t events = pongStep(&s, inputs[t][0], inputs[t][1]);
+    if (events & PONG_EVT_GAME_OVER) pongInit(&s, FIELD_W, FIELD_TOP, FIELD_BOTTOM);
+    TEST_ASSERT_EQUAL_HEX32(recorded[t], stateHash(s, events));
+  }
+
+  char line[48];
+  snprintf(line, sizeof(line), "match hash 0x%08X", (unsigned)all);
+  TEST_MESSAGE(line);
+  TEST_ASSERT_EQUAL_HEX32(GOLDEN_MATCH, all);
+}
+
+static void test_ball_and_paddles_stay_in_field() {
+  PongState s;
+  pongInit(&s, FIELD_W, FIELD_TOP, FIELD_BOTTOM);
+  int hits = 0, points = 0;
+  for (int t = 0; t < MATCH_TICKS && !s.gameOver; t++) {
+    uint8_t events = pongStep(&s, (int8_t)(next() % 3) - 1, tracker(s));
+    hits += (events & PONG_EVT_PADDLE_HIT) != 0;
+    points += (events & PONG_EVT_SCORED) != 0;
+
+    TEST_ASSERT_TRUE(s.ballY >= PONG_FP(FIELD_TOP) && s.ballY <= PONG_FP(FIELD_BOTTOM - PONG_BALL_SIZE));
+    for (int p = 0; p < 2; p++) {
+      TEST_ASSERT_TRUE(s.paddleY[p] >= PONG_FP(FIELD_TOP));
+      TEST_ASSERT_TRUE(s.paddleY[p] <= PONG_FP(FIELD_BOTTOM - PONG_PADDLE_H));
+    }
+  }
+  TEST_ASSERT_GREATER_THAN(0, hits);
+  TEST_ASSERT_GREATER_THAN(0, points);
+}
+
+static void test_game_ends_at_win_score() {
+  PongState s;
+  pongInit(&s, FIELD_W, FIELD_TOP, FIELD_BOTTOM);
+  int scoredBy[2] = {0, 0};
+  uint8_t events = 0;
+  int t = 0;
+  while (!(events & PONG_EVT_GAME_OVER) && t++ < MATCH_TICKS) {
+    uint8_t before[2] = {s.score[0], s.score[1]};
+    events = pongStep(&s, 0, 0);
+    if (events & PONG_EVT_SCORED) {
+      int scorer = s.score[0] != before[0] ? 0 : 1;
+      scoredBy[scorer]++;
+      // next serve goes to whoever lost the point
+      TEST_ASSERT_EQUAL(scorer == 0 ? 1 : -1, s.serveDir);
+    }
+  }
+  TEST_ASSERT_TRUE(s.gameOver);
+  TEST_ASSERT_EQUAL(PONG_WIN_SCORE, s.score[0] > s.score[1] ? s.score[0] : s.score[1]);
+  TEST_ASSERT_EQUAL(s.score[0], scoredBy[0]);
+  TEST_ASSERT_EQUAL(s.score[1], scoredBy[1]);
+
+  PongState frozen = s;
+  TEST_ASSERT_EQUAL(0, pongStep(&s, 1, 1));
+  TEST_ASSERT_EQUAL(frozen.ballX, s.ballX);
+  TEST_ASSERT_EQUAL(frozen.paddleY[0], s.paddleY[0]);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_replay_matches_recording);
+  RUN_TEST(test_ball_and_paddles_stay_in_field);
+  RUN_TEST(test_game_ends_at_win_score);
+  return UNITY_END();
+}
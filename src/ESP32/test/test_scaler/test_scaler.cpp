@@ -0,0 +1,284 @@
+/**
+ * @file test_scaler.cpp
+ * @brief image scaler: placement, and every output pixel against a per pixel reference
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The reference knows nothing about spans: a magnified pixel is the source pixel under it, a reduced pixel is worked out
+ * straight from the overlap of its rectangle with every source pixel, in 1/dst units, summed per channel in 64 bits and
+ * rounded half up. Random images of random sizes go into random areas and have to match bit for bit, without anything
+ * outside the output rectangle being written and without rows being asked for that the image doesn't have.
+ *
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "Display/Scaler.h"
+#include "../bench.h"
+
+#define MAX_SRC SCALER_MAX_SOURCE
+#define GUARD 0xDEAD
+
+static uint16_t source[MAX_SRC * MAX_SRC];
+static uint16_t area[SCALER_MAX_SIZE * SCALER_MAX_SIZE];
+static uint16_t expected[SCALER_MAX_SIZE * SCALER_MAX_SIZE];
+static ScaleMap map;
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+void setUp() {
+  seed = 48;
+}
+
+void tearDown() {}
+
+static void randomImage(int w, int h) {
+  int style = next() % 3;
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      uint16_t p;
+      if (style == 0) p = (uint16_t)next();                                // noise
+      else if (style == 1) p = ((x ^ y) & 1) ? 0xFFFF : 0x0000;             // checkerboard, worst case for rounding
+      else p = (uint16_t)(((x * 31 / w) << 11) | ((y * 63 / h) << 5) | ((x + y) & 0x1F));
+      source[y * w + x] = p;
+    }
+  }
+}
+
+// ---------- reference ---------- //
+
+static int64_t overlap(int64_t a0, int64_t a1, int64_t b0, int64_t b1) {
+  int64_t lo = a0 > b0 ? a0 : b0;
+  int64_t hi = a1 < b1 ? a1 : b1;
+  return hi > lo ? hi - lo : 0;
+}
+
+// the pixel of a srcW x srcH image reduced to dstW x dstH at output (i, j)
+static uint16_t referenceReduced(int srcW, int srcH, int dstW, int dstH, int i, int j) {
+  uint64_t r = 0, g = 0, b = 0;
+  for (int y = 0; y < srcH; y++) {
+    int64_t wy = overlap((int64_t)j * srcH, (int64_t)(j + 1) * srcH, (int64_t)y * dstH, (int64_t)(y + 1) * dstH);
+    if (!wy) continue;
+    for (int x = 0; x < srcW; x++) {
+      int64_t wx = overlap((int64_t)i * srcW, (int64_t)(i + 1) * srcW, (int64_t)x * dstW, (int64_t)(x + 1) * dstW);
+      if (!wx) continue;
+      uint16_t p = source[y * srcW + x];
+      r += wx * wy * (p >> 11);
+      g += wx * wy * ((p >> 5) & 0x3F);
+      b += wx * wy * (p & 0x1F);
+    }
+  }
+  uint64_t n = (uint64_t)srcW * srcH;
+  return (uint16_t)((((r + n / 2) / n) << 11) | (((g + n / 2) / n) << 5) | ((b + n / 2) / n));
+}
+
+// the whole area as it should look: guard everywhere but the output rectangle
+static void referenceRender(const ScaleMap& m, int areaW, int areaH) {
+  for (int i = 0; i < areaW * areaH; i++) expected[i] = GUARD;
+  for (int j = 0; j < m.dstH; j++) {
+    for (int i = 0; i < m.dstW; i++) {
+      uint16_t p = m.scale ? source[(j / m.scale) * m.srcW + i / m.scale]
+                           : referenceReduced(m.srcW, m.srcH, m.dstW, m.dstH, i, j);
+      expected[(m.y + j) * areaW + m.x + i] = p;
+    }
+  }
+}
+
+// ---------- row source ---------- //
+
+struct RowSource {
+  int w, h;
+  int calls;
+  bool outOfRange;
+  uint16_t line[MAX_SRC];
+};
+
+// hands out a copy that is scribbled over on the next call, so a row kept past its turn shows up
+static const uint16_t* sourceRow(void* ctx, int y) {
+  RowSource* s = (RowSource*)ctx;
+  s->calls++;
+  if (y < 0 || y >= s->h) {
+    s->outOfRange = true;
+    y = 0;
+  }
+  memcpy(s->line, &source[y * s->w], s->w * sizeof(uint16_t));
+  return s->line;
+}
+
+// ---------- tests ---------- //
+
+static void test_fit() {
+  // fits: largest integer magnification, centered
+  TEST_ASSERT_TRUE(scaleFit(&map, 32, 32, 128, 128));
+  TEST_ASSERT_EQUAL(4, map.scale);
+  TEST_ASSERT_EQUAL(0, map.x);
+  TEST_ASSERT_EQUAL(0, map.y);
+  TEST_ASSERT_TRUE(scaleFit(&map, 30, 20, 128, 64));
+  TEST_ASSERT_EQUAL(3, map.scale);                       // 64 / 20
+  TEST_ASSERT_EQUAL(90, map.dstW);
+  TEST_ASSERT_EQUAL(60, map.dstH);
+  TEST_ASSERT_EQUAL(19, map.x);
+  TEST_ASSERT_EQUAL(2, map.y);
+  TEST_ASSERT_TRUE(scaleFit(&map, 128, 64, 128, 64));
+  TEST_ASSERT_EQUAL(1, map.scale);
+
+  // too big: the side that overflows more is the one that fills the area
+  TEST_ASSERT_TRUE(scaleFit(&map, 256, 64, 128, 128));
+  TEST_ASSERT_EQUAL(0, map.scale);
+  TEST_ASSERT_EQUAL(128, map.dstW);
+  TEST_ASSERT_EQUAL(32, map.dstH);
+  TEST_ASSERT_EQUAL(48, map.y);
+  TEST_ASSERT_TRUE(scaleFit(&map, 100, 300, 128, 128));
+  TEST_ASSERT_EQUAL(128, map.dstH);
+  TEST_ASSERT_EQUAL(43, map.dstW);                       // 42.67 rounded
+  TEST_ASSERT_TRUE(scaleFit(&map, 1000, 1, 64, 64));
+  TEST_ASSERT_EQUAL(64, map.dstW);
+  TEST_ASSERT_EQUAL(1, map.dstH);                        // at least one pixel
+
+  // refused
+  TEST_ASSERT_FALSE(scaleFit(&map, 0, 10, 64, 64));
+  TEST_ASSERT_FALSE(scaleFit(&map, 10, 10, 0, 64));
+  TEST_ASSERT_FALSE(scaleFit(&map, 300, 300, 200, 200)); // reduced output wider than SCALER_MAX_SIZE
+}
+
+// every output pixel's weights add up to the pixels it covers, and the spans tile the source without gaps
+static void test_spans() {
+  for (int round = 0; round < 2000; round++) {
+    int srcW = 2 + next() % 1000, srcH = 2 + next() % 1000;
+    int areaW = 1 + next() % SCALER_MAX_SIZE, areaH = 1 + next() % SCALER_MAX_SIZE;
+    if (srcW <= areaW && srcH <= areaH) continue;
+    TEST_ASSERT_TRUE(scaleFit(&map, srcW, srcH, areaW, areaH));
+    TEST_ASSERT_LESS_OR_EQUAL(areaW, map.dstW);
+    TEST_ASSERT_LESS_OR_EQUAL(areaH, map.dstH);
+    TEST_ASSERT_TRUE(map.dstW == areaW || map.dstH == areaH);
+
+    for (int axis = 0; axis < 2; axis++) {
+      const ScaleSpan* spans = axis ? map.rows : map.cols;
+      int src = axis ? srcH : srcW, dst = axis ? map.dstH : map.dstW;
+      TEST_ASSERT_EQUAL(0, spans[0].first);
+      TEST_ASSERT_EQUAL(src - 1, spans[dst - 1].last);
+      for (int j = 0; j < dst; j++) {
+        const ScaleSpan& s = spans[j];
+        int inner = s.last > s.first ? s.last - s.first - 1 : 0;
+        int total = s.first == s.last ? s.firstWeight : s.firstWeight + s.lastWeight + inner * dst;
+        TEST_ASSERT_EQUAL(src, total);
+        TEST_ASSERT_TRUE(s.firstWeight >= 1 && s.firstWeight <= dst);
+        TEST_ASSERT_TRUE(s.lastWeight >= 1 && s.lastWeight <= dst);
+        if (j) TEST_ASSERT_TRUE(s.first == spans[j - 1].last || s.first == spans[j - 1].last + 1);
+      }
+    }
+  }
+}
+
+static void checkRandom(bool reduce, int rounds) {
+  RowSource rows;
+  for (int round = 0; round < rounds; round++) {
+    int areaW = 1 + next() % SCALER_MAX_SIZE, areaH = 1 + next() % SCALER_MAX_SIZE;
+    int srcW, srcH;
+    do {
+      srcW = 1 + next() % (reduce ? 200 : areaW);
+      srcH = 1 + next() % (reduce ? 200 : areaH);
+    } while (reduce && srcW <= areaW && srcH <= areaH);
+    randomImage(srcW, srcH);
+
+    TEST_ASSERT_TRUE(scaleFit(&map, srcW, srcH, areaW, areaH));
+    TEST_ASSERT_EQUAL(reduce, map.scale == 0);
+    referenceRender(map, areaW, areaH);
+
+    // through the row callback
+    for (int i = 0; i < areaW * areaH; i++) area[i] = GUARD;
+    rows.w = srcW;
+    rows.h = srcH;
+    rows.calls = 0;
+    rows.outOfRange = false;
+    scaleRender(&map, sourceRow, &rows, area, areaW);
+    TEST_ASSERT_FALSE(rows.outOfRange);
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(expected, area, areaW * areaH);
+    // each source row is read once, plus once more for every output row boundary that splits it
+    TEST_ASSERT_LESS_OR_EQUAL(srcH + (map.scale ? 0 : map.dstH), rows.calls);
+
+    // straight from the buffer
+    for (int i = 0; i < areaW * areaH; i++) area[i] = GUARD;
+    scaleRenderBuffer(&map, source, srcW, area, areaW);
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(expected, area, areaW * areaH);
+  }
+}
+
+static void test_magnify() {
+  checkRandom(false, 3000);
+}
+
+static void test_reduce() {
+  checkRandom(true, 1500);
+}
+
+// a flat image stays exactly its color however it is reduced, a full range gradient keeps both ends
+static void test_flat_and_extremes() {
+  static const uint16_t COLORS[] = { 0x0000, 0xFFFF, 0xF800, 0x07E0, 0x001F, 0x1234, 0xA5A5 };
+  for (uint16_t color : COLORS) {
+    int srcW = 1 + next() % MAX_SRC, srcH = 1 + next() % MAX_SRC;
+    for (int i = 0; i < srcW * srcH; i++) source[i] = color;
+    TEST_ASSERT_TRUE(scaleFit(&map, srcW, srcH, 37, 23));
+    scaleRenderBuffer(&map, source, srcW, area, 37);
+    for (int j = 0; j < map.dstH; j++) {
+      for (int i = 0; i < map.dstW; i++) TEST_ASSERT_EQUAL_HEX16(color, area[(map.y + j) * 37 + map.x + i]);
+    }
+  }
+
+  // the biggest source the callers feed, so the 32 bit sums are at their largest
+  for (int i = 0; i < MAX_SRC * MAX_SRC; i++) source[i] = 0xFFFF;
+  TEST_ASSERT_TRUE(scaleFit(&map, MAX_SRC, MAX_SRC, 1, 1));
+  scaleRenderBuffer(&map, source, MAX_SRC, area, 1);
+  TEST_ASSERT_EQUAL_HEX16(0xFFFF, area[0]);
+}
+
+static void test_benchmark() {
+  struct Case {
+    const char* name;
+    int srcW, srcH, areaW, areaH;
+  };
+  static const Case CASES[] = {
+    { "32x32 magnified to 128x128", 32, 32, 128, 128 },
+    { "128x128 reduced to 64x64", 128, 128, 64, 64 },
+    { "200x150 reduced to 128x64", 200, 150, 128, 64 },
+    { "256x256 reduced to 128x128", 256, 256, 128, 128 },
+  };
+  for (const Case& c : CASES) {
+    randomImage(c.srcW, c.srcH);
+    TEST_ASSERT_TRUE(scaleFit(&map, c.srcW, c.srcH, c.areaW, c.areaH));
+    for (int i = 0; i < c.areaW * c.areaH; i++) area[i] = GUARD;
+    int n = 0;
+    double t0 = benchSeconds();
+    while (n < 100 || benchSeconds() - t0 < 0.2) {
+      scaleRenderBuffer(&map, source, c.srcW, area, c.areaW);
+      n++;
+    }
+    double fast = (benchSeconds() - t0) / n;
+    benchReport(c.name, n, "image", fast * n);
+
+    // once against the reference, for scale (and a last check at the benchmark sizes)
+    t0 = benchSeconds();
+    referenceRender(map, c.areaW, c.areaH);
+    double slow = benchSeconds() - t0;
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(expected, area, c.areaW * c.areaH);
+    char line[96];
+    snprintf(line, sizeof(line), "  %.0f us, per pixel reference %.0f us", fast * 1e6, slow * 1e6);
+    TEST_MESSAGE(line);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fit);
+  RUN_TEST(test_spans);
+  RUN_TEST(test_magnify);
+  RUN_TEST(test_reduce);
+  RUN_TEST(test_flat_and_extremes);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
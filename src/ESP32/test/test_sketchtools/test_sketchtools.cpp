@@ -0,0 +1,291 @@
+/**
+ * @file test_sketchtools.cpp
+ * @brief Sketch tools: flood fill against a reference fill (with a full and a tiny seed stack), worst case fill times,
+ * and the shape rasterizers
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The reference is a breadth first fill with a queue as big as the surface. The module is built a second time below
+ * with a 4 entry seed stack, so the rescan that takes over when seeds are dropped runs on almost every fill. Both have
+ * to paint exactly the reference's pixels and report the same count and damage bounds.
+ *
+ * Worst cases for a scanline fill are many short runs: a one pixel wide serpentine corridor (every run is one row of
+ * it), a comb of one pixel teeth, and diagonal staircases (a run of two pixels per step, a quarter of every row).
+ *
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "EtchASketch/SketchTools.h"
+#include "../bench.h"
+
+// the same fill with a stack that overflows all the time
+namespace tiny {
+#undef SKETCH_FILL_STACK
+#define SKETCH_FILL_STACK 4
+#include "../../src/EtchASketch/SketchTools.cpp"
+#undef SKETCH_FILL_STACK
+}
+
+#define MAX_SIDE 128
+
+static uint16_t pixels[MAX_SIDE * MAX_SIDE];
+static uint16_t reference[MAX_SIDE * MAX_SIDE];
+static uint16_t original[MAX_SIDE * MAX_SIDE];
+static uint8_t mask[SKETCH_MASK_BYTES(MAX_SIDE, MAX_SIDE)];
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+void setUp() {
+  seed = 46;
+}
+
+void tearDown() {}
+
+// ---------- fill ---------- //
+
+static int referenceFill(uint16_t* p, int w, int h, int x, int y, uint16_t color, SketchRect* damage) {
+  damage->x0 = damage->y0 = 0;
+  damage->x1 = damage->y1 = -1;
+  if (x < 0 || y < 0 || x >= w || y >= h) return 0;
+  uint16_t target = p[y * w + x];
+  if (target == color) return 0;
+
+  *damage = { (int16_t)x, (int16_t)y, (int16_t)x, (int16_t)y };
+  std::vector<int> queue;
+  queue.push_back(y * w + x);
+  p[y * w + x] = color;
+  int count = 0;
+  for (size_t i = 0; i < queue.size(); i++) {
+    int px = queue[i] % w, py = queue[i] / w;
+    count++;
+    if (px < damage->x0) damage->x0 = (int16_t)px;
+    if (px > damage->x1) damage->x1 = (int16_t)px;
+    if (py < damage->y0) damage->y0 = (int16_t)py;
+    if (py > damage->y1) damage->y1 = (int16_t)py;
+    const int DX[4] = { 1, -1, 0, 0 }, DY[4] = { 0, 0, 1, -1 };
+    for (int d = 0; d < 4; d++) {
+      int nx = px + DX[d], ny = py + DY[d];
+      if (nx < 0 || ny < 0 || nx >= w || ny >= h || p[ny * w + nx] != target) continue;
+      p[ny * w + nx] = color;
+      queue.push_back(ny * w + nx);
+    }
+  }
+  return count;
+}
+
+enum Pattern { NOISE, BLOBS, SERPENTINE, COMB, STAIRS, PATTERNS };
+
+static const char* const PATTERN_NAMES[PATTERNS] = { "noise", "blobs", "serpentine", "comb", "stairs" };
+
+static void makePattern(uint16_t* p, int w, int h, int pattern) {
+  const uint16_t WALL = 0xFFFF, OPEN = 0x0000;
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      uint16_t c = OPEN;
+      switch (pattern) {
+        case NOISE:                                      // three colors, ~45% open: lots of small ragged areas
+          c = (next() % 100 < 45) ? OPEN : (next() & 1) ? WALL : 0x1234;
+          break;
+        case BLOBS:                                      // mostly open with scattered walls
+          c = (next() % 100 < 12) ? WALL : OPEN;
+          break;
+        case SERPENTINE:                                 // one pixel corridors joined at alternating ends
+          if (y & 1) c = ((y & 2) ? (x != w - 1) : (x != 0)) ? WALL : OPEN;
+          break;
+        case COMB:                                       // a spine along the top, one pixel teeth hanging off it
+          c = (y == 0 || !(x & 1)) ? OPEN : WALL;
+          break;
+        case STAIRS:                                     // diagonal staircases, two pixels a step, hanging off the top
+          c = (y == 0 || ((x - y) & 3) < 2) ? OPEN : WALL;
+          break;
+      }
+      p[y * w + x] = c;
+    }
+  }
+}
+
+typedef int (*FillFn)(SketchSurface*, int16_t, int16_t, uint16_t, SketchRect*);
+
+static void checkFill(FillFn fill, int w, int h, int x, int y, uint16_t color) {
+  memcpy(reference, original, sizeof(uint16_t) * w * h);
+  memcpy(pixels, original, sizeof(uint16_t) * w * h);
+  SketchRect want, got;
+  int expected = referenceFill(reference, w, h, x, y, color, &want);
+
+  SketchSurface s = { pixels, (int16_t)w, (int16_t)h, mask };
+  int count = fill(&s, (int16_t)x, (int16_t)y, color, &got);
+  TEST_ASSERT_EQUAL_INT(expected, count);
+  TEST_ASSERT_EQUAL_MEMORY(reference, pixels, sizeof(uint16_t) * w * h);
+  TEST_ASSERT_EQUAL_INT16(want.x0, got.x0);
+  TEST_ASSERT_EQUAL_INT16(want.y0, got.y0);
+  TEST_ASSERT_EQUAL_INT16(want.x1, got.x1);
+  TEST_ASSERT_EQUAL_INT16(want.y1, got.y1);
+}
+
+static void test_fill_matches_reference() {
+  for (int round = 0; round < 2000; round++) {
+    int w = 1 + (int)(next() % MAX_SIDE), h = 1 + (int)(next() % MAX_SIDE);
+    makePattern(original, w, h, (int)(next() % PATTERNS));
+    int x = (int)(next() % (w + 2)) - 1, y = (int)(next() % (h + 2)) - 1;   // sometimes just off the surface
+    uint16_t color = (next() % 8 == 0) ? 0x0000 : (uint16_t)next();          // sometimes the color already there
+    checkFill(sketchFill, w, h, x, y, color);
+    checkFill(tiny::sketchFill, w, h, x, y, color);
+  }
+}
+
+// the mask only has to be as big as the surface: nothing past SKETCH_MASK_BYTES is touched
+static void test_fill_stays_in_its_buffers() {
+  for (int pattern = 0; pattern < PATTERNS; pattern++) {
+    int w = 37, h = 29;
+    makePattern(original, w, h, pattern);
+    memset(mask, 0xA5, sizeof(mask));
+    memcpy(pixels, original, sizeof(uint16_t) * w * h);
+    pixels[w * h] = 0xBEEF;
+    SketchSurface s = { pixels, (int16_t)w, (int16_t)h, mask };
+    SketchRect damage;
+    tiny::sketchFill(&s, 0, 0, 0x5555, &damage);
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, pixels[w * h]);
+    for (size_t i = SKETCH_MASK_BYTES(w, h); i < sizeof(mask); i++) TEST_ASSERT_EQUAL_HEX8(0xA5, mask[i]);
+  }
+}
+
+// the slowest areas there are on the sketch's canvas (64x64, one panel) and a 2x2 wall, with both stacks
+static void test_fill_worst_case() {
+  const int SIDES[2] = { 64, MAX_SIDE };
+  for (int si = 0; si < 2; si++) {
+    int side = SIDES[si];
+    for (int pattern = SERPENTINE; pattern < PATTERNS; pattern++) {
+      makePattern(original, side, side, pattern);
+      SketchSurface s = { pixels, (int16_t)side, (int16_t)side, mask };
+      for (int stack = 0; stack < 2; stack++) {
+        FillFn fill = stack ? tiny::sketchFill : sketchFill;
+        checkFill(fill, side, side, 0, 0, 0x5555);
+
+        const int N = (side == 64) ? 2000 : 500;
+        int painted = 0;
+        double t0 = benchSeconds();
+        for (int i = 0; i < N; i++) {
+          memcpy(pixels, original, sizeof(uint16_t) * side * side);
+          SketchRect damage;
+          painted = fill(&s, 0, 0, 0x5555, &damage);
+        }
+        double seconds = benchSeconds() - t0;
+        char line[128];
+        snprintf(line, sizeof(line), "fill %dx%d %s, %s stack: %d pixels, %.1f us per fill (copy included)", side,
+                 side, PATTERN_NAMES[pattern], stack ? "4 seed" : "128 seed", painted, seconds / N * 1e6);
+        TEST_MESSAGE(line);
+      }
+    }
+  }
+}
+
+// ---------- shapes ---------- //
+
+static bool plotted[MAX_SIDE][MAX_SIDE];
+static int plotCount;
+
+static void plotInto(void*, int16_t x, int16_t y, int16_t w) {
+  for (int16_t i = 0; i < w; i++) {
+    int px = x + i + MAX_SIDE / 2, py = y + MAX_SIDE / 2;      // shapes are centered on 0,0
+    TEST_ASSERT_TRUE(px >= 0 && py >= 0 && px < MAX_SIDE && py < MAX_SIDE);
+    plotted[py][px] = true;
+    plotCount++;
+  }
+}
+
+static void clearPlot() {
+  memset(plotted, 0, sizeof(plotted));
+  plotCount = 0;
+}
+
+static bool at(int x, int y) {
+  return plotted[y + MAX_SIDE / 2][x + MAX_SIDE / 2];
+}
+
+static void test_line() {
+  for (int round = 0; round < 5000; round++) {
+    int x0 = (int)(next() % 100) - 50, y0 = (int)(next() % 100) - 50;
+    int x1 = (int)(next() % 100) - 50, y1 = (int)(next() % 100) - 50;
+    clearPlot();
+    sketchLine((int16_t)x0, (int16_t)y0, (int16_t)x1, (int16_t)y1, plotInto, nullptr);
+    int dx = abs(x1 - x0), dy = abs(y1 - y0);
+    // one pixel per step along the long axis, both ends, each within half a pixel of the true line
+    TEST_ASSERT_EQUAL_INT((dx > dy ? dx : dy) + 1, plotCount);
+    TEST_ASSERT_TRUE(at(x0, y0) && at(x1, y1));
+    double len = sqrt((double)dx * dx + (double)dy * dy);
+    for (int y = -50; y < 50; y++) {
+      for (int x = -50; x < 50; x++) {
+        if (!at(x, y) || len == 0) continue;
+        double dist = fabs((double)(x1 - x0) * (y0 - y) - (double)(x0 - x) * (y1 - y0)) / len;
+        TEST_ASSERT_TRUE(dist <= 0.5 * (dx > dy ? len / dx : len / dy) + 1e-9);
+      }
+    }
+  }
+}
+
+static void test_rect_and_brush() {
+  for (int round = 0; round < 2000; round++) {
+    int x0 = (int)(next() % 100) - 50, y0 = (int)(next() % 100) - 50;
+    int x1 = (int)(next() % 100) - 50, y1 = (int)(next() % 100) - 50;
+    clearPlot();
+    sketchRect((int16_t)x0, (int16_t)y0, (int16_t)x1, (int16_t)y1, plotInto, nullptr);
+    int l = x0 < x1 ? x0 : x1, r = x0 < x1 ? x1 : x0, t = y0 < y1 ? y0 : y1, b = y0 < y1 ? y1 : y0;
+    int outline = 0;
+    for (int y = -50; y < 50; y++) {
+      for (int x = -50; x < 50; x++) {
+        bool on = x >= l && x <= r && y >= t && y <= b && (x == l || x == r || y == t || y == b);
+        TEST_ASSERT_EQUAL(on, at(x, y));
+        outline += on;
+      }
+    }
+    TEST_ASSERT_EQUAL_INT(outline, plotCount);           // no pixel twice
+  }
+
+  clearPlot();
+  sketchBrush(0, 0, plotInto, nullptr);
+  TEST_ASSERT_EQUAL_INT(SKETCH_BRUSH_SIZE * SKETCH_BRUSH_SIZE, plotCount);
+  TEST_ASSERT_TRUE(at(-1, -1) && at(1, 1) && !at(2, 0));
+}
+
+static void test_circle() {
+  for (int r = 0; r < 50; r++) {
+    clearPlot();
+    sketchCircle(0, 0, (int16_t)r, 0, plotInto, nullptr);
+    for (int y = -55; y < 55; y++) {
+      for (int x = -55; x < 55; x++) {
+        if (!at(x, y)) continue;
+        TEST_ASSERT_TRUE(fabs(sqrt((double)x * x + y * y) - r) < 1.0);
+        TEST_ASSERT_TRUE(at(-x, y) && at(x, -y) && at(y, x));      // 8-fold symmetric
+      }
+    }
+    // reaches the radius on both axes
+    TEST_ASSERT_TRUE(at(r, 0) && at(-r, 0) && at(0, r) && at(0, -r));
+  }
+
+  // a point not on an axis: the radius is the distance rounded to the nearest pixel
+  clearPlot();
+  sketchCircle(0, 0, 3, 4, plotInto, nullptr);
+  TEST_ASSERT_TRUE(at(5, 0));
+  clearPlot();
+  sketchCircle(0, 0, 4, 4, plotInto, nullptr);           // 5.66 -> 6
+  TEST_ASSERT_TRUE(at(6, 0) && !at(5, 0));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fill_matches_reference);
+  RUN_TEST(test_fill_stays_in_its_buffers);
+  RUN_TEST(test_fill_worst_case);
+  RUN_TEST(test_line);
+  RUN_TEST(test_rect_and_brush);
+  RUN_TEST(test_circle);
+  return UNITY_END();
+}
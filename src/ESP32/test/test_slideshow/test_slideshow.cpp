@@ -0,0 +1,174 @@
+/**
+ * @file test_slideshow.cpp
+ * @brief slideshow auto advance: off screen preparation, dwell timing and the cross-fade
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Every slide is drawn once on its own canvas as the reference. The slideshow then runs on the host clock: the canvas
+ * must not change while the next slide is prepared off screen, the fade must start at the dwell time, stay close to a
+ * one step blend of the two slides while it runs, and end on exactly the reference image of the next slide.
+ *
+ */
+
+#include <unity.h>
+#include "PixelArt/PixelArt.h"
+#include "Display/Blitter.h"
+#include "../bench.h"
+
+#define W CANVAS_WIDTH
+#define H CANVAS_HEIGHT
+#define SLIDES 7                        // built in ones, no flash assets
+#define ANIMATED_SLIDE 6                // Pac-Man
+#define FADE_MS 400
+#define DWELL_MS 1000
+
+static MatrixPanel_I2S_DMA* panel;
+static VirtualCanvas* canvas;
+static uint16_t expected[SLIDES][W * H];
+
+static VirtualCanvas* makeCanvas() {
+  panel = new MatrixPanel_I2S_DMA(HUB75_I2S_CFG(PANEL_WIDTH, PANEL_HEIGHT, PANELS_NUMBER));
+  panel->begin();
+  VirtualCanvas* c = new VirtualCanvas(panel, CHAIN_ROWS, ROTATE_0);
+  c->begin();
+  return c;
+}
+
+static void goToSlide(int slide) {
+  while (getCurrentImageIndex() != slide) nextImage();
+}
+
+// the loop in main.cpp calls this every pass, here every millisecond
+static void runUntil(unsigned long until) {
+  while (millis() < until) {
+    hostAdvanceMs(1);
+    updateCurrentImage(canvas, millis());
+  }
+}
+
+static int channelError(uint16_t a, uint16_t b) {
+  int dr = abs((a >> 11) - (b >> 11));
+  int dg = abs(((a >> 5) & 0x3F) - ((b >> 5) & 0x3F)) / 2;
+  int db = abs((a & 0x1F) - (b & 0x1F));
+  return std::max(dr, std::max(dg, db));
+}
+
+void setUp() {
+  canvas = makeCanvas();
+  if (toggleSlideshowAuto()) toggleSlideshowAuto();   // off
+  setSlideshowDwell(DWELL_MS);
+  goToSlide(0);
+}
+
+void tearDown() {
+  delete canvas;
+  delete panel;
+}
+
+static void test_references_differ() {
+  for (int s = 0; s < SLIDES; s++) {
+    goToSlide(s);
+    drawCurrentImage(canvas);
+    memcpy(expected[s], canvas->getBuffer(), sizeof(expected[s]));
+    if (s) TEST_ASSERT_TRUE(memcmp(expected[s], expected[s - 1], sizeof(expected[s])) != 0);
+  }
+}
+
+static void test_manual_stepping_wraps() {
+  prevImage();
+  TEST_ASSERT_EQUAL_INT(SLIDES - 1, getCurrentImageIndex());
+  nextImage();
+  TEST_ASSERT_EQUAL_INT(0, getCurrentImageIndex());
+
+  // without auto advance nothing moves on its own
+  drawCurrentImage(canvas);
+  runUntil(millis() + 3 * DWELL_MS);
+  TEST_ASSERT_EQUAL_INT(0, getCurrentImageIndex());
+  TEST_ASSERT_EQUAL_MEMORY(expected[0], canvas->getBuffer(), W * H * 2);
+}
+
+static void test_dwell_then_fade() {
+  drawCurrentImage(canvas);
+  unsigned long shown = millis();
+  TEST_ASSERT_TRUE(toggleSlideshowAuto());
+
+  // the next slide is rendered off screen, the canvas keeps slide 0 for the whole dwell
+  runUntil(shown + DWELL_MS - 1);
+  TEST_ASSERT_EQUAL_INT(0, getCurrentImageIndex());
+  TEST_ASSERT_EQUAL_MEMORY(expected[0], canvas->getBuffer(), W * H * 2);
+
+  // half way through the fade: a single blend of the two slides at that progress (one level of rounding allowed)
+  runUntil(shown + DWELL_MS + FADE_MS / 2);
+  uint8_t progress = (FADE_MS / 2 - 1) * BLEND_ALPHA_MAX / FADE_MS;
+  int worst = 0, changed = 0;
+  for (int i = 0; i < W * H; i++) {
+    uint16_t ref = blend565(expected[1][i], expected[0][i], progress);
+    worst = std::max(worst, channelError(ref, canvas->getBuffer()[i]));
+    changed += canvas->getBuffer()[i] != expected[0][i];
+  }
+  TEST_ASSERT_TRUE(changed > 0);
+  TEST_ASSERT_TRUE_MESSAGE(worst <= 1, "fade drifted from a plain blend");
+  TEST_ASSERT_EQUAL_INT(0, getCurrentImageIndex());
+
+  // ends on exactly the new slide, FADE_MS after the dwell
+  runUntil(shown + DWELL_MS + FADE_MS - 1);
+  TEST_ASSERT_EQUAL_INT(0, getCurrentImageIndex());
+  runUntil(shown + DWELL_MS + FADE_MS + 1);
+  TEST_ASSERT_EQUAL_INT(1, getCurrentImageIndex());
+  TEST_ASSERT_EQUAL_MEMORY(expected[1], canvas->getBuffer(), W * H * 2);
+}
+
+// all the way round, animated slide included: every slide lands exactly, on schedule
+static void test_full_cycle() {
+  drawCurrentImage(canvas);
+  TEST_ASSERT_TRUE(toggleSlideshowAuto());
+  unsigned long start = millis();
+  for (int n = 1; n <= SLIDES; n++) {
+    int slide = n % SLIDES;
+    unsigned long due = start + n * (DWELL_MS + FADE_MS);
+    runUntil(due - 3);
+    TEST_ASSERT_EQUAL_INT((n - 1) % SLIDES, getCurrentImageIndex());
+    runUntil(due + 3);
+    TEST_ASSERT_EQUAL_INT(slide, getCurrentImageIndex());
+    // the fade lands on the keyframe, an animated slide has moved on by a frame or so already
+    if (slide != ANIMATED_SLIDE) TEST_ASSERT_EQUAL_MEMORY(expected[slide], canvas->getBuffer(), W * H * 2);
+    start = millis() - 3 - n * (DWELL_MS + FADE_MS);
+  }
+
+  // turning it off mid dwell stops it there
+  TEST_ASSERT_FALSE(toggleSlideshowAuto());
+  runUntil(millis() + 3 * DWELL_MS);
+  TEST_ASSERT_EQUAL_INT(0, getCurrentImageIndex());
+}
+
+static void test_slide_speed() {
+  int n = 2000;
+  double t0 = benchSeconds();
+  for (int i = 0; i < n; i++) {
+    nextImage();
+    drawCurrentImage(canvas);
+  }
+  benchReport("slide render (all slides in turn)", n, "slide", benchSeconds() - t0);
+
+  // what a fade step costs: the new slide rendered, the old one blended over it
+  static uint16_t other[W * H];
+  n = 2000;
+  t0 = benchSeconds();
+  for (int i = 0; i < n; i++) {
+    nextImage();
+    drawCurrentImage(canvas);
+    blitBlend(canvas->getBuffer(), W, other, W, W, H, 1 + i % (BLEND_ALPHA_MAX - 1));
+  }
+  benchReport("fade step (render + full canvas blend)", n, "step", benchSeconds() - t0);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_references_differ);
+  RUN_TEST(test_manual_stepping_wraps);
+  RUN_TEST(test_dwell_then_fade);
+  RUN_TEST(test_full_cycle);
+  RUN_TEST(test_slide_speed);
+  return UNITY_END();
+}
@@ -0,0 +1,186 @@
+/**
+ * @file test_sprites.cpp
+ * @brief sprite engine: incremental rendering against a full redraw, culling, and sprites per frame
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The reference redraws the whole scene every frame (tilemap, then the sprites in z order, ties in slot order). The
+ * engine only rebuilds what changed, so after every frame the canvas has to match the reference everywhere.
+ *
+ */
+
+#include <unity.h>
+#include "../bench.h"
+#include "Engine/SpriteEngine.h"
+
+#define MAP_COLS 12
+#define MAP_ROWS 10
+#define BACKGROUND 0x0841
+
+static MatrixPanel_I2S_DMA* panel;
+static VirtualCanvas* canvas;
+
+static uint16_t tilePixels[4 * ENGINE_TILE_SIZE * ENGINE_TILE_SIZE];
+static const Tileset tileset = {tilePixels, 4};
+static uint8_t cells[MAP_COLS * MAP_ROWS];
+static const Tilemap tilemap = {&tileset, cells, MAP_COLS, MAP_ROWS};
+
+static uint16_t smallPixels[6 * 5];
+static uint16_t bigPixels[16 * 16];
+static const SpriteImage smallImage = {smallPixels, 6, 5};
+static const SpriteImage bigImage = {bigPixels, 16, 16};
+
+static uint16_t reference[CANVAS_WIDTH * CANVAS_HEIGHT];
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+void setUp() {
+  seed = 99;
+  for (int i = 0; i < 4 * ENGINE_TILE_SIZE * ENGINE_TILE_SIZE; i++) tilePixels[i] = (uint16_t)(0x1000 + i);
+  for (int i = 0; i < MAP_COLS * MAP_ROWS; i++) cells[i] = i % 5;        // 4 is past the tileset: background
+  for (int i = 0; i < 6 * 5; i++) smallPixels[i] = (i % 4 == 0) ? SPRITE_TRANSPARENT : (uint16_t)(0xA000 + i);
+  for (int i = 0; i < 16 * 16; i++) bigPixels[i] = (i % 7 == 0) ? SPRITE_TRANSPARENT : (uint16_t)(0x5000 + i);
+
+  panel = new MatrixPanel_I2S_DMA(HUB75_I2S_CFG(PANEL_WIDTH, PANEL_HEIGHT, PANELS_NUMBER));
+  panel->begin();
+  canvas = new VirtualCanvas(panel);
+  canvas->begin();
+  engineInit(canvas, BACKGROUND);
+  engineSetTilemap(&tilemap);
+}
+
+void tearDown() {
+  engineClearSprites();
+  delete canvas;
+  delete panel;
+}
+
+static void drawReference(Sprite* const* order, int count) {
+  for (int y = 0; y < CANVAS_HEIGHT; y++) {
+    for (int x = 0; x < CANVAS_WIDTH; x++) {
+      int col = x / ENGINE_TILE_SIZE, row = y / ENGINE_TILE_SIZE;
+      uint16_t c = BACKGROUND;
+      if (col < MAP_COLS && row < MAP_ROWS && cells[row * MAP_COLS + col] < tileset.tileCount) {
+        c = tilePixels[cells[row * MAP_COLS + col] * 64 + (y % ENGINE_TILE_SIZE) * ENGINE_TILE_SIZE + x % ENGINE_TILE_SIZE];
+      }
+      reference[y * CANVAS_WIDTH + x] = c;
+    }
+  }
+
+  // painter's algorithm, stable on z
+  for (int z = 0; z < 256; z++) {
+    for (int i = 0; i < count; i++) {
+      const Sprite* s = order[i];
+      if (s->z != z || !s->visible) continue;
+      for (int y = 0; y < s->image->height; y++) {
+        for (int x = 0; x < s->image->width; x++) {
+          int cx = s->x + x, cy = s->y + y;
+          uint16_t c = s->image->pixels[y * s->image->width + x];
+          if (cx < 0 || cy < 0 || cx >= CANVAS_WIDTH || cy >= CANVAS_HEIGHT || c == SPRITE_TRANSPARENT) continue;
+          reference[cy * CANVAS_WIDTH + cx] = c;
+        }
+      }
+    }
+  }
+}
+
+static void assertCanvasIsReference(Sprite* const* order, int count) {
+  drawReference(order, count);
+  TEST_ASSERT_EQUAL_MEMORY(reference, canvas->getBuffer(), sizeof(reference));
+}
+
+static void test_incremental_matches_full_redraw() {
+  Sprite* sprites[MAX_SPRITES];
+  for (int i = 0; i < MAX_SPRITES; i++) {
+    sprites[i] = engineAddSprite((i & 1) ? &bigImage : &smallImage, (int)(next() % 140) - 10, (int)(next() % 140) - 10, next() % 4);
+    TEST_ASSERT_NOT_NULL(sprites[i]);
+  }
+  TEST_ASSERT_NULL(engineAddSprite(&smallImage, 0, 0, 0));
+
+  engineRender();
+  assertCanvasIsReference(sprites, MAX_SPRITES);
+
+  for (int frame = 0; frame < 200; frame++) {
+    for (int k = 0; k < 4; k++) {
+      Sprite* s = sprites[next() % MAX_SPRITES];
+      switch (next() % 5) {
+        case 0: s->x += (int)(next() % 7) - 3; break;
+        case 1: s->y += (int)(next() % 7) - 3; break;
+        case 2: s->z = next() % 4; break;
+        case 3: s->visible = !s->visible; break;
+        case 4: s->image = (s->image == &bigImage) ? &smallImage : &bigImage; break;
+      }
+    }
+    if (frame % 50 == 0) engineSetTile(next() % MAP_COLS, next() % MAP_ROWS, next() % 5);
+    engineRender();
+    assertCanvasIsReference(sprites, MAX_SPRITES);
+  }
+}
+
+static void test_remove_restores_background() {
+  Sprite* s = engineAddSprite(&bigImage, 20, 20, 1);
+  engineRender();
+  engineRemoveSprite(s);
+  engineRender();
+  assertCanvasIsReference(nullptr, 0);
+}
+
+static void test_idle_frame_does_nothing() {
+  Sprite* s = engineAddSprite(&bigImage, 20, 20, 1);
+  engineRender();
+  canvas->flush();
+  engineRender();
+  TEST_ASSERT_EQUAL(0, engineGetStats().spans);
+  TEST_ASSERT_EQUAL(0, engineGetStats().spritesDrawn);
+
+  s->x = -100;                                        // off the canvas: culled, and its old place cleared
+  engineRender();
+  TEST_ASSERT_EQUAL(1, engineGetStats().spritesCulled);
+  TEST_ASSERT_GREATER_THAN(0, engineGetStats().spans);
+  assertCanvasIsReference(&s, 1);
+}
+
+static void test_benchmark_sprites_per_frame() {
+  static const int counts[] = {4, 16, 32};
+  for (int c = 0; c < 3; c++) {
+    for (int big = 0; big < 2; big++) {
+      const SpriteImage* image = big ? &bigImage : &smallImage;
+      engineClearSprites();
+      Sprite* sprites[MAX_SPRITES];
+      for (int i = 0; i < counts[c]; i++) sprites[i] = engineAddSprite(image, next() % 110, next() % 110, i & 3);
+      engineRender();
+
+      const int frames = 5000;
+      uint32_t blits = 0;
+      double t0 = benchSeconds();
+      for (int f = 0; f < frames; f++) {
+        for (int i = 0; i < counts[c]; i++) {       // everything moves every frame
+          sprites[i]->x = (sprites[i]->x + 1 + (i & 1)) % 112;
+          sprites[i]->y = (sprites[i]->y + 1) % 112;
+        }
+        engineRender();
+        blits += engineGetStats().spritesDrawn;
+      }
+      double t = benchSeconds() - t0;
+
+      char name[64];
+      snprintf(name, sizeof(name), "%2d moving %dx%d sprites (%.1f blits/frame)", counts[c], image->width,
+               image->height, (double)blits / frames);
+      benchReport(name, frames, "frame", t);
+    }
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_incremental_matches_full_redraw);
+  RUN_TEST(test_remove_restores_background);
+  RUN_TEST(test_idle_frame_does_nothing);
+  RUN_TEST(test_benchmark_sprites_per_frame);
+  return UNITY_END();
+}
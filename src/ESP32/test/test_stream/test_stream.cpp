@@ -0,0 +1,289 @@
+/**
+ * @file test_stream.cpp
+ * @brief frame stream decoder: frames split anywhere, damaged frames and resync, decode and link frame rates
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * encodeFrame() below writes the format of include/Remote/FrameStream.h the way tools/stream_encode.py does (changed
+ * 8x8 tiles, literal / run ops, Fletcher-16), so sequences of frames can be pushed through the decoder in pieces of
+ * every size. The framebuffer has a guard border around it that must never be written.
+ *
+ * Frame rates are given two ways: how fast the decoder itself goes on this machine, and what the encoded size of each
+ * frame allows over the 2 Mbaud USB serial link (10 bits per byte), which is the limit on the board.
+ *
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <vector>
+#include "Remote/FrameStream.h"
+#include "../bench.h"
+
+#define W 128
+#define H 128
+#define STRIDE (W + 16)
+#define GUARD 8
+#define TILES ((W / STREAM_TILE) * (H / STREAM_TILE))
+#define LINK_BAUD 2000000
+
+typedef std::vector<uint8_t> Bytes;
+
+static uint16_t framebuffer[(H + 2 * GUARD) * STRIDE];
+static uint16_t* const origin = framebuffer + GUARD * STRIDE + GUARD;
+static FrameStream fs;
+static uint32_t seed;
+
+static int tilesReported;
+static bool tileSeen[TILES];
+static int framesOk, framesBad;
+static uint8_t lastSeq;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+static void put16(Bytes& out, uint16_t v) {
+  out.push_back(v & 0xFF);
+  out.push_back(v >> 8);
+}
+
+static void tileOps(Bytes& out, const uint16_t* img, int tx, int ty) {
+  uint16_t px[STREAM_TILE * STREAM_TILE];
+  for (int i = 0; i < STREAM_TILE * STREAM_TILE; i++) {
+    px[i] = img[(ty * STREAM_TILE + i / STREAM_TILE) * W + tx * STREAM_TILE + i % STREAM_TILE];
+  }
+  int i = 0;
+  while (i < 64) {
+    int run = 1;
+    while (i + run < 64 && px[i + run] == px[i] && run < 128) run++;
+    if (run >= 2) {
+      out.push_back(0x80 | (run - 1));
+      put16(out, px[i]);
+      i += run;
+      continue;
+    }
+    int lit = 1;
+    while (i + lit < 64 && lit < 128 && !(i + lit + 1 < 64 && px[i + lit] == px[i + lit + 1])) lit++;
+    out.push_back(lit - 1);
+    for (int k = 0; k < lit; k++) put16(out, px[i + k]);
+    i += lit;
+  }
+}
+
+// frame with the tiles that differ from prev (all of them for a keyframe)
+static Bytes encodeFrame(const uint16_t* img, const uint16_t* prev, uint8_t seq, bool key) {
+  Bytes out = { STREAM_SYNC0, STREAM_SYNC1, seq, (uint8_t)(key ? STREAM_FLAG_KEYFRAME : 0), 0, 0 };
+  int count = 0;
+  for (int t = 0; t < TILES; t++) {
+    int tx = t % (W / STREAM_TILE), ty = t / (W / STREAM_TILE);
+    bool changed = key;
+    for (int y = 0; y < STREAM_TILE && !changed; y++) {
+      int o = (ty * STREAM_TILE + y) * W + tx * STREAM_TILE;
+      changed = memcmp(img + o, prev + o, STREAM_TILE * 2) != 0;
+    }
+    if (!changed) continue;
+    put16(out, t);
+    tileOps(out, img, tx, ty);
+    count++;
+  }
+  out[4] = count & 0xFF;
+  out[5] = count >> 8;
+  uint16_t s1 = 0, s2 = 0;
+  for (size_t i = 2; i < out.size(); i++) {
+    s1 = (s1 + out[i]) % 255;
+    s2 = (s2 + s1) % 255;
+  }
+  put16(out, (s2 << 8) | s1);
+  return out;
+}
+
+static void onTile(void*, int x, int y) {
+  TEST_ASSERT_EQUAL_INT(0, x % STREAM_TILE);
+  TEST_ASSERT_EQUAL_INT(0, y % STREAM_TILE);
+  tileSeen[(y / STREAM_TILE) * (W / STREAM_TILE) + x / STREAM_TILE] = true;
+  tilesReported++;
+}
+
+static void onFrame(void*, uint8_t seq, bool ok) {
+  if (ok) framesOk++;
+  else framesBad++;
+  lastSeq = seq;
+}
+
+// feed in random pieces of 1..maxPiece bytes
+static void feed(const Bytes& data, int maxPiece) {
+  size_t i = 0;
+  while (i < data.size()) {
+    size_t n = std::min<size_t>(1 + next() % maxPiece, data.size() - i);
+    frameStreamFeed(&fs, data.data() + i, n);
+    i += n;
+  }
+}
+
+static void checkImage(const uint16_t* img) {
+  for (int y = 0; y < H; y++) TEST_ASSERT_EQUAL_MEMORY(img + y * W, origin + y * STRIDE, W * 2);
+}
+
+static void checkGuard() {
+  for (int y = 0; y < H + 2 * GUARD; y++) {
+    for (int x = 0; x < STRIDE; x++) {
+      bool inside = y >= GUARD && y < GUARD + H && x >= GUARD && x < GUARD + W;
+      if (!inside) TEST_ASSERT_EQUAL_HEX16(0xDEAD, framebuffer[y * STRIDE + x]);
+    }
+  }
+}
+
+// a scene like the host demos: a background, a few moving rectangles, now and then noise
+static void stepScene(uint16_t* img, int frame, bool noisy) {
+  for (int i = 0; i < W * H; i++) img[i] = 0x0841;
+  for (int r = 0; r < 4; r++) {
+    int x = (frame * (r + 1) * 3 + r * 40) % (W - 20), y = (frame * (r + 2) + r * 25) % (H - 12);
+    for (int yy = y; yy < y + 12; yy++)
+      for (int xx = x; xx < x + 20; xx++) img[yy * W + xx] = 0xF800 >> (r * 3);
+  }
+  if (noisy) {
+    for (int i = 0; i < 300; i++) img[next() % (W * H)] = next();
+  }
+}
+
+void setUp() {
+  seed = 37;
+  for (auto& p : framebuffer) p = 0xDEAD;
+  frameStreamInit(&fs, origin, W, H, STRIDE);
+  fs.tileDone = onTile;
+  fs.frameDone = onFrame;
+  tilesReported = framesOk = framesBad = 0;
+}
+
+void tearDown() {}
+
+static void test_frames_in_any_pieces() {
+  static uint16_t img[W * H], prev[W * H];
+  memset(prev, 0, sizeof(prev));
+  const int PIECES[] = { 1, 2, 3, 7, 64, 1000, 100000 };
+  int expectedTiles = 0;
+  for (int f = 0; f < 140; f++) {
+    stepScene(img, f, f % 9 == 0);
+    Bytes frame = encodeFrame(img, prev, f, f == 0);
+    memset(tileSeen, 0, sizeof(tileSeen));
+    int before = tilesReported;
+    feed(frame, PIECES[f % 7]);
+    TEST_ASSERT_EQUAL_INT(f + 1, framesOk);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)f, lastSeq);
+    checkImage(img);
+    expectedTiles += frame[4] | (frame[5] << 8);
+    // only changed tiles were reported
+    for (int t = 0; t < TILES; t++) {
+      int o = (t / (W / STREAM_TILE)) * STREAM_TILE * W + (t % (W / STREAM_TILE)) * STREAM_TILE;
+      if (tileSeen[t] || f == 0) continue;
+      for (int y = 0; y < STREAM_TILE; y++) TEST_ASSERT_EQUAL_MEMORY(prev + o + y * W, img + o + y * W, STREAM_TILE * 2);
+    }
+    TEST_ASSERT_TRUE(tilesReported > before || memcmp(img, prev, sizeof(img)) == 0);
+    memcpy(prev, img, sizeof(img));
+  }
+  TEST_ASSERT_EQUAL_INT(0, framesBad);
+  TEST_ASSERT_EQUAL_INT(expectedTiles, tilesReported);
+  TEST_ASSERT_EQUAL_UINT32(140, fs.stats.frames);
+  checkGuard();
+}
+
+// a damaged frame is reported, bytes up to the next sync are skipped, and the keyframe the host sends back fixes it
+static void test_damage_and_resync() {
+  static uint16_t img[W * H], prev[W * H];
+  memset(prev, 0, sizeof(prev));
+  stepScene(img, 0, true);
+  Bytes key = encodeFrame(img, prev, 0, true);
+  feed(key, 50);
+  memcpy(prev, img, sizeof(img));
+
+  for (int trial = 0; trial < 300; trial++) {
+    stepScene(img, trial + 1, trial % 3 == 0);
+    Bytes frame = encodeFrame(img, prev, trial, false);
+    Bytes bad = frame;
+    switch (trial % 4) {
+      case 0: bad[2 + next() % (bad.size() - 2)] ^= 1 << (next() % 8); break;      // bit flip
+      case 1: bad.erase(bad.begin() + 2 + next() % (bad.size() - 2)); break;         // lost byte
+      case 2: bad.resize(2 + next() % (bad.size() - 2)); break;                      // cut short
+      case 3: bad.insert(bad.begin() + next() % bad.size(), 20, 0x37); break;        // line noise
+    }
+    int badBefore = framesBad, okBefore = framesOk;
+    feed(bad, 1 + trial % 40);
+    // noise before the sync does no harm: the frame itself still decodes
+    if (trial % 4 == 3 && framesOk == okBefore + 1) {
+      memcpy(prev, img, sizeof(img));
+      continue;
+    }
+
+    // the host answers a damaged frame with a keyframe (if the damage cut the checksum off, the keyframe's sync
+    // bytes are read as part of it first and it is the one reported)
+    Bytes recovery = encodeFrame(img, prev, trial, true);
+    feed(recovery, 1 + trial % 40);
+    if (framesOk == okBefore) {
+      // the damaged frame swallowed the start of the keyframe, a second one gets through
+      feed(recovery, 1 + trial % 40);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(framesBad > badBefore || trial % 4 == 3, "damage went unnoticed");
+    checkImage(img);
+    memcpy(prev, img, sizeof(img));
+  }
+  TEST_ASSERT_TRUE(fs.stats.errors > 150);
+  checkGuard();
+}
+
+// tile indices and ops that would write outside the image are refused
+static void test_bad_tiles_stay_inside() {
+  for (int trial = 0; trial < 5000; trial++) {
+    Bytes frame = { STREAM_SYNC0, STREAM_SYNC1, 1, 0, (uint8_t)(1 + next() % 3), 0 };
+    for (int n = 0; n < 40; n++) frame.push_back(next());
+    // every so often a plausible tile index near the end
+    if (trial & 1) {
+      frame[6] = (TILES - 1 + next() % 3) & 0xFF;
+      frame[7] = (TILES - 1 + next() % 3) >> 8;
+    }
+    feed(frame, 1 + trial % 16);
+  }
+  checkGuard();
+}
+
+static void test_frame_rates() {
+  static uint16_t img[W * H], prev[W * H];
+  char name[48], line[128];
+  struct Scene { const char* name; bool noisy; bool full; };
+  const Scene SCENES[] = { { "moving blocks", false, false }, { "blocks + noise", true, false }, { "full noise", false, true } };
+
+  for (const Scene& sc : SCENES) {
+    std::vector<Bytes> frames;
+    memset(prev, 0, sizeof(prev));
+    size_t bytes = 0;
+    for (int f = 0; f < 60; f++) {
+      if (sc.full) for (auto& p : img) p = next();
+      else stepScene(img, f, sc.noisy);
+      frames.push_back(encodeFrame(img, prev, f, f == 0));
+      if (f) bytes += frames.back().size();
+      memcpy(prev, img, sizeof(img));
+    }
+    double perFrame = bytes / 59.0;
+
+    int reps = sc.full ? 20 : 200;
+    double t0 = benchSeconds();
+    for (int r = 0; r < reps; r++)
+      for (auto& fr : frames) frameStreamFeed(&fs, fr.data(), fr.size());
+    snprintf(name, sizeof(name), "%s decode", sc.name);
+    benchReport(name, reps * frames.size(), "frame", benchSeconds() - t0);
+
+    snprintf(line, sizeof(line), "%s: %.0f bytes per frame, %.1f fps at 2 Mbaud", sc.name, perFrame,
+             LINK_BAUD / 10.0 / perFrame);
+    TEST_MESSAGE(line);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_frames_in_any_pieces);
+  RUN_TEST(test_damage_and_resync);
+  RUN_TEST(test_bad_tiles_stay_inside);
+  RUN_TEST(test_frame_rates);
+  return UNITY_END();
+}
@@ -0,0 +1,304 @@
+/**
+ * @file test_strokelog.cpp
+ * @brief Sketch session log: writing and reading back through an in-memory sink and source
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Sessions of random actions with waits from nothing to hours (and every wait around the one byte / varint limits) are
+ * written and read back; each event has to come out with its action and the exact tick it was recorded in, however long
+ * the session ran and wherever millis() wrapped. The source can hand out short reads, so events are split across
+ * chunk refills in every possible place.
+ *
+ */
+
+#include <unity.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <string.h>
+#include "EtchASketch/StrokeLog.h"
+#include "../bench.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+// a flash partition in memory: files show up once finished, writes fail past room
+class MemoryStore : public AssetSink, public AssetSource {
+public:
+  std::map<std::string, Bytes> files;
+  std::string path;
+  Bytes pending;
+  bool open = false;
+  bool refuse = false;                  // begin() fails (file could not be created)
+  int aborts = 0;
+  int reads = 0;
+  uint32_t room = 1 << 30;
+  uint32_t readLimit = 0;               // max bytes per read, 0 = as asked
+
+  bool begin(const char* p) override {
+    if (refuse) return false;
+    path = p;
+    pending.clear();
+    open = true;
+    return true;
+  }
+  bool write(const uint8_t* src, uint32_t len) override {
+    if (!open || pending.size() + len > room) return false;
+    pending.insert(pending.end(), src, src + len);
+    return true;
+  }
+  bool finish() override {
+    if (!open) return false;
+    files[path] = pending;
+    open = false;
+    return true;
+  }
+  void abort() override {
+    open = false;
+    aborts++;
+  }
+
+  int32_t fileSize(const char* p) override {
+    auto f = files.find(p);
+    return f == files.end() ? -1 : (int32_t)f->second.size();
+  }
+  int32_t read(const char* p, uint32_t offset, uint8_t* dst, uint32_t len) override {
+    reads++;
+    auto f = files.find(p);
+    if (f == files.end() || offset > f->second.size()) return -1;
+    if (readLimit && len > readLimit) len = readLimit;
+    uint32_t n = std::min<uint32_t>(len, (uint32_t)f->second.size() - offset);
+    memcpy(dst, f->second.data() + offset, n);
+    return n;
+  }
+};
+
+struct Recorded {
+  uint8_t action;
+  uint32_t atMs;                        // what the reader has to give back: the tick the event was in
+};
+
+static MemoryStore* store;
+static StrokeWriter writer;
+static StrokeReader reader;
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+void setUp() {
+  seed = 47;
+  store = new MemoryStore();
+}
+
+void tearDown() {
+  delete store;
+}
+
+// a wait in ms: mostly short (a turning RPG), sometimes around the encoding's limits, sometimes very long
+static uint32_t randomWait() {
+  uint32_t r = next() % 100;
+  if (r < 70) return next() % 70;                                        // fits the event byte
+  if (r < 85) return (7 + 0x7F + (next() % 3) - 1) * STROKE_TICK_MS + next() % STROKE_TICK_MS;   // varint 1 / 2 bytes
+  if (r < 99) return next() % 60000;
+  return next() % (2 * 3600 * 1000);                                     // up to two hours
+}
+
+static std::vector<Recorded> recordSession(const char* path, int events, uint32_t start) {
+  std::vector<Recorded> out;
+  TEST_ASSERT_TRUE(strokeWriterBegin(&writer, store, path, 64, 32, 5, start));
+  uint32_t now = start;
+  for (int i = 0; i < events; i++) {
+    now += randomWait();
+    uint8_t action = (uint8_t)(1 + next() % STROKE_MAX_ACTION);
+    strokeWriterAdd(&writer, action, now);
+    out.push_back({ action, (now - start) / STROKE_TICK_MS * STROKE_TICK_MS });
+  }
+  return out;
+}
+
+static void checkSession(const char* path, const std::vector<Recorded>& events) {
+  TEST_ASSERT_TRUE(strokeReaderBegin(&reader, store, path));
+  TEST_ASSERT_EQUAL_UINT16(64, reader.width);
+  TEST_ASSERT_EQUAL_UINT16(32, reader.height);
+  TEST_ASSERT_EQUAL_UINT8(5, reader.colorIndex);
+  StrokeEvent e;
+  for (size_t i = 0; i < events.size(); i++) {
+    TEST_ASSERT_TRUE(strokeReaderNext(&reader, &e));
+    TEST_ASSERT_EQUAL_UINT8(events[i].action, e.action);
+    TEST_ASSERT_EQUAL_UINT32(events[i].atMs, e.atMs);
+  }
+  TEST_ASSERT_FALSE(strokeReaderNext(&reader, &e));
+}
+
+static void test_round_trip() {
+  for (int session = 1; session <= 50; session++) {
+    char path[STROKE_PATH_LEN];
+    strokeSessionPath(path, session);
+    int events = 1 + (int)(next() % 5000);
+    uint32_t start = (session % 5 == 0) ? 0xFFFFFFFFu - (next() % 100000) : next();   // millis() about to wrap
+    store->readLimit = (session % 3 == 0) ? 1 + next() % 300 : 0;
+
+    std::vector<Recorded> recorded = recordSession(path, events, start);
+    uint32_t bytes = writer.bytes;
+    TEST_ASSERT_EQUAL_UINT32(events, writer.events);
+    TEST_ASSERT_TRUE(strokeWriterFinish(&writer));
+    TEST_ASSERT_EQUAL_INT32(bytes, store->fileSize(path));
+    checkSession(path, recorded);
+  }
+  TEST_ASSERT_EQUAL_INT(50, strokeSessionCount(store));
+}
+
+// one byte per event while the waits stay under 7 ticks, and the chunk buffer read once per STROKE_CHUNK
+static void test_size_and_reads() {
+  TEST_ASSERT_TRUE(strokeWriterBegin(&writer, store, "/sketch/0001.skl", 64, 64, 0, 1000));
+  const int N = 10000;
+  for (int i = 0; i < N; i++) strokeWriterAdd(&writer, (uint8_t)(1 + i % STROKE_MAX_ACTION), 1000 + i * 60);
+  TEST_ASSERT_TRUE(strokeWriterFinish(&writer));
+  TEST_ASSERT_EQUAL_INT32(STROKE_HEADER_BYTES + N, store->fileSize("/sketch/0001.skl"));
+
+  store->reads = 0;
+  TEST_ASSERT_TRUE(strokeReaderBegin(&reader, store, "/sketch/0001.skl"));
+  StrokeEvent e;
+  int n = 0;
+  while (strokeReaderNext(&reader, &e)) n++;
+  TEST_ASSERT_EQUAL_INT(N, n);
+  TEST_ASSERT_EQUAL_INT((STROKE_HEADER_BYTES + N + STROKE_CHUNK - 1) / STROKE_CHUNK + 1, store->reads);
+}
+
+// the encoding at its edges: 6 ticks in the byte, 7 the first varint, 7 + 127 / 7 + 128 one or two varint bytes, up
+// to five varint bytes (a month)
+static void test_wait_limits() {
+  const uint32_t TICKS[] = { 0, 1, 6, 7, 8, 7 + 127, 7 + 128, 7 + 16383, 7 + 16384, 7 + 0x10000000 };
+  const int N = sizeof(TICKS) / sizeof(TICKS[0]);
+  TEST_ASSERT_TRUE(strokeWriterBegin(&writer, store, "/limits", 1, 1, 0, 0));
+  uint32_t now = 0;
+  for (int i = 0; i < N; i++) {
+    now += TICKS[i] * STROKE_TICK_MS;
+    strokeWriterAdd(&writer, STROKE_MAX_ACTION, now + 9);    // rounding down within the tick
+  }
+  TEST_ASSERT_TRUE(strokeWriterFinish(&writer));
+
+  TEST_ASSERT_TRUE(strokeReaderBegin(&reader, store, "/limits"));
+  StrokeEvent e;
+  uint32_t at = 0;
+  for (int i = 0; i < N; i++) {
+    at += TICKS[i] * STROKE_TICK_MS;
+    TEST_ASSERT_TRUE(strokeReaderNext(&reader, &e));
+    TEST_ASSERT_EQUAL_UINT8(STROKE_MAX_ACTION, e.action);
+    TEST_ASSERT_EQUAL_UINT32(at, e.atMs);
+  }
+  TEST_ASSERT_FALSE(strokeReaderNext(&reader, &e));
+}
+
+// a file cut anywhere reads as a prefix of the session, never as something that was not recorded
+static void test_truncated() {
+  std::vector<Recorded> recorded = recordSession("/full", 300, 12345);
+  TEST_ASSERT_TRUE(strokeWriterFinish(&writer));
+  Bytes full = store->files["/full"];
+
+  for (size_t cut = 0; cut < full.size(); cut++) {
+    store->files["/cut"] = Bytes(full.begin(), full.begin() + cut);
+    if (!strokeReaderBegin(&reader, store, "/cut")) {
+      TEST_ASSERT_TRUE(cut < STROKE_HEADER_BYTES);
+      continue;
+    }
+    StrokeEvent e;
+    size_t n = 0;
+    while (strokeReaderNext(&reader, &e)) {
+      TEST_ASSERT_TRUE(n < recorded.size());
+      TEST_ASSERT_EQUAL_UINT8(recorded[n].action, e.action);
+      TEST_ASSERT_EQUAL_UINT32(recorded[n].atMs, e.atMs);
+      n++;
+    }
+  }
+
+  store->files["/bad"] = Bytes(full.begin(), full.end());
+  store->files["/bad"][3] = '2';                         // not SKL1
+  TEST_ASSERT_FALSE(strokeReaderBegin(&reader, store, "/bad"));
+  TEST_ASSERT_FALSE(strokeReaderBegin(&reader, store, "/missing"));
+  TEST_ASSERT_FALSE(strokeReaderBegin(&reader, store, "/a/path/that/is/far/too/long.skl"));
+}
+
+static void test_discarded_sessions() {
+  // nothing recorded
+  TEST_ASSERT_TRUE(strokeWriterBegin(&writer, store, "/empty", 64, 64, 0, 0));
+  strokeWriterAdd(&writer, 0, 10);                       // not an action
+  strokeWriterAdd(&writer, STROKE_MAX_ACTION + 1, 20);
+  TEST_ASSERT_FALSE(strokeWriterFinish(&writer));
+  TEST_ASSERT_EQUAL_INT32(-1, store->fileSize("/empty"));
+  TEST_ASSERT_EQUAL_INT(1, store->aborts);
+
+  // out of space part way: the whole session is dropped, later actions are ignored
+  store->room = 1000;
+  recordSession("/full", 3000, 0);
+  TEST_ASSERT_TRUE(writer.failed);
+  TEST_ASSERT_FALSE(strokeWriterFinish(&writer));
+  TEST_ASSERT_EQUAL_INT32(-1, store->fileSize("/full"));
+  TEST_ASSERT_EQUAL_INT(2, store->aborts);
+  strokeWriterAdd(&writer, 1, 0);
+  TEST_ASSERT_FALSE(strokeWriterFinish(&writer));
+
+  // the file could not be created
+  store->refuse = true;
+  TEST_ASSERT_FALSE(strokeWriterBegin(&writer, store, "/never", 64, 64, 0, 0));
+  strokeWriterAdd(&writer, 1, 10);
+  TEST_ASSERT_FALSE(strokeWriterFinish(&writer));
+  TEST_ASSERT_FALSE(strokeWriterBegin(&writer, nullptr, "/never", 64, 64, 0, 0));
+}
+
+static void test_session_numbering() {
+  char path[STROKE_PATH_LEN];
+  strokeSessionPath(path, 1);
+  TEST_ASSERT_EQUAL_STRING("/sketch/0001.skl", path);
+  strokeSessionPath(path, STROKE_MAX_SESSIONS);
+  TEST_ASSERT_EQUAL_STRING("/sketch/0999.skl", path);
+
+  TEST_ASSERT_EQUAL_INT(0, strokeSessionCount(store));
+  for (int n = 1; n <= 7; n++) {
+    if (n == 6) continue;                                // a gap ends the list
+    strokeSessionPath(path, n);
+    store->files[path] = Bytes(1, 0);
+  }
+  TEST_ASSERT_EQUAL_INT(5, strokeSessionCount(store));
+}
+
+static void test_benchmark() {
+  const int N = 2000000;
+  std::vector<uint32_t> times(N);
+  uint32_t now = 0;
+  for (int i = 0; i < N; i++) times[i] = (now += randomWait());
+
+  double t0 = benchSeconds();
+  TEST_ASSERT_TRUE(strokeWriterBegin(&writer, store, "/bench", 64, 64, 0, 0));
+  for (int i = 0; i < N; i++) strokeWriterAdd(&writer, (uint8_t)(1 + (i & 15)), times[i]);
+  TEST_ASSERT_TRUE(strokeWriterFinish(&writer));
+  benchReport("strokeWriterAdd", N, "event", benchSeconds() - t0);
+
+  char line[96];
+  snprintf(line, sizeof(line), "random session: %.2f bytes per event", (double)store->fileSize("/bench") / N);
+  TEST_MESSAGE(line);
+
+  t0 = benchSeconds();
+  TEST_ASSERT_TRUE(strokeReaderBegin(&reader, store, "/bench"));
+  StrokeEvent e;
+  int n = 0;
+  while (strokeReaderNext(&reader, &e)) n++;
+  benchReport("strokeReaderNext", N, "event", benchSeconds() - t0);
+  TEST_ASSERT_EQUAL_INT(N, n);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_size_and_reads);
+  RUN_TEST(test_wait_limits);
+  RUN_TEST(test_truncated);
+  RUN_TEST(test_discarded_sessions);
+  RUN_TEST(test_session_numbering);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
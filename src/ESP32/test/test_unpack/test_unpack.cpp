@@ -0,0 +1,432 @@
+/**
+ * @file test_unpack.cpp
+ * @brief packed asset decoder: LZSS round trips, the built in blob against its source art, corrupt streams
+ * @version 0.1
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * compress() below writes the stream format of include/Assets/Unpack.h the way tools/pack_assets.py does (greedy
+ * longest match in a 512 byte window), so random data can be round tripped through unpackRead() in pieces of any size.
+ * The blob that ships (PackedAssets.h) is decoded through builtinAsset() and compared with the character art and the
+ * palette file in assets/ it was built from.
+ *
+ * Reads assets/ relative to the project directory, where "pio test" runs the suites.
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include "Assets/BuiltinAssets.h"
+#include "../bench.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+static uint32_t seed;
+
+static uint32_t next() {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+void setUp() {
+  seed = 49;
+}
+
+void tearDown() {}
+
+// ---------- encoder ---------- //
+
+static Bytes compress(const Bytes& data) {
+  Bytes out;
+  size_t i = 0, n = data.size();
+  while (i < n) {
+    size_t flagAt = out.size();
+    out.push_back(0);
+    for (int bit = 0; bit < 8 && i < n; bit++) {
+      size_t bestLen = 0, bestDist = 0;
+      for (size_t start = i > UNPACK_WINDOW ? i - UNPACK_WINDOW : 0; start < i; start++) {
+        size_t len = 0;
+        while (len < 130 && i + len < n && data[start + len] == data[i + len]) len++;
+        if (len > bestLen) {
+          bestLen = len;
+          bestDist = i - start;
+        }
+      }
+      if (bestLen >= 3) {
+        uint16_t code = (bestDist - 1) | ((bestLen - 3) << 9);
+        out.push_back(code & 0xFF);
+        out.push_back(code >> 8);
+        i += bestLen;
+      }
+      else {
+        out[flagAt] |= 1 << bit;
+        out.push_back(data[i++]);
+      }
+    }
+  }
+  return out;
+}
+
+// random data of one of a few kinds: noise, a handful of symbols, runs, and blocks repeated from up to a window back
+static Bytes randomData(size_t n) {
+  Bytes d(n);
+  int kind = next() % 4;
+  for (size_t i = 0; i < n; i++) {
+    if (kind == 0) d[i] = next();
+    else if (kind == 1) d[i] = next() % 3;
+    else if (kind == 2) d[i] = (i && next() % 16) ? d[i - 1] : next();
+    else if (i > 4 && next() % 8) d[i] = d[i - 1 - next() % (i < UNPACK_WINDOW ? i : UNPACK_WINDOW)];
+    else d[i] = next();
+  }
+  return d;
+}
+
+// decode in random pieces into a buffer with a guard after it
+static Bytes decode(const Bytes& stream, size_t limit, bool* failed) {
+  UnpackStream s;
+  unpackBegin(&s, stream.data(), stream.size());
+  Bytes out;
+  uint8_t piece[800 + 16];
+  while (out.size() < limit) {
+    uint32_t want = 1 + next() % 800;
+    memset(piece, 0xA5, sizeof(piece));
+    uint32_t got = unpackRead(&s, piece, want);
+    TEST_ASSERT_LESS_OR_EQUAL(want, got);
+    for (uint32_t k = got; k < want + 16; k++) TEST_ASSERT_EQUAL_HEX8(0xA5, piece[k]);
+    out.insert(out.end(), piece, piece + got);
+    if (got < want) break;
+  }
+  *failed = s.failed;
+  return out;
+}
+
+// ---------- codec ---------- //
+
+static void test_round_trip() {
+  static const size_t SIZES[] = { 0, 1, 2, 3, 8, 9, 130, 131, 511, 512, 513, 1024, 4000 };
+  for (int round = 0; round < 400; round++) {
+    size_t n = round < 13 * 4 ? SIZES[round % 13] : next() % 6000;
+    Bytes data = randomData(n);
+    Bytes stream = compress(data);
+    bool failed;
+    Bytes out = decode(stream, n + 1000, &failed);
+    TEST_ASSERT_FALSE(failed);
+    TEST_ASSERT_EQUAL_UINT32(n, out.size());
+    if (n) TEST_ASSERT_EQUAL_MEMORY(data.data(), out.data(), n);
+  }
+}
+
+// the longest match, the furthest one, and a distance 1 run, each read one byte at a time so it is split across calls
+static void test_match_limits() {
+  Bytes data;
+  for (int i = 0; i < UNPACK_WINDOW; i++) data.push_back(next());
+  data.insert(data.end(), data.begin(), data.begin() + 130);              // 512 back, 130 long
+  data.insert(data.end(), 300, 7);                                        // a run: literal, then distance 1
+  Bytes stream = compress(data);
+
+  UnpackStream s;
+  unpackBegin(&s, stream.data(), stream.size());
+  Bytes out;
+  uint8_t b;
+  while (unpackRead(&s, &b, 1) == 1) out.push_back(b);
+  TEST_ASSERT_FALSE(s.failed);
+  TEST_ASSERT_EQUAL_UINT32(data.size(), out.size());
+  TEST_ASSERT_EQUAL_MEMORY(data.data(), out.data(), data.size());
+
+  // the 130 byte match really was one item at distance 512
+  bool found = false;
+  for (size_t i = 0; i + 1 < stream.size(); i++) found |= stream[i] == 0xFF && stream[i + 1] == 0xFF;
+  TEST_ASSERT_TRUE(found);
+}
+
+// a stream cut anywhere decodes to a prefix of the data
+static void test_truncated() {
+  for (int round = 0; round < 20; round++) {
+    Bytes data = randomData(200 + next() % 800);
+    Bytes stream = compress(data);
+    for (size_t cut = 0; cut <= stream.size(); cut++) {
+      Bytes part(stream.begin(), stream.begin() + cut);
+      bool failed;
+      Bytes out = decode(part, data.size() + 1000, &failed);
+      TEST_ASSERT_LESS_OR_EQUAL(data.size(), out.size());
+      if (!out.empty()) TEST_ASSERT_EQUAL_MEMORY(data.data(), out.data(), out.size());
+      if (cut == stream.size()) TEST_ASSERT_EQUAL_UINT32(data.size(), out.size());
+    }
+  }
+}
+
+// garbage never makes the decoder write past what it was asked for, and a match reaching before the start stops it
+static void test_corrupt() {
+  for (int round = 0; round < 3000; round++) {
+    Bytes stream(next() % 300);
+    for (auto& b : stream) b = next();
+    bool failed;
+    Bytes out = decode(stream, 100000, &failed);
+    TEST_ASSERT_LESS_OR_EQUAL(stream.size() * 130, out.size());
+  }
+
+  const uint8_t BEFORE_START[] = { 0x03, 'a', 'b', 0x02, 0x00 };          // two literals, then distance 3
+  bool failed;
+  Bytes out = decode(Bytes(BEFORE_START, BEFORE_START + sizeof(BEFORE_START)), 100, &failed);
+  TEST_ASSERT_TRUE(failed);
+  TEST_ASSERT_EQUAL_UINT32(2, out.size());
+}
+
+// ---------- blob ---------- //
+
+static void test_blob_table() {
+  PackInfo info;
+  PackEntry entry;
+  TEST_ASSERT_TRUE(builtinAsset(PACKED_PACKERS, &info, &entry));
+  Bytes blob(info.blob, info.blob + info.size);
+
+  TEST_ASSERT_FALSE(packOpen(blob.data(), PACK_HEADER_SIZE - 1, &info));
+  TEST_ASSERT_FALSE(packOpen(blob.data(), PACK_HEADER_SIZE + info.paletteCount * 2, &info));  // no room for the table
+  Bytes bad = blob;
+  bad[2] = PACK_VERSION + 1;
+  TEST_ASSERT_FALSE(packOpen(bad.data(), bad.size(), &info));
+
+  TEST_ASSERT_TRUE(packOpen(blob.data(), blob.size(), &info));
+  TEST_ASSERT_EQUAL(PACKED_COUNT, info.count);
+  TEST_ASSERT_FALSE(packEntry(info, -1, &entry));
+  TEST_ASSERT_FALSE(packEntry(info, PACKED_COUNT, &entry));
+  TEST_ASSERT_EQUAL_HEX16(0, packColor(info, info.paletteCount));
+
+  // an entry whose stream would run past the end of the blob
+  size_t e = PACK_HEADER_SIZE + info.paletteCount * 2;
+  bad = blob;
+  bad[e + 8] = 0xFF;
+  bad[e + 9] = 0xFF;
+  TEST_ASSERT_TRUE(packOpen(bad.data(), bad.size(), &info));
+  TEST_ASSERT_FALSE(packEntry(info, 0, &entry));
+}
+
+static uint16_t rgb565(int r, int g, int b) {
+  return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+// the default colors of tools/anim_encode.py
+static bool artColor(char ch, uint16_t* color) {
+  static const struct { char ch; uint8_t r, g, b; } COLORS[] = {
+    { '.', 0, 0, 0 },       { 'b', 0, 0, 0 },     { 'g', 0, 255, 0 },   { 'y', 255, 255, 0 },
+    { 'w', 255, 255, 255 }, { 'r', 255, 0, 0 },   { 'l', 0, 0, 255 },   { 'o', 255, 165, 0 },
+    { 'p', 128, 0, 128 },   { 'G', 128, 128, 128 }, { 'B', 0, 0, 255 },
+  };
+  for (auto& c : COLORS) {
+    if (c.ch == ch) {
+      *color = rgb565(c.r, c.g, c.b);
+      return true;
+    }
+  }
+  return false;
+}
+
+// first frame of an assets/ file as RGB565
+static bool readArt(const char* path, int* w, int* h, std::vector<uint16_t>& pixels) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  char line[512];
+  int frames = 0;
+  pixels.clear();
+  *w = *h = 0;
+  while (fgets(line, sizeof(line), f)) {
+    int len = strcspn(line, " \r\n");
+    if (line[0] == '#' || len == 0) continue;
+    if (!strncmp(line, "frame", 5)) {
+      frames++;
+      continue;
+    }
+    if (frames != 1) continue;
+    *w = len;
+    (*h)++;
+    for (int i = 0; i < len; i++) {
+      uint16_t c;
+      TEST_ASSERT_TRUE_MESSAGE(artColor(line[i], &c), path);
+      pixels.push_back(c);
+    }
+  }
+  fclose(f);
+  return frames > 0;
+}
+
+static void test_builtin_images_match_their_art() {
+  static const struct { int entry; const char* art; } IMAGES[] = {
+    { PACKED_PACKERS, "assets/packers.txt" }, { PACKED_IOWA, "assets/iowa.txt" },
+    { PACKED_CHARMANDER, "assets/charmander.txt" }, { PACKED_R2D2, "assets/r2d2.txt" },
+    { PACKED_LEBRON, "assets/lebron.txt" }, { PACKED_BEER, "assets/beer.txt" },
+  };
+  for (auto& image : IMAGES) {
+    int w = 0, h = 0;
+    std::vector<uint16_t> expected;
+    TEST_ASSERT_TRUE_MESSAGE(readArt(image.art, &w, &h, expected), image.art);
+
+    PackInfo info;
+    PackEntry entry;
+    TEST_ASSERT_TRUE(builtinAsset(image.entry, &info, &entry));
+    TEST_ASSERT_EQUAL(PACK_IMAGE, entry.type);
+    TEST_ASSERT_EQUAL(w, entry.width);
+    TEST_ASSERT_EQUAL(h, entry.height);
+
+    // row by row, the way the slideshow reads it
+    UnpackStream s;
+    unpackBegin(&s, entry.data, entry.size);
+    uint8_t row[256];
+    for (int y = 0; y < h; y++) {
+      TEST_ASSERT_EQUAL_UINT32(w, unpackRead(&s, row, w));
+      for (int x = 0; x < w; x++) {
+        TEST_ASSERT_LESS_THAN(info.paletteCount, row[x]);
+        TEST_ASSERT_EQUAL_HEX16_MESSAGE(expected[y * w + x], packColor(info, row[x]), image.art);
+      }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, unpackRead(&s, row, 1));                 // nothing after the last row
+    TEST_ASSERT_FALSE(s.failed);
+    TEST_ASSERT_EQUAL_UINT32(entry.size, s.pos);
+  }
+}
+
+// ---------- palettes ---------- //
+
+struct Named {
+  std::string name;
+  uint16_t color;
+};
+
+static Bytes paletteData(const std::vector<Named>& colors) {
+  Bytes d;
+  for (auto& c : colors) {
+    d.push_back(c.color & 0xFF);
+    d.push_back(c.color >> 8);
+    d.insert(d.end(), c.name.begin(), c.name.end());
+    d.push_back(0);
+  }
+  return d;
+}
+
+static void checkPalette(const PackEntry& entry, const std::vector<Named>& expected) {
+  uint16_t colors[16];
+  const char* names[16];
+  char text[256];
+  TEST_ASSERT_EQUAL(expected.size(), unpackPalette(entry, colors, names, 16, text, sizeof(text)));
+  for (size_t i = 0; i < expected.size(); i++) {
+    TEST_ASSERT_EQUAL_HEX16(expected[i].color, colors[i]);
+    TEST_ASSERT_EQUAL_STRING(expected[i].name.c_str(), names[i]);
+  }
+}
+
+static void test_sketch_palette_matches_its_file() {
+  FILE* f = fopen("assets/sketch_colors.txt", "r");
+  TEST_ASSERT_NOT_NULL(f);
+  std::vector<Named> expected;
+  char line[128], name[32];
+  int r, g, b;
+  while (fgets(line, sizeof(line), f)) {
+    if (sscanf(line, "color %31s %d %d %d", name, &r, &g, &b) == 4) expected.push_back({ name, rgb565(r, g, b) });
+  }
+  fclose(f);
+  TEST_ASSERT_EQUAL(7, expected.size());
+
+  PackInfo info;
+  PackEntry entry;
+  TEST_ASSERT_TRUE(builtinAsset(PACKED_SKETCH_COLORS, &info, &entry));
+  TEST_ASSERT_EQUAL(PACK_PALETTE, entry.type);
+  checkPalette(entry, expected);
+
+  // the screen's buffers: MAX_SKETCH_COLORS entries and 96 bytes of names
+  int text = 0;
+  for (auto& c : expected) text += c.name.size() + 1;
+  TEST_ASSERT_LESS_OR_EQUAL(96, text);
+  TEST_ASSERT_LESS_OR_EQUAL(16, expected.size());
+}
+
+static void test_palette_round_trip() {
+  for (int round = 0; round < 500; round++) {
+    std::vector<Named> colors(1 + next() % 16);
+    for (auto& c : colors) {
+      c.color = next();
+      for (int k = next() % 12; k > 0; k--) c.name += (char)('a' + next() % 26);
+    }
+    Bytes stream = compress(paletteData(colors));
+    PackEntry entry = { PACK_PALETTE, (uint8_t)colors.size(), 0, stream.data(), (uint32_t)stream.size() };
+    checkPalette(entry, colors);
+
+    // refused: too many colors for the caller, names that don't fit, the wrong type, a cut or padded stream
+    uint16_t values[16];
+    const char* names[16];
+    char text[256];
+    int need = 0;
+    for (auto& c : colors) need += c.name.size() + 1;
+    TEST_ASSERT_EQUAL(0, unpackPalette(entry, values, names, colors.size() - 1, text, sizeof(text)));
+    TEST_ASSERT_EQUAL(0, unpackPalette(entry, values, names, 16, text, need - 1));
+    TEST_ASSERT_EQUAL(colors.size(), unpackPalette(entry, values, names, 16, text, need));
+    entry.type = PACK_IMAGE;
+    TEST_ASSERT_EQUAL(0, unpackPalette(entry, values, names, 16, text, sizeof(text)));
+    entry.type = PACK_PALETTE;
+    entry.size--;
+    TEST_ASSERT_EQUAL(0, unpackPalette(entry, values, names, 16, text, sizeof(text)));
+    Bytes padded = paletteData(colors);
+    padded.push_back(0);
+    Bytes longer = compress(padded);
+    PackEntry extra = { PACK_PALETTE, (uint8_t)colors.size(), 0, longer.data(), (uint32_t)longer.size() };
+    TEST_ASSERT_EQUAL(0, unpackPalette(extra, values, names, 16, text, sizeof(text)));
+  }
+}
+
+// ---------- speed ---------- //
+
+static void test_benchmark() {
+  Bytes data;
+  for (int i = 0; i < 4; i++) {
+    Bytes part = randomData(64 * 1024);
+    data.insert(data.end(), part.begin(), part.end());
+  }
+  Bytes stream = compress(data);
+  Bytes out(data.size());
+  int n = 0;
+  double t0 = benchSeconds();
+  while (n < 10 || benchSeconds() - t0 < 0.2) {
+    UnpackStream s;
+    unpackBegin(&s, stream.data(), stream.size());
+    TEST_ASSERT_EQUAL_UINT32(data.size(), unpackRead(&s, out.data(), out.size()));
+    n++;
+  }
+  benchReport("decode, mixed data", (double)n * data.size(), "B", benchSeconds() - t0);
+
+  // every built in image row by row, as the slideshow does when each is shown
+  n = 0;
+  uint32_t pixels = 0;
+  t0 = benchSeconds();
+  while (n < 100 || benchSeconds() - t0 < 0.2) {
+    for (int i = PACKED_PACKERS; i <= PACKED_BEER; i++) {
+      PackInfo info;
+      PackEntry entry;
+      UnpackStream s;
+      uint8_t row[256];
+      builtinAsset(i, &info, &entry);
+      unpackBegin(&s, entry.data, entry.size);
+      for (int y = 0; y < entry.height; y++) pixels += unpackRead(&s, row, entry.width);
+    }
+    n++;
+  }
+  double seconds = benchSeconds() - t0;
+  char line[96];
+  snprintf(line, sizeof(line), "all six built in images: %.1f us (%u pixels each pass)", seconds / n * 1e6,
+           (unsigned)(pixels / n));
+  TEST_MESSAGE(line);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_match_limits);
+  RUN_TEST(test_truncated);
+  RUN_TEST(test_corrupt);
+  RUN_TEST(test_blob_table);
+  RUN_TEST(test_builtin_images_match_their_art);
+  RUN_TEST(test_sketch_palette_matches_its_file);
+  RUN_TEST(test_palette_round_trip);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+"""
+@file anim_encode.py
+@brief builds delta frame animations (see include/PixelArt/Animation.h) from ASCII frames
+@version 0.1
+
+@copyright Copyright (c) 2025
+
+Input is the same character art the slideshow uses, one block of rows per frame ('#' starts a comment line):
+
+    color y 255 255 0        (optional, add or override a color character)
+    frame 90                 (starts a frame shown for 90 ms)
+    ....yyyy....
+    ..yyyyyyyy..
+    ...
+
+'.' is black, the other characters default to the slideshow colors (DEFAULT_COLORS below).
+
+Output is a C header with the animation as a const byte array. --check decodes the result again, compares every frame
+with the input and prints the compression ratio against raw RGB565 frames.
+
+usage: anim_encode.py input.txt -n pacman_anim -o include/PixelArt/PacmanAnim.h [--check]
+       anim_encode.py input.txt -o data/img/heart.anim --raw     (file for the flash filesystem)
+"""
+
+import argparse
+import sys
+
+# the slideshow colors (tools/pack_assets.py uses them for the built in images too)
+DEFAULT_COLORS = {
+    '.': (0, 0, 0),
+    'b': (0, 0, 0),
+    'g': (0, 255, 0),
+    'y': (255, 255, 0),
+    'w': (255, 255, 255),
+    'r': (255, 0, 0),
+    'l': (0, 0, 255),
+    'o': (255, 165, 0),
+    'p': (128, 0, 128),
+    'G': (128, 128, 128),
+    'B': (0, 0, 255),
+}
+
+MAX_LITERAL = 128
+MAX_RUN = 64
+MIN_RUN = 3
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def parse(path):
+    """returns (frames, durations, colors). frames are lists of equal length strings"""
+    colors = dict(DEFAULT_COLORS)
+    frames, durations = [], []
+    with open(path) as f:
+        for lineno, raw in enumerate(f, 1):
+            line = raw.rstrip('\n').rstrip()
+            if not line or line.startswith('#'):
+                continue
+            words = line.split()
+            if words[0] == 'color' and len(words) == 5:
+                colors[words[1]] = tuple(int(v) for v in words[2:5])
+            elif words[0] == 'frame':
+                frames.append([])
+                durations.append(int(words[1]) if len(words) > 1 else 100)
+            elif not frames:
+                sys.exit(f"{path}:{lineno}: pixels before the first 'frame' line")
+            else:
+                frames[-1].append(line)
+
+    if not frames:
+        sys.exit(f"{path}: no frames")
+    height, width = len(frames[0]), len(frames[0][0])
+    for i, fr in enumerate(frames):
+        if len(fr) != height or any(len(row) != width for row in fr):
+            sys.exit(f"{path}: frame {i} is not {width}x{height}")
+    if width > 255 or height > 255:
+        sys.exit(f"{path}: frames are limited to 255x255")
+    return frames, durations, colors
+
+
+def build_palette(frames, colors):
+    """palette of distinct RGB565 values in order of first use, and per frame index grids"""
+    palette, lookup, grids = [], {}, []
+    for fr in frames:
+        grid = []
+        for row in fr:
+            for ch in row:
+                if ch not in colors:
+                    sys.exit(f"unknown color character '{ch}' (add a 'color' line)")
+                c = rgb565(*colors[ch])
+                if c not in lookup:
+                    lookup[c] = len(palette)
+                    palette.append(c)
+                grid.append(lookup[c])
+        grids.append(grid)
+    if len(palette) > 256:
+        sys.exit("more than 256 colors")
+    return palette, grids
+
+
+def encode_ops(pixels):
+    """pixels: palette indices, None = skip (unchanged)"""
+    out = bytearray()
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:MAX_LITERAL]
+            del literal[:MAX_LITERAL]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+
+    i, n = 0, len(pixels)
+    while i < n:
+        if pixels[i] is None:
+            flush_literal()
+            j = i
+            while j < n and pixels[j] is None and j - i < MAX_RUN:
+                j += 1
+            out.append(0xC0 | (j - i - 1))
+            i = j
+            continue
+
+        j = i
+        while j < n and pixels[j] == pixels[i] and j - i < MAX_RUN:
+            j += 1
+        if j - i >= MIN_RUN:
+            flush_literal()
+            out.append(0x80 | (j - i - 1))
+            out.append(pixels[i])
+            i = j
+        else:
+            literal.append(pixels[i])
+            i += 1
+    flush_literal()
+    return out
+
+
+def changed_rects(prev, cur, width, height):
+    """bands of consecutive changed rows (gaps of one row merged), each cut to the changed columns"""
+    rows = []
+    for y in range(height):
+        xs = [x for x in range(width) if prev[y * width + x] != cur[y * width + x]]
+        rows.append((min(xs), max(xs)) if xs else None)
+
+    rects, y = [], 0
+    while y < height:
+        if rows[y] is None:
+            y += 1
+            continue
+        top, x0, x1 = y, rows[y][0], rows[y][1]
+        end = y
+        while end + 1 < height and (rows[end + 1] is not None or
+                                    (end + 2 < height and rows[end + 2] is not None)):
+            end += 1
+            if rows[end] is not None:
+                x0, x1 = min(x0, rows[end][0]), max(x1, rows[end][1])
+        rects.append((x0, top, x1 - x0 + 1, end - top + 1))
+        y = end + 1
+    return rects
+
+
+def encode(frames, durations, colors):
+    height, width = len(frames[0]), len(frames[0][0])
+    palette, grids = build_palette(frames, colors)
+
+    out = bytearray(b'AN')
+    out += bytes([1, width, height, len(palette) & 0xFF])
+    out += len(frames).to_bytes(2, 'little')
+    for c in palette:
+        out += c.to_bytes(2, 'little')
+
+    for i, grid in enumerate(grids):
+        if i == 0:
+            rects = [(0, 0, width, height)]
+        else:
+            rects = changed_rects(grids[i - 1], grid, width, height)
+
+        body = bytearray(durations[i].to_bytes(2, 'little'))
+        body.append(len(rects))
+        for (x, y, w, h) in rects:
+            body += bytes([x, y, w, h])
+            pixels = []
+            for ry in range(y, y + h):
+                for rx in range(x, x + w):
+                    v = grid[ry * width + rx]
+                    pixels.append(None if i and grids[i - 1][ry * width + rx] == v else v)
+            body += encode_ops(pixels)
+        out += len(body).to_bytes(2, 'little')
+        out += body
+    return bytes(out), palette, grids
+
+
+def decode(data):
+    """reference decoder, mirrors animDecodeFrame(). returns the list of frames as RGB565 grids"""
+    assert data[:3] == b'AN\x01'
+    width, height = data[3], data[4]
+    pcount = data[5] or 256
+    nframes = int.from_bytes(data[6:8], 'little')
+    palette = [int.from_bytes(data[8 + 2 * i:10 + 2 * i], 'little') for i in range(pcount)]
+    pos = 8 + 2 * pcount
+    image = [0] * (width * height)
+    frames = []
+    for _ in range(nframes):
+        size = int.from_bytes(data[pos:pos + 2], 'little')
+        end = pos + 2 + size
+        rect_count = data[pos + 4]
+        pos += 5
+        for _ in range(rect_count):
+            x, y, w, h = data[pos:pos + 4]
+            pos += 4
+            i = 0
+            while i < w * h:
+                op = data[pos]
+                pos += 1
+                if op < 0x80:
+                    for _ in range(op + 1):
+                        image[(y + i // w) * width + x + i % w] = palette[data[pos]]
+                        pos += 1
+                        i += 1
+                elif op < 0xC0:
+                    for _ in range((op & 0x3F) + 1):
+                        image[(y + i // w) * width + x + i % w] = palette[data[pos]]
+                        i += 1
+                    pos += 1
+                else:
+                    i += (op & 0x3F) + 1
+        assert pos == end, "frame size mismatch"
+        frames.append(list(image))
+    return frames
+
+
+def write_header(path, name, data, source, width, height, nframes):
+    with open(path, 'w') as f:
+        f.write(f"// generated by tools/anim_encode.py from {source}, do not edit\n")
+        f.write(f"// {width}x{height}, {nframes} frames, {len(data)} bytes\n\n")
+        guard = name.upper() + "_H"
+        f.write(f"#ifndef {guard}\n#define {guard}\n\n#include <stdint.h>\n\n")
+        f.write(f"static const uint8_t {name}[] = {{\n")
+        for i in range(0, len(data), 16):
+            f.write("  " + ", ".join(f"0x{b:02X}" for b in data[i:i + 16]) + ",\n")
+        f.write("};\n\n#endif\n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    ap.add_argument('input')
+    ap.add_argument('-n', '--name', default='animation', help='C array name')
+    ap.add_argument('-o', '--output', required=True, help='header to write')
+    ap.add_argument('--check', action='store_true', help='decode again, compare and report the compression ratio')
+    ap.add_argument('--raw', action='store_true', help='write the bare animation file (for data/) instead of a header')
+    args = ap.parse_args()
+
+    frames, durations, colors = parse(args.input)
+    data, palette, grids = encode(frames, durations, colors)
+    height, width = len(frames[0]), len(frames[0][0])
+
+    if args.check:
+        decoded = decode(data)
+        for i, grid in enumerate(grids):
+            if decoded[i] != [palette[v] for v in grid]:
+                sys.exit(f"round trip failed at frame {i}")
+        raw = width * height * 2 * len(frames)
+        print(f"round trip ok: {len(frames)} frames, {raw} bytes raw RGB565 -> {len(data)} bytes "
+              f"({raw / len(data):.1f}x)")
+
+    if args.raw:
+        with open(args.output, 'wb') as f:
+            f.write(data)
+    else:
+        write_header(args.output, args.name, data, args.input, width, height, len(frames))
+
+
+if __name__ == '__main__':
+    main()
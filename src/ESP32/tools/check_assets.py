@@ -0,0 +1,71 @@
+"""
+@file check_assets.py
+@brief PlatformIO pre build step: fails the build when a generated asset header no longer matches its art
+@version 0.1
+
+@copyright Copyright (c) 2025
+
+Every header under include/ whose first line is "// generated by tools/<tool>.py from <inputs>, do not edit" is built
+again from those inputs (into a temporary file, with the same array name) and compared byte for byte. A difference
+means art in assets/ was edited without rerunning the tool, and the build stops with the command that fixes it.
+
+Hooked in from platformio.ini (extra_scripts = pre:tools/check_assets.py). It can also be run by hand from the project
+directory: python3 tools/check_assets.py
+"""
+
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+GENERATED = re.compile(r'^// generated by (tools/\w+\.py) from (.+), do not edit$')
+ARRAY = re.compile(r'^static const uint8_t (\w+)\[\]', re.M)
+
+
+def stale_headers(project):
+    """[(header, command that rebuilds it, tool errors)] for the generated headers that differ from what their tool
+    makes now"""
+    stale = []
+    for root, _, files in os.walk(os.path.join(project, 'include')):
+        for name in sorted(files):
+            if not name.endswith('.h'):
+                continue
+            path = os.path.join(root, name)
+            with open(path) as f:
+                text = f.read()
+            found = GENERATED.match(text.split('\n', 1)[0])
+            array = ARRAY.search(text)
+            if not found or not array:
+                continue
+
+            header = os.path.relpath(path, project)
+            command = [found.group(1)] + found.group(2).split() + ['-n', array.group(1), '-o', header]
+            fd, temp = tempfile.mkstemp(suffix='.h')
+            os.close(fd)
+            try:
+                run = subprocess.run([sys.executable] + command[:-1] + [temp], cwd=project,
+                                     stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, universal_newlines=True)
+                with open(temp) as f:
+                    fresh = f.read()
+            finally:
+                os.remove(temp)
+            if run.returncode != 0 or fresh != text:
+                stale.append((header, ' '.join(['python3'] + command), run.stderr.strip()))
+    return stale
+
+
+def report(stale):
+    for header, command, errors in stale:
+        sys.stderr.write(f"{header} is out of date with its art in assets/, rebuild it with:\n    {command}\n")
+        if errors:
+            sys.stderr.write(errors + "\n")
+    return 1 if stale else 0
+
+
+if __name__ == '__main__':
+    sys.exit(report(stale_headers(os.getcwd())))
+else:
+    Import("env")                                       # noqa: F821 (provided by SCons)
+    if report(stale_headers(env.subst("$PROJECT_DIR"))):  # noqa: F821
+        env.Exit(1)                                     # noqa: F821
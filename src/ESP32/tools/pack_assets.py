@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+"""
+@file pack_assets.py
+@brief packs the built in images and palettes into one compressed blob (see include/Assets/Unpack.h)
+@version 0.1
+
+@copyright Copyright (c) 2025
+
+Input is the character art format of anim_encode.py (only the first frame of each file is used). All images share one
+palette, and each image is stored as its palette indices, row by row, LZSS compressed with a 512 byte window so the
+firmware can decode it as a stream with a fixed buffer:
+
+    stream   groups of one flag byte and 8 items (fewer at the end), bit 0 first
+             flag bit 1: literal byte
+             flag bit 0: match u16: bits 0-8 distance - 1, bits 9-15 length - 3 (copied from the bytes already output)
+
+A file without frames is a named palette (the Sketch drawing colors): one "color <name> r g b" line per color, in order.
+It becomes an entry of its own, every color as RGB565 followed by its NUL terminated name, in the same kind of stream.
+
+Fonts are not packed. The only font in the firmware is the classic 5x7 one inside Adafruit GFX, which drawChar() reads
+in place one glyph at a time; a packed copy could not replace it, only sit next to it.
+
+Output is a C header with the blob as a const byte array and an enum with the index of every entry. --check decodes
+every entry again with a reference decoder, compares it with the input and prints raw and packed sizes.
+
+usage: pack_assets.py assets/packers.txt ... assets/sketch_colors.txt -o include/Assets/PackedAssets.h [--check]
+"""
+
+import argparse
+import os
+import sys
+
+from anim_encode import parse, rgb565
+
+WINDOW = 512
+MIN_MATCH = 3
+MAX_MATCH = MIN_MATCH + 127
+TYPE_IMAGE = 1
+TYPE_PALETTE = 2
+HEADER_SIZE = 8
+ENTRY_SIZE = 12
+
+
+def compress(data):
+    out = bytearray()
+    i, n = 0, len(data)
+    while i < n:
+        flag_at = len(out)
+        out.append(0)
+        for bit in range(8):
+            if i >= n:
+                break
+            # longest match in the window (earliest wins on ties, lengths may run into the bytes being produced)
+            best_len, best_dist = 0, 0
+            for start in range(max(0, i - WINDOW), i):
+                length = 0
+                while length < MAX_MATCH and i + length < n and data[start + length] == data[i + length]:
+                    length += 1
+                if length > best_len:
+                    best_len, best_dist = length, i - start
+            if best_len >= MIN_MATCH:
+                code = (best_dist - 1) | ((best_len - MIN_MATCH) << 9)
+                out += code.to_bytes(2, 'little')
+                i += best_len
+            else:
+                out[flag_at] |= 1 << bit
+                out.append(data[i])
+                i += 1
+    return bytes(out)
+
+
+def decompress(data, size=None):
+    """reference decoder, mirrors unpackRead(). without a size it runs to the end of the stream"""
+    out = bytearray()
+    pos = 0
+    while (len(out) < size) if size is not None else (pos < len(data)):
+        flags = data[pos]
+        pos += 1
+        for bit in range(8):
+            if (len(out) >= size) if size is not None else (pos >= len(data)):
+                break
+            if flags & (1 << bit):
+                out.append(data[pos])
+                pos += 1
+            else:
+                code = int.from_bytes(data[pos:pos + 2], 'little')
+                pos += 2
+                dist, length = (code & 0x1FF) + 1, (code >> 9) + MIN_MATCH
+                for _ in range(length):
+                    out.append(out[-dist])
+    assert pos == len(data), "stream size mismatch"
+    return bytes(out if size is None else out[:size])
+
+
+def parse_palette(path):
+    """[(name, RGB565)] of a file with only color lines, None if it has frames (an image)"""
+    named = []
+    with open(path) as f:
+        for lineno, raw in enumerate(f, 1):
+            words = raw.split()
+            if not words or words[0].startswith('#'):
+                continue
+            if words[0] == 'frame':
+                return None
+            if words[0] != 'color' or len(words) != 5:
+                sys.exit(f"{path}:{lineno}: expected 'color <name> r g b'")
+            named.append((words[1], rgb565(*(int(v) for v in words[2:5]))))
+    if not named or len(named) > 255:
+        sys.exit(f"{path}: a palette has 1 to 255 colors")
+    return named
+
+
+def pack(paths):
+    """the blob, the shared image palette and the entries as (type, width, height, data before compression)"""
+    palette, lookup, entries = [], {}, []
+    for path in paths:
+        named = parse_palette(path)
+        if named is not None:
+            data = b''.join(c.to_bytes(2, 'little') + name.encode() + b'\0' for name, c in named)
+            entries.append((TYPE_PALETTE, len(named), 0, data))
+            continue
+        frames, _, colors = parse(path)
+        indices = bytearray()
+        for row in frames[0]:
+            for ch in row:
+                if ch not in colors:
+                    sys.exit(f"{path}: unknown color character '{ch}' (add a 'color' line)")
+                c = rgb565(*colors[ch])
+                if c not in lookup:
+                    lookup[c] = len(palette)
+                    palette.append(c)
+                indices.append(lookup[c])
+        entries.append((TYPE_IMAGE, len(frames[0][0]), len(frames[0]), bytes(indices)))
+    if len(palette) > 256:
+        sys.exit("more than 256 colors")
+    if len(entries) > 255:
+        sys.exit("more than 255 entries")
+
+    streams = [compress(data) for (_, _, _, data) in entries]
+    out = bytearray(b'PK')
+    out += bytes([1, len(entries), len(palette) & 0xFF, 0, 0, 0])
+    for c in palette:
+        out += c.to_bytes(2, 'little')
+    offset = len(out) + ENTRY_SIZE * len(entries)
+    for (kind, w, h, _), s in zip(entries, streams):
+        out += bytes([kind, w, h, 0])
+        out += offset.to_bytes(4, 'little') + len(s).to_bytes(4, 'little')
+        offset += len(s)
+    for s in streams:
+        out += s
+    return bytes(out), palette, entries
+
+
+def unpack(blob):
+    """reference reader, mirrors packOpen() / packEntry() / unpackPalette(). returns the entries as (type, w, h, data):
+    RGB565 pixels for an image, [(name, RGB565)] for a palette"""
+    assert blob[:3] == b'PK\x01'
+    count, pcount = blob[3], blob[4] or 256
+    palette = [int.from_bytes(blob[HEADER_SIZE + 2 * i:HEADER_SIZE + 2 * i + 2], 'little') for i in range(pcount)]
+    table = HEADER_SIZE + 2 * pcount
+    entries = []
+    for i in range(count):
+        e = blob[table + ENTRY_SIZE * i:table + ENTRY_SIZE * (i + 1)]
+        kind, w, h = e[0], e[1], e[2]
+        offset, size = int.from_bytes(e[4:8], 'little'), int.from_bytes(e[8:12], 'little')
+        if kind == TYPE_PALETTE:
+            data = decompress(blob[offset:offset + size])
+            named, pos = [], 0
+            for _ in range(w):
+                end = data.index(0, pos + 2)
+                named.append((data[pos + 2:end].decode(), int.from_bytes(data[pos:pos + 2], 'little')))
+                pos = end + 1
+            assert pos == len(data), "palette size mismatch"
+            entries.append((kind, w, h, named))
+        else:
+            indices = decompress(blob[offset:offset + size], w * h)
+            entries.append((kind, w, h, [palette[v] for v in indices]))
+    return entries
+
+
+def write_header(path, name, blob, sources, entries):
+    images = [e for e in entries if e[0] == TYPE_IMAGE]
+    raw = sum(w * h for (_, w, h, _) in images)
+    with open(path, 'w') as f:
+        f.write(f"// generated by tools/pack_assets.py from {' '.join(sources)}, do not edit\n")
+        palettes = len(entries) - len(images)
+        plural = '' if palettes == 1 else 's'
+        f.write(f"// {len(images)} images, {raw} pixels, {palettes} palette{plural}, {len(blob)} bytes\n\n")
+        guard = name.upper() + "_H"
+        f.write(f"#ifndef {guard}\n#define {guard}\n\n#include <stdint.h>\n\n")
+        f.write("enum PackedAsset {\n")
+        for src in sources:
+            stem = os.path.splitext(os.path.basename(src))[0]
+            f.write(f"  PACKED_{stem.upper()},\n")
+        f.write("  PACKED_COUNT\n};\n\n")
+        f.write(f"static const uint8_t {name}[] = {{\n")
+        for i in range(0, len(blob), 16):
+            f.write("  " + ", ".join(f"0x{b:02X}" for b in blob[i:i + 16]) + ",\n")
+        f.write("};\n\n#endif\n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    ap.add_argument('inputs', nargs='+')
+    ap.add_argument('-n', '--name', default='packed_assets', help='C array name')
+    ap.add_argument('-o', '--output', required=True, help='header to write')
+    ap.add_argument('--check', action='store_true', help='decode again, compare and report the sizes')
+    args = ap.parse_args()
+
+    blob, palette, entries = pack(args.inputs)
+
+    if args.check:
+        for i, (entry, decoded) in enumerate(zip(entries, unpack(blob))):
+            kind, w, h, data = entry
+            if kind == TYPE_PALETTE:
+                expected = parse_palette(args.inputs[i])
+            else:
+                expected = [palette[v] for v in data]
+            if decoded != (kind, w, h, expected):
+                sys.exit(f"round trip failed for {args.inputs[i]}")
+        images = [e for e in entries if e[0] == TYPE_IMAGE]
+        chars = sum(w * h + h for (_, w, h, _) in images)
+        rgb = sum(w * h * 2 for (_, w, h, _) in images)
+        named = sum(len(data) for (kind, _, _, data) in entries if kind == TYPE_PALETTE)
+        print(f"round trip ok: {len(images)} images ({len(palette)} colors), {len(entries) - len(images)} palette(s)")
+        print(f"  character rows {chars} bytes, raw RGB565 {rgb} bytes, palettes {named} bytes -> {len(blob)} bytes "
+              f"packed")
+
+    write_header(args.output, args.name, blob, args.inputs, entries)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,343 @@
+#!/usr/bin/env python3
+"""
+@file stream_encode.py
+@brief streams frames to the console's Stream program (see include/Remote/FrameStream.h)
+@version 0.1
+
+@copyright Copyright (c) 2025
+
+Every frame is cut into 8x8 tiles; only tiles that differ from what the panel already shows are sent, each run length
+coded. The console acknowledges every frame ('A' seq) and asks for a keyframe ('K') if one arrived damaged. At most two
+frames are in flight, and when the link cannot keep up with --fps the newest frame is sent and the rest are skipped.
+
+Frames come from a built in demo or from raw 24 bit RGB frames (for example video through ffmpeg):
+
+    ffmpeg -i clip.mp4 -vf scale=64:64 -f rawvideo -pix_fmt rgb24 - | stream_encode.py --rgb24 - --serial /dev/ttyUSB0
+
+--bench needs no console: it encodes the frames, decodes them again with a reference decoder (same logic as
+frameStreamFeed()), checks every frame and prints the bytes per frame and the frame rate each link speed can carry.
+
+usage: stream_encode.py --demo bounce --serial /dev/ttyUSB0 [--baud 2000000]
+       stream_encode.py --demo plasma --tcp console.local[:5050]
+       stream_encode.py --demo bounce --bench [--frames 300]
+"""
+
+import argparse
+import math
+import socket
+import sys
+import time
+
+SYNC = b'\xA5\x5A'
+TILE = 8
+FLAG_KEYFRAME = 0x01
+MAX_OP = 128
+WINDOW = 2
+ACK_TIMEOUT = 0.5
+
+# link speeds for --bench, bytes per second (serial: 10 bits per byte on the wire)
+LINKS = [
+    ('UART 115200', 115200 / 10),
+    ('UART 921600', 921600 / 10),
+    ('UART 2000000', 2000000 / 10),
+    ('Wi-Fi TCP ~8 Mbit/s', 8e6 / 8),
+]
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def fletcher16(data):
+    s1 = s2 = 0
+    for b in data:
+        s1 = (s1 + b) % 255
+        s2 = (s2 + s1) % 255
+    return (s2 << 8) | s1
+
+
+def encode_tile(pixels):
+    """64 RGB565 values -> ops. runs of two or more identical pixels are cheaper than literals"""
+    out = bytearray()
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:MAX_OP]
+            del literal[:MAX_OP]
+            out.append(len(chunk) - 1)
+            for c in chunk:
+                out.extend(c.to_bytes(2, 'little'))
+
+    i, n = 0, len(pixels)
+    while i < n:
+        j = i
+        while j < n and pixels[j] == pixels[i] and j - i < MAX_OP:
+            j += 1
+        if j - i >= 2:
+            flush_literal()
+            out.append(0x80 | (j - i - 1))
+            out += pixels[i].to_bytes(2, 'little')
+            i = j
+        else:
+            literal.append(pixels[i])
+            i += 1
+    flush_literal()
+    return out
+
+
+class Encoder:
+    """keeps the frame the panel shows, so only changed tiles are sent"""
+
+    def __init__(self, width, height):
+        self.width, self.height = width, height
+        self.tiles_x, self.tiles_y = width // TILE, height // TILE
+        self.shown = None
+        self.seq = 0
+
+    def tile(self, frame, index):
+        tx, ty = index % self.tiles_x, index // self.tiles_x
+        return [frame[(ty * TILE + y) * self.width + tx * TILE + x] for y in range(TILE) for x in range(TILE)]
+
+    def encode(self, frame, keyframe=False):
+        """frame: width * height RGB565 values. returns (packet, seq)"""
+        keyframe = keyframe or self.shown is None
+        tiles = bytearray()
+        count = 0
+        for index in range(self.tiles_x * self.tiles_y):
+            pixels = self.tile(frame, index)
+            if not keyframe and pixels == self.tile(self.shown, index):
+                continue
+            tiles += index.to_bytes(2, 'little')
+            tiles += encode_tile(pixels)
+            count += 1
+
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        self.shown = list(frame)
+
+        body = bytes([seq, FLAG_KEYFRAME if keyframe else 0]) + count.to_bytes(2, 'little') + tiles
+        return SYNC + body + fletcher16(body).to_bytes(2, 'little'), seq
+
+
+def decode(data, width, image):
+    """reference decoder, mirrors frameStreamFeed(). applies every frame in data to image, returns the frame count"""
+    tiles_x = width // TILE
+    pos, frames = 0, 0
+    while pos < len(data):
+        assert data[pos:pos + 2] == SYNC, "lost sync"
+        start = pos + 2
+        count = int.from_bytes(data[start + 2:start + 4], 'little')
+        pos = start + 4
+        for _ in range(count):
+            index = int.from_bytes(data[pos:pos + 2], 'little')
+            pos += 2
+            ox, oy = (index % tiles_x) * TILE, (index // tiles_x) * TILE
+            i = 0
+            while i < TILE * TILE:
+                op = data[pos]
+                pos += 1
+                for _ in range((op & 0x7F) + 1):
+                    image[(oy + i // TILE) * width + ox + i % TILE] = int.from_bytes(data[pos:pos + 2], 'little')
+                    i += 1
+                    if op < 0x80:
+                        pos += 2                # literal: every pixel has its own value
+                if op >= 0x80:
+                    pos += 2                    # run: one value for all of them
+        check = int.from_bytes(data[pos:pos + 2], 'little')
+        assert check == fletcher16(data[start:pos]), "bad checksum"
+        pos += 2
+        frames += 1
+    return frames
+
+
+# ---------- frame sources ---------- #
+
+def demo_bounce(width, height):
+    """dashboard like: a static gradient, a ball bouncing over it and a ticking bar (few tiles change per frame)"""
+    background = [rgb565(x * 2, 0, 40 + y) for y in range(height) for x in range(width)]
+    x, y, dx, dy, t = 10.0, 20.0, 1.3, 0.9, 0
+    while True:
+        frame = list(background)
+        for py in range(int(y) - 3, int(y) + 4):
+            for px in range(int(x) - 3, int(x) + 4):
+                if 0 <= px < width and 0 <= py < height and (px - x) ** 2 + (py - y) ** 2 <= 9:
+                    frame[py * width + px] = rgb565(255, 255, 0)
+        bar = (t // 2) % width
+        for px in range(bar + 1):
+            frame[(height - 2) * width + px] = rgb565(0, 255, 0)
+        yield frame
+        x, y, t = x + dx, y + dy, t + 1
+        if not 3 <= x < width - 3:
+            dx = -dx
+        if not 3 <= y < height - 6:
+            dy = -dy
+
+
+def demo_plasma(width, height):
+    """worst case: every pixel changes every frame"""
+    t = 0
+    while True:
+        frame = []
+        for y in range(height):
+            for x in range(width):
+                v = math.sin(x * 0.2 + t) + math.sin(y * 0.15 - t * 0.7) + math.sin((x + y) * 0.1 + t * 0.4)
+                frame.append(rgb565(int(127 + 40 * v), int(127 + 40 * math.sin(v + 2)), int(127 - 40 * v)))
+        yield frame
+        t += 0.15
+
+
+def read_rgb24(path, width, height):
+    f = sys.stdin.buffer if path == '-' else open(path, 'rb')
+    size = width * height * 3
+    while True:
+        data = f.read(size)
+        if len(data) < size:
+            return
+        yield [rgb565(data[i], data[i + 1], data[i + 2]) for i in range(0, size, 3)]
+
+
+# ---------- links ---------- #
+
+class SerialLink:
+    def __init__(self, port, baud):
+        try:
+            import serial
+        except ImportError:
+            sys.exit("--serial needs pyserial (pip install pyserial)")
+        self.port = serial.Serial(port, baud, timeout=0)
+
+    def send(self, data):
+        self.port.write(data)
+
+    def receive(self):
+        return self.port.read(256)
+
+
+class TcpLink:
+    def __init__(self, address):
+        host, _, port = address.partition(':')
+        self.sock = socket.create_connection((host, int(port or 5050)))
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.sock.setblocking(False)
+
+    def send(self, data):
+        self.sock.setblocking(True)
+        self.sock.sendall(data)
+        self.sock.setblocking(False)
+
+    def receive(self):
+        try:
+            return self.sock.recv(256)
+        except BlockingIOError:
+            return b''
+
+
+def stream(frames, encoder, link, fps, limit):
+    """send frames at up to fps, never more than WINDOW unacknowledged"""
+    in_flight = {}                  # seq -> time sent
+    want_keyframe = False
+    ack_next = False
+    sent = skipped = 0
+    start = time.time()
+    next_frame = start
+    stats_at = start
+
+    for n, frame in enumerate(frames):
+        if limit and n >= limit:
+            break
+
+        # wait for this frame's time slot, reading acks meanwhile
+        while True:
+            for b in link.receive():
+                if ack_next:
+                    in_flight.pop(b, None)      # 'A' seq: that frame is on the panel
+                    ack_next = False
+                elif b == ord('A'):
+                    ack_next = True
+                elif b == ord('K'):
+                    want_keyframe = True
+                    in_flight.clear()
+            now = time.time()
+            if in_flight and now - min(in_flight.values()) > ACK_TIMEOUT:
+                want_keyframe = True            # lost frame or ack, start over from a keyframe
+                in_flight.clear()
+            if now >= next_frame:
+                break
+            time.sleep(0.001)
+        next_frame += 1 / fps
+
+        if len(in_flight) >= WINDOW:
+            skipped += 1                        # link is behind, this frame is dropped (the next one has it all)
+            continue
+
+        packet, seq = encoder.encode(frame, keyframe=want_keyframe)
+        want_keyframe = False
+        link.send(packet)
+        in_flight[seq] = time.time()
+        sent += 1
+
+        if time.time() - stats_at >= 2:
+            elapsed = time.time() - start
+            print(f"{sent / elapsed:5.1f} fps sent, {skipped} skipped", file=sys.stderr)
+            stats_at = time.time()
+
+
+def bench(frames, width, height, count):
+    encoder = Encoder(width, height)
+    image = [0] * (width * height)
+    sizes = []
+    for n, frame in enumerate(frames):
+        if n >= count:
+            break
+        packet, _ = encoder.encode(frame)
+        decode(packet, width, image)
+        if image != frame:
+            sys.exit(f"round trip failed at frame {n}")
+        sizes.append(len(packet))
+
+    if not sizes:
+        sys.exit("no frames")
+    raw = width * height * 2
+    delta = sizes[1:] or sizes
+    average = sum(delta) / len(delta)
+    print(f"round trip ok: {len(sizes)} frames, keyframe {sizes[0]} bytes, deltas {average:.0f} bytes on average "
+          f"(raw RGB565 frame {raw} bytes, {raw / average:.1f}x)")
+    for name, rate in LINKS:
+        print(f"  {name:22s} {rate / average:7.1f} fps   (keyframes {rate / sizes[0]:6.1f} fps)")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    source = ap.add_mutually_exclusive_group(required=True)
+    source.add_argument('--demo', choices=['bounce', 'plasma'])
+    source.add_argument('--rgb24', metavar='FILE', help="raw 24 bit RGB frames ('-' for stdin)")
+    sink = ap.add_mutually_exclusive_group(required=True)
+    sink.add_argument('--serial', metavar='PORT')
+    sink.add_argument('--tcp', metavar='HOST[:PORT]')
+    sink.add_argument('--bench', action='store_true', help='encode + decode locally and report frame rates')
+    ap.add_argument('--baud', type=int, default=2000000, help='must match REMOTE_BAUD')
+    ap.add_argument('--size', default='64x64', help='canvas size, WxH')
+    ap.add_argument('--fps', type=float, default=30)
+    ap.add_argument('--frames', type=int, default=0, help='stop after this many frames (--bench default 120)')
+    args = ap.parse_args()
+
+    width, height = (int(v) for v in args.size.split('x'))
+    if width % TILE or height % TILE:
+        sys.exit("size must be a multiple of 8")
+
+    if args.demo:
+        frames = {'bounce': demo_bounce, 'plasma': demo_plasma}[args.demo](width, height)
+    else:
+        frames = read_rgb24(args.rgb24, width, height)
+
+    if args.bench:
+        bench(frames, width, height, args.frames or 120)
+        return
+
+    link = SerialLink(args.serial, args.baud) if args.serial else TcpLink(args.tcp)
+    stream(frames, Encoder(width, height), link, args.fps, args.frames)
+
+
+if __name__ == '__main__':
+    main()